@@ -1029,8 +1029,8 @@ absl::StatusOr<std::vector<Block*>> GatherInstantiatedBlocks(Block* top) {
 
 }  // namespace
 
-absl::StatusOr<std::string> GenerateVerilog(
-    Block* top, const CodegenOptions& options, VerilogLineMap* verilog_line_map,
+absl::Status GenerateVerilogFile(
+    Block* top, const CodegenOptions& options, VerilogFile* file,
     const absl::flat_hash_map<InputPort*, std::string>& input_port_sv_types,
     const absl::flat_hash_map<OutputPort*, std::string>& output_port_sv_types) {
   VLOG(2) << absl::StreamFormat(
@@ -1040,19 +1040,31 @@ absl::StatusOr<std::string> GenerateVerilog(
 
   XLS_ASSIGN_OR_RETURN(std::vector<Block*> blocks,
                        GatherInstantiatedBlocks(top));
-  VerilogFile file(options.use_system_verilog() ? FileType::kSystemVerilog
-                                                : FileType::kVerilog);
   for (Block* block : blocks) {
     XLS_RETURN_IF_ERROR(BlockGenerator::Generate(
-        block, &file, options, input_port_sv_types, output_port_sv_types));
+        block, file, options, input_port_sv_types, output_port_sv_types));
     if (block != blocks.back()) {
-      file.Add(file.Make<BlankLine>(SourceInfo()));
-      file.Add(file.Make<BlankLine>(SourceInfo()));
+      file->Add(file->Make<BlankLine>(SourceInfo()));
+      file->Add(file->Make<BlankLine>(SourceInfo()));
     }
   }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> GenerateVerilog(
+    Block* top, const CodegenOptions& options, VerilogLineMap* verilog_line_map,
+    const absl::flat_hash_map<InputPort*, std::string>& input_port_sv_types,
+    const absl::flat_hash_map<OutputPort*, std::string>& output_port_sv_types) {
+  VerilogFile file(options.use_system_verilog() ? FileType::kSystemVerilog
+                                                : FileType::kVerilog);
+  XLS_RETURN_IF_ERROR(GenerateVerilogFile(top, options, &file,
+                                          input_port_sv_types,
+                                          output_port_sv_types));
 
   LineInfo line_info;
-  std::string text = file.Emit(&line_info);
+  std::string text;
+  StringVastSink sink(&text);
+  file.EmitTo(sink, &line_info);
   if (verilog_line_map != nullptr) {
     for (const VastNode* vast_node : line_info.nodes()) {
       std::optional<std::vector<LineSpan>> spans =
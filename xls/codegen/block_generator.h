@@ -18,8 +18,10 @@
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/codegen/codegen_options.h"
+#include "xls/codegen/vast/vast.h"
 #include "xls/codegen/verilog_line_map.pb.h"
 #include "xls/ir/block.h"
 #include "xls/ir/nodes.h"
@@ -38,6 +40,16 @@ absl::StatusOr<std::string> GenerateVerilog(
     const absl::flat_hash_map<OutputPort*, std::string>& output_port_sv_types =
         {});
 
+// Adds VAST for the given top-level block and the blocks it instantiates to
+// `file`. Text for the file can then be emitted with `VerilogFile::Emit` or
+// streamed into a `VastSink` with `VerilogFile::EmitTo`.
+absl::Status GenerateVerilogFile(
+    Block* top, const CodegenOptions& options, VerilogFile* file,
+    const absl::flat_hash_map<InputPort*, std::string>& input_port_sv_types =
+        {},
+    const absl::flat_hash_map<OutputPort*, std::string>& output_port_sv_types =
+        {});
+
 }  // namespace verilog
 }  // namespace xls
 
@@ -15,7 +15,12 @@
 #include "xls/codegen/vast/vast.h"
 
 #include <algorithm>
+#include <cerrno>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>  // NOLINT
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -26,9 +31,11 @@
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -139,6 +146,125 @@ std::string CombineKindAndDataType(std::string_view kind_str,
 
 }  // namespace
 
+void VastSink::Append(std::string_view text) {
+  while (!text.empty()) {
+    size_t newline = text.find('\n');
+    std::string_view line = text.substr(0, newline);
+    if (!line.empty()) {
+      if (at_line_start_) {
+        if (!indent_.empty()) {
+          Write(indent_);
+        }
+        regions_with_content_ = indents_.size();
+        at_line_start_ = false;
+      }
+      Write(line);
+    }
+    if (newline == std::string_view::npos) {
+      return;
+    }
+    // Like `Indent`, drop empty lines which precede any content in a region.
+    if (!at_line_start_ || regions_with_content_ == indents_.size()) {
+      Write("\n");
+    }
+    at_line_start_ = true;
+    text.remove_prefix(newline + 1);
+  }
+}
+
+void VastSink::PushIndent(int64_t spaces) {
+  DCHECK(at_line_start_) << "Indented regions must start at a line start";
+  indents_.push_back(spaces);
+  indent_.append(spaces, ' ');
+}
+
+void VastSink::PopIndent() {
+  CHECK(!indents_.empty());
+  indent_.resize(indent_.size() - indents_.back());
+  indents_.pop_back();
+  regions_with_content_ =
+      std::min<int64_t>(regions_with_content_, indents_.size());
+}
+
+namespace {
+
+// Size at which buffered sinks pass text on to their destination.
+constexpr int64_t kSinkBufferSize = 64 * 1024;
+
+}  // namespace
+
+CordVastSink::~CordVastSink() { CHECK_OK(Flush()); }
+
+void CordVastSink::Write(std::string_view text) {
+  buffer_.append(text);
+  if (buffer_.size() >= kSinkBufferSize) {
+    CHECK_OK(Flush());
+  }
+}
+
+absl::Status CordVastSink::Flush() {
+  if (!buffer_.empty()) {
+    out_->Append(std::move(buffer_));
+    buffer_.clear();
+  }
+  return absl::OkStatus();
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<FileVastSink>> FileVastSink::Create(
+    const std::filesystem::path& path) {
+  std::FILE* file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    int error = errno;
+    return absl::Status(absl::ErrnoToStatusCode(error),
+                        absl::StrFormat("Unable to open %s for writing: %s",
+                                        path.string(), strerror(error)));
+  }
+  return absl::WrapUnique(new FileVastSink(file, path));
+}
+
+FileVastSink::~FileVastSink() {
+  absl::Status status = Flush();
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+  }
+  std::fclose(file_);
+}
+
+void FileVastSink::Write(std::string_view text) {
+  buffer_.append(text);
+  if (buffer_.size() >= kSinkBufferSize) {
+    status_.Update(Flush());
+  }
+}
+
+absl::Status FileVastSink::Flush() {
+  if (status_.ok() && !buffer_.empty()) {
+    if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) !=
+            buffer_.size() ||
+        std::fflush(file_) != 0) {
+      int error = errno;
+      status_ = absl::Status(absl::ErrnoToStatusCode(error),
+                             absl::StrFormat("Unable to write to %s: %s",
+                                             path_.string(), strerror(error)));
+    }
+  }
+  buffer_.clear();
+  return status_;
+}
+
+namespace {
+
+// Emits the given node into a string through its `EmitTo` method.
+template <typename T>
+std::string EmitToString(const T& node, LineInfo* line_info) {
+  std::string result;
+  StringVastSink sink(&result);
+  node.EmitTo(sink, line_info);
+  return result;
+}
+
+}  // namespace
+
 int Precedence(OperatorKind kind) {
   switch (kind) {
     case OperatorKind::kNegate:
@@ -430,16 +556,15 @@ UnpackedArrayType* VerilogFile::UnpackedArrayType(
 }
 
 std::string VerilogFile::Emit(LineInfo* line_info) const {
-  auto file_member_str = [=](const FileMember& member) -> std::string {
-    return absl::visit([=](auto* m) { return m->Emit(line_info); }, member);
-  };
+  return EmitToString(*this, line_info);
+}
 
-  std::string out;
+void VerilogFile::EmitTo(VastSink& sink, LineInfo* line_info) const {
   for (const FileMember& member : members_) {
-    absl::StrAppend(&out, file_member_str(member), "\n");
+    absl::visit([&](auto* m) { m->EmitTo(sink, line_info); }, member);
+    sink.Append("\n");
     LineInfoIncrease(line_info, 1);
   }
-  return out;
 }
 
 LocalParamItemRef* LocalParam::AddItem(std::string_view name, Expression* value,
@@ -464,23 +589,31 @@ std::string CaseArm::Emit(LineInfo* line_info) const {
 }
 
 std::string StatementBlock::Emit(LineInfo* line_info) const {
+  return EmitToString(*this, line_info);
+}
+
+void StatementBlock::EmitTo(VastSink& sink, LineInfo* line_info) const {
   LineInfoStart(line_info, this);
   // TODO(meheff): We can probably be smarter about optionally emitting the
   // begin/end.
   if (statements_.empty()) {
     LineInfoEnd(line_info, this);
-    return "begin end";
+    sink.Append("begin end");
+    return;
   }
-  std::string result = "begin\n";
+  sink.Append("begin\n");
   LineInfoIncrease(line_info, 1);
-  std::vector<std::string> lines;
-  for (const auto& statement : statements_) {
-    lines.push_back(statement->Emit(line_info));
+  sink.PushIndent();
+  for (int64_t i = 0; i < statements_.size(); ++i) {
+    if (i > 0) {
+      sink.Append("\n");
+    }
+    statements_[i]->EmitTo(sink, line_info);
     LineInfoIncrease(line_info, 1);
   }
-  absl::StrAppend(&result, Indent(absl::StrJoin(lines, "\n")), "\nend");
+  sink.PopIndent();
+  sink.Append("\nend");
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 GenerateLoop::GenerateLoop(LogicRef* genvar, Expression* init,
@@ -1000,54 +1133,69 @@ GenvarDef::GenvarDef(std::string_view name, VerilogFile* file,
 namespace {
 
 // "Match" statement for emitting a ModuleMember.
-std::string EmitModuleMember(LineInfo* line_info, const ModuleMember& member) {
-  return absl::visit([=](auto* d) { return d->Emit(line_info); }, member);
+void EmitModuleMember(VastSink& sink, LineInfo* line_info,
+                      const ModuleMember& member) {
+  absl::visit([&](auto* d) { d->EmitTo(sink, line_info); }, member);
 }
 
 // Visitor for emitting a VerilogPackageMember.
-std::string EmitVerilogPackageMember(LineInfo* line_info,
-                                     const VerilogPackageMember& member) {
-  return absl::visit([=](auto* d) { return d->Emit(line_info); }, member);
+void EmitVerilogPackageMember(VastSink& sink, LineInfo* line_info,
+                              const VerilogPackageMember& member) {
+  absl::visit([&](auto* d) { d->EmitTo(sink, line_info); }, member);
 }
 
 }  // namespace
 
 std::string ModuleSection::Emit(LineInfo* line_info) const {
+  return EmitToString(*this, line_info);
+}
+
+void ModuleSection::EmitTo(VastSink& sink, LineInfo* line_info) const {
   LineInfoStart(line_info, this);
-  std::vector<std::string> elements;
+  bool emitted_element = false;
   for (const ModuleMember& member : members_) {
     if (std::holds_alternative<ModuleSection*>(member)) {
       if (std::get<ModuleSection*>(member)->members_.empty()) {
         continue;
       }
     }
-    elements.push_back(EmitModuleMember(line_info, member));
+    if (emitted_element) {
+      sink.Append("\n");
+    }
+    EmitModuleMember(sink, line_info, member);
+    emitted_element = true;
     LineInfoIncrease(line_info, 1);
   }
-  if (!elements.empty()) {
+  if (emitted_element) {
     LineInfoIncrease(line_info, -1);
   }
   LineInfoEnd(line_info, this);
-  return absl::StrJoin(elements, "\n");
 }
 
 std::string VerilogPackageSection::Emit(LineInfo* line_info) const {
+  return EmitToString(*this, line_info);
+}
+
+void VerilogPackageSection::EmitTo(VastSink& sink, LineInfo* line_info) const {
   LineInfoStart(line_info, this);
-  std::vector<std::string> elements;
+  bool emitted_element = false;
   for (const VerilogPackageMember& member : members_) {
     if (std::holds_alternative<VerilogPackageSection*>(member)) {
       if (std::get<VerilogPackageSection*>(member)->members_.empty()) {
         continue;
       }
     }
-    elements.push_back(EmitVerilogPackageMember(line_info, member));
+    if (emitted_element) {
+      sink.Append("\n");
+    }
+    EmitVerilogPackageMember(sink, line_info, member);
+    emitted_element = true;
     LineInfoIncrease(line_info, 1);
   }
-  if (!elements.empty()) {
+  if (emitted_element) {
     LineInfoIncrease(line_info, -1);
   }
   LineInfoEnd(line_info, this);
-  return absl::StrJoin(elements, "\n");
 }
 
 std::string ContinuousAssignment::Emit(LineInfo* line_info) const {
@@ -1186,6 +1334,10 @@ std::string SystemFunctionCall::Emit(LineInfo* line_info) const {
 }
 
 std::string Module::Emit(LineInfo* line_info) const {
+  return EmitToString(*this, line_info);
+}
+
+void Module::EmitTo(VastSink& sink, LineInfo* line_info) const {
   LineInfoStart(line_info, this);
   std::string result = absl::StrCat("module ", name_);
   if (ports_.empty()) {
@@ -1207,25 +1359,34 @@ std::string Module::Emit(LineInfo* line_info) const {
     absl::StrAppend(&result, "\n);\n");
     LineInfoIncrease(line_info, 1);
   }
-  absl::StrAppend(&result, Indent(top_.Emit(line_info)), "\n");
+  sink.Append(result);
+  sink.PushIndent();
+  top_.EmitTo(sink, line_info);
+  sink.PopIndent();
+  sink.Append("\n");
   LineInfoIncrease(line_info, 1);
-  absl::StrAppend(&result, "endmodule");
+  sink.Append("endmodule");
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 std::string VerilogPackage::Emit(LineInfo* line_info) const {
+  return EmitToString(*this, line_info);
+}
+
+void VerilogPackage::EmitTo(VastSink& sink, LineInfo* line_info) const {
   LineInfoStart(line_info, this);
 
-  std::string result = absl::StrCat("package ", name_, ";\n");
+  sink.Append(absl::StrCat("package ", name_, ";\n"));
   LineInfoIncrease(line_info, 1);
 
-  absl::StrAppend(&result, Indent(top_.Emit(line_info)), "\n");
+  sink.PushIndent();
+  top_.EmitTo(sink, line_info);
+  sink.PopIndent();
+  sink.Append("\n");
   LineInfoIncrease(line_info, 1);
 
-  absl::StrAppend(&result, "endpackage");
+  sink.Append("endpackage");
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 std::string Literal::Emit(LineInfo* line_info) const {
@@ -1872,6 +2033,10 @@ std::string EmitSensitivityListElement(LineInfo* line_info,
 }  // namespace
 
 std::string AlwaysBase::Emit(LineInfo* line_info) const {
+  return EmitToString(*this, line_info);
+}
+
+void AlwaysBase::EmitTo(VastSink& sink, LineInfo* line_info) const {
   LineInfoStart(line_info, this);
   LineInfoIncrease(line_info, NumberOfNewlines(name()));
   std::string sensitivity_list = absl::StrJoin(
@@ -1879,25 +2044,32 @@ std::string AlwaysBase::Emit(LineInfo* line_info) const {
       [=](std::string* out, const SensitivityListElement& e) {
         absl::StrAppend(out, EmitSensitivityListElement(line_info, e));
       });
-  std::string statements = statements_->Emit(line_info);
+  sink.Append(absl::StrFormat("%s @ (%s) ", name(), sensitivity_list));
+  statements_->EmitTo(sink, line_info);
   LineInfoEnd(line_info, this);
-  return absl::StrFormat("%s @ (%s) %s", name(), sensitivity_list, statements);
 }
 
 std::string AlwaysComb::Emit(LineInfo* line_info) const {
+  return EmitToString(*this, line_info);
+}
+
+void AlwaysComb::EmitTo(VastSink& sink, LineInfo* line_info) const {
   LineInfoStart(line_info, this);
   LineInfoIncrease(line_info, NumberOfNewlines(name()));
-  std::string result =
-      absl::StrFormat("%s %s", name(), statements_->Emit(line_info));
+  sink.Append(absl::StrCat(name(), " "));
+  statements_->EmitTo(sink, line_info);
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 std::string Initial::Emit(LineInfo* line_info) const {
+  return EmitToString(*this, line_info);
+}
+
+void Initial::EmitTo(VastSink& sink, LineInfo* line_info) const {
   LineInfoStart(line_info, this);
-  std::string result = absl::StrCat("initial ", statements_->Emit(line_info));
+  sink.Append("initial ");
+  statements_->EmitTo(sink, line_info);
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 AlwaysFlop::AlwaysFlop(LogicRef* clk, Reset rst, VerilogFile* file,
@@ -1938,8 +2110,11 @@ void AlwaysFlop::AddRegister(LogicRef* reg, Expression* reg_next,
 }
 
 std::string AlwaysFlop::Emit(LineInfo* line_info) const {
+  return EmitToString(*this, line_info);
+}
+
+void AlwaysFlop::EmitTo(VastSink& sink, LineInfo* line_info) const {
   LineInfoStart(line_info, this);
-  std::string result;
   std::string sensitivity_list =
       absl::StrCat("posedge ", clk_->Emit(line_info));
   if (rst_.has_value() && rst_->asynchronous) {
@@ -1947,10 +2122,9 @@ std::string AlwaysFlop::Emit(LineInfo* line_info) const {
                           (rst_->active_low ? "negedge" : "posedge"),
                           rst_->signal->Emit(line_info));
   }
-  absl::StrAppendFormat(&result, "always @ (%s) %s", sensitivity_list,
-                        top_block_->Emit(line_info));
+  sink.Append(absl::StrFormat("always @ (%s) ", sensitivity_list));
+  top_block_->EmitTo(sink, line_info);
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 std::string Instantiation::Emit(LineInfo* line_info) const {
@@ -19,6 +19,8 @@
 #define XLS_CODEGEN_VAST_VAST_H_
 
 #include <cstdint>
+#include <cstdio>
+#include <filesystem>  // NOLINT
 #include <limits>
 #include <memory>
 #include <optional>
@@ -36,8 +38,10 @@
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
+#include "xls/common/indent.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/bits_ops.h"
 #include "xls/ir/format_preference.h"
@@ -154,6 +158,96 @@ class LineInfo {
 // characters are replaced with '_'.
 std::string SanitizeIdentifier(std::string_view name);
 
+// An append-only destination for emitted Verilog text. The sink tracks the
+// current indentation and applies it to each line as it is appended, so large
+// constructs such as modules can be emitted without building and re-indenting
+// intermediate strings. Text appended within an indented region is formatted
+// exactly as `Indent` would format the equivalent string: empty lines are not
+// indented and leading empty lines of a region are dropped.
+class VastSink {
+ public:
+  virtual ~VastSink() = default;
+
+  // Appends the given text, which may span multiple lines.
+  void Append(std::string_view text);
+
+  // Starts a region in which each line is indented by an additional `spaces`
+  // spaces. Must be called at the start of a line.
+  void PushIndent(int64_t spaces = kDefaultIndentSpaces);
+
+  // Ends the innermost indented region.
+  void PopIndent();
+
+  // Writes any buffered text to the underlying destination.
+  virtual absl::Status Flush() { return absl::OkStatus(); }
+
+ protected:
+  // Writes the given already-indented text to the underlying destination.
+  virtual void Write(std::string_view text) = 0;
+
+ private:
+  // Indentation in spaces of each indented region, innermost last.
+  std::vector<int64_t> indents_;
+  std::string indent_;
+  // The number of outermost regions in which a non-empty line has been
+  // appended. Because appending a line marks all open regions, the regions
+  // without content are always the innermost ones.
+  int64_t regions_with_content_ = 0;
+  bool at_line_start_ = true;
+};
+
+// A sink which appends to a string.
+class StringVastSink final : public VastSink {
+ public:
+  explicit StringVastSink(std::string* out) : out_(ABSL_DIE_IF_NULL(out)) {}
+
+ protected:
+  void Write(std::string_view text) final { out_->append(text); }
+
+ private:
+  std::string* out_;
+};
+
+// A sink which appends to a cord. Text is accumulated in a buffer and added to
+// the cord in large chunks.
+class CordVastSink final : public VastSink {
+ public:
+  explicit CordVastSink(absl::Cord* out) : out_(ABSL_DIE_IF_NULL(out)) {}
+  ~CordVastSink() override;
+
+  absl::Status Flush() final;
+
+ protected:
+  void Write(std::string_view text) final;
+
+ private:
+  absl::Cord* out_;
+  std::string buffer_;
+};
+
+// A sink which writes to a file through a buffer. Write errors are sticky and
+// reported by `Flush`.
+class FileVastSink final : public VastSink {
+ public:
+  static absl::StatusOr<std::unique_ptr<FileVastSink>> Create(
+      const std::filesystem::path& path);
+  ~FileVastSink() override;
+
+  absl::Status Flush() final;
+
+ protected:
+  void Write(std::string_view text) final;
+
+ private:
+  FileVastSink(std::FILE* file, std::filesystem::path path)
+      : file_(file), path_(std::move(path)) {}
+
+  std::FILE* file_;
+  std::filesystem::path path_;
+  std::string buffer_;
+  absl::Status status_;
+};
+
 // Base type for a VAST node. All nodes are owned by a VerilogFile.
 class VastNode {
  public:
@@ -168,6 +262,13 @@ class VastNode {
 
   virtual std::string Emit(LineInfo* line_info) const = 0;
 
+  // Appends the text of this node to the given sink. Equivalent to appending
+  // the result of `Emit`; nodes which contain many lines override this to
+  // stream their contents rather than building a string.
+  virtual void EmitTo(VastSink& sink, LineInfo* line_info) const {
+    sink.Append(Emit(line_info));
+  }
+
  private:
   VerilogFile* file_;
   SourceInfo loc_;
@@ -671,6 +772,7 @@ class StatementBlock final : public VastNode {
   inline T* Add(const SourceInfo& loc, Args&&... args);
 
   std::string Emit(LineInfo* line_info) const final;
+  void EmitTo(VastSink& sink, LineInfo* line_info) const final;
 
   absl::Span<Statement* const> statements() const { return statements_; }
 
@@ -1509,6 +1611,7 @@ class AlwaysFlop final : public VastNode {
                    Expression* reset_value = nullptr);
 
   std::string Emit(LineInfo* line_info) const final;
+  void EmitTo(VastSink& sink, LineInfo* line_info) const final;
 
  private:
   LogicRef* clk_;
@@ -1550,6 +1653,7 @@ class AlwaysBase : public StructuredProcedure {
       : StructuredProcedure(file, loc),
         sensitivity_list_(sensitivity_list.begin(), sensitivity_list.end()) {}
   std::string Emit(LineInfo* line_info) const override;
+  void EmitTo(VastSink& sink, LineInfo* line_info) const override;
 
  protected:
   virtual std::string name() const = 0;
@@ -1574,6 +1678,7 @@ class AlwaysComb final : public AlwaysBase {
   explicit AlwaysComb(VerilogFile* file, const SourceInfo& loc)
       : AlwaysBase({}, file, loc) {}
   std::string Emit(LineInfo* line_info) const final;
+  void EmitTo(VastSink& sink, LineInfo* line_info) const final;
 
  protected:
   std::string name() const final { return "always_comb"; }
@@ -1594,6 +1699,7 @@ class Initial final : public StructuredProcedure {
   using StructuredProcedure::StructuredProcedure;
 
   std::string Emit(LineInfo* line_info) const final;
+  void EmitTo(VastSink& sink, LineInfo* line_info) const final;
 };
 
 class Concat final : public Expression {
@@ -2197,6 +2303,7 @@ class ModuleSection final : public VastNode {
   const std::vector<ModuleMember>& members() const { return members_; }
 
   std::string Emit(LineInfo* line_info) const final;
+  void EmitTo(VastSink& sink, LineInfo* line_info) const final;
 
  private:
   std::vector<ModuleMember> members_;
@@ -2301,6 +2408,7 @@ class Module final : public VastNode {
   const std::string& name() const { return name_; }
 
   std::string Emit(LineInfo* line_info) const final;
+  void EmitTo(VastSink& sink, LineInfo* line_info) const final;
 
  private:
   // Add the given Def as a port on the module.
@@ -2372,6 +2480,7 @@ class VerilogPackageSection final : public VastNode {
   const std::vector<VerilogPackageMember>& members() const { return members_; }
 
   std::string Emit(LineInfo* line_info) const final;
+  void EmitTo(VastSink& sink, LineInfo* line_info) const final;
 
  private:
   std::vector<VerilogPackageMember> members_;
@@ -2406,6 +2515,7 @@ class VerilogPackage final : public VastNode {
   const std::string& name() const { return name_; }
 
   std::string Emit(LineInfo* line_info) const final;
+  void EmitTo(VastSink& sink, LineInfo* line_info) const final;
 
  private:
   std::string name_;
@@ -2459,6 +2569,7 @@ class VerilogFile {
   }
 
   std::string Emit(LineInfo* line_info = nullptr) const;
+  void EmitTo(VastSink& sink, LineInfo* line_info = nullptr) const;
 
   verilog::Slice* Slice(IndexableExpression* subject, Expression* hi,
                         Expression* lo, const SourceInfo& loc) {
@@ -15,6 +15,7 @@
 #include "xls/codegen/vast/vast.h"
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -25,9 +26,14 @@
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_file.h"
+#include "xls/common/indent.h"
 #include "xls/common/status/matchers.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/format_preference.h"
@@ -2356,6 +2362,97 @@ TEST_P(VastTest, SimpleGenerateLoop) {
 endmodule)");
 }
 
+TEST_P(VastTest, SinkIndentationMatchesIndent) {
+  for (std::string_view text :
+       {"", "a", "a\nb", "\n\na\n\nb\n", "a\n", "\n", "  a\n\n  b"}) {
+    std::string out;
+    StringVastSink sink(&out);
+    sink.Append("x\n");
+    sink.PushIndent();
+    sink.Append(text);
+    sink.PushIndent(4);
+    sink.Append(text);
+    sink.PopIndent();
+    sink.PopIndent();
+    sink.Append("\ny");
+    EXPECT_EQ(out, absl::StrCat("x\n", Indent(absl::StrCat(text, Indent(text, 4))),
+                                "\ny"))
+        << "text: " << absl::CEscape(text);
+  }
+}
+
+TEST_P(VastTest, EmitToSinkMatchesEmit) {
+  VerilogFile f(GetFileType());
+  f.AddInclude("foo.v", SourceInfo());
+  f.Add(f.Make<BlankLine>(SourceInfo()));
+  Module* m = f.AddModule("top", SourceInfo());
+  LogicRef* clk =
+      m->AddInput("clk", f.BitVectorType(1, SourceInfo()), SourceInfo());
+  LogicRef* rst =
+      m->AddInput("rst", f.BitVectorType(1, SourceInfo()), SourceInfo());
+  LogicRef* in =
+      m->AddInput("in", f.BitVectorType(8, SourceInfo()), SourceInfo());
+  LogicRef* out =
+      m->AddOutput("out", f.BitVectorType(8, SourceInfo()), SourceInfo());
+  ModuleSection* section = m->top()->Add<ModuleSection>(SourceInfo());
+  section->Add<Comment>(SourceInfo(), "Registers.");
+  LogicRef* r = m->AddReg("r", f.BitVectorType(8, SourceInfo()), SourceInfo(),
+                          /*init=*/nullptr, section);
+  m->top()->Add<ModuleSection>(SourceInfo());
+  m->Add<BlankLine>(SourceInfo());
+  AlwaysFlop* af = m->Add<AlwaysFlop>(
+      SourceInfo(), clk, Reset{.signal = rst, .asynchronous = false,
+                               .active_low = false});
+  af->AddRegister(r, in, SourceInfo(), f.Literal(0, 8, SourceInfo()));
+  m->Add<ContinuousAssignment>(SourceInfo(), out, r);
+
+  LineInfo line_info;
+  std::string text = f.Emit(&line_info);
+  EXPECT_EQ(text, R"(`include "foo.v"
+
+module top(
+  input wire clk,
+  input wire rst,
+  input wire [7:0] in,
+  output wire [7:0] out
+);
+  // Registers.
+  reg [7:0] r;
+
+  always @ (posedge clk) begin
+    if (rst) begin
+      r <= 8'h00;
+    end else begin
+      r <= in;
+    end
+  end
+  assign out = r;
+endmodule
+)");
+
+  LineInfo sink_line_info;
+  std::string sink_text;
+  StringVastSink string_sink(&sink_text);
+  f.EmitTo(string_sink, &sink_line_info);
+  EXPECT_EQ(sink_text, text);
+  EXPECT_EQ(sink_line_info.LookupNode(af), line_info.LookupNode(af));
+  EXPECT_EQ(sink_line_info.LookupNode(m), line_info.LookupNode(m));
+
+  absl::Cord cord;
+  {
+    CordVastSink cord_sink(&cord);
+    f.EmitTo(cord_sink);
+  }
+  EXPECT_EQ(std::string(cord), text);
+
+  XLS_ASSERT_OK_AND_ASSIGN(TempFile temp_file, TempFile::Create(".v"));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<FileVastSink> file_sink,
+                           FileVastSink::Create(temp_file.path()));
+  f.EmitTo(*file_sink);
+  XLS_ASSERT_OK(file_sink->Flush());
+  EXPECT_THAT(GetFileContents(temp_file.path()), IsOkAndHolds(text));
+}
+
 INSTANTIATE_TEST_SUITE_P(VastTestInstantiation, VastTest,
                          testing::Values(false, true),
                          [](const testing::TestParamInfo<bool>& info) {
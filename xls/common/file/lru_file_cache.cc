@@ -0,0 +1,182 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/file/lru_file_cache.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls {
+
+/* static */ absl::StatusOr<std::unique_ptr<LruFileCache>> LruFileCache::Create(
+    std::filesystem::path directory, std::string_view entry_suffix,
+    int64_t max_bytes) {
+  if (max_bytes <= 0) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Cache size bound must be positive, got %d", max_bytes));
+  }
+  XLS_RETURN_IF_ERROR(RecursivelyCreateDir(directory));
+  return absl::WrapUnique(new LruFileCache(
+      std::move(directory), std::string(entry_suffix), max_bytes));
+}
+
+/* static */ void LruFileCache::AppendUint64(uint64_t value, std::string& out) {
+  char bytes[sizeof(value)];
+  std::memcpy(bytes, &value, sizeof(value));
+  out.append(bytes, sizeof(value));
+}
+
+/* static */ bool LruFileCache::ReadUint64(std::string_view& in,
+                                           uint64_t& value) {
+  if (in.size() < sizeof(value)) {
+    return false;
+  }
+  std::memcpy(&value, in.data(), sizeof(value));
+  in.remove_prefix(sizeof(value));
+  return true;
+}
+
+std::filesystem::path LruFileCache::EntryPath(std::string_view key) const {
+  return directory_ / absl::StrCat(key, entry_suffix_);
+}
+
+std::optional<std::string> LruFileCache::Read(std::string_view key) const {
+  absl::StatusOr<std::string> contents = GetFileContents(EntryPath(key));
+  if (!contents.ok()) {
+    return std::nullopt;
+  }
+  return *std::move(contents);
+}
+
+void LruFileCache::Touch(std::string_view key) const {
+  std::error_code ec;
+  std::filesystem::last_write_time(
+      EntryPath(key), std::filesystem::file_time_type::clock::now(), ec);
+}
+
+void LruFileCache::Remove(std::string_view key) const {
+  std::error_code ec;
+  std::filesystem::remove(EntryPath(key), ec);
+}
+
+absl::Status LruFileCache::Write(std::string_view key,
+                                 std::string_view contents) {
+  // Write to a file of our own and rename it into place, so concurrent readers
+  // never see a partially written entry.
+  static std::atomic<int64_t> temp_counter = 0;
+  std::filesystem::path path = EntryPath(key);
+  std::filesystem::path temp_path =
+      directory_ / absl::StrCat(key, ".tmp.", getpid(), ".",
+                                temp_counter.fetch_add(1));
+  XLS_RETURN_IF_ERROR(SetFileContents(temp_path, contents));
+  std::error_code ec;
+  std::filesystem::rename(temp_path, path, ec);
+  if (ec) {
+    std::filesystem::remove(temp_path, ec);
+    return absl::InternalError(absl::StrFormat(
+        "Unable to write cache entry %s: %s", path.string(), ec.message()));
+  }
+  bool evict;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (estimated_bytes_.has_value()) {
+      *estimated_bytes_ += contents.size();
+    }
+    evict = !estimated_bytes_.has_value() || *estimated_bytes_ > max_bytes_;
+  }
+  if (evict) {
+    Evict();
+  }
+  return absl::OkStatus();
+}
+
+void LruFileCache::Evict() {
+  struct Entry {
+    std::filesystem::path path;
+    std::filesystem::file_time_type last_used;
+    int64_t size;
+  };
+  std::vector<Entry> entries;
+  int64_t total_bytes = 0;
+  std::error_code ec;
+  for (const std::filesystem::directory_entry& file :
+       std::filesystem::directory_iterator(directory_, ec)) {
+    if (file.path().extension() != entry_suffix_) {
+      continue;
+    }
+    std::error_code file_ec;
+    int64_t size = file.file_size(file_ec);
+    std::filesystem::file_time_type last_used = file.last_write_time(file_ec);
+    if (file_ec) {
+      // Removed concurrently.
+      continue;
+    }
+    entries.push_back(
+        Entry{.path = file.path(), .last_used = last_used, .size = size});
+    total_bytes += size;
+  }
+  if (total_bytes <= max_bytes_) {
+    absl::MutexLock lock(&mutex_);
+    estimated_bytes_ = total_bytes;
+    return;
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) {
+              return a.last_used < b.last_used;
+            });
+  int64_t evicted = 0;
+  for (const Entry& entry : entries) {
+    if (total_bytes <= max_bytes_) {
+      break;
+    }
+    if (std::filesystem::remove(entry.path, ec)) {
+      ++evicted;
+    }
+    total_bytes -= entry.size;
+  }
+  VLOG(1) << absl::StreamFormat("Evicted %d cache entries from %s", evicted,
+                                directory_.string());
+  absl::MutexLock lock(&mutex_);
+  evictions_ += evicted;
+  estimated_bytes_ = total_bytes;
+}
+
+int64_t LruFileCache::evictions() const {
+  absl::MutexLock lock(&mutex_);
+  return evictions_;
+}
+
+}  // namespace xls
@@ -0,0 +1,111 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_FILE_LRU_FILE_CACHE_H_
+#define XLS_COMMON_FILE_LRU_FILE_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+
+namespace xls {
+
+// A directory of files ("entries"), each named by a key, which persists across
+// processes. Once the entries exceed the size bound the least recently used
+// ones are removed.
+//
+// The directory may be shared between threads and between processes: entries
+// are written to temporary files and renamed into place, so readers never see
+// a partially written entry. To avoid scanning the directory on every write,
+// each instance keeps a running estimate of the size of the directory, updated
+// by its own writes and corrected whenever it scans; the directory is only
+// scanned once the estimate exceeds the bound. Entries written by other
+// instances may therefore take the directory past the bound until this
+// instance next scans it.
+//
+// The contents of entries are up to the user, who should treat unreadable or
+// malformed entries as missing.
+class LruFileCache {
+ public:
+  // Creates a cache whose entries are the files in `directory` named
+  // `<key><entry_suffix>`, where `entry_suffix` is a file extension such as
+  // ".cache". The directory is created if it doesn't exist.
+  static absl::StatusOr<std::unique_ptr<LruFileCache>> Create(
+      std::filesystem::path directory, std::string_view entry_suffix,
+      int64_t max_bytes);
+
+  // Returns the contents of the entry with the given key, or std::nullopt if
+  // there is no such entry.
+  std::optional<std::string> Read(std::string_view key) const;
+
+  // Marks the entry with the given key as recently used.
+  void Touch(std::string_view key) const;
+
+  // Removes the entry with the given key, e.g. because it is malformed.
+  void Remove(std::string_view key) const;
+
+  // Writes the entry with the given key, replacing any existing one, then
+  // removes least recently used entries if the bound may have been exceeded.
+  absl::Status Write(std::string_view key, std::string_view contents);
+
+  // Returns the number of entries this instance has removed to keep the
+  // directory within its size bound.
+  int64_t evictions() const;
+
+  std::filesystem::path EntryPath(std::string_view key) const;
+
+  const std::filesystem::path& directory() const { return directory_; }
+  int64_t max_bytes() const { return max_bytes_; }
+
+  // Helpers for encoding the contents of entries. Integers are 64-bit and
+  // host-endian, so entries should only be read on the host type which wrote
+  // them. ReadUint64 consumes the integer from the front of `in`, returning
+  // false if `in` is too short.
+  static void AppendUint64(uint64_t value, std::string& out);
+  static bool ReadUint64(std::string_view& in, uint64_t& value);
+
+ private:
+  LruFileCache(std::filesystem::path directory, std::string entry_suffix,
+               int64_t max_bytes)
+      : directory_(std::move(directory)),
+        entry_suffix_(std::move(entry_suffix)),
+        max_bytes_(max_bytes) {}
+
+  // Removes the least recently used entries until the entries fit in
+  // max_bytes_, and resets the size estimate to the size of those left.
+  void Evict();
+
+  const std::filesystem::path directory_;
+  const std::string entry_suffix_;
+  const int64_t max_bytes_;
+
+  mutable absl::Mutex mutex_;
+  int64_t evictions_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Estimated total size of the entries in the directory; unknown until the
+  // directory is first scanned.
+  std::optional<int64_t> estimated_bytes_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_FILE_LRU_FILE_CACHE_H_
@@ -0,0 +1,140 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/file/lru_file_cache.h"
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::testing::Optional;
+
+void SetLastUsed(const LruFileCache& cache, std::string_view key,
+                 std::chrono::minutes age) {
+  std::filesystem::last_write_time(
+      cache.EntryPath(key),
+      std::filesystem::file_time_type::clock::now() - age);
+}
+
+TEST(LruFileCacheTest, WriteReadAndRemove) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<LruFileCache> cache,
+      LruFileCache::Create(temp_dir.path(), ".entry", /*max_bytes=*/1000));
+  EXPECT_EQ(cache->EntryPath("a"), temp_dir.path() / "a.entry");
+  EXPECT_EQ(cache->Read("a"), std::nullopt);
+
+  XLS_ASSERT_OK(cache->Write("a", "first"));
+  EXPECT_THAT(cache->Read("a"), Optional(std::string("first")));
+  XLS_ASSERT_OK(cache->Write("a", "second"));
+  EXPECT_THAT(cache->Read("a"), Optional(std::string("second")));
+
+  cache->Remove("a");
+  EXPECT_EQ(cache->Read("a"), std::nullopt);
+  EXPECT_EQ(cache->evictions(), 0);
+}
+
+TEST(LruFileCacheTest, EncodesIntegers) {
+  std::string contents;
+  LruFileCache::AppendUint64(42, contents);
+  LruFileCache::AppendUint64(~uint64_t{0}, contents);
+  std::string_view in = contents;
+  uint64_t value;
+  ASSERT_TRUE(LruFileCache::ReadUint64(in, value));
+  EXPECT_EQ(value, 42);
+  ASSERT_TRUE(LruFileCache::ReadUint64(in, value));
+  EXPECT_EQ(value, ~uint64_t{0});
+  EXPECT_TRUE(in.empty());
+  EXPECT_FALSE(LruFileCache::ReadUint64(in, value));
+}
+
+TEST(LruFileCacheTest, EvictsLeastRecentlyUsed) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<LruFileCache> cache,
+      LruFileCache::Create(temp_dir.path(), ".entry", /*max_bytes=*/250));
+  // Files other than entries don't count towards the bound.
+  XLS_ASSERT_OK(
+      SetFileContents(temp_dir.path() / "unrelated", std::string(1000, 'x')));
+  std::string contents(100, 'x');
+
+  XLS_ASSERT_OK(cache->Write("a", contents));
+  SetLastUsed(*cache, "a", std::chrono::minutes(60));
+  XLS_ASSERT_OK(cache->Write("b", contents));
+  SetLastUsed(*cache, "b", std::chrono::minutes(30));
+  // Using `a` makes `b` the least recently used entry.
+  cache->Touch("a");
+  XLS_ASSERT_OK(cache->Write("c", contents));
+
+  EXPECT_EQ(cache->evictions(), 1);
+  EXPECT_NE(cache->Read("a"), std::nullopt);
+  EXPECT_EQ(cache->Read("b"), std::nullopt);
+  EXPECT_NE(cache->Read("c"), std::nullopt);
+  EXPECT_TRUE(std::filesystem::exists(temp_dir.path() / "unrelated"));
+}
+
+TEST(LruFileCacheTest, ScansOnlyOnceSizeEstimateExceedsBound) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<LruFileCache> cache,
+      LruFileCache::Create(temp_dir.path(), ".entry", /*max_bytes=*/250));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<LruFileCache> other,
+      LruFileCache::Create(temp_dir.path(), ".entry", /*max_bytes=*/250));
+  std::string contents(100, 'x');
+
+  XLS_ASSERT_OK(cache->Write("a", contents));
+  SetLastUsed(*cache, "a", std::chrono::minutes(60));
+  XLS_ASSERT_OK(other->Write("b", contents));
+  // `cache` has not seen `b`, so it only estimates the entries take 200 bytes.
+  XLS_ASSERT_OK(cache->Write("c", contents));
+  EXPECT_EQ(cache->evictions(), 0);
+  EXPECT_NE(cache->Read("b"), std::nullopt);
+
+  // Once the estimate exceeds the bound, it scans the directory and evicts
+  // the least recently used entries.
+  SetLastUsed(*cache, "b", std::chrono::minutes(30));
+  SetLastUsed(*cache, "c", std::chrono::minutes(10));
+  XLS_ASSERT_OK(cache->Write("d", contents));
+  EXPECT_EQ(cache->evictions(), 2);
+  EXPECT_EQ(cache->Read("a"), std::nullopt);
+  EXPECT_EQ(cache->Read("b"), std::nullopt);
+  EXPECT_NE(cache->Read("c"), std::nullopt);
+  EXPECT_NE(cache->Read("d"), std::nullopt);
+}
+
+TEST(LruFileCacheTest, InvalidSizeBound) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  EXPECT_THAT(LruFileCache::Create(temp_dir.path(), ".entry", /*max_bytes=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace xls
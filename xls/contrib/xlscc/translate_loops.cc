@@ -50,6 +50,7 @@
 #include "xls/ir/state_element.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
+#include "xls/passes/partial_info_query_engine.h"
 #include "xls/solvers/z3_ir_translator.h"
 #include "xls/solvers/z3_utils.h"
 #include "z3/src/api/z3_api.h"
@@ -143,6 +144,57 @@ absl::Status Translator::GenerateIR_Loop(
                                   loc);
 }
 
+std::string Translator::LoopTerminationStats::ToString() const {
+  auto tier_string = [](std::string_view name, const Tier& tier) {
+    return absl::StrFormat("%s decided %i/%i in %v", name, tier.decisions,
+                           tier.checks, tier.time);
+  };
+  return absl::StrFormat("%s, %s, %s", tier_string("constant folding", folding),
+                         tier_string("query engine", query_engine),
+                         tier_string("solver", solver));
+}
+
+absl::StatusOr<bool> Translator::LoopConditionMustBeFalse(
+    xls::BValue& bval, const xls::QueryEngine& query_engine,
+    Z3_solver& solver, LoopTerminationStats& stats,
+    const xls::SourceInfo& loc) {
+  // Invalid is interpreted as literal 1
+  if (!bval.valid()) {
+    return false;
+  }
+
+  xls::Stopwatch stopwatch;
+  XLS_RETURN_IF_ERROR(ShortCircuitBVal(bval, loc));
+  if (bval.node()->Is<xls::Literal>()) {
+    stats.folding.Record(stopwatch.GetElapsedTime(), /*decided=*/true);
+    return bval.node()->As<xls::Literal>()->value().IsAllZeros();
+  }
+  stats.folding.Record(stopwatch.GetElapsedTime(), /*decided=*/false);
+
+  // The query engine follows the nodes added to the function as the loop is
+  // unrolled, so it only analyzes each node once.
+  stopwatch.Reset();
+  std::optional<bool> known_false;
+  if (query_engine.IsTracked(bval.node())) {
+    if (query_engine.IsAllZeros(bval.node())) {
+      known_false = true;
+    } else if (query_engine.IsAllOnes(bval.node())) {
+      known_false = false;
+    }
+  }
+  stats.query_engine.Record(stopwatch.GetElapsedTime(),
+                            known_false.has_value());
+  if (known_false.has_value()) {
+    return *known_false;
+  }
+
+  stopwatch.Reset();
+  XLS_ASSIGN_OR_RETURN(bool must_be_false,
+                       SolverBitMustBe(false, bval, solver));
+  stats.solver.Record(stopwatch.GetElapsedTime(), /*decided=*/true);
+  return must_be_false;
+}
+
 absl::Status Translator::GenerateIR_UnrolledLoop(
     bool always_first_iter, bool warn_inferred_loop_type,
     const clang::Stmt* init, const clang::Expr* cond_expr,
@@ -153,6 +205,9 @@ absl::Status Translator::GenerateIR_UnrolledLoop(
 
   XLS_ASSIGN_OR_RETURN(xls::solvers::z3::IrTranslator * z3_translator_parent,
                        GetZ3Translator(context().fb->function()));
+  // The solver is reused by every iteration. Conditions are checked as
+  // assumptions rather than assertions, so nothing needs to be retracted
+  // between checks and what the solver learns carries over.
   Z3_solver solver =
       xls::solvers::z3::CreateSolver(z3_translator_parent->ctx(), 1);
 
@@ -166,6 +221,11 @@ absl::Status Translator::GenerateIR_UnrolledLoop(
     Z3_context ctx_;
     Z3_solver solver_;
   };
+  SolverDeref solver_deref(z3_translator_parent->ctx(), solver);
+
+  xls::PartialInfoQueryEngine query_engine;
+  XLS_RETURN_IF_ERROR(query_engine.Populate(context().fb->function()).status());
+  LoopTerminationStats termination_stats;
 
   // Generate the declaration within a private context
   PushContextGuard for_init_guard(*this, loc);
@@ -224,9 +284,10 @@ absl::Status Translator::GenerateIR_UnrolledLoop(
 
     {
       // We use the relative condition so that returns also stop unrolling
-      XLS_ASSIGN_OR_RETURN(bool condition_must_be_false,
-                           BitMustBe(false, context().relative_condition,
-                                     solver, z3_translator_parent->ctx(), loc));
+      XLS_ASSIGN_OR_RETURN(
+          bool condition_must_be_false,
+          LoopConditionMustBeFalse(context().relative_condition, query_engine,
+                                   solver, termination_stats, loc));
       if (condition_must_be_false) {
         break;
       }
@@ -256,6 +317,14 @@ absl::Status Translator::GenerateIR_UnrolledLoop(
     }
   }
 
+  if (debug_ir_trace_flags_ & DebugIrTraceFlags_OptimizationWarnings &&
+      termination_stats.total_time() > absl::Seconds(0.1)) {
+    LOG(WARNING) << WarningMessage(
+        loc, "Slow loop unrolling termination checks: %s",
+        termination_stats.ToString());
+  }
+  loop_termination_stats_.Add(termination_stats);
+
   if (warn_inferred_loop_type) {
     const int64_t total_io_ops = context().sf->io_ops.size() - io_ops_before;
     const int64_t total_sub_procs =
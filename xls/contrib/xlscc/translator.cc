@@ -5816,6 +5816,12 @@ absl::StatusOr<bool> Translator::BitMustBe(bool assert_value, xls::BValue& bval,
 
   XLS_RETURN_IF_ERROR(ShortCircuitBVal(bval, loc));
 
+  return SolverBitMustBe(assert_value, bval, solver);
+}
+
+absl::StatusOr<bool> Translator::SolverBitMustBe(bool assert_value,
+                                                 xls::BValue bval,
+                                                 Z3_solver& solver) {
   XLS_ASSIGN_OR_RETURN(xls::solvers::z3::IrTranslator * z3_translator,
                        GetZ3Translator(bval.builder()->function()));
   XLS_RETURN_IF_ERROR(bval.node()->Accept(z3_translator));
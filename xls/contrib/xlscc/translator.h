@@ -40,6 +40,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "clang/include/clang/AST/ASTContext.h"
 #include "clang/include/clang/AST/Attr.h"
@@ -71,6 +72,7 @@
 #include "xls/ir/state_element.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
+#include "xls/passes/query_engine.h"
 #include "xls/solvers/z3_ir_translator.h"
 #include "z3/src/api/z3_api.h"
 
@@ -1223,6 +1225,47 @@ class Translator {
     return inst_functions_.at(decl).get();
   }
 
+  // Work done to decide whether an unrolled loop terminates, by each tier of
+  // the decision procedure in LoopConditionMustBeFalse.
+  struct LoopTerminationStats {
+    struct Tier {
+      // Conditions the tier was tried on, and how many of them it decided.
+      int64_t checks = 0;
+      int64_t decisions = 0;
+      absl::Duration time = absl::ZeroDuration();
+
+      void Record(absl::Duration elapsed, bool decided) {
+        ++checks;
+        decisions += decided ? 1 : 0;
+        time += elapsed;
+      }
+      void Add(const Tier& other) {
+        checks += other.checks;
+        decisions += other.decisions;
+        time += other.time;
+      }
+    };
+
+    Tier folding;
+    Tier query_engine;
+    Tier solver;
+
+    void Add(const LoopTerminationStats& other) {
+      folding.Add(other.folding);
+      query_engine.Add(other.query_engine);
+      solver.Add(other.solver);
+    }
+    absl::Duration total_time() const {
+      return folding.time + query_engine.time + solver.time;
+    }
+    std::string ToString() const;
+  };
+
+  // Totals over all the loops unrolled by this translator.
+  const LoopTerminationStats& loop_termination_stats() const {
+    return loop_termination_stats_;
+  }
+
  private:
   friend class CInstantiableTypeAlias;
   friend class CStructType;
@@ -1477,6 +1520,8 @@ class Translator {
   const int64_t warn_unroll_iters_;
   // The rlimit to set for z3 when unrolling loops
   const int64_t z3_rlimit_;
+  // Work done deciding whether unrolled loops terminate, over all loops.
+  LoopTerminationStats loop_termination_stats_;
 
   // Generate an error when an init interval > supported is requested?
   const bool error_on_init_interval_;
@@ -2173,6 +2218,18 @@ class Translator {
   absl::StatusOr<bool> BitMustBe(bool assert_value, xls::BValue& bval,
                                  Z3_solver& solver, Z3_context ctx,
                                  const xls::SourceInfo& loc);
+  // As BitMustBe, for a bval which has already been short circuited.
+  absl::StatusOr<bool> SolverBitMustBe(bool assert_value, xls::BValue bval,
+                                       Z3_solver& solver);
+
+  // Returns whether the loop condition bval must be false, as
+  // BitMustBe(false, ...) does. The condition is first decided by constant
+  // folding, then by the bits query_engine knows, and only if neither is
+  // conclusive by the solver, which is much slower.
+  absl::StatusOr<bool> LoopConditionMustBeFalse(
+      xls::BValue& bval, const xls::QueryEngine& query_engine,
+      Z3_solver& solver, LoopTerminationStats& stats,
+      const xls::SourceInfo& loc);
 
   absl::StatusOr<ConstValue> TranslateBValToConstVal(const CValue& bvalue,
                                                      const xls::SourceInfo& loc,
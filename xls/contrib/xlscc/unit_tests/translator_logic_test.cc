@@ -1601,6 +1601,26 @@ TEST_F(TranslatorLogicTest, ForUnrollShortCircuit2A) {
   Run({{"a", 11}, {"b", 20}}, 111 + 10, content);
 }
 
+// The final condition depends on a parameter, but the bits known about it
+// decide it without the solver.
+TEST_F(TranslatorLogicTest, ForUnrollKnownBitsCondition) {
+  std::string_view content = R"(
+        long long my_package(long long a) {
+         int i=0;
+         #pragma hls_unroll yes
+         for(;i<3 || (a & 3) > 3;++i) {
+           a += 1;
+          }
+         return a+i;
+       })";
+  Run({{"a", 11}}, 11 + 3 + 3, content);
+
+  const xlscc::Translator::LoopTerminationStats& stats =
+      translator_->loop_termination_stats();
+  EXPECT_GT(stats.query_engine.decisions, 0);
+  EXPECT_EQ(stats.solver.checks, 0);
+}
+
 TEST_F(TranslatorLogicTest, ForUnrollShortCircuit3) {
   std::string_view content = R"(
         template<int N>
@@ -17,12 +17,13 @@
 #include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <optional>
 #include <string>
-#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/log/vlog_is_on.h"
@@ -34,21 +35,120 @@
 
 namespace xls {
 
-BinaryDecisionDiagram::BinaryDecisionDiagram() {
-  // Leaf node 0.
-  nodes_.push_back(BddNode(BddVariable(-1), BddNodeIndex(-1), BddNodeIndex(-1),
-                           /*p=*/1));
-  // Leaf node 1.
+namespace {
+
+// The variable of nodes in free slots.
+constexpr BddVariable kFreeVariable = BddVariable(-2);
+
+// The initial number of entries in the computed table.
+constexpr int64_t kInitialCacheEntries = 1024;
+
+constexpr int32_t kSaturatedRefCount = std::numeric_limits<int32_t>::max();
+
+// Returns the largest power of two which is no larger than `n` (and at least
+// one).
+int64_t FloorPowerOfTwo(int64_t n) {
+  int64_t result = 1;
+  while (result * 2 <= n) {
+    result *= 2;
+  }
+  return result;
+}
+
+}  // namespace
+
+BinaryDecisionDiagram::BinaryDecisionDiagram(int64_t max_cache_entries)
+    : max_cache_entries_(FloorPowerOfTwo(max_cache_entries)) {
+  // Leaf node 1; zero is its complement. The leaf is never reclaimed.
   nodes_.push_back(BddNode(BddVariable(-1), BddNodeIndex(-1), BddNodeIndex(-1),
                            /*p=*/1));
+  nodes_.back().ref_count = kSaturatedRefCount;
+  node_count_ = 1;
+  stats_.peak_node_count = 1;
+  cache_.resize(std::min(kInitialCacheEntries, max_cache_entries_));
+}
+
+int32_t BinaryDecisionDiagram::AllocateNode(const BddNode& node) {
+  int32_t slot;
+  if (free_slots_.empty()) {
+    // The slot is shifted left by one bit to form a BddNodeIndex.
+    CHECK_LT(nodes_.size(), std::numeric_limits<int32_t>::max() / 2);
+    slot = nodes_.size();
+    nodes_.push_back(node);
+  } else {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+    nodes_[slot] = node;
+  }
+  ++node_count_;
+  stats_.peak_node_count = std::max(stats_.peak_node_count, node_count_);
+  return slot;
+}
+
+void BinaryDecisionDiagram::IncrementRefCount(int32_t slot) {
+  int32_t& ref_count = nodes_[slot].ref_count;
+  if (ref_count != kSaturatedRefCount) {
+    ++ref_count;
+  }
+}
+
+void BinaryDecisionDiagram::DecrementRefCount(int32_t slot) {
+  int32_t& ref_count = nodes_[slot].ref_count;
+  if (ref_count != kSaturatedRefCount) {
+    CHECK_GT(ref_count, 0) << "Dereferenced an unreferenced BDD node";
+    --ref_count;
+  }
+}
+
+void BinaryDecisionDiagram::FreeNode(int32_t slot) {
+  std::vector<int32_t> worklist = {slot};
+  while (!worklist.empty()) {
+    int32_t current = worklist.back();
+    worklist.pop_back();
+    BddNode& node = nodes_[current];
+    DCHECK_EQ(node.ref_count, 0);
+    unique_tables_[node.variable.value()].erase(
+        std::make_pair(node.high, node.low));
+    for (BddNodeIndex child : {node.high, node.low}) {
+      int32_t& ref_count = nodes_[NodeSlot(child)].ref_count;
+      if (ref_count != kSaturatedRefCount && --ref_count == 0) {
+        worklist.push_back(NodeSlot(child));
+      }
+    }
+    node = BddNode();
+    node.variable = kFreeVariable;
+    free_slots_.push_back(current);
+    --node_count_;
+    ++stats_.nodes_freed;
+  }
+}
+
+int64_t BinaryDecisionDiagram::GarbageCollect() {
+  const int64_t node_count_before = node_count_;
+  for (int32_t slot = 1; slot < nodes_.size(); ++slot) {
+    if (nodes_[slot].variable != kFreeVariable &&
+        nodes_[slot].ref_count == 0) {
+      FreeNode(slot);
+    }
+  }
+  // Cached results may refer to reclaimed nodes whose slots will be reused.
+  ClearCache();
+  ++stats_.garbage_collections;
+  VLOG(2) << absl::StreamFormat("BDD garbage collection reclaimed %d of %d nodes",
+                                node_count_before - node_count_,
+                                node_count_before);
+  return node_count_before - node_count_;
 }
 
 BddNodeIndex BinaryDecisionDiagram::CreateVariableBaseNode(BddVariable var) {
   const BddNodeIndex high = one();
   const BddNodeIndex low = zero();
   const int32_t paths = 2;
-  nodes_.emplace_back(var, high, low, paths);
-  return BddNodeIndex(nodes_.size() - 1);
+  int32_t slot = AllocateNode(BddNode(var, high, low, paths));
+  // Variables are never reclaimed.
+  nodes_[slot].ref_count = kSaturatedRefCount;
+  unique_tables_[var.value()].emplace(std::make_pair(high, low), slot);
+  return MakeIndex(slot, /*complemented=*/false);
 }
 
 BddNodeIndex BinaryDecisionDiagram::GetOrCreateNode(BddVariable var,
@@ -58,97 +158,327 @@ BddNodeIndex BinaryDecisionDiagram::GetOrCreateNode(BddVariable var,
     return low;
   }
 
-  // If low == 0 and high == 1, then this is a variable base node and is kept
-  // in the variable_base_nodes_ vector.
-  if (low == zero() && high == one()) {
-    return variable_base_nodes_[var.value()];
+  // The high child of a node is never complemented; the function with a
+  // complemented high child is represented as the complement of the node with
+  // both children complemented.
+  const bool complemented = IsComplemented(high);
+  if (complemented) {
+    high = Complement(high);
+    low = Complement(low);
   }
 
-  // Otherwise, this is a normal node and is kept in node_map_.
-  NodeKey key = std::make_tuple(var, high, low);
-  auto it = node_map_.lazy_emplace(key, [&](const auto& ctor) {
+  UniqueTable& table = unique_tables_[var.value()];
+  auto [it, inserted] = table.try_emplace(std::make_pair(high, low), 0);
+  if (inserted) {
     // Compute the number of paths that the new node will have to the terminal
     // nodes 0 and 1. Use int64s to avoid overflowing and saturate at INT32_MAX.
     int32_t paths =
         std::min(static_cast<int64_t>(GetNode(low).path_count) +
                      GetNode(high).path_count,
                  static_cast<int64_t>(std::numeric_limits<int32_t>::max()));
-    nodes_.emplace_back(var, high, low, paths);
-    BddNodeIndex node_index = BddNodeIndex(nodes_.size() - 1);
-    ctor(key, node_index);
-  });
-  return it->second;
+    it->second = AllocateNode(BddNode(var, high, low, paths));
+    IncrementRefCount(NodeSlot(high));
+    IncrementRefCount(NodeSlot(low));
+  }
+  return MakeIndex(it->second, complemented);
 }
 
-BddNodeIndex BinaryDecisionDiagram::Restrict(BddNodeIndex expr, BddVariable var,
-                                             bool value) {
-  if (expr == zero() || expr == one()) {
+BddNodeIndex BinaryDecisionDiagram::Cofactor(BddNodeIndex expr, int32_t level,
+                                             bool value) const {
+  const int32_t expr_level = Level(expr);
+  CHECK_LE(level, expr_level);
+  if (expr_level != level) {
     return expr;
   }
+  const BddNode& node = nodes_[NodeSlot(expr)];
+  BddNodeIndex child = value ? node.high : node.low;
+  return IsComplemented(expr) ? Complement(child) : child;
+}
 
-  const BddNode& node = GetNode(expr);
-  CHECK_LE(var, node.variable);
-  if (node.variable == var) {
-    return value ? node.high : node.low;
+int64_t BinaryDecisionDiagram::CacheSlot(BddNodeIndex cond,
+                                         BddNodeIndex if_true,
+                                         BddNodeIndex if_false) const {
+  return absl::HashOf(cond.value(), if_true.value(), if_false.value()) &
+         (cache_.size() - 1);
+}
+
+std::optional<BddNodeIndex> BinaryDecisionDiagram::LookupCache(
+    BddNodeIndex cond, BddNodeIndex if_true, BddNodeIndex if_false) {
+  ++stats_.cache_lookups;
+  const CacheEntry& entry = cache_[CacheSlot(cond, if_true, if_false)];
+  if (entry.cond == cond && entry.if_true == if_true &&
+      entry.if_false == if_false) {
+    ++stats_.cache_hits;
+    return entry.result;
+  }
+  return std::nullopt;
+}
+
+void BinaryDecisionDiagram::InsertCache(BddNodeIndex cond,
+                                        BddNodeIndex if_true,
+                                        BddNodeIndex if_false,
+                                        BddNodeIndex result) {
+  cache_[CacheSlot(cond, if_true, if_false)] =
+      CacheEntry{.cond = cond,
+                 .if_true = if_true,
+                 .if_false = if_false,
+                 .result = result};
+}
+
+void BinaryDecisionDiagram::ClearCache() {
+  std::fill(cache_.begin(), cache_.end(), CacheEntry());
+}
+
+void BinaryDecisionDiagram::MaybeGrowCache() {
+  if (cache_.size() >= max_cache_entries_ || node_count_ <= cache_.size()) {
+    return;
+  }
+  int64_t new_size = cache_.size();
+  while (new_size < node_count_ && new_size < max_cache_entries_) {
+    new_size *= 2;
+  }
+  std::vector<CacheEntry> old_cache(new_size);
+  std::swap(old_cache, cache_);
+  for (const CacheEntry& entry : old_cache) {
+    if (entry.cond != BddNodeIndex(-1)) {
+      InsertCache(entry.cond, entry.if_true, entry.if_false, entry.result);
+    }
   }
-  return expr;
 }
 
 BddNodeIndex BinaryDecisionDiagram::IfThenElse(BddNodeIndex cond,
                                                BddNodeIndex if_true,
                                                BddNodeIndex if_false) {
+  MaybeGrowCache();
+  return IteRecursive(cond, if_true, if_false);
+}
+
+BddNodeIndex BinaryDecisionDiagram::IteRecursive(BddNodeIndex cond,
+                                                 BddNodeIndex if_true,
+                                                 BddNodeIndex if_false) {
   if (cond == one()) {
     return if_true;
   }
   if (cond == zero()) {
     return if_false;
   }
-  if (if_true == one() && if_false == zero()) {
-    return cond;
+  // ITE(a, a, c) == ITE(a, 1, c), ITE(a, !a, c) == ITE(a, 0, c), etc.
+  if (if_true == cond) {
+    if_true = one();
+  } else if (if_true == Complement(cond)) {
+    if_true = zero();
+  }
+  if (if_false == cond) {
+    if_false = zero();
+  } else if (if_false == Complement(cond)) {
+    if_false = one();
   }
   if (if_true == if_false) {
     return if_true;
   }
-  auto key = std::make_tuple(cond, if_true, if_false);
-  auto it = ite_map_.find(key);
-  if (it != ite_map_.end()) {
-    return it->second;
+  if (if_true == one() && if_false == zero()) {
+    return cond;
+  }
+  if (if_true == zero() && if_false == one()) {
+    return Complement(cond);
   }
 
-  // The expression is non-trivial and has not been computed before. Recursively
-  // decompose the expression by peeling away the first variable and performing
-  // a Shannon decomposition.
+  // Put AND and OR in a canonical form to improve the computed table hit rate:
+  // ITE(a, b, 0) == ITE(b, a, 0) and ITE(a, 1, b) == ITE(b, 1, a).
+  if (if_false == zero() && NodeSlot(if_true) < NodeSlot(cond)) {
+    std::swap(cond, if_true);
+  } else if (if_true == one() && NodeSlot(if_false) < NodeSlot(cond)) {
+    std::swap(cond, if_false);
+  }
 
-  // First, find the lowest-index variable amongst all expressions. In all paths
-  // through the BDD the variable indices are strictly increasing.
-  BddVariable min_var = GetNode(cond).variable;
-  // Only non-leaf nodes (not zero or one) have associated variables.
-  if (if_true != zero() && if_true != one()) {
-    min_var = std::min(min_var, GetNode(if_true).variable);
+  // Normalize so the condition and if-true expressions are uncomplemented:
+  //   ITE(!a, b, c) == ITE(a, c, b)
+  //   ITE(a, !b, c) == !ITE(a, b, !c)
+  if (IsComplemented(cond)) {
+    cond = Complement(cond);
+    std::swap(if_true, if_false);
+  }
+  bool complement_result = false;
+  if (IsComplemented(if_true)) {
+    if_true = Complement(if_true);
+    if_false = Complement(if_false);
+    complement_result = true;
   }
-  if (if_false != zero() && if_false != one()) {
-    min_var = std::min(min_var, GetNode(if_false).variable);
+  auto finish = [&](BddNodeIndex result) {
+    return complement_result ? Complement(result) : result;
+  };
+
+  if (std::optional<BddNodeIndex> cached =
+          LookupCache(cond, if_true, if_false)) {
+    return finish(*cached);
   }
 
+  // The expression is non-trivial and has not been computed recently.
+  // Recursively decompose the expression by peeling away the first variable
+  // and performing a Shannon decomposition.
+
+  // First, find the variable at the lowest level amongst all expressions. In
+  // all paths through the BDD the variable levels are strictly increasing.
+  // The leaves are below every variable.
+  const int32_t level =
+      std::min({Level(cond), Level(if_true), Level(if_false)});
+
   // Perform a Shannon expansion about the variable where Shannon expansion is
   // the identity:
   //
   //   F(x0, x1, ..) = !x0 && F(0, x1, ...) + x0 && F(1, x1, ...)
   //
-  BddNodeIndex true_cofactor = IfThenElse(Restrict(cond, min_var, true),
-                                          Restrict(if_true, min_var, true),
-                                          Restrict(if_false, min_var, true));
-  BddNodeIndex false_cofactor = IfThenElse(Restrict(cond, min_var, false),
-                                           Restrict(if_true, min_var, false),
-                                           Restrict(if_false, min_var, false));
-
-  if (true_cofactor == false_cofactor) {
-    ite_map_[key] = true_cofactor;
-    return true_cofactor;
-  }
-  BddNodeIndex expr = GetOrCreateNode(min_var, true_cofactor, false_cofactor);
-  ite_map_[key] = expr;
-  return expr;
+  BddNodeIndex true_cofactor = IteRecursive(Cofactor(cond, level, true),
+                                            Cofactor(if_true, level, true),
+                                            Cofactor(if_false, level, true));
+  BddNodeIndex false_cofactor = IteRecursive(Cofactor(cond, level, false),
+                                             Cofactor(if_true, level, false),
+                                             Cofactor(if_false, level, false));
+  BddNodeIndex result =
+      GetOrCreateNode(level_to_var_[level], true_cofactor, false_cofactor);
+  InsertCache(cond, if_true, if_false, result);
+  return finish(result);
+}
+
+void BinaryDecisionDiagram::SwapAdjacentLevels(int32_t level) {
+  const BddVariable x = level_to_var_[level];
+  const BddVariable y = level_to_var_[level + 1];
+
+  // Nodes of `x` which do not depend on `y` are unaffected by the swap. The
+  // others, with children f1 and f0, are rewritten in place (keeping their
+  // slots, and so the BddNodeIndex of every expression) to
+  //
+  //   y ? (x ? f11 : f01) : (x ? f10 : f00)
+  //
+  // where fab is the cofactor of fa with y = b.
+  UniqueTable& x_table = unique_tables_[x.value()];
+  std::vector<int32_t> dependent_on_y;
+  for (const auto& [children, slot] : x_table) {
+    if (Level(children.first) == level + 1 ||
+        Level(children.second) == level + 1) {
+      dependent_on_y.push_back(slot);
+    }
+  }
+
+  level_to_var_[level] = y;
+  level_to_var_[level + 1] = x;
+  var_to_level_[y.value()] = level;
+  var_to_level_[x.value()] = level + 1;
+
+  std::vector<int32_t> maybe_unreferenced;
+  for (int32_t slot : dependent_on_y) {
+    const BddNodeIndex f1 = nodes_[slot].high;
+    const BddNodeIndex f0 = nodes_[slot].low;
+    x_table.erase(std::make_pair(f1, f0));
+    const BddNodeIndex high = GetOrCreateNode(x, Cofactor(f1, level, true),
+                                              Cofactor(f0, level, true));
+    const BddNodeIndex low = GetOrCreateNode(x, Cofactor(f1, level, false),
+                                             Cofactor(f0, level, false));
+    // `f1` is uncomplemented so its cofactors, and `high`, are too.
+    DCHECK(!IsComplemented(high));
+    DCHECK_NE(high, low);
+    IncrementRefCount(NodeSlot(high));
+    IncrementRefCount(NodeSlot(low));
+    BddNode& node = nodes_[slot];
+    node.variable = y;
+    node.high = high;
+    node.low = low;
+    CHECK(unique_tables_[y.value()]
+              .emplace(std::make_pair(high, low), slot)
+              .second);
+    DecrementRefCount(NodeSlot(f1));
+    DecrementRefCount(NodeSlot(f0));
+    maybe_unreferenced.push_back(NodeSlot(f1));
+    maybe_unreferenced.push_back(NodeSlot(f0));
+  }
+  for (int32_t slot : maybe_unreferenced) {
+    if (nodes_[slot].variable != kFreeVariable &&
+        nodes_[slot].ref_count == 0) {
+      FreeNode(slot);
+    }
+  }
+  ++stats_.swaps;
+}
+
+void BinaryDecisionDiagram::SiftVariable(BddVariable var, double max_growth) {
+  const int32_t last_level = level_to_var_.size() - 1;
+  const int32_t start_level = var_to_level_[var.value()];
+  const int64_t size_limit = static_cast<int64_t>(node_count_ * max_growth);
+  int32_t level = start_level;
+  int32_t best_level = level;
+  int64_t best_size = node_count_;
+  auto record_size = [&]() {
+    if (node_count_ < best_size) {
+      best_size = node_count_;
+      best_level = level;
+    }
+  };
+
+  // Move the variable towards the bottom, then back up past its starting
+  // level towards the top, and finally to the best level seen.
+  while (level < last_level && node_count_ <= size_limit) {
+    SwapAdjacentLevels(level);
+    ++level;
+    record_size();
+  }
+  while (level > 0 && (level > start_level || node_count_ <= size_limit)) {
+    SwapAdjacentLevels(level - 1);
+    --level;
+    record_size();
+  }
+  while (level < best_level) {
+    SwapAdjacentLevels(level);
+    ++level;
+  }
+  while (level > best_level) {
+    SwapAdjacentLevels(level - 1);
+    --level;
+  }
+}
+
+void BinaryDecisionDiagram::RecomputePathCounts() {
+  for (int64_t level = level_to_var_.size() - 1; level >= 0; --level) {
+    for (const auto& [children, slot] :
+         unique_tables_[level_to_var_[level].value()]) {
+      nodes_[slot].path_count = static_cast<int32_t>(std::min(
+          static_cast<int64_t>(GetNode(children.first).path_count) +
+              GetNode(children.second).path_count,
+          static_cast<int64_t>(std::numeric_limits<int32_t>::max())));
+    }
+  }
+}
+
+void BinaryDecisionDiagram::Reorder(double max_growth) {
+  GarbageCollect();
+  const int64_t node_count_before = node_count_;
+
+  // Sift the variables with the most nodes first.
+  std::vector<BddVariable> variables(level_to_var_.begin(),
+                                     level_to_var_.end());
+  std::stable_sort(variables.begin(), variables.end(),
+                   [&](BddVariable a, BddVariable b) {
+                     return unique_tables_[a.value()].size() >
+                            unique_tables_[b.value()].size();
+                   });
+  for (BddVariable var : variables) {
+    SiftVariable(var, max_growth);
+  }
+  RecomputePathCounts();
+  // Reordering reclaims nodes whose slots will be reused.
+  ClearCache();
+  ++stats_.reorderings;
+  VLOG(2) << absl::StreamFormat("BDD reordering reduced %d nodes to %d",
+                                node_count_before, node_count_);
+}
+
+int64_t BinaryDecisionDiagram::max_path_count() const {
+  int64_t result = 0;
+  for (const BddNode& node : nodes_) {
+    if (node.variable != kFreeVariable) {
+      result = std::max<int64_t>(result, node.path_count);
+    }
+  }
+  return result;
 }
 
 template <typename T>
@@ -161,6 +491,9 @@ void ReserveVector(int64_t new_size, std::vector<T>& vec) {
 
 BddNodeIndex BinaryDecisionDiagram::NewVariable() {
   BddVariable var = BddVariable(variable_base_nodes_.size());
+  var_to_level_.push_back(level_to_var_.size());
+  level_to_var_.push_back(var);
+  unique_tables_.emplace_back();
   BddNodeIndex index = CreateVariableBaseNode(var);
   // Simply for consistency with NewVariables, we use ReserveVector here. See
   // comment in NewVariables for details.
@@ -189,22 +522,25 @@ std::vector<BddNodeIndex> BinaryDecisionDiagram::NewVariables(int64_t count) {
   // [0] https://en.cppreference.com/w/cpp/container/vector/reserve
   ReserveVector(nodes_.size() + count, nodes_);
   ReserveVector(variable_base_nodes_.size() + count, variable_base_nodes_);
+  ReserveVector(var_to_level_.size() + count, var_to_level_);
+  ReserveVector(level_to_var_.size() + count, level_to_var_);
+  ReserveVector(unique_tables_.size() + count, unique_tables_);
 
   std::vector<BddNodeIndex> indexes;
   indexes.reserve(count);
   int64_t next_var = variable_base_nodes_.size();
   for (int64_t i = 0; i < count; ++i) {
-    BddNodeIndex index = CreateVariableBaseNode(BddVariable(next_var++));
+    BddVariable var(next_var++);
+    var_to_level_.push_back(level_to_var_.size());
+    level_to_var_.push_back(var);
+    unique_tables_.emplace_back();
+    BddNodeIndex index = CreateVariableBaseNode(var);
     variable_base_nodes_.push_back(index);
     indexes.push_back(index);
   }
   return indexes;
 }
 
-BddNodeIndex BinaryDecisionDiagram::Not(BddNodeIndex expr) {
-  return IfThenElse(expr, zero(), one());
-}
-
 BddNodeIndex BinaryDecisionDiagram::Or(BddNodeIndex a, BddNodeIndex b) {
   return IfThenElse(a, one(), b);
 }
@@ -242,8 +578,9 @@ absl::StatusOr<bool> BinaryDecisionDiagram::Evaluate(
           absl::StrFormat("Missing value for BDD variable %d (node index %d)",
                           GetNode(result).variable.value(), var_node.value()));
     }
-    result = variable_values.at(var_node) ? GetNode(result).high
-                                          : GetNode(result).low;
+    BddNodeIndex child = variable_values.at(var_node) ? GetNode(result).high
+                                                      : GetNode(result).low;
+    result = IsComplemented(result) ? Complement(child) : child;
   }
   VLOG(2) << "  result = " << (result == one() ? true : false);
   return result == one();
@@ -275,10 +612,13 @@ void BinaryDecisionDiagram::ToStringDnfHelper(BddNodeIndex expr,
   }
 
   const BddNode& node = GetNode(expr);
+  const BddNodeIndex high =
+      IsComplemented(expr) ? Complement(node.high) : node.high;
+  const BddNodeIndex low = IsComplemented(expr) ? Complement(node.low) : node.low;
   terms->push_back(absl::StrCat("x", node.variable.value()));
-  ToStringDnfHelper(node.high, minterms_to_emit, terms, str);
+  ToStringDnfHelper(high, minterms_to_emit, terms, str);
   terms->back() = absl::StrCat("!x", node.variable.value());
-  ToStringDnfHelper(node.low, minterms_to_emit, terms, str);
+  ToStringDnfHelper(low, minterms_to_emit, terms, str);
   terms->pop_back();
 }
 
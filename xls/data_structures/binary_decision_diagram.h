@@ -16,8 +16,10 @@
 #define XLS_DATA_STRUCTURES_BINARY_DECISION_DIAGRAM_H_
 
 #include <cstdint>
+#include <limits>
+#include <optional>
 #include <string>
-#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -34,19 +36,33 @@ namespace xls {
 //   K.S. Brace, R.L. Rudell, and R.E. Bryant,
 //   "Efficient Implementation of a BDD package"
 //   https://ieeexplore.ieee.org/document/114826
+//
+// Expressions are referenced through complement edges so negation is free and
+// an expression and its inverse share nodes. The computed table memoizing
+// if-then-else operations is a bounded, lossy cache. Nodes are reference
+// counted: nodes which are not (transitively) referenced are reclaimed by
+// GarbageCollect, and the variable order can be improved by Reorder, which
+// uses Rudell's sifting algorithm:
+//   R. Rudell, "Dynamic variable ordering for ordered binary decision
+//   diagrams", ICCAD 1993.
+//
+// Neither garbage collection nor reordering happens implicitly. Both require
+// every expression which is used afterwards to be referenced with Ref.
 
-// For efficiency variables and nodes are referred to by indices into vector
-// data members in the BDD.
+// For efficiency variables and nodes are referred to by indices. A
+// BddNodeIndex refers to an expression: the upper bits hold the index of a
+// node in the BDD and the lowest bit is set if the expression is the inverse
+// of the node's function.
 XLS_DEFINE_STRONG_INT_TYPE(BddVariable, int32_t);
 XLS_DEFINE_STRONG_INT_TYPE(BddNodeIndex, int32_t);
 
 // A node in the BDD. The node is associated with a single variable and has
 // children corresponding to when the variable is true (high) and when it is
-// false (low).
+// false (low). The high child is never complemented.
 struct BddNode {
-  BddNode() : variable(0), high(0), low(0), path_count(0) {}
+  BddNode() : variable(0), high(0), low(0), path_count(0), ref_count(0) {}
   BddNode(BddVariable v, BddNodeIndex h, BddNodeIndex l, int32_t p)
-      : variable(v), high(h), low(l), path_count(p) {}
+      : variable(v), high(h), low(l), path_count(p), ref_count(0) {}
 
   BddVariable variable;
   BddNodeIndex high;
@@ -56,16 +72,39 @@ struct BddNode {
   // the growth of the BDD by halting evaluation if the number of paths gets too
   // large. Saturates at INT32_MAX.
   int32_t path_count;
+
+  // Number of parent nodes plus the number of external references (see
+  // BinaryDecisionDiagram::Ref). Saturates at INT32_MAX, after which the node
+  // is never reclaimed.
+  int32_t ref_count;
 };
 
 class BinaryDecisionDiagram {
  public:
-  // Creates an empty BDD. Initialize the BDD contains only the nodes
-  // corresponding to zero and one.
-  BinaryDecisionDiagram();
+  // The default upper bound on the number of entries in the computed table.
+  static constexpr int64_t kDefaultMaxCacheEntries = int64_t{1} << 20;
+
+  struct Stats {
+    // Computed table lookups and hits.
+    int64_t cache_lookups = 0;
+    int64_t cache_hits = 0;
+    // The largest number of nodes ever held in the BDD.
+    int64_t peak_node_count = 0;
+    int64_t garbage_collections = 0;
+    int64_t nodes_freed = 0;
+    int64_t reorderings = 0;
+    // Number of swaps of adjacent variables performed while reordering.
+    int64_t swaps = 0;
+  };
+
+  // Creates an empty BDD. Initially the BDD contains only the terminal node
+  // corresponding to one (zero is its complement). The computed table grows
+  // with the BDD up to `max_cache_entries` entries.
+  explicit BinaryDecisionDiagram(
+      int64_t max_cache_entries = kDefaultMaxCacheEntries);
 
   // Adds a new variable to the BDD and returns the node corresponding the
-  // variable's value.
+  // variable's value. New variables are placed last in the variable order.
   BddNodeIndex NewVariable();
 
   // Adds `count` new variables to the BDD and returns the nodes corresponding
@@ -74,8 +113,8 @@ class BinaryDecisionDiagram {
   // `count`.
   std::vector<BddNodeIndex> NewVariables(int64_t count);
 
-  // Returns the inverse of the given expression.
-  BddNodeIndex Not(BddNodeIndex expr);
+  // Returns the inverse of the given expression. Never creates nodes.
+  BddNodeIndex Not(BddNodeIndex expr) { return Complement(expr); }
 
   // Returns the OR/AND of the given expressions.
   BddNodeIndex And(BddNodeIndex a, BddNodeIndex b);
@@ -85,8 +124,8 @@ class BinaryDecisionDiagram {
   BddNodeIndex Implies(BddNodeIndex a, BddNodeIndex b);
 
   // Returns the leaf node corresponding to zero or one.
-  BddNodeIndex zero() const { return BddNodeIndex(0); }
-  BddNodeIndex one() const { return BddNodeIndex(1); }
+  BddNodeIndex zero() const { return BddNodeIndex(1); }
+  BddNodeIndex one() const { return BddNodeIndex(0); }
 
   // Evaluates the given expression with the given variable values. The keys in
   // the map are the *node* indices of the respective variable (value returned
@@ -96,13 +135,15 @@ class BinaryDecisionDiagram {
       BddNodeIndex expr,
       const absl::flat_hash_map<BddNodeIndex, bool>& variable_values) const;
 
-  // Returns the BDD node with the given index.
+  // Returns the BDD node referenced by the given expression. The node's
+  // children are those of the uncomplemented expression.
   const BddNode& GetNode(BddNodeIndex node_index) const {
-    return nodes_.at(node_index.value());
+    return nodes_.at(NodeSlot(node_index));
   }
 
-  // Returns the number of nodes in the graph.
-  int64_t size() const { return nodes_.size(); }
+  // Returns the number of nodes in the graph, including unreferenced nodes
+  // which have not been garbage collected.
+  int64_t size() const { return node_count_; }
 
   // Returns the number of variables in the graph.
   int64_t variable_count() const { return variable_base_nodes_.size(); }
@@ -112,6 +153,15 @@ class BinaryDecisionDiagram {
     return GetNode(expr).path_count;
   }
 
+  // Returns the largest number of paths of any expression in the BDD.
+  int64_t max_path_count() const;
+
+  // Returns the position of the given variable in the variable order; the
+  // first variable tested on every path is at level zero.
+  int64_t GetVariableLevel(BddVariable variable) const {
+    return var_to_level_.at(variable.value());
+  }
+
   // Returns the given expression in disjunctive normal form (sum of products).
   // The expression is not minimal. 'minterm_limit' is the maximum number of
   // minterms to emit before truncating the output.
@@ -121,27 +171,108 @@ class BinaryDecisionDiagram {
   // variable. The expression of a base node is exactly equal to the value of
   // the variable.
   bool IsVariableBaseNode(BddNodeIndex expr) const {
-    return GetNode(expr).high == one() && GetNode(expr).low == zero();
+    return !IsComplemented(expr) && GetNode(expr).high == one() &&
+           GetNode(expr).low == zero();
   }
 
   // Returns the node corresponding to the given if-then-else expression.
   BddNodeIndex IfThenElse(BddNodeIndex cond, BddNodeIndex if_true,
                           BddNodeIndex if_false);
 
+  // Adds or removes an external reference to the given expression. Referenced
+  // expressions, and the variables, survive GarbageCollect and Reorder.
+  void Ref(BddNodeIndex expr) { IncrementRefCount(NodeSlot(expr)); }
+  void Deref(BddNodeIndex expr) { DecrementRefCount(NodeSlot(expr)); }
+
+  // Reclaims all nodes which are not reachable from a referenced expression
+  // and clears the computed table. Returns the number of nodes reclaimed.
+  // Unreferenced expressions must not be used afterwards.
+  int64_t GarbageCollect();
+
+  // Reorders the variables by sifting to reduce the number of nodes. Each
+  // variable in turn is moved through every level of the order and left where
+  // the BDD is smallest; a variable stops moving in one direction once the BDD
+  // grows by more than `max_growth` relative to its size when the variable
+  // started moving. Referenced expressions keep their BddNodeIndex and
+  // meaning. Garbage collects first, so unreferenced expressions must not be
+  // used afterwards.
+  void Reorder(double max_growth = 1.2);
+
+  const Stats& stats() const { return stats_; }
+
  private:
+  // The level of the terminal node, below every variable.
+  static constexpr int32_t kTerminalLevel = std::numeric_limits<int32_t>::max();
+
+  static int32_t NodeSlot(BddNodeIndex expr) { return expr.value() >> 1; }
+  static bool IsComplemented(BddNodeIndex expr) { return expr.value() & 1; }
+  static BddNodeIndex Complement(BddNodeIndex expr) {
+    return BddNodeIndex(expr.value() ^ 1);
+  }
+  static BddNodeIndex Regular(BddNodeIndex expr) {
+    return BddNodeIndex(expr.value() & ~1);
+  }
+  static BddNodeIndex MakeIndex(int32_t slot, bool complemented) {
+    return BddNodeIndex((slot << 1) | (complemented ? 1 : 0));
+  }
+
+  // Returns the level of the variable tested by the expression's node.
+  int32_t Level(BddNodeIndex expr) const {
+    const BddNode& node = nodes_[NodeSlot(expr)];
+    return NodeSlot(expr) == 0 ? kTerminalLevel
+                               : var_to_level_[node.variable.value()];
+  }
+
+  // Returns the cofactor of the expression with the variable at the given
+  // level set to `value`. `level` must not be below the expression's level.
+  BddNodeIndex Cofactor(BddNodeIndex expr, int32_t level, bool value) const;
+
+  // Recursive implementation of IfThenElse.
+  BddNodeIndex IteRecursive(BddNodeIndex cond, BddNodeIndex if_true,
+                            BddNodeIndex if_false);
+
   // Helper for constructing a DNF string respresentation.
   void ToStringDnfHelper(BddNodeIndex expr, int64_t* minterms_to_emit,
                          std::vector<std::string>* terms,
                          std::string* str) const;
 
   // Get the node corresponding to the given variable with the given low/high
-  // children. Creates it if it does not exist.
+  // children. Creates it if it does not exist. A new node references its
+  // children but is itself unreferenced.
   BddNodeIndex GetOrCreateNode(BddVariable var, BddNodeIndex high,
                                BddNodeIndex low);
 
-  // Returns the node equal to given expression with the given variable
-  // set to the given value.
-  BddNodeIndex Restrict(BddNodeIndex expr, BddVariable var, bool value);
+  // Returns a free node slot holding the given node.
+  int32_t AllocateNode(const BddNode& node);
+
+  // Removes the unreferenced node in the given slot from the BDD, along with
+  // any descendants which become unreferenced as a result.
+  void FreeNode(int32_t slot);
+
+  void IncrementRefCount(int32_t slot);
+  void DecrementRefCount(int32_t slot);
+
+  // Swaps the variables at the given level and the level below it.
+  void SwapAdjacentLevels(int32_t level);
+
+  // Moves the given variable to the level minimizing the size of the BDD.
+  void SiftVariable(BddVariable var, double max_growth);
+
+  // Recomputes the path counts of all nodes, which changes when the variable
+  // order changes.
+  void RecomputePathCounts();
+
+  // Computed table operations.
+  std::optional<BddNodeIndex> LookupCache(BddNodeIndex cond,
+                                          BddNodeIndex if_true,
+                                          BddNodeIndex if_false);
+  void InsertCache(BddNodeIndex cond, BddNodeIndex if_true,
+                   BddNodeIndex if_false, BddNodeIndex result);
+  int64_t CacheSlot(BddNodeIndex cond, BddNodeIndex if_true,
+                    BddNodeIndex if_false) const;
+  void ClearCache();
+  // Grows the computed table, up to max_cache_entries_, as the BDD grows.
+  void MaybeGrowCache();
 
   // Returns the node corresponding to the value of the given variable.
   BddNodeIndex GetVariableBaseNode(BddVariable variable) const {
@@ -155,20 +286,37 @@ class BinaryDecisionDiagram {
   // variable.
   std::vector<BddNodeIndex> variable_base_nodes_;
 
-  // The vector of all the nodes in the BDD.
-  std::vector<BddNode> nodes_;
+  // The variable order: the level of each variable and the variable at each
+  // level.
+  std::vector<int32_t> var_to_level_;
+  std::vector<BddVariable> level_to_var_;
 
-  // A map from BDD node content (variable id, high child, low child) to the
-  // index of the respective node. This map is used to ensure that no duplicate
-  // nodes are created.
-  using NodeKey = std::tuple<BddVariable, BddNodeIndex, BddNodeIndex>;
-  absl::flat_hash_map<NodeKey, BddNodeIndex> node_map_;
-
-  // A map from if-then-else expression to the node corresponding to that
-  // expression. The key elements are (condition, if-true, if-false). This map
-  // enables fast lookup for expressions.
-  using IteKey = std::tuple<BddNodeIndex, BddNodeIndex, BddNodeIndex>;
-  absl::flat_hash_map<IteKey, BddNodeIndex> ite_map_;
+  // The vector of all the nodes in the BDD, including free slots (whose
+  // variable is kFreeVariable) which are listed in free_slots_.
+  std::vector<BddNode> nodes_;
+  std::vector<int32_t> free_slots_;
+  int64_t node_count_ = 0;
+
+  // For each variable, a map from the (high, low) children of the variable's
+  // nodes to the slot of the respective node. These maps ensure that no
+  // duplicate nodes are created.
+  using UniqueTable =
+      absl::flat_hash_map<std::pair<BddNodeIndex, BddNodeIndex>, int32_t>;
+  std::vector<UniqueTable> unique_tables_;
+
+  // A direct-mapped cache from if-then-else expression (condition, if-true,
+  // if-false) to the node corresponding to that expression. Colliding entries
+  // overwrite each other.
+  struct CacheEntry {
+    BddNodeIndex cond = BddNodeIndex(-1);
+    BddNodeIndex if_true;
+    BddNodeIndex if_false;
+    BddNodeIndex result;
+  };
+  std::vector<CacheEntry> cache_;
+  int64_t max_cache_entries_;
+
+  Stats stats_;
 };
 
 }  // namespace xls
@@ -15,6 +15,7 @@
 #include "xls/data_structures/binary_decision_diagram.h"
 
 #include <cstdint>
+#include <cstdlib>
 #include <limits>
 #include <string>
 #include <vector>
@@ -315,5 +316,156 @@ TEST(BinaryDecisionDiagramTest, ThreeVariableExhaustive) {
   }
 }
 
+// Returns the variable assignment setting vars[i] to bit i of `value`.
+absl::flat_hash_map<BddNodeIndex, bool> Assignment(
+    const std::vector<BddNodeIndex>& vars, int64_t value) {
+  absl::flat_hash_map<BddNodeIndex, bool> result;
+  for (int64_t i = 0; i < vars.size(); ++i) {
+    result[vars[i]] = ((value >> i) & 1) != 0;
+  }
+  return result;
+}
+
+// Returns (x0 & y0) | (x1 & y1) | ... for the given variables, which has a
+// linear size BDD if the pairs are adjacent in the variable order and an
+// exponential one if all the xs precede all the ys.
+BddNodeIndex SumOfPairs(BinaryDecisionDiagram& bdd,
+                        const std::vector<BddNodeIndex>& xs,
+                        const std::vector<BddNodeIndex>& ys) {
+  BddNodeIndex result = bdd.zero();
+  for (int64_t i = 0; i < xs.size(); ++i) {
+    result = bdd.Or(result, bdd.And(xs[i], ys[i]));
+  }
+  return result;
+}
+
+TEST(BinaryDecisionDiagramTest, ComplementEdges) {
+  BinaryDecisionDiagram bdd;
+  std::vector<BddNodeIndex> vars = bdd.NewVariables(3);
+  BddNodeIndex f = bdd.Or(bdd.And(vars[0], vars[1]), vars[2]);
+
+  // Negation is free and shares the nodes of the negated expression.
+  int64_t size = bdd.size();
+  BddNodeIndex not_f = bdd.Not(f);
+  EXPECT_EQ(bdd.size(), size);
+  EXPECT_NE(not_f, f);
+  EXPECT_EQ(bdd.Not(not_f), f);
+  EXPECT_EQ(bdd.path_count(not_f), bdd.path_count(f));
+  EXPECT_EQ(bdd.Not(bdd.zero()), bdd.one());
+  EXPECT_FALSE(bdd.IsVariableBaseNode(bdd.Not(vars[0])));
+
+  // De Morgan's laws hold structurally.
+  EXPECT_EQ(not_f, bdd.And(bdd.Or(bdd.Not(vars[0]), bdd.Not(vars[1])),
+                           bdd.Not(vars[2])));
+  EXPECT_EQ(bdd.size(), size);
+  for (int64_t value = 0; value < 8; ++value) {
+    EXPECT_THAT(bdd.Evaluate(not_f, Assignment(vars, value)),
+                IsOkAndHolds(!(((value & 3) == 3) || (value & 4))));
+  }
+}
+
+TEST(BinaryDecisionDiagramTest, GarbageCollection) {
+  BinaryDecisionDiagram bdd;
+  std::vector<BddNodeIndex> vars = bdd.NewVariables(8);
+  const int64_t variables_size = bdd.size();
+
+  BddNodeIndex kept = bdd.And(vars[0], bdd.Or(vars[1], vars[2]));
+  bdd.Ref(kept);
+  const int64_t kept_size = bdd.size();
+  BddNodeIndex parity = bdd.zero();
+  for (BddNodeIndex var : vars) {
+    parity = bdd.Or(bdd.And(parity, bdd.Not(var)), bdd.And(bdd.Not(parity), var));
+  }
+  EXPECT_GT(bdd.size(), kept_size);
+
+  // Everything but the referenced expression and the variables is reclaimed.
+  EXPECT_EQ(bdd.GarbageCollect(), bdd.stats().nodes_freed);
+  EXPECT_EQ(bdd.size(), kept_size);
+  for (int64_t value = 0; value < 8; ++value) {
+    EXPECT_THAT(bdd.Evaluate(kept, Assignment(vars, value)),
+                IsOkAndHolds((value & 1) && (value & 6)));
+  }
+  // Recreating the expression finds the existing nodes.
+  EXPECT_EQ(bdd.And(vars[0], bdd.Or(vars[1], vars[2])), kept);
+
+  bdd.Deref(kept);
+  bdd.GarbageCollect();
+  EXPECT_EQ(bdd.size(), variables_size);
+  EXPECT_EQ(bdd.stats().garbage_collections, 2);
+
+  // Freed nodes are reused.
+  BddNodeIndex recreated = bdd.And(vars[0], bdd.Or(vars[1], vars[2]));
+  EXPECT_EQ(bdd.size(), kept_size);
+  for (int64_t value = 0; value < 8; ++value) {
+    EXPECT_THAT(bdd.Evaluate(recreated, Assignment(vars, value)),
+                IsOkAndHolds((value & 1) && (value & 6)));
+  }
+}
+
+TEST(BinaryDecisionDiagramTest, BoundedComputedTable) {
+  // A computed table with a handful of entries loses most results but must
+  // not change the expressions produced.
+  BinaryDecisionDiagram small(/*max_cache_entries=*/4);
+  BinaryDecisionDiagram large;
+  std::vector<BddNodeIndex> small_vars = small.NewVariables(6);
+  std::vector<BddNodeIndex> large_vars = large.NewVariables(6);
+  BddNodeIndex small_f = SumOfPairs(
+      small, {small_vars[0], small_vars[1], small_vars[2]},
+      {small_vars[3], small_vars[4], small_vars[5]});
+  BddNodeIndex large_f = SumOfPairs(
+      large, {large_vars[0], large_vars[1], large_vars[2]},
+      {large_vars[3], large_vars[4], large_vars[5]});
+  EXPECT_EQ(small.size(), large.size());
+  EXPECT_EQ(small.ToStringDnf(small_f), large.ToStringDnf(large_f));
+  EXPECT_GT(small.stats().cache_lookups, 0);
+}
+
+TEST(BinaryDecisionDiagramTest, ReorderingShrinksBdd) {
+  constexpr int64_t kPairs = 6;
+  BinaryDecisionDiagram bdd;
+  std::vector<BddNodeIndex> vars = bdd.NewVariables(2 * kPairs);
+  std::vector<BddNodeIndex> xs(vars.begin(), vars.begin() + kPairs);
+  std::vector<BddNodeIndex> ys(vars.begin() + kPairs, vars.end());
+  BddNodeIndex f = SumOfPairs(bdd, xs, ys);
+  BddNodeIndex not_g = bdd.Not(bdd.And(xs[0], bdd.Or(ys[1], xs[2])));
+  bdd.Ref(f);
+  bdd.Ref(not_g);
+  bdd.GarbageCollect();
+  const int64_t size_before = bdd.size();
+  const std::string f_dnf = bdd.ToStringDnf(f);
+
+  bdd.Reorder();
+  EXPECT_LT(bdd.size(), size_before);
+  EXPECT_EQ(bdd.stats().reorderings, 1);
+  EXPECT_GT(bdd.stats().swaps, 0);
+
+  // Each x is placed next to its y.
+  for (int64_t i = 0; i < kPairs; ++i) {
+    EXPECT_EQ(std::abs(bdd.GetVariableLevel(bdd.GetNode(xs[i]).variable) -
+                       bdd.GetVariableLevel(bdd.GetNode(ys[i]).variable)),
+              1);
+  }
+
+  // Referenced expressions keep their meaning, and rebuilding them finds the
+  // same nodes.
+  for (int64_t value = 0; value < (1 << (2 * kPairs)); ++value) {
+    bool expected_f = false;
+    for (int64_t i = 0; i < kPairs; ++i) {
+      expected_f |= ((value >> i) & 1) && ((value >> (i + kPairs)) & 1);
+    }
+    absl::flat_hash_map<BddNodeIndex, bool> assignment =
+        Assignment(vars, value);
+    ASSERT_THAT(bdd.Evaluate(f, assignment), IsOkAndHolds(expected_f));
+    ASSERT_THAT(bdd.Evaluate(not_g, assignment),
+                IsOkAndHolds(!((value & 1) && (((value >> (kPairs + 1)) & 1) ||
+                                               ((value >> 2) & 1)))));
+  }
+  EXPECT_EQ(SumOfPairs(bdd, xs, ys), f);
+  EXPECT_EQ(bdd.Not(bdd.And(xs[0], bdd.Or(ys[1], xs[2]))), not_g);
+  // Path counts follow the new order.
+  EXPECT_EQ(bdd.path_count(f), (1 << (kPairs + 1)) - 1);
+  EXPECT_NE(bdd.ToStringDnf(f), f_dnf);
+}
+
 }  // namespace
 }  // namespace xls
@@ -15,9 +15,11 @@
 #ifndef XLS_DATA_STRUCTURES_STRONGLY_CONNECTED_COMPONENTS_H_
 #define XLS_DATA_STRUCTURES_STRONGLY_CONNECTED_COMPONENTS_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <stack>
+#include <utility>
 #include <vector>
 
 #include "absl/container/btree_map.h"
@@ -96,6 +98,84 @@ std::vector<absl::btree_set<V>> StronglyConnectedComponents(
   return result;
 }
 
+// Computes the strongly connected components of a graph whose vertices are the
+// integers in [0, vertex_count). `next_successor(v, after)` must return the
+// smallest out-neighbor of `v` which is greater than `after` (-1 on the first
+// call for `v`), or -1 if there is none. Self-edges are permitted.
+//
+// Returns the components, each with its vertices in increasing order, in
+// reverse topological order: every edge leads from a component to itself or to
+// an earlier one. Unlike the overload above this does not recurse, so it
+// handles graphs with arbitrarily long paths.
+template <typename NextSuccessorFn>
+std::vector<std::vector<int64_t>> DenseStronglyConnectedComponents(
+    int64_t vertex_count, NextSuccessorFn next_successor) {
+  struct Frame {
+    int64_t vertex;
+    // The last out-neighbor of `vertex` visited.
+    int64_t last_successor = -1;
+  };
+
+  int64_t index = 0;
+  std::vector<int64_t> indexes(vertex_count, -1);
+  std::vector<int64_t> low_links(vertex_count, -1);
+  std::vector<bool> on_stack(vertex_count, false);
+  std::vector<int64_t> stack;
+  std::vector<Frame> frames;
+  std::vector<std::vector<int64_t>> result;
+
+  auto visit = [&](int64_t vertex) {
+    indexes[vertex] = index;
+    low_links[vertex] = index;
+    ++index;
+    stack.push_back(vertex);
+    on_stack[vertex] = true;
+    frames.push_back(Frame{.vertex = vertex});
+  };
+
+  for (int64_t root = 0; root < vertex_count; ++root) {
+    if (indexes[root] != -1) {
+      continue;
+    }
+    visit(root);
+    while (!frames.empty()) {
+      Frame& frame = frames.back();
+      const int64_t vertex = frame.vertex;
+      const int64_t neighbor = next_successor(vertex, frame.last_successor);
+      if (neighbor != -1) {
+        frame.last_successor = neighbor;
+        if (indexes[neighbor] == -1) {
+          visit(neighbor);
+        } else if (on_stack[neighbor]) {
+          low_links[vertex] = std::min(low_links[vertex], indexes[neighbor]);
+        }
+        continue;
+      }
+
+      // All out-neighbors of `vertex` have been visited.
+      frames.pop_back();
+      if (!frames.empty()) {
+        int64_t parent = frames.back().vertex;
+        low_links[parent] = std::min(low_links[parent], low_links[vertex]);
+      }
+      if (low_links[vertex] == indexes[vertex]) {
+        std::vector<int64_t> scc;
+        int64_t v;
+        do {
+          v = stack.back();
+          stack.pop_back();
+          on_stack[v] = false;
+          scc.push_back(v);
+        } while (v != vertex);
+        std::sort(scc.begin(), scc.end());
+        result.push_back(std::move(scc));
+      }
+    }
+  }
+
+  return result;
+}
+
 }  // namespace xls
 
 #endif  // XLS_DATA_STRUCTURES_STRONGLY_CONNECTED_COMPONENTS_H_
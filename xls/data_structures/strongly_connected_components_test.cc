@@ -18,6 +18,7 @@
 #include <string>
 #include <vector>
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/btree_map.h"
 #include "absl/container/btree_set.h"
@@ -25,6 +26,8 @@
 namespace xls {
 namespace {
 
+using ::testing::ElementsAre;
+
 using V = std::string;
 
 absl::btree_set<V> FlattenSCCs(const std::vector<absl::btree_set<V>>& sccs) {
@@ -145,5 +148,49 @@ TEST(StronglyConnectedComponentsTest, Tree) {
   EXPECT_EQ(FlattenSCCs(sccs).size(), GraphSize(graph));
 }
 
+// Runs DenseStronglyConnectedComponents on a graph given as sorted adjacency
+// lists.
+std::vector<std::vector<int64_t>> DenseSCCs(
+    const std::vector<std::vector<int64_t>>& graph) {
+  return DenseStronglyConnectedComponents(
+      graph.size(), [&](int64_t vertex, int64_t after) -> int64_t {
+        for (int64_t neighbor : graph[vertex]) {
+          if (neighbor > after) {
+            return neighbor;
+          }
+        }
+        return -1;
+      });
+}
+
+TEST(StronglyConnectedComponentsTest, DenseBarBellWithSelfEdge) {
+  // Two cycles, 0 -> 1 -> 2 -> 0 and 3 -> 4 -> 3, joined by the edge 0 -> 3,
+  // plus a vertex with a self-edge and an isolated vertex.
+  std::vector<std::vector<int64_t>> graph = {{1, 3}, {2}, {0}, {4},
+                                             {3},    {5}, {}};
+  EXPECT_THAT(DenseSCCs(graph),
+              ElementsAre(ElementsAre(3, 4), ElementsAre(0, 1, 2),
+                          ElementsAre(5), ElementsAre(6)));
+}
+
+TEST(StronglyConnectedComponentsTest, DenseComponentsAreReverseTopological) {
+  // 0 -> 1 -> 2 and 0 -> 2 -> 3.
+  std::vector<std::vector<int64_t>> graph = {{1, 2}, {2}, {3}, {}};
+  EXPECT_THAT(DenseSCCs(graph), ElementsAre(ElementsAre(3), ElementsAre(2),
+                                            ElementsAre(1), ElementsAre(0)));
+}
+
+TEST(StronglyConnectedComponentsTest, DenseLongCycle) {
+  // Deep enough to overflow the stack if the search were recursive.
+  constexpr int64_t kVertexCount = 1000000;
+  std::vector<std::vector<int64_t>> sccs = DenseStronglyConnectedComponents(
+      kVertexCount, [&](int64_t vertex, int64_t after) -> int64_t {
+        int64_t next = (vertex + 1) % kVertexCount;
+        return after < next ? next : -1;
+      });
+  ASSERT_EQ(sccs.size(), 1);
+  EXPECT_EQ(sccs[0].size(), kVertexCount);
+}
+
 }  // namespace
 }  // namespace xls
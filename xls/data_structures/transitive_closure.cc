@@ -0,0 +1,213 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/data_structures/transitive_closure.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/types/span.h"
+#include "xls/common/thread.h"
+#include "xls/data_structures/inline_bitmap.h"
+#include "xls/data_structures/strongly_connected_components.h"
+
+namespace xls::internal {
+namespace {
+
+// Levels of the condensed DAG with fewer components than this are closed
+// serially, as they don't amortize the cost of starting threads.
+constexpr int64_t kMinComponentsPerParallelLevel = 256;
+
+// Returns the index of the first set bit of `bitmap` after `after`, or -1 if
+// there is none.
+int64_t NextSetBit(const InlineBitmap& bitmap, int64_t after) {
+  constexpr int64_t kWordBits = 64;
+  const int64_t index = after + 1;
+  if (index >= bitmap.bit_count()) {
+    return -1;
+  }
+  int64_t wordno = index / kWordBits;
+  uint64_t word =
+      bitmap.GetWord(wordno) & (~uint64_t{0} << (index % kWordBits));
+  while (word == 0) {
+    if (++wordno == bitmap.word_count()) {
+      return -1;
+    }
+    word = bitmap.GetWord(wordno);
+  }
+  return wordno * kWordBits + std::countr_zero(word);
+}
+
+class DenseClosure {
+ public:
+  explicit DenseClosure(absl::Span<InlineBitmap> relation)
+      : relation_(relation),
+        components_(DenseStronglyConnectedComponents(
+            relation.size(), [&](int64_t vertex, int64_t after) {
+              return NextSetBit(relation[vertex], after);
+            })),
+        component_of_(relation.size()) {
+    for (int64_t c = 0; c < components_.size(); ++c) {
+      for (int64_t vertex : components_[c]) {
+        component_of_[vertex] = c;
+      }
+    }
+  }
+
+  int64_t component_count() const { return components_.size(); }
+
+  // Scratch space for finding the successors of a component.
+  struct Scratch {
+    explicit Scratch(int64_t component_count)
+        : last_seen(component_count, -1) {}
+
+    std::vector<int64_t> last_seen;
+    std::vector<int64_t> successors;
+  };
+
+  // Sets `scratch.successors` to the components which the edges of `c` lead
+  // to, other than `c` itself, in decreasing order.
+  void FindSuccessorComponents(int64_t c, Scratch& scratch) const {
+    scratch.successors.clear();
+    for (int64_t vertex : components_[c]) {
+      const InlineBitmap& row = relation_[vertex];
+      for (int64_t successor = NextSetBit(row, -1); successor != -1;
+           successor = NextSetBit(row, successor)) {
+        int64_t d = component_of_[successor];
+        if (d != c && scratch.last_seen[d] != c) {
+          scratch.last_seen[d] = c;
+          scratch.successors.push_back(d);
+        }
+      }
+    }
+    std::sort(scratch.successors.begin(), scratch.successors.end(),
+              std::greater<int64_t>());
+  }
+
+  // Replaces the rows of the vertices of `c` with their closure. The rows of
+  // all the components `c` leads to must already be closed.
+  void Close(int64_t c, Scratch& scratch) {
+    FindSuccessorComponents(c, scratch);
+    const std::vector<int64_t>& vertices = components_[c];
+    InlineBitmap closure(relation_.size());
+    // Successors are visited in reverse topological order, so a successor
+    // reachable through another one is visited after it and can be skipped:
+    // its closure is already included.
+    for (int64_t d : scratch.successors) {
+      int64_t representative = components_[d].front();
+      if (!closure.Get(representative)) {
+        closure.Union(relation_[representative]);
+      }
+    }
+    for (int64_t vertex : vertices) {
+      closure.Union(relation_[vertex]);
+    }
+    if (vertices.size() > 1) {
+      for (int64_t vertex : vertices) {
+        closure.Set(vertex);
+      }
+    }
+    for (int64_t i = 0; i + 1 < vertices.size(); ++i) {
+      relation_[vertices[i]] = closure;
+    }
+    relation_[vertices.back()] = std::move(closure);
+  }
+
+  void CloseSerially() {
+    Scratch scratch(component_count());
+    for (int64_t c = 0; c < component_count(); ++c) {
+      Close(c, scratch);
+    }
+  }
+
+  void CloseInParallel(int64_t thread_count) {
+    // Group the components by the length of the longest path from them to a
+    // sink. The components of a level only lead to those of lower levels.
+    std::vector<std::vector<int64_t>> levels;
+    {
+      Scratch scratch(component_count());
+      std::vector<int64_t> level_of(component_count());
+      for (int64_t c = 0; c < component_count(); ++c) {
+        FindSuccessorComponents(c, scratch);
+        int64_t level = 0;
+        for (int64_t d : scratch.successors) {
+          level = std::max(level, level_of[d] + 1);
+        }
+        level_of[c] = level;
+        if (level >= levels.size()) {
+          levels.resize(level + 1);
+        }
+        levels[level].push_back(c);
+      }
+    }
+
+    Scratch scratch(component_count());
+    for (const std::vector<int64_t>& level : levels) {
+      if (level.size() < kMinComponentsPerParallelLevel) {
+        for (int64_t c : level) {
+          Close(c, scratch);
+        }
+        continue;
+      }
+      std::atomic<int64_t> next_index = 0;
+      std::vector<std::unique_ptr<Thread>> workers;
+      const int64_t worker_count =
+          std::min<int64_t>(thread_count, static_cast<int64_t>(level.size()));
+      workers.reserve(worker_count);
+      for (int64_t i = 0; i < worker_count; ++i) {
+        workers.push_back(std::make_unique<Thread>([&]() {
+          Scratch worker_scratch(component_count());
+          for (int64_t index = next_index++; index < level.size();
+               index = next_index++) {
+            Close(level[index], worker_scratch);
+          }
+        }));
+      }
+      for (std::unique_ptr<Thread>& worker : workers) {
+        worker->Join();
+      }
+    }
+  }
+
+ private:
+  absl::Span<InlineBitmap> relation_;
+  // In reverse topological order.
+  std::vector<std::vector<int64_t>> components_;
+  std::vector<int64_t> component_of_;
+};
+
+}  // namespace
+
+void CondensedTransitiveClosure(absl::Span<InlineBitmap> relation,
+                                int64_t thread_count) {
+  for (const InlineBitmap& row : relation) {
+    DCHECK_EQ(row.bit_count(), relation.size());
+  }
+  DenseClosure closure(relation);
+  if (thread_count > 1 &&
+      closure.component_count() >= kMinComponentsPerParallelLevel) {
+    closure.CloseInParallel(thread_count);
+  } else {
+    closure.CloseSerially();
+  }
+}
+
+}  // namespace xls::internal
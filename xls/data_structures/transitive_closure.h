@@ -15,18 +15,24 @@
 #ifndef XLS_DATA_STRUCTURES_TRANSITIVE_CLOSURE_H_
 #define XLS_DATA_STRUCTURES_TRANSITIVE_CLOSURE_H_
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/types/span.h"
 #include "xls/data_structures/inline_bitmap.h"
+#include "xls/data_structures/strongly_connected_components.h"
 
 namespace xls {
 
 namespace internal {
-// Compute the transitive closure of a relation.
+// Compute the transitive closure of a relation with Warshall's algorithm, in
+// O(n^3) time. Superseded by the SCC-based closures below, but kept as a
+// reference for tests and benchmarks.
 template <typename Relation>
 void TransitiveClosure(Relation relation) {
   // Warshall's algorithm; https://cs.winona.edu/lin/cs440/ch08-2.pdf
@@ -97,6 +103,112 @@ class DenseIdRelation {
   absl::Span<InlineBitmap> relation_;
 };
 
+// Compute the transitive closure of a relation represented as a boolean
+// adjacency matrix in place, by condensing its strongly connected components
+// and closing the resulting DAG in reverse topological order. The closure of
+// each component is the union of the closures of its successor components,
+// taken with word-wide ORs of whole rows; successors are visited closest
+// first, and those already reachable through another successor are skipped.
+// The components of each level of the DAG (by longest path to a sink) are
+// independent, so large levels are closed using up to `thread_count` threads.
+void CondensedTransitiveClosure(absl::Span<InlineBitmap> relation,
+                                int64_t thread_count = 1);
+
+// As above, for a relation represented as an explicit adjacency list.
+template <typename V>
+absl::flat_hash_map<V, absl::flat_hash_set<V>> CondensedTransitiveClosure(
+    const absl::flat_hash_map<V, absl::flat_hash_set<V>>& relation) {
+  // Number the vertices, including those which are only targets.
+  std::vector<const V*> vertices;
+  absl::flat_hash_map<V, int64_t> ids;
+  auto id_of = [&](const V& v) -> int64_t {
+    auto [it, inserted] = ids.try_emplace(v, vertices.size());
+    if (inserted) {
+      vertices.push_back(&v);
+    }
+    return it->second;
+  };
+  for (const auto& [source, targets] : relation) {
+    id_of(source);
+    for (const V& target : targets) {
+      id_of(target);
+    }
+  }
+  std::vector<std::vector<int64_t>> successors(vertices.size());
+  for (const auto& [source, targets] : relation) {
+    std::vector<int64_t>& source_successors = successors[ids.at(source)];
+    for (const V& target : targets) {
+      source_successors.push_back(ids.at(target));
+    }
+  }
+  for (std::vector<int64_t>& vertex_successors : successors) {
+    std::sort(vertex_successors.begin(), vertex_successors.end());
+  }
+
+  std::vector<std::vector<int64_t>> components =
+      DenseStronglyConnectedComponents(
+          vertices.size(), [&](int64_t vertex, int64_t after) -> int64_t {
+            auto it = std::upper_bound(successors[vertex].begin(),
+                                       successors[vertex].end(), after);
+            return it == successors[vertex].end() ? -1 : *it;
+          });
+  std::vector<int64_t> component_of(vertices.size());
+  for (int64_t c = 0; c < components.size(); ++c) {
+    for (int64_t vertex : components[c]) {
+      component_of[vertex] = c;
+    }
+  }
+
+  // Components are in reverse topological order, so the closures of the
+  // successors of a component are complete by the time it is reached.
+  std::vector<absl::flat_hash_set<V>> closures(components.size());
+  std::vector<int64_t> last_seen(components.size(), -1);
+  for (int64_t c = 0; c < components.size(); ++c) {
+    std::vector<int64_t> successor_components;
+    for (int64_t vertex : components[c]) {
+      for (int64_t successor : successors[vertex]) {
+        int64_t d = component_of[successor];
+        if (d != c && last_seen[d] != c) {
+          last_seen[d] = c;
+          successor_components.push_back(d);
+        }
+      }
+    }
+    std::sort(successor_components.begin(), successor_components.end(),
+              std::greater<int64_t>());
+    absl::flat_hash_set<V>& closure = closures[c];
+    for (int64_t d : successor_components) {
+      // A component reachable through another successor has its closure
+      // included in that of the other successor.
+      if (!closure.contains(*vertices[components[d].front()])) {
+        closure.insert(closures[d].begin(), closures[d].end());
+      }
+    }
+    for (int64_t vertex : components[c]) {
+      for (int64_t successor : successors[vertex]) {
+        closure.insert(*vertices[successor]);
+      }
+    }
+    if (components[c].size() > 1) {
+      for (int64_t vertex : components[c]) {
+        closure.insert(*vertices[vertex]);
+      }
+    }
+  }
+
+  absl::flat_hash_map<V, absl::flat_hash_set<V>> result;
+  result.reserve(relation.size());
+  for (const auto& [source, targets] : relation) {
+    int64_t c = component_of[ids.at(source)];
+    if (components[c].size() == 1) {
+      result.emplace(source, std::move(closures[c]));
+    } else {
+      result.emplace(source, closures[c]);
+    }
+  }
+  return result;
+}
+
 }  // namespace internal
 
 template <typename V>
@@ -105,26 +217,26 @@ using HashRelation = absl::flat_hash_map<V, absl::flat_hash_set<V>>;
 // Compute the transitive closure of a relation represented as an explicit
 // adjacency list.
 template <typename V>
-HashRelation<V> TransitiveClosure(HashRelation<V> v) {
-  internal::TransitiveClosure(internal::HashRelation<V>(v));
-  return v;
+HashRelation<V> TransitiveClosure(const HashRelation<V>& v) {
+  return internal::CondensedTransitiveClosure(v);
 }
 
 // TODO(allight): Using a more efficient bitmap format like croaring might give
 // a speedup here.
 using DenseIdRelation = absl::Span<InlineBitmap>;
 // Compute the transitive closure of a relation represented as a boolean
-// adjacency matrix.
-inline DenseIdRelation TransitiveClosure(DenseIdRelation v) {
-  internal::TransitiveClosure(internal::DenseIdRelation(v));
+// adjacency matrix, using up to `thread_count` threads.
+inline DenseIdRelation TransitiveClosure(DenseIdRelation v,
+                                         int64_t thread_count = 1) {
+  internal::CondensedTransitiveClosure(v, thread_count);
   return v;
 }
 
 // Compute the transitive closure of a relation represented as a boolean
-// adjacency matrix.
-inline std::vector<InlineBitmap> TransitiveClosure(
-    std::vector<InlineBitmap> v) {
-  TransitiveClosure(absl::MakeSpan(v));
+// adjacency matrix, using up to `thread_count` threads.
+inline std::vector<InlineBitmap> TransitiveClosure(std::vector<InlineBitmap> v,
+                                                   int64_t thread_count = 1) {
+  TransitiveClosure(absl::MakeSpan(v), thread_count);
   return v;
 }
 
@@ -17,6 +17,7 @@
 #include <cstdint>
 #include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "benchmark/benchmark.h"
@@ -87,6 +88,113 @@ HashRelation<V> RandomRelation(std::vector<V> nodes, double p,
   return rel;
 }
 
+// A random relation over `node_cnt` nodes in which each node relates to about
+// `degree` others. Unless `acyclic` is set, about one edge in `degree` may go
+// backwards, forming cycles.
+std::vector<InlineBitmap> RandomSparseDenseRelation(int64_t node_cnt,
+                                                    int64_t degree,
+                                                    bool acyclic,
+                                                    absl::BitGenRef rng) {
+  std::vector<InlineBitmap> res(node_cnt, InlineBitmap(node_cnt));
+  for (int64_t i = 0; i < node_cnt; ++i) {
+    for (int64_t e = 0; e < degree; ++e) {
+      int64_t j = absl::Uniform<int64_t>(rng, 0, node_cnt);
+      if (acyclic && j <= i) {
+        continue;
+      }
+      if (!acyclic && j < i && !absl::Bernoulli(rng, 1.0 / degree)) {
+        continue;
+      }
+      res[i].Set(j);
+    }
+  }
+  return res;
+}
+
+HashRelation<V> ToHashRelation(absl::Span<const InlineBitmap> rel) {
+  HashRelation<V> res;
+  for (int64_t i = 0; i < rel.size(); ++i) {
+    // Leave out some of the nodes without successors.
+    if (rel[i].IsAllZeroes() && i % 2 == 0) {
+      continue;
+    }
+    absl::flat_hash_set<V>& row = res[absl::StrCat(i)];
+    for (int64_t j = 0; j < rel.size(); ++j) {
+      if (rel[i].Get(j)) {
+        row.insert(absl::StrCat(j));
+      }
+    }
+  }
+  return res;
+}
+
+std::vector<InlineBitmap> WarshallTransitiveClosure(
+    std::vector<InlineBitmap> rel) {
+  internal::TransitiveClosure(internal::DenseIdRelation(absl::MakeSpan(rel)));
+  return rel;
+}
+
+TEST(TransitiveClosureTest, MatchesWarshall) {
+  std::mt19937_64 rng(42);
+  for (int64_t node_cnt : {1, 2, 7, 64, 65, 150}) {
+    for (int64_t degree : {1, 2, 4}) {
+      for (bool acyclic : {false, true}) {
+        std::vector<InlineBitmap> rel =
+            RandomSparseDenseRelation(node_cnt, degree, acyclic, rng);
+        std::vector<InlineBitmap> expected = WarshallTransitiveClosure(rel);
+        EXPECT_EQ(TransitiveClosure(rel), expected)
+            << node_cnt << " nodes, degree " << degree;
+
+        HashRelation<V> hash_rel = ToHashRelation(rel);
+        HashRelation<V> hash_expected = hash_rel;
+        internal::TransitiveClosure(internal::HashRelation<V>(hash_expected));
+        EXPECT_EQ(TransitiveClosure(hash_rel), hash_expected)
+            << node_cnt << " nodes, degree " << degree;
+      }
+    }
+  }
+}
+
+TEST(TransitiveClosureTest, Cycles) {
+  HashRelation<V> rel;
+  rel["a"].insert("b");
+  rel["b"].insert("a");
+  rel["b"].insert("c");
+  rel["c"].insert("c");
+  rel["c"].insert("d");
+  HashRelation<V> tc = TransitiveClosure<V>(rel);
+  EXPECT_THAT(tc.at("a"), UnorderedElementsAre("a", "b", "c", "d"));
+  EXPECT_THAT(tc.at("b"), UnorderedElementsAre("a", "b", "c", "d"));
+  EXPECT_THAT(tc.at("c"), UnorderedElementsAre("c", "d"));
+  EXPECT_FALSE(tc.contains("d"));
+}
+
+TEST(TransitiveClosureTest, LongChain) {
+  constexpr int64_t kNodeCnt = 5000;
+  std::vector<InlineBitmap> rel(kNodeCnt, InlineBitmap(kNodeCnt));
+  for (int64_t i = 0; i + 1 < kNodeCnt; ++i) {
+    rel[i].Set(i + 1);
+  }
+  std::vector<InlineBitmap> tc = TransitiveClosure(std::move(rel));
+  for (int64_t i : {int64_t{0}, int64_t{1234}, kNodeCnt - 1}) {
+    InlineBitmap expected(kNodeCnt);
+    for (int64_t j = i + 1; j < kNodeCnt; ++j) {
+      expected.Set(j);
+    }
+    EXPECT_EQ(tc[i], expected) << i;
+  }
+}
+
+TEST(TransitiveClosureTest, ParallelMatchesSerial) {
+  std::mt19937_64 rng(7);
+  for (bool acyclic : {false, true}) {
+    std::vector<InlineBitmap> rel =
+        RandomSparseDenseRelation(3000, 2, acyclic, rng);
+    std::vector<InlineBitmap> serial = TransitiveClosure(rel);
+    EXPECT_EQ(TransitiveClosure(rel, /*thread_count=*/4), serial);
+  }
+}
+
 void BM_RandomRelation(benchmark::State& state) {
   std::seed_seq seq = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
   std::mt19937_64 rng(seq);
@@ -134,5 +242,58 @@ void BM_RandomDenseRelation(benchmark::State& state) {
   }
 }
 BENCHMARK(BM_RandomDenseRelation)->Range(500, 10000);
+
+void BM_RandomDenseRelationWarshall(benchmark::State& state) {
+  absl::BitGen rng;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<InlineBitmap> rel = RandomDenseRelation(state.range(0), rng);
+    state.ResumeTiming();
+    internal::TransitiveClosure(internal::DenseIdRelation(absl::MakeSpan(rel)));
+    benchmark::DoNotOptimize(rel);
+  }
+}
+BENCHMARK(BM_RandomDenseRelationWarshall)->Range(500, 10000);
+
+// Sparse acyclic relations, like the dependencies between the nodes of a proc.
+// Arguments are the node count and the thread count, with a thread count of
+// zero selecting Warshall's algorithm.
+void BM_SparseDagRelation(benchmark::State& state) {
+  std::mt19937_64 rng(42);
+  const std::vector<InlineBitmap> original = RandomSparseDenseRelation(
+      state.range(0), /*degree=*/3, /*acyclic=*/true, rng);
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<InlineBitmap> rel = original;
+    state.ResumeTiming();
+    if (state.range(1) == 0) {
+      internal::TransitiveClosure(
+          internal::DenseIdRelation(absl::MakeSpan(rel)));
+    } else {
+      TransitiveClosure(absl::MakeSpan(rel), state.range(1));
+    }
+    benchmark::DoNotOptimize(rel);
+  }
+}
+BENCHMARK(BM_SparseDagRelation)
+    ->ArgsProduct({{1000, 4000}, {0, 1}})
+    ->ArgsProduct({{4000, 16000, 32000}, {1, 4}});
+
+void BM_SparseDagHashRelation(benchmark::State& state) {
+  std::mt19937_64 rng(42);
+  HashRelation<V> rel = ToHashRelation(RandomSparseDenseRelation(
+      state.range(0), /*degree=*/3, /*acyclic=*/true, rng));
+  for (auto _ : state) {
+    if (state.range(1) == 0) {
+      HashRelation<V> tc = rel;
+      internal::TransitiveClosure(internal::HashRelation<V>(tc));
+      benchmark::DoNotOptimize(tc);
+    } else {
+      HashRelation<V> tc = TransitiveClosure(rel);
+      benchmark::DoNotOptimize(tc);
+    }
+  }
+}
+BENCHMARK(BM_SparseDagHashRelation)->ArgsProduct({{100, 400}, {0, 1}});
 }  // namespace
 }  // namespace xls
@@ -52,11 +52,17 @@ To gather BDD stats of an IR file:
 To gather BDD stats of a set of benchmarks:
    bdd_stats --benchmarks=sha256,crc32
    bdd_stats --benchmarks=all
+
+To also measure the effect of reordering the BDD variables:
+   bdd_stats --bdd_reorder <ir_file>
 )";
 
 ABSL_FLAG(int64_t, bdd_path_limit, 0,
           "Maximum number of paths before truncating the BDD subgraph "
           "and declaring a new variable. If zero, then no limit.");
+ABSL_FLAG(bool, bdd_reorder, false,
+          "Whether to reorder the BDD variables by sifting after construction "
+          "and report the resulting node count.");
 ABSL_FLAG(std::vector<std::string>, benchmarks, {},
           "Comma-separated list of benchmarks gather BDD stats about.");
 
@@ -83,6 +89,15 @@ GetBenchmarks(absl::Span<const std::string> benchmark_names) {
   return packages;
 }
 
+void PrintMaxPaths(const BinaryDecisionDiagram& bdd) {
+  int64_t max_paths = bdd.max_path_count();
+  if (max_paths == std::numeric_limits<int32_t>::max()) {
+    std::cout << "Maximum paths of any expression: INT32_MAX\n";
+  } else {
+    std::cout << "Maximum paths of any expression: " << max_paths << "\n";
+  }
+}
+
 absl::Status RealMain(std::string_view input_path) {
   std::vector<std::pair<std::string, std::unique_ptr<Package>>> packages;
   if (absl::GetFlag(FLAGS_benchmarks).empty()) {
@@ -103,6 +118,7 @@ absl::Status RealMain(std::string_view input_path) {
   }
 
   absl::Duration total_time;
+  absl::Duration total_reorder_time;
   for (const auto& pair : packages) {
     const std::string& name = pair.first;
     const auto& package = pair.second;
@@ -132,20 +148,44 @@ absl::Status RealMain(std::string_view input_path) {
     }
     std::cout << "Bits in graph: " << number_bits << "\n";
 
-    int64_t max_paths = 0;
-    for (int64_t i = 0; i < query_engine.bdd().size(); ++i) {
-      max_paths =
-          std::max(max_paths, query_engine.bdd().path_count(BddNodeIndex(i)));
-    }
-    if (max_paths == std::numeric_limits<int32_t>::max()) {
-      std::cout << "Maximum paths of any expression: INT32_MAX\n";
-    } else {
-      std::cout << "Maximum paths of any expression: " << max_paths << "\n";
+    PrintMaxPaths(query_engine.bdd());
+
+    const BinaryDecisionDiagram::Stats& stats = query_engine.bdd().stats();
+    std::cout << "BDD peak node count: " << stats.peak_node_count << "\n";
+    std::cout << absl::StreamFormat(
+        "BDD computed table hit rate: %.1f%% of %d lookups\n",
+        stats.cache_lookups == 0
+            ? 0.0
+            : 100.0 * stats.cache_hits / stats.cache_lookups,
+        stats.cache_lookups);
+
+    // The query engine references every BDD node it retains, so the other
+    // nodes are intermediate results which garbage collection reclaims.
+    Stopwatch gc_stopwatch;
+    int64_t freed = query_engine.bdd().GarbageCollect();
+    std::cout << "BDD garbage collection time: "
+              << gc_stopwatch.GetElapsedTime() << "\n";
+    std::cout << "BDD live node count: " << query_engine.bdd().size() << " ("
+              << freed << " reclaimed)\n";
+
+    if (absl::GetFlag(FLAGS_bdd_reorder)) {
+      Stopwatch reorder_stopwatch;
+      query_engine.bdd().Reorder();
+      absl::Duration reorder_time = reorder_stopwatch.GetElapsedTime();
+      total_reorder_time += reorder_time;
+      std::cout << "BDD reordering time: " << reorder_time << "\n";
+      std::cout << "BDD node count after reordering: "
+                << query_engine.bdd().size() << " ("
+                << query_engine.bdd().stats().swaps << " swaps)\n";
+      PrintMaxPaths(query_engine.bdd());
     }
   }
 
   if (packages.size() > 1) {
     std::cout << "\nTotal construction time: " << total_time << "\n";
+    if (absl::GetFlag(FLAGS_bdd_reorder)) {
+      std::cout << "Total reordering time: " << total_reorder_time << "\n";
+    }
   }
 
   return absl::OkStatus();
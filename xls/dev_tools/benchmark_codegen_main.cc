@@ -23,15 +23,18 @@
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_split.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "xls/codegen/block_generator.h"
 #include "xls/codegen/block_metrics.h"
 #include "xls/codegen/codegen_options.h"
 #include "xls/codegen/combinational_generator.h"
 #include "xls/codegen/module_signature.h"
 #include "xls/codegen/pipeline_generator.h"
+#include "xls/codegen/vast/vast.h"
 #include "xls/codegen/xls_metrics.pb.h"
 #include "xls/common/exit_status.h"
 #include "xls/common/file/filesystem.h"
@@ -113,6 +116,30 @@ absl::Status PrintPipelinedCodegenInfo(
   return absl::OkStatus();
 }
 
+// Measures the time to emit the Verilog text for the given block from its VAST
+// representation, separately from the time to build the VAST.
+absl::Status PrintEmissionInfo(Block* top,
+                               const verilog::CodegenOptions& codegen_options) {
+  verilog::VerilogFile file(codegen_options.use_system_verilog()
+                                ? verilog::FileType::kSystemVerilog
+                                : verilog::FileType::kVerilog);
+  XLS_RETURN_IF_ERROR(
+      verilog::GenerateVerilogFile(top, codegen_options, &file));
+
+  absl::Time start = absl::Now();
+  absl::Cord text;
+  {
+    verilog::CordVastSink sink(&text);
+    file.EmitTo(sink);
+  }
+  absl::Duration total_time = absl::Now() - start;
+  std::cout << absl::StreamFormat("Emission time: %dms\n",
+                                  total_time / absl::Milliseconds(1));
+  std::cout << absl::StreamFormat("Emitted Verilog bytes: %d\n", text.size());
+
+  return absl::OkStatus();
+}
+
 absl::StatusOr<Block*> GetTopBlock(Package* package) {
   if (!absl::GetFlag(FLAGS_top).empty()) {
     return package->GetBlock(absl::GetFlag(FLAGS_top));
@@ -190,6 +217,9 @@ absl::Status RealMain(std::string_view opt_ir_path,
       XLS_RETURN_IF_ERROR(
           PrintPipelinedCodegenInfo(*top, schedule, codegen_options));
     }
+
+    XLS_ASSIGN_OR_RETURN(Block * top_block, GetTopBlock(block_package.get()));
+    XLS_RETURN_IF_ERROR(PrintEmissionInfo(top_block, codegen_options));
   }
 
   XLS_ASSIGN_OR_RETURN(Block * top, GetTopBlock(block_package.get()));
@@ -118,6 +118,7 @@ class CodeGenMainTest(test_base.TestCase):
     self.assertIn('Lines of Verilog: 7', output)
     self.assertIn('Codegen time:', output)
     self.assertIn('Scheduling time:', output)
+    self.assertIn('Emission time:', output)
 
   def test_simple_block_no_delay_model(self):
     opt_ir_file = self.create_tempfile(content=OPT_IR)
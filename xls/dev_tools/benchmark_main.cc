@@ -81,6 +81,7 @@
 #include "xls/passes/optimization_pass.h"
 #include "xls/passes/optimization_pass_pipeline.h"
 #include "xls/passes/pass_base.h"
+#include "xls/passes/pass_trace.h"
 #include "xls/passes/query_engine.h"
 #include "xls/scheduling/pipeline_schedule.h"
 #include "xls/scheduling/schedule_util.h"
@@ -137,6 +138,10 @@ ABSL_FLAG(std::string, synthesis_server, "ipv4:///0.0.0.0:10000",
           "The address, including port, of the gRPC server to use with "
           "--compare_delay_to_synthesis.");
 // LINT.ThenChange(//xls/build_rules/xls_ir_rules.bzl)
+ABSL_FLAG(std::string, pass_trace_file, "",
+          "If non-empty, write a trace of the optimization passes to this "
+          "file in the Chrome trace event format, viewable in "
+          "chrome://tracing or https://ui.perfetto.dev.");
 
 namespace xls {
 namespace {
@@ -195,10 +200,18 @@ absl::Status RunOptimizationAndPrintStats(Package* package) {
           : std::make_optional(split_next_value_selects);
   pass_options.use_context_narrowing_analysis =
       absl::GetFlag(FLAGS_use_context_narrowing_analysis);
+  std::optional<PassTracer> tracer;
+  if (!absl::GetFlag(FLAGS_pass_trace_file).empty()) {
+    pass_options.tracer = &tracer.emplace();
+  }
   PassResults pass_results;
   OptimizationContext context;
   XLS_RETURN_IF_ERROR(
       pipeline->Run(package, pass_options, &pass_results, context).status());
+  if (tracer.has_value()) {
+    XLS_RETURN_IF_ERROR(
+        tracer->WriteChromeTrace(absl::GetFlag(FLAGS_pass_trace_file)));
+  }
   absl::Duration total_time = absl::Now() - start;
   std::cout << absl::StreamFormat("Optimization time: %dms\n",
                                   DurationToMs(total_time));
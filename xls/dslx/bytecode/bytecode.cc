@@ -24,7 +24,9 @@
 #include <variant>
 #include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/log/check.h"
+#include "absl/log/log.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -37,6 +39,7 @@
 #include "absl/types/variant.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/dslx/bytecode/register_function.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/pos.h"
 #include "xls/dslx/interp_value.h"
@@ -768,6 +771,21 @@ BytecodeFunction::BytecodeFunction(const Module* owner,
       type_info_(type_info),
       bytecodes_(std::move(bytecodes)) {}
 
+BytecodeFunction::~BytecodeFunction() = default;
+
+const RegisterFunction* BytecodeFunction::GetRegisterFunction() const {
+  absl::call_once(register_function_once_, [this] {
+    absl::StatusOr<std::unique_ptr<RegisterFunction>> lowered =
+        RegisterFunction::Lower(*this);
+    if (lowered.ok()) {
+      register_function_ = *std::move(lowered);
+    } else {
+      VLOG(3) << "Not lowering function to registers: " << lowered.status();
+    }
+  });
+  return register_function_.get();
+}
+
 std::vector<Bytecode> BytecodeFunction::CloneBytecodes() const {
   // Create a modifiable copy of the bytecodes.
   std::vector<Bytecode> bytecodes;
@@ -23,6 +23,7 @@
 #include <variant>
 #include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "xls/common/strong_int.h"
@@ -79,7 +80,7 @@ class Bytecode {
     // Expands the N-tuple on the top of the stack by one level, placing leading
     // elements at the top of the stack. In other words, expanding the tuple
     // `(a, (b, c))` will result in a stack of `(b, c), a`, where `a` is on top
-    // of the stack.
+    // of the stack. N is given in the optional data argument when known.
     kExpandTuple,
     // Compares TOS1 to TOS0, storing true if TOS1 == TOS0.
     kEq,
@@ -191,8 +192,8 @@ class Bytecode {
   // Used by kJumpRel and kJumpRelIf opcodes.
   XLS_DEFINE_STRONG_INT_TYPE(JumpTarget, int64_t);
 
-  // Indicates the size of a data structure; used by kCreateArray and
-  // kCreateTuple opcodes.
+  // Indicates the size of a data structure; used by kCreateArray,
+  // kCreateTuple and kExpandTuple opcodes.
   XLS_DEFINE_STRONG_INT_TYPE(NumElements, int64_t);
 
   // Indicates the index into which to store or from which to load a value. Used
@@ -472,6 +473,8 @@ class Bytecode {
 
 std::string OpToString(Bytecode::Op op);
 
+class RegisterFunction;
+
 // Holds all the bytecode implementing a function along with useful metadata.
 class BytecodeFunction {
  public:
@@ -488,6 +491,8 @@ class BytecodeFunction {
       const Module* owner, const Function* source_fn, const TypeInfo* type_info,
       std::vector<Bytecode> bytecode);
 
+  ~BytecodeFunction();
+
   const Module* owner() const { return owner_; }
   const Function* source_fn() const { return source_fn_; }
   const TypeInfo* type_info() const { return type_info_; }
@@ -496,6 +501,10 @@ class BytecodeFunction {
   // Creates and returns a [caller-owned] copy of the internal bytecodes.
   std::vector<Bytecode> CloneBytecodes() const;
 
+  // Returns the register-based form of this function, lowering it on first
+  // use, or nullptr if the function can't be lowered. Thread-safe.
+  const RegisterFunction* GetRegisterFunction() const;
+
  private:
   BytecodeFunction(const Module* owner, const Function* source_fn,
                    const TypeInfo* type_info, std::vector<Bytecode> bytecode);
@@ -504,6 +513,9 @@ class BytecodeFunction {
   const Function* source_fn_;
   const TypeInfo* type_info_;
   std::vector<Bytecode> bytecodes_;
+
+  mutable absl::once_flag register_function_once_;
+  mutable std::unique_ptr<RegisterFunction> register_function_;
 };
 
 // Converts the given sequence of bytecodes to a more human-readable string,
@@ -24,6 +24,7 @@
 #include <variant>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/function_ref.h"
@@ -1289,7 +1290,21 @@ absl::Status BytecodeEmitter::DestructureLet(
   } else {
     // Pushes each element of the current level of the tuple
     // onto the stack in reverse order, e.g., (a, (b, c)) pushes (b, c) then a
-    Add(Bytecode(tree->span(), Bytecode::Op::kExpandTuple));
+    //
+    // The element count is recorded when it's statically known, which lets
+    // the stack depth after the expansion be determined without executing it.
+    std::optional<Bytecode::Data> element_count;
+    if (!absl::c_any_of(tree->nodes(), [](const NameDefTree* node) {
+          return node->IsRestOfTupleLeaf();
+        })) {
+      element_count = Bytecode::NumElements(tree->nodes().size());
+    } else if (std::holds_alternative<Type*>(type_or_size) &&
+               dynamic_cast<TupleType*>(std::get<Type*>(type_or_size)) !=
+                   nullptr) {
+      element_count = Bytecode::NumElements(CountElements(type_or_size));
+    }
+    Add(Bytecode(tree->span(), Bytecode::Op::kExpandTuple,
+                 std::move(element_count)));
 
     // Note: we intentionally don't check validity of the tuple here; that's
     // done by Deduce().
@@ -165,10 +165,10 @@ fn has_name_def_tree() -> (u32, u64, uN[128]) {
 006 create_tuple 3
 007 create_tuple 2
 008 create_tuple 3
-009 expand_tuple
+009 expand_tuple 3
 010 store 0
 011 store 1
-012 expand_tuple
+012 expand_tuple 2
 013 store 2
 014 store 3
 015 load 0
@@ -1363,7 +1363,7 @@ fn main() -> u32 {
       "index",
       "swap",
       "create_tuple 2",
-      "expand_tuple",
+      "expand_tuple 2",
       "store 2",
       "store 3",
       "load 3",
@@ -1421,9 +1421,9 @@ load 2
 index
 swap
 create_tuple 2
-expand_tuple
+expand_tuple 2
 pop
-expand_tuple
+expand_tuple 0
 literal [u8:119, u8:104, u8:101, u8:101]
 load 0
 literal u64:0
@@ -1672,7 +1672,7 @@ proc Foo {
   const std::vector<std::string> kConfigExpected = {
       "literal (channel_reference(out, channel_instance_id=none), "
       "channel_reference(in, channel_instance_id=none))",
-      "expand_tuple",
+      "expand_tuple 2",
       "store 0",
       "store 1",
       "load 1",
@@ -1745,7 +1745,7 @@ proc Parent {
   const std::vector<std::string> kParentConfigExpected = {
       "literal (channel_reference(out, channel_instance_id=none), "
       "channel_reference(in, channel_instance_id=none))",
-      "expand_tuple",
+      "expand_tuple 2",
       "store 0",
       "store 1",
       "load 1",
@@ -1807,7 +1807,7 @@ proc Parent {
                           "literal u1:1",   //
                           "literal u32:0",  //
                           "recv c",         //
-                          "expand_tuple",   //
+                          "expand_tuple 2", //
                           "store 4",        //
                           "store 5",        //
                           "load 3",         //
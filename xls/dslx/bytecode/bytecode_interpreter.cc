@@ -26,6 +26,8 @@
 #include <variant>
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"
+#include "absl/container/fixed_array.h"
 #include "absl/log/check.h"
 #include "absl/log/die_if_null.h"
 #include "absl/log/log.h"
@@ -44,6 +46,8 @@
 #include "xls/dslx/bytecode/bytecode_interpreter_options.h"
 #include "xls/dslx/bytecode/frame.h"
 #include "xls/dslx/bytecode/interpreter_stack.h"
+#include "xls/dslx/bytecode/register_function.h"
+#include "xls/dslx/bytecode/register_value.h"
 #include "xls/dslx/dslx_builtins.h"
 #include "xls/dslx/errors.h"
 #include "xls/dslx/frontend/ast.h"
@@ -135,6 +139,116 @@ absl::StatusOr<InterpValue> ResizeBitsValue(const InterpValue& from,
   return InterpValue::MakeBits(is_signed, result_bits);
 }
 
+// Evaluates a binary bytecode on register values holding inline bits, as the
+// corresponding InterpValue operation would. Returns nullopt if the operands
+// aren't both inline bits or the operation could fail on them, in which case
+// it's left to the stack machine to produce the result or error.
+std::optional<RegisterValue> EvalInlineBitsBinop(Bytecode::Op op,
+                                                 const RegisterValue& lhs,
+                                                 const RegisterValue& rhs) {
+  using Op = Bytecode::Op;
+  if (!lhs.IsInlineBits() || !rhs.IsInlineBits()) {
+    return std::nullopt;
+  }
+  const int64_t bit_count = lhs.bit_count();
+  const bool is_signed = lhs.IsSigned();
+  const bool same_width = bit_count == rhs.bit_count();
+  const bool same_tag = is_signed == rhs.IsSigned();
+  const uint64_t a = lhs.bits();
+  const uint64_t b = rhs.bits();
+  auto make_bits = [&](uint64_t value) {
+    return RegisterValue::MakeBits(is_signed, bit_count, value);
+  };
+  auto compare = [&](auto cmp) -> std::optional<RegisterValue> {
+    if (!same_width || !same_tag) {
+      return std::nullopt;
+    }
+    return RegisterValue::MakeBool(is_signed
+                                       ? cmp(lhs.SignedBits(), rhs.SignedBits())
+                                       : cmp(a, b));
+  };
+  switch (op) {
+    case Op::kUAdd:
+    case Op::kSAdd:
+    case Op::kAnd:
+      if (!same_width || !same_tag) {
+        return std::nullopt;
+      }
+      return make_bits(op == Op::kAnd ? a & b : a + b);
+    case Op::kUSub:
+    case Op::kSSub:
+    case Op::kUMul:
+    case Op::kSMul:
+    case Op::kOr:
+    case Op::kXor:
+      if (!same_width) {
+        return std::nullopt;
+      }
+      switch (op) {
+        case Op::kUSub:
+        case Op::kSSub:
+          return make_bits(a - b);
+        case Op::kUMul:
+        case Op::kSMul:
+          return make_bits(a * b);
+        case Op::kOr:
+          return make_bits(a | b);
+        default:
+          return make_bits(a ^ b);
+      }
+    case Op::kLogicalAnd:
+    case Op::kLogicalOr:
+      if (bit_count != 1 || !same_width || !same_tag) {
+        return std::nullopt;
+      }
+      return make_bits(op == Op::kLogicalAnd ? a & b : a | b);
+    case Op::kEq:
+      return RegisterValue::MakeBool(same_width && a == b);
+    case Op::kNe:
+      return RegisterValue::MakeBool(!(same_width && a == b));
+    case Op::kLt:
+      return compare(std::less<>());
+    case Op::kLe:
+      return compare(std::less_equal<>());
+    case Op::kGt:
+      return compare(std::greater<>());
+    case Op::kGe:
+      return compare(std::greater_equal<>());
+    case Op::kShl:
+      return make_bits(b >= bit_count ? 0 : a << b);
+    case Op::kShr:
+      if (is_signed) {
+        return make_bits(static_cast<uint64_t>(
+            lhs.SignedBits() >> std::min<uint64_t>(b, 63)));
+      }
+      return make_bits(b >= bit_count ? 0 : a >> b);
+    case Op::kConcat: {
+      const int64_t rhs_bit_count = rhs.bit_count();
+      if (is_signed || rhs.IsSigned() ||
+          bit_count + rhs_bit_count > RegisterValue::kMaxInlineBitCount) {
+        return std::nullopt;
+      }
+      const uint64_t high = rhs_bit_count >= 64 ? 0 : a << rhs_bit_count;
+      return RegisterValue::MakeBits(/*is_signed=*/false,
+                                     bit_count + rhs_bit_count, high | b);
+    }
+    default:
+      return std::nullopt;
+  }
+}
+
+// Returns whether the values held by the registers are equal per
+// InterpValue::Eq (i.e., `lhs.Eq(rhs)`).
+absl::StatusOr<bool> RegisterValuesEqual(const RegisterValue& lhs,
+                                         const RegisterValue& rhs) {
+  if (lhs.IsInlineBits() && rhs.IsInlineBits()) {
+    return lhs.bit_count() == rhs.bit_count() && lhs.bits() == rhs.bits();
+  }
+  XLS_ASSIGN_OR_RETURN(InterpValue lhs_value, lhs.ToInterpValue());
+  XLS_ASSIGN_OR_RETURN(InterpValue rhs_value, rhs.ToInterpValue());
+  return lhs_value.Eq(rhs_value);
+}
+
 }  // namespace
 
 // How much to indent the data value in the trace emitted when sending/receiving
@@ -197,7 +311,13 @@ BytecodeInterpreter::CreateUnique(
 
 absl::Status BytecodeInterpreter::Run(bool* progress_made) {
   blocked_channel_info_ = std::nullopt;
-  while (!frames_.empty()) {
+  return RunFrames(/*depth=*/0, progress_made);
+}
+
+absl::Status BytecodeInterpreter::RunFrames(int64_t depth,
+                                            bool* progress_made) {
+  while (frames_.size() > depth) {
+    XLS_RETURN_IF_ERROR(MaybeRunRegisterFunction(progress_made));
     Frame* frame = &frames_.back();
     while (frame->pc() < frame->bf()->bytecodes().size()) {
       const std::vector<Bytecode>& bytecodes = frame->bf()->bytecodes();
@@ -213,6 +333,7 @@ absl::Status BytecodeInterpreter::Run(bool* progress_made) {
                                     stack_.ToString());
 
       if (bytecode.op() == Bytecode::Op::kCall) {
+        XLS_RETURN_IF_ERROR(MaybeRunRegisterFunction(progress_made));
         frame = &frames_.back();
       } else if (frame->pc() != old_pc + 1) {
         XLS_RET_CHECK(bytecodes.at(frame->pc()).op() == Bytecode::Op::kJumpDest)
@@ -252,6 +373,313 @@ absl::Status BytecodeInterpreter::Run(bool* progress_made) {
   return absl::OkStatus();
 }
 
+absl::Status BytecodeInterpreter::MaybeRunRegisterFunction(
+    bool* progress_made) {
+  if (!options_.register_lowering() || frames_.back().pc() != 0) {
+    return absl::OkStatus();
+  }
+  const RegisterFunction* rf = frames_.back().bf()->GetRegisterFunction();
+  if (rf == nullptr) {
+    return absl::OkStatus();
+  }
+  const int64_t frame_index = frames_.size() - 1;
+  XLS_RETURN_IF_ERROR(RunRegisterFunction(*rf, frame_index));
+  Frame& frame = frames_[frame_index];
+  frame.set_pc(frame.bf()->bytecodes().size());
+  if (progress_made != nullptr) {
+    *progress_made = true;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BytecodeInterpreter::RunRegisterFunction(
+    const RegisterFunction& rf, int64_t frame_index) {
+  // Everything allocated in the arena during this call is only reachable from
+  // `registers`, so can be released on return. Note that frames are accessed
+  // by index since calls may reallocate `frames_`.
+  const RegisterValueArena::Mark mark = register_arena_.GetMark();
+  absl::Cleanup release_arena = [&] { register_arena_.Release(mark); };
+
+  absl::FixedArray<RegisterValue> registers(rf.register_count());
+  std::vector<InterpValue>& slots = frames_[frame_index].slots();
+  for (int64_t i = 0;
+       i < std::min(static_cast<int64_t>(slots.size()), rf.slot_count()); ++i) {
+    registers[i] =
+        RegisterValue::FromInterpValue(std::move(slots[i]), register_arena_);
+  }
+  for (const RegisterFunction::Constant& constant : rf.constants()) {
+    registers[constant.reg] =
+        RegisterValue::Borrow(*constant.value).WithFormat(constant.format);
+  }
+
+  const std::vector<RegisterFunction::Instruction>& instructions =
+      rf.instructions();
+  int64_t ip = 0;
+  while (true) {
+    XLS_RET_CHECK_LT(ip, instructions.size());
+    const RegisterFunction::Instruction& instruction = instructions[ip];
+    switch (instruction.kind) {
+      case RegisterFunction::Kind::kMove:
+        registers[instruction.dst] = registers[instruction.operands[0]];
+        ++ip;
+        break;
+      case RegisterFunction::Kind::kMoveUnformatted:
+        registers[instruction.dst] =
+            registers[instruction.operands[0]].WithoutFormat();
+        ++ip;
+        break;
+      case RegisterFunction::Kind::kJump:
+        ip = instruction.target;
+        break;
+      case RegisterFunction::Kind::kJumpIf:
+        ip = registers[instruction.operands[0]].IsTrue() ? instruction.target
+                                                          : ip + 1;
+        break;
+      case RegisterFunction::Kind::kEval:
+        XLS_RETURN_IF_ERROR(EvalRegisterInstruction(
+            instruction, frame_index, absl::MakeSpan(registers)));
+        ++ip;
+        break;
+      case RegisterFunction::Kind::kReturn: {
+        const RegisterValue& result = registers[instruction.operands[0]];
+        XLS_ASSIGN_OR_RETURN(InterpValue value, result.ToInterpValue());
+        std::optional<ValueFormatDescriptor> format;
+        if (result.format() != nullptr) {
+          format = *result.format();
+        }
+        stack_.PushFormattedValue({.value = std::move(value),
+                                   .format_descriptor = std::move(format)});
+        return absl::OkStatus();
+      }
+    }
+  }
+}
+
+absl::Status BytecodeInterpreter::EvalRegisterInstruction(
+    const RegisterFunction::Instruction& instruction, int64_t frame_index,
+    absl::Span<RegisterValue> registers) {
+  XLS_ASSIGN_OR_RETURN(bool evaluated,
+                       EvalRegisterInstructionNative(instruction, registers));
+  if (evaluated) {
+    return absl::OkStatus();
+  }
+
+  // Run the bytecode on the stack machine: push the operands, evaluate it (and
+  // any frame it calls) and pop the results.
+  frames_[frame_index].set_pc(instruction.pc);
+  const int64_t stack_base = stack_.size();
+  for (RegisterFunction::Register reg : instruction.operands) {
+    const RegisterValue& operand = registers[reg];
+    XLS_ASSIGN_OR_RETURN(InterpValue value, operand.ToInterpValue());
+    if (operand.format() != nullptr) {
+      stack_.PushFormattedValue(
+          {.value = std::move(value), .format_descriptor = *operand.format()});
+    } else {
+      stack_.Push(std::move(value));
+    }
+  }
+  XLS_RETURN_IF_ERROR(EvalNextInstruction());
+  if (frames_.size() > frame_index + 1) {
+    XLS_RETURN_IF_ERROR(
+        RunFrames(/*depth=*/frame_index + 1, /*progress_made=*/nullptr));
+  }
+  XLS_RET_CHECK_EQ(stack_.size(), stack_base + instruction.result_count)
+      << "Unexpected stack depth after evaluating "
+      << instruction.bytecode->ToString(file_table());
+  for (int64_t i = instruction.result_count - 1; i >= 0; --i) {
+    XLS_ASSIGN_OR_RETURN(InterpreterStack::FormattedInterpValue result,
+                         stack_.PopFormattedValue());
+    const ValueFormatDescriptor* format = nullptr;
+    if (result.format_descriptor.has_value()) {
+      format = register_arena_.Box(*std::move(result.format_descriptor));
+    }
+    registers[instruction.dst + i] =
+        RegisterValue::FromInterpValue(std::move(result.value),
+                                       register_arena_)
+            .WithFormat(format);
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<bool> BytecodeInterpreter::EvalRegisterInstructionNative(
+    const RegisterFunction::Instruction& instruction,
+    absl::Span<RegisterValue> registers) {
+  using Op = Bytecode::Op;
+  const Op op = instruction.bytecode->op();
+  RegisterValue& dst = registers[instruction.dst];
+  switch (op) {
+    case Op::kUAdd:
+    case Op::kSAdd:
+    case Op::kUSub:
+    case Op::kSSub:
+    case Op::kUMul:
+    case Op::kSMul:
+      // The rollover hook needs the full-precision result.
+      if (options_.rollover_hook() != nullptr) {
+        return false;
+      }
+      [[fallthrough]];
+    case Op::kAnd:
+    case Op::kOr:
+    case Op::kXor:
+    case Op::kLogicalAnd:
+    case Op::kLogicalOr:
+    case Op::kEq:
+    case Op::kNe:
+    case Op::kLt:
+    case Op::kLe:
+    case Op::kGt:
+    case Op::kGe:
+    case Op::kShl:
+    case Op::kShr:
+    case Op::kConcat: {
+      std::optional<RegisterValue> result =
+          EvalInlineBitsBinop(op, registers[instruction.operands[0]],
+                              registers[instruction.operands[1]]);
+      if (!result.has_value()) {
+        return false;
+      }
+      dst = *result;
+      return true;
+    }
+    case Op::kInvert:
+    case Op::kNegate: {
+      const RegisterValue& arg = registers[instruction.operands[0]];
+      if (!arg.IsInlineBits()) {
+        return false;
+      }
+      const uint64_t bits = arg.bits();
+      dst = RegisterValue::MakeBits(arg.IsSigned(), arg.bit_count(),
+                                    op == Op::kInvert ? ~bits : 0 - bits);
+      return true;
+    }
+    case Op::kIndex:
+    case Op::kTupleIndex: {
+      const RegisterValue& basis = registers[instruction.operands[0]];
+      const RegisterValue& index = registers[instruction.operands[1]];
+      if (basis.IsEmpty() || !index.IsInlineBits() || index.IsSigned()) {
+        return false;
+      }
+      const int64_t count = basis.ElementCount();
+      if (count < 0 || index.bits() >= count ||
+          (op == Op::kTupleIndex && basis.tag() != InterpValueTag::kTuple)) {
+        return false;
+      }
+      dst = basis.Element(index.bits());
+      return true;
+    }
+    case Op::kCreateTuple:
+    case Op::kCreateArray: {
+      absl::Span<RegisterValue> elements =
+          register_arena_.AllocateElements(instruction.operands.size());
+      for (int64_t i = 0; i < instruction.operands.size(); ++i) {
+        const RegisterValue& element = registers[instruction.operands[i]];
+        if (element.IsEmpty()) {
+          return false;
+        }
+        elements[i] = element.WithoutFormat();
+      }
+      dst = RegisterValue::MakeAggregate(op == Op::kCreateTuple
+                                             ? InterpValueTag::kTuple
+                                             : InterpValueTag::kArray,
+                                         elements);
+      return true;
+    }
+    case Op::kExpandTuple: {
+      // The tuple is copied first since its register may be overwritten by
+      // the results. Elements are pushed last-first, so element 0 ends up on
+      // top of the stack, i.e. in the last result register.
+      const RegisterValue tuple = registers[instruction.operands[0]];
+      if (tuple.IsEmpty() || tuple.tag() != InterpValueTag::kTuple ||
+          tuple.ElementCount() != instruction.result_count) {
+        return false;
+      }
+      const int64_t count = instruction.result_count;
+      for (int64_t i = 0; i < count; ++i) {
+        registers[instruction.dst + i] = tuple.Element(count - 1 - i);
+      }
+      return true;
+    }
+    case Op::kMatchArm: {
+      XLS_ASSIGN_OR_RETURN(const Bytecode::MatchArmItem* item,
+                           instruction.bytecode->match_arm_item());
+      const RegisterValue matchee = registers[instruction.operands[0]];
+      if (matchee.IsEmpty()) {
+        return false;
+      }
+      XLS_ASSIGN_OR_RETURN(
+          bool equal, MatchArmEqualsRegisterValue(*item, matchee, registers));
+      registers[instruction.dst] = RegisterValue::MakeBool(equal);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+absl::StatusOr<bool> BytecodeInterpreter::MatchArmEqualsRegisterValue(
+    const Bytecode::MatchArmItem& item, const RegisterValue& value,
+    absl::Span<RegisterValue> registers) {
+  using Kind = Bytecode::MatchArmItem::Kind;
+  switch (item.kind()) {
+    case Kind::kInterpValue: {
+      XLS_ASSIGN_OR_RETURN(InterpValue arm_value, item.interp_value());
+      return RegisterValuesEqual(RegisterValue::Borrow(arm_value), value);
+    }
+    case Kind::kLoad: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot_index, item.slot_index());
+      if (slot_index.value() >= registers.size()) {
+        return absl::InternalError(absl::StrCat(
+            "MatchArm load item index was OOB: ", slot_index.value(), " vs. ",
+            registers.size(), "."));
+      }
+      if (registers[slot_index.value()].IsEmpty()) {
+        return absl::InternalError(absl::StrCat(
+            "MatchArm load item register was empty: ", slot_index.value(),
+            "."));
+      }
+      return RegisterValuesEqual(registers[slot_index.value()], value);
+    }
+    case Kind::kStore: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot_index, item.slot_index());
+      XLS_RET_CHECK_LT(slot_index.value(), registers.size());
+      registers[slot_index.value()] = value.WithoutFormat();
+      return true;
+    }
+    case Kind::kWildcard:
+    case Kind::kRestOfTuple:
+      return true;
+    case Kind::kRange:
+      break;
+    case Kind::kTuple: {
+      if (value.ElementCount() < 0) {
+        // Let the stack machine's matcher report the error.
+        break;
+      }
+      XLS_ASSIGN_OR_RETURN(std::vector<Bytecode::MatchArmItem> item_elements,
+                           item.tuple_elements());
+      if (item_elements.size() != value.ElementCount()) {
+        return absl::InternalError(
+            absl::StrCat("Match arm item had a different number of elements "
+                         "than the corresponding InterpValue: ",
+                         item.ToString(), " vs. ", value.ToString()));
+      }
+      for (int64_t i = 0; i < item_elements.size(); ++i) {
+        XLS_ASSIGN_OR_RETURN(
+            bool equal, MatchArmEqualsRegisterValue(item_elements[i],
+                                                    value.Element(i),
+                                                    registers));
+        if (!equal) {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+  XLS_ASSIGN_OR_RETURN(InterpValue interp_value, value.ToInterpValue());
+  return MatchArmEqualsInterpValue(&frames_.back(), item, interp_value);
+}
+
 absl::StatusOr<std::vector<InterpValue>>
 BytecodeInterpreter::PopArgsRightToLeft(size_t count) {
   std::vector<InterpValue> args(count, InterpValue::MakeToken());
@@ -33,6 +33,8 @@
 #include "xls/dslx/bytecode/bytecode_interpreter_options.h"
 #include "xls/dslx/bytecode/frame.h"
 #include "xls/dslx/bytecode/interpreter_stack.h"
+#include "xls/dslx/bytecode/register_function.h"
+#include "xls/dslx/bytecode/register_value.h"
 #include "xls/dslx/dslx_builtins.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/pos.h"
@@ -162,6 +164,30 @@ class BytecodeInterpreter {
   std::string FormatChannelNameForTracing(const Bytecode::ChannelData& channel);
 
  private:
+  // Runs frames until only `depth` frames remain.
+  absl::Status RunFrames(int64_t depth, bool* progress_made);
+
+  // Runs the current frame to completion in its register-based form if
+  // register lowering is enabled, the frame hasn't started executing and its
+  // function can be lowered. Afterwards the frame's PC points to the end of
+  // its bytecode and its result is on the stack, as if run by the stack
+  // machine.
+  absl::Status MaybeRunRegisterFunction(bool* progress_made);
+  absl::Status RunRegisterFunction(const RegisterFunction& rf,
+                                   int64_t frame_index);
+
+  // Evaluates a kEval instruction of a register function, natively if
+  // possible and otherwise by running its bytecode on the stack machine.
+  absl::Status EvalRegisterInstruction(
+      const RegisterFunction::Instruction& instruction, int64_t frame_index,
+      absl::Span<RegisterValue> registers);
+  absl::StatusOr<bool> EvalRegisterInstructionNative(
+      const RegisterFunction::Instruction& instruction,
+      absl::Span<RegisterValue> registers);
+  absl::StatusOr<bool> MatchArmEqualsRegisterValue(
+      const Bytecode::MatchArmItem& item, const RegisterValue& value,
+      absl::Span<RegisterValue> registers);
+
   // Runs the next instruction in the current frame. Returns an error if called
   // when the PC is already pointing to the end of the bytecode.
   absl::Status EvalNextInstruction();
@@ -256,6 +282,8 @@ class BytecodeInterpreter {
 
   InterpreterStack stack_;
   std::vector<Frame> frames_;
+  // Holds the aggregates and boxed values of executing register functions.
+  RegisterValueArena register_arena_;
   std::optional<InterpValueChannelManager*> channel_manager_;
   BytecodeInterpreterOptions options_;
 
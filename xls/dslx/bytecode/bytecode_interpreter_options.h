@@ -97,6 +97,15 @@ class BytecodeInterpreterOptions {
   }
   FormatPreference format_preference() const { return format_preference_; }
 
+  // Whether to execute functions in their register-based form (see
+  // RegisterFunction) where possible. Functions which can't be lowered are run
+  // on the stack machine as usual.
+  BytecodeInterpreterOptions& register_lowering(bool value) {
+    register_lowering_ = value;
+    return *this;
+  }
+  bool register_lowering() const { return register_lowering_; }
+
  private:
   PostFnEvalHook post_fn_eval_hook_ = nullptr;
   TraceHook trace_hook_ = nullptr;
@@ -105,6 +114,7 @@ class BytecodeInterpreterOptions {
   std::optional<int64_t> max_ticks_;
   bool validate_final_stack_depth_ = true;
   FormatPreference format_preference_ = FormatPreference::kDefault;
+  bool register_lowering_ = false;
 };
 
 }  // namespace xls::dslx
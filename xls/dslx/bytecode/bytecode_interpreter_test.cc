@@ -119,9 +119,25 @@ static absl::StatusOr<InterpValue> Interpret(
                                      options.format_preference()}));
   XLS_RET_CHECK_EQ(bf->owner(), f->owner());
 
-  return BytecodeInterpreter::Interpret(import_data, bf.get(), args,
-                                        /*channel_manager=*/std::nullopt,
-                                        options);
+  absl::StatusOr<InterpValue> result = BytecodeInterpreter::Interpret(
+      import_data, bf.get(), args, /*channel_manager=*/std::nullopt, options);
+
+  // Check that register-based execution agrees with the stack machine, unless
+  // the test observes hooks (which would be invoked twice).
+  if (!options.register_lowering() && options.post_fn_eval_hook() == nullptr &&
+      options.trace_hook() == nullptr && options.rollover_hook() == nullptr) {
+    BytecodeInterpreterOptions register_options = options;
+    register_options.register_lowering(true);
+    absl::StatusOr<InterpValue> register_result =
+        BytecodeInterpreter::Interpret(import_data, bf.get(), args,
+                                       /*channel_manager=*/std::nullopt,
+                                       register_options);
+    EXPECT_EQ(register_result.status(), result.status());
+    if (result.ok() && register_result.ok()) {
+      EXPECT_EQ(*register_result, *result);
+    }
+  }
+  return result;
 }
 
 static const Pos kFakePos(Fileno(0), 0, 0);
@@ -2593,5 +2609,84 @@ fn g() -> u32[3] {
   EXPECT_EQ(bit_value, 8);
 }
 
+TEST_F(BytecodeInterpreterTest, RegisterLoweringRunsLoopsAndCalls) {
+  constexpr std::string_view kProgram = R"(
+fn square(x: u32) -> u32 { x * x }
+
+fn main(n: u32) -> (u32, u64) {
+  let (sum, wide) = for (i, (sum, wide)) in u32:0..u32:8 {
+    let sq = square(i);
+    (sum + sq, if sq > n { wide + (sq as u64) } else { wide })
+  }((u32:0, u64:0));
+  (sum, wide)
+})";
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm,
+      ParseAndTypecheckOrPrintError(kProgram, &import_data_.value()));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f,
+                           tm.module->GetMemberOrError<Function>("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<BytecodeFunction> bf,
+      BytecodeEmitter::Emit(&import_data_.value(), tm.type_info, *f,
+                            ParametricEnv()));
+  EXPECT_NE(bf->GetRegisterFunction(), nullptr);
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpValue result,
+      BytecodeInterpreter::Interpret(
+          &import_data_.value(), bf.get(), {InterpValue::MakeU32(10)},
+          /*channel_manager=*/std::nullopt,
+          BytecodeInterpreterOptions().register_lowering(true)));
+  EXPECT_EQ(result, InterpValue::MakeTuple({InterpValue::MakeU32(140),
+                                            InterpValue::MakeU64(126)}));
+}
+
+TEST_F(BytecodeInterpreterTest, RegisterLoweringWideValuesAndMatch) {
+  constexpr std::string_view kProgram = R"(
+fn main(x: u128, y: (u8, s8)) -> u128 {
+  let z = match y {
+    (u8:0, _) => x,
+    (a, s8:3) => x + (a as u128),
+    (a, b) => (x << (a as u128)) ^ (b as u128),
+  };
+  z * u128:3
+})";
+
+  const BytecodeInterpreterOptions options =
+      BytecodeInterpreterOptions().register_lowering(true);
+  const InterpValue x = InterpValue::MakeUBits(128, 5);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpValue result,
+      Interpret(kProgram, "main",
+                {x, InterpValue::MakeTuple({InterpValue::MakeU8(2),
+                                            InterpValue::MakeSBits(8, 3)})},
+                options));
+  EXPECT_EQ(result, InterpValue::MakeUBits(128, 21));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      result,
+      Interpret(kProgram, "main",
+                {x, InterpValue::MakeTuple({InterpValue::MakeU8(1),
+                                            InterpValue::MakeSBits(8, 1)})},
+                options));
+  EXPECT_EQ(result, InterpValue::MakeUBits(128, 33));
+}
+
+TEST_F(BytecodeInterpreterTest, RegisterLoweringReportsFailures) {
+  constexpr std::string_view kProgram = R"(
+fn main(x: u32) -> u32 {
+  assert_eq(x, u32:7);
+  x
+})";
+
+  EXPECT_THAT(Interpret(kProgram, "main", {InterpValue::MakeU32(3)},
+                        BytecodeInterpreterOptions().register_lowering(true)),
+              StatusIs(absl::StatusCode::kInternal,
+                       testing::AllOf(HasSubstr("were not equal"),
+                                      HasSubstr("lhs: u32:3"),
+                                      HasSubstr("rhs: u32:7"))));
+}
+
 }  // namespace
 }  // namespace xls::dslx
@@ -0,0 +1,688 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/bytecode/register_function.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/types/span.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/bytecode/bytecode.h"
+#include "xls/dslx/frontend/ast.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/ir/format_strings.h"
+
+namespace xls::dslx {
+namespace {
+
+using Register = RegisterFunction::Register;
+using Instruction = RegisterFunction::Instruction;
+using Kind = RegisterFunction::Kind;
+
+// During lowering, the registers of stack positions and scratch registers are
+// numbered from these bases; they're renumbered to follow the slot and
+// constant registers once their counts are known.
+constexpr Register kStackBase = 1 << 20;
+constexpr Register kScratchBase = 1 << 29;
+
+absl::Status CannotLower(int64_t pc, std::string_view reason) {
+  return absl::UnimplementedError(absl::StrFormat(
+      "Cannot lower bytecode at PC %d to registers: %s", pc, reason));
+}
+
+absl::StatusOr<int64_t> TraceArgCount(const Bytecode& bytecode) {
+  XLS_ASSIGN_OR_RETURN(const Bytecode::TraceData* trace_data,
+                       bytecode.trace_data());
+  return absl::c_count_if(trace_data->steps(), [](const FormatStep& step) {
+    return !std::holds_alternative<std::string>(step);
+  });
+}
+
+// Collects the slots loaded or stored by the given match arm item.
+absl::Status CollectMatchArmSlots(const Bytecode::MatchArmItem& item,
+                                  std::vector<int64_t>& loads,
+                                  std::vector<int64_t>& stores) {
+  using ItemKind = Bytecode::MatchArmItem::Kind;
+  switch (item.kind()) {
+    case ItemKind::kLoad: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot, item.slot_index());
+      loads.push_back(slot.value());
+      return absl::OkStatus();
+    }
+    case ItemKind::kStore: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot, item.slot_index());
+      stores.push_back(slot.value());
+      return absl::OkStatus();
+    }
+    case ItemKind::kTuple: {
+      XLS_ASSIGN_OR_RETURN(std::vector<Bytecode::MatchArmItem> elements,
+                           item.tuple_elements());
+      for (const Bytecode::MatchArmItem& element : elements) {
+        XLS_RETURN_IF_ERROR(CollectMatchArmSlots(element, loads, stores));
+      }
+      return absl::OkStatus();
+    }
+    default:
+      return absl::OkStatus();
+  }
+}
+
+// Lowers a function by simulating its stack: each stack position holds an
+// Entry naming the register which holds its value. An entry refers to either
+// the register of its own stack position, a slot or a constant. Since no entry
+// refers to the register of another stack position, those registers can be
+// reused as soon as their position is popped.
+class Lowerer {
+ public:
+  explicit Lowerer(const BytecodeFunction& bf)
+      : bytecodes_(bf.bytecodes()),
+        constant_of_pc_(bytecodes_.size(), -1) {}
+
+  absl::Status Lower();
+
+  int64_t slot_count() const { return slot_count_; }
+  int64_t max_depth() const { return max_depth_; }
+  int64_t scratch_count() const { return scratch_count_; }
+  std::vector<RegisterFunction::Constant>& constants() { return constants_; }
+  std::vector<Instruction>& instructions() { return instructions_; }
+
+ private:
+  struct Entry {
+    Register reg;
+    // Whether the value must be used without the format descriptor of the
+    // register, e.g., for dups of literals.
+    bool unformatted;
+  };
+
+  struct Label {
+    // The stack depth at the label, once known.
+    std::optional<int64_t> depth;
+    // The index of the first instruction after the label, once placed.
+    int64_t instruction = -1;
+    // Jumps emitted before the label was placed.
+    std::vector<int64_t> pending_jumps;
+  };
+
+  // Assigns slot and constant registers.
+  absl::Status AssignRegisters();
+
+  absl::Status LowerBytecode(int64_t& pc);
+
+  static Register StackRegister(int64_t position) {
+    return kStackBase + position;
+  }
+  bool IsFormattedConstant(Register reg) const {
+    return reg >= slot_count_ && reg < slot_count_ + constants_.size() &&
+           constants_[reg - slot_count_].format != nullptr;
+  }
+  bool IsConstant(Register reg) const {
+    return reg >= slot_count_ && reg < slot_count_ + constants_.size();
+  }
+
+  void Emit(Instruction instruction) {
+    instructions_.push_back(std::move(instruction));
+  }
+  void EmitMove(Kind kind, Register dst, Register src) {
+    Emit(Instruction{.kind = kind, .dst = dst, .operands = {src}});
+  }
+
+  void Push(Entry entry) {
+    stack_.push_back(entry);
+    max_depth_ = std::max<int64_t>(max_depth_, stack_.size());
+  }
+
+  // Moves the value of the given stack position into its own register.
+  void Materialize(int64_t position);
+  void MaterializeAll();
+  void MaterializeSlotReferences(int64_t slot);
+
+  // Returns the register to use for the given position as an operand of a
+  // kEval instruction.
+  Register OperandRegister(int64_t position);
+
+  // Rearranges the top `sources.size()` stack values such that the value at
+  // offset `k` from the bottom of that range comes from offset `sources[k]`.
+  void Permute(absl::Span<const int64_t> sources, bool unformatted);
+
+  // Emits a kEval of the bytecode at `pc`, consuming `inputs` stack values and
+  // producing `results`.
+  absl::Status EmitEval(int64_t pc, int64_t inputs, int64_t results);
+
+  absl::Status EmitJump(int64_t pc, std::optional<Register> condition);
+  absl::Status PlaceLabel(int64_t pc);
+
+  const std::vector<Bytecode>& bytecodes_;
+  int64_t slot_count_ = 0;
+  std::vector<Register> constant_of_pc_;
+  std::vector<RegisterFunction::Constant> constants_;
+
+  std::vector<Entry> stack_;
+  // Whether the current position is unreachable, i.e., follows a jump or a
+  // failure.
+  bool dead_ = false;
+  absl::flat_hash_map<int64_t, Label> labels_;
+
+  int64_t max_depth_ = 0;
+  int64_t scratch_count_ = 0;
+  std::vector<Instruction> instructions_;
+};
+
+absl::Status Lowerer::AssignRegisters() {
+  int64_t max_slot = -1;
+  for (int64_t pc = 0; pc < bytecodes_.size(); ++pc) {
+    const Bytecode& bytecode = bytecodes_[pc];
+    switch (bytecode.op()) {
+      case Bytecode::Op::kLoad:
+      case Bytecode::Op::kStore: {
+        XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot, bytecode.slot_index());
+        max_slot = std::max(max_slot, slot.value());
+        break;
+      }
+      case Bytecode::Op::kMatchArm: {
+        XLS_ASSIGN_OR_RETURN(const Bytecode::MatchArmItem* item,
+                             bytecode.match_arm_item());
+        std::vector<int64_t> slots;
+        XLS_RETURN_IF_ERROR(CollectMatchArmSlots(*item, slots, slots));
+        for (int64_t slot : slots) {
+          max_slot = std::max(max_slot, slot);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  slot_count_ = max_slot + 1;
+
+  for (int64_t pc = 0; pc < bytecodes_.size(); ++pc) {
+    const Bytecode& bytecode = bytecodes_[pc];
+    if (bytecode.op() != Bytecode::Op::kLiteral) {
+      continue;
+    }
+    if (!bytecode.has_data() ||
+        !std::holds_alternative<InterpValue>(bytecode.data().value())) {
+      return CannotLower(pc, "literal without a value");
+    }
+    constant_of_pc_[pc] = slot_count_ + constants_.size();
+    constants_.push_back(RegisterFunction::Constant{
+        .reg = constant_of_pc_[pc],
+        .value = &std::get<InterpValue>(bytecode.data().value()),
+        .format = bytecode.format_descriptor().has_value()
+                      ? &bytecode.format_descriptor().value()
+                      : nullptr});
+  }
+  if (slot_count_ + constants_.size() >= kStackBase) {
+    return CannotLower(0, "too many slots and literals");
+  }
+  return absl::OkStatus();
+}
+
+void Lowerer::Materialize(int64_t position) {
+  Entry& entry = stack_[position];
+  Register reg = StackRegister(position);
+  if (entry.reg == reg) {
+    return;
+  }
+  EmitMove(entry.unformatted ? Kind::kMoveUnformatted : Kind::kMove, reg,
+           entry.reg);
+  entry = Entry{.reg = reg, .unformatted = false};
+}
+
+void Lowerer::MaterializeAll() {
+  for (int64_t i = 0; i < stack_.size(); ++i) {
+    Materialize(i);
+  }
+}
+
+void Lowerer::MaterializeSlotReferences(int64_t slot) {
+  for (int64_t i = 0; i < stack_.size(); ++i) {
+    if (stack_[i].reg == slot) {
+      Materialize(i);
+    }
+  }
+}
+
+Register Lowerer::OperandRegister(int64_t position) {
+  const Entry& entry = stack_[position];
+  if (entry.unformatted && IsFormattedConstant(entry.reg)) {
+    Materialize(position);
+  }
+  return stack_[position].reg;
+}
+
+void Lowerer::Permute(absl::Span<const int64_t> sources, bool unformatted) {
+  const int64_t base = stack_.size() - sources.size();
+  std::vector<Entry> old(stack_.begin() + base, stack_.end());
+  std::vector<Entry> result(sources.size());
+  // Values in stack registers which change position are copied to scratch
+  // registers first, since their destinations may hold values which are
+  // still to be moved.
+  std::vector<int64_t> moved;
+  int64_t scratch = 0;
+  for (int64_t k = 0; k < sources.size(); ++k) {
+    int64_t source = sources[k];
+    const Entry& entry = old[source];
+    if (entry.reg != StackRegister(base + source)) {
+      result[k] = Entry{.reg = entry.reg,
+                        .unformatted = entry.unformatted || unformatted};
+      continue;
+    }
+    if (source == k) {
+      if (unformatted) {
+        EmitMove(Kind::kMoveUnformatted, entry.reg, entry.reg);
+      }
+      result[k] = entry;
+      continue;
+    }
+    Register scratch_reg = kScratchBase + scratch++;
+    EmitMove(Kind::kMove, scratch_reg, entry.reg);
+    result[k] = Entry{.reg = scratch_reg, .unformatted = false};
+    moved.push_back(k);
+  }
+  for (int64_t k : moved) {
+    EmitMove(unformatted ? Kind::kMoveUnformatted : Kind::kMove,
+             StackRegister(base + k), result[k].reg);
+    result[k] = Entry{.reg = StackRegister(base + k), .unformatted = false};
+  }
+  scratch_count_ = std::max(scratch_count_, scratch);
+  std::copy(result.begin(), result.end(), stack_.begin() + base);
+}
+
+absl::Status Lowerer::EmitEval(int64_t pc, int64_t inputs, int64_t results) {
+  if (stack_.size() < inputs) {
+    return CannotLower(pc, "stack underflow");
+  }
+  const int64_t base = stack_.size() - inputs;
+  Instruction instruction{.kind = Kind::kEval,
+                          .dst = StackRegister(base),
+                          .result_count = results,
+                          .bytecode = &bytecodes_[pc],
+                          .pc = pc};
+  for (int64_t i = base; i < stack_.size(); ++i) {
+    instruction.operands.push_back(OperandRegister(i));
+  }
+  stack_.resize(base);
+  for (int64_t i = 0; i < results; ++i) {
+    Push(Entry{.reg = StackRegister(base + i), .unformatted = false});
+  }
+  Emit(std::move(instruction));
+  return absl::OkStatus();
+}
+
+absl::Status Lowerer::EmitJump(int64_t pc, std::optional<Register> condition) {
+  XLS_ASSIGN_OR_RETURN(Bytecode::JumpTarget offset,
+                       bytecodes_[pc].jump_target());
+  int64_t target = pc + offset.value();
+  if (target < 0 || target >= bytecodes_.size() ||
+      bytecodes_[target].op() != Bytecode::Op::kJumpDest) {
+    return CannotLower(pc, "jump target is not a jump_dest");
+  }
+  MaterializeAll();
+  Label& label = labels_[target];
+  if (target <= pc && label.instruction < 0) {
+    return CannotLower(pc, "backward jump to an unreachable label");
+  }
+  if (label.depth.has_value() && *label.depth != stack_.size()) {
+    return CannotLower(pc, "inconsistent stack depth at jump target");
+  }
+  label.depth = stack_.size();
+  Instruction jump{.kind = condition.has_value() ? Kind::kJumpIf : Kind::kJump,
+                   .target = label.instruction};
+  if (condition.has_value()) {
+    jump.operands.push_back(*condition);
+  }
+  if (label.instruction < 0) {
+    label.pending_jumps.push_back(instructions_.size());
+  }
+  Emit(std::move(jump));
+  return absl::OkStatus();
+}
+
+absl::Status Lowerer::PlaceLabel(int64_t pc) {
+  Label& label = labels_[pc];
+  if (dead_) {
+    if (!label.depth.has_value()) {
+      // Nothing jumps here (yet), so the code remains unreachable.
+      return absl::OkStatus();
+    }
+    // Values arriving from jumps are held in their own registers.
+    stack_.clear();
+    for (int64_t i = 0; i < *label.depth; ++i) {
+      Push(Entry{.reg = StackRegister(i), .unformatted = false});
+    }
+    dead_ = false;
+  } else {
+    if (label.depth.has_value() && *label.depth != stack_.size()) {
+      return CannotLower(pc, "inconsistent stack depth at jump_dest");
+    }
+    MaterializeAll();
+    label.depth = stack_.size();
+  }
+  label.instruction = instructions_.size();
+  for (int64_t jump : label.pending_jumps) {
+    instructions_[jump].target = label.instruction;
+  }
+  label.pending_jumps.clear();
+  return absl::OkStatus();
+}
+
+absl::Status Lowerer::LowerBytecode(int64_t& pc) {
+  const Bytecode& bytecode = bytecodes_[pc];
+  switch (bytecode.op()) {
+    case Bytecode::Op::kJumpDest:
+      return PlaceLabel(pc);
+    case Bytecode::Op::kLiteral:
+      Push(Entry{.reg = constant_of_pc_[pc], .unformatted = false});
+      return absl::OkStatus();
+    case Bytecode::Op::kLoad: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot, bytecode.slot_index());
+      Push(Entry{.reg = static_cast<Register>(slot.value()),
+                 .unformatted = false});
+      return absl::OkStatus();
+    }
+    case Bytecode::Op::kStore: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot, bytecode.slot_index());
+      if (stack_.empty()) {
+        return CannotLower(pc, "stack underflow");
+      }
+      Entry entry = stack_.back();
+      stack_.pop_back();
+      MaterializeSlotReferences(slot.value());
+      if (entry.reg != slot.value()) {
+        EmitMove(Kind::kMoveUnformatted, slot.value(), entry.reg);
+      }
+      return absl::OkStatus();
+    }
+    case Bytecode::Op::kPop:
+      if (stack_.empty()) {
+        return CannotLower(pc, "stack underflow");
+      }
+      stack_.pop_back();
+      return absl::OkStatus();
+    case Bytecode::Op::kDup: {
+      if (stack_.empty()) {
+        return CannotLower(pc, "stack underflow");
+      }
+      // The copy pushed by a dup has no format descriptor.
+      Entry entry = stack_.back();
+      Register top = StackRegister(stack_.size() - 1);
+      if (entry.reg == top) {
+        EmitMove(Kind::kMoveUnformatted, top + 1, top);
+        Push(Entry{.reg = top + 1, .unformatted = false});
+      } else {
+        Push(Entry{.reg = entry.reg, .unformatted = true});
+      }
+      return absl::OkStatus();
+    }
+    case Bytecode::Op::kSwap:
+      if (stack_.size() < 2) {
+        return CannotLower(pc, "stack underflow");
+      }
+      Permute({1, 0}, /*unformatted=*/false);
+      return absl::OkStatus();
+    case Bytecode::Op::kCreateTuple: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::NumElements count,
+                           bytecode.num_elements());
+      // A tuple which is immediately expanded, e.g., the (index, accumulator)
+      // tuple of a `for` loop, just reverses the order of its elements.
+      if (pc + 1 < bytecodes_.size() &&
+          bytecodes_[pc + 1].op() == Bytecode::Op::kExpandTuple) {
+        absl::StatusOr<Bytecode::NumElements> expanded =
+            bytecodes_[pc + 1].num_elements();
+        if (expanded.ok() && *expanded == count) {
+          if (stack_.size() < count.value()) {
+            return CannotLower(pc, "stack underflow");
+          }
+          std::vector<int64_t> sources(count.value());
+          for (int64_t k = 0; k < count.value(); ++k) {
+            sources[k] = count.value() - 1 - k;
+          }
+          Permute(sources, /*unformatted=*/true);
+          ++pc;
+          return absl::OkStatus();
+        }
+      }
+      return EmitEval(pc, count.value(), 1);
+    }
+    case Bytecode::Op::kCreateArray: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::NumElements count,
+                           bytecode.num_elements());
+      return EmitEval(pc, count.value(), 1);
+    }
+    case Bytecode::Op::kExpandTuple: {
+      if (!bytecode.has_data()) {
+        return CannotLower(pc, "expand_tuple of unknown arity");
+      }
+      XLS_ASSIGN_OR_RETURN(Bytecode::NumElements count,
+                           bytecode.num_elements());
+      return EmitEval(pc, 1, count.value());
+    }
+    case Bytecode::Op::kCall: {
+      // The callee is always a literal function value, whose parameter count
+      // gives the number of arguments on the stack.
+      if (stack_.empty() || !IsConstant(stack_.back().reg)) {
+        return CannotLower(pc, "call of a non-literal callee");
+      }
+      const InterpValue& callee =
+          *constants_[stack_.back().reg - slot_count_].value;
+      XLS_ASSIGN_OR_RETURN(const InterpValue::FnData* fn_data,
+                           callee.GetFunction());
+      int64_t arg_count;
+      if (std::holds_alternative<Builtin>(*fn_data)) {
+        XLS_ASSIGN_OR_RETURN(Bytecode::InvocationData invocation_data,
+                             bytecode.invocation_data());
+        arg_count = invocation_data.invocation()->args().size();
+      } else {
+        arg_count = std::get<InterpValue::UserFnData>(*fn_data)
+                        .function->params()
+                        .size();
+      }
+      return EmitEval(pc, arg_count + 1, 1);
+    }
+    case Bytecode::Op::kFail: {
+      XLS_ASSIGN_OR_RETURN(int64_t arg_count, TraceArgCount(bytecode));
+      XLS_RETURN_IF_ERROR(EmitEval(pc, arg_count, 0));
+      dead_ = true;
+      return absl::OkStatus();
+    }
+    case Bytecode::Op::kTraceFmt:
+    case Bytecode::Op::kTraceArg: {
+      XLS_ASSIGN_OR_RETURN(int64_t arg_count, TraceArgCount(bytecode));
+      return EmitEval(pc, arg_count, 1);
+    }
+    case Bytecode::Op::kJumpRel:
+      XLS_RETURN_IF_ERROR(EmitJump(pc, /*condition=*/std::nullopt));
+      dead_ = true;
+      return absl::OkStatus();
+    case Bytecode::Op::kJumpRelIf: {
+      if (stack_.empty()) {
+        return CannotLower(pc, "stack underflow");
+      }
+      Entry condition = stack_.back();
+      stack_.pop_back();
+      return EmitJump(pc, condition.reg);
+    }
+    case Bytecode::Op::kMatchArm: {
+      // The values of slots stored by the match must be captured first by any
+      // stack values referring to them.
+      XLS_ASSIGN_OR_RETURN(const Bytecode::MatchArmItem* item,
+                           bytecode.match_arm_item());
+      std::vector<int64_t> loads;
+      std::vector<int64_t> stores;
+      XLS_RETURN_IF_ERROR(CollectMatchArmSlots(*item, loads, stores));
+      for (int64_t slot : stores) {
+        MaterializeSlotReferences(slot);
+      }
+      return EmitEval(pc, 1, 1);
+    }
+    case Bytecode::Op::kCast:
+    case Bytecode::Op::kCheckedCast:
+    case Bytecode::Op::kDecode:
+    case Bytecode::Op::kInvert:
+    case Bytecode::Op::kNegate:
+      return EmitEval(pc, 1, 1);
+    case Bytecode::Op::kUAdd:
+    case Bytecode::Op::kSAdd:
+    case Bytecode::Op::kAnd:
+    case Bytecode::Op::kConcat:
+    case Bytecode::Op::kDiv:
+    case Bytecode::Op::kMod:
+    case Bytecode::Op::kEq:
+    case Bytecode::Op::kGe:
+    case Bytecode::Op::kGt:
+    case Bytecode::Op::kIndex:
+    case Bytecode::Op::kTupleIndex:
+    case Bytecode::Op::kLe:
+    case Bytecode::Op::kLogicalAnd:
+    case Bytecode::Op::kLogicalOr:
+    case Bytecode::Op::kLt:
+    case Bytecode::Op::kUMul:
+    case Bytecode::Op::kSMul:
+    case Bytecode::Op::kNe:
+    case Bytecode::Op::kOr:
+    case Bytecode::Op::kRange:
+    case Bytecode::Op::kShl:
+    case Bytecode::Op::kShr:
+    case Bytecode::Op::kUSub:
+    case Bytecode::Op::kSSub:
+    case Bytecode::Op::kWidthSlice:
+    case Bytecode::Op::kXor:
+      return EmitEval(pc, 2, 1);
+    case Bytecode::Op::kSlice:
+      return EmitEval(pc, 3, 1);
+    case Bytecode::Op::kRecv:
+    case Bytecode::Op::kRecvNonBlocking:
+    case Bytecode::Op::kSend:
+    case Bytecode::Op::kSpawn:
+      return CannotLower(pc, absl::StrCat(OpToString(bytecode.op()),
+                                          " is not supported"));
+  }
+  return CannotLower(pc, "unknown op");
+}
+
+absl::Status Lowerer::Lower() {
+  XLS_RETURN_IF_ERROR(AssignRegisters());
+  for (int64_t pc = 0; pc < bytecodes_.size(); ++pc) {
+    if (dead_ && bytecodes_[pc].op() != Bytecode::Op::kJumpDest) {
+      continue;
+    }
+    XLS_RETURN_IF_ERROR(LowerBytecode(pc));
+  }
+  if (dead_) {
+    return absl::OkStatus();
+  }
+  if (stack_.size() != 1) {
+    return CannotLower(bytecodes_.size(),
+                       "function does not leave a single value on the stack");
+  }
+  Emit(Instruction{.kind = Kind::kReturn, .operands = {OperandRegister(0)}});
+  return absl::OkStatus();
+}
+
+std::string InstructionToString(const Instruction& instruction) {
+  auto reg = [](Register r) { return absl::StrFormat("r%d", r); };
+  switch (instruction.kind) {
+    case Kind::kMove:
+      return absl::StrFormat("%s = %s", reg(instruction.dst),
+                             reg(instruction.operands[0]));
+    case Kind::kMoveUnformatted:
+      return absl::StrFormat("%s = unformatted %s", reg(instruction.dst),
+                             reg(instruction.operands[0]));
+    case Kind::kJump:
+      return absl::StrFormat("jump %03d", instruction.target);
+    case Kind::kJumpIf:
+      return absl::StrFormat("jump_if %s %03d", reg(instruction.operands[0]),
+                             instruction.target);
+    case Kind::kReturn:
+      return absl::StrFormat("return %s", reg(instruction.operands[0]));
+    case Kind::kEval:
+      break;
+  }
+  std::string results;
+  if (instruction.result_count == 1) {
+    results = absl::StrFormat("%s = ", reg(instruction.dst));
+  } else if (instruction.result_count > 1) {
+    results = absl::StrFormat(
+        "%s..%s = ", reg(instruction.dst),
+        reg(instruction.dst + instruction.result_count - 1));
+  }
+  std::string operands = absl::StrJoin(
+      instruction.operands, ", ",
+      [&](std::string* out, Register r) { absl::StrAppend(out, reg(r)); });
+  return absl::StrFormat("%s%s%s%s", results,
+                         OpToString(instruction.bytecode->op()),
+                         operands.empty() ? "" : " ", operands);
+}
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<RegisterFunction>>
+RegisterFunction::Lower(const BytecodeFunction& bf) {
+  Lowerer lowerer(bf);
+  XLS_RETURN_IF_ERROR(lowerer.Lower());
+
+  auto result = absl::WrapUnique(new RegisterFunction());
+  result->slot_count_ = lowerer.slot_count();
+  result->constants_ = std::move(lowerer.constants());
+  const int64_t stack_base = result->slot_count_ + result->constants_.size();
+  const int64_t scratch_base = stack_base + lowerer.max_depth();
+  result->register_count_ = scratch_base + lowerer.scratch_count();
+  auto renumber = [&](Register& r) {
+    if (r >= kScratchBase) {
+      r = scratch_base + (r - kScratchBase);
+    } else if (r >= kStackBase) {
+      r = stack_base + (r - kStackBase);
+    }
+  };
+  result->instructions_ = std::move(lowerer.instructions());
+  for (Instruction& instruction : result->instructions_) {
+    renumber(instruction.dst);
+    for (Register& operand : instruction.operands) {
+      renumber(operand);
+    }
+  }
+  return result;
+}
+
+std::string RegisterFunction::ToString() const {
+  std::vector<std::string> lines;
+  for (const Constant& constant : constants_) {
+    lines.push_back(
+        absl::StrFormat("r%d = %s", constant.reg, constant.value->ToString()));
+  }
+  for (int64_t i = 0; i < instructions_.size(); ++i) {
+    lines.push_back(
+        absl::StrFormat("%03d %s", i, InstructionToString(instructions_[i])));
+  }
+  return absl::StrJoin(lines, "\n");
+}
+
+}  // namespace xls::dslx
@@ -0,0 +1,115 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_BYTECODE_REGISTER_FUNCTION_H_
+#define XLS_DSLX_BYTECODE_REGISTER_FUNCTION_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/status/statusor.h"
+#include "xls/dslx/bytecode/bytecode.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/dslx/value_format_descriptor.h"
+
+namespace xls::dslx {
+
+// A register-based form of a BytecodeFunction.
+//
+// The stack machine bytecode moves every intermediate value through the
+// interpreter stack, and loads copy values out of the frame's slots. Lowering
+// simulates the stack at compile time instead, so that each stack position
+// becomes a register: loads, stores, literals, dups, swaps and pops turn into
+// register moves (and are mostly eliminated), and the remaining instructions
+// name their operand and result registers explicitly.
+//
+// Registers are laid out as the frame's slots, followed by one register per
+// literal, followed by the registers for stack positions and scratch
+// registers.
+//
+// The value of every stack position must be statically known at each
+// instruction, so functions whose stack depth depends on control flow or
+// which use channel operations (whose execution may block and be resumed
+// later) can't be lowered.
+class RegisterFunction {
+ public:
+  using Register = int32_t;
+
+  enum class Kind : uint8_t {
+    // Copies operand 0 to `dst`, including its format descriptor.
+    kMove,
+    // Copies operand 0 to `dst` without its format descriptor, as happens when
+    // a value is popped from the stack and stored.
+    kMoveUnformatted,
+    // Continues at instruction `target`.
+    kJump,
+    // Continues at instruction `target` if operand 0 is true.
+    kJumpIf,
+    // Evaluates `bytecode` with the given operands (deepest stack value first)
+    // and writes its `result_count` results to `dst`, `dst + 1`, etc. (deepest
+    // stack value first).
+    kEval,
+    // Returns operand 0 from the function.
+    kReturn,
+  };
+
+  struct Instruction {
+    Kind kind;
+    Register dst = 0;
+    int64_t result_count = 0;
+    int64_t target = 0;
+    // The bytecode evaluated by kEval instructions and its PC.
+    const Bytecode* bytecode = nullptr;
+    int64_t pc = 0;
+    absl::InlinedVector<Register, 3> operands;
+  };
+
+  // The register holding the value of a literal.
+  struct Constant {
+    Register reg;
+    const InterpValue* value;
+    const ValueFormatDescriptor* format;
+  };
+
+  // Lowers the given function, returning an UnimplementedError if it can't be
+  // lowered. The result refers to the bytecodes of `bf`, so must not outlive
+  // it.
+  static absl::StatusOr<std::unique_ptr<RegisterFunction>> Lower(
+      const BytecodeFunction& bf);
+
+  int64_t register_count() const { return register_count_; }
+  // The number of registers holding the slots of the frame, which come first.
+  int64_t slot_count() const { return slot_count_; }
+  const std::vector<Constant>& constants() const { return constants_; }
+  const std::vector<Instruction>& instructions() const {
+    return instructions_;
+  }
+
+  std::string ToString() const;
+
+ private:
+  RegisterFunction() = default;
+
+  int64_t register_count_ = 0;
+  int64_t slot_count_ = 0;
+  std::vector<Constant> constants_;
+  std::vector<Instruction> instructions_;
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_BYTECODE_REGISTER_FUNCTION_H_
@@ -0,0 +1,126 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/bytecode/register_function.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/bytecode/bytecode.h"
+#include "xls/dslx/frontend/pos.h"
+#include "xls/dslx/interp_value.h"
+
+namespace xls::dslx {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::testing::HasSubstr;
+
+const Span kFakeSpan = Span::Fake();
+
+absl::StatusOr<std::unique_ptr<BytecodeFunction>> MakeFunction(
+    std::vector<Bytecode> bytecodes) {
+  return BytecodeFunction::Create(/*owner=*/nullptr, /*source_fn=*/nullptr,
+                                  /*type_info=*/nullptr, std::move(bytecodes));
+}
+
+TEST(RegisterFunctionTest, StraightLine) {
+  std::vector<Bytecode> bytecodes;
+  bytecodes.push_back(Bytecode::MakeLoad(kFakeSpan, Bytecode::SlotIndex(0)));
+  bytecodes.push_back(Bytecode::MakeLoad(kFakeSpan, Bytecode::SlotIndex(1)));
+  bytecodes.push_back(Bytecode(kFakeSpan, Bytecode::Op::kUAdd));
+  bytecodes.push_back(
+      Bytecode::MakeLiteral(kFakeSpan, InterpValue::MakeU32(1)));
+  bytecodes.push_back(Bytecode(kFakeSpan, Bytecode::Op::kUAdd));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BytecodeFunction> bf,
+                           MakeFunction(std::move(bytecodes)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<RegisterFunction> rf,
+                           RegisterFunction::Lower(*bf));
+  EXPECT_EQ(rf->slot_count(), 2);
+  EXPECT_EQ(rf->register_count(), 5);
+  EXPECT_EQ(rf->ToString(), R"(r2 = u32:1
+000 r3 = uadd r0, r1
+001 r3 = uadd r3, r2
+002 return r3)");
+}
+
+TEST(RegisterFunctionTest, StackManipulationBecomesMoves) {
+  std::vector<Bytecode> bytecodes;
+  bytecodes.push_back(Bytecode::MakeLoad(kFakeSpan, Bytecode::SlotIndex(0)));
+  bytecodes.push_back(Bytecode::MakeDup(kFakeSpan));
+  bytecodes.push_back(Bytecode::MakeSwap(kFakeSpan));
+  bytecodes.push_back(Bytecode::MakeStore(kFakeSpan, Bytecode::SlotIndex(1)));
+  bytecodes.push_back(Bytecode::MakeLoad(kFakeSpan, Bytecode::SlotIndex(1)));
+  bytecodes.push_back(Bytecode(kFakeSpan, Bytecode::Op::kUAdd));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BytecodeFunction> bf,
+                           MakeFunction(std::move(bytecodes)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<RegisterFunction> rf,
+                           RegisterFunction::Lower(*bf));
+  EXPECT_EQ(rf->ToString(), R"(000 r1 = unformatted r0
+001 r2 = uadd r0, r1
+002 return r2)");
+}
+
+TEST(RegisterFunctionTest, JumpsMaterializeTheStack) {
+  // Equivalent to `if x { u32:2 } else { u32:1 }`.
+  std::vector<Bytecode> bytecodes;
+  bytecodes.push_back(Bytecode::MakeLoad(kFakeSpan, Bytecode::SlotIndex(0)));
+  bytecodes.push_back(
+      Bytecode::MakeJumpRelIf(kFakeSpan, Bytecode::JumpTarget(3)));
+  bytecodes.push_back(
+      Bytecode::MakeLiteral(kFakeSpan, InterpValue::MakeU32(1)));
+  bytecodes.push_back(
+      Bytecode::MakeJumpRel(kFakeSpan, Bytecode::JumpTarget(3)));
+  bytecodes.push_back(Bytecode::MakeJumpDest(kFakeSpan));
+  bytecodes.push_back(
+      Bytecode::MakeLiteral(kFakeSpan, InterpValue::MakeU32(2)));
+  bytecodes.push_back(Bytecode::MakeJumpDest(kFakeSpan));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BytecodeFunction> bf,
+                           MakeFunction(std::move(bytecodes)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<RegisterFunction> rf,
+                           RegisterFunction::Lower(*bf));
+  EXPECT_EQ(rf->ToString(), R"(r1 = u32:1
+r2 = u32:2
+000 jump_if r0 003
+001 r3 = r1
+002 jump 004
+003 r3 = r2
+004 return r3)");
+}
+
+TEST(RegisterFunctionTest, ExpandTupleOfUnknownArityIsNotLowered) {
+  std::vector<Bytecode> bytecodes;
+  bytecodes.push_back(Bytecode::MakeLoad(kFakeSpan, Bytecode::SlotIndex(0)));
+  bytecodes.push_back(Bytecode(kFakeSpan, Bytecode::Op::kExpandTuple));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BytecodeFunction> bf,
+                           MakeFunction(std::move(bytecodes)));
+
+  EXPECT_THAT(RegisterFunction::Lower(*bf),
+              StatusIs(absl::StatusCode::kUnimplemented,
+                       HasSubstr("expand_tuple of unknown arity")));
+  EXPECT_EQ(bf->GetRegisterFunction(), nullptr);
+}
+
+}  // namespace
+}  // namespace xls::dslx
@@ -0,0 +1,158 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/bytecode/register_value.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/ir/bits.h"
+
+namespace xls::dslx {
+namespace {
+
+bool FitsInline(const InterpValue& value) {
+  return value.IsBits() &&
+         value.GetBitsOrDie().bit_count() <= RegisterValue::kMaxInlineBitCount;
+}
+
+}  // namespace
+
+/* static */ RegisterValue RegisterValue::Borrow(const InterpValue& value) {
+  if (FitsInline(value)) {
+    const Bits& bits = value.GetBitsOrDie();
+    return MakeBits(value.IsSBits(), bits.bit_count(),
+                    bits.bit_count() == 0 ? 0 : bits.ToUint64().value());
+  }
+  RegisterValue result;
+  result.kind_ = Kind::kInterpValue;
+  result.interp_value_ = &value;
+  return result;
+}
+
+/* static */ RegisterValue RegisterValue::FromInterpValue(
+    InterpValue value, RegisterValueArena& arena) {
+  if (FitsInline(value)) {
+    return Borrow(value);
+  }
+  return Borrow(*arena.Box(std::move(value)));
+}
+
+int64_t RegisterValue::ElementCount() const {
+  switch (kind_) {
+    case Kind::kAggregate:
+      return size_;
+    case Kind::kInterpValue:
+      if (interp_value_->IsTuple() || interp_value_->IsArray()) {
+        return interp_value_->GetValuesOrDie().size();
+      }
+      return -1;
+    default:
+      return -1;
+  }
+}
+
+RegisterValue RegisterValue::Element(int64_t i) const {
+  DCHECK_GE(i, 0);
+  DCHECK_LT(i, ElementCount());
+  if (kind_ == Kind::kAggregate) {
+    return elements_[i];
+  }
+  return Borrow(interp_value_->GetValuesOrDie()[i]);
+}
+
+absl::StatusOr<InterpValue> RegisterValue::ToInterpValue() const {
+  switch (kind_) {
+    case Kind::kEmpty:
+      return absl::InternalError("Attempted to read an unwritten register.");
+    case Kind::kBits:
+      return InterpValue::MakeBits(IsSigned(), UBits(bits_, size_));
+    case Kind::kAggregate: {
+      std::vector<InterpValue> elements;
+      elements.reserve(size_);
+      for (int64_t i = 0; i < size_; ++i) {
+        XLS_ASSIGN_OR_RETURN(InterpValue element, elements_[i].ToInterpValue());
+        elements.push_back(std::move(element));
+      }
+      if (tag_ == InterpValueTag::kTuple) {
+        return InterpValue::MakeTuple(std::move(elements));
+      }
+      return InterpValue::MakeArray(std::move(elements));
+    }
+    case Kind::kInterpValue:
+      return *interp_value_;
+  }
+  return absl::InternalError("Invalid register value kind.");
+}
+
+std::string RegisterValue::ToString() const {
+  if (IsEmpty()) {
+    return "<empty>";
+  }
+  absl::StatusOr<InterpValue> value = ToInterpValue();
+  CHECK_OK(value.status());
+  return value->ToString();
+}
+
+absl::Span<RegisterValue> RegisterValueArena::AllocateElements(int64_t count) {
+  if (block_ < blocks_.size() && offset_ + count > blocks_[block_].size) {
+    ++block_;
+    offset_ = 0;
+  }
+  if (block_ == blocks_.size()) {
+    blocks_.push_back(Block{.values = nullptr, .size = 0});
+  }
+  Block& block = blocks_[block_];
+  if (block.size < count) {
+    // Unused blocks hold no live values so they can be replaced by a larger
+    // one.
+    int64_t size = std::max(count, kBlockSize);
+    block.values = std::make_unique<RegisterValue[]>(size);
+    block.size = size;
+  }
+  absl::Span<RegisterValue> result(block.values.get() + offset_, count);
+  offset_ += count;
+  return result;
+}
+
+void RegisterValueArena::Release(const Mark& mark) {
+  block_ = mark.block;
+  offset_ = mark.offset;
+  while (boxed_values_.size() > mark.boxed_values) {
+    boxed_values_.pop_back();
+  }
+  while (boxed_formats_.size() > mark.boxed_formats) {
+    boxed_formats_.pop_back();
+  }
+}
+
+int64_t RegisterValueArena::capacity() const {
+  int64_t result = 0;
+  for (const Block& block : blocks_) {
+    result += block.size;
+  }
+  return result;
+}
+
+}  // namespace xls::dslx
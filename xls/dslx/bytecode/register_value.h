@@ -0,0 +1,252 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_BYTECODE_REGISTER_VALUE_H_
+#define XLS_DSLX_BYTECODE_REGISTER_VALUE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/dslx/value_format_descriptor.h"
+
+namespace xls::dslx {
+
+class RegisterValueArena;
+
+// A value held in a register while executing a RegisterFunction.
+//
+// Register values are cheap to copy: bits values of up to 64 bits are held
+// inline, tuples and arrays built during execution point at elements allocated
+// in a RegisterValueArena, and all other values point at an InterpValue which
+// is either boxed in the arena or borrowed from storage which outlives the
+// execution (e.g., the literals of a BytecodeFunction).
+//
+// Register values are immutable, so aliasing between registers is safe.
+class RegisterValue {
+ public:
+  enum class Kind : uint8_t {
+    // A register which has not been written.
+    kEmpty,
+    // A UBits or SBits value of at most 64 bits.
+    kBits,
+    // A tuple or array whose elements are RegisterValues.
+    kAggregate,
+    // Any other value, held as a pointer to an InterpValue.
+    kInterpValue,
+  };
+
+  static constexpr int64_t kMaxInlineBitCount = 64;
+
+  RegisterValue() = default;
+
+  // Returns the mask of the low `bit_count` bits.
+  static uint64_t Mask(int64_t bit_count) {
+    return bit_count >= 64 ? ~uint64_t{0}
+                           : (uint64_t{1} << bit_count) - uint64_t{1};
+  }
+
+  // Creates a bits value; the bits of `value` above `bit_count` are dropped.
+  static RegisterValue MakeBits(bool is_signed, int64_t bit_count,
+                                uint64_t value) {
+    DCHECK_LE(bit_count, kMaxInlineBitCount);
+    RegisterValue result;
+    result.kind_ = Kind::kBits;
+    result.tag_ = is_signed ? InterpValueTag::kSBits : InterpValueTag::kUBits;
+    result.size_ = bit_count;
+    result.bits_ = value & Mask(bit_count);
+    return result;
+  }
+  static RegisterValue MakeBool(bool value) {
+    return MakeBits(/*is_signed=*/false, /*bit_count=*/1, value ? 1 : 0);
+  }
+
+  // Creates a tuple or array value (per `tag`) from elements which must remain
+  // valid for the lifetime of the value, e.g., storage allocated with
+  // RegisterValueArena::AllocateElements.
+  static RegisterValue MakeAggregate(InterpValueTag tag,
+                                     absl::Span<const RegisterValue> elements) {
+    DCHECK(tag == InterpValueTag::kTuple || tag == InterpValueTag::kArray);
+    RegisterValue result;
+    result.kind_ = Kind::kAggregate;
+    result.tag_ = tag;
+    result.size_ = elements.size();
+    result.elements_ = elements.data();
+    return result;
+  }
+
+  // Creates a register value referring to `value`, which must outlive the
+  // register value. Bits values which fit are copied inline instead.
+  static RegisterValue Borrow(const InterpValue& value);
+
+  // Creates a register value holding `value`, which is moved into the arena if
+  // it can't be held inline.
+  static RegisterValue FromInterpValue(InterpValue value,
+                                       RegisterValueArena& arena);
+
+  Kind kind() const { return kind_; }
+  bool IsEmpty() const { return kind_ == Kind::kEmpty; }
+  bool IsInlineBits() const { return kind_ == Kind::kBits; }
+  bool IsSigned() const { return tag_ == InterpValueTag::kSBits; }
+
+  // The tag of the value; must not be called on empty registers.
+  InterpValueTag tag() const {
+    DCHECK(kind_ != Kind::kEmpty);
+    return kind_ == Kind::kInterpValue ? interp_value_->tag() : tag_;
+  }
+
+  // Accessors for inline bits values.
+  int64_t bit_count() const {
+    DCHECK(IsInlineBits());
+    return size_;
+  }
+  uint64_t bits() const {
+    DCHECK(IsInlineBits());
+    return bits_;
+  }
+  // Returns the bits sign-extended from bit_count() to 64 bits.
+  int64_t SignedBits() const {
+    DCHECK(IsInlineBits());
+    if (size_ == 0) {
+      return 0;
+    }
+    int64_t shift = 64 - size_;
+    return static_cast<int64_t>(bits_ << shift) >> shift;
+  }
+
+  // Returns whether the value is a single set bit.
+  bool IsTrue() const {
+    switch (kind_) {
+      case Kind::kBits:
+        return size_ == 1 && bits_ == 1;
+      case Kind::kInterpValue:
+        return interp_value_->IsTrue();
+      default:
+        return false;
+    }
+  }
+
+  // For tuple or array values, returns the number of elements; otherwise
+  // returns -1.
+  int64_t ElementCount() const;
+
+  // Returns the `i`-th element of a tuple or array value. Elements of a value
+  // which refers to an InterpValue are borrowed from it.
+  RegisterValue Element(int64_t i) const;
+
+  // Returns the referenced InterpValue for kInterpValue registers.
+  const InterpValue& interp_value() const {
+    DCHECK(kind_ == Kind::kInterpValue);
+    return *interp_value_;
+  }
+
+  // Converts the value to an InterpValue, which copies it.
+  absl::StatusOr<InterpValue> ToInterpValue() const;
+
+  // The format of the literal the value originated from, if any. Nullptr if
+  // the value is unformatted.
+  const ValueFormatDescriptor* format() const { return format_; }
+  RegisterValue WithFormat(const ValueFormatDescriptor* format) const {
+    RegisterValue result = *this;
+    result.format_ = format;
+    return result;
+  }
+  RegisterValue WithoutFormat() const { return WithFormat(nullptr); }
+
+  std::string ToString() const;
+
+ private:
+  Kind kind_ = Kind::kEmpty;
+  InterpValueTag tag_ = InterpValueTag::kUBits;
+  // The bit count of inline bits or the element count of aggregates.
+  int64_t size_ = 0;
+  union {
+    uint64_t bits_ = 0;
+    const RegisterValue* elements_;
+    const InterpValue* interp_value_;
+  };
+  const ValueFormatDescriptor* format_ = nullptr;
+};
+
+// Storage for the aggregate elements and boxed InterpValues created while
+// executing register functions.
+//
+// Allocation is stack-like: callers take a Mark() before executing a function
+// and Release() it when the function returns, freeing everything allocated in
+// the meantime while keeping the underlying memory for reuse by later calls.
+class RegisterValueArena {
+ public:
+  struct Mark {
+    int64_t block;
+    int64_t offset;
+    int64_t boxed_values;
+    int64_t boxed_formats;
+  };
+
+  RegisterValueArena() = default;
+  RegisterValueArena(const RegisterValueArena&) = delete;
+  RegisterValueArena& operator=(const RegisterValueArena&) = delete;
+
+  // Returns storage for `count` (empty) values.
+  absl::Span<RegisterValue> AllocateElements(int64_t count);
+
+  // Takes ownership of the given value or format until released.
+  const InterpValue* Box(InterpValue value) {
+    return &boxed_values_.emplace_back(std::move(value));
+  }
+  const ValueFormatDescriptor* Box(ValueFormatDescriptor format) {
+    return &boxed_formats_.emplace_back(std::move(format));
+  }
+
+  Mark GetMark() const {
+    return Mark{.block = block_,
+                .offset = offset_,
+                .boxed_values = static_cast<int64_t>(boxed_values_.size()),
+                .boxed_formats = static_cast<int64_t>(boxed_formats_.size())};
+  }
+
+  // Frees everything allocated since `mark` was taken.
+  void Release(const Mark& mark);
+
+  // Total number of element slots held by the arena, allocated or not.
+  int64_t capacity() const;
+
+ private:
+  static constexpr int64_t kBlockSize = 1024;
+
+  struct Block {
+    std::unique_ptr<RegisterValue[]> values;
+    int64_t size;
+  };
+
+  std::vector<Block> blocks_;
+  // The block currently being allocated from and the offset of its first free
+  // element. Blocks after the current one are unused.
+  int64_t block_ = 0;
+  int64_t offset_ = 0;
+
+  std::deque<InterpValue> boxed_values_;
+  std::deque<ValueFormatDescriptor> boxed_formats_;
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_BYTECODE_REGISTER_VALUE_H_
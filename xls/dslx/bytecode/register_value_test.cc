@@ -0,0 +1,102 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/bytecode/register_value.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/types/span.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/interp_value.h"
+
+namespace xls::dslx {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+
+TEST(RegisterValueTest, InlineBits) {
+  RegisterValue value = RegisterValue::MakeBits(/*is_signed=*/true,
+                                                /*bit_count=*/4, 0xfe);
+  EXPECT_TRUE(value.IsInlineBits());
+  EXPECT_TRUE(value.IsSigned());
+  EXPECT_EQ(value.bits(), 0xe);
+  EXPECT_EQ(value.SignedBits(), -2);
+  EXPECT_THAT(value.ToInterpValue(),
+              IsOkAndHolds(InterpValue::MakeSBits(4, -2)));
+
+  EXPECT_TRUE(RegisterValue::MakeBool(true).IsTrue());
+  EXPECT_FALSE(RegisterValue::MakeBool(false).IsTrue());
+}
+
+TEST(RegisterValueTest, BorrowWideValue) {
+  InterpValue wide = InterpValue::MakeUBits(128, 7);
+  RegisterValue value = RegisterValue::Borrow(wide);
+  EXPECT_EQ(value.kind(), RegisterValue::Kind::kInterpValue);
+  EXPECT_EQ(&value.interp_value(), &wide);
+
+  RegisterValue narrow = RegisterValue::Borrow(InterpValue::MakeU32(7));
+  EXPECT_TRUE(narrow.IsInlineBits());
+  EXPECT_EQ(narrow.bit_count(), 32);
+}
+
+TEST(RegisterValueTest, AggregateRoundTrip) {
+  RegisterValueArena arena;
+  absl::Span<RegisterValue> elements = arena.AllocateElements(2);
+  elements[0] = RegisterValue::MakeBits(/*is_signed=*/false, 8, 1);
+  elements[1] = RegisterValue::FromInterpValue(
+      InterpValue::MakeArray({InterpValue::MakeU32(2)}).value(), arena);
+  RegisterValue tuple =
+      RegisterValue::MakeAggregate(InterpValueTag::kTuple, elements);
+
+  EXPECT_EQ(tuple.ElementCount(), 2);
+  EXPECT_EQ(tuple.Element(0).bits(), 1);
+  EXPECT_EQ(tuple.Element(1).ElementCount(), 1);
+  EXPECT_EQ(tuple.Element(1).Element(0).bits(), 2);
+  EXPECT_THAT(tuple.ToInterpValue(),
+              IsOkAndHolds(InterpValue::MakeTuple(
+                  {InterpValue::MakeU8(1),
+                   InterpValue::MakeArray({InterpValue::MakeU32(2)})
+                       .value()})));
+}
+
+TEST(RegisterValueTest, EmptyRegister) {
+  RegisterValue value;
+  EXPECT_TRUE(value.IsEmpty());
+  EXPECT_EQ(value.ElementCount(), -1);
+  EXPECT_THAT(value.ToInterpValue(), StatusIs(absl::StatusCode::kInternal));
+}
+
+TEST(RegisterValueTest, ArenaReleaseReusesStorage) {
+  RegisterValueArena arena;
+  RegisterValueArena::Mark mark = arena.GetMark();
+  absl::Span<RegisterValue> first = arena.AllocateElements(3);
+  arena.Box(InterpValue::MakeUBits(100, 1));
+  const int64_t capacity = arena.capacity();
+
+  arena.Release(mark);
+  absl::Span<RegisterValue> second = arena.AllocateElements(3);
+  EXPECT_EQ(first.data(), second.data());
+  EXPECT_EQ(arena.capacity(), capacity);
+
+  // Allocations larger than a block get a block of their own.
+  absl::Span<RegisterValue> large = arena.AllocateElements(5000);
+  EXPECT_EQ(large.size(), 5000);
+  EXPECT_NE(large.data(), second.data() + 3);
+}
+
+}  // namespace
+}  // namespace xls::dslx
@@ -66,6 +66,9 @@ ABSL_FLAG(std::string, compare, "none",
 ABSL_FLAG(
     int64_t, seed, 0,
     "Seed for quickcheck random stimulus; 0 for an nondetermistic value.");
+ABSL_FLAG(int64_t, quickcheck_workers, 1,
+          "Number of threads to run quickcheck samples on; 0 uses all "
+          "available CPUs. Only applies when comparing against the JIT.");
 ABSL_FLAG(std::string, test_filter, "",
           "Regexp that must be a full match of test name(s) to run.");
 
@@ -82,6 +85,9 @@ ABSL_FLAG(bool, warnings_as_errors, true,
 ABSL_FLAG(bool, trace_channels, false,
           "If true, values sent and received on channels are emitted as trace "
           "messages");
+ABSL_FLAG(bool, register_lowering, false,
+          "If true, the bytecode interpreter runs functions in a register-based "
+          "form where possible rather than on its stack machine");
 ABSL_FLAG(int64_t, max_ticks, 100000,
           "If non-zero, the maximum number of ticks to execute on any proc. If "
           "exceeded an error is returned.");
@@ -140,8 +146,9 @@ absl::StatusOr<TestResult> RealMain(
     const std::filesystem::path& dslx_stdlib_path,
     const std::optional<std::string>& test_filter,
     FormatPreference format_preference, CompareFlag compare_flag, bool execute,
-    bool warnings_as_errors, std::optional<int64_t> seed, bool trace_channels,
-    std::optional<int64_t> max_ticks,
+    bool warnings_as_errors, std::optional<int64_t> seed,
+    int64_t quickcheck_workers, bool trace_channels,
+    std::optional<int64_t> max_ticks, bool register_lowering,
     std::optional<std::string_view> xml_output_file, EvaluatorType evaluator) {
   XLS_ASSIGN_OR_RETURN(
       WarningKindSet warnings,
@@ -187,10 +194,12 @@ absl::StatusOr<TestResult> RealMain(
                                  .run_comparator = run_comparator.get(),
                                  .execute = execute,
                                  .seed = seed,
+                                 .quickcheck_workers = quickcheck_workers,
                                  .warnings_as_errors = warnings_as_errors,
                                  .warnings = warnings,
                                  .trace_channels = trace_channels,
-                                 .max_ticks = max_ticks};
+                                 .max_ticks = max_ticks,
+                                 .register_lowering = register_lowering};
 
   std::unique_ptr<AbstractTestRunner> test_runner = GetTestRunner(evaluator);
   XLS_ASSIGN_OR_RETURN(TestResultData test_result,
@@ -231,6 +240,9 @@ int main(int argc, char* argv[]) {
   bool execute = absl::GetFlag(FLAGS_execute);
   bool warnings_as_errors = absl::GetFlag(FLAGS_warnings_as_errors);
   bool trace_channels = absl::GetFlag(FLAGS_trace_channels);
+  bool register_lowering = absl::GetFlag(FLAGS_register_lowering);
+  int64_t quickcheck_workers = absl::GetFlag(FLAGS_quickcheck_workers);
+  QCHECK(quickcheck_workers >= 0) << "--quickcheck_workers must be >= 0";
   std::optional<int64_t> max_ticks =
       absl::GetFlag(FLAGS_max_ticks) == 0
           ? std::nullopt
@@ -311,8 +323,9 @@ int main(int argc, char* argv[]) {
 
   absl::StatusOr<xls::dslx::TestResult> test_result = xls::dslx::RealMain(
       args[0], dslx_paths, dslx_stdlib_path, test_filter, preference,
-      compare_flag, execute, warnings_as_errors, seed, trace_channels,
-      max_ticks, xml_output_file, evaluator.value());
+      compare_flag, execute, warnings_as_errors, seed, quickcheck_workers,
+      trace_channels, max_ticks, register_lowering, xml_output_file,
+      evaluator.value());
   if (!test_result.ok()) {
     return xls::ExitStatus(test_result.status());
   }
@@ -15,9 +15,11 @@
 #ifndef XLS_DSLX_IR_CONVERT_CONVERSION_INFO_H_
 #define XLS_DSLX_IR_CONVERT_CONVERSION_INFO_H_
 
+#include <filesystem>  // NOLINT
 #include <memory>
 #include <string>
 
+#include "absl/container/flat_hash_map.h"
 #include "xls/ir/package.h"
 #include "xls/ir/xls_ir_interface.pb.h"
 
@@ -29,6 +31,10 @@ struct PackageConversionData {
   std::unique_ptr<Package> package;
   // Any extern type/interface information
   PackageInterfaceProto interface;
+  // The DSLX modules the package was converted from, including all
+  // transitively imported modules, mapped from their paths to the contents
+  // they were parsed from. Only populated by ConvertFilesToPackage.
+  absl::flat_hash_map<std::filesystem::path, std::string> module_contents;
 
   std::string DumpIr() const { return package->DumpIr(); }
 };
@@ -590,9 +590,13 @@ absl::StatusOr<PackageConversionData> ConvertFilesToPackage(
         "path to know where to resolve the entry function");
   }
   for (std::string_view path : paths) {
-    ImportData import_data(
-        CreateImportData(stdlib_path, dslx_paths, convert_options.warnings,
-                         std::make_unique<RealFilesystem>()));
+    // All input paths share one record of the files read, so a module imported
+    // by several of them is parsed from the same contents each time.
+    ImportData import_data(CreateImportData(
+        stdlib_path, dslx_paths, convert_options.warnings,
+        std::make_unique<RecordingFilesystem>(
+            std::make_unique<RealFilesystem>(),
+            &conversion_data.module_contents)));
     XLS_ASSIGN_OR_RETURN(std::string text,
                          import_data.vfs().GetFileContents(path));
     XLS_ASSIGN_OR_RETURN(std::string module_name, PathToName(path));
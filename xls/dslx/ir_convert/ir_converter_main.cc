@@ -18,11 +18,13 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "absl/types/span.h"
@@ -37,9 +39,11 @@
 #include "xls/dslx/ir_convert/ir_converter.h"
 #include "xls/dslx/ir_convert/ir_converter_options_flags.h"
 #include "xls/dslx/ir_convert/ir_converter_options_flags.pb.h"
+#include "xls/dslx/persistent_module_cache.h"
 #include "xls/dslx/warning_kind.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/package.h"
+#include "xls/ir/xls_ir_interface.pb.h"
 
 namespace xls::dslx {
 namespace {
@@ -129,25 +133,65 @@ absl::Status RealMain(absl::Span<const std::string_view> paths) {
            "input path to know where to resolve the entry function)";
   }
 
+  // Results are only cached when warnings are errors: a successful conversion
+  // then printed nothing, so a cache hit is indistinguishable from a fresh run.
+  PersistentModuleCache* cache = PersistentModuleCache::GetDefault();
+  std::optional<std::string> cache_key;
+  if (cache != nullptr && warnings_as_errors) {
+    IrConverterOptionsFlagsProto key_options = ir_converter_options;
+    key_options.clear_output_file();
+    key_options.clear_interface_proto_file();
+    key_options.clear_interface_textproto_file();
+    std::vector<std::filesystem::path> inputs(paths.begin(), paths.end());
+    absl::StatusOr<std::string> key = PersistentModuleCache::MakeKey(
+        "ir_convert", key_options.SerializeAsString(), inputs);
+    if (key.ok()) {
+      cache_key = *std::move(key);
+    } else {
+      VLOG(1) << "Not caching IR conversion results: " << key.status();
+    }
+  }
+  std::optional<std::vector<std::string>> cached;
+  if (cache_key.has_value()) {
+    cached = cache->Lookup(*cache_key);
+  }
+
   bool printed_error = false;
-  XLS_ASSIGN_OR_RETURN(PackageConversionData result,
-                       ConvertFilesToPackage(
-                           paths, dslx_stdlib_path, dslx_paths, convert_options,
-                           /*top=*/top,
-                           /*package_name=*/package_name, &printed_error));
+  std::string ir;
+  PackageInterfaceProto interface;
+  if (cached.has_value() && cached->size() == 2 &&
+      interface.ParseFromString(cached->at(1))) {
+    ir = std::move(cached->at(0));
+  } else {
+    XLS_ASSIGN_OR_RETURN(
+        PackageConversionData result,
+        ConvertFilesToPackage(paths, dslx_stdlib_path, dslx_paths,
+                              convert_options,
+                              /*top=*/top,
+                              /*package_name=*/package_name, &printed_error));
+    ir = result.DumpIr();
+    interface = std::move(result.interface);
+    if (cache_key.has_value() && !printed_error) {
+      absl::Status status = cache->Store(*cache_key, result.module_contents,
+                                         {ir, interface.SerializeAsString()});
+      if (!status.ok()) {
+        LOG(WARNING) << "Unable to cache IR conversion results: " << status;
+      }
+    }
+  }
   if (output_file) {
-    XLS_RETURN_IF_ERROR(SetFileContents(*output_file, result.DumpIr()));
+    XLS_RETURN_IF_ERROR(SetFileContents(*output_file, ir));
   } else {
-    std::cout << result.package->DumpIr();
+    std::cout << ir;
   }
   if (ir_converter_options.has_interface_proto_file()) {
     XLS_RETURN_IF_ERROR(
         SetFileContents(ir_converter_options.interface_proto_file(),
-                        result.interface.SerializeAsString()));
+                        interface.SerializeAsString()));
   }
   if (ir_converter_options.has_interface_textproto_file()) {
     std::string res;
-    XLS_RET_CHECK(google::protobuf::TextFormat::PrintToString(result.interface, &res));
+    XLS_RET_CHECK(google::protobuf::TextFormat::PrintToString(interface, &res));
     XLS_RETURN_IF_ERROR(
         SetFileContents(ir_converter_options.interface_textproto_file(), res));
   }
@@ -0,0 +1,273 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/persistent_module_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "openssl/sha.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/lru_file_cache.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls::dslx {
+namespace {
+
+constexpr std::string_view kKeyPrefix = "dslx_";
+constexpr std::string_view kEntrySuffix = ".xlsdslx";
+
+// Entries start with this magic string followed by the number of recorded
+// modules and the path and content digest of each, then the number of
+// artifacts and the size and contents of each. Sizes are 64-bit host-endian
+// integers.
+constexpr std::string_view kEntryMagic = "XLSDSLX1";
+
+std::string Digest(std::string_view data) {
+  std::string digest(SHA256_DIGEST_LENGTH, '\0');
+  SHA256(reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+         reinterpret_cast<uint8_t*>(digest.data()));
+  return digest;
+}
+
+// Appends a length-prefixed string to the key material so that adjacent
+// fields can never run into each other.
+void AppendKeyField(std::string_view field, std::string& out) {
+  absl::StrAppend(&out, field.size(), ":", field, ";");
+}
+
+void AppendString(std::string_view str, std::string& out) {
+  LruFileCache::AppendUint64(str.size(), out);
+  out.append(str);
+}
+
+bool ReadString(std::string_view& in, std::string_view& str) {
+  uint64_t size;
+  if (!LruFileCache::ReadUint64(in, size) || size > in.size()) {
+    return false;
+  }
+  str = in.substr(0, size);
+  in.remove_prefix(size);
+  return true;
+}
+
+// Identifies the running binary by its path, size and modification time.
+std::string ToolIdentity() {
+  std::error_code ec;
+  std::filesystem::path exe =
+      std::filesystem::read_symlink("/proc/self/exe", ec);
+  if (ec) {
+    return "unknown";
+  }
+  uintmax_t size = std::filesystem::file_size(exe, ec);
+  std::filesystem::file_time_type mtime =
+      std::filesystem::last_write_time(exe, ec);
+  return absl::StrCat(exe.string(), ":", size, ":",
+                      mtime.time_since_epoch().count());
+}
+
+struct ParsedEntry {
+  std::vector<std::pair<std::string_view, std::string_view>> modules;
+  std::vector<std::string> artifacts;
+};
+
+// Parses an entry, returning std::nullopt if it is malformed.
+std::optional<ParsedEntry> ParseEntry(std::string_view contents) {
+  if (!absl::StartsWith(contents, kEntryMagic)) {
+    return std::nullopt;
+  }
+  contents.remove_prefix(kEntryMagic.size());
+  ParsedEntry entry;
+  uint64_t module_count;
+  if (!LruFileCache::ReadUint64(contents, module_count)) {
+    return std::nullopt;
+  }
+  for (uint64_t i = 0; i < module_count; ++i) {
+    std::string_view path;
+    std::string_view digest;
+    if (!ReadString(contents, path) || !ReadString(contents, digest)) {
+      return std::nullopt;
+    }
+    entry.modules.push_back({path, digest});
+  }
+  uint64_t artifact_count;
+  if (!LruFileCache::ReadUint64(contents, artifact_count)) {
+    return std::nullopt;
+  }
+  for (uint64_t i = 0; i < artifact_count; ++i) {
+    std::string_view artifact;
+    if (!ReadString(contents, artifact)) {
+      return std::nullopt;
+    }
+    entry.artifacts.push_back(std::string(artifact));
+  }
+  if (!contents.empty()) {
+    return std::nullopt;
+  }
+  return entry;
+}
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<PersistentModuleCache>>
+PersistentModuleCache::Create(const std::filesystem::path& directory,
+                              int64_t max_bytes) {
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<LruFileCache> files,
+      LruFileCache::Create(directory, kEntrySuffix, max_bytes));
+  return absl::WrapUnique(new PersistentModuleCache(std::move(files)));
+}
+
+/* static */ PersistentModuleCache* PersistentModuleCache::GetDefault() {
+  static PersistentModuleCache* const cache = []() -> PersistentModuleCache* {
+    const char* directory = std::getenv("XLS_DSLX_CACHE_DIR");
+    if (directory == nullptr || directory[0] == '\0') {
+      return nullptr;
+    }
+    int64_t max_bytes = kDefaultMaxBytes;
+    if (const char* max_bytes_str = std::getenv("XLS_DSLX_CACHE_MAX_BYTES");
+        max_bytes_str != nullptr &&
+        !absl::SimpleAtoi(max_bytes_str, &max_bytes)) {
+      LOG(WARNING) << "Ignoring invalid XLS_DSLX_CACHE_MAX_BYTES value: "
+                   << max_bytes_str;
+      max_bytes = kDefaultMaxBytes;
+    }
+    absl::StatusOr<std::unique_ptr<PersistentModuleCache>> cache =
+        Create(directory, max_bytes);
+    if (!cache.ok()) {
+      LOG(WARNING) << "Unable to create DSLX module cache in " << directory
+                   << ": " << cache.status();
+      return nullptr;
+    }
+    return cache->release();
+  }();
+  return cache;
+}
+
+/* static */ absl::StatusOr<std::string> PersistentModuleCache::MakeKey(
+    std::string_view action, std::string_view options,
+    absl::Span<const std::filesystem::path> inputs) {
+  static const std::string* const tool_identity =
+      new std::string(ToolIdentity());
+  std::string key_material;
+  AppendKeyField(*tool_identity, key_material);
+  AppendKeyField(action, key_material);
+  AppendKeyField(options, key_material);
+  for (const std::filesystem::path& input : inputs) {
+    if (!std::filesystem::is_regular_file(input)) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Cannot cache results for %s: not a regular file", input.string()));
+    }
+    XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(input));
+    AppendKeyField(input.string(), key_material);
+    AppendKeyField(Digest(contents), key_material);
+  }
+  return absl::StrCat(kKeyPrefix,
+                      absl::BytesToHexString(Digest(key_material)));
+}
+
+std::optional<std::vector<std::string>> PersistentModuleCache::Read(
+    std::string_view key) {
+  std::optional<std::string> contents = files_->Read(key);
+  if (!contents.has_value()) {
+    return std::nullopt;
+  }
+  std::optional<ParsedEntry> entry = ParseEntry(*contents);
+  if (!entry.has_value()) {
+    LOG(WARNING) << "Removing malformed DSLX module cache entry "
+                 << files_->EntryPath(key);
+    files_->Remove(key);
+    return std::nullopt;
+  }
+  for (const auto& [module_path, digest] : entry->modules) {
+    absl::StatusOr<std::string> module_contents =
+        GetFileContents(std::filesystem::path(module_path));
+    if (!module_contents.ok() || Digest(*module_contents) != digest) {
+      VLOG(1) << "DSLX module cache entry " << key << " is stale: "
+              << module_path << " changed";
+      return std::nullopt;
+    }
+  }
+  files_->Touch(key);
+  return std::move(entry->artifacts);
+}
+
+std::optional<std::vector<std::string>> PersistentModuleCache::Lookup(
+    std::string_view key) {
+  std::optional<std::vector<std::string>> artifacts = Read(key);
+  absl::MutexLock lock(&mutex_);
+  if (artifacts.has_value()) {
+    ++stats_.hits;
+  } else {
+    ++stats_.misses;
+  }
+  return artifacts;
+}
+
+absl::Status PersistentModuleCache::Store(
+    std::string_view key,
+    const absl::flat_hash_map<std::filesystem::path, std::string>& modules,
+    absl::Span<const std::string> artifacts) {
+  std::vector<std::filesystem::path> paths;
+  paths.reserve(modules.size());
+  for (const auto& [path, module_contents] : modules) {
+    paths.push_back(path);
+  }
+  std::sort(paths.begin(), paths.end());
+
+  std::string contents(kEntryMagic);
+  LruFileCache::AppendUint64(modules.size(), contents);
+  for (const std::filesystem::path& path : paths) {
+    AppendString(path.string(), contents);
+    AppendString(Digest(modules.at(path)), contents);
+  }
+  LruFileCache::AppendUint64(artifacts.size(), contents);
+  for (const std::string& artifact : artifacts) {
+    AppendString(artifact, contents);
+  }
+  XLS_RETURN_IF_ERROR(files_->Write(key, contents));
+  absl::MutexLock lock(&mutex_);
+  ++stats_.stores;
+  return absl::OkStatus();
+}
+
+PersistentModuleCacheStats PersistentModuleCache::stats() const {
+  absl::MutexLock lock(&mutex_);
+  PersistentModuleCacheStats stats = stats_;
+  stats.evictions = files_->evictions();
+  return stats;
+}
+
+}  // namespace xls::dslx
@@ -0,0 +1,121 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_PERSISTENT_MODULE_CACHE_H_
+#define XLS_DSLX_PERSISTENT_MODULE_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xls/common/file/lru_file_cache.h"
+
+namespace xls::dslx {
+
+struct PersistentModuleCacheStats {
+  // Number of lookups which found, or didn't find, a valid entry.
+  int64_t hits = 0;
+  int64_t misses = 0;
+  // Number of entries written to the cache.
+  int64_t stores = 0;
+  // Number of entries removed to keep the cache within its size bound.
+  int64_t evictions = 0;
+};
+
+// A cache of the artifacts tools derive from parsed and typechecked DSLX
+// modules (e.g. converted IR or serialized type information), stored as files
+// in a directory so that it persists across processes.
+//
+// Entries are keyed (see MakeKey) by the tool action, its options, and the
+// paths and contents of the input modules. Each entry additionally records the
+// content hash of every module in the transitive import graph, including the
+// standard library, and is only used if all of those still match, so editing
+// an imported module invalidates the entries of its importers.
+//
+// Import resolution is assumed to depend only on the search paths, which
+// belong in the options; adding a module which shadows a previously resolved
+// import is not detected.
+//
+// The cache may be shared between threads and between processes, and is kept
+// within its size bound by removing the least recently used entries (see
+// LruFileCache). Unreadable or corrupt entries are treated as misses.
+class PersistentModuleCache {
+ public:
+  static constexpr int64_t kDefaultMaxBytes = int64_t{1} << 30;
+
+  static absl::StatusOr<std::unique_ptr<PersistentModuleCache>> Create(
+      const std::filesystem::path& directory,
+      int64_t max_bytes = kDefaultMaxBytes);
+
+  // Returns the process-wide cache configured by the XLS_DSLX_CACHE_DIR (and
+  // optionally XLS_DSLX_CACHE_MAX_BYTES) environment variables, or nullptr if
+  // no cache is configured.
+  static PersistentModuleCache* GetDefault();
+
+  // Returns the key for the result of applying `action` with the given
+  // options to the given input modules. The key also covers the identity of
+  // the running binary, so results of a rebuilt tool are never reused.
+  //
+  // Returns an error if an input is not a regular file (e.g. /dev/stdin),
+  // since its contents cannot be checked again later.
+  static absl::StatusOr<std::string> MakeKey(
+      std::string_view action, std::string_view options,
+      absl::Span<const std::filesystem::path> inputs);
+
+  // Returns the artifacts of the entry with the given key, or std::nullopt if
+  // there is no valid entry or one of its recorded modules has changed.
+  std::optional<std::vector<std::string>> Lookup(std::string_view key);
+
+  // Stores the given artifacts as the entry with the given key. `modules` maps
+  // the path of every module the artifacts were derived from to the contents
+  // they were derived from (see RecordingFilesystem), which must be the
+  // contents later lookups find for the entry to be used.
+  absl::Status Store(
+      std::string_view key,
+      const absl::flat_hash_map<std::filesystem::path, std::string>& modules,
+      absl::Span<const std::string> artifacts);
+
+  PersistentModuleCacheStats stats() const;
+
+  const std::filesystem::path& directory() const {
+    return files_->directory();
+  }
+  int64_t max_bytes() const { return files_->max_bytes(); }
+
+ private:
+  explicit PersistentModuleCache(std::unique_ptr<LruFileCache> files)
+      : files_(std::move(files)) {}
+
+  std::optional<std::vector<std::string>> Read(std::string_view key);
+
+  const std::unique_ptr<LruFileCache> files_;
+
+  mutable absl::Mutex mutex_;
+  PersistentModuleCacheStats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_PERSISTENT_MODULE_CACHE_H_
@@ -0,0 +1,220 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/persistent_module_cache.h"
+
+#include <chrono>  // NOLINT
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/virtualizable_file_system.h"
+
+namespace xls::dslx {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::testing::ElementsAre;
+using ::testing::Ne;
+using ::testing::Optional;
+
+class PersistentModuleCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    XLS_ASSERT_OK_AND_ASSIGN(temp_dir_, TempDirectory::Create());
+    XLS_ASSERT_OK_AND_ASSIGN(
+        cache_, PersistentModuleCache::Create(temp_dir_->path() / "cache"));
+  }
+
+  std::filesystem::path WriteModule(std::string_view name,
+                                    std::string_view contents) {
+    std::filesystem::path path = temp_dir_->path() / name;
+    CHECK_OK(SetFileContents(path, contents));
+    return path;
+  }
+
+  // Reads the given modules as a tool would, returning the contents to record.
+  absl::flat_hash_map<std::filesystem::path, std::string> ReadModules(
+      absl::Span<const std::filesystem::path> paths) {
+    absl::flat_hash_map<std::filesystem::path, std::string> modules;
+    RecordingFilesystem vfs(std::make_unique<RealFilesystem>(), &modules);
+    for (const std::filesystem::path& path : paths) {
+      CHECK_OK(vfs.GetFileContents(path).status());
+    }
+    return modules;
+  }
+
+  std::optional<TempDirectory> temp_dir_;
+  std::unique_ptr<PersistentModuleCache> cache_;
+};
+
+TEST_F(PersistentModuleCacheTest, MakeKey) {
+  std::filesystem::path a = WriteModule("a.x", "fn f() {}");
+  std::filesystem::path b = WriteModule("b.x", "fn g() {}");
+  XLS_ASSERT_OK_AND_ASSIGN(std::string key,
+                           PersistentModuleCache::MakeKey("act", "opt", {a}));
+  EXPECT_THAT(PersistentModuleCache::MakeKey("act", "opt", {a}),
+              IsOkAndHolds(key));
+  EXPECT_THAT(PersistentModuleCache::MakeKey("act", "opt2", {a}),
+              IsOkAndHolds(Ne(key)));
+  EXPECT_THAT(PersistentModuleCache::MakeKey("act2", "opt", {a}),
+              IsOkAndHolds(Ne(key)));
+  EXPECT_THAT(PersistentModuleCache::MakeKey("act", "opt", {b}),
+              IsOkAndHolds(Ne(key)));
+
+  // The key depends on the contents of the inputs.
+  WriteModule("a.x", "fn f() { () }");
+  EXPECT_THAT(PersistentModuleCache::MakeKey("act", "opt", {a}),
+              IsOkAndHolds(Ne(key)));
+
+  EXPECT_FALSE(PersistentModuleCache::MakeKey("act", "opt",
+                                              {temp_dir_->path() / "missing.x"})
+                   .ok());
+}
+
+TEST_F(PersistentModuleCacheTest, StoreAndLookup) {
+  std::filesystem::path a = WriteModule("a.x", "import b;");
+  std::filesystem::path b = WriteModule("b.x", "fn g() {}");
+  XLS_ASSERT_OK_AND_ASSIGN(std::string key,
+                           PersistentModuleCache::MakeKey("act", "opt", {a}));
+  EXPECT_EQ(cache_->Lookup(key), std::nullopt);
+
+  XLS_ASSERT_OK(
+      cache_->Store(key, ReadModules({a, b}),
+                    {"first", std::string("\0second", 7)}));
+  EXPECT_THAT(cache_->Lookup(key),
+              Optional(ElementsAre("first", std::string("\0second", 7))));
+
+  PersistentModuleCacheStats stats = cache_->stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.stores, 1);
+  EXPECT_EQ(stats.evictions, 0);
+}
+
+TEST_F(PersistentModuleCacheTest, ChangedImportIsAMiss) {
+  std::filesystem::path a = WriteModule("a.x", "import b;");
+  std::filesystem::path b = WriteModule("b.x", "fn g() {}");
+  XLS_ASSERT_OK_AND_ASSIGN(std::string key,
+                           PersistentModuleCache::MakeKey("act", "opt", {a}));
+  XLS_ASSERT_OK(cache_->Store(key, ReadModules({a, b}), {"result"}));
+
+  // The importing module is unchanged, so the key stays the same, but the
+  // entry is stale.
+  WriteModule("b.x", "fn g() { () }");
+  EXPECT_THAT(PersistentModuleCache::MakeKey("act", "opt", {a}),
+              IsOkAndHolds(key));
+  EXPECT_EQ(cache_->Lookup(key), std::nullopt);
+
+  // Storing again records the new contents.
+  XLS_ASSERT_OK(cache_->Store(key, ReadModules({a, b}), {"new result"}));
+  EXPECT_THAT(cache_->Lookup(key), Optional(ElementsAre("new result")));
+}
+
+TEST_F(PersistentModuleCacheTest, ImportEditedBeforeStoreIsAMiss) {
+  std::filesystem::path a = WriteModule("a.x", "import b;");
+  std::filesystem::path b = WriteModule("b.x", "fn g() {}");
+  XLS_ASSERT_OK_AND_ASSIGN(std::string key,
+                           PersistentModuleCache::MakeKey("act", "opt", {a}));
+  absl::flat_hash_map<std::filesystem::path, std::string> modules =
+      ReadModules({a, b});
+
+  // The artifacts were derived from the old contents of `b`, so the entry must
+  // not match the new ones.
+  WriteModule("b.x", "fn g() { () }");
+  XLS_ASSERT_OK(cache_->Store(key, modules, {"result"}));
+  EXPECT_EQ(cache_->Lookup(key), std::nullopt);
+
+  // Restoring the contents the artifacts were derived from makes it a hit.
+  WriteModule("b.x", "fn g() {}");
+  EXPECT_THAT(cache_->Lookup(key), Optional(ElementsAre("result")));
+}
+
+TEST_F(PersistentModuleCacheTest, EntriesPersistAcrossInstances) {
+  std::filesystem::path a = WriteModule("a.x", "fn f() {}");
+  XLS_ASSERT_OK_AND_ASSIGN(std::string key,
+                           PersistentModuleCache::MakeKey("act", "opt", {a}));
+  XLS_ASSERT_OK(cache_->Store(key, ReadModules({a}), {"result"}));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PersistentModuleCache> cache,
+      PersistentModuleCache::Create(temp_dir_->path() / "cache"));
+  EXPECT_THAT(cache->Lookup(key), Optional(ElementsAre("result")));
+}
+
+TEST_F(PersistentModuleCacheTest, MalformedEntryIsAMiss) {
+  std::filesystem::path a = WriteModule("a.x", "fn f() {}");
+  XLS_ASSERT_OK_AND_ASSIGN(std::string key,
+                           PersistentModuleCache::MakeKey("act", "opt", {a}));
+  std::filesystem::path path =
+      cache_->directory() / absl::StrCat(key, ".xlsdslx");
+  XLS_ASSERT_OK(SetFileContents(path, "XLSDSLX1 truncated"));
+  EXPECT_EQ(cache_->Lookup(key), std::nullopt);
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST_F(PersistentModuleCacheTest, EvictsLeastRecentlyUsed) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PersistentModuleCache> cache,
+      PersistentModuleCache::Create(temp_dir_->path() / "small_cache",
+                                    /*max_bytes=*/300));
+  // Each entry takes 24 bytes of header plus 108 bytes for the artifact, so
+  // only two fit.
+  std::string artifact(100, 'x');
+  std::vector<std::string> keys;
+  for (std::string_view name : {"a.x", "b.x", "c.x"}) {
+    std::filesystem::path path = WriteModule(name, "");
+    XLS_ASSERT_OK_AND_ASSIGN(
+        std::string key, PersistentModuleCache::MakeKey("act", "opt", {path}));
+    keys.push_back(key);
+  }
+  auto set_last_used = [&](std::string_view key, std::chrono::minutes age) {
+    std::filesystem::last_write_time(
+        cache->directory() / absl::StrCat(key, ".xlsdslx"),
+        std::filesystem::file_time_type::clock::now() - age);
+  };
+
+  XLS_ASSERT_OK(cache->Store(keys[0], {}, {artifact}));
+  set_last_used(keys[0], std::chrono::minutes(60));
+  XLS_ASSERT_OK(cache->Store(keys[1], {}, {artifact}));
+  set_last_used(keys[1], std::chrono::minutes(30));
+  // Using the first entry makes the second the least recently used one.
+  EXPECT_NE(cache->Lookup(keys[0]), std::nullopt);
+  XLS_ASSERT_OK(cache->Store(keys[2], {}, {artifact}));
+
+  EXPECT_EQ(cache->stats().evictions, 1);
+  EXPECT_NE(cache->Lookup(keys[0]), std::nullopt);
+  EXPECT_EQ(cache->Lookup(keys[1]), std::nullopt);
+  EXPECT_NE(cache->Lookup(keys[2]), std::nullopt);
+}
+
+TEST_F(PersistentModuleCacheTest, InvalidSizeBound) {
+  EXPECT_FALSE(
+      PersistentModuleCache::Create(temp_dir_->path(), /*max_bytes=*/0).ok());
+}
+
+}  // namespace
+}  // namespace xls::dslx
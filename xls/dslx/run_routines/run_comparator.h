@@ -63,6 +63,17 @@ class RunComparator : public AbstractRunComparator {
       std::string_view ir_name, xls::Function* ir_function,
       absl::Span<const xls::Value> ir_args) override;
 
+  // Returns a comparator with the same mode and its own JIT cache.
+  std::unique_ptr<AbstractRunComparator> CloneForWorker() const override {
+    return std::make_unique<RunComparator>(mode_);
+  }
+
+  // JIT-compiles the function ahead of running it.
+  absl::Status PrepareIrFunction(std::string_view ir_name,
+                                 xls::Function* ir_function) override {
+    return GetOrCompileJitFunction(ir_name, ir_function).status();
+  }
+
   // Returns the cached or newly-compiled jit function for ir_name.  ir_name has
   // already been mangled (see MangleDslxName) so it should be unique in the
   // program and is used as the cache key.
@@ -17,10 +17,12 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <ctime>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <random>
@@ -31,6 +33,7 @@
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/btree_map.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/bind_front.h"
 #include "absl/log/check.h"
@@ -40,11 +43,14 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "xls/common/math_util.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/data_structures/inline_bitmap.h"
 #include "xls/dslx/bytecode/bytecode.h"
 #include "xls/dslx/bytecode/bytecode_cache.h"
@@ -347,18 +353,57 @@ static bool ValuesAreValid(absl::Span<const Value> values,
   return true;
 }
 
+namespace {
+
+// Quickcheck samples are generated and run in shards of this many samples,
+// which are distributed over the available workers.
+constexpr int64_t kQuickCheckShardSize = 1024;
+
+// Returns the random engine generating the arguments of the given shard of a
+// counted quickcheck. Each shard has its own engine so the samples don't
+// depend on how shards are distributed over workers; the first shard's engine
+// is seeded with the quickcheck seed itself.
+std::minstd_rand MakeShardEngine(int64_t seed, int64_t shard_index) {
+  if (shard_index == 0) {
+    return std::minstd_rand(seed);
+  }
+  const uint64_t seed_bits = static_cast<uint64_t>(seed);
+  std::seed_seq seq{static_cast<uint32_t>(seed_bits),
+                    static_cast<uint32_t>(seed_bits >> 32),
+                    static_cast<uint32_t>(shard_index)};
+  return std::minstd_rand(seq);
+}
+
+struct QuickCheckShard {
+  QuickCheckResults results;
+  absl::Status status;
+  // Whether the shard ended early, on a falsifying sample or an error.
+  bool stopped = false;
+};
+
+}  // namespace
+
 absl::StatusOr<QuickCheckResults> DoQuickCheck(
     bool requires_implicit_token, dslx::FunctionType* dslx_fn_type,
     xls::Function* ir_function, std::string_view ir_name,
     AbstractRunComparator* run_comparator, int64_t seed,
     QuickCheckTestCases test_cases) {
-  QuickCheckResults results;
-  std::minstd_rand rng_engine(seed);
+  return DoQuickCheck(requires_implicit_token, dslx_fn_type, ir_function,
+                      ir_name, absl::MakeConstSpan(&run_comparator, 1), seed,
+                      test_cases);
+}
+
+absl::StatusOr<QuickCheckResults> DoQuickCheck(
+    bool requires_implicit_token, dslx::FunctionType* dslx_fn_type,
+    xls::Function* ir_function, std::string_view ir_name,
+    absl::Span<AbstractRunComparator* const> run_comparators, int64_t seed,
+    QuickCheckTestCases test_cases) {
+  XLS_RET_CHECK(!run_comparators.empty());
   xls::TupleType* ir_param_tuple = ir_function->package()->GetTupleType(
       ir_function->GetType()->parameters());
 
   int64_t num_tests;
-  std::function<std::vector<Value>(int64_t)> make_arg_set;
+  std::function<std::vector<Value>(int64_t, std::minstd_rand&)> make_arg_set;
   switch (test_cases.tag()) {
     case QuickCheckTestCasesTag::kExhaustive: {
       int64_t parameter_bit_count = ir_param_tuple->GetFlatBitCount();
@@ -370,7 +415,7 @@ absl::StatusOr<QuickCheckResults> DoQuickCheck(
                             ir_function->name(), parameter_bit_count));
       }
       num_tests = int64_t{1} << parameter_bit_count;
-      make_arg_set = [&](int64_t i) {
+      make_arg_set = [&](int64_t i, std::minstd_rand&) {
         return MakeFromUint64(ir_param_tuple, i);
       };
       break;
@@ -378,7 +423,7 @@ absl::StatusOr<QuickCheckResults> DoQuickCheck(
     case QuickCheckTestCasesTag::kCounted:
       num_tests =
           test_cases.count().value_or(QuickCheckTestCases::kDefaultTestCount);
-      make_arg_set = [&](int64_t) {
+      make_arg_set = [&](int64_t, std::minstd_rand& rng_engine) {
         return RandomFunctionArguments(ir_function, rng_engine);
       };
       break;
@@ -403,48 +448,125 @@ absl::StatusOr<QuickCheckResults> DoQuickCheck(
   XLS_RET_CHECK_EQ(ir_param_tuple->size(), dslx_param_types.size())
       << "IR param tuple size should match DSLX param types size";
 
-  for (int i = 0; i < num_tests; i++) {
-    {
-      std::vector<Value> arg_set = make_arg_set(i);
-      if (!ValuesAreValid(arg_set, dslx_param_types)) {
-        // Note: if we reject an argument set, it counts as a test case -- this
-        // makes sense for exhaustive mode but less sense for randomized mode,
-        // we may want those to operate slightly differently.
-        continue;
+  auto run_shard = [&](AbstractRunComparator* run_comparator,
+                       int64_t shard_index,
+                       QuickCheckShard& shard) -> absl::Status {
+    std::minstd_rand rng_engine = MakeShardEngine(seed, shard_index);
+    QuickCheckResults& results = shard.results;
+    const int64_t start = shard_index * kQuickCheckShardSize;
+    const int64_t end = std::min(num_tests, start + kQuickCheckShardSize);
+    for (int64_t i = start; i < end; ++i) {
+      {
+        std::vector<Value> arg_set = make_arg_set(i, rng_engine);
+        if (!ValuesAreValid(arg_set, dslx_param_types)) {
+          // Note: if we reject an argument set, it counts as a test case --
+          // this makes sense for exhaustive mode but less sense for randomized
+          // mode, we may want those to operate slightly differently.
+          continue;
+        }
+        results.arg_sets.push_back(std::move(arg_set));
       }
-      results.arg_sets.push_back(std::move(arg_set));
-    }
 
-    // TODO(https://github.com/google/xls/issues/506): 2021-10-15
-    // Assertion failures should work out, but we should consciously decide
-    // if/how we want to dump traces when running QuickChecks (always, for
-    // failures, flag-controlled, ...).
-    absl::Span<const Value> this_arg_set = results.arg_sets.back();
-    XLS_ASSIGN_OR_RETURN(xls::Value result,
-                         DropInterpreterEvents(run_comparator->RunIrFunction(
-                             ir_name, ir_function, this_arg_set)));
-
-    // In the case of an implicit token signature we get (token, bool) as the
-    // result of the quickcheck'd function, so we unbox the boolean here.
-    if (result.IsTuple()) {
-      result = result.elements()[1];
-      XLS_RET_CHECK(result.IsBits());
+      // TODO(https://github.com/google/xls/issues/506): 2021-10-15
+      // Assertion failures should work out, but we should consciously decide
+      // if/how we want to dump traces when running QuickChecks (always, for
+      // failures, flag-controlled, ...).
+      absl::Span<const Value> this_arg_set = results.arg_sets.back();
+      XLS_ASSIGN_OR_RETURN(xls::Value result,
+                           DropInterpreterEvents(run_comparator->RunIrFunction(
+                               ir_name, ir_function, this_arg_set)));
+
+      // In the case of an implicit token signature we get (token, bool) as the
+      // result of the quickcheck'd function, so we unbox the boolean here.
+      if (result.IsTuple()) {
+        result = result.elements()[1];
+        XLS_RET_CHECK(result.IsBits());
+      }
+
+      XLS_RET_CHECK(result.IsBits())
+          << "quickcheck properties must return `bool`, should be validated by "
+             "type checking; got: "
+          << result;
+
+      results.results.push_back(result);
+
+      if (result.IsAllZeros()) {
+        // We were able to falsify the xls_function (predicate), bail out early
+        // and present this evidence.
+        shard.stopped = true;
+        break;
+      }
     }
+    return absl::OkStatus();
+  };
 
-    XLS_RET_CHECK(result.IsBits())
-        << "quickcheck properties must return `bool`, should be validated by "
-           "type checking; got: "
-        << result;
+  // Workers claim shards in order from a counter, and shards are only
+  // allocated once claimed: exhaustive quickchecks may have billions of them.
+  // Once a shard stops early no later shard needs to run, and the results of
+  // any which already ran are dropped; every earlier shard still completes, so
+  // the results are the same as running the shards one after another.
+  const int64_t shard_count = CeilOfRatio(num_tests, kQuickCheckShardSize);
+  std::atomic<int64_t> next_shard = 0;
+  // Only written with `mu` held.
+  std::atomic<int64_t> first_stopped_shard = shard_count;
+  absl::Mutex mu;
+  // The shards which have run, guarded by `mu`.
+  absl::btree_map<int64_t, QuickCheckShard> finished_shards;
+  auto run_worker = [&](AbstractRunComparator* run_comparator) {
+    while (true) {
+      const int64_t shard_index = next_shard.fetch_add(1);
+      if (shard_index >= first_stopped_shard.load()) {
+        return;
+      }
+      QuickCheckShard shard;
+      shard.status = run_shard(run_comparator, shard_index, shard);
+      if (!shard.status.ok()) {
+        shard.stopped = true;
+      }
+      absl::MutexLock lock(&mu);
+      if (shard_index > first_stopped_shard.load()) {
+        continue;
+      }
+      if (shard.stopped) {
+        first_stopped_shard.store(shard_index);
+        finished_shards.erase(finished_shards.upper_bound(shard_index),
+                              finished_shards.end());
+      }
+      finished_shards.emplace(shard_index, std::move(shard));
+    }
+  };
 
-    results.results.push_back(result);
+  const int64_t worker_count =
+      std::min<int64_t>(run_comparators.size(), shard_count);
+  if (worker_count > 1) {
+    // Prepare (e.g. JIT-compile) the function for each worker up front, since
+    // preparation may touch the IR package and so can't run concurrently.
+    for (int64_t i = 0; i < worker_count; ++i) {
+      XLS_RETURN_IF_ERROR(
+          run_comparators[i]->PrepareIrFunction(ir_name, ir_function));
+    }
+  }
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t i = 1; i < worker_count; ++i) {
+    threads.push_back(std::make_unique<Thread>(
+        [&run_worker, comparator = run_comparators[i]] {
+          run_worker(comparator);
+        }));
+  }
+  run_worker(run_comparators[0]);
+  for (std::unique_ptr<Thread>& thread : threads) {
+    thread->Join();
+  }
 
-    if (result.IsAllZeros()) {
-      // We were able to falsify the xls_function (predicate), bail out early
-      // and present this evidence.
+  QuickCheckResults results;
+  for (auto& [shard_index, shard] : finished_shards) {
+    XLS_RETURN_IF_ERROR(shard.status);
+    absl::c_move(shard.results.arg_sets, std::back_inserter(results.arg_sets));
+    absl::c_move(shard.results.results, std::back_inserter(results.results));
+    if (shard.stopped) {
       break;
     }
   }
-
   return results;
 }
 
@@ -485,9 +607,10 @@ static absl::StatusOr<QuickcheckIrFn> FindQuickcheckIrFn(Function* dslx_fn,
                       absl::StrJoin(ir_package->GetFunctionNames(), ", ")));
 }
 
-static absl::Status RunQuickCheck(AbstractRunComparator* run_comparator,
-                                  Package* ir_package, QuickCheck* quickcheck,
-                                  TypeInfo* type_info, int64_t seed) {
+static absl::Status RunQuickCheck(
+    absl::Span<AbstractRunComparator* const> run_comparators,
+    Package* ir_package, QuickCheck* quickcheck, TypeInfo* type_info,
+    int64_t seed) {
   // Note: DSLX function.
   dslx::Function* dslx_fn = quickcheck->fn();
 
@@ -512,8 +635,8 @@ static absl::Status RunQuickCheck(AbstractRunComparator* run_comparator,
       QuickCheckResults qc_results,
       DoQuickCheck(
           qc_fn.calling_convention == CallingConvention::kImplicitToken,
-          dslx_fn_type, qc_fn.ir_function, qc_fn.ir_name, run_comparator, seed,
-          quickcheck->test_cases()));
+          dslx_fn_type, qc_fn.ir_function, qc_fn.ir_name, run_comparators,
+          seed, quickcheck->test_cases()));
 
   // Extract the (inputs, outputs) from the results.
   const auto& [inputs, outputs] = qc_results;
@@ -569,8 +692,8 @@ static absl::Status RunQuickCheck(AbstractRunComparator* run_comparator,
 static absl::Status RunQuickChecksIfJitEnabled(
     const RE2* test_filter, Module* entry_module, TypeInfo* type_info,
     AbstractRunComparator* run_comparator, Package* ir_package,
-    std::optional<int64_t> seed, TestResultData& result,
-    VirtualizableFilesystem& vfs) {
+    std::optional<int64_t> seed, int64_t quickcheck_workers,
+    TestResultData& result, VirtualizableFilesystem& vfs) {
   if (run_comparator == nullptr) {
     // TODO(leary): 2024-02-08 Note that this skips /all/ the quickchecks so we
     // don't make an entry for it right now in the test XML.
@@ -583,6 +706,22 @@ static absl::Status RunQuickChecksIfJitEnabled(
     // for rationale.
     seed = static_cast<int64_t>(getpid()) * static_cast<int64_t>(time(nullptr));
   }
+  // Comparators for additional quickcheck workers are created once so that
+  // their compiled functions are shared by all the quickchecks in the module.
+  if (quickcheck_workers == 0) {
+    quickcheck_workers = AvailableCPUs();
+  }
+  std::vector<std::unique_ptr<AbstractRunComparator>> worker_comparators;
+  std::vector<AbstractRunComparator*> run_comparators = {run_comparator};
+  while (run_comparators.size() < quickcheck_workers) {
+    std::unique_ptr<AbstractRunComparator> worker_comparator =
+        run_comparator->CloneForWorker();
+    if (worker_comparator == nullptr) {
+      break;
+    }
+    run_comparators.push_back(worker_comparator.get());
+    worker_comparators.push_back(std::move(worker_comparator));
+  }
   FileTable& file_table = *entry_module->file_table();
   bool any_quicktest_run = false;
   for (QuickCheck* quickcheck : entry_module->GetQuickChecks()) {
@@ -610,8 +749,8 @@ static absl::Status RunQuickChecksIfJitEnabled(
     }
     std::cerr << "[ RUN QUICKCHECK        ] " << quickcheck_name
               << " cases: " << quickcheck->test_cases().ToString() << "\n";
-    const absl::Status status =
-        RunQuickCheck(run_comparator, ir_package, quickcheck, type_info, *seed);
+    const absl::Status status = RunQuickCheck(run_comparators, ir_package,
+                                              quickcheck, type_info, *seed);
     const absl::Duration duration = absl::Now() - test_case_start;
     if (!status.ok()) {
       HandleError(result, status, quickcheck_name, start_pos, test_case_start,
@@ -933,7 +1072,8 @@ absl::StatusOr<TestResultData> AbstractTestRunner::ParseAndTest(
         .trace_hook(absl::bind_front(InfoLoggingTraceHook, file_table))
         .trace_channels(options.trace_channels)
         .max_ticks(options.max_ticks)
-        .format_preference(options.format_preference);
+        .format_preference(options.format_preference)
+        .register_lowering(options.register_lowering);
     if (std::holds_alternative<TestFunction*>(*member)) {
       XLS_ASSIGN_OR_RETURN(
           out, runner->RunTestFunction(test_name, interpreter_options));
@@ -971,8 +1111,8 @@ absl::StatusOr<TestResultData> AbstractTestRunner::ParseAndTest(
   if (!entry_module->GetQuickChecks().empty()) {
     XLS_RETURN_IF_ERROR(RunQuickChecksIfJitEnabled(
         options.test_filter, entry_module, tm->type_info,
-        options.run_comparator, ir_package.get(), options.seed, result,
-        import_data.vfs()));
+        options.run_comparator, ir_package.get(), options.seed,
+        options.quickcheck_workers, result, import_data.vfs()));
   }
 
   result.Finish(
@@ -83,6 +83,21 @@ class AbstractRunComparator {
   virtual absl::StatusOr<InterpreterResult<xls::Value>> RunIrFunction(
       std::string_view ir_name, xls::Function* ir_function,
       absl::Span<const xls::Value> ir_args) = 0;
+
+  // Returns a new comparator that can run IR functions concurrently with this
+  // one (i.e. that has its own execution state), or nullptr if that isn't
+  // supported.
+  virtual std::unique_ptr<AbstractRunComparator> CloneForWorker() const {
+    return nullptr;
+  }
+
+  // Does any up-front work (e.g. JIT compilation) needed to run the given IR
+  // function, so that later RunIrFunction calls don't touch the IR package.
+  // Must not be called concurrently for functions of the same package.
+  virtual absl::Status PrepareIrFunction(std::string_view ir_name,
+                                         xls::Function* ir_function) {
+    return absl::OkStatus();
+  }
 };
 
 // Optional arguments to ParseAndTest (that have sensible defaults).
@@ -93,6 +108,11 @@ class AbstractRunComparator {
 //    executions with a reference (e.g. IR execution).
 //   execute: Whether or not to execute the quickchecks and tests.
 //   seed: Seed for QuickCheck random input stimulus.
+//   quickcheck_workers: Number of threads quickcheck samples are spread over,
+//    each with its own copy of the run comparator. Zero uses all available
+//    CPUs.
+//   register_lowering: Whether the bytecode interpreter runs functions in
+//    their register-based form where possible.
 //   convert_options: Options used in IR conversion, see `ConvertOptions` for
 //    details.
 //   warnings_as_errors: Whether warnings should be reported as errors (i.e.
@@ -106,11 +126,13 @@ struct ParseAndTestOptions {
   AbstractRunComparator* run_comparator = nullptr;
   bool execute = true;
   std::optional<int64_t> seed = std::nullopt;
+  int64_t quickcheck_workers = 1;
   ConvertOptions convert_options;
   bool warnings_as_errors = true;
   WarningKindSet warnings = kDefaultWarningsSet;
   bool trace_channels = false;
   std::optional<int64_t> max_ticks;
+  bool register_lowering = false;
   std::function<std::unique_ptr<VirtualizableFilesystem>()> vfs_factory =
       nullptr;
 };
@@ -301,6 +323,16 @@ absl::StatusOr<QuickCheckResults> DoQuickCheck(
     AbstractRunComparator* run_comparator, int64_t seed,
     QuickCheckTestCases test_cases);
 
+// As above, but spreads the samples over one thread per given comparator
+// (which must be able to run concurrently, see CloneForWorker). Samples are
+// generated in fixed-size shards with per-shard seeds, so the results don't
+// depend on the number of comparators.
+absl::StatusOr<QuickCheckResults> DoQuickCheck(
+    bool requires_implicit_token, dslx::FunctionType* dslx_fn_type,
+    xls::Function* ir_function, std::string_view ir_name,
+    absl::Span<AbstractRunComparator* const> run_comparators, int64_t seed,
+    QuickCheckTestCases test_cases);
+
 }  // namespace xls::dslx
 
 #endif  // XLS_DSLX_RUN_ROUTINES_RUN_ROUTINES_H_
@@ -694,6 +694,97 @@ TEST(QuickcheckTest, Seeding) {
   EXPECT_EQ(results1, results2);
 }
 
+// Runs the given single-`bits[8]`-parameter property sequentially and spread
+// over three workers, and checks the results are identical.
+void ExpectShardedQuickCheckMatchesSequential(std::string_view ir_text,
+                                              int64_t test_count) {
+  Package package("sharded");
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  std::vector<std::unique_ptr<dslx::Type>> params;
+  params.push_back(std::make_unique<dslx::BitsType>(false, 8));
+  auto return_type = std::make_unique<dslx::BitsType>(false, 1);
+  dslx::FunctionType fn_type(std::move(params), std::move(return_type));
+
+  int64_t seed = 12345;
+  QuickCheckTestCases test_cases = QuickCheckTestCases::Counted(test_count);
+  RunComparator jit_comparator(CompareMode::kJit);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      QuickCheckResults sequential,
+      DoQuickCheck(/*requires_implicit_token=*/false, &fn_type, function,
+                   kFakeIrName, &jit_comparator, seed, test_cases));
+
+  std::unique_ptr<AbstractRunComparator> worker1 =
+      jit_comparator.CloneForWorker();
+  std::unique_ptr<AbstractRunComparator> worker2 =
+      jit_comparator.CloneForWorker();
+  ASSERT_NE(worker1, nullptr);
+  ASSERT_NE(worker2, nullptr);
+  std::vector<AbstractRunComparator*> comparators = {
+      &jit_comparator, worker1.get(), worker2.get()};
+  XLS_ASSERT_OK_AND_ASSIGN(
+      QuickCheckResults sharded,
+      DoQuickCheck(/*requires_implicit_token=*/false, &fn_type, function,
+                   kFakeIrName, comparators, seed, test_cases));
+
+  EXPECT_EQ(sequential.arg_sets, sharded.arg_sets);
+  EXPECT_EQ(sequential.results, sharded.results);
+}
+
+TEST(QuickcheckTest, ShardedMatchesSequential) {
+  constexpr std::string_view kIrText = R"(
+  fn always_true(x: bits[8]) -> bits[1] {
+    literal.2: bits[8] = literal(value=0)
+    ret uge.3: bits[1] = uge(x, literal.2)
+  }
+  )";
+  ExpectShardedQuickCheckMatchesSequential(kIrText, 5000);
+}
+
+TEST(QuickcheckTest, ShardedStopsAtFirstFalsifyingExample) {
+  // Only falsified by a single value, so likely not in the first shard.
+  constexpr std::string_view kIrText = R"(
+  fn ne_42(x: bits[8]) -> bits[1] {
+    literal.2: bits[8] = literal(value=42)
+    ret ne.3: bits[1] = ne(x, literal.2)
+  }
+  )";
+  ExpectShardedQuickCheckMatchesSequential(kIrText, 20000);
+}
+
+// An exhaustive quickcheck over 48 parameter bits has about 2^38 shards, which
+// must only be allocated as they run.
+TEST(QuickcheckTest, ShardedExhaustiveStopsEarlyOnWideParameters) {
+  Package package("wide_exhaustive");
+  std::string ir_text = R"(
+  fn nonzero(x: bits[48]) -> bits[1] {
+    literal.2: bits[48] = literal(value=0)
+    ret ne.3: bits[1] = ne(x, literal.2)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  std::vector<std::unique_ptr<dslx::Type>> params;
+  params.push_back(std::make_unique<dslx::BitsType>(false, 48));
+  auto return_type = std::make_unique<dslx::BitsType>(false, 1);
+  dslx::FunctionType fn_type(std::move(params), std::move(return_type));
+
+  RunComparator jit_comparator(CompareMode::kJit);
+  std::unique_ptr<AbstractRunComparator> worker =
+      jit_comparator.CloneForWorker();
+  ASSERT_NE(worker, nullptr);
+  std::vector<AbstractRunComparator*> comparators = {&jit_comparator,
+                                                     worker.get()};
+  XLS_ASSERT_OK_AND_ASSIGN(
+      QuickCheckResults results,
+      DoQuickCheck(/*requires_implicit_token=*/false, &fn_type, function,
+                   kFakeIrName, comparators, /*seed=*/0,
+                   QuickCheckTestCases::Exhaustive()));
+  // The very first sample is falsifying.
+  ASSERT_EQ(results.results.size(), 1);
+  EXPECT_EQ(results.results.front(), Value(UBits(0, 1)));
+}
+
 TEST(QuickcheckTest, ProofFailure) {
   constexpr std::string_view kProgram = R"(
 #[quickcheck(exhaustive)]
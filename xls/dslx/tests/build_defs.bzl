@@ -44,6 +44,7 @@ def dslx_lang_test(
         benchmark_ir = True,
         warnings_as_errors = True,
         test_autofmt = True,
+        test_register_lowering = True,
         compare = "jit"):
     """This macro is convenient shorthand for our many DSLX test targets.
 
@@ -96,6 +97,8 @@ def dslx_lang_test(
         language test remains auto-formatted.
       compare: Whether to compare DSL-interpreted results with IR execution for each
         function for consistency checking.
+      test_register_lowering: Whether to also run the language-level test with
+        the bytecode interpreter's register-based execution mode.
 
     As a byproduct this makes a "{name}_dslx" library target that other
     dslx_interp_tests can reference via the dslx_deps attribute.
@@ -119,6 +122,13 @@ def dslx_lang_test(
         dslx_test_args = test_args,
     )
 
+    if test_register_lowering:
+        xls_dslx_test(
+            name = name + "_dslx_register_lowering_test",
+            library = name + "_dslx",
+            dslx_test_args = dict(test_args, register_lowering = "true"),
+        )
+
     if test_autofmt:
         xls_dslx_fmt_test(
             name = name + "_dslx_fmt",
@@ -20,6 +20,7 @@
 #include <string_view>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/flags/flag.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
@@ -39,6 +40,7 @@
 #include "xls/dslx/frontend/bindings.h"
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/parse_and_typecheck.h"
+#include "xls/dslx/persistent_module_cache.h"
 #include "xls/dslx/type_system/type_info.pb.h"
 #include "xls/dslx/type_system/type_info_to_proto.h"
 #include "xls/dslx/virtualizable_file_system.h"
@@ -75,6 +77,17 @@ Parses and typechecks the specified module and emits the type information that
 was deduced.
 )";
 
+// Writes the type information either as a protobin to `output_path` or, when
+// no output path is given, as text to stdout.
+absl::Status EmitOutput(std::string_view output,
+                        std::optional<std::filesystem::path> output_path) {
+  if (output_path.has_value()) {
+    return SetFileContents(output_path->c_str(), output);
+  }
+  std::cout << output << '\n';
+  return absl::OkStatus();
+}
+
 absl::Status RealMain(absl::Span<const std::filesystem::path> dslx_paths,
                       const std::filesystem::path& dslx_stdlib_path,
                       const std::filesystem::path& input_path,
@@ -84,10 +97,44 @@ absl::Status RealMain(absl::Span<const std::filesystem::path> dslx_paths,
       GetWarningsSetFromFlags(absl::GetFlag(FLAGS_enable_warnings),
                               absl::GetFlag(FLAGS_disable_warnings)));
 
-  ImportData import_data(
-      CreateImportData(dslx_stdlib_path,
-                       /*additional_search_paths=*/dslx_paths, warnings,
-                       std::make_unique<RealFilesystem>()));
+  // Results are only cached when typechecking succeeds without warnings, so a
+  // cache hit produces exactly the output of a fresh run.
+  PersistentModuleCache* cache = PersistentModuleCache::GetDefault();
+  std::optional<std::string> cache_key;
+  if (cache != nullptr) {
+    std::vector<std::string> dslx_path_strs;
+    for (const std::filesystem::path& path : dslx_paths) {
+      dslx_path_strs.push_back(path.string());
+    }
+    std::string options = absl::StrJoin(
+        {absl::StrJoin(dslx_path_strs, ":"), dslx_stdlib_path.string(),
+         absl::GetFlag(FLAGS_enable_warnings),
+         absl::GetFlag(FLAGS_disable_warnings),
+         std::string(output_path.has_value() ? "proto" : "text")},
+        "\n");
+    absl::StatusOr<std::string> key =
+        PersistentModuleCache::MakeKey("typecheck", options, {input_path});
+    if (key.ok()) {
+      cache_key = *std::move(key);
+    } else {
+      VLOG(1) << "Not caching typecheck results: " << key.status();
+    }
+  }
+  if (cache_key.has_value()) {
+    std::optional<std::vector<std::string>> artifacts =
+        cache->Lookup(*cache_key);
+    if (artifacts.has_value() && artifacts->size() == 1) {
+      return EmitOutput(artifacts->front(), output_path);
+    }
+  }
+
+  // The contents of every module as it was parsed, for the cache to record.
+  absl::flat_hash_map<std::filesystem::path, std::string> module_contents;
+  ImportData import_data(CreateImportData(
+      dslx_stdlib_path,
+      /*additional_search_paths=*/dslx_paths, warnings,
+      std::make_unique<RecordingFilesystem>(std::make_unique<RealFilesystem>(),
+                                            &module_contents)));
   XLS_ASSIGN_OR_RETURN(std::string input_contents,
                        import_data.vfs().GetFileContents(input_path));
   XLS_ASSIGN_OR_RETURN(std::string module_name, PathToName(input_path.c_str()));
@@ -119,16 +166,21 @@ absl::Status RealMain(absl::Span<const std::filesystem::path> dslx_paths,
   }
 
   XLS_ASSIGN_OR_RETURN(TypeInfoProto tip, TypeInfoToProto(*tm->type_info));
+  std::string output;
   if (output_path.has_value()) {
-    std::string output;
     QCHECK(tip.SerializeToString(&output));
-    return SetFileContents(output_path->c_str(), output);
+  } else {
+    XLS_ASSIGN_OR_RETURN(
+        output, ToHumanString(tip, import_data, import_data.file_table()));
   }
-  XLS_ASSIGN_OR_RETURN(
-      std::string humanized,
-      ToHumanString(tip, import_data, import_data.file_table()));
-  std::cout << humanized << '\n';
-  return absl::OkStatus();
+  if (cache_key.has_value() && tm->warnings.empty()) {
+    absl::Status status =
+        cache->Store(*cache_key, module_contents, {output});
+    if (!status.ok()) {
+      LOG(WARNING) << "Unable to cache typecheck results: " << status;
+    }
+  }
+  return EmitOutput(output, output_path);
 }
 
 }  // namespace
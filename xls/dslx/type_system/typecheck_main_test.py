@@ -89,6 +89,43 @@ class TypecheckMainTest(absltest.TestCase):
     self.assertNotEqual(p.returncode, 0)
     self.assertIn('Match is already exhaustive', p.stderr)
 
+  def test_persistent_cache(self):
+    module_dir = self.create_tempdir()
+    imported = module_dir.create_file(
+        'imported.x',
+        content='pub type Value = u32;\npub const VALUE = Value:42;',
+    )
+    top = module_dir.create_file(
+        'top.x',
+        content=(
+            'import imported;\n\n'
+            'fn f() -> imported::Value { imported::VALUE }'
+        ),
+    )
+    cache_dir = self.create_tempdir()
+    env = dict(os.environ, XLS_DSLX_CACHE_DIR=cache_dir.full_path)
+
+    def typecheck():
+      return subp.check_output(
+          [
+              _TYPECHECK_MAIN_PATH,
+              top.full_path,
+              '--dslx_path=' + module_dir.full_path,
+          ],
+          encoding='utf-8',
+          env=env,
+      )
+
+    first = typecheck()
+    self.assertLen(os.listdir(cache_dir.full_path), 1)
+    self.assertEqual(typecheck(), first)
+
+    # Changing an imported module invalidates the cached result.
+    imported.write_text('pub type Value = u8;\npub const VALUE = Value:42;')
+    second = typecheck()
+    self.assertNotEqual(second, first)
+    self.assertLen(os.listdir(cache_dir.full_path), 1)
+
 
 if __name__ == '__main__':
   absltest.main()
@@ -22,6 +22,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/common/file/filesystem.h"
+#include "xls/common/status/status_macros.h"
 
 namespace xls::dslx {
 
@@ -38,6 +39,28 @@ absl::StatusOr<std::filesystem::path> RealFilesystem::GetCurrentDirectory() {
   return xls::GetCurrentDirectory();
 }
 
+// -- RecordingFilesystem
+
+absl::Status RecordingFilesystem::FileExists(
+    const std::filesystem::path& path) {
+  return base_->FileExists(path);
+}
+
+absl::StatusOr<std::string> RecordingFilesystem::GetFileContents(
+    const std::filesystem::path& path) {
+  auto it = files_->find(path);
+  if (it == files_->end()) {
+    XLS_ASSIGN_OR_RETURN(std::string contents, base_->GetFileContents(path));
+    it = files_->emplace(path, std::move(contents)).first;
+  }
+  return it->second;
+}
+
+absl::StatusOr<std::filesystem::path>
+RecordingFilesystem::GetCurrentDirectory() {
+  return base_->GetCurrentDirectory();
+}
+
 // -- FakeFilesystem
 
 FakeFilesystem::FakeFilesystem(
@@ -16,9 +16,11 @@
 #define XLS_DSLX_VIRTUALIZABLE_FILE_SYSTEM_H_
 
 #include <filesystem>  // NOLINT
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
@@ -57,6 +59,30 @@ class RealFilesystem : public VirtualizableFilesystem {
   absl::StatusOr<std::filesystem::path> GetCurrentDirectory() override;
 };
 
+// A filesystem which forwards to `base` and records the contents of every file
+// read through it in `files`, keyed by the requested path. Once a file has been
+// read, its recorded contents are returned for all later reads of the same
+// path, so everything derived from the files sees one version of each even if
+// they change on disk in the meantime. `files` may be shared between several
+// instances and must outlive them.
+class RecordingFilesystem : public VirtualizableFilesystem {
+ public:
+  RecordingFilesystem(
+      std::unique_ptr<VirtualizableFilesystem> base,
+      absl::flat_hash_map<std::filesystem::path, std::string>* files)
+      : base_(std::move(base)), files_(files) {}
+
+  ~RecordingFilesystem() override = default;
+  absl::Status FileExists(const std::filesystem::path& path) override;
+  absl::StatusOr<std::string> GetFileContents(
+      const std::filesystem::path& path) override;
+  absl::StatusOr<std::filesystem::path> GetCurrentDirectory() override;
+
+ private:
+  std::unique_ptr<VirtualizableFilesystem> base_;
+  absl::flat_hash_map<std::filesystem::path, std::string>* files_;
+};
+
 // A fake filesystem that gives back the same file content for all requested
 // paths, useful in testing.
 //
@@ -14,16 +14,29 @@
 
 #include "xls/fuzzer/run_fuzz.h"
 
+#include <poll.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <array>
+#include <cerrno>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>  // NOLINT
+#include <limits>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"
 #include "absl/flags/declare.h"
 #include "absl/flags/flag.h"
 #include "absl/log/log.h"
@@ -32,9 +45,11 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "openssl/sha.h"
@@ -43,6 +58,7 @@
 #include "xls/common/file/get_runfile_path.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/stopwatch.h"
+#include "xls/common/strerror.h"
 #include "xls/common/subprocess.h"
 #include "xls/dslx/frontend/pos.h"
 #include "xls/fuzzer/ast_generator.h"
@@ -174,12 +190,142 @@ absl::StatusOr<std::filesystem::path> SaveCrasher(
   return sample_crasher_dir;
 }
 
+// Exit codes of the forked child in RunSampleInForkedProcess. These are
+// unlikely to be used by anything else which might exit the child, e.g. exit(0)
+// or exit(1) from library code; any other exit code is a sample failure.
+constexpr int kForkedSampleSuccess = 90;
+constexpr int kForkedSampleSkipped = 91;
+constexpr int kForkedSampleFailed = 92;
+
+// File in the run directory through which the forked child reports the status
+// of a failed sample: the numeric status code on the first line followed by
+// the message.
+constexpr std::string_view kForkedStatusFileName = "forked_status.txt";
+
+// Blocks until the child process `pid` exits or `deadline` passes, without
+// reaping it. Returns whether the child exited.
+absl::StatusOr<bool> WaitForExit(pid_t pid, absl::Time deadline) {
+  // A pidfd becomes readable once the process exits, so it can be waited on
+  // with a timeout.
+  int pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+  if (pidfd < 0) {
+    return absl::InternalError(absl::StrFormat(
+        "Unable to open pidfd for sample runner: %s", Strerror(errno)));
+  }
+  absl::Cleanup close_pidfd = [pidfd] { close(pidfd); };
+  while (true) {
+    absl::Duration remaining = deadline - absl::Now();
+    if (remaining <= absl::ZeroDuration()) {
+      return false;
+    }
+    struct pollfd poll_fd = {.fd = pidfd, .events = POLLIN, .revents = 0};
+    int64_t timeout_ms = absl::ToInt64Milliseconds(
+        absl::Ceil(remaining, absl::Milliseconds(1)));
+    int ready = poll(&poll_fd, 1,
+                     static_cast<int>(std::min<int64_t>(
+                         timeout_ms, std::numeric_limits<int>::max())));
+    if (ready > 0) {
+      return true;
+    }
+    if (ready < 0 && errno != EINTR) {
+      return absl::InternalError(absl::StrFormat(
+          "Unable to wait for sample runner: %s", Strerror(errno)));
+    }
+  }
+}
+
+// Runs the sample in-process in a forked child, so that a crash only
+// terminates the child. The child reports how the sample completed through its
+// exit code.
+absl::StatusOr<CompletedSampleKind> RunSampleInForkedProcess(
+    const Sample& smp, const std::filesystem::path& run_dir,
+    const std::optional<std::filesystem::path>& summary_file,
+    std::optional<absl::Duration> generate_sample_elapsed) {
+  std::filesystem::path status_path = run_dir / kForkedStatusFileName;
+  pid_t pid = fork();
+  if (pid < 0) {
+    return absl::InternalError(
+        absl::StrFormat("Unable to fork sample runner: %s", Strerror(errno)));
+  }
+  if (pid == 0) {
+    absl::StatusOr<CompletedSampleKind> result =
+        RunSample(smp, run_dir, summary_file, generate_sample_elapsed,
+                  SampleRunner::ExecutionMode::kInProcess);
+    if (result.ok()) {
+      _exit(*result == CompletedSampleKind::kSkipped ? kForkedSampleSkipped
+                                                     : kForkedSampleSuccess);
+    }
+    if (!SetFileContents(status_path,
+                         absl::StrCat(static_cast<int>(result.status().code()),
+                                      "\n", result.status().message()))
+             .ok()) {
+      LOG(ERROR) << "Failed to record sample status: " << result.status();
+    }
+    _exit(kForkedSampleFailed);
+  }
+
+  std::optional<absl::Time> deadline;
+  if (smp.options().timeout_seconds().has_value()) {
+    deadline = absl::Now() + absl::Seconds(*smp.options().timeout_seconds());
+  }
+  absl::StatusOr<bool> exited = true;
+  if (deadline.has_value()) {
+    exited = WaitForExit(pid, *deadline);
+  }
+  if (!exited.ok() || !*exited) {
+    kill(pid, SIGKILL);
+  }
+  int wait_status;
+  while (waitpid(pid, &wait_status, 0) < 0) {
+    if (errno != EINTR) {
+      return absl::InternalError(absl::StrFormat(
+          "Unable to wait for sample runner: %s", Strerror(errno)));
+    }
+  }
+  XLS_RETURN_IF_ERROR(exited.status());
+  if (!*exited) {
+    return absl::DeadlineExceededError(
+        absl::StrFormat("Sample timed out after %d seconds",
+                        *smp.options().timeout_seconds()));
+  }
+
+  if (WIFSIGNALED(wait_status)) {
+    return absl::InternalError(absl::StrFormat(
+        "Sample runner terminated by signal %d (%s)", WTERMSIG(wait_status),
+        strsignal(WTERMSIG(wait_status))));
+  }
+  switch (WEXITSTATUS(wait_status)) {
+    case kForkedSampleSuccess:
+      return CompletedSampleKind::kSuccess;
+    case kForkedSampleSkipped:
+      return CompletedSampleKind::kSkipped;
+    case kForkedSampleFailed:
+      break;
+    default:
+      return absl::InternalError(
+          absl::StrFormat("Sample runner exited with unexpected status %d",
+                          WEXITSTATUS(wait_status)));
+  }
+  XLS_ASSIGN_OR_RETURN(std::string status_text, GetFileContents(status_path));
+  std::filesystem::remove(status_path);
+  std::pair<std::string_view, std::string_view> code_and_message =
+      absl::StrSplit(status_text, absl::MaxSplits('\n', 1));
+  int code;
+  if (!absl::SimpleAtoi(code_and_message.first, &code)) {
+    return absl::InternalError(
+        absl::StrCat("Malformed sample runner status: ", status_text));
+  }
+  return absl::Status(static_cast<absl::StatusCode>(code),
+                      code_and_message.second);
+}
+
 }  // namespace
 
 absl::StatusOr<CompletedSampleKind> RunSample(
     const Sample& smp, const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& summary_file,
-    std::optional<absl::Duration> generate_sample_elapsed) {
+    std::optional<absl::Duration> generate_sample_elapsed,
+    SampleRunner::ExecutionMode execution_mode) {
   XLS_ASSIGN_OR_RETURN(std::filesystem::path sample_runner_main_path,
                        GetXlsRunfilePath(kSampleRunnerMainPath));
 
@@ -226,7 +372,7 @@ cd "$RUNDIR"
 
   VLOG(1) << "Starting to run sample";
   VLOG(2) << smp.input_text();
-  SampleRunner runner(run_dir);
+  SampleRunner runner(run_dir, execution_mode);
   XLS_ASSIGN_OR_RETURN(auto fuzz_result,
                        runner.RunFromFiles(sample_file_name, options_file_name,
                                            testvector_path));
@@ -258,7 +404,7 @@ absl::StatusOr<std::pair<Sample, CompletedSampleKind>> GenerateSampleAndRun(
     const SampleOptions& sample_options, const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& crasher_dir,
     const std::optional<std::filesystem::path>& summary_file,
-    bool force_failure) {
+    bool force_failure, SampleRunner::ExecutionMode execution_mode) {
   Stopwatch stopwatch;
   XLS_ASSIGN_OR_RETURN(
       Sample smp, GenerateSample(ast_generator_options, sample_options, bit_gen,
@@ -266,7 +412,10 @@ absl::StatusOr<std::pair<Sample, CompletedSampleKind>> GenerateSampleAndRun(
   absl::Duration generate_sample_elapsed = stopwatch.GetElapsedTime();
 
   absl::StatusOr<CompletedSampleKind> status =
-      RunSample(smp, run_dir, summary_file, generate_sample_elapsed);
+      execution_mode == SampleRunner::ExecutionMode::kInProcess
+          ? RunSampleInForkedProcess(smp, run_dir, summary_file,
+                                     generate_sample_elapsed)
+          : RunSample(smp, run_dir, summary_file, generate_sample_elapsed);
   if (force_failure) {
     status = absl::InternalError("Forced sample failure.");
   }
@@ -30,21 +30,34 @@ namespace xls {
 
 // Runs the given sample in `run_dir`. If `summary_file` is given, the sample
 // summary will be appended to this file; if `generate_sample_elapsed` is also
-// given, it will be recorded in the timings in the sample summary.
+// given, it will be recorded in the timings in the sample summary. The sample
+// runner executes the sample's stages according to `execution_mode`.
 //
 // `run_dir` must be an empty directory.
 absl::StatusOr<CompletedSampleKind> RunSample(
     const Sample& smp, const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& summary_file = std::nullopt,
-    std::optional<absl::Duration> generate_sample_elapsed = std::nullopt);
+    std::optional<absl::Duration> generate_sample_elapsed = std::nullopt,
+    SampleRunner::ExecutionMode execution_mode =
+        SampleRunner::ExecutionMode::kSubprocess);
 
+// Generates a sample and runs it in `run_dir`, saving (and minimizing) it in
+// `crasher_dir` if it fails.
+//
+// With `SampleRunner::ExecutionMode::kInProcess`, the sample is run in a
+// forked child process so that a crash while running it is reported as a
+// failure of the sample rather than terminating the caller; the sample's
+// timeout, if any, then applies to the sample as a whole. Forking is only safe
+// if the calling process is single-threaded.
 absl::StatusOr<std::pair<Sample, CompletedSampleKind>> GenerateSampleAndRun(
     dslx::FileTable& file_table, absl::BitGenRef bit_gen,
     const dslx::AstGeneratorOptions& ast_generator_options,
     const SampleOptions& sample_options, const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& crasher_dir = std::nullopt,
     const std::optional<std::filesystem::path>& summary_file = std::nullopt,
-    bool force_failure = false);
+    bool force_failure = false,
+    SampleRunner::ExecutionMode execution_mode =
+        SampleRunner::ExecutionMode::kSubprocess);
 
 }  // namespace xls
 
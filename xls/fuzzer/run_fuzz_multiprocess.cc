@@ -14,7 +14,15 @@
 
 #include "xls/fuzzer/run_fuzz_multiprocess.h"
 
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
@@ -23,6 +31,7 @@
 #include <string_view>
 #include <vector>
 
+#include "absl/functional/function_ref.h"
 #include "absl/log/log.h"
 #include "absl/random/distributions.h"
 #include "absl/random/random.h"
@@ -36,11 +45,13 @@
 #include "xls/common/file/temp_directory.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/stopwatch.h"
+#include "xls/common/strerror.h"
 #include "xls/common/thread.h"
 #include "xls/dslx/frontend/pos.h"
 #include "xls/fuzzer/ast_generator.h"
 #include "xls/fuzzer/run_fuzz.h"
 #include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_runner.h"
 
 namespace xls {
 namespace {
@@ -63,7 +74,8 @@ absl::StatusOr<FuzzResult> GenerateAndRunSamples(
     const std::optional<std::filesystem::path>& crasher_dir,
     const std::optional<std::filesystem::path>& summary_dir,
     std::optional<int64_t> sample_count,
-    const std::optional<absl::Duration>& duration, bool force_failure) {
+    const std::optional<absl::Duration>& duration, bool force_failure,
+    SampleRunner::ExecutionMode execution_mode) {
   int64_t crashers = 0;
   int64_t skipped = 0;
   LOG(INFO) << "--- Started worker " << worker_number;
@@ -105,7 +117,8 @@ absl::StatusOr<FuzzResult> GenerateAndRunSamples(
 
     auto result = GenerateSampleAndRun(file_table, rng, ast_generator_options,
                                        sample_options, run_dir, crasher_dir,
-                                       summary_file, force_failure);
+                                       summary_file, force_failure,
+                                       execution_mode);
     if (!result.ok()) {
       LOG(INFO) << kRedText
                 << absl::StreamFormat(
@@ -171,6 +184,114 @@ absl::StatusOr<FuzzResult> GenerateAndRunSamples(
   };
 }
 
+bool WriteFully(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t written = write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+bool ReadFully(int fd, char* data, size_t size) {
+  while (size > 0) {
+    ssize_t bytes = read(fd, data, size);
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      return false;
+    }
+    data += bytes;
+    size -= bytes;
+  }
+  return true;
+}
+
+// Runs each worker in a forked process rather than a thread, so that workers
+// are single-threaded and can in turn fork a child for each sample they run
+// in-process. Each worker reports its FuzzResult to the parent through a pipe.
+void RunWorkerProcesses(
+    int64_t worker_count,
+    absl::FunctionRef<absl::StatusOr<FuzzResult>(int64_t)> run_worker,
+    std::vector<absl::StatusOr<FuzzResult>>& worker_status) {
+  struct WorkerProcess {
+    pid_t pid;
+    int result_fd;
+  };
+  std::vector<std::optional<WorkerProcess>> processes(worker_count);
+  for (int64_t i = 0; i < worker_count; ++i) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+      worker_status[i] = absl::InternalError(
+          absl::StrCat("Failed to create worker pipe: ", Strerror(errno)));
+      continue;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+      worker_status[i] = absl::InternalError(
+          absl::StrCat("Failed to fork worker: ", Strerror(errno)));
+      close(fds[0]);
+      close(fds[1]);
+      continue;
+    }
+    if (pid == 0) {
+      close(fds[0]);
+      absl::StatusOr<FuzzResult> result = run_worker(i);
+      if (!result.ok()) {
+        LOG(ERROR) << kRedText << "-- Worker #" << i
+                   << " failed: " << result.status() << kDefaultColor;
+        _exit(1);
+      }
+      std::array<int64_t, 3> fields = {result->samples_generated,
+                                       result->samples_skipped,
+                                       result->crashers};
+      _exit(WriteFully(fds[1], reinterpret_cast<const char*>(fields.data()),
+                       sizeof(fields))
+                ? 0
+                : 1);
+    }
+    close(fds[1]);
+    processes[i] = WorkerProcess{.pid = pid, .result_fd = fds[0]};
+  }
+
+  for (int64_t i = 0; i < worker_count; ++i) {
+    if (!processes[i].has_value()) {
+      continue;
+    }
+    LOG(INFO) << "-- Waiting on worker " << i;
+    std::array<int64_t, 3> fields;
+    bool have_result =
+        ReadFully(processes[i]->result_fd,
+                  reinterpret_cast<char*>(fields.data()), sizeof(fields));
+    close(processes[i]->result_fd);
+    int wait_status;
+    while (waitpid(processes[i]->pid, &wait_status, 0) < 0 && errno == EINTR) {
+    }
+    if (WIFSIGNALED(wait_status)) {
+      worker_status[i] = absl::InternalError(
+          absl::StrFormat("worker process terminated by signal %d (%s)",
+                          WTERMSIG(wait_status),
+                          strsignal(WTERMSIG(wait_status))));
+    } else if (!have_result || WEXITSTATUS(wait_status) != 0) {
+      worker_status[i] = absl::InternalError(absl::StrFormat(
+          "worker process exited with status %d", WEXITSTATUS(wait_status)));
+    } else {
+      worker_status[i] = FuzzResult{
+          .samples_generated = fields[0],
+          .samples_skipped = fields[1],
+          .crashers = fields[2],
+      };
+    }
+  }
+}
+
 }  // namespace
 
 absl::Status ParallelGenerateAndRunSamples(
@@ -181,31 +302,40 @@ absl::Status ParallelGenerateAndRunSamples(
     const std::optional<std::filesystem::path>& crasher_dir,
     const std::optional<std::filesystem::path>& summary_dir,
     std::optional<int64_t> sample_count, std::optional<absl::Duration> duration,
-    bool force_failure) {
-  std::vector<std::unique_ptr<Thread>> workers;
-  workers.resize(worker_count);
+    bool force_failure, SampleRunner::ExecutionMode execution_mode) {
+  Stopwatch stopwatch;
   std::vector<absl::StatusOr<FuzzResult>> worker_status;
-  worker_status.resize(workers.size(),
+  worker_status.resize(worker_count,
                        absl::InternalError("worker did not terminate."));
-  for (int64_t i = 0; i < workers.size(); ++i) {
+  auto run_worker = [&](int64_t i) {
     std::optional<int64_t> worker_sample_count =
         sample_count.has_value()
             ? std::make_optional((*sample_count + i) / worker_count)
             : std::nullopt;
-    workers[i] = std::make_unique<Thread>([&, i, worker_sample_count,
-                                           status = &worker_status[i]] {
-      *status =
-          GenerateAndRunSamples(i, ast_generator_options, sample_options, seed,
-                                top_run_dir, crasher_dir, summary_dir,
-                                worker_sample_count, duration, force_failure);
-    });
+    return GenerateAndRunSamples(i, ast_generator_options, sample_options,
+                                 seed, top_run_dir, crasher_dir, summary_dir,
+                                 worker_sample_count, duration, force_failure,
+                                 execution_mode);
+  };
+
+  if (execution_mode == SampleRunner::ExecutionMode::kInProcess) {
+    RunWorkerProcesses(worker_count, run_worker, worker_status);
+  } else {
+    std::vector<std::unique_ptr<Thread>> workers;
+    workers.resize(worker_count);
+    for (int64_t i = 0; i < workers.size(); ++i) {
+      workers[i] = std::make_unique<Thread>(
+          [&, i, status = &worker_status[i]] { *status = run_worker(i); });
+    }
+    for (int64_t i = 0; i < workers.size(); ++i) {
+      LOG(INFO) << "-- Waiting on worker " << i;
+      workers[i]->Join();
+    }
   }
 
   FuzzResult total{};
 
-  for (int64_t i = 0; i < workers.size(); ++i) {
-    LOG(INFO) << "-- Waiting on worker " << i;
-    workers[i]->Join();
+  for (int64_t i = 0; i < worker_status.size(); ++i) {
     if (worker_status[i].ok()) {
       total.samples_generated += worker_status[i]->samples_generated;
       total.samples_skipped += worker_status[i]->samples_skipped;
@@ -216,13 +346,17 @@ absl::Status ParallelGenerateAndRunSamples(
     }
   }
 
+  absl::Duration elapsed = stopwatch.GetElapsedTime();
   LOG(INFO) << absl::StreamFormat(
       "Multiprocess Fuzzer finished! Total: %d samples; %d skipped; %d "
-      "crashes; Sample skip rate: %.4f%%.",
+      "crashes; Sample skip rate: %.4f%%; %.2f samples/s; ran for %s.",
 
       total.samples_generated, total.samples_skipped, total.crashers,
       static_cast<double>(total.samples_skipped * 100) /
-          static_cast<double>(total.samples_generated));
+          static_cast<double>(total.samples_generated),
+      static_cast<double>(total.samples_generated) /
+          absl::ToDoubleSeconds(elapsed),
+      absl::FormatDuration(elapsed));
 
   return absl::OkStatus();
 }
@@ -23,10 +23,11 @@
 #include "absl/time/time.h"
 #include "xls/fuzzer/ast_generator.h"
 #include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_runner.h"
 
 namespace xls {
 
-// Generate and run fuzzer samples on `worker_count` threads; runs up to
+// Generate and run fuzzer samples on `worker_count` workers; runs up to
 // `sample_count` samples (unbounded if unspecified) for up to `duration` time.
 //
 // Generates samples according to `ast_generator_options`, and runs them
@@ -37,6 +38,11 @@ namespace xls {
 //
 // If `force_failure` is true, every sample run will be considered a failure.
 // This is useful for testing failure paths.
+//
+// With `SampleRunner::ExecutionMode::kInProcess`, workers are forked processes
+// rather than threads and each sample is run in-process in a child forked from
+// its worker, so a crashing sample is recorded as a crasher without taking
+// down the fuzzer.
 absl::Status ParallelGenerateAndRunSamples(
     int64_t worker_count,
     const dslx::AstGeneratorOptions& ast_generator_options,
@@ -47,7 +53,9 @@ absl::Status ParallelGenerateAndRunSamples(
     const std::optional<std::filesystem::path>& summary_dir = std::nullopt,
     std::optional<int64_t> sample_count = std::nullopt,
     std::optional<absl::Duration> duration = std::nullopt,
-    bool force_failure = false);
+    bool force_failure = false,
+    SampleRunner::ExecutionMode execution_mode =
+        SampleRunner::ExecutionMode::kSubprocess);
 
 }  // namespace xls
 
@@ -62,6 +62,40 @@ class RunFuzzMultiprocessTest(test_base.TestCase):
     self.assertNotIn('sample.v', sample1_contents)
     self.assertNotIn('sample.sv', sample1_contents)
 
+  def test_in_process(self):
+    crasher_path = self.create_tempdir().full_path
+    samples_path = self.create_tempdir().full_path
+
+    output = subprocess.run(
+        [
+            RUN_FUZZ_MULTIPROCESS_PATH,
+            '--seed=42',
+            '--crash_path=' + crasher_path,
+            '--save_temps_path=' + samples_path,
+            '--sample_count=4',
+            '--calls_per_sample=3',
+            '--worker_count=2',
+            '--in_process',
+            '--logtostderr',
+        ],
+        check=True,
+        stderr=subprocess.PIPE,
+        encoding='utf-8',
+    )
+    self.assertIn('samples/s', output.stderr)
+
+    # Crasher path should contain a single file 'test'.
+    self.assertSequenceEqual(os.listdir(crasher_path), ('test',))
+
+    sample_dirs = os.listdir(samples_path)
+    self.assertLen(sample_dirs, 4)
+    for sample_dir in sample_dirs:
+      sample_contents = os.listdir(os.path.join(samples_path, sample_dir))
+      self.assertIn('sample.ir', sample_contents)
+      self.assertIn('sample.ir.results', sample_contents)
+      self.assertIn('sample.opt.ir', sample_contents)
+      self.assertIn('sample.opt.ir.results', sample_contents)
+
   def test_multiple_workers(self):
     crasher_path = self.create_tempdir().full_path
     samples_path = self.create_tempdir().full_path
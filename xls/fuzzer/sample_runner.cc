@@ -24,6 +24,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -43,6 +44,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xls/common/file/filesystem.h"
@@ -59,11 +61,15 @@
 #include "xls/dslx/bytecode/proc_hierarchy_interpreter.h"
 #include "xls/dslx/channel_direction.h"
 #include "xls/dslx/create_import_data.h"
+#include "xls/dslx/default_dslx_stdlib_path.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/module.h"
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/interp_value.h"
 #include "xls/dslx/interp_value_utils.h"
+#include "xls/dslx/ir_convert/conversion_info.h"
+#include "xls/dslx/ir_convert/convert_options.h"
+#include "xls/dslx/ir_convert/ir_converter.h"
 #include "xls/dslx/parse_and_typecheck.h"
 #include "xls/dslx/type_system/type.h"
 #include "xls/dslx/type_system/type_info.h"
@@ -72,13 +78,20 @@
 #include "xls/fuzzer/cpp_sample_runner.h"
 #include "xls/fuzzer/sample.h"
 #include "xls/fuzzer/sample.pb.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/clone_package.h"
+#include "xls/ir/events.h"
 #include "xls/ir/format_preference.h"
+#include "xls/ir/function.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
 #include "xls/ir/value.h"
+#include "xls/jit/function_jit.h"
 #include "xls/public/runtime_build_actions.h"
 #include "xls/simulation/check_simulator.h"
 #include "xls/tests/testvector.pb.h"
 #include "xls/tools/eval_utils.h"
+#include "xls/tools/opt.h"
 #include "re2/re2.h"
 
 // These are used to forward, but also see comment below.
@@ -411,6 +424,117 @@ absl::StatusOr<std::filesystem::path> OptimizeIr(
   return opt_ir_path;
 }
 
+// Converts the DSLX file to an IR package within this process, writing the
+// IR to `run_dir` for replay. Only the `--top` converter flag is supported
+// in-process; samples with other converter flags fall back to the
+// ir_converter_main subprocess and the resulting IR is parsed.
+absl::StatusOr<std::unique_ptr<Package>> DslxToIrPackage(
+    const std::filesystem::path& input_path, const SampleOptions& options,
+    const std::filesystem::path& run_dir,
+    const SampleRunner::Commands& commands) {
+  std::optional<std::string> top;
+  bool in_process = !commands.ir_converter_main.has_value();
+  for (std::string_view arg : options.ir_converter_args()) {
+    if (absl::ConsumePrefix(&arg, "--top=")) {
+      top = std::string(arg);
+    } else {
+      in_process = false;
+    }
+  }
+  if (!in_process) {
+    XLS_ASSIGN_OR_RETURN(
+        std::filesystem::path ir_path,
+        DslxToIrFunction(input_path, options, run_dir, commands));
+    XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_path));
+    return Parser::ParsePackage(ir_text, ir_path.string());
+  }
+
+  VLOG(1) << "Converting DSLX to IR in-process";
+  Stopwatch timer;
+  const std::string input_path_str = input_path.string();
+  bool printed_error = false;
+  XLS_ASSIGN_OR_RETURN(
+      dslx::PackageConversionData conversion,
+      dslx::ConvertFilesToPackage(
+          {input_path_str}, kDefaultDslxStdlibPath,
+          /*dslx_paths=*/{}, dslx::ConvertOptions{.warnings_as_errors = false},
+          top, /*package_name=*/std::nullopt, &printed_error));
+  if (printed_error) {
+    return absl::InternalError(
+        "IR conversion failed with an earlier non-fatal error.");
+  }
+  VLOG(1) << "Converting DSLX to IR complete, elapsed "
+          << timer.GetElapsedTime();
+  std::string ir_text = conversion.DumpIr();
+  VLOG(3) << "Unoptimized IR:\n" << ir_text;
+  XLS_RETURN_IF_ERROR(SetFileContents(run_dir / "sample.ir", ir_text));
+  return std::move(conversion.package);
+}
+
+// Evaluates the top function of the package on each argument set within this
+// process and returns the result Values. When using the JIT, the function is
+// compiled once and the runtime is reused for every argument set; nothing is
+// reused across samples, which each have their own function and, when run by
+// run_fuzz, their own forked process. The results are written next to
+// `ir_path` as `eval_ir_main` would.
+absl::StatusOr<std::vector<dslx::InterpValue>> EvaluateIrFunctionInProcess(
+    Package* package, const std::filesystem::path& ir_path,
+    const ArgsBatch& args_batch, bool use_jit) {
+  XLS_ASSIGN_OR_RETURN(Function * f, package->GetTopAsFunction());
+  VLOG(1) << absl::StreamFormat("Evaluating IR in-process (%s): %s",
+                                (use_jit ? "JIT" : "interpreter"), ir_path);
+  Stopwatch timer;
+  std::unique_ptr<FunctionJit> jit;
+  if (use_jit) {
+    XLS_ASSIGN_OR_RETURN(jit, FunctionJit::Create(f));
+  }
+
+  std::vector<dslx::InterpValue> results;
+  results.reserve(args_batch.size());
+  std::string results_text;
+  std::vector<Value> ir_args;
+  for (const std::vector<dslx::InterpValue>& args : args_batch) {
+    ir_args.clear();
+    for (const dslx::InterpValue& arg : args) {
+      XLS_ASSIGN_OR_RETURN(ir_args.emplace_back(), arg.ConvertToIr());
+    }
+    Value result;
+    if (use_jit) {
+      XLS_ASSIGN_OR_RETURN(result, DropInterpreterEvents(jit->Run(ir_args)));
+    } else {
+      XLS_ASSIGN_OR_RETURN(
+          result, DropInterpreterEvents(InterpretFunction(f, ir_args)));
+    }
+    absl::StrAppend(&results_text, result.ToString(FormatPreference::kHex),
+                    "\n");
+    XLS_ASSIGN_OR_RETURN(results.emplace_back(),
+                         dslx::ValueToInterpValue(result));
+  }
+  VLOG(1) << "Evaluating IR complete, elapsed " << timer.GetElapsedTime();
+  XLS_RETURN_IF_ERROR(SetFileContents(
+      absl::StrCat(ir_path.string(), ".results"), results_text));
+  return results;
+}
+
+// Optimizes a copy of the package within this process, writing the optimized
+// IR to `run_dir` for replay and for the codegen stages. Returns the optimized
+// package and the path of the written IR.
+absl::StatusOr<std::pair<std::unique_ptr<Package>, std::filesystem::path>>
+OptimizeIrInProcess(Package* package, const std::filesystem::path& run_dir) {
+  VLOG(1) << "Optimizing IR in-process";
+  Stopwatch timer;
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> opt_package,
+                       ClonePackage(package));
+  XLS_RETURN_IF_ERROR(
+      tools::OptimizeIrForTop(opt_package.get(), tools::OptOptions()));
+  VLOG(1) << "Optimizing IR complete, elapsed " << timer.GetElapsedTime();
+  std::string opt_ir_text = opt_package->DumpIr();
+  VLOG(3) << "Optimized IR:\n" << opt_ir_text;
+  std::filesystem::path opt_ir_path = run_dir / "sample.opt.ir";
+  XLS_RETURN_IF_ERROR(SetFileContents(opt_ir_path, opt_ir_text));
+  return std::make_pair(std::move(opt_package), std::move(opt_ir_path));
+}
+
 // Simulates the Verilog file representing a function and returns the results.
 absl::StatusOr<std::vector<dslx::InterpValue>> SimulateFunction(
     const std::filesystem::path& verilog_path,
@@ -857,6 +981,22 @@ absl::Status SampleRunner::RunFunction(
   // Results from various ways of interpretation.
   absl::flat_hash_map<std::string, std::vector<dslx::InterpValue>> results;
 
+  // In-process execution passes these packages between stages instead of
+  // re-parsing the IR files.
+  const bool in_process = execution_mode_ == ExecutionMode::kInProcess;
+  std::unique_ptr<Package> package;
+  std::unique_ptr<Package> opt_package;
+  auto evaluate_ir = [&](Package* ir_package, const std::filesystem::path& path,
+                         bool use_jit)
+      -> absl::StatusOr<std::vector<dslx::InterpValue>> {
+    if (ir_package != nullptr && !commands_.eval_ir_main.has_value()) {
+      return EvaluateIrFunctionInProcess(ir_package, path, *args_batch,
+                                         use_jit);
+    }
+    return EvaluateIrFunction(path, testvector_path, use_jit, options,
+                              run_dir_, commands_);
+  };
+
   std::filesystem::path ir_path;
   if (options.input_is_dslx()) {
     if (args_batch.has_value()) {
@@ -875,12 +1015,22 @@ absl::Status SampleRunner::RunFunction(
     }
 
     Stopwatch t;
-    XLS_ASSIGN_OR_RETURN(
-        ir_path, DslxToIrFunction(input_path, options, run_dir_, commands_));
+    if (in_process) {
+      ir_path = run_dir_ / "sample.ir";
+      XLS_ASSIGN_OR_RETURN(package, DslxToIrPackage(input_path, options,
+                                                    run_dir_, commands_));
+    } else {
+      XLS_ASSIGN_OR_RETURN(
+          ir_path, DslxToIrFunction(input_path, options, run_dir_, commands_));
+    }
     timing_.set_convert_ir_ns(absl::ToInt64Nanoseconds(t.GetElapsedTime()));
   } else {
     ir_path = run_dir_ / "sample.ir";
     XLS_RETURN_IF_ERROR(SetFileContents(ir_path, input_text));
+    if (in_process) {
+      XLS_ASSIGN_OR_RETURN(package,
+                           Parser::ParsePackage(input_text, ir_path.string()));
+    }
   }
 
   if (args_batch.has_value()) {
@@ -889,15 +1039,13 @@ absl::Status SampleRunner::RunFunction(
     // Unconditionally evaluate with the interpreter even if using the JIT. This
     // exercises the interpreter and serves as a reference.
     XLS_ASSIGN_OR_RETURN(results["evaluated unopt IR (interpreter)"],
-                         EvaluateIrFunction(ir_path, testvector_path, false,
-                                            options, run_dir_, commands_));
+                         evaluate_ir(package.get(), ir_path, false));
     timing_.set_unoptimized_interpret_ir_ns(
         absl::ToInt64Nanoseconds(t.GetElapsedTime()));
 
     if (options.use_jit()) {
       XLS_ASSIGN_OR_RETURN(results["evaluated unopt IR (JIT)"],
-                           EvaluateIrFunction(ir_path, testvector_path, true,
-                                              options, run_dir_, commands_));
+                           evaluate_ir(package.get(), ir_path, true));
       timing_.set_unoptimized_jit_ns(
           absl::ToInt64Nanoseconds(t.GetElapsedTime()));
     }
@@ -905,25 +1053,27 @@ absl::Status SampleRunner::RunFunction(
 
   if (options.optimize_ir()) {
     Stopwatch t;
-    XLS_ASSIGN_OR_RETURN(std::filesystem::path opt_ir_path,
-                         OptimizeIr(ir_path, options, run_dir_, commands_));
+    std::filesystem::path opt_ir_path;
+    if (package != nullptr && !commands_.ir_opt_main.has_value()) {
+      XLS_ASSIGN_OR_RETURN(std::tie(opt_package, opt_ir_path),
+                           OptimizeIrInProcess(package.get(), run_dir_));
+    } else {
+      XLS_ASSIGN_OR_RETURN(opt_ir_path,
+                           OptimizeIr(ir_path, options, run_dir_, commands_));
+    }
     timing_.set_optimize_ns(absl::ToInt64Nanoseconds(t.GetElapsedTime()));
 
     if (args_batch.has_value()) {
       if (options.use_jit()) {
         t.Reset();
-        XLS_ASSIGN_OR_RETURN(
-            results["evaluated opt IR (JIT)"],
-            EvaluateIrFunction(opt_ir_path, testvector_path, true, options,
-                               run_dir_, commands_));
+        XLS_ASSIGN_OR_RETURN(results["evaluated opt IR (JIT)"],
+                             evaluate_ir(opt_package.get(), opt_ir_path, true));
         timing_.set_optimized_jit_ns(
             absl::ToInt64Nanoseconds(t.GetElapsedTime()));
       }
       t.Reset();
-      XLS_ASSIGN_OR_RETURN(
-          results["evaluated opt IR (interpreter)"],
-          EvaluateIrFunction(opt_ir_path, testvector_path, false, options,
-                             run_dir_, commands_));
+      XLS_ASSIGN_OR_RETURN(results["evaluated opt IR (interpreter)"],
+                           evaluate_ir(opt_package.get(), opt_ir_path, false));
       timing_.set_optimized_interpret_ir_ns(
           absl::ToInt64Nanoseconds(t.GetElapsedTime()));
     }
@@ -15,6 +15,7 @@
 #ifndef XLS_FUZZER_SAMPLE_RUNNER_H_
 #define XLS_FUZZER_SAMPLE_RUNNER_H_
 
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <functional>
 #include <optional>
@@ -65,8 +66,23 @@ class SampleRunner {
     std::optional<Callable> simulate_module_main;
   };
 
-  explicit SampleRunner(std::filesystem::path run_dir)
-      : run_dir_(std::move(run_dir)) {}
+  // How the stages of a sample are executed.
+  enum class ExecutionMode : std::uint8_t {
+    // Each stage invokes a tool binary (or the corresponding `Commands`
+    // override) and stages communicate through IR text files in `run_dir`.
+    kSubprocess,
+    // DSLX conversion, IR evaluation and optimization of function samples run
+    // within this process on a single in-memory package; a JIT is created once
+    // per evaluated function and reused for every argument set. Intermediate
+    // files are still written to `run_dir` for replay. Codegen, simulation and
+    // proc samples use subprocesses as in `kSubprocess`.
+    kInProcess,
+  };
+
+  explicit SampleRunner(
+      std::filesystem::path run_dir,
+      ExecutionMode execution_mode = ExecutionMode::kSubprocess)
+      : run_dir_(std::move(run_dir)), execution_mode_(execution_mode) {}
   SampleRunner(std::filesystem::path run_dir, Commands commands)
       : run_dir_(std::move(run_dir)), commands_(std::move(commands)) {}
 
@@ -95,6 +111,7 @@ class SampleRunner {
 
   const std::filesystem::path run_dir_;
   const Commands commands_;
+  const ExecutionMode execution_mode_ = ExecutionMode::kSubprocess;
   fuzzer::SampleTimingProto timing_;
 };
 
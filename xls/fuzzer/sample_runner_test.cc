@@ -539,6 +539,55 @@ TEST_F(SampleRunnerTest, InterpretOptIR) {
               ElementsAre("bits[8]:0x8e"));
 }
 
+TEST_F(SampleRunnerTest, InProcessInterpretOptIR) {
+  SampleRunner runner(GetTempPath(), SampleRunner::ExecutionMode::kInProcess);
+  constexpr std::string_view dslx_text =
+      "fn main(x: u8, y: u8) -> u8 { x + y }";
+  SampleOptions options;
+  options.set_input_is_dslx(true);
+  options.set_ir_converter_args({"--top=main"});
+  options.set_use_jit(true);
+  XLS_ASSERT_OK_AND_ASSIGN(ArgsBatch args_batch,
+                           ToArgsBatch({{"bits[8]:42", "bits[8]:100"},
+                                        {"bits[8]:222", "bits[8]:240"}}));
+  XLS_ASSERT_OK(
+      runner.Run(Sample(std::string(dslx_text), options, args_batch)));
+  EXPECT_THAT(GetFileContents(GetTempPath() / "sample.ir"),
+              IsOkAndHolds(HasSubstr("package sample")));
+  EXPECT_THAT(GetFileContents(GetTempPath() / "sample.opt.ir"),
+              IsOkAndHolds(HasSubstr("package sample")));
+  for (std::string_view results_file :
+       {"sample.ir.results", "sample.opt.ir.results"}) {
+    XLS_ASSERT_OK_AND_ASSIGN(std::string results,
+                             GetFileContents(GetTempPath() / results_file));
+    EXPECT_THAT(absl::StrSplit(absl::StripAsciiWhitespace(results), "\n",
+                               absl::SkipEmpty()),
+                ElementsAre("bits[8]:0x8e", "bits[8]:0xce"));
+  }
+}
+
+TEST_F(SampleRunnerTest, InProcessIRInput) {
+  SampleRunner runner(GetTempPath(), SampleRunner::ExecutionMode::kInProcess);
+  constexpr std::string_view ir_text = R"(
+package foo
+
+top fn foo(x: bits[8], y: bits[8]) -> bits[8] {
+  ret add.1: bits[8] = add(x, y)
+}
+)";
+  SampleOptions options;
+  options.set_input_is_dslx(false);
+  XLS_ASSERT_OK_AND_ASSIGN(ArgsBatch args_batch,
+                           ToArgsBatch({{"bits[8]:42", "bits[8]:100"}}));
+  XLS_ASSERT_OK(runner.Run(Sample(std::string(ir_text), options, args_batch)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string opt_results,
+      GetFileContents(GetTempPath() / "sample.opt.ir.results"));
+  EXPECT_THAT(absl::StrSplit(absl::StripAsciiWhitespace(opt_results), "\n",
+                             absl::SkipEmpty()),
+              ElementsAre("bits[8]:0x8e"));
+}
+
 TEST_F(SampleRunnerTest, InterpretOptIRMiscompare) {
   SampleRunner runner(
       GetTempPath(),
@@ -15,6 +15,7 @@
 #include "xls/interpreter/function_interpreter.h"
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
@@ -22,16 +23,20 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/interpreter/ir_interpreter.h"
 #include "xls/interpreter/observer.h"
 #include "xls/ir/events.h"
 #include "xls/ir/keyword_args.h"
+#include "xls/ir/node.h"
 #include "xls/ir/nodes.h"
+#include "xls/ir/topo_sort.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
 
@@ -61,12 +66,25 @@ class FunctionInterpreter final : public IrInterpreter {
   std::vector<Value> args_;
 };
 
-}  // namespace
+// An interpreter for XLS functions which holds node values in dense slots.
+class SlotFunctionInterpreter final : public IrInterpreter {
+ public:
+  SlotFunctionInterpreter(absl::Span<const Value> args, NodeValueSlots& slots,
+                          std::optional<EvaluationObserver*> observer)
+      : IrInterpreter(slots, observer), args_(args) {}
 
-absl::StatusOr<InterpreterResult<Value>> InterpretFunction(
-    Function* function, absl::Span<const Value> args,
-    std::optional<EvaluationObserver*> observer) {
-  VLOG(3) << "Interpreting function " << function->name();
+  absl::Status HandleParam(Param* param) override {
+    XLS_ASSIGN_OR_RETURN(int64_t index,
+                         param->function_base()->GetParamIndex(param));
+    XLS_RET_CHECK_LT(index, args_.size());
+    return SetValueResult(param, args_[index]);
+  }
+
+ private:
+  absl::Span<const Value> args_;
+};
+
+absl::Status CheckArgs(Function* function, absl::Span<const Value> args) {
   if (args.size() != function->params().size()) {
     return absl::InvalidArgumentError(absl::StrFormat(
         "Function `%s` (type: `%s`) wants %d arguments, got %d.",
@@ -84,6 +102,16 @@ absl::StatusOr<InterpreterResult<Value>> InterpretFunction(
           value.ToString(), argno, param_type->ToString()));
     }
   }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<InterpreterResult<Value>> InterpretFunction(
+    Function* function, absl::Span<const Value> args,
+    std::optional<EvaluationObserver*> observer) {
+  VLOG(3) << "Interpreting function " << function->name();
+  XLS_RETURN_IF_ERROR(CheckArgs(function, args));
   FunctionInterpreter visitor(args, observer);
   XLS_RETURN_IF_ERROR(function->Accept(&visitor));
   Value result = visitor.ResolveAsValue(function->return_value());
@@ -101,4 +129,45 @@ absl::StatusOr<InterpreterResult<Value>> InterpretFunction(
   return InterpretFunction(function, positional_args, observer);
 }
 
+/* static */ absl::StatusOr<std::unique_ptr<CompiledFunctionInterpreter>>
+CompiledFunctionInterpreter::Create(Function* function) {
+  return absl::WrapUnique(
+      new CompiledFunctionInterpreter(function, TopoSort(function)));
+}
+
+CompiledFunctionInterpreter::CompiledFunctionInterpreter(
+    Function* function, std::vector<Node*> topo_order)
+    : function_(function),
+      node_count_(function->node_count()),
+      topo_order_(std::move(topo_order)),
+      slots_(topo_order_) {}
+
+absl::StatusOr<InterpreterResult<Value>> CompiledFunctionInterpreter::Run(
+    absl::Span<const Value> args, std::optional<EvaluationObserver*> observer) {
+  VLOG(3) << "Interpreting compiled function " << function_->name();
+  XLS_RET_CHECK_EQ(function_->node_count(), node_count_)
+      << "Function " << function_->name()
+      << " was modified after the interpreter was created";
+  XLS_RETURN_IF_ERROR(CheckArgs(function_, args));
+  slots_.Clear();
+  SlotFunctionInterpreter visitor(args, slots_, observer);
+  for (Node* node : topo_order_) {
+    XLS_RETURN_IF_ERROR(node->VisitSingleNode(&visitor));
+  }
+  // Copy the result out of the slots as they are reused by the next run.
+  Value result = visitor.ResolveAsValue(function_->return_value());
+  VLOG(2) << "Result = " << result;
+  return InterpreterResult<Value>{std::move(result),
+                                  std::move(visitor.GetInterpreterEvents())};
+}
+
+absl::StatusOr<InterpreterResult<Value>>
+CompiledFunctionInterpreter::RunWithKwargs(
+    const absl::flat_hash_map<std::string, Value>& args,
+    std::optional<EvaluationObserver*> observer) {
+  XLS_ASSIGN_OR_RETURN(std::vector<Value> positional_args,
+                       KeywordArgsToPositional(*function_, args));
+  return Run(positional_args, observer);
+}
+
 }  // namespace xls
@@ -15,15 +15,20 @@
 #ifndef XLS_INTERPRETER_FUNCTION_INTERPRETER_H_
 #define XLS_INTERPRETER_FUNCTION_INTERPRETER_H_
 
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
+#include "xls/interpreter/ir_interpreter.h"
 #include "xls/interpreter/observer.h"
 #include "xls/ir/events.h"
 #include "xls/ir/function.h"
+#include "xls/ir/node.h"
 #include "xls/ir/value.h"
 
 namespace xls {
@@ -41,6 +46,43 @@ absl::StatusOr<InterpreterResult<Value>> InterpretFunctionKwargs(
     Function* function, const absl::flat_hash_map<std::string, Value>& args,
     std::optional<EvaluationObserver*> observer = std::nullopt);
 
+// An interpreter for repeatedly evaluating a single function. The topological
+// order of the function is computed once at creation and each node is assigned
+// a dense slot in a flat value array, so evaluation requires neither a graph
+// traversal nor hashing of nodes. The slot storage is reused across calls to
+// `Run`.
+//
+// The function must not be modified after the interpreter is created. Not
+// thread-safe.
+class CompiledFunctionInterpreter {
+ public:
+  static absl::StatusOr<std::unique_ptr<CompiledFunctionInterpreter>> Create(
+      Function* function);
+
+  // Evaluates the function with the given positional arguments.
+  absl::StatusOr<InterpreterResult<Value>> Run(
+      absl::Span<const Value> args,
+      std::optional<EvaluationObserver*> observer = std::nullopt);
+
+  // As above with the arguments given by name.
+  absl::StatusOr<InterpreterResult<Value>> RunWithKwargs(
+      const absl::flat_hash_map<std::string, Value>& args,
+      std::optional<EvaluationObserver*> observer = std::nullopt);
+
+  Function* function() const { return function_; }
+
+ private:
+  CompiledFunctionInterpreter(Function* function,
+                              std::vector<Node*> topo_order);
+
+  Function* function_;
+  // The number of nodes in the function at creation, used to detect
+  // modifications of the function.
+  int64_t node_count_;
+  std::vector<Node*> topo_order_;
+  NodeValueSlots slots_;
+};
+
 }  // namespace xls
 
 #endif  // XLS_INTERPRETER_FUNCTION_INTERPRETER_H_
@@ -14,17 +14,22 @@
 
 #include "xls/interpreter/interpreter_proc_runtime.h"
 
+#include <cstdint>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/parallel_proc_runtime.h"
 #include "xls/interpreter/proc_evaluator.h"
 #include "xls/interpreter/proc_interpreter.h"
+#include "xls/interpreter/proc_runtime.h"
 #include "xls/interpreter/serial_proc_runtime.h"
+#include "xls/ir/channel.h"
 #include "xls/ir/package.h"
 #include "xls/ir/proc_elaboration.h"
 #include "xls/ir/value.h"
@@ -32,6 +37,32 @@
 namespace xls {
 namespace {
 
+// Creates a ProcInterpreter for each proc in the elaboration of the given
+// queue manager.
+std::vector<std::unique_ptr<ProcEvaluator>> CreateProcInterpreters(
+    ChannelQueueManager* queue_manager) {
+  std::vector<std::unique_ptr<ProcEvaluator>> proc_interpreters;
+  for (Proc* proc : queue_manager->elaboration().procs()) {
+    proc_interpreters.push_back(
+        std::make_unique<ProcInterpreter>(proc, queue_manager));
+  }
+  return proc_interpreters;
+}
+
+// Inject initial values into channel queues.
+absl::Status InsertInitialChannelValues(ProcRuntime* proc_runtime) {
+  for (ChannelInstance* channel_instance :
+       proc_runtime->elaboration().channel_instances()) {
+    Channel* channel = channel_instance->channel;
+    ChannelQueue& queue =
+        proc_runtime->queue_manager().GetQueue(channel_instance);
+    for (const Value& value : channel->initial_values()) {
+      XLS_RETURN_IF_ERROR(queue.Write(value));
+    }
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateRuntime(
     ProcElaboration elaboration, const EvaluatorOptions& options) {
   // Create a queue manager for the queues. This factory verifies that there an
@@ -40,11 +71,8 @@ absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateRuntime(
                        ChannelQueueManager::Create(std::move(elaboration)));
 
   // Create a ProcInterpreter for each Proc.
-  std::vector<std::unique_ptr<ProcEvaluator>> proc_interpreters;
-  for (Proc* proc : queue_manager->elaboration().procs()) {
-    proc_interpreters.push_back(
-        std::make_unique<ProcInterpreter>(proc, queue_manager.get()));
-  }
+  std::vector<std::unique_ptr<ProcEvaluator>> proc_interpreters =
+      CreateProcInterpreters(queue_manager.get());
 
   // Create a runtime.
   XLS_ASSIGN_OR_RETURN(
@@ -52,17 +80,23 @@ absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateRuntime(
       SerialProcRuntime::Create(std::move(proc_interpreters),
                                 std::move(queue_manager), options));
 
-  // Inject initial values into channel queues.
-  for (ChannelInstance* channel_instance :
-       proc_runtime->elaboration().channel_instances()) {
-    Channel* channel = channel_instance->channel;
-    ChannelQueue& queue =
-        proc_runtime->queue_manager().GetQueue(channel_instance);
-    for (const Value& value : channel->initial_values()) {
-      XLS_RETURN_IF_ERROR(queue.Write(value));
-    }
-  }
+  XLS_RETURN_IF_ERROR(InsertInitialChannelValues(proc_runtime.get()));
+  return proc_runtime;
+}
 
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>> CreateParallelRuntime(
+    ProcElaboration elaboration, const EvaluatorOptions& options,
+    int64_t thread_count) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<ChannelQueueManager> queue_manager,
+                       ChannelQueueManager::Create(std::move(elaboration)));
+  std::vector<std::unique_ptr<ProcEvaluator>> proc_interpreters =
+      CreateProcInterpreters(queue_manager.get());
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<ParallelProcRuntime> proc_runtime,
+      ParallelProcRuntime::Create(std::move(proc_interpreters),
+                                  std::move(queue_manager), options,
+                                  thread_count));
+  XLS_RETURN_IF_ERROR(InsertInitialChannelValues(proc_runtime.get()));
   return proc_runtime;
 }
 
@@ -83,4 +117,21 @@ CreateInterpreterSerialProcRuntime(Proc* top, const EvaluatorOptions& options) {
   return CreateRuntime(std::move(elaboration), options);
 }
 
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+CreateInterpreterParallelProcRuntime(Package* package,
+                                     const EvaluatorOptions& options,
+                                     int64_t thread_count) {
+  XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
+                       ProcElaboration::ElaborateOldStylePackage(package));
+  return CreateParallelRuntime(std::move(elaboration), options, thread_count);
+}
+
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+CreateInterpreterParallelProcRuntime(Proc* top, const EvaluatorOptions& options,
+                                     int64_t thread_count) {
+  XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
+                       ProcElaboration::Elaborate(top));
+  return CreateParallelRuntime(std::move(elaboration), options, thread_count);
+}
+
 }  // namespace xls
@@ -15,10 +15,12 @@
 #ifndef XLS_INTERPRETER_INTERPRETER_PROC_RUNTIME_H_
 #define XLS_INTERPRETER_INTERPRETER_PROC_RUNTIME_H_
 
+#include <cstdint>
 #include <memory>
 
 #include "absl/status/statusor.h"
 #include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/parallel_proc_runtime.h"
 #include "xls/interpreter/serial_proc_runtime.h"
 #include "xls/ir/package.h"
 
@@ -36,6 +38,18 @@ absl::StatusOr<std::unique_ptr<SerialProcRuntime>>
 CreateInterpreterSerialProcRuntime(
     Proc* top, const EvaluatorOptions& options = EvaluatorOptions());
 
+// Creates a runtime which ticks the interpreted procs concurrently on
+// `thread_count` threads (zero means one per available CPU).
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+CreateInterpreterParallelProcRuntime(
+    Package* package, const EvaluatorOptions& options = EvaluatorOptions(),
+    int64_t thread_count = 0);
+
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+CreateInterpreterParallelProcRuntime(
+    Proc* top, const EvaluatorOptions& options = EvaluatorOptions(),
+    int64_t thread_count = 0);
+
 }  // namespace xls
 
 #endif  // XLS_INTERPRETER_INTERPRETER_PROC_RUNTIME_H_
@@ -65,6 +65,18 @@ uint64_t BitsToBoundedUint64(const Bits& bits, uint64_t upper_limit) {
 
 }  // namespace
 
+NodeValueSlots::NodeValueSlots(absl::Span<Node* const> nodes)
+    : values_(nodes.size()), generations_(nodes.size(), 0) {
+  int64_t max_id = -1;
+  for (Node* node : nodes) {
+    max_id = std::max(max_id, node->id());
+  }
+  slot_by_id_.resize(max_id + 1, -1);
+  for (int64_t i = 0; i < nodes.size(); ++i) {
+    slot_by_id_[nodes[i]->id()] = i;
+  }
+}
+
 absl::StatusOr<Value> InterpretNode(Node* node,
                                     absl::Span<const Value> operand_values) {
   // Gate nodes do not require side effects when interpreted.
@@ -840,11 +852,11 @@ absl::Status IrInterpreter::VerifyAllBitsTypes(Node* node) {
 }
 
 const Bits& IrInterpreter::ResolveAsBits(Node* node) {
-  return NodeValuesMap().at(node).bits();
+  return ResolveAsValue(node).bits();
 }
 
 bool IrInterpreter::ResolveAsBool(Node* node) {
-  const Bits& bits = NodeValuesMap().at(node).bits();
+  const Bits& bits = ResolveAsValue(node).bits();
   CHECK_EQ(bits.bit_count(), 1);
   return bits.IsAllOnes();
 }
@@ -878,7 +890,7 @@ absl::Status IrInterpreter::SetBitsResult(Node* node, const Bits& result) {
 absl::Status IrInterpreter::SetValueResult(Node* node, Value result) {
   if (VLOG_IS_ON(4) &&
       std::all_of(node->operands().begin(), node->operands().end(),
-                  [this](Node* o) { return NodeValuesMap().contains(o); })) {
+                  [this](Node* o) { return HasResult(o); })) {
     VLOG(4) << absl::StreamFormat("%s operands:", node->GetName());
     for (int64_t i = 0; i < node->operand_count(); ++i) {
       VLOG(4) << absl::StreamFormat(
@@ -889,7 +901,7 @@ absl::Status IrInterpreter::SetValueResult(Node* node, Value result) {
   VLOG(3) << absl::StreamFormat("Result of %s: %s", node->ToString(),
                                 result.ToString());
 
-  XLS_RET_CHECK(!NodeValuesMap().contains(node));
+  XLS_RET_CHECK(!HasResult(node));
   if (!ValueConformsToType(result, node->GetType())) {
     return absl::InternalError(absl::StrFormat(
         "Expected value %s to match type %s of node %s", result.ToString(),
@@ -898,7 +910,11 @@ absl::Status IrInterpreter::SetValueResult(Node* node, Value result) {
   if (observer_) {
     (*observer_)->NodeEvaluated(node, result);
   }
-  NodeValuesMap()[node] = std::move(result);
+  if (node_value_slots_ != nullptr) {
+    node_value_slots_->Set(node, std::move(result));
+  } else {
+    NodeValuesMap()[node] = std::move(result);
+  }
   return absl::OkStatus();
 }
 
@@ -17,9 +17,11 @@
 
 #include <cstdint>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
@@ -39,6 +41,60 @@ namespace xls {
 absl::StatusOr<Value> InterpretNode(Node* node,
                                     absl::Span<const Value> operand_values);
 
+// Flat storage for the values of a fixed set of nodes. Each node is assigned a
+// dense slot index at construction so reading and writing a value is an array
+// access rather than a hash lookup. Values are retained across calls to
+// `Clear` so that repeated evaluations of the same function reuse the slot
+// storage.
+class NodeValueSlots {
+ public:
+  explicit NodeValueSlots(absl::Span<Node* const> nodes);
+
+  // Returns the slot index of the given node. The node must be one of the nodes
+  // passed in at construction.
+  int64_t slot(Node* node) const {
+    DCHECK_LT(node->id(), slot_by_id_.size());
+    DCHECK_GE(slot_by_id_[node->id()], 0);
+    return slot_by_id_[node->id()];
+  }
+
+  // Returns true if the given node is one of the nodes passed in at
+  // construction.
+  bool Contains(Node* node) const {
+    return node->id() < slot_by_id_.size() && slot_by_id_[node->id()] >= 0;
+  }
+
+  bool HasValue(Node* node) const {
+    return generations_[slot(node)] == generation_;
+  }
+  const Value& Get(Node* node) const {
+    int64_t s = slot(node);
+    CHECK_EQ(generations_[s], generation_)
+        << "No value for node " << node->GetName();
+    return values_[s];
+  }
+  void Set(Node* node, Value value) {
+    int64_t s = slot(node);
+    values_[s] = std::move(value);
+    generations_[s] = generation_;
+  }
+
+  // Marks all slots as empty. This is constant time and does not release the
+  // storage of the previously held values.
+  void Clear() { ++generation_; }
+
+  int64_t size() const { return values_.size(); }
+
+ private:
+  // Slot index of each node indexed by node id, or -1 for ids of nodes not
+  // held in the slots.
+  std::vector<int64_t> slot_by_id_;
+  std::vector<Value> values_;
+  // A slot holds a valid value iff its generation equals `generation_`.
+  std::vector<int64_t> generations_;
+  int64_t generation_ = 1;
+};
+
 // A visitor for traversing and evaluating XLS IR.
 class IrInterpreter : public DfsVisitor {
  public:
@@ -56,6 +112,16 @@ class IrInterpreter : public DfsVisitor {
         events_ptr_(events),
         observer_(observer) {}
 
+  // Constructor which stores node values in the given dense slots rather than
+  // a map. All nodes evaluated must have been assigned a slot.
+  explicit IrInterpreter(
+      NodeValueSlots& node_value_slots,
+      std::optional<EvaluationObserver*> observer = std::nullopt)
+      : node_values_ptr_(nullptr),
+        node_value_slots_(&node_value_slots),
+        events_ptr_(nullptr),
+        observer_(observer) {}
+
   // Sets the evaluated value for 'node' to the given Value. 'value' must be
   // passed in by value (ha!) because a use case is passing in a previously
   // evaluated value and inserting a into flat_hash_map (done below) invalidates
@@ -64,6 +130,9 @@ class IrInterpreter : public DfsVisitor {
 
   // Returns the previously evaluated value of 'node' as a Value.
   const Value& ResolveAsValue(Node* node) const {
+    if (node_value_slots_ != nullptr) {
+      return node_value_slots_->Get(node);
+    }
     return NodeValuesMap().at(node);
   }
 
@@ -77,7 +146,12 @@ class IrInterpreter : public DfsVisitor {
   absl::Status AddInterpreterEvents(const InterpreterEvents& events);
 
   // Returns true if a value has been set for the result of the given node.
-  bool HasResult(Node* node) const { return NodeValuesMap().contains(node); }
+  bool HasResult(Node* node) const {
+    if (node_value_slots_ != nullptr) {
+      return node_value_slots_->HasValue(node);
+    }
+    return NodeValuesMap().contains(node);
+  }
 
   absl::Status HandleAdd(BinOp* add) override;
   absl::Status HandleAfterAll(AfterAll* after_all) override;
@@ -195,7 +269,9 @@ class IrInterpreter : public DfsVisitor {
   absl::StatusOr<Value> DeepOr(Type* input_type,
                                absl::Span<const Value* const> inputs);
 
-  // Returns the map which maps Node* to the Value computed for that node.
+  // Returns the map which maps Node* to the Value computed for that node. Not
+  // used if the values are held in dense slots (`node_value_slots_` is not
+  // null).
   absl::flat_hash_map<Node*, Value>& NodeValuesMap() {
     return node_values_ptr_ != nullptr ? *node_values_ptr_ : node_values_;
   }
@@ -210,6 +286,10 @@ class IrInterpreter : public DfsVisitor {
   absl::flat_hash_map<Node*, Value>* node_values_ptr_;
   absl::flat_hash_map<Node*, Value> node_values_;
 
+  // If not null, the evaluated values are held in these slots instead of the
+  // map above.
+  NodeValueSlots* node_value_slots_ = nullptr;
+
   // Events observed while interpreting (currently only trace messages). To
   // support continuations, an existing events object can either be passed in at
   // construction time (`events_ptr_` is not null), or a fresh events object is
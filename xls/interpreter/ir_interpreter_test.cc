@@ -14,14 +14,18 @@
 
 #include "xls/interpreter/ir_interpreter.h"
 
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "xls/common/status/matchers.h"
 #include "xls/interpreter/function_interpreter.h"
@@ -32,6 +36,9 @@
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/ir_test_base.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
+#include "xls/ir/source_location.h"
 #include "xls/ir/package.h"
 #include "xls/ir/value.h"
 #include "xls/ir/verifier.h"
@@ -41,6 +48,7 @@ namespace {
 
 using ::absl_testing::IsOkAndHolds;
 using ::absl_testing::StatusIs;
+using ::testing::_;
 using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
 using ::testing::FieldsAre;
@@ -62,6 +70,29 @@ INSTANTIATE_TEST_SUITE_P(
         true, "IrInterpreter")),
     testing::PrintToStringParamName());
 
+INSTANTIATE_TEST_SUITE_P(
+    CompiledIrInterpreterTest, IrEvaluatorTestBase,
+    testing::Values(IrEvaluatorTestParam(
+        [](Function* function, absl::Span<const Value> args,
+           std::optional<EvaluationObserver*> obs)
+            -> absl::StatusOr<InterpreterResult<Value>> {
+          XLS_ASSIGN_OR_RETURN(
+              std::unique_ptr<CompiledFunctionInterpreter> interpreter,
+              CompiledFunctionInterpreter::Create(function));
+          return interpreter->Run(args, obs);
+        },
+        [](Function* function,
+           const absl::flat_hash_map<std::string, Value>& kwargs,
+           std::optional<EvaluationObserver*> obs)
+            -> absl::StatusOr<InterpreterResult<Value>> {
+          XLS_ASSIGN_OR_RETURN(
+              std::unique_ptr<CompiledFunctionInterpreter> interpreter,
+              CompiledFunctionInterpreter::Create(function));
+          return interpreter->RunWithKwargs(kwargs, obs);
+        },
+        true, "CompiledIrInterpreter")),
+    testing::PrintToStringParamName());
+
 // Fixture for IrInterpreter-only tests (i.e., those that aren't common to all
 // IR evaluators).
 class IrInterpreterOnlyTest : public IrTestBase {};
@@ -232,5 +263,53 @@ fn map_trace() -> bits[32][5]{
                            FieldsAre("b is odd", 0)));
 }
 
+TEST_F(IrInterpreterOnlyTest, CompiledInterpreterRepeatedRuns) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+    fn f(tkn: token, x: bits[8], y: bits[8]) -> (bits[8], bits[8][2]) {
+      add.1: bits[8] = add(x, y)
+      ult.2: bits[1] = ult(x, y)
+      trace.3: token = trace(tkn, ult.2, format="{} < {}", data_operands=[x, y])
+      array.4: bits[8][2] = array(x, add.1)
+      ret tuple.5: (bits[8], bits[8][2]) = tuple(add.1, array.4)
+    }
+    )",
+                                                       p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CompiledFunctionInterpreter> interp,
+                           CompiledFunctionInterpreter::Create(f));
+  for (int64_t x = 0; x < 16; ++x) {
+    for (int64_t y = 0; y < 16; y += 3) {
+      std::vector<Value> args = {Value::Token(), Value(UBits(x, 8)),
+                                 Value(UBits(y, 8))};
+      XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> expected,
+                               InterpretFunction(f, args));
+      XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> actual,
+                               interp->Run(args));
+      EXPECT_EQ(actual.value, expected.value);
+      EXPECT_EQ(actual.events.trace_msgs, expected.events.trace_msgs);
+      EXPECT_EQ(actual.events.trace_msgs.size(), x < y ? 1 : 0);
+    }
+  }
+}
+
+TEST_F(IrInterpreterOnlyTest, CompiledInterpreterRejectsModifiedFunction) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  fb.Not(x);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CompiledFunctionInterpreter> interp,
+                           CompiledFunctionInterpreter::Create(f));
+  EXPECT_THAT(interp->Run({Value(UBits(1, 8))}),
+              IsOkAndHolds(FieldsAre(Value(UBits(0xfe, 8)), _)));
+  EXPECT_THAT(interp->Run({Value(UBits(1, 16))}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  XLS_ASSERT_OK(f->MakeNode<UnOp>(SourceInfo(), f->param(0), Op::kNeg).status());
+  EXPECT_THAT(interp->Run({Value(UBits(1, 8))}),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("modified after the interpreter")));
+}
+
 }  // namespace
 }  // namespace xls
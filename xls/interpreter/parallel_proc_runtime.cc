@@ -0,0 +1,410 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/parallel_proc_runtime.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
+#include "xls/interpreter/channel_queue.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/proc_evaluator.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/events.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/package.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/proc_elaboration.h"
+#include "xls/jit/jit_channel_queue.h"
+
+namespace xls {
+namespace {
+
+// Returns true if the results of ticking the network do not depend on the
+// order in which proc instances are scheduled. This holds for Kahn process
+// networks: procs which only perform blocking receives on FIFO channels.
+bool IsScheduleIndependent(const ProcElaboration& elaboration) {
+  for (ChannelInstance* channel_instance : elaboration.channel_instances()) {
+    if (channel_instance->channel->kind() == ChannelKind::kSingleValue) {
+      return false;
+    }
+  }
+  for (Proc* proc : elaboration.procs()) {
+    for (Node* node : proc->nodes()) {
+      if (node->Is<Receive>() && !node->As<Receive>()->is_blocking()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+ParallelProcRuntime::Create(
+    std::vector<std::unique_ptr<ProcEvaluator>>&& evaluators,
+    std::unique_ptr<ChannelQueueManager>&& queue_manager,
+    const EvaluatorOptions& options, int64_t thread_count) {
+  XLS_RET_CHECK_GE(thread_count, 0);
+  // Verify there exists exactly one evaluator per proc in the package.
+  absl::flat_hash_map<Proc*, std::unique_ptr<ProcEvaluator>> evaluator_map;
+  for (std::unique_ptr<ProcEvaluator>& evaluator : evaluators) {
+    Proc* proc = evaluator->proc();
+    auto [it, inserted] = evaluator_map.insert({proc, std::move(evaluator)});
+    XLS_RET_CHECK(inserted) << absl::StreamFormat(
+        "More than one evaluator given for proc `%s`", proc->name());
+  }
+  for (Proc* proc : queue_manager->elaboration().procs()) {
+    XLS_RET_CHECK(evaluator_map.contains(proc))
+        << absl::StreamFormat("No evaluator given for proc `%s`", proc->name());
+  }
+  XLS_RET_CHECK_EQ(evaluator_map.size(),
+                   queue_manager->elaboration().procs().size())
+      << "More evaluators than procs given.";
+  for (ChannelQueue* queue : queue_manager->queues()) {
+    XLS_RET_CHECK(dynamic_cast<ThreadUnsafeJitChannelQueue*>(queue) == nullptr)
+        << absl::StreamFormat(
+               "Channel instance `%s` is backed by a thread-unsafe queue",
+               queue->channel_instance()->ToString());
+  }
+  if (thread_count == 0) {
+    thread_count = std::max(AvailableCPUs(), 1);
+  }
+  bool schedule_independent =
+      IsScheduleIndependent(queue_manager->elaboration());
+  VLOG(2) << absl::StreamFormat(
+      "Creating parallel proc runtime with %d threads; schedule %s",
+      thread_count, schedule_independent ? "independent" : "dependent");
+  return absl::WrapUnique(new ParallelProcRuntime(
+      std::move(evaluator_map), std::move(queue_manager), options,
+      thread_count, schedule_independent));
+}
+
+ParallelProcRuntime::ParallelProcRuntime(
+    absl::flat_hash_map<Proc*, std::unique_ptr<ProcEvaluator>>&& evaluators,
+    std::unique_ptr<ChannelQueueManager>&& queue_manager,
+    const EvaluatorOptions& options, int64_t thread_count,
+    bool schedule_independent)
+    : ProcRuntime(std::move(evaluators), std::move(queue_manager), options),
+      schedule_independent_(schedule_independent) {
+  for (int64_t i = 0; i < thread_count; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  // Only spin up background threads if they can ever be used.
+  if (schedule_independent_) {
+    for (int64_t i = 1; i < thread_count; ++i) {
+      threads_.push_back(
+          std::make_unique<Thread>([this, i]() { WorkerThreadLoop(i); }));
+    }
+  }
+}
+
+ParallelProcRuntime::~ParallelProcRuntime() {
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    shutdown_ = true;
+  }
+  for (std::unique_ptr<Thread>& thread : threads_) {
+    thread->Join();
+  }
+}
+
+ParallelProcRuntime::Task ParallelProcRuntime::MakeTask(int64_t index) {
+  ProcInstance* instance = elaboration().proc_instances()[index];
+  return Task{.index = index,
+              .instance = instance,
+              .evaluator = evaluators_.at(instance->proc()).get(),
+              .continuation = continuations_.at(instance).get()};
+}
+
+void ParallelProcRuntime::Push(int64_t worker_index, const Task& task) {
+  {
+    Worker& worker = *workers_[worker_index];
+    absl::MutexLock lock(&worker.mutex);
+    worker.tasks.push_back(task);
+  }
+  // Only count the task once it is on a deque, so that a worker which claims
+  // it is guaranteed to find it.
+  absl::MutexLock lock(&schedule_mutex_);
+  ++ready_;
+}
+
+void ParallelProcRuntime::AddPending(int64_t delta) {
+  absl::MutexLock lock(&schedule_mutex_);
+  pending_ += delta;
+}
+
+bool ParallelProcRuntime::ClaimTask() {
+  absl::MutexLock lock(&schedule_mutex_);
+  auto runnable = [&]() ABSL_SHARED_LOCKS_REQUIRED(schedule_mutex_) {
+    return ready_ > 0 || pending_ == 0 || failed_;
+  };
+  schedule_mutex_.Await(absl::Condition(&runnable));
+  if (pending_ == 0 || failed_) {
+    return false;
+  }
+  --ready_;
+  return true;
+}
+
+std::optional<ParallelProcRuntime::Task> ParallelProcRuntime::PopOrSteal(
+    int64_t worker_index) {
+  {
+    Worker& worker = *workers_[worker_index];
+    absl::MutexLock lock(&worker.mutex);
+    if (!worker.tasks.empty()) {
+      Task task = worker.tasks.front();
+      worker.tasks.pop_front();
+      return task;
+    }
+  }
+  for (int64_t i = 1; i < workers_.size(); ++i) {
+    Worker& victim = *workers_[(worker_index + i) % workers_.size()];
+    absl::MutexLock lock(&victim.mutex);
+    if (!victim.tasks.empty()) {
+      Task task = victim.tasks.back();
+      victim.tasks.pop_back();
+      return task;
+    }
+  }
+  return std::nullopt;
+}
+
+absl::Status ParallelProcRuntime::RunTask(int64_t worker_index,
+                                          const Task& task) {
+  VLOG(3) << absl::StreamFormat("Ticking proc instance `%s` on worker %d",
+                                task.instance->GetName(), worker_index);
+  XLS_ASSIGN_OR_RETURN(TickResult tick_result,
+                       task.evaluator->Tick(*task.continuation));
+  XLS_RETURN_IF_ERROR(
+      InterpreterEventsToStatus(task.continuation->GetEvents()));
+  VLOG(3) << "Tick result: " << tick_result;
+
+  if (tick_result.progress_made) {
+    progress_made_.store(true, std::memory_order_relaxed);
+    if (task.evaluator->ProcHasIoOperations()) {
+      progress_made_on_io_procs_.store(true, std::memory_order_relaxed);
+    }
+  }
+  switch (tick_result.execution_state) {
+    case TickExecutionState::kCompleted:
+      AddPending(-1);
+      break;
+    case TickExecutionState::kSentOnChannel: {
+      std::optional<Task> woken;
+      {
+        absl::MutexLock lock(&park_mutex_);
+        auto it = parked_.find(tick_result.channel_instance.value());
+        if (it != parked_.end()) {
+          woken = it->second;
+          parked_.erase(it);
+          AddPending(1);
+        }
+      }
+      if (woken.has_value()) {
+        VLOG(3) << absl::StreamFormat(
+            "Unblocking proc instance `%s` and adding to ready list",
+            woken->instance->GetName());
+        Push(worker_index, *woken);
+      }
+      // This proc instance can go back on the ready queue.
+      Push(worker_index, task);
+      break;
+    }
+    case TickExecutionState::kBlockedOnReceive: {
+      ChannelInstance* channel_instance = tick_result.channel_instance.value();
+      absl::MutexLock lock(&park_mutex_);
+      // A value may have been sent between the failed receive and now; the
+      // sender checks for parked instances only after its send completes, so
+      // re-checking under the lock cannot miss a wakeup.
+      if (!queue_manager_->GetQueue(channel_instance).IsEmpty()) {
+        Push(worker_index, task);
+        break;
+      }
+      VLOG(3) << absl::StreamFormat(
+          "Proc instance `%s` is now blocked on channel instance `%s`",
+          task.instance->GetName(), channel_instance->ToString());
+      parked_.emplace(channel_instance, task);
+      AddPending(-1);
+      break;
+    }
+  }
+  return absl::OkStatus();
+}
+
+void ParallelProcRuntime::RunWorker(int64_t worker_index) {
+  while (ClaimTask()) {
+    // The claimed task is on some deque, but other workers may steal the
+    // tasks this worker looks at first.
+    std::optional<Task> task;
+    do {
+      task = PopOrSteal(worker_index);
+    } while (!task.has_value());
+    absl::Status status = RunTask(worker_index, *task);
+    if (!status.ok()) {
+      {
+        absl::MutexLock lock(&error_mutex_);
+        if (!error_index_.has_value() || task->index < *error_index_) {
+          error_index_ = task->index;
+          error_ = std::move(status);
+        }
+      }
+      absl::MutexLock lock(&schedule_mutex_);
+      failed_ = true;
+    }
+  }
+}
+
+void ParallelProcRuntime::WorkerThreadLoop(int64_t worker_index) {
+  int64_t seen_generation = 0;
+  while (true) {
+    {
+      absl::MutexLock lock(&pool_mutex_);
+      auto ready = [&]() ABSL_SHARED_LOCKS_REQUIRED(pool_mutex_) {
+        return shutdown_ || generation_ != seen_generation;
+      };
+      pool_mutex_.Await(absl::Condition(&ready));
+      if (shutdown_) {
+        return;
+      }
+      seen_generation = generation_;
+    }
+    RunWorker(worker_index);
+    absl::MutexLock lock(&pool_mutex_);
+    --running_workers_;
+  }
+}
+
+absl::StatusOr<ParallelProcRuntime::NetworkTickResult>
+ParallelProcRuntime::TickInternal() {
+  VLOG(3) << absl::StreamFormat("TickInternal on package %s",
+                                package()->name());
+  const bool concurrent = runs_concurrently();
+  const int64_t active_workers = concurrent ? workers_.size() : 1;
+
+  // Put all proc instances on the ready lists.
+  const int64_t instance_count = elaboration().proc_instances().size();
+  {
+    absl::MutexLock lock(&schedule_mutex_);
+    pending_ = instance_count;
+    ready_ = 0;
+    failed_ = false;
+  }
+  for (int64_t i = 0; i < instance_count; ++i) {
+    Push(i % active_workers, MakeTask(i));
+  }
+  progress_made_.store(false, std::memory_order_relaxed);
+  progress_made_on_io_procs_.store(false, std::memory_order_relaxed);
+  in_concurrent_tick_ = concurrent;
+
+  if (concurrent) {
+    {
+      absl::MutexLock lock(&pool_mutex_);
+      running_workers_ = threads_.size();
+      ++generation_;
+    }
+    RunWorker(0);
+    absl::MutexLock lock(&pool_mutex_);
+    auto done = [&]() ABSL_SHARED_LOCKS_REQUIRED(pool_mutex_) {
+      return running_workers_ == 0;
+    };
+    pool_mutex_.Await(absl::Condition(&done));
+  } else {
+    RunWorker(0);
+  }
+  in_concurrent_tick_ = false;
+  FlushChannelTraceMessages();
+
+  // Gather the instances which were left blocked and reset the scheduler.
+  absl::flat_hash_map<ChannelInstance*, Task> parked;
+  {
+    absl::MutexLock lock(&park_mutex_);
+    parked = std::move(parked_);
+    parked_.clear();
+  }
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    absl::MutexLock lock(&worker->mutex);
+    worker->tasks.clear();
+  }
+  {
+    absl::MutexLock lock(&error_mutex_);
+    if (error_index_.has_value()) {
+      error_index_.reset();
+      return std::exchange(error_, absl::OkStatus());
+    }
+  }
+
+  std::vector<ChannelInstance*> blocked_channel_instances;
+  for (ChannelInstance* instance : elaboration().channel_instances()) {
+    if (parked.contains(instance)) {
+      blocked_channel_instances.push_back(instance);
+    }
+  }
+  return NetworkTickResult{
+      .progress_made = progress_made_.load(std::memory_order_relaxed),
+      .progress_made_on_io_procs =
+          progress_made_on_io_procs_.load(std::memory_order_relaxed),
+      .blocked_channel_instances = std::move(blocked_channel_instances),
+  };
+}
+
+void ParallelProcRuntime::AddChannelTraceMessage(
+    ChannelInstance* channel_instance, TraceMessage message) {
+  if (!in_concurrent_tick_) {
+    AddTraceMessage(std::move(message));
+    return;
+  }
+  absl::MutexLock lock(&trace_mutex_);
+  channel_trace_messages_[channel_instance].push_back(std::move(message));
+}
+
+void ParallelProcRuntime::FlushChannelTraceMessages() {
+  absl::flat_hash_map<ChannelInstance*, std::vector<TraceMessage>> messages;
+  {
+    absl::MutexLock lock(&trace_mutex_);
+    messages = std::move(channel_trace_messages_);
+    channel_trace_messages_.clear();
+  }
+  if (messages.empty()) {
+    return;
+  }
+  for (ChannelInstance* channel_instance : elaboration().channel_instances()) {
+    auto it = messages.find(channel_instance);
+    if (it == messages.end()) {
+      continue;
+    }
+    for (TraceMessage& message : it->second) {
+      AddTraceMessage(std::move(message));
+    }
+  }
+}
+
+}  // namespace xls
@@ -0,0 +1,187 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_INTERPRETER_PARALLEL_PROC_RUNTIME_H_
+#define XLS_INTERPRETER_PARALLEL_PROC_RUNTIME_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/thread.h"
+#include "xls/interpreter/channel_queue.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/proc_evaluator.h"
+#include "xls/interpreter/proc_runtime.h"
+#include "xls/ir/events.h"
+#include "xls/ir/package.h"
+#include "xls/ir/proc_elaboration.h"
+
+namespace xls {
+
+// A proc runtime which ticks proc instances concurrently on a pool of worker
+// threads.
+//
+// Each network tick distributes the proc instances over per-worker deques.
+// Workers run instances from the front of their own deque and steal from the
+// back of other workers' deques when they run dry, and sleep while no instance
+// is ready to run. As in SerialProcRuntime, an
+// instance which blocks on a receive is parked on its channel instance and
+// woken when a value is sent on that channel, and the network tick ends once
+// every instance has either completed its tick or is parked.
+//
+// Proc networks communicating only through blocking receives on streaming
+// channels are deterministic, so running them concurrently yields the same
+// proc state, channel contents and per-proc InterpreterEvents as the serial
+// runtime. Channel trace messages generated during a network tick are
+// buffered and emitted at the end of the tick grouped by channel instance (in
+// elaboration order), so the global events are independent of the schedule.
+// Unlike in the serial runtime, they are therefore not interleaved across
+// channels in the order the sends and receives happened: each tick's messages
+// are the serial runtime's messages for that tick, stably sorted by channel.
+// Networks which are sensitive to scheduling -- those with non-blocking
+// receives or single-value channels -- and runs with an evaluation observer
+// attached are ticked on the calling thread in exactly the serial runtime's
+// order.
+//
+// The channel queues must be safe to access from multiple threads; each
+// channel instance is written by at most one thread and read by at most one
+// thread at a time, so lock-free SPSC queues suffice.
+class ParallelProcRuntime : public ProcRuntime {
+ public:
+  // Creates and returns a proc network runtime for the given evaluators using
+  // `thread_count` threads (including the calling thread). A `thread_count`
+  // of zero uses one thread per available CPU.
+  static absl::StatusOr<std::unique_ptr<ParallelProcRuntime>> Create(
+      std::vector<std::unique_ptr<ProcEvaluator>>&& evaluators,
+      std::unique_ptr<ChannelQueueManager>&& queue_manager,
+      const EvaluatorOptions& options = EvaluatorOptions(),
+      int64_t thread_count = 0);
+
+  ~ParallelProcRuntime() override;
+
+  // Returns the number of threads (including the calling thread) used to tick
+  // the network.
+  int64_t thread_count() const { return workers_.size(); }
+
+  // Whether network ticks run concurrently rather than falling back to the
+  // serial schedule.
+  bool runs_concurrently() const {
+    return schedule_independent_ && workers_.size() > 1 && !observer_;
+  }
+
+ protected:
+  void AddChannelTraceMessage(ChannelInstance* channel_instance,
+                              TraceMessage message) override;
+
+ private:
+  ParallelProcRuntime(
+      absl::flat_hash_map<Proc*, std::unique_ptr<ProcEvaluator>>&& evaluators,
+      std::unique_ptr<ChannelQueueManager>&& queue_manager,
+      const EvaluatorOptions& options, int64_t thread_count,
+      bool schedule_independent);
+
+  struct Task {
+    // Index of the instance in elaboration().proc_instances().
+    int64_t index;
+    ProcInstance* instance;
+    ProcEvaluator* evaluator;
+    ProcContinuation* continuation;
+  };
+
+  struct Worker {
+    absl::Mutex mutex;
+    std::deque<Task> tasks ABSL_GUARDED_BY(mutex);
+  };
+
+  absl::StatusOr<NetworkTickResult> TickInternal() override;
+
+  // Body of the background worker threads.
+  void WorkerThreadLoop(int64_t worker_index);
+
+  // Runs tasks on the given worker until the network tick is complete.
+  void RunWorker(int64_t worker_index);
+
+  // Blocks until a task is ready or the network tick is over, and claims the
+  // task. Returns false if the network tick is over.
+  bool ClaimTask();
+
+  // Pops a task from the front of the worker's own deque, or steals one from
+  // the back of another worker's deque.
+  std::optional<Task> PopOrSteal(int64_t worker_index);
+  void Push(int64_t worker_index, const Task& task);
+
+  // Adjusts the number of pending instances by `delta`.
+  void AddPending(int64_t delta);
+
+  // Ticks the task once and reschedules, parks or retires it.
+  absl::Status RunTask(int64_t worker_index, const Task& task);
+
+  // Moves the buffered channel trace messages into the global events.
+  void FlushChannelTraceMessages();
+
+  Task MakeTask(int64_t index);
+
+  const bool schedule_independent_;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Background threads; worker 0 is the thread calling Tick.
+  std::vector<std::unique_ptr<Thread>> threads_;
+
+  // Coordinates the start and end of network ticks with the background
+  // threads.
+  absl::Mutex pool_mutex_;
+  int64_t generation_ ABSL_GUARDED_BY(pool_mutex_) = 0;
+  int64_t running_workers_ ABSL_GUARDED_BY(pool_mutex_) = 0;
+  bool shutdown_ ABSL_GUARDED_BY(pool_mutex_) = false;
+
+  // Scheduling state of the current network tick; guarded by a mutex so idle
+  // workers can wait for it to change.
+  absl::Mutex schedule_mutex_;
+  // Number of instances which have neither completed their tick nor are
+  // parked. The network tick is complete when this reaches zero.
+  int64_t pending_ ABSL_GUARDED_BY(schedule_mutex_) = 0;
+  // Number of tasks on the worker deques which no worker has claimed yet.
+  int64_t ready_ ABSL_GUARDED_BY(schedule_mutex_) = 0;
+  bool failed_ ABSL_GUARDED_BY(schedule_mutex_) = false;
+
+  std::atomic<bool> progress_made_ = false;
+  std::atomic<bool> progress_made_on_io_procs_ = false;
+  bool in_concurrent_tick_ = false;
+
+  absl::Mutex park_mutex_;
+  absl::flat_hash_map<ChannelInstance*, Task> parked_
+      ABSL_GUARDED_BY(park_mutex_);
+
+  absl::Mutex error_mutex_;
+  // The error of the lowest-indexed failing instance, if any.
+  std::optional<int64_t> error_index_ ABSL_GUARDED_BY(error_mutex_);
+  absl::Status error_ ABSL_GUARDED_BY(error_mutex_);
+
+  absl::Mutex trace_mutex_;
+  absl::flat_hash_map<ChannelInstance*, std::vector<TraceMessage>>
+      channel_trace_messages_ ABSL_GUARDED_BY(trace_mutex_);
+};
+
+}  // namespace xls
+
+#endif  // XLS_INTERPRETER_PARALLEL_PROC_RUNTIME_H_
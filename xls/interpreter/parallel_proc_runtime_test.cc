@@ -0,0 +1,327 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/parallel_proc_runtime.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/algorithm/container.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/interpreter/channel_queue.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/interpreter_proc_runtime.h"
+#include "xls/interpreter/proc_runtime.h"
+#include "xls/interpreter/proc_runtime_test_base.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/channel_ops.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+#include "xls/ir/proc_elaboration.h"
+#include "xls/ir/value.h"
+#include "xls/jit/jit_proc_runtime.h"
+
+namespace xls {
+namespace {
+
+constexpr int64_t kThreadCount = 4;
+
+// Instantiate and run all the tests in proc_runtime_test_base.cc using
+// parallel runtimes.
+INSTANTIATE_TEST_SUITE_P(
+    ParallelProcRuntimeTest, ProcRuntimeTestBase,
+    testing::Values(
+        ProcRuntimeTestParam(
+            "interpreter",
+            [](Package* package, const EvaluatorOptions& options)
+                -> std::unique_ptr<ProcRuntime> {
+              return CreateInterpreterParallelProcRuntime(package, options,
+                                                          kThreadCount)
+                  .value();
+            },
+            [](Proc* top, const EvaluatorOptions& options)
+                -> std::unique_ptr<ProcRuntime> {
+              return CreateInterpreterParallelProcRuntime(top, options,
+                                                          kThreadCount)
+                  .value();
+            },
+            /*supports_observers=*/true),
+        ProcRuntimeTestParam(
+            "jit",
+            [](Package* package, const EvaluatorOptions& options)
+                -> std::unique_ptr<ProcRuntime> {
+              return CreateJitParallelProcRuntime(package, options,
+                                                  kThreadCount)
+                  .value();
+            },
+            [](Proc* top, const EvaluatorOptions& options)
+                -> std::unique_ptr<ProcRuntime> {
+              return CreateJitParallelProcRuntime(top, options, kThreadCount)
+                  .value();
+            },
+            /*supports_observers=*/true)),
+    ParameterizedTestName<ProcRuntimeTestBase>);
+
+class ParallelProcRuntimeTest : public IrTestBase {
+ protected:
+  // Builds a chain of `length` procs, each of which receives a value from the
+  // previous proc, adds it to an accumulator, traces it, and sends the
+  // accumulated value to the next proc.
+  absl::StatusOr<std::unique_ptr<Package>> CreateAccumulatorChain(
+      int64_t length) {
+    auto package = CreatePackage();
+    std::vector<Channel*> channels;
+    for (int64_t i = 0; i <= length; ++i) {
+      ChannelOps ops = i == 0        ? ChannelOps::kReceiveOnly
+                       : i == length ? ChannelOps::kSendOnly
+                                     : ChannelOps::kSendReceive;
+      XLS_ASSIGN_OR_RETURN(
+          Channel * channel,
+          package->CreateStreamingChannel(absl::StrCat("ch", i), ops,
+                                          package->GetBitsType(32)));
+      channels.push_back(channel);
+    }
+    for (int64_t i = 0; i < length; ++i) {
+      TokenlessProcBuilder pb(absl::StrCat("accum", i), "tkn", package.get());
+      BValue accum = pb.StateElement("accum", Value(UBits(0, 32)));
+      BValue input = pb.Receive(channels[i]);
+      BValue next_accum = pb.Add(accum, input);
+      pb.Trace(pb.CurrentToken(), pb.Literal(UBits(1, 1)), {next_accum},
+               "accum: {}");
+      pb.Send(channels[i + 1], next_accum);
+      XLS_RETURN_IF_ERROR(pb.Build({next_accum}).status());
+    }
+    return package;
+  }
+};
+
+TEST_F(ParallelProcRuntimeTest, MatchesSerialRuntime) {
+  constexpr int64_t kChainLength = 16;
+  constexpr int64_t kInputCount = 100;
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           CreateAccumulatorChain(kChainLength));
+  XLS_ASSERT_OK_AND_ASSIGN(Channel * in_channel, package->GetChannel("ch0"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * out_channel,
+      package->GetChannel(absl::StrCat("ch", kChainLength)));
+
+  auto run = [&](ProcRuntime* runtime) {
+    ChannelQueue& in_queue = runtime->queue_manager().GetQueue(in_channel);
+    for (int64_t i = 0; i < kInputCount; ++i) {
+      XLS_ASSERT_OK(in_queue.Write(Value(UBits(i, 32))));
+    }
+    XLS_ASSERT_OK(runtime->TickUntilBlocked(/*max_ticks=*/1000).status());
+  };
+
+  EvaluatorOptions options = EvaluatorOptions().set_trace_channels(true);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ProcRuntime> serial,
+      CreateInterpreterSerialProcRuntime(package.get(), options));
+  run(serial.get());
+
+  std::vector<std::unique_ptr<ProcRuntime>> parallel_runtimes;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ParallelProcRuntime> interpreter,
+      CreateInterpreterParallelProcRuntime(package.get(), options,
+                                           kThreadCount));
+  EXPECT_TRUE(interpreter->runs_concurrently());
+  parallel_runtimes.push_back(std::move(interpreter));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ParallelProcRuntime> jit,
+      CreateJitParallelProcRuntime(package.get(), options, kThreadCount));
+  EXPECT_TRUE(jit->runs_concurrently());
+  parallel_runtimes.push_back(std::move(jit));
+
+  for (std::unique_ptr<ProcRuntime>& runtime : parallel_runtimes) {
+    run(runtime.get());
+    ChannelQueue& serial_out = serial->queue_manager().GetQueue(out_channel);
+    ChannelQueue& parallel_out =
+        runtime->queue_manager().GetQueue(out_channel);
+    EXPECT_EQ(parallel_out.GetSize(), kInputCount);
+    EXPECT_EQ(parallel_out.GetSize(), serial_out.GetSize());
+    for (ProcInstance* instance : runtime->elaboration().proc_instances()) {
+      Proc* proc = instance->proc();
+      EXPECT_EQ(runtime->ResolveState(proc), serial->ResolveState(proc))
+          << proc->name();
+      EXPECT_EQ(runtime->GetInterpreterEvents(proc),
+                serial->GetInterpreterEvents(proc))
+          << proc->name();
+    }
+    // Channel traces may be interleaved differently across channels but the
+    // sequence of messages on each channel matches.
+    InterpreterEvents parallel_events = runtime->GetGlobalEvents();
+    InterpreterEvents serial_events = serial->GetGlobalEvents();
+    EXPECT_EQ(parallel_events.trace_msgs.size(),
+              serial_events.trace_msgs.size());
+    for (ChannelInstance* channel_instance :
+         runtime->elaboration().channel_instances()) {
+      std::string channel_name =
+          absl::StrFormat("`%s`", channel_instance->ToString());
+      auto on_channel = [&](const InterpreterEvents& events) {
+        std::vector<std::string> messages;
+        for (const TraceMessage& message : events.trace_msgs) {
+          if (absl::StrContains(message.message, channel_name)) {
+            messages.push_back(message.message);
+          }
+        }
+        return messages;
+      };
+      EXPECT_EQ(on_channel(parallel_events), on_channel(serial_events))
+          << channel_name;
+    }
+  }
+  ChannelQueue& serial_out = serial->queue_manager().GetQueue(out_channel);
+  ChannelQueue& interpreter_out =
+      parallel_runtimes[0]->queue_manager().GetQueue(out_channel);
+  ChannelQueue& jit_out =
+      parallel_runtimes[1]->queue_manager().GetQueue(out_channel);
+  for (int64_t i = 0; i < kInputCount; ++i) {
+    std::optional<Value> expected = serial_out.Read();
+    ASSERT_TRUE(expected.has_value());
+    EXPECT_EQ(interpreter_out.Read(), expected);
+    EXPECT_EQ(jit_out.Read(), expected);
+  }
+}
+
+TEST_F(ParallelProcRuntimeTest, TracesAreIndependentOfThreadCount) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           CreateAccumulatorChain(8));
+  XLS_ASSERT_OK_AND_ASSIGN(Channel * in_channel, package->GetChannel("ch0"));
+
+  std::vector<TraceMessage> first_trace;
+  for (int64_t thread_count : {2, 3, 8}) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<ParallelProcRuntime> runtime,
+        CreateInterpreterParallelProcRuntime(
+            package.get(), EvaluatorOptions().set_trace_channels(true),
+            thread_count));
+    EXPECT_EQ(runtime->thread_count(), thread_count);
+    ChannelQueue& in_queue = runtime->queue_manager().GetQueue(in_channel);
+    for (int64_t i = 0; i < 20; ++i) {
+      XLS_ASSERT_OK(in_queue.Write(Value(UBits(i, 32))));
+    }
+    XLS_ASSERT_OK(runtime->TickUntilBlocked(/*max_ticks=*/1000).status());
+    std::vector<TraceMessage> trace = runtime->GetGlobalEvents().trace_msgs;
+    if (first_trace.empty()) {
+      first_trace = trace;
+    } else {
+      EXPECT_EQ(trace, first_trace) << thread_count << " threads";
+    }
+  }
+}
+
+TEST_F(ParallelProcRuntimeTest, ChannelTracesAreGroupedByChannelEachTick) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           CreateAccumulatorChain(4));
+  XLS_ASSERT_OK_AND_ASSIGN(Channel * in_channel, package->GetChannel("ch0"));
+  EvaluatorOptions options = EvaluatorOptions().set_trace_channels(true);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ProcRuntime> serial,
+      CreateInterpreterSerialProcRuntime(package.get(), options));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ParallelProcRuntime> parallel,
+      CreateInterpreterParallelProcRuntime(package.get(), options,
+                                           kThreadCount));
+  ASSERT_TRUE(parallel->runs_concurrently());
+  for (ProcRuntime* runtime :
+       std::vector<ProcRuntime*>{serial.get(), parallel.get()}) {
+    ChannelQueue& in_queue = runtime->queue_manager().GetQueue(in_channel);
+    for (int64_t i = 0; i < 10; ++i) {
+      XLS_ASSERT_OK(in_queue.Write(Value(UBits(i, 32))));
+    }
+  }
+
+  // Returns the elaboration-order index of the channel instance a serial
+  // runtime trace message is about.
+  auto channel_index = [&](const TraceMessage& message) -> int64_t {
+    absl::Span<ChannelInstance* const> channel_instances =
+        serial->elaboration().channel_instances();
+    for (int64_t i = 0; i < channel_instances.size(); ++i) {
+      if (absl::StrContains(
+              message.message,
+              absl::StrFormat("`%s`", channel_instances[i]->ToString()))) {
+        return i;
+      }
+    }
+    return -1;
+  };
+
+  // Within each network tick the parallel runtime emits the serial runtime's
+  // channel traces grouped by channel, rather than in the order the sends and
+  // receives happened.
+  int64_t serial_seen = 0;
+  int64_t parallel_seen = 0;
+  for (int64_t tick = 0; tick < 15; ++tick) {
+    XLS_ASSERT_OK(serial->Tick());
+    XLS_ASSERT_OK(parallel->Tick());
+    std::vector<TraceMessage> serial_trace =
+        serial->GetGlobalEvents().trace_msgs;
+    std::vector<TraceMessage> parallel_trace =
+        parallel->GetGlobalEvents().trace_msgs;
+    std::vector<TraceMessage> expected(serial_trace.begin() + serial_seen,
+                                       serial_trace.end());
+    absl::c_stable_sort(expected,
+                        [&](const TraceMessage& a, const TraceMessage& b) {
+                          return channel_index(a) < channel_index(b);
+                        });
+    EXPECT_EQ(std::vector<TraceMessage>(parallel_trace.begin() + parallel_seen,
+                                        parallel_trace.end()),
+              expected)
+        << "tick " << tick;
+    serial_seen = serial_trace.size();
+    parallel_seen = parallel_trace.size();
+  }
+  EXPECT_GT(serial_seen, 0);
+}
+
+TEST_F(ParallelProcRuntimeTest, NonBlockingReceiveFallsBackToSerialOrder) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * in_channel,
+      package->CreateStreamingChannel("in", ChannelOps::kReceiveOnly,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * out_channel,
+      package->CreateStreamingChannel("out", ChannelOps::kSendOnly,
+                                      package->GetBitsType(32)));
+  TokenlessProcBuilder pb("nb", "tkn", package.get());
+  auto [data, valid] = pb.ReceiveNonBlocking(in_channel);
+  pb.Send(out_channel, data);
+  XLS_ASSERT_OK(pb.Build({}).status());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ParallelProcRuntime> runtime,
+      CreateInterpreterParallelProcRuntime(package.get(), EvaluatorOptions(),
+                                           kThreadCount));
+  EXPECT_FALSE(runtime->runs_concurrently());
+  XLS_ASSERT_OK(runtime->Tick());
+  EXPECT_EQ(runtime->queue_manager().GetQueue(out_channel).GetSize(), 1);
+}
+
+}  // namespace
+}  // namespace xls
@@ -60,7 +60,8 @@ class ChannelTraceRecorder : public ChannelQueueCallback {
                                           channel_instance->ToString(),
                                           value.ToString(format_preference_));
     VLOG(3) << message;
-    runtime_->AddTraceMessage(
+    runtime_->AddChannelTraceMessage(
+        channel_instance,
         TraceMessage{.message = std::move(message), .verbosity = 0});
   }
 
@@ -70,7 +71,8 @@ class ChannelTraceRecorder : public ChannelQueueCallback {
                                           channel_instance->ToString(),
                                           value.ToString(format_preference_));
     VLOG(3) << message;
-    runtime_->AddTraceMessage(
+    runtime_->AddChannelTraceMessage(
+        channel_instance,
         TraceMessage{.message = std::move(message), .verbosity = 0});
   }
 
@@ -262,6 +264,11 @@ void ProcRuntime::ClearInterpreterEvents() {
   }
 }
 
+void ProcRuntime::AddChannelTraceMessage(ChannelInstance* channel_instance,
+                                         TraceMessage message) {
+  AddTraceMessage(std::move(message));
+}
+
 void ProcRuntime::AddTraceMessage(TraceMessage message) {
   absl::MutexLock lock(&global_events_mutex_);
   global_events_.trace_msgs.push_back(std::move(message));
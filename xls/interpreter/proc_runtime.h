@@ -146,6 +146,11 @@ class ProcRuntime {
   friend class ChannelTraceRecorder;
   void AddTraceMessage(TraceMessage message);
 
+  // Records a trace message for activity on the given channel instance. By
+  // default the message is added to the global events immediately.
+  virtual void AddChannelTraceMessage(ChannelInstance* channel_instance,
+                                      TraceMessage message);
+
   // Execute (up to) a single iteration of every proc in the package.
   struct NetworkTickResult {
     // Whether any instruction on any proc executed.
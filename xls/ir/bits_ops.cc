@@ -25,6 +25,7 @@
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "absl/numeric/int128.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
@@ -40,6 +41,174 @@ namespace xls {
 namespace bits_ops {
 namespace {
 
+// Multiplications where both operands have at least this many words use
+// Karatsuba multiplication rather than schoolbook multiplication.
+constexpr int64_t kKaratsubaThresholdWords = 32;
+
+// Returns the value of the given bits, which must have at most 128 bits.
+absl::uint128 ToUint128(const Bits& bits) {
+  DCHECK_LE(bits.bit_count(), 128);
+  const InlineBitmap& bitmap = bits.bitmap();
+  uint64_t low = bitmap.word_count() > 0 ? bitmap.GetWord(0) : 0;
+  uint64_t high = bitmap.word_count() > 1 ? bitmap.GetWord(1) : 0;
+  return absl::MakeUint128(high, low);
+}
+
+// Returns the low `bit_count` bits of `value`.
+Bits UBits128(absl::uint128 value, int64_t bit_count) {
+  InlineBitmap result(bit_count);
+  if (result.word_count() > 0) {
+    result.SetWord(0, absl::Uint128Low64(value));
+  }
+  if (result.word_count() > 1) {
+    result.SetWord(1, absl::Uint128High64(value));
+  }
+  return Bits::FromBitmap(std::move(result));
+}
+
+std::vector<uint64_t> Words(const Bits& bits) {
+  const InlineBitmap& bitmap = bits.bitmap();
+  std::vector<uint64_t> words(bitmap.word_count());
+  for (int64_t i = 0; i < words.size(); ++i) {
+    words[i] = bitmap.GetWord(i);
+  }
+  return words;
+}
+
+// Returns the low `bit_count` bits of the value with the given words, which
+// must cover at least `bit_count` bits.
+Bits FromWords(absl::Span<const uint64_t> words, int64_t bit_count) {
+  InlineBitmap result(bit_count);
+  for (int64_t i = 0; i < result.word_count(); ++i) {
+    result.SetWord(i, words[i]);
+  }
+  return Bits::FromBitmap(std::move(result));
+}
+
+// Adds `value` to `dst` in place, discarding any carry out of `dst`.
+void AddWordsInPlace(absl::Span<uint64_t> dst,
+                     absl::Span<const uint64_t> value) {
+  DCHECK_LE(value.size(), dst.size());
+  uint64_t carry = 0;
+  int64_t i = 0;
+  for (; i < value.size(); ++i) {
+    uint64_t sum = dst[i] + value[i];
+    uint64_t carry_out = sum < value[i] ? 1 : 0;
+    sum += carry;
+    carry_out |= sum < carry ? 1 : 0;
+    dst[i] = sum;
+    carry = carry_out;
+  }
+  for (; carry != 0 && i < dst.size(); ++i) {
+    dst[i] += carry;
+    carry = dst[i] == 0 ? 1 : 0;
+  }
+}
+
+// Subtracts `value` from `dst` in place, discarding any borrow out of `dst`.
+void SubWordsInPlace(absl::Span<uint64_t> dst,
+                     absl::Span<const uint64_t> value) {
+  DCHECK_LE(value.size(), dst.size());
+  uint64_t borrow = 0;
+  int64_t i = 0;
+  for (; i < value.size(); ++i) {
+    uint64_t diff = dst[i] - value[i];
+    uint64_t borrow_out = dst[i] < value[i] ? 1 : 0;
+    borrow_out |= diff < borrow ? 1 : 0;
+    dst[i] = diff - borrow;
+    borrow = borrow_out;
+  }
+  for (; borrow != 0 && i < dst.size(); ++i) {
+    borrow = dst[i] == 0 ? 1 : 0;
+    dst[i] -= 1;
+  }
+}
+
+// Adds `a * b` to `result`, discarding words of the product beyond the size of
+// `result`.
+void SchoolbookMultiply(absl::Span<const uint64_t> a,
+                        absl::Span<const uint64_t> b,
+                        absl::Span<uint64_t> result) {
+  for (int64_t i = 0; i < a.size() && i < result.size(); ++i) {
+    if (a[i] == 0) {
+      continue;
+    }
+    uint64_t carry = 0;
+    int64_t j = 0;
+    for (; j < b.size() && i + j < result.size(); ++j) {
+      absl::uint128 t = absl::uint128{a[i]} * b[j] + result[i + j] + carry;
+      result[i + j] = absl::Uint128Low64(t);
+      carry = absl::Uint128High64(t);
+    }
+    for (int64_t k = i + j; carry != 0 && k < result.size(); ++k) {
+      result[k] += carry;
+      carry = result[k] < carry ? 1 : 0;
+    }
+  }
+}
+
+// Writes the product of `a` and `b`, which must have the same number of words
+// n, to the 2n words of `result`, which must be zero.
+void KaratsubaMultiply(absl::Span<const uint64_t> a,
+                       absl::Span<const uint64_t> b,
+                       absl::Span<uint64_t> result) {
+  DCHECK_EQ(a.size(), b.size());
+  DCHECK_EQ(result.size(), 2 * a.size());
+  const int64_t n = a.size();
+  if (n < kKaratsubaThresholdWords) {
+    SchoolbookMultiply(a, b, result);
+    return;
+  }
+  // Split each operand into a low half of `m` words and a high half of `h`
+  // words: a = a1 * B^m + a0. Then
+  //   a * b = z2 * B^2m + z1 * B^m + z0
+  // where z0 = a0 * b0, z2 = a1 * b1 and z1 = (a0 + a1) * (b0 + b1) - z0 - z2.
+  const int64_t m = n / 2;
+  const int64_t h = n - m;
+  absl::Span<uint64_t> z0 = result.subspan(0, 2 * m);
+  absl::Span<uint64_t> z2 = result.subspan(2 * m, 2 * h);
+  KaratsubaMultiply(a.subspan(0, m), b.subspan(0, m), z0);
+  KaratsubaMultiply(a.subspan(m), b.subspan(m), z2);
+
+  std::vector<uint64_t> a_sum(a.begin() + m, a.end());
+  a_sum.push_back(0);
+  AddWordsInPlace(absl::MakeSpan(a_sum), a.subspan(0, m));
+  std::vector<uint64_t> b_sum(b.begin() + m, b.end());
+  b_sum.push_back(0);
+  AddWordsInPlace(absl::MakeSpan(b_sum), b.subspan(0, m));
+  std::vector<uint64_t> z1(2 * (h + 1));
+  KaratsubaMultiply(a_sum, b_sum, absl::MakeSpan(z1));
+  SubWordsInPlace(absl::MakeSpan(z1), z0);
+  SubWordsInPlace(absl::MakeSpan(z1), z2);
+
+  // z1 < 2 * B^(m + h), so any words which don't fit in the result are zero.
+  absl::Span<uint64_t> z1_dst = result.subspan(m);
+  AddWordsInPlace(z1_dst,
+                  absl::MakeConstSpan(z1).subspan(
+                      0, std::min<int64_t>(z1.size(), z1_dst.size())));
+}
+
+// Returns the low `bit_count` bits of the product of the unsigned values with
+// the given words.
+Bits MultiplyWords(absl::Span<const uint64_t> a, absl::Span<const uint64_t> b,
+                   int64_t bit_count) {
+  const int64_t word_count = CeilOfRatio(bit_count, int64_t{64});
+  std::vector<uint64_t> product;
+  if (std::min(a.size(), b.size()) >= kKaratsubaThresholdWords) {
+    int64_t n = std::max(a.size(), b.size());
+    std::vector<uint64_t> a_padded(a.begin(), a.end());
+    std::vector<uint64_t> b_padded(b.begin(), b.end());
+    a_padded.resize(n);
+    b_padded.resize(n);
+    product.resize(2 * n);
+    KaratsubaMultiply(a_padded, b_padded, absl::MakeSpan(product));
+  } else {
+    product.resize(word_count);
+    SchoolbookMultiply(a, b, absl::MakeSpan(product));
+  }
+  return FromWords(product, bit_count);
+}
+
 // Converts the given bits value to signed value of the given bit count. Uses
 // truncation or sign-extension to narrow/widen the value.
 Bits TruncateOrSignExtend(Bits bits, int64_t bit_count) {
@@ -218,9 +387,9 @@ Bits Add(const Bits& lhs, const Bits& rhs) {
     return UBits(result, lhs.bit_count());
   }
 
-  Bits sum = BigInt::Add(BigInt::MakeSigned(lhs), BigInt::MakeSigned(rhs))
-                 .ToSignedBits();
-  return TruncateOrSignExtend(std::move(sum), lhs.bit_count());
+  std::vector<uint64_t> sum = Words(lhs);
+  AddWordsInPlace(absl::MakeSpan(sum), Words(rhs));
+  return FromWords(sum, lhs.bit_count());
 }
 
 Bits Sub(const Bits& lhs, const Bits& rhs) {
@@ -231,9 +400,9 @@ Bits Sub(const Bits& lhs, const Bits& rhs) {
     uint64_t result = (lhs_int - rhs_int) & Mask(lhs.bit_count());
     return UBits(result, lhs.bit_count());
   }
-  Bits diff = BigInt::Sub(BigInt::MakeSigned(lhs), BigInt::MakeSigned(rhs))
-                  .ToSignedBits();
-  return TruncateOrSignExtend(std::move(diff), lhs.bit_count());
+  std::vector<uint64_t> diff = Words(lhs);
+  SubWordsInPlace(absl::MakeSpan(diff), Words(rhs));
+  return FromWords(diff, lhs.bit_count());
 }
 
 Bits Increment(Bits x) {
@@ -270,10 +439,16 @@ Bits SMul(const Bits& lhs, const Bits& rhs) {
     int64_t result = lhs_int * rhs_int;
     return SBits(result, result_width);
   }
+  if (lhs.bit_count() <= 64 && rhs.bit_count() <= 64) {
+    absl::int128 product =
+        absl::int128{lhs.ToInt64().value()} * rhs.ToInt64().value();
+    return UBits128(static_cast<absl::uint128>(product), result_width);
+  }
 
-  BigInt product =
-      BigInt::Mul(BigInt::MakeSigned(lhs), BigInt::MakeSigned(rhs));
-  return product.ToSignedBitsWithBitCount(result_width).value();
+  // The product of the sign-extended operands truncated to the result width is
+  // the signed product, as the result width is wide enough to hold it.
+  return MultiplyWords(Words(SignExtend(lhs, result_width)),
+                       Words(SignExtend(rhs, result_width)), result_width);
 }
 
 Bits UMul(const Bits& lhs, const Bits& rhs) {
@@ -284,16 +459,26 @@ Bits UMul(const Bits& lhs, const Bits& rhs) {
     uint64_t result = lhs_int * rhs_int;
     return UBits(result, result_width);
   }
+  if (lhs.bit_count() <= 64 && rhs.bit_count() <= 64) {
+    absl::uint128 product =
+        absl::uint128{lhs.ToUint64().value()} * rhs.ToUint64().value();
+    return UBits128(product, result_width);
+  }
 
-  BigInt product =
-      BigInt::Mul(BigInt::MakeUnsigned(lhs), BigInt::MakeUnsigned(rhs));
-  return product.ToUnsignedBitsWithBitCount(result_width).value();
+  return MultiplyWords(Words(lhs), Words(rhs), result_width);
 }
 
 Bits UDiv(const Bits& lhs, const Bits& rhs) {
   if (rhs.IsZero()) {
     return Bits::AllOnes(lhs.bit_count());
   }
+  if (lhs.bit_count() <= 64 && rhs.bit_count() <= 64) {
+    return UBits(lhs.ToUint64().value() / rhs.ToUint64().value(),
+                 lhs.bit_count());
+  }
+  if (lhs.bit_count() <= 128 && rhs.bit_count() <= 128) {
+    return UBits128(ToUint128(lhs) / ToUint128(rhs), lhs.bit_count());
+  }
   BigInt quotient =
       BigInt::Div(BigInt::MakeUnsigned(lhs), BigInt::MakeUnsigned(rhs));
   return ZeroExtend(quotient.ToUnsignedBits(), lhs.bit_count());
@@ -303,6 +488,13 @@ Bits UMod(const Bits& lhs, const Bits& rhs) {
   if (rhs.IsZero()) {
     return Bits(rhs.bit_count());
   }
+  if (lhs.bit_count() <= 64 && rhs.bit_count() <= 64) {
+    return UBits(lhs.ToUint64().value() % rhs.ToUint64().value(),
+                 rhs.bit_count());
+  }
+  if (lhs.bit_count() <= 128 && rhs.bit_count() <= 128) {
+    return UBits128(ToUint128(lhs) % ToUint128(rhs), rhs.bit_count());
+  }
   BigInt modulo =
       BigInt::Mod(BigInt::MakeUnsigned(lhs), BigInt::MakeUnsigned(rhs));
   return ZeroExtend(modulo.ToUnsignedBits(), rhs.bit_count());
@@ -322,6 +514,13 @@ Bits SDiv(const Bits& lhs, const Bits& rhs) {
     // 0b0111...111.
     return ZeroExtend(Bits::AllOnes(lhs.bit_count() - 1), lhs.bit_count());
   }
+  if (lhs.bit_count() <= 64 && rhs.bit_count() <= 64) {
+    // Divide in 128 bits so that dividing the minimum value by -1 can't
+    // overflow. Like BigInt::Div this rounds toward zero.
+    absl::int128 quotient =
+        absl::int128{lhs.ToInt64().value()} / rhs.ToInt64().value();
+    return UBits128(static_cast<absl::uint128>(quotient), lhs.bit_count());
+  }
   BigInt quotient =
       BigInt::Div(BigInt::MakeSigned(lhs), BigInt::MakeSigned(rhs));
   return TruncateOrSignExtend(quotient.ToSignedBits(), lhs.bit_count());
@@ -331,6 +530,11 @@ Bits SMod(const Bits& lhs, const Bits& rhs) {
   if (rhs.IsZero()) {
     return Bits(rhs.bit_count());
   }
+  if (lhs.bit_count() <= 64 && rhs.bit_count() <= 64) {
+    absl::int128 modulo =
+        absl::int128{lhs.ToInt64().value()} % rhs.ToInt64().value();
+    return UBits128(static_cast<absl::uint128>(modulo), rhs.bit_count());
+  }
   BigInt modulo = BigInt::Mod(BigInt::MakeSigned(lhs), BigInt::MakeSigned(rhs));
   return TruncateOrSignExtend(modulo.ToSignedBits(), rhs.bit_count());
 }
@@ -409,6 +613,12 @@ bool ULessThan(const Bits& lhs, int64_t rhs) {
 }
 
 bool SEqual(const Bits& lhs, const Bits& rhs) {
+  if (lhs.bit_count() <= 64 && rhs.bit_count() <= 64) {
+    return lhs.ToInt64().value() == rhs.ToInt64().value();
+  }
+  if (lhs.bit_count() == rhs.bit_count()) {
+    return lhs == rhs;
+  }
   return BigInt::MakeSigned(lhs) == BigInt::MakeSigned(rhs);
 }
 
@@ -507,8 +717,8 @@ Bits Negate(const Bits& bits) {
     return UBits((-bits.ToInt64().value()) & Mask(bits.bit_count()),
                  bits.bit_count());
   }
-  Bits negated = BigInt::Negate(BigInt::MakeSigned(bits)).ToSignedBits();
-  return TruncateOrSignExtend(std::move(negated), bits.bit_count());
+  // Two's complement negation: -x == ~x + 1.
+  return Increment(Not(bits));
 }
 
 Bits Abs(const Bits& bits) {
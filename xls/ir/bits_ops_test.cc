@@ -17,6 +17,7 @@
 #include <array>
 #include <cstdint>
 #include <limits>
+#include <random>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,10 +26,12 @@
 #include "gtest/gtest.h"
 #include "xls/common/fuzzing/fuzztest.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "xls/common/status/matchers.h"
 #include "xls/data_structures/inline_bitmap.h"
+#include "xls/ir/big_int.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/bits_test_utils.h"
 #include "xls/ir/format_preference.h"
@@ -380,6 +383,113 @@ TEST(BitsOpsTest, SMod) {
             "0xffff_ffff_ffff_ffff_ffff_ffff_f000_a000_b000_c000");
 }
 
+// Returns a random value, biased toward words which are all zeros or all ones
+// to exercise carries, borrows and signs.
+Bits RandomBits(int64_t bit_count, std::mt19937_64& rng) {
+  InlineBitmap bitmap(bit_count);
+  for (int64_t i = 0; i < bitmap.word_count(); ++i) {
+    switch (rng() % 4) {
+      case 0:
+        bitmap.SetWord(i, 0);
+        break;
+      case 1:
+        bitmap.SetWord(i, std::numeric_limits<uint64_t>::max());
+        break;
+      default:
+        bitmap.SetWord(i, rng());
+        break;
+    }
+  }
+  return Bits::FromBitmap(std::move(bitmap));
+}
+
+Bits TruncateOrSignExtend(const Bits& bits, int64_t bit_count) {
+  return bits.bit_count() > bit_count
+             ? bits_ops::Truncate(bits, bit_count)
+             : bits_ops::SignExtend(bits, bit_count);
+}
+
+// The word-level implementations of the arithmetic operations should agree
+// with BigInt at every width, including those handled by 64-bit and 128-bit
+// fast paths and wide enough to use Karatsuba multiplication.
+TEST(BitsOpsTest, ArithmeticMatchesBigInt) {
+  std::mt19937_64 rng(42);
+  for (int64_t lhs_width :
+       {1, 7, 8, 32, 63, 64, 65, 100, 127, 128, 129, 200, 3000}) {
+    for (int64_t rhs_width : {1, 8, 63, 64, 65, 128, 200, 3000}) {
+      for (int64_t i = 0; i < 20; ++i) {
+        Bits lhs = RandomBits(lhs_width, rng);
+        Bits rhs = RandomBits(rhs_width, rng);
+        SCOPED_TRACE(absl::StrCat(BitsToString(lhs, FormatPreference::kHex),
+                                  ", ",
+                                  BitsToString(rhs, FormatPreference::kHex)));
+        BigInt lhs_unsigned = BigInt::MakeUnsigned(lhs);
+        BigInt rhs_unsigned = BigInt::MakeUnsigned(rhs);
+        BigInt lhs_signed = BigInt::MakeSigned(lhs);
+        BigInt rhs_signed = BigInt::MakeSigned(rhs);
+        int64_t product_width = lhs_width + rhs_width;
+
+        EXPECT_EQ(bits_ops::UMul(lhs, rhs),
+                  BigInt::Mul(lhs_unsigned, rhs_unsigned)
+                      .ToUnsignedBitsWithBitCount(product_width)
+                      .value());
+        EXPECT_EQ(bits_ops::SMul(lhs, rhs),
+                  BigInt::Mul(lhs_signed, rhs_signed)
+                      .ToSignedBitsWithBitCount(product_width)
+                      .value());
+        if (!rhs.IsZero()) {
+          EXPECT_EQ(bits_ops::UDiv(lhs, rhs),
+                    bits_ops::ZeroExtend(
+                        BigInt::Div(lhs_unsigned, rhs_unsigned)
+                            .ToUnsignedBits(),
+                        lhs_width));
+          EXPECT_EQ(bits_ops::UMod(lhs, rhs),
+                    bits_ops::ZeroExtend(
+                        BigInt::Mod(lhs_unsigned, rhs_unsigned)
+                            .ToUnsignedBits(),
+                        rhs_width));
+          EXPECT_EQ(bits_ops::SDiv(lhs, rhs),
+                    TruncateOrSignExtend(
+                        BigInt::Div(lhs_signed, rhs_signed).ToSignedBits(),
+                        lhs_width));
+          EXPECT_EQ(bits_ops::SMod(lhs, rhs),
+                    TruncateOrSignExtend(
+                        BigInt::Mod(lhs_signed, rhs_signed).ToSignedBits(),
+                        rhs_width));
+        }
+        EXPECT_EQ(bits_ops::SEqual(lhs, rhs), lhs_signed == rhs_signed);
+        EXPECT_EQ(bits_ops::SLessThan(lhs, rhs),
+                  BigInt::LessThan(lhs_signed, rhs_signed));
+
+        Bits same_width_rhs = RandomBits(lhs_width, rng);
+        BigInt same_width_rhs_signed = BigInt::MakeSigned(same_width_rhs);
+        EXPECT_EQ(bits_ops::Add(lhs, same_width_rhs),
+                  TruncateOrSignExtend(
+                      BigInt::Add(lhs_signed, same_width_rhs_signed)
+                          .ToSignedBits(),
+                      lhs_width));
+        EXPECT_EQ(bits_ops::Sub(lhs, same_width_rhs),
+                  TruncateOrSignExtend(
+                      BigInt::Sub(lhs_signed, same_width_rhs_signed)
+                          .ToSignedBits(),
+                      lhs_width));
+        EXPECT_EQ(bits_ops::Negate(lhs),
+                  TruncateOrSignExtend(
+                      BigInt::Negate(lhs_signed).ToSignedBits(), lhs_width));
+      }
+    }
+  }
+}
+
+TEST(BitsOpsTest, SignedDivisionOverflow) {
+  // The minimum value divided by -1 wraps around to the minimum value.
+  EXPECT_EQ(bits_ops::SDiv(Bits::MinSigned(64), SBits(-1, 64)),
+            Bits::MinSigned(64));
+  EXPECT_EQ(bits_ops::SMod(Bits::MinSigned(64), SBits(-1, 64)), UBits(0, 64));
+  EXPECT_EQ(bits_ops::SDiv(Bits::MinSigned(8), SBits(-1, 8)),
+            Bits::MinSigned(8));
+}
+
 TEST(BitsOpsTest, UnsignedComparisons) {
   Bits b42 = UBits(42, 64);
   Bits b77 = UBits(77, 64);
@@ -1228,5 +1338,107 @@ void BM_ZeroExtendMove(benchmark::State& state) {
 }
 BENCHMARK(BM_ZeroExtendMove)->Range(33, 1 << 20);
 
+// Benchmarks of the arithmetic operations, each paired with the equivalent
+// computation using BigInt for comparison.
+void ArithmeticWidths(benchmark::internal::Benchmark* b) {
+  for (int64_t width : {8, 32, 64, 100, 128, 256, 1024, 4096}) {
+    b->Arg(width);
+  }
+}
+
+void BM_Add(benchmark::State& state) {
+  std::mt19937_64 rng;
+  Bits lhs = RandomBits(state.range(0), rng);
+  Bits rhs = RandomBits(state.range(0), rng);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bits_ops::Add(lhs, rhs));
+  }
+}
+BENCHMARK(BM_Add)->Apply(ArithmeticWidths);
+
+void BM_AddBigInt(benchmark::State& state) {
+  std::mt19937_64 rng;
+  Bits lhs = RandomBits(state.range(0), rng);
+  Bits rhs = RandomBits(state.range(0), rng);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TruncateOrSignExtend(
+        BigInt::Add(BigInt::MakeSigned(lhs), BigInt::MakeSigned(rhs))
+            .ToSignedBits(),
+        state.range(0)));
+  }
+}
+BENCHMARK(BM_AddBigInt)->Apply(ArithmeticWidths);
+
+void BM_UMul(benchmark::State& state) {
+  std::mt19937_64 rng;
+  Bits lhs = RandomBits(state.range(0), rng);
+  Bits rhs = RandomBits(state.range(0), rng);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bits_ops::UMul(lhs, rhs));
+  }
+}
+BENCHMARK(BM_UMul)->Apply(ArithmeticWidths);
+
+void BM_UMulBigInt(benchmark::State& state) {
+  std::mt19937_64 rng;
+  Bits lhs = RandomBits(state.range(0), rng);
+  Bits rhs = RandomBits(state.range(0), rng);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        BigInt::Mul(BigInt::MakeUnsigned(lhs), BigInt::MakeUnsigned(rhs))
+            .ToUnsignedBitsWithBitCount(2 * state.range(0))
+            .value());
+  }
+}
+BENCHMARK(BM_UMulBigInt)->Apply(ArithmeticWidths);
+
+void BM_SMul(benchmark::State& state) {
+  std::mt19937_64 rng;
+  Bits lhs = RandomBits(state.range(0), rng);
+  Bits rhs = RandomBits(state.range(0), rng);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bits_ops::SMul(lhs, rhs));
+  }
+}
+BENCHMARK(BM_SMul)->Apply(ArithmeticWidths);
+
+void BM_SMulBigInt(benchmark::State& state) {
+  std::mt19937_64 rng;
+  Bits lhs = RandomBits(state.range(0), rng);
+  Bits rhs = RandomBits(state.range(0), rng);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        BigInt::Mul(BigInt::MakeSigned(lhs), BigInt::MakeSigned(rhs))
+            .ToSignedBitsWithBitCount(2 * state.range(0))
+            .value());
+  }
+}
+BENCHMARK(BM_SMulBigInt)->Apply(ArithmeticWidths);
+
+void BM_UDiv(benchmark::State& state) {
+  std::mt19937_64 rng;
+  Bits lhs = RandomBits(state.range(0), rng);
+  Bits rhs = bits_ops::Or(RandomBits(state.range(0), rng),
+                          UBits(1, state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bits_ops::UDiv(lhs, rhs));
+  }
+}
+BENCHMARK(BM_UDiv)->Apply(ArithmeticWidths);
+
+void BM_UDivBigInt(benchmark::State& state) {
+  std::mt19937_64 rng;
+  Bits lhs = RandomBits(state.range(0), rng);
+  Bits rhs = bits_ops::Or(RandomBits(state.range(0), rng),
+                          UBits(1, state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bits_ops::ZeroExtend(
+        BigInt::Div(BigInt::MakeUnsigned(lhs), BigInt::MakeUnsigned(rhs))
+            .ToUnsignedBits(),
+        state.range(0)));
+  }
+}
+BENCHMARK(BM_UDivBigInt)->Apply(ArithmeticWidths);
+
 }  // namespace
 }  // namespace xls
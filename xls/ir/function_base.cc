@@ -139,7 +139,7 @@ absl::Status FunctionBase::RemoveNode(Node* node) {
   XLS_RET_CHECK(!HasImplicitUse(node)) << node->GetName();
   VLOG(4) << absl::StrFormat("Removing node from FunctionBase %s: %s", name(),
                              node->ToString());
-  ++package()->transform_metrics().nodes_removed;
+  ++transform_metrics().nodes_removed;
   std::vector<Node*> unique_operands;
   for (Node* operand : node->operands()) {
     if (!absl::c_linear_search(unique_operands, operand)) {
@@ -243,10 +243,37 @@ Block* FunctionBase::AsBlockOrDie() {
   return down_cast<Block*>(this);
 }
 
+int64_t FunctionBase::AllocateNodeId() {
+  if (concurrent_modification_.has_value()) {
+    return concurrent_modification_->next_node_id++;
+  }
+  return package()->GetNextNodeIdAndIncrement();
+}
+
+TransformMetrics& FunctionBase::transform_metrics() {
+  if (concurrent_modification_.has_value()) {
+    return concurrent_modification_->metrics;
+  }
+  return package()->transform_metrics();
+}
+
+void FunctionBase::RenumberNode(Node* node, int64_t new_id) {
+  // Next nodes are stored in sets ordered by id, so they must be reinserted.
+  std::optional<StateRead*> state_read;
+  if (node->Is<Next>() && node->As<Next>()->state_read()->Is<StateRead>()) {
+    state_read = node->As<Next>()->state_read()->As<StateRead>();
+    next_values_by_state_read_.at(*state_read).erase(node->As<Next>());
+  }
+  node->SetId(new_id);
+  if (state_read.has_value()) {
+    next_values_by_state_read_.at(*state_read).insert(node->As<Next>());
+  }
+}
+
 Node* FunctionBase::AddNodeInternal(std::unique_ptr<Node> node) {
   VLOG(4) << absl::StrFormat("Adding node to FunctionBase %s: %s", name(),
                              node->ToString());
-  ++package()->transform_metrics().nodes_added;
+  ++transform_metrics().nodes_added;
   if (node->Is<Param>()) {
     params_.push_back(node->As<Param>());
   }
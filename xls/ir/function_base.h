@@ -184,6 +184,16 @@ class FunctionBase {
     return node_name_uniquer_.GetSanitizedUniqueName(name);
   }
 
+  // Returns a fresh id for a node being added to this function. Ids are drawn
+  // from the package, except while the function is being modified concurrently
+  // with other functions (see Package::BeginConcurrentModification).
+  int64_t AllocateNodeId();
+
+  // Returns the metrics into which transformations of this function should be
+  // recorded. This is the package's metrics, except while the function is being
+  // modified concurrently with other functions.
+  TransformMetrics& transform_metrics();
+
   // Returns whether this FunctionBase is a function, proc, or block.
   bool IsFunction() const;
   bool IsProc() const;
@@ -268,6 +278,21 @@ class FunctionBase {
   std::optional<xls::ForeignFunctionData> foreign_function_;
 
   std::vector<ChangeListener*> change_listeners_;
+
+ private:
+  friend class Package;
+
+  // Changes the id of `node`, keeping id-ordered containers consistent.
+  void RenumberNode(Node* node, int64_t new_id);
+
+  // Node-id allocation and metrics local to this function; only set between
+  // Package::BeginConcurrentModification and EndConcurrentModification.
+  struct ConcurrentModificationState {
+    int64_t first_node_id;
+    int64_t next_node_id;
+    TransformMetrics metrics;
+  };
+  std::optional<ConcurrentModificationState> concurrent_modification_;
 };
 
 inline absl::Span<ChangeListener* const> GetChangeListeners(
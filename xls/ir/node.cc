@@ -57,7 +57,7 @@ namespace xls {
 Node::Node(Op op, Type* type, const SourceInfo& loc, std::string_view name,
            FunctionBase* function_base)
     : function_base_(function_base),
-      id_(function_base_->package()->GetNextNodeIdAndIncrement()),
+      id_(function_base_->AllocateNodeId()),
       op_(op),
       type_(type),
       loc_(loc),
@@ -830,7 +830,7 @@ bool Node::ReplaceOperand(Node* old_operand, Node* new_operand) {
   if (this == new_operand) {
     return true;
   }
-  ++package()->transform_metrics().operands_replaced;
+  ++function_base_->transform_metrics().operands_replaced;
   std::vector<int64_t> replaced_operands;
   for (int64_t i = 0; i < operand_count(); ++i) {
     if (operands_[i] == old_operand) {
@@ -857,7 +857,7 @@ absl::Status Node::ReplaceOperandNumber(int64_t operand_no, Node* new_operand,
         << "old operand type: " << old_operand->GetType()->ToString()
         << " new operand type: " << new_operand->GetType()->ToString();
   }
-  ++package()->transform_metrics().operands_replaced;
+  ++function_base_->transform_metrics().operands_replaced;
 
   // AddUser is idempotent so even if the new operand is already used by this
   // node in another operand slot, it is safe to call.
@@ -879,7 +879,7 @@ absl::Status Node::ReplaceOperandNumber(int64_t operand_no, Node* new_operand,
 absl::Status Node::RemoveOptionalOperand(int64_t operand_no) {
   XLS_RET_CHECK_LE(operand_no, operands_.size() - 1);
   Node* old_operand = operands_[operand_no];
-  ++package()->transform_metrics().operands_removed;
+  ++function_base_->transform_metrics().operands_removed;
 
   operands_.erase(operands_.begin() + operand_no);
 
@@ -902,7 +902,7 @@ absl::Status Node::ReplaceUsesWith(Node* replacement,
   XLS_RET_CHECK(GetType() == replacement->GetType())
       << "type was: " << GetType()->ToString()
       << " replacement: " << replacement->GetType()->ToString();
-  ++package()->transform_metrics().nodes_replaced;
+  ++function_base_->transform_metrics().nodes_replaced;
   bool all_replaced = true;
   std::vector<Node*> orig_users(users().begin(), users().end());
   for (Node* user : orig_users) {
@@ -408,6 +408,59 @@ std::vector<FunctionBase*> Package::GetFunctionBases() const {
   return result;
 }
 
+void Package::BeginConcurrentModification(
+    absl::Span<FunctionBase* const> function_bases) {
+  CHECK(!under_concurrent_modification_)
+      << "package is already being modified concurrently";
+  under_concurrent_modification_ = true;
+  type_manager_.SetConcurrentAccess(true);
+  for (FunctionBase* fb : function_bases) {
+    CHECK_EQ(fb->package(), this);
+    CHECK(!fb->concurrent_modification_.has_value())
+        << fb->name() << " is already being modified concurrently";
+    fb->concurrent_modification_ = FunctionBase::ConcurrentModificationState{
+        .first_node_id = next_node_id_,
+        .next_node_id = next_node_id_,
+        .metrics = {},
+    };
+  }
+}
+
+void Package::EndConcurrentModification(
+    absl::Span<FunctionBase* const> function_bases) {
+  for (FunctionBase* fb : function_bases) {
+    CHECK(fb->concurrent_modification_.has_value())
+        << fb->name() << " is not being modified concurrently";
+    FunctionBase::ConcurrentModificationState state =
+        *std::move(fb->concurrent_modification_);
+    fb->concurrent_modification_.reset();
+    transform_metrics_ = transform_metrics_ + state.metrics;
+
+    // Serially, this FunctionBase's new nodes would have been numbered
+    // consecutively after those of the preceding FunctionBases; shift them all
+    // by the same offset. Renumbering from the newest node down ensures that no
+    // new id collides with a not-yet-renumbered one.
+    const int64_t base = next_node_id_;
+    const int64_t offset = base - state.first_node_id;
+    if (offset != 0) {
+      std::vector<Node*> new_nodes;
+      for (Node* node : fb->nodes()) {
+        if (node->id() >= state.first_node_id) {
+          new_nodes.push_back(node);
+        }
+      }
+      std::sort(new_nodes.begin(), new_nodes.end(),
+                [](Node* a, Node* b) { return a->id() > b->id(); });
+      for (Node* node : new_nodes) {
+        fb->RenumberNode(node, node->id() + offset);
+      }
+    }
+    next_node_id_ = base + (state.next_node_id - state.first_node_id);
+  }
+  type_manager_.SetConcurrentAccess(false);
+  under_concurrent_modification_ = false;
+}
+
 absl::Status Package::RemoveFunctionBase(FunctionBase* function_base) {
   if (function_base->IsFunction()) {
     return RemoveFunction(function_base->AsFunctionOrDie());
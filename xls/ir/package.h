@@ -436,6 +436,30 @@ class Package {
   }
   TransformMetrics& transform_metrics() { return transform_metrics_; }
 
+  // Prepares the given FunctionBases to be modified concurrently with each
+  // other, e.g. by running a function-local pass on each in its own thread.
+  // Until EndConcurrentModification is called, nodes added to each FunctionBase
+  // get ids which are only unique within that FunctionBase, and transform
+  // metrics are recorded per FunctionBase, and the type manager may be used
+  // from several threads. Other package-level state must not be modified in
+  // the meantime.
+  void BeginConcurrentModification(
+      absl::Span<FunctionBase* const> function_bases);
+
+  // Ends concurrent modification of the given FunctionBases, which must be
+  // those passed to BeginConcurrentModification. Nodes added in the meantime
+  // are renumbered exactly as if the FunctionBases had been modified one after
+  // the other in the given order, so results do not depend on scheduling.
+  void EndConcurrentModification(
+      absl::Span<FunctionBase* const> function_bases);
+
+  // Returns whether FunctionBases of this package are currently being modified
+  // concurrently, i.e. between BeginConcurrentModification and
+  // EndConcurrentModification.
+  bool IsUnderConcurrentModification() const {
+    return under_concurrent_modification_;
+  }
+
  private:
   std::vector<std::string> GetChannelNames() const;
 
@@ -456,6 +480,10 @@ class Package {
   // Ordinal to assign to the next node created in this package.
   int64_t next_node_id_ = 1;
 
+  // Whether BeginConcurrentModification has been called without a matching
+  // EndConcurrentModification.
+  bool under_concurrent_modification_ = false;
+
   std::vector<std::unique_ptr<Function>> functions_;
   std::vector<std::unique_ptr<Proc>> procs_;
   std::vector<std::unique_ptr<Block>> blocks_;
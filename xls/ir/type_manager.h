@@ -24,6 +24,7 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
@@ -31,6 +32,8 @@
 
 namespace xls {
 
+// Owns and interns the types of a package. Types may only be requested from
+// several threads concurrently while concurrent access is enabled.
 class TypeManager {
  public:
   explicit TypeManager();
@@ -42,9 +45,11 @@ class TypeManager {
   TypeManager& operator=(const TypeManager&) = delete;
   // Returns whether the given type is one of the types owned by this package.
   bool IsOwnedType(const Type* type) const {
-    return owned_types_.find(type) != owned_types_.end();
+    absl::MutexLockMaybe lock(mutex());
+    return IsOwnedTypeLocked(type);
   }
   bool IsOwnedFunctionType(const FunctionType* function_type) const {
+    absl::MutexLockMaybe lock(mutex());
     return owned_function_types_.find(function_type) !=
            owned_function_types_.end();
   }
@@ -66,7 +71,28 @@ class TypeManager {
 
   Type* GetTypeForValue(const Value& value);
 
+  // Sets whether types may be requested from several threads concurrently, in
+  // which case the tables are guarded by a mutex. Must not be called while
+  // types are being requested.
+  void SetConcurrentAccess(bool concurrent_access) {
+    concurrent_access_ = concurrent_access;
+  }
+
  private:
+  bool IsOwnedTypeLocked(const Type* type) const {
+    return owned_types_.find(type) != owned_types_.end();
+  }
+
+  // Returns the mutex guarding the tables below, or null if they are only
+  // accessed from one thread so locking is unnecessary.
+  absl::Mutex* mutex() const {
+    return concurrent_access_ ? mu_.get() : nullptr;
+  }
+
+  bool concurrent_access_ = false;
+  // Held by pointer to keep the type manager movable.
+  std::unique_ptr<absl::Mutex> mu_ = std::make_unique<absl::Mutex>();
+
   // Set of owned types in this package.
   absl::flat_hash_set<const Type*> owned_types_;
 
@@ -24,6 +24,7 @@
 #include <variant>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/log.h"
@@ -40,6 +41,7 @@
 #include "xls/ir/block.h"
 #include "xls/ir/block_elaboration.h"
 #include "xls/ir/caret.h"
+#include "xls/ir/change_listener.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/code_template.h"
 #include "xls/ir/dfs_visitor.h"
@@ -105,42 +107,20 @@ absl::Status VerifyName(FunctionBase* function_base) {
   return absl::OkStatus();
 }
 
-// Verify common invariants to function-level constructs.
-absl::Status VerifyFunctionBase(FunctionBase* function) {
-  VLOG(2) << absl::StreamFormat("Verifying function %s:", function->name());
-  XLS_VLOG_LINES(4, function->DumpIr());
-
-  XLS_RETURN_IF_ERROR(VerifyName(function));
-
-  // Verify all types are owned by package.
-  for (Node* node : function->nodes()) {
-    XLS_RET_CHECK(node->package()->IsOwnedType(node->GetType()));
-    XLS_RET_CHECK(node->package() == function->package());
-  }
-
-  // Verify ids are unique within the function.
-  std::vector<bool> ids_seen(function->package()->next_node_id());
-  int64_t max_id_seen = -1;
-  for (Node* node : function->nodes()) {
-    XLS_RETURN_IF_ERROR(VerifyNodeIdUnique(node, &ids_seen, &max_id_seen));
-  }
-
-  // Verify that there are no cycles in the node graph.
+// Verify that there are no cycles in the node graph.
+absl::Status VerifyAcyclic(FunctionBase* function) {
   class CycleChecker : public DfsVisitorWithDefault {
     absl::Status DefaultHandler(Node* node) override {
       return absl::OkStatus();
     }
   };
   CycleChecker cycle_checker;
-  XLS_RETURN_IF_ERROR(function->Accept(&cycle_checker));
-
-  // Verify consistency of node::users() and node::operands().
-  for (Node* node : function->nodes()) {
-    XLS_RETURN_IF_ERROR(VerifyNode(node));
-  }
+  return function->Accept(&cycle_checker);
+}
 
-  // Verify the set of parameter nodes is exactly Function::params(), and that
-  // the parameter names are unique.
+// Verify the set of parameter nodes is exactly Function::params(), and that
+// the parameter names are unique.
+absl::Status VerifyParams(FunctionBase* function) {
   absl::flat_hash_set<std::string> param_names;
   absl::flat_hash_set<Node*> param_set;
   for (Node* param : function->params()) {
@@ -166,6 +146,36 @@ absl::Status VerifyFunctionBase(FunctionBase* function) {
   return absl::OkStatus();
 }
 
+// Verify common invariants to function-level constructs.
+absl::Status VerifyFunctionBase(FunctionBase* function) {
+  VLOG(2) << absl::StreamFormat("Verifying function %s:", function->name());
+  XLS_VLOG_LINES(4, function->DumpIr());
+
+  XLS_RETURN_IF_ERROR(VerifyName(function));
+
+  // Verify all types are owned by package.
+  for (Node* node : function->nodes()) {
+    XLS_RET_CHECK(node->package()->IsOwnedType(node->GetType()));
+    XLS_RET_CHECK(node->package() == function->package());
+  }
+
+  // Verify ids are unique within the function.
+  std::vector<bool> ids_seen(function->package()->next_node_id());
+  int64_t max_id_seen = -1;
+  for (Node* node : function->nodes()) {
+    XLS_RETURN_IF_ERROR(VerifyNodeIdUnique(node, &ids_seen, &max_id_seen));
+  }
+
+  XLS_RETURN_IF_ERROR(VerifyAcyclic(function));
+
+  // Verify consistency of node::users() and node::operands().
+  for (Node* node : function->nodes()) {
+    XLS_RETURN_IF_ERROR(VerifyNode(node));
+  }
+
+  return VerifyParams(function);
+}
+
 // Verify various invariants about the channels owned by the given package.
 absl::Status VerifyChannels(Package* package, bool codegen) {
   // All channels must be proc-scoped or no channels should be proc scoped.
@@ -526,6 +536,16 @@ absl::Status VerifyBlockChannelMetadata(Block* block) {
   return absl::OkStatus();
 }
 
+// Verify that `node`, a node of a function, is not a send or receive.
+absl::Status VerifyNotChannelOperation(Node* node) {
+  if (node->Is<Send>() || node->Is<Receive>()) {
+    return absl::InternalError(absl::StrFormat(
+        "Send and receive nodes can only be in procs, not functions (%s)",
+        node->GetName()));
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 absl::Status VerifyPackage(Package* package, bool codegen) {
@@ -604,11 +624,7 @@ absl::Status VerifyFunction(Function* function, bool codegen) {
   XLS_RETURN_IF_ERROR(VerifyFunctionBase(function));
 
   for (Node* node : function->nodes()) {
-    if (node->Is<Send>() || node->Is<Receive>()) {
-      return absl::InternalError(absl::StrFormat(
-          "Send and receive nodes can only be in procs, not functions (%s)",
-          node->GetName()));
-    }
+    XLS_RETURN_IF_ERROR(VerifyNotChannelOperation(node));
   }
 
   return absl::OkStatus();
@@ -1182,4 +1198,256 @@ absl::Status VerifyBlock(Block* block, bool codegen) {
   return absl::OkStatus();
 }
 
+// Records the changes made to a single FunctionBase since it was last
+// verified.
+class IncrementalVerifier::Recorder : public ChangeListener {
+ public:
+  explicit Recorder(FunctionBase* function_base)
+      : function_base_(function_base), name_(function_base->name()) {
+    function_base_->RegisterChangeListener(this);
+  }
+
+  // Returns whether this recorder is registered with `function_base_`, i.e.
+  // whether `function_base_` is still the FunctionBase it was created for. May
+  // only be called if `function_base_` is alive.
+  bool IsRegistered() const {
+    return absl::c_linear_search(function_base_->ChangeListeners(), this);
+  }
+  void Unregister() { function_base_->UnregisterChangeListener(this); }
+
+  std::string_view name() const { return name_; }
+  bool HasChanges() const { return !touched_.empty() || edges_changed_; }
+  bool edges_changed() const { return edges_changed_; }
+  bool params_changed() const { return params_changed_; }
+  bool channel_operations_changed() const {
+    return channel_operations_changed_;
+  }
+
+  // Returns the nodes which were added or changed, and the nodes whose users
+  // changed, ordered by id.
+  std::vector<Node*> TouchedNodes() const {
+    std::vector<Node*> nodes(touched_.begin(), touched_.end());
+    std::sort(nodes.begin(), nodes.end(), Node::NodeIdLessThan());
+    return nodes;
+  }
+
+  void Clear() {
+    touched_.clear();
+    edges_changed_ = false;
+    params_changed_ = false;
+    channel_operations_changed_ = false;
+  }
+
+  void NodeAdded(Node* node) override {
+    Touch(node);
+    for (Node* operand : node->operands()) {
+      touched_.insert(operand);
+    }
+  }
+  void NodeDeleted(Node* node) override {
+    // The node may no longer be verified, but its operands lost a user.
+    Touch(node);
+    touched_.erase(node);
+    for (Node* operand : node->operands()) {
+      touched_.insert(operand);
+    }
+  }
+  void OperandChanged(Node* node, Node* old_operand,
+                      absl::Span<const int64_t> operand_nos) override {
+    touched_.insert(node);
+    touched_.insert(old_operand);
+    for (int64_t operand_no : operand_nos) {
+      touched_.insert(node->operand(operand_no));
+    }
+    edges_changed_ = true;
+  }
+  void OperandRemoved(Node* node, Node* old_operand) override {
+    touched_.insert(node);
+    touched_.insert(old_operand);
+  }
+  void OperandAdded(Node* node) override {
+    touched_.insert(node);
+    touched_.insert(node->operands().back());
+    edges_changed_ = true;
+  }
+  void ReturnValueChanged(Function* function_base,
+                          Node* old_return_value) override {
+    touched_.insert(function_base->return_value());
+    touched_.insert(old_return_value);
+  }
+  void NextStateElementChanged(Proc* proc, int64_t state_index,
+                               Node* old_next_state_element) override {
+    touched_.insert(old_next_state_element);
+  }
+
+ private:
+  void Touch(Node* node) {
+    touched_.insert(node);
+    params_changed_ = params_changed_ || node->Is<Param>();
+    channel_operations_changed_ = channel_operations_changed_ ||
+                                  node->Is<Send>() || node->Is<Receive>();
+  }
+
+  FunctionBase* function_base_;
+  std::string name_;
+  absl::flat_hash_set<Node*> touched_;
+  bool edges_changed_ = false;
+  bool params_changed_ = false;
+  bool channel_operations_changed_ = false;
+};
+
+IncrementalVerifier::IncrementalVerifier(Package* package, bool codegen,
+                                         int64_t full_verification_interval)
+    : package_(package),
+      codegen_(codegen),
+      full_verification_interval_(full_verification_interval) {}
+
+IncrementalVerifier::~IncrementalVerifier() {
+  // FunctionBases removed from the package may have been destroyed, so only
+  // unregister from those which are still present.
+  for (FunctionBase* function_base : package_->GetFunctionBases()) {
+    auto it = recorders_.find(function_base);
+    if (it != recorders_.end() && it->second->IsRegistered()) {
+      it->second->Unregister();
+    }
+  }
+}
+
+std::vector<const void*> IncrementalVerifier::ChannelSignature() const {
+  std::vector<const void*> signature(package_->channels().begin(),
+                                     package_->channels().end());
+  for (const std::unique_ptr<Proc>& proc : package_->procs()) {
+    signature.push_back(proc.get());
+    for (Channel* channel : proc->channels()) {
+      signature.push_back(channel);
+    }
+    for (ChannelInterface* channel_interface : proc->interface()) {
+      signature.push_back(channel_interface);
+    }
+    for (const std::unique_ptr<ProcInstantiation>& instantiation :
+         proc->proc_instantiations()) {
+      signature.push_back(instantiation.get());
+    }
+  }
+  return signature;
+}
+
+bool IncrementalVerifier::PackageStructureChanged() const {
+  std::vector<FunctionBase*> function_bases = package_->GetFunctionBases();
+  if (function_bases.size() != recorders_.size()) {
+    return true;
+  }
+  for (FunctionBase* function_base : function_bases) {
+    auto it = recorders_.find(function_base);
+    if (it == recorders_.end() || !it->second->IsRegistered() ||
+        it->second->name() != function_base->name()) {
+      return true;
+    }
+  }
+  return ChannelSignature() != channel_signature_;
+}
+
+absl::Status IncrementalVerifier::Verify() {
+  ++verification_count_;
+  if (verification_count_ == 1 ||
+      (full_verification_interval_ > 0 &&
+       verification_count_ % full_verification_interval_ == 0) ||
+      PackageStructureChanged()) {
+    return VerifyFull();
+  }
+  return VerifyChanges();
+}
+
+absl::Status IncrementalVerifier::VerifyFull() {
+  ++full_verification_count_;
+  // Track every FunctionBase of the package, including any added since the
+  // last verification.
+  absl::flat_hash_map<FunctionBase*, std::unique_ptr<Recorder>> recorders;
+  for (FunctionBase* function_base : package_->GetFunctionBases()) {
+    auto it = recorders_.find(function_base);
+    if (it != recorders_.end() && it->second->IsRegistered() &&
+        it->second->name() == function_base->name()) {
+      it->second->Clear();
+      recorders[function_base] = std::move(it->second);
+    } else {
+      if (it != recorders_.end() && it->second->IsRegistered()) {
+        it->second->Unregister();
+      }
+      recorders[function_base] = std::make_unique<Recorder>(function_base);
+    }
+  }
+  recorders_ = std::move(recorders);
+  channel_signature_ = ChannelSignature();
+  return VerifyPackage(package_, codegen_);
+}
+
+absl::Status IncrementalVerifier::VerifyChanges() {
+  bool channel_operations_changed = false;
+  for (FunctionBase* function_base : package_->GetFunctionBases()) {
+    Recorder& recorder = *recorders_.at(function_base);
+    if (!recorder.HasChanges()) {
+      continue;
+    }
+    channel_operations_changed = channel_operations_changed ||
+                                 recorder.channel_operations_changed();
+    absl::Status status = VerifyFunctionBaseChanges(function_base, recorder);
+    recorder.Clear();
+    XLS_RETURN_IF_ERROR(status);
+  }
+  if (channel_operations_changed) {
+    XLS_RETURN_IF_ERROR(VerifyChannels(package_, codegen_));
+    XLS_RETURN_IF_ERROR(VerifyElaboration(package_));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status IncrementalVerifier::VerifyFunctionBaseChanges(
+    FunctionBase* function_base, const Recorder& recorder) {
+  VLOG(2) << absl::StreamFormat("Incrementally verifying %s:",
+                                function_base->name());
+  if (function_base->IsBlock()) {
+    // Blocks have many invariants which are not local to the changed nodes
+    // (ports, registers, instantiations) so they are verified in full.
+    return VerifyBlock(function_base->AsBlockOrDie(), codegen_);
+  }
+
+  // Verify the changed nodes and their users, whose operands' types may have
+  // changed.
+  absl::flat_hash_set<Node*> verified;
+  auto verify_node = [&](Node* node) -> absl::Status {
+    if (!verified.insert(node).second) {
+      return absl::OkStatus();
+    }
+    XLS_RET_CHECK(node->function_base() == function_base) << node->GetName();
+    XLS_RET_CHECK(package_->IsOwnedType(node->GetType())) << node->GetName();
+    XLS_RET_CHECK_LT(node->id(), package_->next_node_id()) << node->GetName();
+    if (function_base->IsFunction()) {
+      XLS_RETURN_IF_ERROR(VerifyNotChannelOperation(node));
+    }
+    return VerifyNode(node);
+  };
+  for (Node* node : recorder.TouchedNodes()) {
+    XLS_RETURN_IF_ERROR(verify_node(node));
+    for (Node* user : node->users()) {
+      XLS_RETURN_IF_ERROR(verify_node(user));
+    }
+  }
+
+  // Only a change of operands can introduce a cycle.
+  if (recorder.edges_changed()) {
+    XLS_RETURN_IF_ERROR(VerifyAcyclic(function_base));
+  }
+  if (recorder.params_changed()) {
+    XLS_RETURN_IF_ERROR(VerifyParams(function_base));
+  }
+  if (function_base->IsProc()) {
+    Proc* proc = function_base->AsProcOrDie();
+    XLS_RET_CHECK(proc->params().empty());
+    if (recorder.channel_operations_changed() && proc->is_new_style_proc()) {
+      XLS_RETURN_IF_ERROR(VerifyProcScopedChannels(proc));
+    }
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace xls
@@ -15,12 +15,18 @@
 #ifndef XLS_IR_VERIFIER_H_
 #define XLS_IR_VERIFIER_H_
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 
 namespace xls {
 
 class Node;
 class Function;
+class FunctionBase;
 class Proc;
 class Block;
 class Package;
@@ -32,6 +38,59 @@ absl::Status VerifyFunction(Function* function, bool codegen = false);
 absl::Status VerifyProc(Proc* Proc, bool codegen = false);
 absl::Status VerifyBlock(Block* Block, bool codegen = false);
 
+// Verifies a package repeatedly as it is transformed (e.g., between
+// optimization passes) by re-verifying only what changed since the previous
+// verification: the nodes added or changed, as seen by change listeners, and
+// their users, the acyclicity of the functions and procs whose edges changed,
+// and the package-wide channel invariants if channel operations changed.
+// Blocks with any change are verified in full, as is the whole package if
+// functions, procs, blocks or channels were added, removed or renamed.
+//
+// Changes which are not visible to change listeners (e.g., renaming a node)
+// are only caught by a full verification. If `full_verification_interval` is
+// positive, every `full_verification_interval`-th verification verifies the
+// whole package regardless of what changed. The first verification is always
+// a full one.
+//
+// The package must outlive the verifier.
+class IncrementalVerifier {
+ public:
+  explicit IncrementalVerifier(Package* package, bool codegen = false,
+                               int64_t full_verification_interval = 0);
+  ~IncrementalVerifier();
+
+  IncrementalVerifier(const IncrementalVerifier&) = delete;
+  IncrementalVerifier& operator=(const IncrementalVerifier&) = delete;
+
+  Package* package() const { return package_; }
+
+  absl::Status Verify();
+
+  int64_t verification_count() const { return verification_count_; }
+  int64_t full_verification_count() const { return full_verification_count_; }
+
+ private:
+  class Recorder;
+
+  // Returns identities of the channels, channel interfaces and proc
+  // instantiations of the package, used to detect any change to them.
+  std::vector<const void*> ChannelSignature() const;
+  bool PackageStructureChanged() const;
+
+  absl::Status VerifyFull();
+  absl::Status VerifyChanges();
+  absl::Status VerifyFunctionBaseChanges(FunctionBase* function_base,
+                                         const Recorder& recorder);
+
+  Package* package_;
+  bool codegen_;
+  int64_t full_verification_interval_;
+  int64_t verification_count_ = 0;
+  int64_t full_verification_count_ = 0;
+  absl::flat_hash_map<FunctionBase*, std::unique_ptr<Recorder>> recorders_;
+  std::vector<const void*> channel_signature_;
+};
+
 }  // namespace xls
 
 #endif  // XLS_IR_VERIFIER_H_
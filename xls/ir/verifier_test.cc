@@ -14,7 +14,9 @@
 
 #include "xls/ir/verifier.h"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -30,6 +32,7 @@
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
 #include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
 #include "xls/ir/package.h"
 #include "xls/ir/source_location.h"
 #include "xls/ir/value.h"
@@ -722,5 +725,116 @@ proc my_new_proc<>() {}
                                  "proc-scoped channels")));
 }
 
+TEST_F(VerifierTest, IncrementalVerifierChecksChangedNodes) {
+  std::string input = R"(
+package incremental
+
+fn graph(p: bits[2], q: bits[42], r: bits[42]) -> bits[42] {
+  ret and.1: bits[42] = and(q, r)
+}
+
+fn other(x: bits[8]) -> bits[8] {
+  ret neg.2: bits[8] = neg(x)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackageNoVerify(input));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, p->GetFunction("graph"));
+  IncrementalVerifier verifier(p.get());
+  XLS_EXPECT_OK(verifier.Verify());
+  EXPECT_EQ(verifier.full_verification_count(), 1);
+
+  // A well-formed change is verified incrementally.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * not_q,
+      f->MakeNode<UnOp>(SourceInfo(), FindNode("q", f), Op::kNot));
+  EXPECT_TRUE(FindNode("and.1", f)->ReplaceOperand(FindNode("q", f), not_q));
+  XLS_EXPECT_OK(verifier.Verify());
+  EXPECT_EQ(verifier.verification_count(), 2);
+  EXPECT_EQ(verifier.full_verification_count(), 1);
+
+  // Replace lhs of the 'and' with a different bit-width value.
+  FindNode("and.1", f)->ReplaceOperand(not_q, FindNode("p", f));
+  EXPECT_THAT(verifier.Verify(),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("Expected operand 0 of and.1 to have type "
+                                 "bits[42], has type bits[2].")));
+  EXPECT_EQ(verifier.full_verification_count(), 1);
+}
+
+TEST_F(VerifierTest, IncrementalVerifierDetectsCycle) {
+  std::string input = R"(
+package incremental
+
+fn graph(q: bits[42], r: bits[42]) -> bits[42] {
+  and.1: bits[42] = and(q, r)
+  ret not.2: bits[42] = not(and.1)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackageNoVerify(input));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, p->GetFunction("graph"));
+  IncrementalVerifier verifier(p.get());
+  XLS_EXPECT_OK(verifier.Verify());
+
+  XLS_ASSERT_OK(
+      FindNode("and.1", f)->ReplaceOperandNumber(0, FindNode("not.2", f)));
+  EXPECT_THAT(verifier.Verify(), StatusIs(absl::StatusCode::kInternal,
+                                          HasSubstr("Cycle detected")));
+}
+
+TEST_F(VerifierTest, IncrementalVerifierChecksChannelInvariants) {
+  std::string input = R"(
+package incremental
+
+chan ch(bits[32], id=42, kind=streaming, ops=send_only, flow_control=none)
+
+proc my_proc(t: token, s: bits[32], init={token, 45}) {
+  send.1: token = send(t, s, channel=ch)
+  next (send.1, s)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackageNoVerify(input));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc, p->GetProc("my_proc"));
+  IncrementalVerifier verifier(p.get(), /*codegen=*/true);
+  XLS_EXPECT_OK(verifier.Verify());
+
+  Send* send = FindNode("send.1", proc)->As<Send>();
+  XLS_ASSERT_OK(proc->MakeNode<Send>(SourceInfo(), send, send->data(),
+                                     /*predicate=*/std::nullopt,
+                                     send->channel_name())
+                    .status());
+  EXPECT_THAT(
+      verifier.Verify(),
+      StatusIs(
+          absl::StatusCode::kInternal,
+          HasSubstr("Multiple sends associated with the same channel 'ch'")));
+}
+
+TEST_F(VerifierTest, IncrementalVerifierFullVerification) {
+  std::string input = R"(
+package incremental
+
+fn graph(x: bits[8]) -> bits[8] {
+  ret neg.1: bits[8] = neg(x)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackageNoVerify(input));
+  IncrementalVerifier verifier(p.get(), /*codegen=*/false,
+                               /*full_verification_interval=*/3);
+  for (int64_t i = 0; i < 6; ++i) {
+    XLS_EXPECT_OK(verifier.Verify());
+  }
+  // The first, third and sixth verifications were full ones.
+  EXPECT_EQ(verifier.full_verification_count(), 3);
+
+  // Adding a function requires a full verification.
+  FunctionBuilder fb("added", p.get());
+  fb.Param("y", p->GetBitsType(8));
+  XLS_ASSERT_OK(fb.Build().status());
+  XLS_EXPECT_OK(verifier.Verify());
+  EXPECT_EQ(verifier.full_verification_count(), 4);
+  XLS_EXPECT_OK(verifier.Verify());
+  EXPECT_EQ(verifier.full_verification_count(), 4);
+}
+
 }  // namespace
 }  // namespace xls
@@ -358,6 +358,10 @@ class BufferAllocator {
 // The maximum number of xls::Nodes in a partition.
 static constexpr int64_t kMaxPartitionSize = 100;
 
+// The minimum number of xls::Nodes in a partition, unless the partition is cut
+// short by an early exit point or the end of the function.
+static constexpr int64_t kMinPartitionSize = kMaxPartitionSize / 2;
+
 // Abstraction representing a point (partition function) at which an early exit
 // can occur.
 struct EarlyExitPoint {
@@ -400,10 +404,141 @@ bool ExecutionContinuesAfterNode(Node* node) {
   return node->Is<Send>();
 }
 
+// Returns a topological order of the nodes of `f` in which nodes tend to
+// closely follow their operands, so that values are more likely to be produced
+// and consumed within a single partition.
+//
+// Nodes are scheduled depth-first: users which become ready when a node is
+// scheduled are placed before nodes which were ready earlier. Nodes without
+// operands (e.g. literals) are placed just before their first user. The
+// relative order of side-effecting nodes is the same as in TopoSort, so the
+// order in which side effects and early exits occur is unchanged.
+std::vector<Node*> LocalityAwareTopoSort(FunctionBase* f) {
+  std::vector<Node*> topo_order = TopoSort(f);
+  auto is_deferred = [](Node* node) {
+    return node->operand_count() == 0 && !OpIsSideEffecting(node->op());
+  };
+  absl::flat_hash_map<Node*, int64_t> topo_index;
+  // The number of unscheduled distinct operands (and side-effecting
+  // predecessors) of each node.
+  absl::flat_hash_map<Node*, int64_t> pending;
+  absl::flat_hash_map<Node*, Node*> next_side_effect;
+  Node* previous_side_effect = nullptr;
+  for (int64_t i = 0; i < topo_order.size(); ++i) {
+    Node* node = topo_order[i];
+    topo_index[node] = i;
+    absl::flat_hash_set<Node*> operands;
+    for (Node* operand : node->operands()) {
+      if (!is_deferred(operand)) {
+        operands.insert(operand);
+      }
+    }
+    pending[node] = operands.size();
+    if (OpIsSideEffecting(node->op())) {
+      if (previous_side_effect != nullptr) {
+        next_side_effect[previous_side_effect] = node;
+        ++pending[node];
+      }
+      previous_side_effect = node;
+    }
+  }
+
+  // Stack of ready nodes; the top is scheduled next.
+  std::vector<Node*> ready;
+  for (auto it = topo_order.rbegin(); it != topo_order.rend(); ++it) {
+    if (!is_deferred(*it) && pending.at(*it) == 0) {
+      ready.push_back(*it);
+    }
+  }
+  std::vector<Node*> order;
+  order.reserve(topo_order.size());
+  absl::flat_hash_set<Node*> scheduled;
+  std::vector<Node*> newly_ready;
+  auto release = [&](Node* node) {
+    if (--pending.at(node) == 0) {
+      newly_ready.push_back(node);
+    }
+  };
+  while (!ready.empty()) {
+    Node* node = ready.back();
+    ready.pop_back();
+    for (Node* operand : node->operands()) {
+      if (is_deferred(operand) && scheduled.insert(operand).second) {
+        order.push_back(operand);
+      }
+    }
+    order.push_back(node);
+    scheduled.insert(node);
+
+    newly_ready.clear();
+    for (Node* user : node->users()) {
+      release(user);
+    }
+    if (auto it = next_side_effect.find(node); it != next_side_effect.end()) {
+      release(it->second);
+    }
+    // Schedule the earliest (in TopoSort order) of the newly ready nodes first.
+    absl::c_sort(newly_ready, [&](Node* a, Node* b) {
+      return topo_index.at(a) > topo_index.at(b);
+    });
+    absl::c_copy(newly_ready, std::back_inserter(ready));
+  }
+  // Unused nodes without operands.
+  for (Node* node : topo_order) {
+    if (!scheduled.contains(node)) {
+      CHECK(is_deferred(node));
+      order.push_back(node);
+    }
+  }
+  CHECK_EQ(order.size(), topo_order.size());
+  return order;
+}
+
+// Returns the number of bytes of values which are live across a partition
+// boundary placed immediately before each position of `order` (which must be
+// in topological order). Element `i` is the cost of a boundary between
+// order[i - 1] and order[i]; the result has order.size() + 1 elements.
+//
+// Values passed across partition boundaries are stored in the temp block
+// rather than in buffers local to a partition function. Nodes without
+// operands are not counted, since they are either passed in via the input
+// buffers or (for literals) moved into the partition of their first use.
+std::vector<int64_t> PartitionBoundaryCosts(absl::Span<Node* const> order) {
+  absl::flat_hash_map<Node*, int64_t> position;
+  for (int64_t i = 0; i < order.size(); ++i) {
+    position[order[i]] = i;
+  }
+  // Costs are accumulated as differences between adjacent boundaries.
+  std::vector<int64_t> costs(order.size() + 1, 0);
+  for (int64_t i = 0; i < order.size(); ++i) {
+    Node* node = order[i];
+    if (node->operand_count() == 0 || node->users().empty()) {
+      continue;
+    }
+    int64_t last_use = i;
+    for (Node* user : node->users()) {
+      last_use = std::max(last_use, position.at(user));
+    }
+    // The value crosses every boundary after its definition up to its last
+    // use.
+    int64_t bytes = std::max(
+        int64_t{1}, CeilOfRatio(node->GetType()->GetFlatBitCount(), int64_t{8}));
+    costs[i + 1] += bytes;
+    costs[last_use + 1] -= bytes;
+  }
+  for (int64_t i = 1; i < costs.size(); ++i) {
+    costs[i] += costs[i - 1];
+  }
+  return costs;
+}
+
 // Divides the nodes of the given function base into a topologically sorted
 // sequence of partitions. Each partition then becomes a separate function in
 // the LLVM module.
-// TODO(meheff): 2022/09/09 Tune this algorithm to maximize performance.
+//
+// Nodes are first ordered with LocalityAwareTopoSort. The order is then cut
+// into partitions of kMinPartitionSize to kMaxPartitionSize nodes, choosing
+// each cut to minimize the size of the values live across it.
 std::vector<Partition> PartitionFunctionBase(FunctionBase* f) {
   absl::flat_hash_map<Node*, int64_t> partition_map;
   // Partitions at which execution may resume after an early exit.
@@ -413,39 +548,59 @@ std::vector<Partition> PartitionFunctionBase(FunctionBase* f) {
   enum class Resume : uint8_t { kNextPartition, kThisPartition };
   absl::flat_hash_map<int64_t, Resume> early_exit_partitions;
 
-  // Naively assign nodes to partitions based on a topological sort. First N
-  // nodes go to partition 0, next N nodes go to partition 1, etc.
-  int64_t current_partition = 0;
-  int64_t partition_size = 0;
-  for (Node* node : TopoSort(f)) {
-    if (IsEarlyExitPoint(node)) {
-      CHECK(f->IsProc())
-          << "Early exit points are only supported in procs in the JIT";
-      // Nodes which are early exits are placed in their own partition.
-      if (partition_size != 0) {
-        ++current_partition;
+  std::vector<Node*> order = LocalityAwareTopoSort(f);
+  std::vector<int64_t> boundary_costs = PartitionBoundaryCosts(order);
+
+  // The number of partitions assigned so far.
+  int64_t partition_count = 0;
+  // Assigns the nodes order[start, end) to new partitions.
+  auto partition_segment = [&](int64_t start, int64_t end) {
+    while (start < end) {
+      int64_t cut = end;
+      if (end - start > kMaxPartitionSize) {
+        // Choose the cheapest boundary, preferring larger partitions.
+        cut = start + kMaxPartitionSize;
+        for (int64_t i = start + kMaxPartitionSize - 1;
+             i >= start + kMinPartitionSize; --i) {
+          if (boundary_costs[i] < boundary_costs[cut]) {
+            cut = i;
+          }
+        }
       }
-      partition_map[node] = current_partition;
-      if (ExecutionContinuesAfterNode(node)) {
-        early_exit_partitions.insert(
-            {current_partition, Resume::kNextPartition});
-        resume_partitions.insert(current_partition + 1);
-      } else {
-        early_exit_partitions.insert(
-            {current_partition, Resume::kThisPartition});
-        resume_partitions.insert(current_partition);
+      for (int64_t i = start; i < cut; ++i) {
+        partition_map[order[i]] = partition_count;
       }
-      ++current_partition;
-      partition_size = 0;
+      ++partition_count;
+      start = cut;
+    }
+  };
+  int64_t segment_start = 0;
+  for (int64_t i = 0; i < order.size(); ++i) {
+    Node* node = order[i];
+    if (!IsEarlyExitPoint(node)) {
       continue;
     }
+    CHECK(f->IsProc())
+        << "Early exit points are only supported in procs in the JIT";
+    // Nodes which are early exits are placed in their own partition.
+    partition_segment(segment_start, i);
+    segment_start = i + 1;
+    int64_t current_partition = partition_count++;
     partition_map[node] = current_partition;
-    ++partition_size;
-    if (partition_size > kMaxPartitionSize) {
-      ++current_partition;
-      partition_size = 0;
+    if (ExecutionContinuesAfterNode(node)) {
+      early_exit_partitions.insert({current_partition, Resume::kNextPartition});
+      resume_partitions.insert(current_partition + 1);
+    } else {
+      early_exit_partitions.insert({current_partition, Resume::kThisPartition});
+      resume_partitions.insert(current_partition);
     }
   }
+  partition_segment(segment_start, order.size());
+  if (resume_partitions.contains(partition_count)) {
+    // Execution may resume after an early exit point at the end of the
+    // function, so there must be an (empty) partition to resume at.
+    ++partition_count;
+  }
 
   // Move literals down as far as possible so they appear in the same partition
   // as their uses.
@@ -464,10 +619,9 @@ std::vector<Partition> PartitionFunctionBase(FunctionBase* f) {
     }
   }
 
-  // Assemble nodes into partitions. `current_partition` is the maximum number
-  // of any partition.
-  std::vector<Partition> partitions(current_partition + 1);
-  for (Node* node : TopoSort(f)) {
+  // Assemble nodes into partitions.
+  std::vector<Partition> partitions(partition_count);
+  for (Node* node : order) {
     int64_t partition = partition_map.at(node);
     partitions.at(partition).nodes.push_back(node);
   }
@@ -1253,6 +1407,97 @@ absl::StatusOr<llvm::Function*> BuildPackedWrapper(
   return wrapper.function();
 }
 
+// Builds a wrapper around the jitted function `callee` which evaluates it on a
+// batch of independent inputs. The final argument is the number of lanes in
+// the batch. Input and output pointers point to arrays holding the respective
+// value for each lane in the native LLVM data layout, one allocation size
+// apart. Lanes are evaluated in order by a loop within the wrapper so the
+// per-call overhead of entering the jitted code is paid once per batch.
+absl::StatusOr<llvm::Function*> BuildBatchWrapper(
+    FunctionBase* xls_function, llvm::Function* callee,
+    JitBuilderContext& jit_context) {
+  llvm::LLVMContext* context = &jit_context.context();
+  std::vector<Node*> inputs = GetJittedFunctionInputs(xls_function);
+  std::vector<Node*> outputs = GetJittedFunctionOutputs(xls_function);
+  llvm::Type* i64_type = llvm::Type::getInt64Ty(*context);
+  LlvmFunctionWrapper wrapper = LlvmFunctionWrapper::Create(
+      absl::StrFormat("%s_batch", xls_function->name()), inputs, outputs,
+      i64_type, jit_context,
+      LlvmFunctionWrapper::FunctionArg{.name = "batch_size",
+                                       .type = i64_type});
+  llvm::IRBuilder<>& entry = wrapper.entry_builder();
+  llvm::Value* batch_size = wrapper.GetExtraArg().value();
+
+  // Arrays of pointers to the values of the current lane which are passed to
+  // `callee`.
+  llvm::Type* pointer_type = llvm::PointerType::get(*context, 0);
+  llvm::Value* input_arg_array =
+      entry.CreateAlloca(llvm::ArrayType::get(pointer_type, inputs.size()));
+  llvm::Value* output_arg_array =
+      entry.CreateAlloca(llvm::ArrayType::get(pointer_type, outputs.size()));
+
+  // The base of each input/output array and the distance between the values
+  // of consecutive lanes.
+  auto load_arrays = [&](llvm::Value* pointers, absl::Span<Node* const> nodes,
+                         auto get_type) {
+    std::vector<std::pair<llvm::Value*, int64_t>> arrays;
+    for (int64_t i = 0; i < nodes.size(); ++i) {
+      arrays.push_back(
+          {LoadPointerFromPointerArray(i, pointers, &entry),
+           jit_context.type_converter().GetTypeByteSize(get_type(nodes[i]))});
+    }
+    return arrays;
+  };
+  std::vector<std::pair<llvm::Value*, int64_t>> input_arrays =
+      load_arrays(wrapper.GetInputsArg(), inputs, InputType);
+  std::vector<std::pair<llvm::Value*, int64_t>> output_arrays =
+      load_arrays(wrapper.GetOutputsArg(), outputs, OutputType);
+
+  llvm::BasicBlock* loop_block = llvm::BasicBlock::Create(
+      *context, "lane", wrapper.function(), /*InsertBefore=*/nullptr);
+  llvm::BasicBlock* exit_block = llvm::BasicBlock::Create(
+      *context, "exit", wrapper.function(), /*InsertBefore=*/nullptr);
+  entry.CreateCondBr(
+      entry.CreateICmpSGT(batch_size, llvm::ConstantInt::get(i64_type, 0)),
+      loop_block, exit_block);
+
+  llvm::IRBuilder<> loop(loop_block);
+  llvm::PHINode* lane = loop.CreatePHI(i64_type, 2, "lane");
+  lane->addIncoming(loop.getInt64(0), entry.GetInsertBlock());
+  auto store_lane_pointers =
+      [&](llvm::Value* arg_array,
+          absl::Span<const std::pair<llvm::Value*, int64_t>> arrays) {
+        for (int64_t i = 0; i < arrays.size(); ++i) {
+          const auto& [base, stride] = arrays[i];
+          llvm::Value* lane_ptr = loop.CreateGEP(
+              loop.getInt8Ty(), base,
+              loop.CreateMul(lane, llvm::ConstantInt::get(i64_type, stride)));
+          llvm::Value* gep = loop.CreateGEP(
+              llvm::ArrayType::get(pointer_type, arrays.size()), arg_array,
+              {loop.getInt32(0), loop.getInt32(i)});
+          loop.CreateStore(lane_ptr, gep);
+        }
+      };
+  store_lane_pointers(input_arg_array, input_arrays);
+  store_lane_pointers(output_arg_array, output_arrays);
+
+  loop.CreateCall(callee, {input_arg_array, output_arg_array,
+                           wrapper.GetTempBufferArg(),
+                           wrapper.GetInterpreterEventsArg(),
+                           wrapper.GetInstanceContextArg(),
+                           wrapper.GetJitRuntimeArg(),
+                           /*continuation_point=*/loop.getInt64(0)});
+  llvm::Value* next_lane = loop.CreateAdd(lane, loop.getInt64(1));
+  lane->addIncoming(next_lane, loop_block);
+  loop.CreateCondBr(loop.CreateICmpSLT(next_lane, batch_size), loop_block,
+                    exit_block);
+
+  llvm::IRBuilder<> exit(exit_block);
+  exit.CreateRet(exit.getInt64(0));
+
+  return wrapper.function();
+}
+
 }  // namespace
 
 JitArgumentSet JittedFunctionBase::CreateInputBuffer(bool zero) const {
@@ -1281,7 +1526,7 @@ JitTempBuffer JittedFunctionBase::CreateTempBuffer() const {
 // dependent xls::Functions which may be called by `xls_function`.
 absl::StatusOr<JittedFunctionBase> JittedFunctionBase::BuildInternal(
     FunctionBase* xls_function, JitBuilderContext& jit_context,
-    bool build_packed_wrapper) {
+    bool build_packed_wrapper, bool build_batch_wrapper) {
   std::vector<FunctionBase*> functions = GetDependentFunctions(xls_function);
   BufferAllocator allocator(&jit_context.type_converter());
   llvm::Function* top_function = nullptr;
@@ -1319,6 +1564,13 @@ absl::StatusOr<JittedFunctionBase> JittedFunctionBase::BuildInternal(
         BuildPackedWrapper(xls_function, top_function, jit_context));
     packed_wrapper_name = packed_wrapper_function->getName().str();
   }
+  std::string batch_wrapper_name;
+  if (build_batch_wrapper) {
+    XLS_ASSIGN_OR_RETURN(
+        llvm::Function * batch_wrapper_function,
+        BuildBatchWrapper(xls_function, top_function, jit_context));
+    batch_wrapper_name = batch_wrapper_function->getName().str();
+  }
 
   XLS_RETURN_IF_ERROR(
       jit_context.llvm_compiler().CompileModule(jit_context.ConsumeModule()));
@@ -1352,6 +1604,20 @@ absl::StatusOr<JittedFunctionBase> JittedFunctionBase::BuildInternal(
     }
   }
 
+  if (build_batch_wrapper) {
+    jitted_function.batch_function_name_ = batch_wrapper_name;
+    if (jit_context.llvm_compiler().IsOrcJit()) {
+      XLS_ASSIGN_OR_RETURN(auto* orc_jit,
+                           jit_context.llvm_compiler().AsOrcJit());
+      XLS_ASSIGN_OR_RETURN(auto batch_fn_address,
+                           orc_jit->LoadSymbol(batch_wrapper_name));
+      jitted_function.batch_function_ =
+          absl::bit_cast<JitFunctionType>(batch_fn_address);
+    } else {
+      jitted_function.batch_function_ = InvalidJitFunctionUse;
+    }
+  }
+
   for (const Node* input : GetJittedFunctionInputs(xls_function)) {
     Type* input_type = InputType(input);
     jitted_function.input_buffer_sizes_.push_back(
@@ -1395,21 +1661,24 @@ absl::StatusOr<JittedFunctionBase> JittedFunctionBase::Build(
     Function* xls_function, LlvmCompiler& compiler) {
   JitBuilderContext jit_context(compiler, xls_function);
   return JittedFunctionBase::BuildInternal(xls_function, jit_context,
-                                           /*build_packed_wrapper=*/true);
+                                           /*build_packed_wrapper=*/true,
+                                           /*build_batch_wrapper=*/true);
 }
 
 absl::StatusOr<JittedFunctionBase> JittedFunctionBase::Build(
     Proc* proc, LlvmCompiler& compiler) {
   JitBuilderContext jit_context(compiler, proc);
   return JittedFunctionBase::BuildInternal(proc, jit_context,
-                                           /*build_packed_wrapper=*/false);
+                                           /*build_packed_wrapper=*/false,
+                                           /*build_batch_wrapper=*/false);
 }
 
 absl::StatusOr<JittedFunctionBase> JittedFunctionBase::Build(
     Block* block, LlvmCompiler& compiler) {
   JitBuilderContext jit_context(compiler, block);
   return JittedFunctionBase::BuildInternal(block, jit_context,
-                                           /*build_packed_wrapper=*/false);
+                                           /*build_packed_wrapper=*/false,
+                                           /*build_batch_wrapper=*/false);
 }
 
 absl::StatusOr<JittedFunctionBase> JittedFunctionBase::BuildFromAot(
@@ -1543,6 +1812,34 @@ JittedFunctionBase::RunUnalignedJittedFunction</*kForceZeroCopy=*/false>(
     InterpreterEvents* events, InstanceContext* instance_context,
     JitRuntime* jit_runtime, int64_t continuation) const;
 
+void JittedFunctionBase::RunBatchedJittedFunction(
+    const uint8_t* const* inputs, uint8_t* const* outputs, void* temp_buffer,
+    InterpreterEvents* events, InstanceContext* instance_context,
+    JitRuntime* jit_runtime, int64_t batch_size) const {
+  DCHECK_OK(VerifyOffsetAlignments(inputs, input_buffer_abi_alignments()));
+  DCHECK_OK(VerifyOffsetAlignments(outputs, output_buffer_abi_alignments()));
+  DCHECK(IsAligned(temp_buffer, temp_buffer_alignment_));
+  if (batch_function_.has_value()) {
+    (*batch_function_)(inputs, outputs, temp_buffer, events, instance_context,
+                       jit_runtime, batch_size);
+    return;
+  }
+  // No batch entry point (e.g., AOT compiled code), so call the function once
+  // per lane.
+  std::vector<const uint8_t*> lane_inputs(input_buffer_sizes_.size());
+  std::vector<uint8_t*> lane_outputs(output_buffer_sizes_.size());
+  for (int64_t lane = 0; lane < batch_size; ++lane) {
+    for (int64_t i = 0; i < lane_inputs.size(); ++i) {
+      lane_inputs[i] = inputs[i] + lane * input_buffer_sizes_[i];
+    }
+    for (int64_t i = 0; i < lane_outputs.size(); ++i) {
+      lane_outputs[i] = outputs[i] + lane * output_buffer_sizes_[i];
+    }
+    function_(lane_inputs.data(), lane_outputs.data(), temp_buffer, events,
+              instance_context, jit_runtime, /*continuation_point=*/0);
+  }
+}
+
 std::optional<int64_t> JittedFunctionBase::RunPackedJittedFunction(
     const uint8_t* const* inputs, uint8_t* const* outputs, void* temp_buffer,
     InterpreterEvents* events, InstanceContext* instance_context,
@@ -147,6 +147,18 @@ class JittedFunctionBase {
                                      JitRuntime* jit_runtime,
                                      int64_t continuation) const;
 
+  // Execute the function on `batch_size` independent sets of inputs. Each
+  // input and output pointer points to an array holding the value for each
+  // lane, `input_buffer_sizes()[i]` (or `output_buffer_sizes()[i]`) bytes
+  // apart, in the native LLVM data layout. The arrays must have the ABI
+  // alignment of their element type. Only functions may be run batched.
+  void RunBatchedJittedFunction(const uint8_t* const* inputs,
+                                uint8_t* const* outputs, void* temp_buffer,
+                                InterpreterEvents* events,
+                                InstanceContext* instance_context,
+                                JitRuntime* jit_runtime,
+                                int64_t batch_size) const;
+
   // Execute the actual function (after verifying some invariants)
   std::optional<int64_t> RunPackedJittedFunction(
       const uint8_t* const* inputs, uint8_t* const* outputs, void* temp_buffer,
@@ -161,6 +173,15 @@ class JittedFunctionBase {
                : std::nullopt;
   }
 
+  // Checks if we have a compiled batch version of the function. Without one
+  // RunBatchedJittedFunction calls the function once per lane.
+  bool HasBatchFunction() const { return batch_function_.has_value(); }
+  std::optional<std::string_view> batch_function_name() const {
+    return HasBatchFunction()
+               ? std::make_optional<std::string_view>(*batch_function_name_)
+               : std::nullopt;
+  }
+
   std::string_view function_name() const { return function_name_; }
 
   absl::Span<int64_t const> input_buffer_sizes() const {
@@ -254,7 +275,7 @@ class JittedFunctionBase {
 
   static absl::StatusOr<JittedFunctionBase> BuildInternal(
       FunctionBase* function, JitBuilderContext& jit_context,
-      bool build_packed_wrapper);
+      bool build_packed_wrapper, bool build_batch_wrapper);
 
   // Name and function pointer for the jitted function which accepts/produces
   // arguments/results in LLVM native format.
@@ -267,6 +288,12 @@ class JittedFunctionBase {
   std::optional<std::string> packed_function_name_;
   std::optional<JitFunctionType> packed_function_;
 
+  // Name and function pointer for the jitted function which evaluates a batch
+  // of inputs (see RunBatchedJittedFunction), with the batch size passed in
+  // place of the continuation point. Only exists for JITted xls::Functions.
+  std::optional<std::string> batch_function_name_;
+  std::optional<JitFunctionType> batch_function_;
+
   // Sizes of the inputs/outputs in native LLVM format for `function_base`.
   std::vector<int64_t> input_buffer_sizes_;
   std::vector<int64_t> output_buffer_sizes_;
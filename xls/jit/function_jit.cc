@@ -14,7 +14,9 @@
 
 #include "xls/jit/function_jit.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <string>
@@ -22,6 +24,8 @@
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/base/casts.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -30,8 +34,10 @@
 #include "absl/types/span.h"
 #include "llvm/include/llvm/IR/DataLayout.h"
 #include "llvm/include/llvm/Support/Error.h"
+#include "xls/common/math_util.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/ir/events.h"
 #include "xls/ir/function.h"
 #include "xls/ir/keyword_args.h"
@@ -44,6 +50,7 @@
 #include "xls/jit/aot_compiler.h"
 #include "xls/jit/aot_entrypoint.pb.h"
 #include "xls/jit/function_base_jit.h"
+#include "xls/jit/jit_buffer.h"
 #include "xls/jit/jit_runtime.h"
 #include "xls/jit/observer.h"
 #include "xls/jit/orc_jit.h"
@@ -167,8 +174,7 @@ absl::StatusOr<std::unique_ptr<FunctionJit>> FunctionJit::CreateInternal(
       include_observer_callbacks, std::make_unique<JitRuntime>(data_layout)));
 }
 
-absl::StatusOr<InterpreterResult<Value>> FunctionJit::Run(
-    absl::Span<const Value> args) {
+absl::Status FunctionJit::CheckArgs(absl::Span<const Value> args) const {
   if (args.size() != metadata_.ParamCount()) {
     return absl::InvalidArgumentError(absl::StrFormat(
         "Arg list to '%s' has the wrong size: %d vs expected %d.",
@@ -182,6 +188,12 @@ absl::StatusOr<InterpreterResult<Value>> FunctionJit::Run(
           args[i].ToString(), i, metadata_.param_types[i]->ToString()));
     }
   }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<InterpreterResult<Value>> FunctionJit::Run(
+    absl::Span<const Value> args) {
+  XLS_RETURN_IF_ERROR(CheckArgs(args));
 
   // Allocate argument buffers and copy in arg Values.
   XLS_RETURN_IF_ERROR(jit_runtime_->PackArgs(args, metadata_.param_types,
@@ -205,6 +217,136 @@ absl::StatusOr<InterpreterResult<Value>> FunctionJit::Run(
   return Run(positional_args);
 }
 
+absl::Status FunctionJit::RunBatch(absl::Span<const uint8_t* const> args,
+                                   uint8_t* result_buffer, int64_t batch_size,
+                                   InterpreterEvents* events, int64_t threads) {
+  if (args.size() != metadata_.ParamCount()) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Arg list has the wrong size: %d vs expected %d.",
+                        args.size(), metadata_.ParamCount()));
+  }
+  if (batch_size < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Batch size must be non-negative, got %d", batch_size));
+  }
+  if (threads < 1) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Thread count must be positive, got %d", threads));
+  }
+  for (int64_t i = 0; i < args.size(); ++i) {
+    if (absl::bit_cast<uintptr_t>(args[i]) % GetArgTypeAlignment(i) != 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Batch buffer for argument %d is not aligned to %d "
+                          "bytes",
+                          i, GetArgTypeAlignment(i)));
+    }
+  }
+  if (absl::bit_cast<uintptr_t>(result_buffer) % GetReturnTypeAlignment() !=
+      0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Batch result buffer is not aligned to %d bytes",
+                        GetReturnTypeAlignment()));
+  }
+  if (batch_size == 0) {
+    return absl::OkStatus();
+  }
+
+  // Evaluates lanes [start, start + count) with a temporary buffer of its own.
+  auto run_chunk = [&](int64_t start, int64_t count,
+                       InterpreterEvents* chunk_events) {
+    std::vector<const uint8_t*> chunk_args(args.size());
+    for (int64_t i = 0; i < args.size(); ++i) {
+      chunk_args[i] = args[i] + start * GetArgTypeSize(i);
+    }
+    uint8_t* chunk_results[1] = {result_buffer +
+                                 start * GetReturnTypeSize()};
+    JitTempBuffer temp_buffer = jitted_function_base_.CreateTempBuffer();
+    jitted_function_base_.RunBatchedJittedFunction(
+        chunk_args.data(), chunk_results, temp_buffer.get(), chunk_events,
+        /*instance_context=*/&callbacks_, runtime(), count);
+  };
+
+  InterpreterEvents local_events;
+  if (events == nullptr) {
+    events = &local_events;
+  }
+  int64_t chunk_size = CeilOfRatio(batch_size, threads);
+  int64_t chunk_count = CeilOfRatio(batch_size, chunk_size);
+  if (chunk_count == 1) {
+    run_chunk(0, batch_size, events);
+    return absl::OkStatus();
+  }
+  std::vector<InterpreterEvents> chunk_events(chunk_count);
+  std::vector<std::unique_ptr<Thread>> workers;
+  workers.reserve(chunk_count - 1);
+  for (int64_t chunk = 1; chunk < chunk_count; ++chunk) {
+    int64_t start = chunk * chunk_size;
+    int64_t count = std::min(chunk_size, batch_size - start);
+    workers.push_back(std::make_unique<Thread>(
+        [&run_chunk, &chunk_events, start, count, chunk]() {
+          run_chunk(start, count, &chunk_events[chunk]);
+        }));
+  }
+  run_chunk(0, chunk_size, &chunk_events[0]);
+  for (std::unique_ptr<Thread>& worker : workers) {
+    worker->Join();
+  }
+  for (InterpreterEvents& chunk_event : chunk_events) {
+    absl::c_move(chunk_event.trace_msgs, std::back_inserter(events->trace_msgs));
+    absl::c_move(chunk_event.assert_msgs,
+                 std::back_inserter(events->assert_msgs));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<InterpreterResult<std::vector<Value>>> FunctionJit::RunBatch(
+    absl::Span<const std::vector<Value>> arg_sets, int64_t threads) {
+  for (const std::vector<Value>& args : arg_sets) {
+    XLS_RETURN_IF_ERROR(CheckArgs(args));
+  }
+  int64_t batch_size = arg_sets.size();
+
+  // Allocates an aligned buffer for `batch_size` values of `size` bytes.
+  std::vector<std::vector<uint8_t>> allocations;
+  auto allocate = [&](int64_t size, int64_t alignment) {
+    std::vector<uint8_t>& allocation = allocations.emplace_back(
+        jit_runtime_->ShouldAllocateForAlignment(
+            std::max<int64_t>(size * batch_size, 1), alignment));
+    return jit_runtime_->AsAligned(absl::MakeSpan(allocation), alignment)
+        .data();
+  };
+  std::vector<uint8_t*> arg_buffers;
+  for (int64_t i = 0; i < metadata_.ParamCount(); ++i) {
+    arg_buffers.push_back(
+        allocate(GetArgTypeSize(i), GetArgTypeAlignment(i)));
+  }
+  uint8_t* result_buffer =
+      allocate(GetReturnTypeSize(), GetReturnTypeAlignment());
+
+  std::vector<uint8_t*> lane_buffers(metadata_.ParamCount());
+  for (int64_t lane = 0; lane < batch_size; ++lane) {
+    for (int64_t i = 0; i < metadata_.ParamCount(); ++i) {
+      lane_buffers[i] = arg_buffers[i] + lane * GetArgTypeSize(i);
+    }
+    XLS_RETURN_IF_ERROR(jit_runtime_->PackArgs(
+        arg_sets[lane], metadata_.param_types, lane_buffers));
+  }
+
+  InterpreterEvents events;
+  XLS_RETURN_IF_ERROR(RunBatch(
+      std::vector<const uint8_t*>(arg_buffers.begin(), arg_buffers.end()),
+      result_buffer, batch_size, &events, threads));
+
+  std::vector<Value> results;
+  results.reserve(batch_size);
+  for (int64_t lane = 0; lane < batch_size; ++lane) {
+    results.push_back(jit_runtime_->UnpackBuffer(
+        result_buffer + lane * GetReturnTypeSize(), metadata_.return_type));
+  }
+  return InterpreterResult<std::vector<Value>>{std::move(results),
+                                               std::move(events)};
+}
+
 template <bool kForceZeroCopy>
 absl::Status FunctionJit::RunWithViews(absl::Span<uint8_t* const> args,
                                        absl::Span<uint8_t> result_buffer,
@@ -47,7 +47,8 @@ namespace xls {
 // This class provides a facility to execute XLS functions (on the host) by
 // converting it to LLVM IR, compiling it, and finally executing it. Not
 // thread-safe due to sharing of result and temporary buffers between
-// invocations of Run.
+// invocations of Run. The exception is RunBatch, which allocates its own
+// temporary buffers and may be called concurrently.
 class FunctionJit {
  public:
   // Returns an object containing a host-compiled version of the specified XLS
@@ -93,6 +94,29 @@ class FunctionJit {
                             absl::Span<uint8_t> result_buffer,
                             InterpreterEvents* events);
 
+  // Executes the compiled function on `batch_size` independent sets of
+  // arguments held in "structure of arrays" form: `args[i]` points to
+  // `batch_size` consecutive values of parameter i in the native LLVM data
+  // layout, each GetArgTypeSize(i) bytes long, and `result_buffer` receives
+  // `batch_size` consecutive results, each GetReturnTypeSize() bytes long.
+  // Buffers must be aligned to GetArgTypeAlignment(i) (respectively
+  // GetReturnTypeAlignment()).
+  //
+  // The lanes are evaluated by a loop compiled into the jitted code. With
+  // `threads` > 1 the batch is split into contiguous chunks which are evaluated
+  // concurrently, each with its own temporary buffer. Events from all lanes
+  // are appended to `events` (if non-null) in no particular order.
+  //
+  // Thread-safe, provided any runtime observer is thread-safe too.
+  absl::Status RunBatch(absl::Span<const uint8_t* const> args,
+                        uint8_t* result_buffer, int64_t batch_size,
+                        InterpreterEvents* events, int64_t threads = 1);
+
+  // As above, but with each element of `arg_sets` holding the arguments of one
+  // lane, and returning the result of each lane.
+  absl::StatusOr<InterpreterResult<std::vector<Value>>> RunBatch(
+      absl::Span<const std::vector<Value>> arg_sets, int64_t threads = 1);
+
   // Similar to RunWithViews(), except the arguments here are _packed_views_ -
   // views whose data elements are tightly packed, with no padding bits or bytes
   // between them. The function return value is specified as the last arg - its
@@ -242,6 +266,9 @@ class FunctionJit {
       Function* xls_function, int64_t opt_level,
       bool include_observer_callbacks, JitObserver* jit_observer);
 
+  // Returns an error if `args` are not valid arguments of the function.
+  absl::Status CheckArgs(absl::Span<const Value> args) const;
+
   template <bool kForceZeroCopy, typename... ArgsT>
   absl::Status RunWithUnpackedViewsCommon(ArgsT... args) {
     const uint8_t* arg_buffers[sizeof...(ArgsT)];
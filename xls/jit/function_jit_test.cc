@@ -1378,5 +1378,186 @@ FUZZ_TEST(FunctionJitTest, TestPackedArrayWithType)
                                    /*max_elements=*/68),
                         /*max_elements=*/1030)));
 
+// Builds a function of two bits[32] params from a long chain of operations,
+// many of which use values from far earlier in the chain, so that the JITted
+// function has many partitions with values live across them.
+absl::StatusOr<Function*> BuildLargeFunction(Package* package,
+                                             int64_t length) {
+  FunctionBuilder b("large", package);
+  BValue x = b.Param("x", package->GetBitsType(32));
+  BValue y = b.Param("y", package->GetBitsType(32));
+  std::vector<BValue> values = {x, y};
+  for (int64_t i = 2; i < length; ++i) {
+    BValue previous = values[i - 1];
+    BValue earlier = values[(i * 7) % (i - 1)];
+    switch (i % 3) {
+      case 0:
+        values.push_back(b.Add(previous, earlier));
+        break;
+      case 1:
+        values.push_back(b.Xor(previous, b.Literal(UBits(i, 32))));
+        break;
+      default:
+        values.push_back(b.UMul(previous, earlier));
+        break;
+    }
+  }
+  return b.Build();
+}
+
+TEST(FunctionJitTest, ParallelCompilation) {
+  Package package("parallel");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           BuildLargeFunction(&package, 2000));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<FunctionJit> serial_jit,
+                           FunctionJit::Create(function));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto orc_jit,
+      OrcJit::Create(LlvmCompiler::kDefaultOptLevel,
+                     /*include_observer_callbacks=*/false,
+                     /*jit_observer=*/nullptr));
+  orc_jit->SetParallelCompilation(/*threads=*/4,
+                                  /*min_instruction_count=*/0);
+  XLS_ASSERT_OK_AND_ASSIGN(llvm::DataLayout data_layout,
+                           orc_jit->CreateDataLayout());
+  XLS_ASSERT_OK_AND_ASSIGN(JittedFunctionBase parallel_jit,
+                           JittedFunctionBase::Build(function, *orc_jit));
+
+  std::minstd_rand bitgen;
+  for (int64_t i = 0; i < 10; ++i) {
+    Value x = RandomValue(package.GetBitsType(32), bitgen);
+    Value y = RandomValue(package.GetBitsType(32), bitgen);
+    std::vector<Value> args = {x, y};
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> expected,
+                             serial_jit->Run(args));
+
+    std::vector<uint8_t> x_data = FlattenValue(x);
+    std::vector<uint8_t> y_data = FlattenValue(y);
+    std::vector<uint8_t> output(4);
+    std::array<uint8_t*, 2> inputs = {x_data.data(), y_data.data()};
+    std::array<uint8_t*, 1> outputs = {output.data()};
+    InterpreterEvents events;
+    JitRuntime runtime(data_layout);
+    JitTempBuffer temp_buffer = parallel_jit.CreateTempBuffer();
+    std::optional<int64_t> ret = parallel_jit.RunPackedJittedFunction(
+        inputs.data(), outputs.data(), &temp_buffer, &events,
+        /*instance_context=*/nullptr, /*jit_runtime=*/&runtime,
+        /*continuation_point=*/0);
+    ASSERT_TRUE(ret.has_value());
+    CheckOutput(/*expected_data=*/FlattenValue(expected.value),
+                /*output_data=*/output,
+                /*extra_data=*/{{"x", x_data}, {"y", y_data}});
+  }
+}
+
+TEST(FunctionJitTest, RunBatch) {
+  Package package("my_package");
+  std::string ir_text = R"(
+  fn f(x: bits[32], y: (bits[8], bits[16])) -> (bits[32], bits[16]) {
+    y0: bits[8] = tuple_index(y, index=0)
+    y1: bits[16] = tuple_index(y, index=1)
+    y0_ext: bits[32] = zero_ext(y0, new_bit_count=32)
+    sum: bits[32] = add(x, y0_ext)
+    prod: bits[16] = umul(y1, y1)
+    ret result: (bits[32], bits[16]) = tuple(sum, prod)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+  EXPECT_TRUE(jit->jitted_function_base().HasBatchFunction());
+
+  std::minstd_rand bitgen;
+  std::vector<std::vector<Value>> arg_sets;
+  for (int64_t i = 0; i < 1000; ++i) {
+    arg_sets.push_back(
+        {RandomValue(function->param(0)->GetType(), bitgen),
+         RandomValue(function->param(1)->GetType(), bitgen)});
+  }
+  std::vector<Value> expected;
+  for (const std::vector<Value>& args : arg_sets) {
+    XLS_ASSERT_OK_AND_ASSIGN(Value result,
+                             RunJitNoEvents(jit.get(), args));
+    expected.push_back(result);
+  }
+
+  for (int64_t threads : {1, 3, 8}) {
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<std::vector<Value>> result,
+                             jit->RunBatch(arg_sets, threads));
+    EXPECT_THAT(result.value, ElementsAreArray(expected)) << threads;
+  }
+  EXPECT_THAT(jit->RunBatch(absl::Span<const std::vector<Value>>()),
+              IsOkAndHolds(testing::Field(
+                  &InterpreterResult<std::vector<Value>>::value,
+                  testing::IsEmpty())));
+}
+
+TEST(FunctionJitTest, RunBatchWithViews) {
+  Package package("my_package");
+  std::string ir_text = R"(
+  fn f(x: bits[8], y: bits[8]) -> bits[8] {
+    ret sub.1: bits[8] = sub(x, y)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+  ASSERT_EQ(jit->GetArgTypeSize(0), 1);
+  ASSERT_EQ(jit->GetReturnTypeSize(), 1);
+
+  constexpr int64_t kBatchSize = 300;
+  std::vector<uint8_t> x(kBatchSize);
+  std::vector<uint8_t> y(kBatchSize);
+  for (int64_t i = 0; i < kBatchSize; ++i) {
+    x[i] = i;
+    y[i] = 3 * i;
+  }
+  std::vector<uint8_t> result(kBatchSize);
+  std::array<const uint8_t*, 2> args = {x.data(), y.data()};
+  XLS_ASSERT_OK(jit->RunBatch(args, result.data(), kBatchSize,
+                              /*events=*/nullptr, /*threads=*/4));
+  for (int64_t i = 0; i < kBatchSize; ++i) {
+    EXPECT_EQ(result[i], static_cast<uint8_t>(x[i] - y[i])) << i;
+  }
+
+  EXPECT_THAT(jit->RunBatch(args, result.data(), /*batch_size=*/-1,
+                            /*events=*/nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(jit->RunBatch(args, result.data(), kBatchSize,
+                            /*events=*/nullptr, /*threads=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(FunctionJitTest, RunBatchCollectsEvents) {
+  Package package("my_package");
+  std::string ir_text = R"(
+  fn f(tkn: token, x: bits[8]) -> bits[8] {
+    one: bits[1] = literal(value=1)
+    trace.1: token = trace(tkn, one, format="x is {}", data_operands=[x], id=1)
+    ret identity.2: bits[8] = identity(x)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+
+  std::vector<std::vector<Value>> arg_sets;
+  for (int64_t i = 0; i < 10; ++i) {
+    arg_sets.push_back({Value::Token(), Value(UBits(i, 8))});
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<std::vector<Value>> result,
+                           jit->RunBatch(arg_sets, /*threads=*/2));
+  std::vector<std::string> messages;
+  for (const TraceMessage& trace : result.events.trace_msgs) {
+    messages.push_back(trace.message);
+  }
+  EXPECT_THAT(messages,
+              testing::UnorderedElementsAre("x is 0", "x is 1", "x is 2",
+                                            "x is 3", "x is 4", "x is 5",
+                                            "x is 6", "x is 7", "x is 8",
+                                            "x is 9"));
+}
+
 }  // namespace
 }  // namespace xls
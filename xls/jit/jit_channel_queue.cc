@@ -25,11 +25,13 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/log/check.h"
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "xls/common/math_util.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/interpreter/channel_queue.h"
+#include "xls/ir/channel.h"
 #include "xls/ir/package.h"
 #include "xls/ir/proc_elaboration.h"
 #include "xls/ir/type.h"
@@ -56,6 +58,31 @@ std::optional<Value> ReadValueFromQueue(Type* type, JitRuntime& runtime,
   return runtime.UnpackBuffer(buffer.data(), type);
 }
 
+void WriteValueOnQueue(const Value& value, Type* type, JitRuntime& runtime,
+                       SpscByteQueue& queue) {
+  absl::InlinedVector<uint8_t, ByteQueue::kInitBufferSize> buffer(
+      queue.element_size());
+  runtime.BlitValueToBuffer(value, type, absl::MakeSpan(buffer));
+  queue.Write(buffer.data());
+}
+
+std::optional<Value> ReadValueFromQueue(Type* type, JitRuntime& runtime,
+                                        SpscByteQueue& queue) {
+  std::vector<uint8_t> buffer(queue.element_size());
+  if (!queue.Read(buffer.data())) {
+    return std::nullopt;
+  }
+  return runtime.UnpackBuffer(buffer.data(), type);
+}
+
+int64_t AllocatedElementSize(int64_t channel_element_size) {
+  // Empty tuples still occupy a slot so that elements can be counted.
+  return std::max(
+      RoundUpToNearest(channel_element_size,
+                       static_cast<int64_t>(alignof(std::max_align_t))),
+      int64_t{1});
+}
+
 }  // namespace
 
 ByteQueue::ByteQueue(int64_t channel_element_size, bool is_single_value)
@@ -102,6 +129,109 @@ void ByteQueue::Resize() {
   }
 }
 
+SpscByteQueue::Ring::Ring(int64_t capacity, int64_t stride)
+    : capacity(capacity),
+      stride(stride),
+      storage(std::make_unique<uint8_t[]>(capacity * stride)) {
+  CHECK_GT(capacity, 0);
+  CHECK_EQ(capacity & (capacity - 1), 0) << "capacity must be a power of two";
+}
+
+SpscByteQueue::SpscByteQueue(int64_t channel_element_size,
+                             int64_t initial_capacity)
+    : channel_element_size_(channel_element_size),
+      allocated_element_size_(AllocatedElementSize(channel_element_size)) {
+  int64_t capacity = int64_t{1} << CeilOfLog2(std::max(initial_capacity,
+                                                       int64_t{1}));
+  write_ring_ = new Ring(capacity, allocated_element_size_);
+  read_ring_ = write_ring_;
+}
+
+SpscByteQueue::~SpscByteQueue() {
+  Ring* ring = read_ring_;
+  while (ring != nullptr) {
+    Ring* next = ring->next.load(std::memory_order_acquire);
+    delete ring;
+    ring = next;
+  }
+}
+
+SpscByteQueue::Ring* SpscByteQueue::AppendRing() {
+  Ring* ring = new Ring(write_ring_->capacity * 2, allocated_element_size_);
+  // Publishing the link is the last access to the old ring by the producer;
+  // the consumer may free it as soon as it has drained it.
+  write_ring_->next.store(ring, std::memory_order_release);
+  write_ring_ = ring;
+  return ring;
+}
+
+bool SpscByteQueue::AdvanceReadRing() {
+  Ring* next = read_ring_->next.load(std::memory_order_acquire);
+  if (next == nullptr) {
+    return false;
+  }
+  // The producer filled the ring before linking its successor, and the
+  // acquire above makes all of those writes visible. Drain them first.
+  if (read_ring_->write_count.load(std::memory_order_relaxed) !=
+      read_ring_->read_count.load(std::memory_order_relaxed)) {
+    return true;
+  }
+  delete read_ring_;
+  read_ring_ = next;
+  return true;
+}
+
+void SpscByteQueue::WriteBatch(const uint8_t* data, int64_t count) {
+#ifdef ABSL_HAVE_MEMORY_SANITIZER
+  __msan_unpoison(data, channel_element_size_ * count);
+#endif
+  const int64_t total = count;
+  while (count > 0) {
+    Ring* ring = write_ring_;
+    int64_t write_count = ring->write_count.load(std::memory_order_relaxed);
+    int64_t free = ring->FreeSlots(write_count);
+    if (free == 0) {
+      ring = AppendRing();
+      write_count = 0;
+      free = ring->capacity;
+    }
+    int64_t chunk = std::min(free, count);
+    for (int64_t i = 0; i < chunk; ++i) {
+      memcpy(ring->Slot(write_count + i), data, channel_element_size_);
+      data += channel_element_size_;
+    }
+    ring->write_count.store(write_count + chunk, std::memory_order_release);
+    count -= chunk;
+  }
+  total_written_.store(total_written_.load(std::memory_order_relaxed) + total,
+                       std::memory_order_release);
+}
+
+int64_t SpscByteQueue::ReadBatch(uint8_t* buffer, int64_t max_count) {
+  int64_t count = 0;
+  while (count < max_count) {
+    Ring* ring = read_ring_;
+    int64_t read_count = ring->read_count.load(std::memory_order_relaxed);
+    int64_t used = ring->UsedSlots(read_count);
+    if (used == 0) {
+      if (!AdvanceReadRing()) {
+        break;
+      }
+      continue;
+    }
+    int64_t chunk = std::min(used, max_count - count);
+    for (int64_t i = 0; i < chunk; ++i) {
+      memcpy(buffer, ring->Slot(read_count + i), channel_element_size_);
+      buffer += channel_element_size_;
+    }
+    ring->read_count.store(read_count + chunk, std::memory_order_release);
+    count += chunk;
+  }
+  total_read_.store(total_read_.load(std::memory_order_relaxed) + count,
+                    std::memory_order_release);
+  return count;
+}
+
 int64_t ThreadSafeJitChannelQueue::GetSizeInternal() const {
   return byte_queue_.size();
 }
@@ -138,6 +268,54 @@ std::optional<Value> ThreadUnsafeJitChannelQueue::ReadInternal() {
   return value;
 }
 
+LockFreeJitChannelQueue::LockFreeJitChannelQueue(
+    ChannelInstance* channel_instance, JitRuntime* jit_runtime)
+    : JitChannelQueue(channel_instance, jit_runtime),
+      byte_queue_(element_size_) {
+  CHECK_NE(channel_instance->channel->kind(), ChannelKind::kSingleValue)
+      << "Single-value channel " << channel_instance->ToString()
+      << " cannot be backed by a lock-free queue";
+}
+
+void LockFreeJitChannelQueue::WriteRawBatch(const uint8_t* data,
+                                            int64_t count) {
+  if (!callbacks_.empty()) {
+    JitChannelQueue::WriteRawBatch(data, count);
+    return;
+  }
+  byte_queue_.WriteBatch(data, count);
+}
+
+int64_t LockFreeJitChannelQueue::ReadRawBatch(uint8_t* buffer,
+                                              int64_t max_count) {
+  if (!callbacks_.empty() || generator_.has_value()) {
+    return JitChannelQueue::ReadRawBatch(buffer, max_count);
+  }
+  return byte_queue_.ReadBatch(buffer, max_count);
+}
+
+int64_t LockFreeJitChannelQueue::GetSizeInternal() const {
+  return byte_queue_.size();
+}
+
+void LockFreeJitChannelQueue::WriteInternal(const Value& value) {
+  if (!callbacks_.empty()) {
+    absl::MutexLock lock(&callback_mutex_);
+    CallWriteCallbacks(value);
+  }
+  WriteValueOnQueue(value, channel()->type(), *jit_runtime_, byte_queue_);
+}
+
+std::optional<Value> LockFreeJitChannelQueue::ReadInternal() {
+  std::optional<Value> value =
+      ReadValueFromQueue(channel()->type(), *jit_runtime_, byte_queue_);
+  if (value.has_value() && !callbacks_.empty()) {
+    absl::MutexLock lock(&callback_mutex_);
+    CallReadCallbacks(value.value());
+  }
+  return value;
+}
+
 /* static */ absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
 JitChannelQueueManager::CreateThreadSafe(Package* package,
                                          std::unique_ptr<JitRuntime> runtime) {
@@ -178,6 +356,31 @@ JitChannelQueueManager::CreateThreadUnsafe(
       std::move(elaboration), std::move(queues), std::move(runtime)));
 }
 
+/* static */ absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
+JitChannelQueueManager::CreateLockFree(Package* package,
+                                       std::unique_ptr<JitRuntime> runtime) {
+  XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
+                       ProcElaboration::ElaborateOldStylePackage(package));
+  return CreateLockFree(std::move(elaboration), std::move(runtime));
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
+JitChannelQueueManager::CreateLockFree(ProcElaboration&& elaboration,
+                                       std::unique_ptr<JitRuntime> runtime) {
+  std::vector<std::unique_ptr<ChannelQueue>> queues;
+  for (ChannelInstance* channel_instance : elaboration.channel_instances()) {
+    if (channel_instance->channel->kind() == ChannelKind::kSingleValue) {
+      queues.push_back(std::make_unique<ThreadSafeJitChannelQueue>(
+          channel_instance, runtime.get()));
+    } else {
+      queues.push_back(std::make_unique<LockFreeJitChannelQueue>(
+          channel_instance, runtime.get()));
+    }
+  }
+  return absl::WrapUnique(new JitChannelQueueManager(
+      std::move(elaboration), std::move(queues), std::move(runtime)));
+}
+
 JitChannelQueue& JitChannelQueueManager::GetJitQueue(Channel* channel) {
   JitChannelQueue* queue = dynamic_cast<JitChannelQueue*>(&GetQueue(channel));
   CHECK_NE(queue, nullptr);
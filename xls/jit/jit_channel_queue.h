@@ -14,6 +14,7 @@
 #ifndef XLS_JIT_JIT_CHANNEL_QUEUE_H_
 #define XLS_JIT_JIT_CHANNEL_QUEUE_H_
 
+#include <atomic>
 #include <cstdint>
 #include <cstring>
 #include <memory>
@@ -21,6 +22,8 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/config.h"
+#include "absl/base/optimization.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/statusor.h"
@@ -112,20 +115,187 @@ class ByteQueue {
   bool is_single_value_;
 };
 
+// A lock-free FIFO queue of raw bytes which may be accessed concurrently by
+// exactly one producer thread and one consumer thread.
+//
+// Elements are stored in a chain of fixed-capacity ring buffers. The producer
+// appends to the newest ring and the consumer drains the oldest; the two sides
+// only synchronize through per-ring acquire/release counters, each of which is
+// on its own cache line. Rather than blocking, a producer which finds its ring
+// full links in a new ring of twice the capacity, so the queue is unbounded
+// like ByteQueue and a producer which runs ahead of its consumer can never
+// deadlock. The consumer frees a ring once it is drained and has a successor.
+//
+// Batch accesses copy a run of elements per synchronization rather than one.
+// In batch buffers elements are packed contiguously, `element_size()` bytes
+// apart.
+class SpscByteQueue {
+ public:
+  explicit SpscByteQueue(int64_t channel_element_size,
+                         int64_t initial_capacity = kDefaultCapacity);
+  ~SpscByteQueue();
+
+  SpscByteQueue(const SpscByteQueue&) = delete;
+  SpscByteQueue& operator=(const SpscByteQueue&) = delete;
+
+  int64_t element_size() const { return channel_element_size_; }
+
+  // Producer-side operations.
+  void Write(const uint8_t* data) {
+#ifdef ABSL_HAVE_MEMORY_SANITIZER
+    __msan_unpoison(data, channel_element_size_);
+#endif
+    Ring* ring = write_ring_;
+    int64_t write_count = ring->write_count.load(std::memory_order_relaxed);
+    if (ABSL_PREDICT_FALSE(ring->FreeSlots(write_count) == 0)) {
+      ring = AppendRing();
+      write_count = 0;
+    }
+    memcpy(ring->Slot(write_count), data, channel_element_size_);
+    ring->write_count.store(write_count + 1, std::memory_order_release);
+    total_written_.store(total_written_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_release);
+  }
+  void WriteBatch(const uint8_t* data, int64_t count);
+
+  // Consumer-side operations. Returns false/zero if the queue is empty.
+  bool Read(uint8_t* buffer) {
+    while (true) {
+      Ring* ring = read_ring_;
+      int64_t read_count = ring->read_count.load(std::memory_order_relaxed);
+      if (ABSL_PREDICT_TRUE(ring->UsedSlots(read_count) > 0)) {
+        memcpy(buffer, ring->Slot(read_count), channel_element_size_);
+        ring->read_count.store(read_count + 1, std::memory_order_release);
+        total_read_.store(total_read_.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_release);
+        return true;
+      }
+      if (!AdvanceReadRing()) {
+        return false;
+      }
+    }
+  }
+  int64_t ReadBatch(uint8_t* buffer, int64_t max_count);
+
+  // Returns the number of elements in the queue. May be called from any
+  // thread, in which case the result is only a snapshot.
+  int64_t size() const {
+    int64_t read = total_read_.load(std::memory_order_acquire);
+    int64_t written = total_written_.load(std::memory_order_acquire);
+    return written > read ? written - read : 0;
+  }
+
+  static constexpr int64_t kDefaultCapacity = 64;
+
+ private:
+  struct Ring {
+    Ring(int64_t capacity, int64_t stride);
+
+    uint8_t* Slot(int64_t count) {
+      return storage.get() + (count & (capacity - 1)) * stride;
+    }
+
+    // Producer-side: returns the number of free slots, refreshing the cached
+    // consumer position only when the ring appears full.
+    int64_t FreeSlots(int64_t write_count) {
+      int64_t free = capacity - (write_count - cached_read_count);
+      if (free == 0) {
+        cached_read_count = read_count.load(std::memory_order_acquire);
+        free = capacity - (write_count - cached_read_count);
+      }
+      return free;
+    }
+
+    // Consumer-side: returns the number of readable slots, refreshing the
+    // cached producer position only when the ring appears empty.
+    int64_t UsedSlots(int64_t read_count) {
+      int64_t used = cached_write_count - read_count;
+      if (used == 0) {
+        cached_write_count = write_count.load(std::memory_order_acquire);
+        used = cached_write_count - read_count;
+      }
+      return used;
+    }
+
+    // Number of slots; a power of two.
+    const int64_t capacity;
+    // Distance in bytes between consecutive slots.
+    const int64_t stride;
+    std::unique_ptr<uint8_t[]> storage;
+
+    // Written only by the producer.
+    alignas(ABSL_CACHELINE_SIZE) std::atomic<int64_t> write_count = 0;
+    int64_t cached_read_count = 0;
+
+    // Written only by the consumer.
+    alignas(ABSL_CACHELINE_SIZE) std::atomic<int64_t> read_count = 0;
+    int64_t cached_write_count = 0;
+
+    // The next (newer) ring. Set by the producer once this ring is full, after
+    // which the producer never touches this ring again.
+    alignas(ABSL_CACHELINE_SIZE) std::atomic<Ring*> next = nullptr;
+  };
+
+  // Producer-side: links a new ring of twice the capacity after the current
+  // one and makes it the write ring.
+  Ring* AppendRing();
+
+  // Consumer-side: called when the read ring appears empty. Returns true if
+  // the caller should retry the read, either because the read ring had a
+  // successor and has been freed or because it turned out not to be drained.
+  bool AdvanceReadRing();
+
+  // Size of an element in the channel in units of bytes.
+  const int64_t channel_element_size_;
+  // Distance in bytes between elements in a ring. Elements are aligned to the
+  // largest scalar type.
+  const int64_t allocated_element_size_;
+
+  alignas(ABSL_CACHELINE_SIZE) Ring* write_ring_;
+  std::atomic<int64_t> total_written_ = 0;
+
+  alignas(ABSL_CACHELINE_SIZE) Ring* read_ring_;
+  std::atomic<int64_t> total_read_ = 0;
+};
+
 // Abstract base class for channel queues which may be used by the JIT. These
 // queues support reading and writing raw bytes to the queue rather the just
 // xls::Values.
 class JitChannelQueue : public ChannelQueue {
  public:
   JitChannelQueue(ChannelInstance* channel, JitRuntime* jit_runtime)
-      : ChannelQueue(channel), jit_runtime_(jit_runtime) {}
+      : ChannelQueue(channel),
+        jit_runtime_(jit_runtime),
+        element_size_(jit_runtime->GetTypeByteSize(channel->channel->type())) {}
   ~JitChannelQueue() override = default;
 
   virtual void WriteRaw(const uint8_t* data) = 0;
   virtual bool ReadRaw(uint8_t* buffer) = 0;
 
+  // Writes `count` values packed contiguously in `data`, each
+  // `element_size()` bytes.
+  virtual void WriteRawBatch(const uint8_t* data, int64_t count) {
+    for (int64_t i = 0; i < count; ++i) {
+      WriteRaw(data + i * element_size_);
+    }
+  }
+
+  // Reads up to `max_count` values into `buffer`, packed contiguously, each
+  // `element_size()` bytes. Returns the number of values read.
+  virtual int64_t ReadRawBatch(uint8_t* buffer, int64_t max_count) {
+    int64_t count = 0;
+    while (count < max_count && ReadRaw(buffer + count * element_size_)) {
+      ++count;
+    }
+    return count;
+  }
+
+  // Size in bytes of a value in LLVM's native format.
+  int64_t element_size() const { return element_size_; }
+
  protected:
   JitRuntime* jit_runtime_;
+  int64_t element_size_;
 };
 
 // A thread-safe version of the JIT channel queue. All accesses are guarded by a
@@ -215,6 +385,51 @@ class ThreadUnsafeJitChannelQueue : public JitChannelQueue {
   ByteQueue byte_queue_;
 };
 
+// A JIT channel queue for streaming channels which uses no locks on the raw
+// access path. At most one thread may write to the queue and at most one
+// thread may read from it at any time (though they may be different threads).
+// Attached callbacks are serialized with a mutex. Single-value channels are
+// not supported; use ThreadSafeJitChannelQueue for those.
+class LockFreeJitChannelQueue : public JitChannelQueue {
+ public:
+  LockFreeJitChannelQueue(ChannelInstance* channel_instance,
+                          JitRuntime* jit_runtime);
+  ~LockFreeJitChannelQueue() override = default;
+
+  void WriteRaw(const uint8_t* data) override {
+    byte_queue_.Write(data);
+    if (!callbacks_.empty()) {
+      absl::MutexLock lock(&callback_mutex_);
+      CallWriteCallbacks(jit_runtime_->UnpackBuffer(data, channel()->type()));
+    }
+  }
+  bool ReadRaw(uint8_t* buffer) override {
+    if (generator_.has_value()) {
+      std::optional<Value> generated_value = (*generator_)();
+      if (generated_value.has_value()) {
+        WriteInternal(generated_value.value());
+      }
+    }
+    bool value_read = byte_queue_.Read(buffer);
+    if (value_read && !callbacks_.empty()) {
+      absl::MutexLock lock(&callback_mutex_);
+      CallReadCallbacks(jit_runtime_->UnpackBuffer(buffer, channel()->type()));
+    }
+    return value_read;
+  }
+
+  void WriteRawBatch(const uint8_t* data, int64_t count) override;
+  int64_t ReadRawBatch(uint8_t* buffer, int64_t max_count) override;
+
+ protected:
+  int64_t GetSizeInternal() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
+  void WriteInternal(const Value& value) override;
+  std::optional<Value> ReadInternal() override;
+
+  SpscByteQueue byte_queue_;
+  absl::Mutex callback_mutex_;
+};
+
 // A Channel manager which holds exclusively JitChannelQueues.
 class JitChannelQueueManager : public ChannelQueueManager {
  public:
@@ -233,6 +448,15 @@ class JitChannelQueueManager : public ChannelQueueManager {
   CreateThreadUnsafe(ProcElaboration&& elaboration,
                      std::unique_ptr<JitRuntime> runtime);
 
+  // Factories which create a queue manager with LockFreeJitChannelQueues for
+  // streaming channels and ThreadSafeJitChannelQueues for single-value
+  // channels. Suitable for runtimes in which each channel is written by one
+  // thread and read by one thread.
+  static absl::StatusOr<std::unique_ptr<JitChannelQueueManager>> CreateLockFree(
+      Package* package, std::unique_ptr<JitRuntime> runtime);
+  static absl::StatusOr<std::unique_ptr<JitChannelQueueManager>> CreateLockFree(
+      ProcElaboration&& elaboration, std::unique_ptr<JitRuntime> runtime);
+
   JitChannelQueue& GetJitQueue(Channel* channel);
   JitChannelQueue& GetJitQueue(ChannelInstance* channel_instance);
 
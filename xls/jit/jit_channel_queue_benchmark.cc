@@ -22,6 +22,7 @@
 #include "absl/log/check.h"
 #include "xls/common/benchmark_support.h"
 #include "xls/common/init_xls.h"
+#include "xls/common/thread.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/channel_ops.h"
 #include "xls/ir/package.h"
@@ -95,6 +96,86 @@ BENCHMARK(BM_QueueWriteThenRead<ThreadUnsafeJitChannelQueue>)
     ->ArgPair(2048, 1)
     ->ArgPair(2048, 128);
 
+BENCHMARK(BM_QueueWriteThenRead<LockFreeJitChannelQueue>)
+    ->ArgPair(1, 1)
+    ->ArgPair(1, 128)
+    ->ArgPair(8, 1)
+    ->ArgPair(8, 128)
+    ->ArgPair(32, 1)
+    ->ArgPair(32, 128)
+    ->ArgPair(2048, 1)
+    ->ArgPair(2048, 128);
+
+// Benchmark evaluating throughput when a producer thread writes to the channel
+// while the benchmark thread concurrently reads from it, so the two sides
+// contend on the queue. Values are transferred in batches of the given size
+// (a batch size of one uses the single-element API).
+template <typename QueueT,
+          typename std::enable_if<std::is_base_of_v<JitChannelQueue, QueueT>,
+                                  QueueT>::type* = nullptr>
+static void BM_QueueCrossThread(benchmark::State& state) {
+  int64_t element_size_bytes = state.range(0);
+  int64_t batch_size = state.range(1);
+  constexpr int64_t kTransferCount = 1 << 16;
+
+  Package package("benchmark");
+  auto orc_jit = OrcJit::Create().value();
+  auto jit_runtime =
+      std::make_unique<JitRuntime>(orc_jit->CreateDataLayout().value());
+  Channel* channel =
+      package
+          .CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                  package.GetBitsType(8 * element_size_bytes))
+          .value();
+  ProcElaboration elaboration =
+      ProcElaboration::ElaborateOldStylePackage(&package).value();
+
+  QueueT queue(elaboration.GetUniqueInstance(channel).value(),
+               jit_runtime.get());
+  CHECK_EQ(queue.element_size(), element_size_bytes);
+
+  std::vector<uint8_t> send_buffer(element_size_bytes * batch_size, 42);
+  std::vector<uint8_t> recv_buffer(element_size_bytes * batch_size);
+  for (auto _ : state) {
+    Thread producer([&]() {
+      for (int64_t sent = 0; sent < kTransferCount; sent += batch_size) {
+        if (batch_size == 1) {
+          queue.WriteRaw(send_buffer.data());
+        } else {
+          queue.WriteRawBatch(send_buffer.data(), batch_size);
+        }
+      }
+    });
+    int64_t received = 0;
+    while (received < kTransferCount) {
+      if (batch_size == 1) {
+        received += queue.ReadRaw(recv_buffer.data()) ? 1 : 0;
+      } else {
+        received += queue.ReadRawBatch(recv_buffer.data(), batch_size);
+      }
+    }
+    producer.Join();
+  }
+  state.SetItemsProcessed(state.iterations() * kTransferCount);
+}
+
+// For the following benchmarks, the first element in the pair denotes the
+// buffer size written/read from the channel queue. The second element in the
+// pair denotes the number of values transferred per access.
+BENCHMARK(BM_QueueCrossThread<ThreadSafeJitChannelQueue>)
+    ->ArgPair(8, 1)
+    ->ArgPair(8, 64)
+    ->ArgPair(256, 1)
+    ->ArgPair(256, 64)
+    ->UseRealTime();
+
+BENCHMARK(BM_QueueCrossThread<LockFreeJitChannelQueue>)
+    ->ArgPair(8, 1)
+    ->ArgPair(8, 64)
+    ->ArgPair(256, 1)
+    ->ArgPair(256, 64)
+    ->UseRealTime();
+
 }  // namespace
 }  // namespace xls
 
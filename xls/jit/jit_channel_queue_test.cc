@@ -25,6 +25,8 @@
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "xls/common/status/matchers.h"
+#include "xls/common/thread.h"
+#include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/channel_queue_test_base.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/channel.h"
@@ -64,11 +66,25 @@ INSTANTIATE_TEST_SUITE_P(
                                                                GetJitRuntime());
         })));
 
+INSTANTIATE_TEST_SUITE_P(
+    LockFreeJitChannelQueueTest, ChannelQueueTestBase,
+    testing::Values(ChannelQueueTestParam(
+        [](ChannelInstance* channel_instance) -> std::unique_ptr<ChannelQueue> {
+          // Lock-free queues only back streaming channels.
+          if (channel_instance->channel->kind() == ChannelKind::kSingleValue) {
+            return std::make_unique<ThreadSafeJitChannelQueue>(
+                channel_instance, GetJitRuntime());
+          }
+          return std::make_unique<LockFreeJitChannelQueue>(channel_instance,
+                                                           GetJitRuntime());
+        })));
+
 template <typename QueueT>
 class JitChannelQueueTest : public ::testing::Test {};
 
 using QueueTypes =
-    ::testing::Types<ThreadSafeJitChannelQueue, ThreadUnsafeJitChannelQueue>;
+    ::testing::Types<ThreadSafeJitChannelQueue, ThreadUnsafeJitChannelQueue,
+                     LockFreeJitChannelQueue>;
 TYPED_TEST_SUITE(JitChannelQueueTest, QueueTypes);
 
 // An empty tuple represents a zero width.
@@ -181,5 +197,84 @@ TYPED_TEST(JitChannelQueueTest, IotaGeneratorWithRawApi) {
                                  "a generator function")));
 }
 
+TYPED_TEST(JitChannelQueueTest, BatchAccess) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+
+  TypeParam queue(elaboration.GetUniqueInstance(channel).value(),
+                  GetJitRuntime());
+  ASSERT_EQ(queue.element_size(), 4);
+
+  // Write enough values to span several internal buffers.
+  constexpr int64_t kCount = 1000;
+  std::vector<uint32_t> send_buffer(kCount);
+  for (int64_t i = 0; i < kCount; ++i) {
+    send_buffer[i] = i;
+  }
+  queue.WriteRawBatch(reinterpret_cast<uint8_t*>(send_buffer.data()), 10);
+  queue.WriteRawBatch(reinterpret_cast<uint8_t*>(send_buffer.data() + 10),
+                      kCount - 10);
+  EXPECT_EQ(queue.GetSize(), kCount);
+
+  std::vector<uint32_t> recv_buffer(kCount + 1);
+  EXPECT_EQ(queue.ReadRawBatch(reinterpret_cast<uint8_t*>(recv_buffer.data()),
+                               3),
+            3);
+  EXPECT_EQ(queue.ReadRawBatch(
+                reinterpret_cast<uint8_t*>(recv_buffer.data() + 3), kCount),
+            kCount - 3);
+  EXPECT_TRUE(queue.IsEmpty());
+  recv_buffer.pop_back();
+  EXPECT_EQ(recv_buffer, send_buffer);
+  EXPECT_EQ(queue.ReadRawBatch(reinterpret_cast<uint8_t*>(recv_buffer.data()),
+                               kCount),
+            0);
+}
+
+TEST(LockFreeJitChannelQueueTest, ConcurrentProducerAndConsumer) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(64)));
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+
+  LockFreeJitChannelQueue queue(elaboration.GetUniqueInstance(channel).value(),
+                                GetJitRuntime());
+
+  constexpr uint64_t kCount = 100000;
+  Thread producer([&]() {
+    for (uint64_t i = 0; i < kCount; ++i) {
+      if (i % 3 == 0 && i + 1 < kCount) {
+        uint64_t batch[2] = {i, i + 1};
+        queue.WriteRawBatch(reinterpret_cast<uint8_t*>(batch), 2);
+        ++i;
+      } else {
+        queue.WriteRaw(reinterpret_cast<uint8_t*>(&i));
+      }
+    }
+  });
+
+  std::vector<uint64_t> received;
+  received.reserve(kCount);
+  uint64_t value;
+  while (received.size() < kCount) {
+    if (queue.ReadRaw(reinterpret_cast<uint8_t*>(&value))) {
+      received.push_back(value);
+    }
+  }
+  producer.Join();
+  EXPECT_TRUE(queue.IsEmpty());
+  for (uint64_t i = 0; i < kCount; ++i) {
+    ASSERT_EQ(received[i], i);
+  }
+}
+
 }  // namespace
 }  // namespace xls
@@ -0,0 +1,86 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "benchmark/benchmark.h"
+#include "xls/common/benchmark_support.h"
+#include "xls/common/init_xls.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/package.h"
+#include "xls/jit/function_base_jit.h"
+#include "xls/jit/orc_jit.h"
+
+namespace xls {
+namespace {
+
+// Measures JIT startup time (partitioning, LLVM optimization and code
+// generation) for large functions, with and without parallel compilation.
+
+// Builds a function of `length` nodes in which many nodes use values from far
+// earlier in the function, so values are live across many partitions.
+Function* BuildLargeFunction(Package* package, int64_t length) {
+  FunctionBuilder b("large", package);
+  std::vector<BValue> values = {b.Param("x", package->GetBitsType(32)),
+                                b.Param("y", package->GetBitsType(32))};
+  for (int64_t i = 2; i < length; ++i) {
+    BValue previous = values[i - 1];
+    BValue earlier = values[(i * 7) % (i - 1)];
+    switch (i % 3) {
+      case 0:
+        values.push_back(b.Add(previous, earlier));
+        break;
+      case 1:
+        values.push_back(b.Xor(previous, b.Literal(UBits(i, 32))));
+        break;
+      default:
+        values.push_back(b.UMul(previous, earlier));
+        break;
+    }
+  }
+  return b.Build().value();
+}
+
+// Args: node count, compile threads.
+static void BM_JitCompile(benchmark::State& state) {
+  Package package("BM");
+  Function* function = BuildLargeFunction(&package, state.range(0));
+  for (auto _ : state) {
+    std::unique_ptr<OrcJit> orc_jit = OrcJit::Create().value();
+    orc_jit->SetParallelCompilation(/*threads=*/state.range(1),
+                                    /*min_instruction_count=*/0);
+    absl::StatusOr<JittedFunctionBase> jit =
+        JittedFunctionBase::Build(function, *orc_jit);
+    CHECK_OK(jit.status());
+    benchmark::DoNotOptimize(jit);
+  }
+}
+
+BENCHMARK(BM_JitCompile)
+    ->ArgsProduct({{1000, 10000, 50000}, {1, 4, 8}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char* argv[]) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::RunSpecifiedBenchmarks(/*default_spec=*/"all");
+  return 0;
+}
@@ -0,0 +1,216 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/jit_object_cache.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "llvm/include/llvm/ADT/ArrayRef.h"
+#include "llvm/include/llvm/ADT/StringExtras.h"
+#include "llvm/include/llvm/ADT/StringRef.h"
+#include "llvm/include/llvm/IR/Module.h"
+#include "llvm/include/llvm/Support/MemoryBuffer.h"
+#include "llvm/include/llvm/Support/SHA256.h"
+#include "xls/common/file/lru_file_cache.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls {
+namespace {
+
+constexpr std::string_view kKeyPrefix = "xlsjit_";
+constexpr std::string_view kEntrySuffix = ".xlsjit";
+
+// Entries start with this magic string followed by the number of objects, then
+// the size and contents of each object. Sizes are 64-bit host-endian integers;
+// keys include the target so entries are never read on a different host type.
+constexpr std::string_view kEntryMagic = "XLSJITO1";
+
+// Parses the objects of an entry, returning std::nullopt if it is malformed.
+std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> ParseEntry(
+    std::string_view contents, std::string_view key) {
+  if (!absl::StartsWith(contents, kEntryMagic)) {
+    return std::nullopt;
+  }
+  contents.remove_prefix(kEntryMagic.size());
+  uint64_t count;
+  if (!LruFileCache::ReadUint64(contents, count) || count == 0) {
+    return std::nullopt;
+  }
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> objects;
+  for (uint64_t i = 0; i < count; ++i) {
+    uint64_t size;
+    if (!LruFileCache::ReadUint64(contents, size) || size > contents.size()) {
+      return std::nullopt;
+    }
+    objects.push_back(llvm::MemoryBuffer::getMemBufferCopy(
+        llvm::StringRef(contents.data(), size), absl::StrCat(key, "_", i)));
+    contents.remove_prefix(size);
+  }
+  if (!contents.empty()) {
+    return std::nullopt;
+  }
+  return objects;
+}
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<JitObjectCache>>
+JitObjectCache::Create(const std::filesystem::path& directory,
+                       int64_t max_bytes) {
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<LruFileCache> files,
+      LruFileCache::Create(directory, kEntrySuffix, max_bytes));
+  return absl::WrapUnique(new JitObjectCache(std::move(files)));
+}
+
+/* static */ JitObjectCache* JitObjectCache::GetDefault() {
+  static JitObjectCache* const cache = []() -> JitObjectCache* {
+    const char* directory = std::getenv("XLS_JIT_CACHE_DIR");
+    if (directory == nullptr || directory[0] == '\0') {
+      return nullptr;
+    }
+    int64_t max_bytes = kDefaultMaxBytes;
+    if (const char* max_bytes_str = std::getenv("XLS_JIT_CACHE_MAX_BYTES");
+        max_bytes_str != nullptr &&
+        !absl::SimpleAtoi(max_bytes_str, &max_bytes)) {
+      LOG(WARNING) << "Ignoring invalid XLS_JIT_CACHE_MAX_BYTES value: "
+                   << max_bytes_str;
+      max_bytes = kDefaultMaxBytes;
+    }
+    absl::StatusOr<std::unique_ptr<JitObjectCache>> cache =
+        Create(directory, max_bytes);
+    if (!cache.ok()) {
+      LOG(WARNING) << "Unable to create JIT object cache in " << directory
+                   << ": " << cache.status();
+      return nullptr;
+    }
+    return cache->release();
+  }();
+  return cache;
+}
+
+/* static */ std::string JitObjectCache::MakeKey(
+    std::string_view key_material) {
+  std::array<uint8_t, 32> hash = llvm::SHA256::hash(llvm::ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t*>(key_material.data()),
+      key_material.size()));
+  return absl::StrCat(kKeyPrefix,
+                      llvm::toHex(hash, /*LowerCase=*/true));
+}
+
+/* static */ bool JitObjectCache::IsKey(std::string_view str) {
+  return absl::StartsWith(str, kKeyPrefix) &&
+         str.size() == kKeyPrefix.size() + 64;
+}
+
+std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>>
+JitObjectCache::Read(std::string_view key) {
+  std::optional<std::string> contents = files_->Read(key);
+  if (!contents.has_value()) {
+    return std::nullopt;
+  }
+  std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> objects =
+      ParseEntry(*contents, key);
+  if (!objects.has_value()) {
+    LOG(WARNING) << "Removing malformed JIT object cache entry "
+                 << files_->EntryPath(key);
+    files_->Remove(key);
+    return std::nullopt;
+  }
+  files_->Touch(key);
+  return objects;
+}
+
+std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>>
+JitObjectCache::Lookup(std::string_view key) {
+  std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> objects =
+      Read(key);
+  absl::MutexLock lock(&mutex_);
+  if (objects.has_value()) {
+    ++stats_.hits;
+  } else {
+    ++stats_.misses;
+  }
+  return objects;
+}
+
+absl::Status JitObjectCache::Store(
+    std::string_view key, absl::Span<const llvm::MemoryBufferRef> objects) {
+  std::string contents(kEntryMagic);
+  LruFileCache::AppendUint64(objects.size(), contents);
+  for (const llvm::MemoryBufferRef& object : objects) {
+    LruFileCache::AppendUint64(object.getBufferSize(), contents);
+    contents.append(object.getBufferStart(), object.getBufferSize());
+  }
+  XLS_RETURN_IF_ERROR(files_->Write(key, contents));
+  absl::MutexLock lock(&mutex_);
+  ++stats_.stores;
+  return absl::OkStatus();
+}
+
+JitObjectCacheStats JitObjectCache::stats() const {
+  absl::MutexLock lock(&mutex_);
+  JitObjectCacheStats stats = stats_;
+  stats.evictions = files_->evictions();
+  return stats;
+}
+
+void JitObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                          llvm::MemoryBufferRef object) {
+  const std::string& key = module->getModuleIdentifier();
+  if (!IsKey(key)) {
+    return;
+  }
+  absl::Status status = Store(key, {object});
+  if (!status.ok()) {
+    LOG(WARNING) << "Unable to store JIT object code: " << status;
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer> JitObjectCache::getObject(
+    const llvm::Module* module) {
+  const std::string& key = module->getModuleIdentifier();
+  if (!IsKey(key)) {
+    return nullptr;
+  }
+  // OrcJit looks up entries (and records hits and misses) before optimizing a
+  // module, so this is only reached after a miss unless another process has
+  // stored the entry in the meantime.
+  std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> objects =
+      Read(key);
+  if (!objects.has_value() || objects->size() != 1) {
+    return nullptr;
+  }
+  return std::move(objects->front());
+}
+
+}  // namespace xls
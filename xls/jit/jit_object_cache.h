@@ -0,0 +1,122 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_JIT_JIT_OBJECT_CACHE_H_
+#define XLS_JIT_JIT_OBJECT_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "llvm/include/llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/include/llvm/Support/MemoryBuffer.h"
+#include "xls/common/file/lru_file_cache.h"
+
+namespace llvm {
+class Module;
+}  // namespace llvm
+
+namespace xls {
+
+struct JitObjectCacheStats {
+  // Number of lookups which found, or didn't find, cached object code.
+  int64_t hits = 0;
+  int64_t misses = 0;
+  // Number of entries written to the cache.
+  int64_t stores = 0;
+  // Number of entries removed to keep the cache within its size bound.
+  int64_t evictions = 0;
+};
+
+// A cache of JIT-compiled object code, stored as files in a directory so that
+// it persists across processes.
+//
+// Entries are keyed by a hash (see MakeKey) of everything which determines the
+// object code: the unoptimized LLVM module and the compiler configuration. An
+// entry holds one or more object files, since large modules may be compiled
+// in several parts. The cache may be shared between threads and between
+// processes, and is kept within its size bound by removing the least recently
+// used entries (see LruFileCache). Unreadable or corrupt entries are treated
+// as misses.
+//
+// As an llvm::ObjectCache, modules are identified by their module identifier,
+// which OrcJit sets to the entry's key.
+class JitObjectCache : public llvm::ObjectCache {
+ public:
+  static constexpr int64_t kDefaultMaxBytes = int64_t{1} << 30;
+
+  static absl::StatusOr<std::unique_ptr<JitObjectCache>> Create(
+      const std::filesystem::path& directory,
+      int64_t max_bytes = kDefaultMaxBytes);
+
+  // Returns the process-wide cache configured by the XLS_JIT_CACHE_DIR (and
+  // optionally XLS_JIT_CACHE_MAX_BYTES) environment variables, or nullptr if
+  // no cache is configured.
+  static JitObjectCache* GetDefault();
+
+  // Returns the key for an entry from a description of everything which
+  // determines its contents.
+  static std::string MakeKey(std::string_view key_material);
+
+  // Returns whether the given string is a key returned by MakeKey.
+  static bool IsKey(std::string_view str);
+
+  // Returns the objects of the entry with the given key, or std::nullopt if
+  // there is no such (valid) entry.
+  std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> Lookup(
+      std::string_view key);
+
+  // Stores the given objects as the entry with the given key.
+  absl::Status Store(std::string_view key,
+                     absl::Span<const llvm::MemoryBufferRef> objects);
+
+  JitObjectCacheStats stats() const;
+
+  const std::filesystem::path& directory() const {
+    return files_->directory();
+  }
+  int64_t max_bytes() const { return files_->max_bytes(); }
+
+  // llvm::ObjectCache implementation.
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override;
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module* module) override;
+
+ private:
+  explicit JitObjectCache(std::unique_ptr<LruFileCache> files)
+      : files_(std::move(files)) {}
+
+  std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> Read(
+      std::string_view key);
+
+  const std::unique_ptr<LruFileCache> files_;
+
+  mutable absl::Mutex mutex_;
+  JitObjectCacheStats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace xls
+
+#endif  // XLS_JIT_JIT_OBJECT_CACHE_H_
@@ -0,0 +1,182 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/jit_object_cache.h"
+
+#include <chrono>  // NOLINT
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "llvm/include/llvm/Support/MemoryBuffer.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Optional;
+
+std::optional<std::vector<std::string>> LookupStrings(JitObjectCache& cache,
+                                                      std::string_view key) {
+  std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> objects =
+      cache.Lookup(key);
+  if (!objects.has_value()) {
+    return std::nullopt;
+  }
+  std::vector<std::string> result;
+  for (const std::unique_ptr<llvm::MemoryBuffer>& object : *objects) {
+    result.push_back(object->getBuffer().str());
+  }
+  return result;
+}
+
+void SetLastUsed(JitObjectCache& cache, std::string_view key,
+                 std::chrono::minutes age) {
+  std::filesystem::path path =
+      cache.directory() / absl::StrCat(key, ".xlsjit");
+  std::filesystem::last_write_time(
+      path, std::filesystem::file_time_type::clock::now() - age);
+}
+
+TEST(JitObjectCacheTest, MakeKey) {
+  std::string key = JitObjectCache::MakeKey("module");
+  EXPECT_TRUE(JitObjectCache::IsKey(key));
+  EXPECT_EQ(key, JitObjectCache::MakeKey("module"));
+  EXPECT_NE(key, JitObjectCache::MakeKey("module2"));
+  EXPECT_FALSE(JitObjectCache::IsKey("module"));
+}
+
+TEST(JitObjectCacheTest, StoreAndLookup) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<JitObjectCache> cache,
+                           JitObjectCache::Create(temp_dir.path()));
+  std::string key = JitObjectCache::MakeKey("a");
+  EXPECT_EQ(LookupStrings(*cache, key), std::nullopt);
+
+  XLS_ASSERT_OK(cache->Store(
+      key, {llvm::MemoryBufferRef("first object", "first"),
+            llvm::MemoryBufferRef(std::string_view("\0second", 7), "second")}));
+  EXPECT_THAT(LookupStrings(*cache, key),
+              Optional(ElementsAre("first object",
+                                   std::string("\0second", 7))));
+
+  JitObjectCacheStats stats = cache->stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.stores, 1);
+  EXPECT_EQ(stats.evictions, 0);
+}
+
+TEST(JitObjectCacheTest, EntriesPersistAcrossInstances) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::string key = JitObjectCache::MakeKey("a");
+  {
+    XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<JitObjectCache> cache,
+                             JitObjectCache::Create(temp_dir.path()));
+    XLS_ASSERT_OK(
+        cache->Store(key, {llvm::MemoryBufferRef("object", "object")}));
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<JitObjectCache> cache,
+                           JitObjectCache::Create(temp_dir.path()));
+  EXPECT_THAT(LookupStrings(*cache, key), Optional(ElementsAre("object")));
+}
+
+TEST(JitObjectCacheTest, MalformedEntryIsAMiss) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<JitObjectCache> cache,
+                           JitObjectCache::Create(temp_dir.path()));
+  std::string key = JitObjectCache::MakeKey("a");
+  std::filesystem::path path = temp_dir.path() / absl::StrCat(key, ".xlsjit");
+  XLS_ASSERT_OK(SetFileContents(path, "XLSJITO1 truncated"));
+  EXPECT_EQ(LookupStrings(*cache, key), std::nullopt);
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(JitObjectCacheTest, EvictsLeastRecentlyUsed) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  // Each entry takes 24 bytes of header plus 100 bytes of object code, so
+  // only two fit.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<JitObjectCache> cache,
+      JitObjectCache::Create(temp_dir.path(), /*max_bytes=*/300));
+  std::string object(100, 'x');
+  std::string a = JitObjectCache::MakeKey("a");
+  std::string b = JitObjectCache::MakeKey("b");
+  std::string c = JitObjectCache::MakeKey("c");
+
+  XLS_ASSERT_OK(cache->Store(a, {llvm::MemoryBufferRef(object, "a")}));
+  SetLastUsed(*cache, a, std::chrono::minutes(60));
+  XLS_ASSERT_OK(cache->Store(b, {llvm::MemoryBufferRef(object, "b")}));
+  SetLastUsed(*cache, b, std::chrono::minutes(30));
+  // Using `a` makes `b` the least recently used entry.
+  EXPECT_NE(LookupStrings(*cache, a), std::nullopt);
+  XLS_ASSERT_OK(cache->Store(c, {llvm::MemoryBufferRef(object, "c")}));
+
+  EXPECT_EQ(cache->stats().evictions, 1);
+  EXPECT_NE(LookupStrings(*cache, a), std::nullopt);
+  EXPECT_EQ(LookupStrings(*cache, b), std::nullopt);
+  EXPECT_NE(LookupStrings(*cache, c), std::nullopt);
+}
+
+TEST(JitObjectCacheTest, EvictsOnceSizeEstimateExceedsBound) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  // Each entry takes 124 bytes, so only two fit.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<JitObjectCache> cache,
+      JitObjectCache::Create(temp_dir.path(), /*max_bytes=*/300));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<JitObjectCache> other,
+      JitObjectCache::Create(temp_dir.path(), /*max_bytes=*/300));
+  std::string object(100, 'x');
+  std::string a = JitObjectCache::MakeKey("a");
+  std::string b = JitObjectCache::MakeKey("b");
+  std::string c = JitObjectCache::MakeKey("c");
+  std::string d = JitObjectCache::MakeKey("d");
+
+  XLS_ASSERT_OK(cache->Store(a, {llvm::MemoryBufferRef(object, "a")}));
+  SetLastUsed(*cache, a, std::chrono::minutes(60));
+  XLS_ASSERT_OK(other->Store(b, {llvm::MemoryBufferRef(object, "b")}));
+  // `cache` has not seen `b`, so it only estimates the entries take 248 bytes.
+  XLS_ASSERT_OK(cache->Store(c, {llvm::MemoryBufferRef(object, "c")}));
+  EXPECT_EQ(cache->stats().evictions, 0);
+  EXPECT_NE(LookupStrings(*cache, b), std::nullopt);
+
+  // Once the estimate exceeds the bound, it scans the directory and evicts
+  // the least recently used entries.
+  SetLastUsed(*cache, b, std::chrono::minutes(30));
+  SetLastUsed(*cache, c, std::chrono::minutes(10));
+  XLS_ASSERT_OK(cache->Store(d, {llvm::MemoryBufferRef(object, "d")}));
+  EXPECT_EQ(cache->stats().evictions, 2);
+  EXPECT_EQ(LookupStrings(*cache, a), std::nullopt);
+  EXPECT_EQ(LookupStrings(*cache, b), std::nullopt);
+  EXPECT_NE(LookupStrings(*cache, c), std::nullopt);
+  EXPECT_NE(LookupStrings(*cache, d), std::nullopt);
+}
+
+TEST(JitObjectCacheTest, InvalidSizeBound) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  EXPECT_FALSE(JitObjectCache::Create(temp_dir.path(), /*max_bytes=*/0).ok());
+}
+
+}  // namespace
+}  // namespace xls
@@ -38,6 +38,7 @@
 #include "xls/common/status/status_macros.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/parallel_proc_runtime.h"
 #include "xls/interpreter/proc_evaluator.h"
 #include "xls/interpreter/serial_proc_runtime.h"
 #include "xls/ir/package.h"
@@ -232,8 +233,15 @@ absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateAotRuntime(
   return std::move(proc_runtime);
 }
 
-absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateRuntime(
-    ProcElaboration elaboration, const EvaluatorOptions& options) {
+// The queue manager and per-proc JITs backing a JIT proc runtime.
+struct JitProcNetwork {
+  std::unique_ptr<JitChannelQueueManager> queue_manager;
+  std::vector<std::unique_ptr<ProcEvaluator>> proc_jits;
+};
+
+absl::StatusOr<JitProcNetwork> CreateJitProcNetwork(
+    ProcElaboration elaboration, const EvaluatorOptions& options,
+    bool lock_free_queues) {
   // We use the compiler to know the data layout.
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<OrcJit> comp,
@@ -243,27 +251,64 @@ absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateRuntime(
   XLS_ASSIGN_OR_RETURN(llvm::DataLayout layout, comp->CreateDataLayout());
   // Create a queue manager for the queues. This factory verifies that there an
   // receive only queue for every receive only channel.
-  XLS_ASSIGN_OR_RETURN(
-      std::unique_ptr<JitChannelQueueManager> queue_manager,
-      JitChannelQueueManager::CreateThreadSafe(
-          std::move(elaboration), std::make_unique<JitRuntime>(layout)));
+  JitProcNetwork network;
+  if (lock_free_queues) {
+    XLS_ASSIGN_OR_RETURN(
+        network.queue_manager,
+        JitChannelQueueManager::CreateLockFree(
+            std::move(elaboration), std::make_unique<JitRuntime>(layout)));
+  } else {
+    XLS_ASSIGN_OR_RETURN(
+        network.queue_manager,
+        JitChannelQueueManager::CreateThreadSafe(
+            std::move(elaboration), std::make_unique<JitRuntime>(layout)));
+  }
 
   // Create a ProcJit for each Proc.
-  std::vector<std::unique_ptr<ProcEvaluator>> proc_jits;
-  for (Proc* proc : queue_manager->elaboration().procs()) {
+  for (Proc* proc : network.queue_manager->elaboration().procs()) {
     XLS_ASSIGN_OR_RETURN(
         std::unique_ptr<ProcJit> proc_jit,
         ProcJit::Create(
-            proc, &queue_manager->runtime(), queue_manager.get(),
+            proc, &network.queue_manager->runtime(),
+            network.queue_manager.get(),
             /*include_observer_callbacks=*/options.support_observers()));
-    proc_jits.push_back(std::move(proc_jit));
+    network.proc_jits.push_back(std::move(proc_jit));
   }
+  return network;
+}
+
+absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateRuntime(
+    ProcElaboration elaboration, const EvaluatorOptions& options) {
+  XLS_ASSIGN_OR_RETURN(JitProcNetwork network,
+                       CreateJitProcNetwork(std::move(elaboration), options,
+                                            /*lock_free_queues=*/false));
+
+  // Create a runtime.
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<SerialProcRuntime> proc_runtime,
+                       SerialProcRuntime::Create(
+                           std::move(network.proc_jits),
+                           std::move(network.queue_manager), options));
+
+  XLS_RETURN_IF_ERROR(InsertInitialChannelValues(
+      proc_runtime->elaboration(), proc_runtime->queue_manager()));
+  return std::move(proc_runtime);
+}
+
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>> CreateParallelRuntime(
+    ProcElaboration elaboration, const EvaluatorOptions& options,
+    int64_t thread_count) {
+  // Each channel instance has a single sending and a single receiving proc
+  // instance, and an instance only runs on one thread at a time.
+  XLS_ASSIGN_OR_RETURN(JitProcNetwork network,
+                       CreateJitProcNetwork(std::move(elaboration), options,
+                                            /*lock_free_queues=*/true));
 
   // Create a runtime.
   XLS_ASSIGN_OR_RETURN(
-      std::unique_ptr<SerialProcRuntime> proc_runtime,
-      SerialProcRuntime::Create(std::move(proc_jits), std::move(queue_manager),
-                                options));
+      std::unique_ptr<ParallelProcRuntime> proc_runtime,
+      ParallelProcRuntime::Create(std::move(network.proc_jits),
+                                  std::move(network.queue_manager), options,
+                                  thread_count));
 
   XLS_RETURN_IF_ERROR(InsertInitialChannelValues(
       proc_runtime->elaboration(), proc_runtime->queue_manager()));
@@ -286,6 +331,22 @@ absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateJitSerialProcRuntime(
   return CreateRuntime(std::move(elaboration), options);
 }
 
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+CreateJitParallelProcRuntime(Package* package, const EvaluatorOptions& options,
+                             int64_t thread_count) {
+  XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
+                       ProcElaboration::ElaborateOldStylePackage(package));
+  return CreateParallelRuntime(std::move(elaboration), options, thread_count);
+}
+
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+CreateJitParallelProcRuntime(Proc* top, const EvaluatorOptions& options,
+                             int64_t thread_count) {
+  XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
+                       ProcElaboration::Elaborate(top));
+  return CreateParallelRuntime(std::move(elaboration), options, thread_count);
+}
+
 absl::StatusOr<JitObjectCode> CreateProcAotObjectCode(Package* package,
                                                       int64_t opt_level,
                                                       bool with_msan,
@@ -37,6 +37,7 @@
 #include "xls/ir/bits.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
+#include "xls/jit/jit_object_cache.h"
 #include "xls/jit/llvm_type_converter.h"
 
 namespace xls {
@@ -47,6 +48,14 @@ JitRuntime::JitRuntime(llvm::DataLayout data_layout)
       type_converter_(
           std::make_unique<LlvmTypeConverter>(context_.get(), data_layout_)) {}
 
+/* static */ JitObjectCacheStats JitRuntime::GetObjectCacheStats() {
+  JitObjectCache* cache = JitObjectCache::GetDefault();
+  if (cache == nullptr) {
+    return JitObjectCacheStats{};
+  }
+  return cache->stats();
+}
+
 absl::Status JitRuntime::PackArgs(absl::Span<const Value> args,
                                   absl::Span<Type* const> arg_types,
                                   absl::Span<uint8_t* const> arg_buffers) {
@@ -26,6 +26,7 @@
 #include "llvm/include/llvm/IR/DataLayout.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
+#include "xls/jit/jit_object_cache.h"
 #include "xls/jit/llvm_type_converter.h"
 
 namespace xls {
@@ -57,6 +58,10 @@ class JitRuntime {
 
   const llvm::DataLayout& data_layout() { return data_layout_; }
 
+  // Returns the hit/miss statistics of the process-wide JIT object cache (see
+  // JitObjectCache::GetDefault), or all zeros if no cache is configured.
+  static JitObjectCacheStats GetObjectCacheStats();
+
   // Returns the number of bytes that should be allocated for a native LLVM
   // value storing `size` bytes with `alignment` alignment.
   //
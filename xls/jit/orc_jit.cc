@@ -14,12 +14,14 @@
 
 #include "xls/jit/orc_jit.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "absl/log/log.h"
 #include "absl/log/vlog_is_on.h"
@@ -30,6 +32,9 @@
 #include "absl/strings/str_format.h"
 #include "llvm/include/llvm/ADT/SmallVector.h"
 #include "llvm/include/llvm/Analysis/CGSCCPassManager.h"
+#include "llvm/include/llvm/Bitcode/BitcodeReader.h"
+#include "llvm/include/llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/include/llvm/Config/llvm-config.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/AbsoluteSymbols.h"  // IWYU pragma: keep
 #include "llvm/include/llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/Core.h"
@@ -45,19 +50,27 @@
 #include "llvm/include/llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/include/llvm/IR/BasicBlock.h"
 #include "llvm/include/llvm/IR/DataLayout.h"
+#include "llvm/include/llvm/IR/Function.h"
+#include "llvm/include/llvm/IR/GlobalVariable.h"
 #include "llvm/include/llvm/IR/Instruction.h"
+#include "llvm/include/llvm/IR/LLVMContext.h"
 #include "llvm/include/llvm/IR/LegacyPassManager.h"
 #include "llvm/include/llvm/IR/Module.h"
 #include "llvm/include/llvm/IRPrinter/IRPrintingPasses.h"
 #include "llvm/include/llvm/Passes/PassBuilder.h"
 #include "llvm/include/llvm/Support/CodeGen.h"
 #include "llvm/include/llvm/Support/Error.h"
+#include "llvm/include/llvm/Support/MemoryBuffer.h"
+#include "llvm/include/llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/include/llvm/Support/raw_ostream.h"
 #include "llvm/include/llvm/Transforms/Instrumentation/MemorySanitizer.h"
+#include "llvm/include/llvm/Transforms/Utils/SplitModule.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/jit/jit_clang_builtins.h"
 #include "xls/jit/jit_emulated_tls.h"  // NOLINT: Used with MSAN
+#include "xls/jit/jit_object_cache.h"
 #include "xls/jit/llvm_compiler.h"
 #include "xls/jit/observer.h"
 
@@ -72,7 +85,10 @@ OrcJit::OrcJit(int64_t opt_level, bool include_msan,
       object_layer_(
           execution_session_,
           []() { return std::make_unique<llvm::SectionMemoryManager>(); }),
-      dylib_(execution_session_.createBareJITDylib("main")) {}
+      dylib_(execution_session_.createBareJITDylib("main")),
+      object_cache_(JitObjectCache::GetDefault()),
+      compile_threads_(std::min<int64_t>(AvailableCPUs(),
+                                         kMaxDefaultCompileThreads)) {}
 
 OrcJit::~OrcJit() {
   if (auto err = execution_session_.endSession()) {
@@ -221,7 +237,9 @@ absl::Status OrcJit::InitInternal() {
   // Add some selected compiler-rt symbols.
   XLS_RETURN_IF_ERROR(AddCompilerRtSymbols(dylib_, data_layout_));
 
-  auto compiler = std::make_unique<llvm::orc::SimpleCompiler>(*target_machine_);
+  auto compiler = std::make_unique<llvm::orc::SimpleCompiler>(*target_machine_,
+                                                              object_cache_);
+  compiler_ = compiler.get();
   compile_layer_ = std::make_unique<llvm::orc::IRCompileLayer>(
       execution_session_, object_layer_, std::move(compiler));
 
@@ -237,8 +255,191 @@ absl::Status OrcJit::InitInternal() {
   return absl::OkStatus();
 }
 
+namespace {
+
+// Returns whether the module defines any functions or variables.
+bool HasDefinitions(const llvm::Module& module) {
+  for (const llvm::Function& function : module.functions()) {
+    if (!function.isDeclaration()) {
+      return true;
+    }
+  }
+  for (const llvm::GlobalVariable& variable : module.globals()) {
+    if (!variable.isDeclaration()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+void OrcJit::SetObjectCache(JitObjectCache* object_cache) {
+  object_cache_ = object_cache;
+  if (compiler_ != nullptr) {
+    compiler_->setObjectCache(object_cache);
+  }
+}
+
+bool OrcJit::ObserverRequestsModuleCode() const {
+  if (jit_observer_ == nullptr) {
+    return false;
+  }
+  JitObserverRequests requests = jit_observer_->GetNotificationOptions();
+  return requests.unoptimized_module || requests.optimized_module ||
+         requests.assembly_code_str;
+}
+
+std::string OrcJit::GetObjectCacheKey(const llvm::Module& module) const {
+  // The module IR determines the object code along with the compiler, the
+  // target and the optimization options (which include MSAN instrumentation).
+  return JitObjectCache::MakeKey(absl::StrCat(
+      "llvm_version=", LLVM_VERSION_STRING, "\ntriple=", target_triple(),
+      "\ncpu=", target_machine_->getTargetCPU().str(),
+      "\nfeatures=", target_machine_->getTargetFeatureString().str(),
+      "\nopt_level=", opt_level_, "\nmsan=", include_msan_,
+      "\nobserver_callbacks=", include_observer_callbacks_, "\n",
+      DumpLlvmModuleToString(&module)));
+}
+
+bool OrcJit::ShouldCompileInParallel(const llvm::Module& module) const {
+  if (compile_threads_ <= 1 || VLOG_IS_ON(2) || ObserverRequestsModuleCode()) {
+    // The optimizer logs or reports the whole module's IR and assembly in
+    // these cases.
+    return false;
+  }
+  int64_t instruction_count = 0;
+  for (const llvm::Function& function : module.functions()) {
+    instruction_count += function.getInstructionCount();
+  }
+  return instruction_count >= min_parallel_compile_instruction_count_;
+}
+
+absl::Status OrcJit::CompileModuleInParallel(
+    std::unique_ptr<llvm::Module> module,
+    std::optional<std::string> cache_key) {
+  // An LLVM context can only be used by one thread at a time, so each part is
+  // serialized to bitcode and compiled in a context of its own.
+  std::vector<llvm::SmallVector<char, 0>> parts;
+  llvm::SplitModule(
+      *module, compile_threads_,
+      [&](std::unique_ptr<llvm::Module> part) {
+        if (!HasDefinitions(*part)) {
+          return;
+        }
+        llvm::raw_svector_ostream ostream(parts.emplace_back());
+        llvm::WriteBitcodeToFile(*part, ostream);
+      },
+      /*PreserveLocals=*/true);
+  VLOG(1) << absl::StreamFormat("Compiling module `%s` in %d parts",
+                                module->getName().str(), parts.size());
+  module.reset();
+
+  std::vector<absl::StatusOr<std::unique_ptr<llvm::MemoryBuffer>>> objects(
+      parts.size());
+  auto compile_part = [&](int64_t i) -> absl::Status {
+    llvm::LLVMContext context;
+    llvm::Expected<std::unique_ptr<llvm::Module>> part = llvm::parseBitcodeFile(
+        llvm::MemoryBufferRef(llvm::StringRef(parts[i].data(), parts[i].size()),
+                              absl::StrCat("part_", i)),
+        context);
+    if (!part) {
+      return absl::InternalError(
+          absl::StrCat("Unable to parse module part: ",
+                       llvm::toString(part.takeError())));
+    }
+    if (llvm::Error error = PerformStandardOptimization(part->get())) {
+      return absl::InternalError(absl::StrCat(
+          "Unable to optimize module part: ", llvm::toString(std::move(error))));
+    }
+    // Target machines can't be shared between threads either.
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<llvm::TargetMachine> target_machine,
+                         CreateTargetMachine());
+    llvm::SmallVector<char, 0> object;
+    {
+      llvm::raw_svector_ostream ostream(object);
+      llvm::legacy::PassManager mpm;
+      if (target_machine->addPassesToEmitFile(
+              mpm, ostream, nullptr, llvm::CodeGenFileType::ObjectFile)) {
+        return absl::InternalError("Could not create object generation pass");
+      }
+      mpm.run(**part);
+    }
+    objects[i] = std::make_unique<llvm::SmallVectorMemoryBuffer>(
+        std::move(object), absl::StrCat("part_", i, "-jitted-objectbuffer"),
+        /*RequiresNullTerminator=*/false);
+    return absl::OkStatus();
+  };
+
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t i = 1; i < parts.size(); ++i) {
+    threads.push_back(std::make_unique<Thread>([&compile_part, &objects, i] {
+      absl::Status status = compile_part(i);
+      if (!status.ok()) {
+        objects[i] = status;
+      }
+    }));
+  }
+  if (!parts.empty()) {
+    absl::Status status = compile_part(0);
+    if (!status.ok()) {
+      objects[0] = status;
+    }
+  }
+  for (std::unique_ptr<Thread>& thread : threads) {
+    thread->Join();
+  }
+
+  for (absl::StatusOr<std::unique_ptr<llvm::MemoryBuffer>>& object : objects) {
+    XLS_RETURN_IF_ERROR(object.status());
+  }
+  if (cache_key.has_value()) {
+    std::vector<llvm::MemoryBufferRef> object_refs;
+    for (absl::StatusOr<std::unique_ptr<llvm::MemoryBuffer>>& object :
+         objects) {
+      object_refs.push_back((*object)->getMemBufferRef());
+    }
+    absl::Status status = object_cache_->Store(*cache_key, object_refs);
+    if (!status.ok()) {
+      LOG(WARNING) << "Unable to store JIT object code: " << status;
+    }
+  }
+  for (absl::StatusOr<std::unique_ptr<llvm::MemoryBuffer>>& object : objects) {
+    if (llvm::Error error = object_layer_.add(dylib_, *std::move(object))) {
+      return absl::UnknownError(
+          absl::StrFormat("Error adding compiled module part: %s",
+                          llvm::toString(std::move(error))));
+    }
+  }
+  return absl::OkStatus();
+}
+
 absl::Status OrcJit::CompileModule(std::unique_ptr<llvm::Module>&& module) {
   XLS_RETURN_IF_ERROR(VerifyModule(*module));
+  std::optional<std::string> cache_key;
+  if (object_cache_ != nullptr && !ObserverRequestsModuleCode()) {
+    cache_key = GetObjectCacheKey(*module);
+    std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> objects =
+        object_cache_->Lookup(*cache_key);
+    if (objects.has_value()) {
+      VLOG(1) << "Using cached object code for module "
+              << module->getName().str();
+      for (std::unique_ptr<llvm::MemoryBuffer>& object : *objects) {
+        if (llvm::Error error = object_layer_.add(dylib_, std::move(object))) {
+          return absl::UnknownError(
+              absl::StrFormat("Error adding cached object code: %s",
+                              llvm::toString(std::move(error))));
+        }
+      }
+      return absl::OkStatus();
+    }
+    // The compiler stores the object code under the module identifier (see
+    // JitObjectCache::notifyObjectCompiled).
+    module->setModuleIdentifier(*cache_key);
+  }
+  if (ShouldCompileInParallel(*module)) {
+    return CompileModuleInParallel(std::move(module), std::move(cache_key));
+  }
   llvm::Error error = transform_layer_->add(
       dylib_, llvm::orc::ThreadSafeModule(std::move(module), context_));
   if (error) {
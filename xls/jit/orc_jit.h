@@ -17,10 +17,13 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "llvm/include/llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/Core.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/IRTransformLayer.h"
@@ -31,6 +34,7 @@
 #include "llvm/include/llvm/Support/Error.h"
 #include "llvm/include/llvm/Support/raw_ostream.h"
 #include "llvm/include/llvm/Target/TargetMachine.h"
+#include "xls/jit/jit_object_cache.h"
 #include "xls/jit/llvm_compiler.h"
 #include "xls/jit/observer.h"
 
@@ -40,6 +44,11 @@ namespace xls {
 class OrcJit : public LlvmCompiler {
  public:
   static constexpr int64_t kDefaultOptLevel = 2;
+  // Defaults for SetParallelCompilation. By default up to
+  // kMaxDefaultCompileThreads threads are used, limited by the available
+  // CPUs.
+  static constexpr int64_t kMaxDefaultCompileThreads = 8;
+  static constexpr int64_t kDefaultMinParallelCompileInstructionCount = 50000;
 
   ~OrcJit() override;
 
@@ -59,6 +68,23 @@ class OrcJit : public LlvmCompiler {
 
   JitObserver* jit_observer() const { return jit_observer_; }
 
+  // Sets the cache used to reuse object code compiled for identical modules,
+  // possibly by other processes. Defaults to JitObjectCache::GetDefault().
+  // Nullptr disables caching. Must be called before CompileModule.
+  void SetObjectCache(JitObjectCache* object_cache);
+  JitObjectCache* object_cache() const { return object_cache_; }
+
+  // Configures parallel compilation. Modules with at least
+  // `min_instruction_count` LLVM instructions are split into up to `threads`
+  // parts (keeping functions which share internal symbols together) which are
+  // optimized and compiled to object code concurrently. Parallel compilation
+  // is disabled if `threads` <= 1, and isn't used when the JIT observer
+  // requests the module IR or assembly.
+  void SetParallelCompilation(int64_t threads, int64_t min_instruction_count) {
+    compile_threads_ = threads;
+    min_parallel_compile_instruction_count_ = min_instruction_count;
+  }
+
   // Compiles the given LLVM module into the JIT's execution session.
   absl::Status CompileModule(std::unique_ptr<llvm::Module>&& module) override;
 
@@ -84,15 +110,41 @@ class OrcJit : public LlvmCompiler {
       llvm::orc::ThreadSafeModule module,
       const llvm::orc::MaterializationResponsibility& responsibility);
 
+  // Returns whether the JIT observer asks to be notified of module IR or
+  // assembly, which are only produced when compiling the whole module with the
+  // optimizer above.
+  bool ObserverRequestsModuleCode() const;
+
+  // Returns whether the given module should be compiled with
+  // CompileModuleInParallel.
+  bool ShouldCompileInParallel(const llvm::Module& module) const;
+
+  // Splits the given module into parts which are optimized and compiled on
+  // separate threads, and adds the resulting objects to the JIT. If
+  // `cache_key` is given the objects are stored in the object cache.
+  absl::Status CompileModuleInParallel(std::unique_ptr<llvm::Module> module,
+                                       std::optional<std::string> cache_key);
+
+  // Returns the object cache key for the given (unoptimized) module compiled
+  // with this JIT's configuration.
+  std::string GetObjectCacheKey(const llvm::Module& module) const;
+
   llvm::orc::ThreadSafeContext context_;
   llvm::orc::ExecutionSession execution_session_;
   llvm::orc::RTDyldObjectLinkingLayer object_layer_;
   llvm::orc::JITDylib& dylib_;
 
   std::unique_ptr<llvm::orc::IRCompileLayer> compile_layer_;
+  // Owned by compile_layer_.
+  llvm::orc::SimpleCompiler* compiler_ = nullptr;
   std::unique_ptr<llvm::orc::IRTransformLayer> transform_layer_;
 
   JitObserver* jit_observer_ = nullptr;
+  JitObjectCache* object_cache_;
+
+  int64_t compile_threads_;
+  int64_t min_parallel_compile_instruction_count_ =
+      kDefaultMinParallelCompileInstructionCount;
 };
 
 }  // namespace xls
@@ -0,0 +1,105 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_NETLIST_BIT_SLICED_VALUE_H_
+#define XLS_NETLIST_BIT_SLICED_VALUE_H_
+
+#include <cstdint>
+#include <ostream>
+#include <utility>
+
+#include "absl/log/check.h"
+#include "absl/strings/str_format.h"
+
+namespace xls {
+namespace netlist {
+
+// A bundle of 64 independent boolean values ("lanes") which are operated on
+// together. Used as the EvalT of the netlist interpreter, a single evaluation
+// of a netlist simulates 64 input vectors at once: lane i of every net holds
+// the value of that net for the i-th vector.
+//
+// Cells described by state tables, including SB_LUT4 cells, are not supported,
+// since matching a table row requires a single scalar value per input. The
+// interpreter rejects them before evaluating anything.
+class BitSlicedValue {
+ public:
+  static constexpr int64_t kLaneCount = 64;
+
+  constexpr BitSlicedValue() = default;
+
+  // Sets every lane to `value`. This lets BitSlicedValue{false} and
+  // BitSlicedValue{true} serve as the interpreter's zero and one.
+  explicit constexpr BitSlicedValue(bool value)
+      : lanes_(value ? ~uint64_t{0} : uint64_t{0}) {}
+
+  // Creates a value whose lane i is bit i of `lanes`.
+  static constexpr BitSlicedValue FromLanes(uint64_t lanes) {
+    BitSlicedValue result;
+    result.lanes_ = lanes;
+    return result;
+  }
+
+  constexpr uint64_t lanes() const { return lanes_; }
+
+  bool lane(int64_t i) const {
+    DCHECK(i >= 0 && i < kLaneCount);
+    return (lanes_ >> i) & 1;
+  }
+  void set_lane(int64_t i, bool value) {
+    DCHECK(i >= 0 && i < kLaneCount);
+    lanes_ = (lanes_ & ~(uint64_t{1} << i)) | (uint64_t{value} << i);
+  }
+
+  constexpr BitSlicedValue operator&(const BitSlicedValue& rhs) const {
+    return FromLanes(lanes_ & rhs.lanes_);
+  }
+  constexpr BitSlicedValue operator|(const BitSlicedValue& rhs) const {
+    return FromLanes(lanes_ | rhs.lanes_);
+  }
+  constexpr BitSlicedValue operator^(const BitSlicedValue& rhs) const {
+    return FromLanes(lanes_ ^ rhs.lanes_);
+  }
+  constexpr BitSlicedValue operator!() const { return FromLanes(~lanes_); }
+
+  friend constexpr bool operator==(const BitSlicedValue& lhs,
+                                   const BitSlicedValue& rhs) {
+    return lhs.lanes_ == rhs.lanes_;
+  }
+  friend constexpr bool operator!=(const BitSlicedValue& lhs,
+                                   const BitSlicedValue& rhs) {
+    return !(lhs == rhs);
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const BitSlicedValue& value) {
+    return H::combine(std::move(h), value.lanes_);
+  }
+  template <typename Sink>
+  friend void AbslStringify(Sink& sink, const BitSlicedValue& value) {
+    absl::Format(&sink, "0x%016x", value.lanes_);
+  }
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const BitSlicedValue& value) {
+    return os << absl::StrFormat("0x%016x", value.lanes_);
+  }
+
+ private:
+  uint64_t lanes_ = 0;
+};
+
+}  // namespace netlist
+}  // namespace xls
+
+#endif  // XLS_NETLIST_BIT_SLICED_VALUE_H_
@@ -0,0 +1,54 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/netlist/bit_sliced_value.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace xls {
+namespace netlist {
+namespace {
+
+TEST(BitSlicedValueTest, SplatAndLanes) {
+  EXPECT_EQ(BitSlicedValue(false).lanes(), 0);
+  EXPECT_EQ(BitSlicedValue(true).lanes(), ~uint64_t{0});
+  EXPECT_EQ(BitSlicedValue{}, BitSlicedValue(false));
+
+  BitSlicedValue value;
+  value.set_lane(0, true);
+  value.set_lane(63, true);
+  value.set_lane(5, true);
+  value.set_lane(5, false);
+  EXPECT_EQ(value.lanes(), (uint64_t{1} << 63) | 1);
+  EXPECT_TRUE(value.lane(0));
+  EXPECT_FALSE(value.lane(5));
+  EXPECT_TRUE(value.lane(63));
+  EXPECT_EQ(testing::PrintToString(value), "0x8000000000000001");
+}
+
+TEST(BitSlicedValueTest, OperatorsAreLanewise) {
+  BitSlicedValue a = BitSlicedValue::FromLanes(0b1100);
+  BitSlicedValue b = BitSlicedValue::FromLanes(0b1010);
+  EXPECT_EQ((a & b).lanes(), 0b1000);
+  EXPECT_EQ((a | b).lanes(), 0b1110);
+  EXPECT_EQ((a ^ b).lanes(), 0b0110);
+  EXPECT_EQ((!a).lanes(), ~uint64_t{0b1100});
+  EXPECT_NE(a, b);
+}
+
+}  // namespace
+}  // namespace netlist
+}  // namespace xls
@@ -0,0 +1,95 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/netlist/compiled_function.h"
+
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/netlist/function_parser.h"
+
+namespace xls {
+namespace netlist {
+namespace function {
+namespace {
+
+using Instruction = CompiledFunction::Instruction;
+using Opcode = CompiledFunction::Opcode;
+
+// Appends the postfix form of `ast` to `instructions`.
+absl::Status CompileInto(
+    const Ast& ast,
+    absl::FunctionRef<std::optional<CompiledFunction::Pin>(std::string_view)>
+        resolve,
+    std::vector<Instruction>& instructions) {
+  for (const Ast& child : ast.children()) {
+    XLS_RETURN_IF_ERROR(CompileInto(child, resolve, instructions));
+  }
+  switch (ast.kind()) {
+    case Ast::Kind::kIdentifier: {
+      std::optional<CompiledFunction::Pin> pin = resolve(ast.name());
+      if (!pin.has_value()) {
+        return absl::NotFoundError(
+            absl::StrFormat("Identifier \"%s\" not found", ast.name()));
+      }
+      instructions.push_back(
+          Instruction{.opcode = pin->internal ? Opcode::kInternal
+                                              : Opcode::kInput,
+                      .operand = pin->index});
+      return absl::OkStatus();
+    }
+    case Ast::Kind::kLiteralZero:
+      instructions.push_back(Instruction{.opcode = Opcode::kLiteralZero});
+      return absl::OkStatus();
+    case Ast::Kind::kLiteralOne:
+      instructions.push_back(Instruction{.opcode = Opcode::kLiteralOne});
+      return absl::OkStatus();
+    case Ast::Kind::kNot:
+      instructions.push_back(Instruction{.opcode = Opcode::kNot});
+      return absl::OkStatus();
+    case Ast::Kind::kAnd:
+      instructions.push_back(Instruction{.opcode = Opcode::kAnd});
+      return absl::OkStatus();
+    case Ast::Kind::kOr:
+      instructions.push_back(Instruction{.opcode = Opcode::kOr});
+      return absl::OkStatus();
+    case Ast::Kind::kXor:
+      instructions.push_back(Instruction{.opcode = Opcode::kXor});
+      return absl::OkStatus();
+  }
+  return absl::InvalidArgumentError(
+      absl::StrCat("Unknown AST element type: ", static_cast<int>(ast.kind())));
+}
+
+}  // namespace
+
+absl::StatusOr<CompiledFunction> CompiledFunction::Compile(
+    const Ast& ast,
+    absl::FunctionRef<std::optional<Pin>(std::string_view)> resolve) {
+  std::vector<Instruction> instructions;
+  XLS_RETURN_IF_ERROR(CompileInto(ast, resolve, instructions));
+  return CompiledFunction(std::move(instructions));
+}
+
+}  // namespace function
+}  // namespace netlist
+}  // namespace xls
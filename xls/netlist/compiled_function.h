@@ -0,0 +1,142 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compiles the ASTs of cell library "function" attributes into a flat postfix
+// program, so that evaluating a cell doesn't need to walk the AST or resolve
+// pin names.
+#ifndef XLS_NETLIST_COMPILED_FUNCTION_H_
+#define XLS_NETLIST_COMPILED_FUNCTION_H_
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/netlist/function_parser.h"
+
+namespace xls {
+namespace netlist {
+namespace function {
+
+// A function AST compiled into a sequence of stack-machine instructions, with
+// each identifier resolved to the index of an input pin or internal (state
+// table) pin of the cell.
+class CompiledFunction {
+ public:
+  enum class Opcode : uint8_t {
+    // Pushes the value of the input pin `operand`.
+    kInput,
+    // Pushes the value of the internal pin `operand`.
+    kInternal,
+    kLiteralZero,
+    kLiteralOne,
+    kNot,
+    kAnd,
+    kOr,
+    kXor,
+  };
+
+  struct Instruction {
+    Opcode opcode;
+    int64_t operand = 0;
+  };
+
+  // The pin an identifier refers to.
+  struct Pin {
+    bool internal = false;
+    int64_t index;
+  };
+
+  // Compiles `ast`, using `resolve` to map each identifier to a pin. Returns a
+  // NotFound error if an identifier can't be resolved.
+  static absl::StatusOr<CompiledFunction> Compile(
+      const Ast& ast,
+      absl::FunctionRef<std::optional<Pin>(std::string_view)> resolve);
+
+  // Evaluates the function. `input(i)` must return the value of input pin `i`
+  // and `internal(i)` the (status-wrapped) value of internal pin `i`. `stack`
+  // is scratch space, passed in so it can be reused across evaluations.
+  template <typename EvalT, typename InputFn, typename InternalFn>
+  absl::StatusOr<EvalT> Evaluate(const EvalT& zero, const EvalT& one,
+                                 InputFn&& input, InternalFn&& internal,
+                                 std::vector<EvalT>& stack) const;
+
+  absl::Span<const Instruction> instructions() const { return instructions_; }
+
+ private:
+  explicit CompiledFunction(std::vector<Instruction> instructions)
+      : instructions_(std::move(instructions)) {}
+
+  std::vector<Instruction> instructions_;
+};
+
+template <typename EvalT, typename InputFn, typename InternalFn>
+absl::StatusOr<EvalT> CompiledFunction::Evaluate(
+    const EvalT& zero, const EvalT& one, InputFn&& input,
+    InternalFn&& internal, std::vector<EvalT>& stack) const {
+  stack.clear();
+  for (const Instruction& instruction : instructions_) {
+    switch (instruction.opcode) {
+      case Opcode::kInput:
+        stack.push_back(input(instruction.operand));
+        break;
+      case Opcode::kInternal: {
+        XLS_ASSIGN_OR_RETURN(EvalT value, internal(instruction.operand));
+        stack.push_back(std::move(value));
+        break;
+      }
+      case Opcode::kLiteralZero:
+        stack.push_back(zero);
+        break;
+      case Opcode::kLiteralOne:
+        stack.push_back(one);
+        break;
+      case Opcode::kNot: {
+        EvalT value = std::move(stack.back());
+        stack.pop_back();
+        stack.push_back(!value);
+        break;
+      }
+      case Opcode::kAnd:
+      case Opcode::kOr:
+      case Opcode::kXor: {
+        EvalT rhs = std::move(stack.back());
+        stack.pop_back();
+        EvalT lhs = std::move(stack.back());
+        stack.pop_back();
+        if (instruction.opcode == Opcode::kAnd) {
+          stack.push_back(lhs & rhs);
+        } else if (instruction.opcode == Opcode::kOr) {
+          stack.push_back(lhs | rhs);
+        } else {
+          stack.push_back(lhs ^ rhs);
+        }
+        break;
+      }
+    }
+  }
+  return std::move(stack.back());
+}
+
+}  // namespace function
+}  // namespace netlist
+}  // namespace xls
+
+#endif  // XLS_NETLIST_COMPILED_FUNCTION_H_
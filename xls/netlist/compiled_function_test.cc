@@ -0,0 +1,101 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/netlist/compiled_function.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/matchers.h"
+#include "xls/netlist/function_parser.h"
+
+namespace xls {
+namespace netlist {
+namespace function {
+namespace {
+
+using ::absl_testing::StatusIs;
+
+// Resolves "A", "B" and "C" to input pins 0-2 and "IQ" to internal pin 0.
+std::optional<CompiledFunction::Pin> ResolveTestPin(std::string_view name) {
+  if (name == "IQ") {
+    return CompiledFunction::Pin{.internal = true, .index = 0};
+  }
+  if (name.size() == 1 && name[0] >= 'A' && name[0] <= 'C') {
+    return CompiledFunction::Pin{.index = name[0] - 'A'};
+  }
+  return std::nullopt;
+}
+
+absl::StatusOr<CompiledFunction> CompileTestFunction(std::string_view text) {
+  XLS_ASSIGN_OR_RETURN(Ast ast, Parser::ParseFunction(std::string(text)));
+  return CompiledFunction::Compile(ast, ResolveTestPin);
+}
+
+TEST(CompiledFunctionTest, MatchesTruthTable) {
+  XLS_ASSERT_OK_AND_ASSIGN(CompiledFunction function,
+                           CompileTestFunction("(A & !B) | (B ^ C)"));
+  std::vector<bool> stack;
+  for (int64_t row = 0; row < 8; ++row) {
+    const bool a = row & 1;
+    const bool b = row & 2;
+    const bool c = row & 4;
+    std::vector<bool> inputs = {a, b, c};
+    XLS_ASSERT_OK_AND_ASSIGN(
+        bool value,
+        function.Evaluate<bool>(
+            false, true, [&](int64_t pin) -> bool { return inputs[pin]; },
+            [](int64_t pin) -> absl::StatusOr<bool> {
+              return absl::InternalError("unexpected internal pin");
+            },
+            stack));
+    EXPECT_EQ(value, (a && !b) || (b != c)) << "row " << row;
+  }
+}
+
+TEST(CompiledFunctionTest, InternalPinsAndLiterals) {
+  XLS_ASSERT_OK_AND_ASSIGN(CompiledFunction function,
+                           CompileTestFunction("(IQ & 1) | (A & 0)"));
+  std::vector<bool> stack;
+  for (bool iq : {false, true}) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        bool value,
+        function.Evaluate<bool>(
+            false, true, [](int64_t pin) -> bool { return true; },
+            [&](int64_t pin) -> absl::StatusOr<bool> {
+              EXPECT_EQ(pin, 0);
+              return iq;
+            },
+            stack));
+    EXPECT_EQ(value, iq);
+  }
+}
+
+TEST(CompiledFunctionTest, UnknownIdentifier) {
+  EXPECT_THAT(CompileTestFunction("A & Q"),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+}  // namespace
+}  // namespace function
+}  // namespace netlist
+}  // namespace xls
@@ -17,10 +17,15 @@
 
 #include "absl/status/statusor.h"
 #include "xls/netlist/cell_library.h"
+#include "xls/netlist/netlist.pb.h"
 
 namespace xls {
 namespace netlist {
 
+// Returns the proto of the fake cell library, e.g. for building it with a
+// non-default EvalT.
+absl::StatusOr<CellLibraryProto> MakeFakeCellLibraryProto();
+
 // Creates a fake cell library suitable for testing.
 absl::StatusOr<CellLibrary> MakeFakeCellLibrary();
 
@@ -21,7 +21,9 @@
 #include <optional>
 #include <queue>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
@@ -38,7 +40,9 @@
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/thread.h"
+#include "xls/netlist/bit_sliced_value.h"
 #include "xls/netlist/cell_library.h"
+#include "xls/netlist/compiled_function.h"
 #include "xls/netlist/function_parser.h"
 #include "xls/netlist/netlist.h"
 
@@ -53,6 +57,12 @@ using NetRef2Value = AbstractNetRef2Value<bool>;
 
 // Interprets Netlists/Modules given a set of input values and returns the
 // resulting value.
+//
+// Without worker threads, each module is levelized once into a static
+// evaluation order over densely-numbered nets, with the cells' "function"
+// attributes compiled to flat programs (see ModulePlan), and every subsequent
+// InterpretModule call just runs that order. With worker threads, cells are
+// dispatched to the pool as their inputs become available.
 template <typename EvalT = bool>
 class AbstractInterpreter {
  public:
@@ -137,8 +147,59 @@ class AbstractInterpreter {
       const rtl::AbstractCell<EvalT>& cell, const std::string& pin_name,
       const AbstractNetRef2Value<EvalT>& inputs);
 
+  // Returns an error if `cell` is described by a state table and EvalT is
+  // bit-sliced: matching a table row needs a single scalar value per input,
+  // while the lanes of a BitSlicedValue may disagree.
+  static absl::Status CheckStateTableSupported(
+      const rtl::AbstractCell<EvalT>& cell);
+
   absl::Status ThreadBody();
 
+  // A cell of a levelized module.
+  struct CellStep {
+    const rtl::AbstractCell<EvalT>* cell;
+    // Whether the cell is an instance of a module in the netlist.
+    bool is_module = false;
+    // Value slots of the cell's input and output pins, in pin order.
+    std::vector<int64_t> input_slots;
+    std::vector<int64_t> output_slots;
+    // The compiled "function" attribute of each output pin, for outputs
+    // without a custom evaluation function.
+    std::vector<std::optional<function::CompiledFunction>> functions;
+  };
+
+  // A module levelized into a static evaluation order. Each net of the module
+  // is assigned a slot in a dense value array.
+  struct ModulePlan {
+    absl::flat_hash_map<rtl::AbstractNetRef<EvalT>, int64_t> slots;
+    // Cells in an order in which all of a cell's inputs are computed before
+    // the cell itself.
+    std::vector<CellStep> steps;
+    // Module inputs which are read by some cell.
+    std::vector<rtl::AbstractNetRef<EvalT>> used_inputs;
+    // Module outputs which are driven by some cell, and their slots.
+    std::vector<std::pair<rtl::AbstractNetRef<EvalT>, int64_t>> driven_outputs;
+  };
+
+  // Returns the (cached) levelized form of `module`.
+  absl::StatusOr<const ModulePlan*> GetModulePlan(
+      const rtl::AbstractModule<EvalT>* module);
+  absl::StatusOr<std::unique_ptr<ModulePlan>> BuildModulePlan(
+      const rtl::AbstractModule<EvalT>* module);
+
+  // Interprets `module` by evaluating its levelized cells in order.
+  absl::StatusOr<AbstractNetRef2Value<EvalT>> InterpretLevelized(
+      const rtl::AbstractModule<EvalT>* module,
+      const AbstractNetRef2Value<EvalT>& inputs,
+      absl::Span<const std::string> dump_cells);
+
+  // Fills in the values of module outputs which are not driven by a cell by
+  // following the module's assign statements.
+  absl::Status ResolveAssignedOutputs(
+      const rtl::AbstractModule<EvalT>* module,
+      const AbstractNetRef2Value<EvalT>& inputs,
+      AbstractNetRef2Value<EvalT>& outputs);
+
   rtl::AbstractNetlist<EvalT>* netlist_;
   EvalT zero_;
   EvalT one_;
@@ -177,6 +238,11 @@ class AbstractInterpreter {
   std::atomic_size_t num_available_threads_ ABSL_GUARDED_BY(input_queue_guard_);
   // Set to shut down thread pool.
   std::atomic_bool threads_should_exit_ ABSL_GUARDED_BY(input_queue_guard_);
+
+  absl::Mutex plans_mutex_;
+  absl::flat_hash_map<const rtl::AbstractModule<EvalT>*,
+                      std::unique_ptr<ModulePlan>>
+      plans_ ABSL_GUARDED_BY(plans_mutex_);
 };
 
 using Interpreter = AbstractInterpreter<>;
@@ -239,6 +305,10 @@ AbstractInterpreter<EvalT>::InterpretModule(
     const rtl::AbstractModule<EvalT>* module,
     const AbstractNetRef2Value<EvalT>& inputs,
     absl::Span<const std::string> dump_cells) {
+  if (threads_.empty()) {
+    return InterpretLevelized(module, inputs, dump_cells);
+  }
+
   // Reserve space in the outputs map.
   AbstractNetRef2Value<EvalT> outputs;
   outputs.reserve(module->outputs().size());
@@ -364,7 +434,15 @@ AbstractInterpreter<EvalT>::InterpretModule(
     }
   }
 
-  // Handle assigns.
+  XLS_RETURN_IF_ERROR(ResolveAssignedOutputs(module, inputs, outputs));
+  return outputs;
+}
+
+template <typename EvalT>
+absl::Status AbstractInterpreter<EvalT>::ResolveAssignedOutputs(
+    const rtl::AbstractModule<EvalT>* module,
+    const AbstractNetRef2Value<EvalT>& inputs,
+    AbstractNetRef2Value<EvalT>& outputs) {
   const auto& assigns = module->assigns();
   for (const rtl::AbstractNetRef<EvalT> output : module->outputs()) {
     if (!outputs.contains(output)) {
@@ -389,7 +467,273 @@ AbstractInterpreter<EvalT>::InterpretModule(
       }
     }
   }
+  return absl::OkStatus();
+}
+
+template <typename EvalT>
+absl::StatusOr<const typename AbstractInterpreter<EvalT>::ModulePlan*>
+AbstractInterpreter<EvalT>::GetModulePlan(
+    const rtl::AbstractModule<EvalT>* module) {
+  absl::MutexLock lock(&plans_mutex_);
+  auto it = plans_.find(module);
+  if (it == plans_.end()) {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<ModulePlan> plan,
+                         BuildModulePlan(module));
+    it = plans_.emplace(module, std::move(plan)).first;
+  }
+  return it->second.get();
+}
+
+template <typename EvalT>
+absl::StatusOr<std::unique_ptr<typename AbstractInterpreter<EvalT>::ModulePlan>>
+AbstractInterpreter<EvalT>::BuildModulePlan(
+    const rtl::AbstractModule<EvalT>* module) {
+  auto plan = std::make_unique<ModulePlan>();
+  for (const auto& net : module->nets()) {
+    plan->slots.emplace(net.get(), plan->slots.size());
+  }
+  auto slot = [&](rtl::AbstractNetRef<EvalT> net) -> absl::StatusOr<int64_t> {
+    auto it = plan->slots.find(net);
+    XLS_RET_CHECK(it != plan->slots.end())
+        << "Net " << net->name() << " is not in module " << module->name();
+    return it->second;
+  };
+
+  // Levelize: a cell is ready once every one of its input pins is connected to
+  // a module input or to an output of a cell which is already in the order.
+  absl::flat_hash_map<rtl::AbstractNetRef<EvalT>,
+                      std::vector<const rtl::AbstractCell<EvalT>*>>
+      readers;
+  absl::flat_hash_map<const rtl::AbstractCell<EvalT>*, int64_t> missing_inputs;
+  std::deque<const rtl::AbstractCell<EvalT>*> ready;
+  for (const auto& cell : module->cells()) {
+    for (const auto& input : cell->inputs()) {
+      readers[input.netref].push_back(cell.get());
+    }
+    missing_inputs[cell.get()] = cell->inputs().size();
+    if (cell->inputs().empty()) {
+      ready.push_back(cell.get());
+    }
+  }
+  absl::flat_hash_set<rtl::AbstractNetRef<EvalT>> available;
+  auto make_available = [&](rtl::AbstractNetRef<EvalT> net) {
+    if (!available.insert(net).second) {
+      return;
+    }
+    auto it = readers.find(net);
+    if (it == readers.end()) {
+      return;
+    }
+    for (const rtl::AbstractCell<EvalT>* reader : it->second) {
+      if (--missing_inputs.at(reader) == 0) {
+        ready.push_back(reader);
+      }
+    }
+  };
+  for (const rtl::AbstractNetRef<EvalT> input : module->inputs()) {
+    if (readers.contains(input)) {
+      plan->used_inputs.push_back(input);
+    }
+    make_available(input);
+  }
+
+  // Parsed "function" attributes, shared between cells of the same type.
+  absl::flat_hash_map<std::string, function::Ast> asts;
+  absl::flat_hash_set<rtl::AbstractNetRef<EvalT>> driven;
+  while (!ready.empty()) {
+    const rtl::AbstractCell<EvalT>* cell = ready.front();
+    ready.pop_front();
+
+    XLS_RETURN_IF_ERROR(CheckStateTableSupported(*cell));
+    CellStep step{.cell = cell};
+    const AbstractCellLibraryEntry<EvalT>* entry = cell->cell_library_entry();
+    step.is_module = netlist_->MaybeGetModule(entry->name()).has_value();
+    for (const auto& input : cell->inputs()) {
+      XLS_ASSIGN_OR_RETURN(int64_t input_slot, slot(input.netref));
+      step.input_slots.push_back(input_slot);
+    }
+    for (const auto& output : cell->outputs()) {
+      XLS_ASSIGN_OR_RETURN(int64_t output_slot, slot(output.netref));
+      step.output_slots.push_back(output_slot);
+      if (step.is_module || output.eval != nullptr) {
+        step.functions.push_back(std::nullopt);
+        continue;
+      }
+      auto pin_function = entry->output_pin_to_function().find(output.name);
+      if (pin_function == entry->output_pin_to_function().end()) {
+        return absl::NotFoundError(absl::StrFormat(
+            "No function for output pin \"%s\" of cell %s.", output.name,
+            cell->name()));
+      }
+      auto ast_it = asts.find(pin_function->second);
+      if (ast_it == asts.end()) {
+        XLS_ASSIGN_OR_RETURN(
+            function::Ast ast,
+            function::Parser::ParseFunction(pin_function->second));
+        ast_it = asts.emplace(pin_function->second, std::move(ast)).first;
+      }
+      // As in InterpretFunction, identifiers name input pins (the last one, if
+      // repeated) or else internal pins.
+      auto resolve = [&](std::string_view name)
+          -> std::optional<function::CompiledFunction::Pin> {
+        std::optional<function::CompiledFunction::Pin> pin;
+        for (int64_t i = 0; i < cell->inputs().size(); ++i) {
+          if (cell->inputs()[i].name == name) {
+            pin = function::CompiledFunction::Pin{.index = i};
+          }
+        }
+        if (pin.has_value()) {
+          return pin;
+        }
+        for (int64_t i = 0; i < cell->internal_pins().size(); ++i) {
+          if (cell->internal_pins()[i].name == name) {
+            return function::CompiledFunction::Pin{.internal = true,
+                                                   .index = i};
+          }
+        }
+        return std::nullopt;
+      };
+      XLS_ASSIGN_OR_RETURN(
+          function::CompiledFunction compiled,
+          function::CompiledFunction::Compile(ast_it->second, resolve),
+          _ << " in cell " << cell->name() << "'s inputs or internal signals.");
+      step.functions.push_back(std::move(compiled));
+    }
+    plan->steps.push_back(std::move(step));
+    for (const auto& output : cell->outputs()) {
+      driven.insert(output.netref);
+      make_available(output.netref);
+    }
+  }
+
+  // Soundness check that we've ordered all cells (i.e., that there aren't
+  // unsatisfiable cells).
+  for (const auto& cell : module->cells()) {
+    if (missing_inputs.at(cell.get()) > 0) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Netlist contains unconnected subgraphs and cannot be translated. "
+          "Example: cell %s",
+          cell->name()));
+    }
+  }
+
+  for (const rtl::AbstractNetRef<EvalT> output : module->outputs()) {
+    if (driven.contains(output)) {
+      XLS_ASSIGN_OR_RETURN(int64_t output_slot, slot(output));
+      plan->driven_outputs.push_back({output, output_slot});
+    }
+  }
+  return plan;
+}
+
+template <typename EvalT>
+absl::StatusOr<AbstractNetRef2Value<EvalT>>
+AbstractInterpreter<EvalT>::InterpretLevelized(
+    const rtl::AbstractModule<EvalT>* module,
+    const AbstractNetRef2Value<EvalT>& inputs,
+    absl::Span<const std::string> dump_cells) {
+  XLS_ASSIGN_OR_RETURN(const ModulePlan* plan, GetModulePlan(module));
+
+  // EvalT need not be default-constructible, so slots are optional.
+  std::vector<std::optional<EvalT>> values(plan->slots.size());
+  for (const auto& [net, value] : inputs) {
+    auto it = plan->slots.find(net);
+    if (it != plan->slots.end()) {
+      values[it->second] = value;
+    }
+    if constexpr (std::is_convertible<EvalT, int>()) {
+      VLOG(2) << "Input : " << net->name() << " : " << static_cast<int>(value);
+    }
+  }
+  for (const rtl::AbstractNetRef<EvalT> input : plan->used_inputs) {
+    if (!values[plan->slots.at(input)].has_value()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("No value given for input %s of module %s",
+                          input->name(), module->name()));
+    }
+  }
+
+  absl::flat_hash_set<std::string> dump_cell_set(dump_cells.begin(),
+                                                 dump_cells.end());
+  std::vector<EvalT> results;
+  std::vector<EvalT> args;
+  std::vector<EvalT> stack;
+  for (const CellStep& step : plan->steps) {
+    const rtl::AbstractCell<EvalT>* cell = step.cell;
+    VLOG(2) << "Processing cell: " << cell->name();
+    auto input_value = [&](int64_t pin) -> const EvalT& {
+      return *values[step.input_slots[pin]];
+    };
+    auto cell_inputs = [&]() {
+      AbstractNetRef2Value<EvalT> cell_inputs;
+      for (int64_t i = 0; i < cell->inputs().size(); ++i) {
+        cell_inputs.insert({cell->inputs()[i].netref, input_value(i)});
+      }
+      return cell_inputs;
+    };
+
+    results.clear();
+    if (step.is_module) {
+      XLS_ASSIGN_OR_RETURN(AbstractNetRef2Value<EvalT> module_results,
+                           InterpretCell(cell, cell_inputs()));
+      for (const auto& output : cell->outputs()) {
+        auto it = module_results.find(output.netref);
+        XLS_RET_CHECK(it != module_results.end())
+            << "Output pin " << output.name << " of cell " << cell->name()
+            << " was not computed.";
+        results.push_back(it->second);
+      }
+    } else {
+      for (int64_t i = 0; i < cell->outputs().size(); ++i) {
+        if (!step.functions[i].has_value()) {
+          args.clear();
+          for (int64_t pin = 0; pin < step.input_slots.size(); ++pin) {
+            args.push_back(input_value(pin));
+          }
+          XLS_ASSIGN_OR_RETURN(EvalT value, cell->outputs()[i].eval(args));
+          results.push_back(std::move(value));
+          continue;
+        }
+        auto internal_value = [&](int64_t pin) -> absl::StatusOr<EvalT> {
+          return InterpretStateTable(*cell, cell->internal_pins()[pin].name,
+                                     cell_inputs());
+        };
+        XLS_ASSIGN_OR_RETURN(EvalT value,
+                             step.functions[i]->Evaluate(
+                                 zero_, one_, input_value, internal_value,
+                                 stack));
+        results.push_back(std::move(value));
+      }
+    }
+
+    if (dump_cell_set.contains(cell->name())) {
+      LOG(INFO) << "Cell " << cell->name() << " inputs:";
+      if constexpr (std::is_convertible<EvalT, int>()) {
+        for (int64_t i = 0; i < cell->inputs().size(); ++i) {
+          LOG(INFO) << "   " << cell->inputs()[i].netref->name() << " : "
+                    << static_cast<int>(input_value(i));
+        }
+        LOG(INFO) << "Cell " << cell->name() << " outputs:";
+        for (int64_t i = 0; i < cell->outputs().size(); ++i) {
+          LOG(INFO) << "   " << cell->outputs()[i].netref->name() << " : "
+                    << static_cast<int>(results[i]);
+        }
+      } else {
+        LOG(INFO) << "Cell " << cell->name() << " inputs are not printable.";
+      }
+    }
+
+    for (int64_t i = 0; i < results.size(); ++i) {
+      values[step.output_slots[i]] = std::move(results[i]);
+    }
+  }
 
+  AbstractNetRef2Value<EvalT> outputs;
+  outputs.reserve(module->outputs().size());
+  for (const auto& [output, output_slot] : plan->driven_outputs) {
+    outputs.insert({output, *values[output_slot]});
+  }
+  XLS_RETURN_IF_ERROR(ResolveAssignedOutputs(module, inputs, outputs));
   return outputs;
 }
 
@@ -585,10 +929,25 @@ absl::StatusOr<EvalT> AbstractInterpreter<EvalT>::InterpretFunction(
   }
 }
 
+template <typename EvalT>
+absl::Status AbstractInterpreter<EvalT>::CheckStateTableSupported(
+    const rtl::AbstractCell<EvalT>& cell) {
+  if constexpr (std::is_same_v<EvalT, BitSlicedValue>) {
+    if (cell.cell_library_entry()->state_table().has_value()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Cell %s (%s) is described by a state table, which is not supported "
+          "in bit-sliced simulation.",
+          cell.name(), cell.cell_library_entry()->name()));
+    }
+  }
+  return absl::OkStatus();
+}
+
 template <typename EvalT>
 absl::StatusOr<EvalT> AbstractInterpreter<EvalT>::InterpretStateTable(
     const rtl::AbstractCell<EvalT>& cell, const std::string& pin_name,
     const AbstractNetRef2Value<EvalT>& inputs) {
+  XLS_RETURN_IF_ERROR(CheckStateTableSupported(cell));
   XLS_RET_CHECK(cell.cell_library_entry()->state_table());
   const AbstractStateTable<EvalT>& state_table =
       cell.cell_library_entry()->state_table().value();
@@ -0,0 +1,150 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the throughput, in simulated input vectors per second, of the
+// scalar netlist interpreter against the 64-lane bit-sliced interpreter.
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "xls/common/benchmark_support.h"
+#include "xls/common/init_xls.h"
+#include "xls/netlist/bit_sliced_value.h"
+#include "xls/netlist/cell_library.h"
+#include "xls/netlist/fake_cell_library.h"
+#include "xls/netlist/interpreter.h"
+#include "xls/netlist/netlist.h"
+#include "xls/netlist/netlist.pb.h"
+#include "xls/netlist/netlist_parser.h"
+
+namespace xls {
+namespace netlist {
+namespace {
+
+// Returns the text of a `width`-bit ripple-carry adder module named "adder"
+// with inputs a0..aN, b0..bN and outputs s0..sN, cout.
+std::string MakeAdderNetlist(int64_t width) {
+  std::vector<std::string> ports;
+  std::vector<std::string> inputs;
+  std::vector<std::string> outputs;
+  std::vector<std::string> wires;
+  std::string cells;
+  for (int64_t i = 0; i < width; ++i) {
+    inputs.push_back(absl::StrCat("a", i));
+    inputs.push_back(absl::StrCat("b", i));
+    outputs.push_back(absl::StrCat("s", i));
+    wires.push_back(absl::StrCat("p", i));
+    wires.push_back(absl::StrCat("g", i));
+    wires.push_back(absl::StrCat("t", i));
+    // The carry into bit 0 is zero.
+    std::string carry_in = i == 0 ? "1'b0" : absl::StrCat("c", i);
+    std::string carry_out = i == width - 1 ? "cout" : absl::StrCat("c", i + 1);
+    if (i != width - 1) {
+      wires.push_back(carry_out);
+    }
+    absl::StrAppendFormat(&cells,
+                          "  XOR xor_p%d( .A(a%d), .B(b%d), .Z(p%d) );\n"
+                          "  AND and_g%d( .A(a%d), .B(b%d), .Z(g%d) );\n"
+                          "  XOR xor_s%d( .A(p%d), .B(%s), .Z(s%d) );\n"
+                          "  AND and_t%d( .A(p%d), .B(%s), .Z(t%d) );\n"
+                          "  OR or_c%d( .A(g%d), .B(t%d), .Z(%s) );\n",
+                          i, i, i, i, i, i, i, i, i, i, carry_in, i, i, i,
+                          carry_in, i, i, i, i, carry_out);
+  }
+  outputs.push_back("cout");
+  ports = inputs;
+  ports.insert(ports.end(), outputs.begin(), outputs.end());
+  return absl::StrFormat(
+      "module adder (%s);\n  input %s;\n  output %s;\n  wire %s;\n%s"
+      "endmodule\n",
+      absl::StrJoin(ports, ", "), absl::StrJoin(inputs, ", "),
+      absl::StrJoin(outputs, ", "), absl::StrJoin(wires, ", "), cells);
+}
+
+// Random input vectors, one uint64_t of lanes per module input.
+std::vector<uint64_t> MakeRandomLanes(int64_t input_count) {
+  std::mt19937_64 bit_gen;
+  std::vector<uint64_t> lanes(input_count);
+  for (uint64_t& lane : lanes) {
+    lane = bit_gen();
+  }
+  return lanes;
+}
+
+void BM_ScalarAdder(benchmark::State& state) {
+  CellLibrary cell_library = MakeFakeCellLibrary().value();
+  rtl::Scanner scanner(MakeAdderNetlist(state.range(0)));
+  std::unique_ptr<rtl::Netlist> netlist =
+      rtl::Parser::ParseNetlist(&cell_library, &scanner).value();
+  const rtl::Module* module = netlist->GetModule("adder").value();
+  std::vector<uint64_t> lanes = MakeRandomLanes(module->inputs().size());
+
+  Interpreter interpreter(netlist.get());
+  for (auto _ : state) {
+    for (int64_t lane = 0; lane < BitSlicedValue::kLaneCount; ++lane) {
+      NetRef2Value inputs;
+      for (int64_t i = 0; i < module->inputs().size(); ++i) {
+        inputs[module->inputs()[i]] = (lanes[i] >> lane) & 1;
+      }
+      benchmark::DoNotOptimize(
+          interpreter.InterpretModule(module, inputs).value());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * BitSlicedValue::kLaneCount);
+}
+
+void BM_BitSlicedAdder(benchmark::State& state) {
+  CellLibraryProto proto = MakeFakeCellLibraryProto().value();
+  AbstractCellLibrary<BitSlicedValue> cell_library =
+      AbstractCellLibrary<BitSlicedValue>::FromProto(proto).value();
+  rtl::Scanner scanner(MakeAdderNetlist(state.range(0)));
+  std::unique_ptr<rtl::AbstractNetlist<BitSlicedValue>> netlist =
+      rtl::AbstractParser<BitSlicedValue>::ParseNetlist(&cell_library,
+                                                        &scanner)
+          .value();
+  const rtl::AbstractModule<BitSlicedValue>* module =
+      netlist->GetModule("adder").value();
+  std::vector<uint64_t> lanes = MakeRandomLanes(module->inputs().size());
+
+  AbstractInterpreter<BitSlicedValue> interpreter(netlist.get());
+  for (auto _ : state) {
+    AbstractNetRef2Value<BitSlicedValue> inputs;
+    for (int64_t i = 0; i < module->inputs().size(); ++i) {
+      inputs[module->inputs()[i]] = BitSlicedValue::FromLanes(lanes[i]);
+    }
+    benchmark::DoNotOptimize(
+        interpreter.InterpretModule(module, inputs).value());
+  }
+  state.SetItemsProcessed(state.iterations() * BitSlicedValue::kLaneCount);
+}
+
+BENCHMARK(BM_ScalarAdder)->Arg(8)->Arg(32)->Arg(128);
+BENCHMARK(BM_BitSlicedAdder)->Arg(8)->Arg(32)->Arg(128);
+
+}  // namespace
+}  // namespace netlist
+}  // namespace xls
+
+int main(int argc, char* argv[]) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::RunSpecifiedBenchmarks(/*default_spec=*/"all");
+  return 0;
+}
@@ -15,6 +15,7 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -23,12 +24,17 @@
 #include <utility>
 #include <vector>
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/str_format.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "xls/common/status/matchers.h"
+#include "xls/netlist/bit_sliced_value.h"
 #include "xls/netlist/cell_library.h"
 #include "xls/netlist/fake_cell_library.h"
 #include "xls/netlist/function_extractor.h"
@@ -41,6 +47,9 @@ namespace xls {
 namespace netlist {
 namespace {
 
+using ::absl_testing::StatusIs;
+using ::testing::HasSubstr;
+
 // Smoke test to make sure anything works.
 TEST(InterpreterTest, BasicFunctionality) {
   // Make a very simple A * B module.
@@ -227,6 +236,202 @@ endmodule
   EXPECT_EQ(outputs[module->outputs()[0]], 1);
 }
 
+// Verifies that the levelized (single-threaded) evaluation order handles cells
+// listed out of dataflow order, and agrees with the threaded interpreter over
+// repeated evaluations.
+TEST(InterpreterTest, LevelizedMatchesThreaded) {
+  // Two half adders feeding a third, with the cells in reverse order.
+  std::string module_text = R"(
+module main (i0, i1, i2, i3, sum, carry);
+  input i0, i1, i2, i3;
+  output sum, carry;
+  wire s0, c0, s1, c1, c2;
+
+  OR or0( .A(c1), .B(c2), .Z(carry) );
+  AND and2( .A(s0), .B(s1), .Z(c2) );
+  XOR xor2( .A(s0), .B(s1), .Z(sum) );
+  AND and1( .A(i2), .B(i3), .Z(c1) );
+  XOR xor1( .A(i2), .B(i3), .Z(s1) );
+  AND and0( .A(i0), .B(i1), .Z(c0) );
+  XOR xor0( .A(i0), .B(i1), .Z(s0) );
+endmodule
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+
+  Interpreter levelized(netlist.get());
+  Interpreter threaded(netlist.get(), false, true, /*num_threads=*/2);
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    for (int row = 0; row < 16; ++row) {
+      NetRef2Value inputs;
+      for (int i = 0; i < 4; ++i) {
+        inputs[module->inputs()[i]] = (row >> i) & 1;
+      }
+      XLS_ASSERT_OK_AND_ASSIGN(NetRef2Value levelized_outputs,
+                               levelized.InterpretModule(module, inputs));
+      XLS_ASSERT_OK_AND_ASSIGN(NetRef2Value threaded_outputs,
+                               threaded.InterpretModule(module, inputs));
+      EXPECT_EQ(levelized_outputs, threaded_outputs) << "row " << row;
+
+      const bool i0 = row & 1, i1 = row & 2, i2 = row & 4, i3 = row & 8;
+      const bool s0 = i0 ^ i1, s1 = i2 ^ i3;
+      EXPECT_EQ(levelized_outputs.at(module->outputs()[0]), s0 ^ s1);
+      EXPECT_EQ(levelized_outputs.at(module->outputs()[1]),
+                (i2 && i3) || (s0 && s1));
+    }
+  }
+}
+
+TEST(InterpreterTest, BitSlicedMatchesScalar) {
+  std::string module_text = R"(
+module main (i0, i1, i2, i3, sum, carry);
+  input i0, i1, i2, i3;
+  output sum, carry;
+  wire s0, c0, s1, c1, c2, n0;
+
+  INV inv0( .A(c0), .ZN(n0) );
+  OR or0( .A(c1), .B(c2), .Z(carry) );
+  AND and2( .A(s0), .B(s1), .Z(c2) );
+  XOR xor2( .A(s0), .B(n0), .Z(sum) );
+  AND and1( .A(i2), .B(i3), .Z(c1) );
+  XOR xor1( .A(i2), .B(i3), .Z(s1) );
+  AND and0( .A(i0), .B(i1), .Z(c0) );
+  XOR xor0( .A(i0), .B(i1), .Z(s0) );
+endmodule
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryProto proto, MakeFakeCellLibraryProto());
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library,
+                           CellLibrary::FromProto(proto));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      AbstractCellLibrary<BitSlicedValue> sliced_cell_library,
+      AbstractCellLibrary<BitSlicedValue>::FromProto(proto));
+
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+  rtl::Scanner sliced_scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto sliced_netlist,
+      rtl::AbstractParser<BitSlicedValue>::ParseNetlist(&sliced_cell_library,
+                                                        &sliced_scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::AbstractModule<BitSlicedValue>* sliced,
+                           sliced_netlist->GetModule("main"));
+
+  // Lane i evaluates the input vector i % 16, bit-reversed on every other
+  // repetition so that each word holds a mix of patterns.
+  auto vector_for_lane = [](int lane) {
+    int row = lane % 16;
+    return (lane / 16) % 2 == 0 ? row : 15 - row;
+  };
+  AbstractNetRef2Value<BitSlicedValue> sliced_inputs;
+  for (int i = 0; i < 4; ++i) {
+    BitSlicedValue value;
+    for (int lane = 0; lane < BitSlicedValue::kLaneCount; ++lane) {
+      value.set_lane(lane, (vector_for_lane(lane) >> i) & 1);
+    }
+    sliced_inputs[sliced->inputs()[i]] = value;
+  }
+  AbstractInterpreter<BitSlicedValue> sliced_interpreter(sliced_netlist.get());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      AbstractNetRef2Value<BitSlicedValue> sliced_outputs,
+      sliced_interpreter.InterpretModule(sliced, sliced_inputs));
+
+  Interpreter interpreter(netlist.get());
+  for (int lane = 0; lane < BitSlicedValue::kLaneCount; ++lane) {
+    NetRef2Value inputs;
+    for (int i = 0; i < 4; ++i) {
+      inputs[module->inputs()[i]] = (vector_for_lane(lane) >> i) & 1;
+    }
+    XLS_ASSERT_OK_AND_ASSIGN(NetRef2Value outputs,
+                             interpreter.InterpretModule(module, inputs));
+    for (int o = 0; o < module->outputs().size(); ++o) {
+      EXPECT_EQ(sliced_outputs.at(sliced->outputs()[o]).lane(lane),
+                outputs.at(module->outputs()[o]))
+          << "lane " << lane << ", output " << o;
+    }
+  }
+}
+
+TEST(InterpreterTest, BitSlicedRejectsLutCells) {
+  std::string module_text = R"(
+module main (a0, a1, a2, a3, q0);
+  input a0, a1, a2, a3;
+  output q0;
+
+  SB_LUT4 #(
+    .LUT_INIT(16'h8000)
+  ) q0_SB_LUT4_O (
+    .I0(a0),
+    .I1(a1),
+    .I2(a2),
+    .I3(a3),
+    .O(q0)
+  );
+endmodule
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryProto proto, MakeFakeCellLibraryProto());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      AbstractCellLibrary<BitSlicedValue> cell_library,
+      AbstractCellLibrary<BitSlicedValue>::FromProto(proto));
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::AbstractParser<BitSlicedValue>::ParseNetlist(
+                               &cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::AbstractModule<BitSlicedValue>* module,
+                           netlist->GetModule("main"));
+
+  // The cell is rejected whether its input lanes agree or not, so the outcome
+  // does not depend on how input vectors are batched.
+  for (uint64_t lanes :
+       {uint64_t{0}, ~uint64_t{0}, uint64_t{0x5a5a5a5a5a5a5a5a},
+        uint64_t{0xff00ff00ff00ff00}}) {
+    AbstractNetRef2Value<BitSlicedValue> inputs;
+    for (int i = 0; i < 4; ++i) {
+      inputs[module->inputs()[i]] =
+          BitSlicedValue::FromLanes(i % 2 == 0 ? lanes : ~lanes);
+    }
+    AbstractInterpreter<BitSlicedValue> interpreter(netlist.get());
+    EXPECT_THAT(interpreter.InterpretModule(module, inputs),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("q0_SB_LUT4_O")))
+        << absl::StrFormat("lanes 0x%016x", lanes);
+  }
+}
+
+TEST(InterpreterTest, MissingInputIsAnError) {
+  std::string module_text = R"(
+module main (a, b, o);
+  input a, b;
+  output o;
+
+  AND and0( .A(a), .B(b), .Z(o) );
+endmodule
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  rtl::Scanner scanner(module_text);
+  XLS_ASSERT_OK_AND_ASSIGN(auto netlist,
+                           rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const rtl::Module* module,
+                           netlist->GetModule("main"));
+
+  Interpreter interpreter(netlist.get());
+  NetRef2Value inputs;
+  inputs[module->inputs()[0]] = true;
+  EXPECT_THAT(interpreter.InterpretModule(module, inputs),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("No value given for input b")));
+}
+
 // Verifies that a [combinational] StateTable can be correctly interpreted in a
 // design.
 TEST(InterpreterTest, StateTables) {
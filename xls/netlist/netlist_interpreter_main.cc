@@ -13,16 +13,20 @@
 // limitations under the License.
 
 // Driver for NetlistInterpreter: loads a netlist from disk, feeds Value input
-// (taken from the command line) into it, and prints the result.
+// (taken from the command line or, one vector per line, from a file) into it,
+// and prints the result.
 
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_split.h"
 #include "absl/types/span.h"
 #include "xls/codegen/flattening.h"
@@ -38,6 +42,7 @@
 #include "xls/ir/package.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
+#include "xls/netlist/bit_sliced_value.h"
 #include "xls/netlist/cell_library.h"
 #include "xls/netlist/function_extractor.h"
 #include "xls/netlist/interpreter.h"
@@ -60,6 +65,11 @@ ABSL_FLAG(std::string, input, "",
           "The input to the function as a semicolon-separated list of typed "
           "values. For example: \"bits[32]:42; (bits[7]:0, bits[20]:4)\". "
           "Values must be listed in the same order as the module inputs.");
+ABSL_FLAG(std::string, input_file, "",
+          "File containing one input per line, each in the format of --input. "
+          "Inputs are simulated 64 at a time using bit-sliced evaluation and "
+          "one output is printed per line. Cells described by state tables, "
+          "including SB_LUT4 cells, are rejected in this mode.");
 ABSL_FLAG(std::string, output_type, "",
           "Type of the value as an XLS-formatted string. If un-set, then the "
           "output will be printed as flat uninterpreted bits.");
@@ -68,7 +78,7 @@ ABSL_FLAG(std::string, netlist, "", "Path to the netlist to interpret.");
 
 namespace xls {
 
-static absl::StatusOr<netlist::CellLibrary> GetCellLibrary(
+static absl::StatusOr<netlist::CellLibraryProto> GetCellLibraryProto(
     const std::string& cell_library_path,
     const std::string& cell_library_proto_path) {
   if (!cell_library_proto_path.empty()) {
@@ -76,35 +86,19 @@ static absl::StatusOr<netlist::CellLibrary> GetCellLibrary(
                          GetFileContents(cell_library_proto_path));
     netlist::CellLibraryProto lib_proto;
     XLS_RET_CHECK(lib_proto.ParseFromString(proto_text));
-    return netlist::CellLibrary::FromProto(lib_proto);
+    return lib_proto;
   }
   XLS_ASSIGN_OR_RETURN(std::string cell_library_text,
                        GetFileContents(cell_library_path));
   XLS_ASSIGN_OR_RETURN(
       auto char_stream,
       netlist::cell_lib::CharStream::FromText(cell_library_text));
-  XLS_ASSIGN_OR_RETURN(netlist::CellLibraryProto lib_proto,
-                       netlist::function::ExtractFunctions(&char_stream));
-  return netlist::CellLibrary::FromProto(lib_proto);
+  return netlist::function::ExtractFunctions(&char_stream);
 }
 
-static absl::Status RealMain(const std::string& netlist_path,
-                             const std::string& cell_library_path,
-                             const std::string& cell_library_proto_path,
-                             const std::string& module_name,
-                             absl::Span<const std::string> inputs,
-                             const std::string& output_type_string,
-                             absl::Span<const std::string> dump_cells) {
-  XLS_ASSIGN_OR_RETURN(
-      netlist::CellLibrary cell_library,
-      GetCellLibrary(cell_library_path, cell_library_proto_path));
-
-  XLS_ASSIGN_OR_RETURN(std::string netlist_text, GetFileContents(netlist_path));
-  netlist::rtl::Scanner scanner(netlist_text);
-  XLS_ASSIGN_OR_RETURN(auto netlist, netlist::rtl::Parser::ParseNetlist(
-                                         &cell_library, &scanner));
-  XLS_ASSIGN_OR_RETURN(const auto* module, netlist->GetModule(module_name));
-
+// Parses a semicolon-separated list of typed values into the flat input bits
+// of the module, indexed by input port offset.
+static absl::StatusOr<Bits> ParseInputBits(std::string_view input) {
   // Input values are listed in the same order as inputs are declared by
   // the netlist module declaration, which may be different from the order of
   // Module::inputs().  For example:
@@ -117,47 +111,149 @@ static absl::Status RealMain(const std::string& netlist_path,
   //
   // The values of --inputs should follow the module declaration, which would
   // also follow the declaration of the source language (e.g. C++ or XLS).
-
   Bits input_bits;
-  for (const auto& input_string : inputs) {
-    XLS_ASSIGN_OR_RETURN(Value input, Parser::ParseTypedValue(input_string));
-    Bits flat_value = FlattenValueToBits(input);
+  for (std::string_view input_string : absl::StrSplit(input, ';')) {
+    XLS_ASSIGN_OR_RETURN(Value value, Parser::ParseTypedValue(input_string));
+    Bits flat_value = FlattenValueToBits(value);
     input_bits = bits_ops::Concat({input_bits, flat_value});
   }
-  input_bits = bits_ops::Reverse(input_bits);
+  return bits_ops::Reverse(input_bits);
+}
+
+static absl::StatusOr<std::string> FormatOutput(
+    const Bits& output_bits, const std::string& output_type_string) {
+  if (output_type_string.empty()) {
+    return Value(output_bits).ToString(FormatPreference::kHex);
+  }
+  // This is a disposable package - it only exists to hold the type below.
+  Package package("foo");
+  XLS_ASSIGN_OR_RETURN(Type * output_type,
+                       Parser::ParseType(output_type_string, &package));
+  XLS_ASSIGN_OR_RETURN(Value output,
+                       UnflattenBitsToValue(output_bits, output_type));
+  return output.ToString(FormatPreference::kHex);
+}
 
-  netlist::NetRef2Value input_nets;
+// Interprets the module once per input.
+static absl::StatusOr<std::vector<Bits>> InterpretScalar(
+    const netlist::CellLibraryProto& lib_proto, std::string_view netlist_text,
+    const std::string& module_name, absl::Span<const Bits> inputs,
+    absl::Span<const std::string> dump_cells) {
+  XLS_ASSIGN_OR_RETURN(netlist::CellLibrary cell_library,
+                       netlist::CellLibrary::FromProto(lib_proto));
+  netlist::rtl::Scanner scanner(netlist_text);
+  XLS_ASSIGN_OR_RETURN(auto netlist, netlist::rtl::Parser::ParseNetlist(
+                                         &cell_library, &scanner));
+  XLS_ASSIGN_OR_RETURN(const auto* module, netlist->GetModule(module_name));
   const std::vector<netlist::rtl::NetRef>& module_inputs = module->inputs();
-  XLS_RET_CHECK(module_inputs.size() == input_bits.bit_count());
 
-  for (int i = 0; i < module->inputs().size(); i++) {
-    const netlist::rtl::NetRef in = module_inputs[i];
-    input_nets[in] = input_bits.Get(module->GetInputPortOffset(in->name()));
+  netlist::Interpreter interpreter(netlist.get());
+  std::vector<Bits> outputs;
+  outputs.reserve(inputs.size());
+  for (const Bits& input_bits : inputs) {
+    XLS_RET_CHECK(module_inputs.size() == input_bits.bit_count());
+    netlist::NetRef2Value input_nets;
+    for (const netlist::rtl::NetRef in : module_inputs) {
+      input_nets[in] = input_bits.Get(module->GetInputPortOffset(in->name()));
+    }
+    XLS_ASSIGN_OR_RETURN(
+        auto output_nets,
+        interpreter.InterpretModule(module, input_nets, dump_cells));
+
+    BitsRope rope(output_nets.size());
+    for (const netlist::rtl::NetRef ref : module->outputs()) {
+      rope.push_back(output_nets[ref]);
+    }
+    outputs.push_back(rope.Build());
   }
+  return outputs;
+}
 
-  netlist::Interpreter interpreter(netlist.get());
-  XLS_ASSIGN_OR_RETURN(auto output_nets, interpreter.InterpretModule(
-                                             module, input_nets, dump_cells));
+// Interprets the module on batches of kLaneCount inputs at a time, each input
+// occupying one lane of every net.
+static absl::StatusOr<std::vector<Bits>> InterpretBitSliced(
+    const netlist::CellLibraryProto& lib_proto, std::string_view netlist_text,
+    const std::string& module_name, absl::Span<const Bits> inputs) {
+  using netlist::BitSlicedValue;
+  XLS_ASSIGN_OR_RETURN(
+      netlist::AbstractCellLibrary<BitSlicedValue> cell_library,
+      netlist::AbstractCellLibrary<BitSlicedValue>::FromProto(lib_proto));
+  netlist::rtl::Scanner scanner(netlist_text);
+  XLS_ASSIGN_OR_RETURN(
+      auto netlist,
+      netlist::rtl::AbstractParser<BitSlicedValue>::ParseNetlist(&cell_library,
+                                                                 &scanner));
+  XLS_ASSIGN_OR_RETURN(const auto* module, netlist->GetModule(module_name));
+  const std::vector<netlist::rtl::AbstractNetRef<BitSlicedValue>>&
+      module_inputs = module->inputs();
 
-  BitsRope rope(output_nets.size());
-  for (const netlist::rtl::NetRef ref : module->outputs()) {
-    rope.push_back(output_nets[ref]);
+  netlist::AbstractInterpreter<BitSlicedValue> interpreter(netlist.get());
+  std::vector<Bits> outputs;
+  outputs.reserve(inputs.size());
+  for (int64_t base = 0; base < inputs.size();
+       base += BitSlicedValue::kLaneCount) {
+    absl::Span<const Bits> batch =
+        inputs.subspan(base, BitSlicedValue::kLaneCount);
+    netlist::AbstractNetRef2Value<BitSlicedValue> input_nets;
+    for (const auto in : module_inputs) {
+      const int64_t offset = module->GetInputPortOffset(in->name());
+      BitSlicedValue value;
+      for (int64_t lane = 0; lane < batch.size(); ++lane) {
+        XLS_RET_CHECK(module_inputs.size() == batch[lane].bit_count());
+        value.set_lane(lane, batch[lane].Get(offset));
+      }
+      input_nets[in] = value;
+    }
+    XLS_ASSIGN_OR_RETURN(auto output_nets,
+                         interpreter.InterpretModule(module, input_nets));
+
+    for (int64_t lane = 0; lane < batch.size(); ++lane) {
+      BitsRope rope(output_nets.size());
+      for (const auto ref : module->outputs()) {
+        rope.push_back(output_nets.at(ref).lane(lane));
+      }
+      outputs.push_back(rope.Build());
+    }
   }
-  Bits output_bits = rope.Build();
-
-  Value output;
-  if (!output_type_string.empty()) {
-    // This is a disposable package - it only exists to hold the type below.
-    Package package("foo");
-    XLS_ASSIGN_OR_RETURN(Type * output_type,
-                         Parser::ParseType(output_type_string, &package));
-    XLS_ASSIGN_OR_RETURN(output,
-                         UnflattenBitsToValue(output_bits, output_type));
+  return outputs;
+}
+
+static absl::Status RealMain(const std::string& netlist_path,
+                             const std::string& cell_library_path,
+                             const std::string& cell_library_proto_path,
+                             const std::string& module_name,
+                             absl::Span<const std::string> inputs,
+                             bool bit_sliced,
+                             const std::string& output_type_string,
+                             absl::Span<const std::string> dump_cells) {
+  XLS_ASSIGN_OR_RETURN(
+      netlist::CellLibraryProto lib_proto,
+      GetCellLibraryProto(cell_library_path, cell_library_proto_path));
+  XLS_ASSIGN_OR_RETURN(std::string netlist_text, GetFileContents(netlist_path));
+
+  std::vector<Bits> input_bits;
+  input_bits.reserve(inputs.size());
+  for (const std::string& input : inputs) {
+    XLS_ASSIGN_OR_RETURN(Bits bits, ParseInputBits(input));
+    input_bits.push_back(std::move(bits));
+  }
+
+  std::vector<Bits> output_bits;
+  if (bit_sliced) {
+    XLS_ASSIGN_OR_RETURN(output_bits,
+                         InterpretBitSliced(lib_proto, netlist_text,
+                                            module_name, input_bits));
   } else {
-    output = Value(output_bits);
+    XLS_ASSIGN_OR_RETURN(output_bits,
+                         InterpretScalar(lib_proto, netlist_text, module_name,
+                                         input_bits, dump_cells));
   }
 
-  std::cout << output.ToString(FormatPreference::kHex) << '\n';
+  for (const Bits& output : output_bits) {
+    XLS_ASSIGN_OR_RETURN(std::string output_string,
+                         FormatOutput(output, output_type_string));
+    std::cout << output_string << '\n';
+  }
   return absl::OkStatus();
 }
 
@@ -179,15 +275,28 @@ int main(int argc, char* argv[]) {
   QCHECK(!module_name.empty()) << "--module_name must be specified.";
 
   std::string input = absl::GetFlag(FLAGS_input);
-  QCHECK(!input.empty()) << "--input must be specified.";
-  std::vector<std::string> inputs = absl::StrSplit(input, ';');
+  std::string input_file = absl::GetFlag(FLAGS_input_file);
+  QCHECK(!input.empty() ^ !input_file.empty())
+      << "One (and only one) of --input or --input_file must be specified.";
+  std::vector<std::string> inputs;
+  if (!input.empty()) {
+    inputs.push_back(input);
+  } else {
+    absl::StatusOr<std::string> input_text = xls::GetFileContents(input_file);
+    QCHECK_OK(input_text.status());
+    for (std::string_view line :
+         absl::StrSplit(*input_text, '\n', absl::SkipWhitespace())) {
+      inputs.push_back(std::string(absl::StripAsciiWhitespace(line)));
+    }
+  }
 
   std::string dump_cells_str = absl::GetFlag(FLAGS_dump_cells);
   std::vector<std::string> dump_cells = absl::StrSplit(dump_cells_str, ',');
 
   std::string output_type = absl::GetFlag(FLAGS_output_type);
 
-  return xls::ExitStatus(xls::RealMain(netlist_path, cell_library_path,
-                                       cell_library_proto_path, module_name,
-                                       inputs, output_type, dump_cells));
+  return xls::ExitStatus(
+      xls::RealMain(netlist_path, cell_library_path, cell_library_proto_path,
+                    module_name, inputs, /*bit_sliced=*/!input_file.empty(),
+                    output_type, dump_cells));
 }
@@ -180,6 +180,8 @@ absl::StatusOr<ExperimentData> ExperimentRunner::RunExperiment(
   NocSimulator simulator;
   XLS_RET_CHECK_OK(simulator.Initialize(graph, params, routing_table,
                                         graph.GetNetworkIds()[0]));
+  XLS_RET_CHECK_OK(
+      simulator.SetMode(simulator_mode_, simulator_thread_count_));
   simulator.Dump();
 
   // Hook traffic injector and simulator together.
@@ -35,6 +35,7 @@
 #include "xls/noc/config/network_config.pb.h"
 #include "xls/noc/simulation/flit.h"
 #include "xls/noc/simulation/global_routing_table.h"
+#include "xls/noc/simulation/sim_objects.h"
 #include "xls/noc/simulation/traffic_description.h"
 
 // This file contains classes used to construct different
@@ -146,6 +147,8 @@ class ExperimentMetrics {
   // Prints out the metrics and values stored.
   absl::Status DebugDump() const;
 
+  bool operator==(const ExperimentMetrics& other) const = default;
+
  private:
   absl::btree_map<std::string, double> float_metrics_;
   absl::btree_map<std::string, absl::flat_hash_map<int64_t, int64_t>>
@@ -249,6 +252,16 @@ class ExperimentRunner {
     return *this;
   }
 
+  // Selects how the simulator converges each cycle, all modes produce the
+  // same results. thread_count is only used by NocSimulatorMode::kParallel.
+  ExperimentRunner& SetSimulatorMode(NocSimulatorMode mode,
+                                     int64_t thread_count = 1) {
+    CHECK_GT(thread_count, 0);
+    simulator_mode_ = mode;
+    simulator_thread_count_ = thread_count;
+    return *this;
+  }
+
   int64_t GetSimulationCycleCount() const {
     return total_simulation_cycle_count_;
   }
@@ -256,6 +269,8 @@ class ExperimentRunner {
 
   int16_t GetSeed() const { return seed_; }
   std::string_view GetTrafficMode() const { return mode_name_; }
+  NocSimulatorMode GetSimulatorMode() const { return simulator_mode_; }
+  int64_t GetSimulatorThreadCount() const { return simulator_thread_count_; }
 
  private:
   int64_t total_simulation_cycle_count_;
@@ -263,6 +278,9 @@ class ExperimentRunner {
   int16_t seed_;
 
   std::string mode_name_;
+
+  NocSimulatorMode simulator_mode_ = NocSimulatorMode::kSweep;
+  int64_t simulator_thread_count_ = 1;
 };
 
 class ExperimentBuilderBase;
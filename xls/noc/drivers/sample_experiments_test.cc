@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -28,6 +29,7 @@
 #include "xls/noc/drivers/experiment_factory.h"
 #include "xls/noc/simulation/common.h"
 #include "xls/noc/simulation/flit.h"
+#include "xls/noc/simulation/sim_objects.h"
 
 namespace xls::noc {
 namespace {
@@ -220,5 +222,40 @@ TEST(SampleExperimentsTest, AggregateTreeTest) {
   }
 }
 
+TEST(SampleExperimentsTest, SimulatorModesMatchSweep) {
+  ExperimentFactory experiment_factory;
+  XLS_ASSERT_OK(RegisterSampleExperiments(experiment_factory));
+
+  for (const std::string& tag : experiment_factory.ListExperimentTags()) {
+    XLS_ASSERT_OK_AND_ASSIGN(Experiment experiment,
+                             experiment_factory.BuildExperiment(tag));
+    ExperimentRunner runner = experiment.GetRunner();
+    runner.SetSimulationCycleCount(10'000);
+
+    for (int64_t i = 0; i < experiment.GetSweeps().GetStepCount(); ++i) {
+      LOG(INFO) << absl::StreamFormat("Experiment %s Step %d", tag, i);
+      XLS_ASSERT_OK_AND_ASSIGN(ExperimentConfig config,
+                               experiment.GetConfigForStep(i));
+      runner.SetSimulatorMode(NocSimulatorMode::kSweep);
+      XLS_ASSERT_OK_AND_ASSIGN(ExperimentData expected,
+                               runner.RunExperiment(config));
+
+      for (auto [mode, thread_count] :
+           {std::pair{NocSimulatorMode::kEventDriven, int64_t{1}},
+            std::pair{NocSimulatorMode::kParallel, int64_t{1}},
+            std::pair{NocSimulatorMode::kParallel, int64_t{4}}}) {
+        runner.SetSimulatorMode(mode, thread_count);
+        XLS_ASSERT_OK_AND_ASSIGN(ExperimentData actual,
+                                 runner.RunExperiment(config));
+        EXPECT_TRUE(actual.metrics == expected.metrics)
+            << absl::StreamFormat("mode %d with %d threads",
+                                  static_cast<int>(mode), thread_count);
+        EXPECT_EQ(actual.info.GetLinkToPacketCountMap(),
+                  expected.info.GetLinkToPacketCountMap());
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace xls::noc
@@ -14,20 +14,29 @@
 
 #include "xls/noc/simulation/sim_objects.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <deque>
+#include <memory>
+#include <numeric>
+#include <optional>
 #include <queue>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/ir/bits.h"
 #include "xls/noc/simulation/common.h"
 #include "xls/noc/simulation/flit.h"
@@ -132,6 +141,273 @@ bool SimplePipelineImpl<DataTimePhitT>::TryPropagation(
 
 }  // namespace
 
+// Ticks the components of a NocSimulator from several threads.
+//
+// Components are split into contiguous regions of the network, each owned by
+// one worker which is the only one to tick them.  Connections shared between
+// components are guarded by a mutex per connection; a tick acquires the
+// mutexes of all connections of the component in index order so that ticks of
+// adjacent components never deadlock.
+class NocParallelScheduler {
+ public:
+  NocParallelScheduler(NocSimulator& simulator, int64_t thread_count);
+  ~NocParallelScheduler();
+
+  // Ticks components until no more progress can be made in the current
+  // cycle. Returns true if all components have converged.
+  bool Run();
+
+ private:
+  struct Partition {
+    absl::Mutex mutex;
+    std::deque<int64_t> worklist ABSL_GUARDED_BY(mutex);
+    // Set once no component is pending, so the worker stops waiting for work.
+    bool done ABSL_GUARDED_BY(mutex) = false;
+  };
+
+  // Queues the given component on the worklist of its owner.
+  void Push(int64_t component);
+
+  // Blocks until a component owned by the given worker needs ticking and
+  // returns it, or returns std::nullopt once no component is pending.
+  std::optional<int64_t> Pop(int64_t worker_index);
+
+  // Marks `count` pending components as no longer pending, waking all workers
+  // if none remain.
+  void Settle(int64_t count);
+
+  // Ticks the given component, queueing its neighbors if any of its
+  // connections changed.
+  void TickComponent(int64_t component);
+
+  void RunWorker(int64_t worker_index);
+  void WorkerThreadLoop(int64_t worker_index);
+
+  NocSimulator& simulator_;
+
+  // Index of the worker owning each component.
+  std::vector<int64_t> owner_;
+  // Components owned by each worker.
+  std::vector<std::vector<int64_t>> owned_;
+  std::vector<std::unique_ptr<Partition>> partitions_;
+  std::unique_ptr<absl::Mutex[]> connection_mutexes_;
+
+  // Per-component flags, stored as chars so that flags of components owned by
+  // different workers never share storage. converged_ is only accessed by the
+  // owning worker, queued_ is guarded by the owner's partition mutex.
+  std::vector<char> converged_;
+  std::vector<char> queued_;
+
+  // Number of components that are queued or being ticked.
+  std::atomic<int64_t> pending_ = 0;
+
+  absl::Mutex pool_mutex_;
+  int64_t generation_ ABSL_GUARDED_BY(pool_mutex_) = 0;
+  int64_t running_workers_ ABSL_GUARDED_BY(pool_mutex_) = 0;
+  bool shutdown_ ABSL_GUARDED_BY(pool_mutex_) = false;
+  std::vector<std::unique_ptr<Thread>> threads_;
+};
+
+NocParallelScheduler::NocParallelScheduler(NocSimulator& simulator,
+                                           int64_t thread_count)
+    : simulator_(simulator),
+      connection_mutexes_(
+          new absl::Mutex[simulator.connection_components_.size()]) {
+  const int64_t component_count = simulator_.components_.size();
+  const int64_t worker_count =
+      std::max<int64_t>(1, std::min(thread_count, component_count));
+
+  // Order components breadth-first through the network so that each worker
+  // owns a connected region and most connections are local to one worker.
+  std::vector<int64_t> order;
+  order.reserve(component_count);
+  std::vector<bool> visited(component_count, false);
+  for (int64_t root = 0; root < component_count; ++root) {
+    if (visited[root]) {
+      continue;
+    }
+    visited[root] = true;
+    order.push_back(root);
+    for (int64_t next = order.size() - 1; next < order.size(); ++next) {
+      for (int64_t connection :
+           simulator_.component_connections_[order[next]]) {
+        for (int64_t neighbor : simulator_.connection_components_[connection]) {
+          if (!visited[neighbor]) {
+            visited[neighbor] = true;
+            order.push_back(neighbor);
+          }
+        }
+      }
+    }
+  }
+
+  owner_.resize(component_count);
+  owned_.resize(worker_count);
+  for (int64_t i = 0; i < component_count; ++i) {
+    int64_t worker_index = i * worker_count / component_count;
+    owner_[order[i]] = worker_index;
+    owned_[worker_index].push_back(order[i]);
+  }
+  for (int64_t i = 0; i < worker_count; ++i) {
+    partitions_.push_back(std::make_unique<Partition>());
+  }
+  converged_.resize(component_count, 0);
+  queued_.resize(component_count, 0);
+
+  for (int64_t i = 1; i < worker_count; ++i) {
+    threads_.push_back(
+        std::make_unique<Thread>([this, i]() { WorkerThreadLoop(i); }));
+  }
+}
+
+NocParallelScheduler::~NocParallelScheduler() {
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    shutdown_ = true;
+  }
+  for (std::unique_ptr<Thread>& thread : threads_) {
+    thread->Join();
+  }
+}
+
+void NocParallelScheduler::Push(int64_t component) {
+  Partition& partition = *partitions_[owner_[component]];
+  absl::MutexLock lock(&partition.mutex);
+  if (queued_[component]) {
+    return;
+  }
+  queued_[component] = 1;
+  pending_.fetch_add(1, std::memory_order_acq_rel);
+  partition.worklist.push_back(component);
+}
+
+std::optional<int64_t> NocParallelScheduler::Pop(int64_t worker_index) {
+  Partition& partition = *partitions_[worker_index];
+  auto runnable = [&]() ABSL_SHARED_LOCKS_REQUIRED(partition.mutex) {
+    return !partition.worklist.empty() || partition.done;
+  };
+  while (true) {
+    std::optional<int64_t> result;
+    int64_t skipped = 0;
+    {
+      absl::MutexLock lock(&partition.mutex);
+      partition.mutex.Await(absl::Condition(&runnable));
+      while (!partition.worklist.empty()) {
+        int64_t component = partition.worklist.front();
+        partition.worklist.pop_front();
+        queued_[component] = 0;
+        if (!converged_[component]) {
+          result = component;
+          break;
+        }
+        ++skipped;
+      }
+      if (!result.has_value() && skipped == 0) {
+        return std::nullopt;
+      }
+    }
+    // Settle outside the partition mutex, since it locks every partition.
+    if (skipped > 0) {
+      Settle(skipped);
+    }
+    if (result.has_value()) {
+      return result;
+    }
+  }
+}
+
+void NocParallelScheduler::Settle(int64_t count) {
+  if (pending_.fetch_sub(count, std::memory_order_acq_rel) != count) {
+    return;
+  }
+  for (std::unique_ptr<Partition>& partition : partitions_) {
+    absl::MutexLock lock(&partition->mutex);
+    partition->done = true;
+  }
+}
+
+void NocParallelScheduler::TickComponent(int64_t component) {
+  absl::Span<const int64_t> connections =
+      simulator_.component_connections_[component];
+
+  for (int64_t connection : connections) {
+    connection_mutexes_[connection].Lock();
+  }
+  int64_t propagated = simulator_.CountPropagatedChannels(connections);
+  bool converged = simulator_.components_[component]->Tick(simulator_);
+  bool changed = simulator_.CountPropagatedChannels(connections) != propagated;
+  for (auto it = connections.rbegin(); it != connections.rend(); ++it) {
+    connection_mutexes_[*it].Unlock();
+  }
+
+  if (converged) {
+    converged_[component] = 1;
+  }
+  if (changed) {
+    for (int64_t connection : connections) {
+      for (int64_t neighbor : simulator_.connection_components_[connection]) {
+        Push(neighbor);
+      }
+    }
+  }
+}
+
+void NocParallelScheduler::RunWorker(int64_t worker_index) {
+  while (std::optional<int64_t> component = Pop(worker_index)) {
+    TickComponent(*component);
+    Settle(1);
+  }
+}
+
+void NocParallelScheduler::WorkerThreadLoop(int64_t worker_index) {
+  int64_t seen_generation = 0;
+  while (true) {
+    {
+      absl::MutexLock lock(&pool_mutex_);
+      auto ready = [&]() ABSL_SHARED_LOCKS_REQUIRED(pool_mutex_) {
+        return shutdown_ || generation_ != seen_generation;
+      };
+      pool_mutex_.Await(absl::Condition(&ready));
+      if (shutdown_) {
+        return;
+      }
+      seen_generation = generation_;
+    }
+    RunWorker(worker_index);
+    absl::MutexLock lock(&pool_mutex_);
+    --running_workers_;
+  }
+}
+
+bool NocParallelScheduler::Run() {
+  // Every component is ticked at least once per cycle.
+  std::fill(converged_.begin(), converged_.end(), 0);
+  std::fill(queued_.begin(), queued_.end(), 1);
+  pending_.store(converged_.size(), std::memory_order_release);
+  for (int64_t i = 0; i < partitions_.size(); ++i) {
+    absl::MutexLock lock(&partitions_[i]->mutex);
+    partitions_[i]->worklist.assign(owned_[i].begin(), owned_[i].end());
+    partitions_[i]->done = converged_.empty();
+  }
+
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    running_workers_ = threads_.size();
+    ++generation_;
+  }
+  RunWorker(0);
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    auto done = [&]() ABSL_SHARED_LOCKS_REQUIRED(pool_mutex_) {
+      return running_workers_ == 0;
+    };
+    pool_mutex_.Await(absl::Condition(&done));
+  }
+
+  return std::all_of(converged_.begin(), converged_.end(),
+                     [](char converged) { return converged != 0; });
+}
+
 absl::Status NocSimulator::CreateSimulationObjects(NetworkId network) {
   Network& network_obj = mgr_->GetNetwork(network);
 
@@ -258,17 +534,86 @@ void NocSimulator::Dump() {
   }
 }
 
-absl::Status NocSimulator::RunCycle(int64_t max_ticks) {
-  ++cycle_;
-  VLOG(2) << "";
-  VLOG(2) << absl::StreamFormat("*** Simul Cycle %d", cycle_);
+NocSimulator::~NocSimulator() = default;
 
-  for (NocSimulatorServiceShim* svc : pre_cycle_services_) {
-    XLS_RET_CHECK_OK(svc->RunCycle());
+absl::Status NocSimulator::BuildComponentConnectivity() {
+  mode_ = NocSimulatorMode::kSweep;
+  parallel_scheduler_.reset();
+
+  components_.clear();
+  for (SimNetworkInterfaceSrc& nc : network_interface_sources_) {
+    components_.push_back(&nc);
+  }
+  for (SimLink& nc : links_) {
+    components_.push_back(&nc);
+  }
+  for (SimInputBufferedVCRouter& nc : routers_) {
+    components_.push_back(&nc);
+  }
+  for (SimNetworkInterfaceSink& nc : network_interface_sinks_) {
+    components_.push_back(&nc);
+  }
+
+  component_connections_.assign(components_.size(), {});
+  connection_components_.assign(connections_.size(), {});
+  for (int64_t i = 0; i < components_.size(); ++i) {
+    std::vector<int64_t>& connections = component_connections_[i];
+    for (const Port& port :
+         mgr_->GetNetworkComponent(components_[i]->GetId()).GetPorts()) {
+      if (!port.connection().IsValid()) {
+        continue;
+      }
+      auto iter = connection_index_map_.find(port.connection());
+      XLS_RET_CHECK(iter != connection_index_map_.end());
+      connections.push_back(iter->second);
+    }
+    std::sort(connections.begin(), connections.end());
+    connections.erase(std::unique(connections.begin(), connections.end()),
+                      connections.end());
+    for (int64_t connection : connections) {
+      connection_components_[connection].push_back(i);
+    }
+  }
+
+  return absl::OkStatus();
+}
+
+absl::Status NocSimulator::SetMode(NocSimulatorMode mode,
+                                   int64_t thread_count) {
+  XLS_RET_CHECK(mgr_ != nullptr) << "SetMode called before Initialize";
+  if (mode == NocSimulatorMode::kParallel && thread_count < 1) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Parallel simulation requires at least one thread, got %d",
+        thread_count));
   }
+  parallel_scheduler_.reset();
+  if (mode == NocSimulatorMode::kParallel) {
+    parallel_scheduler_ =
+        std::make_unique<NocParallelScheduler>(*this, thread_count);
+  }
+  mode_ = mode;
+  return absl::OkStatus();
+}
 
+int64_t NocSimulator::CountPropagatedChannels(
+    absl::Span<const int64_t> connections) {
+  int64_t count = 0;
+  for (int64_t index : connections) {
+    const SimConnectionState& connection = connections_[index];
+    if (connection.forward_channels.cycle == cycle_) {
+      ++count;
+    }
+    for (const TimedMetadataFlit& flit : connection.reverse_channels) {
+      if (flit.cycle == cycle_) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+absl::Status NocSimulator::RunSweep(int64_t nticks, int64_t max_ticks) {
   bool converged = false;
-  int64_t nticks = 0;
   while (!converged) {
     VLOG(2) << absl::StreamFormat("Tick %d", nticks);
     converged = Tick();
@@ -279,6 +624,75 @@ absl::Status NocSimulator::RunCycle(int64_t max_ticks) {
           cycle_));
     }
   }
+  return absl::OkStatus();
+}
+
+absl::Status NocSimulator::RunEventDriven(int64_t max_ticks) {
+  // A component's tick only depends on its own state and the state of its
+  // connections, so after the initial tick of every component it only needs
+  // to be ticked again once a neighbor has stamped one of those connections.
+  std::deque<int64_t> worklist(components_.size());
+  std::iota(worklist.begin(), worklist.end(), 0);
+  std::vector<bool> queued(components_.size(), true);
+  std::vector<bool> converged(components_.size(), false);
+  int64_t converged_count = 0;
+
+  while (!worklist.empty()) {
+    int64_t index = worklist.front();
+    worklist.pop_front();
+    queued[index] = false;
+
+    absl::Span<const int64_t> connections = component_connections_[index];
+    int64_t propagated = CountPropagatedChannels(connections);
+    if (components_[index]->Tick(*this)) {
+      converged[index] = true;
+      ++converged_count;
+    }
+    if (CountPropagatedChannels(connections) == propagated) {
+      continue;
+    }
+    for (int64_t connection : connections) {
+      for (int64_t neighbor : connection_components_[connection]) {
+        if (!converged[neighbor] && !queued[neighbor]) {
+          queued[neighbor] = true;
+          worklist.push_back(neighbor);
+        }
+      }
+    }
+  }
+
+  if (converged_count == components_.size()) {
+    return absl::OkStatus();
+  }
+  // Some components are waiting on state no tick will produce, sweep so that
+  // the failure is reported as in kSweep mode.
+  return RunSweep(/*nticks=*/1, max_ticks);
+}
+
+absl::Status NocSimulator::RunCycle(int64_t max_ticks) {
+  ++cycle_;
+  VLOG(2) << "";
+  VLOG(2) << absl::StreamFormat("*** Simul Cycle %d", cycle_);
+
+  for (NocSimulatorServiceShim* svc : pre_cycle_services_) {
+    XLS_RET_CHECK_OK(svc->RunCycle());
+  }
+
+  switch (mode_) {
+    case NocSimulatorMode::kSweep:
+      XLS_RETURN_IF_ERROR(RunSweep(/*nticks=*/0, max_ticks));
+      break;
+    case NocSimulatorMode::kEventDriven:
+      XLS_RETURN_IF_ERROR(RunEventDriven(max_ticks));
+      break;
+    case NocSimulatorMode::kParallel:
+      if (!parallel_scheduler_->Run()) {
+        // Some components are waiting on state no tick will produce, sweep
+        // so that the failure is reported as in kSweep mode.
+        XLS_RETURN_IF_ERROR(RunSweep(/*nticks=*/1, max_ticks));
+      }
+      break;
+  }
 
   for (int64_t i = 0; i < connections_.size(); ++i) {
     VLOG(2) << absl::StreamFormat("  Connection %d (%x)", i,
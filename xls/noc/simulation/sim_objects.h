@@ -16,6 +16,7 @@
 #define XLS_NOC_SIMULATION_SIM_OBJECTS_H_
 
 #include <cstdint>
+#include <memory>
 #include <queue>
 #include <vector>
 
@@ -362,12 +363,31 @@ class SimInputBufferedVCRouter : public SimNetworkComponentBase {
   int64_t utilization_cycle_count_;
 };
 
+// Strategy used by NocSimulator::RunCycle to converge each cycle.
+//
+// All modes produce identical simulation results; components only act on
+// connection state stamped with the current cycle, so the order in which they
+// are ticked does not matter.
+enum class NocSimulatorMode : uint8_t {
+  // Repeatedly ticks every component until all of them have converged.
+  kSweep,
+  // Ticks each component once, and afterwards only re-ticks components
+  // attached to a connection whose state changed.
+  kEventDriven,
+  // Like kEventDriven, but components are partitioned into contiguous
+  // regions of the network which are ticked by separate threads.
+  kParallel,
+};
+
+class NocParallelScheduler;
+
 // Main simulator class that drives the simulation and stores simulation
 // state and objects.
 class NocSimulator {
  public:
   NocSimulator()
       : mgr_(nullptr), params_(nullptr), routing_(nullptr), cycle_(-1) {}
+  ~NocSimulator();
 
   // Creates all simulation objects for a given network.
   // NetworkManager, NocParameters, and DistributedRoutingTable should
@@ -380,9 +400,19 @@ class NocSimulator {
     network_ = network;
     cycle_ = -1;
 
-    return CreateSimulationObjects(network);
+    XLS_RETURN_IF_ERROR(CreateSimulationObjects(network));
+    return BuildComponentConnectivity();
   }
 
+  // Selects how each cycle is converged, see NocSimulatorMode.
+  // thread_count is only used by NocSimulatorMode::kParallel.
+  //
+  // Must be called after Initialize.
+  absl::Status SetMode(NocSimulatorMode mode, int64_t thread_count = 1);
+
+  // Returns how each cycle is converged.
+  NocSimulatorMode GetMode() const { return mode_; }
+
   NetworkManager* GetNetworkManager() { return mgr_; }
   NocParameters* GetNocParameters() { return params_; }
   DistributedRoutingTable* GetRoutingTable() { return routing_; }
@@ -474,6 +504,23 @@ class NocSimulator {
   absl::Status CreateLink(NetworkComponentId nc_id);
   absl::Status CreateRouter(NetworkComponentId nc_id);
 
+  // Records which connections each simulation object is attached to.
+  absl::Status BuildComponentConnectivity();
+
+  // Returns the number of forward and reverse channels of the given
+  // connections that have been stamped with the current cycle.
+  int64_t CountPropagatedChannels(absl::Span<const int64_t> connections);
+
+  // Converges the current cycle by only ticking components whose
+  // connections changed, falling back to Tick() for any remaining ticks.
+  absl::Status RunEventDriven(int64_t max_ticks);
+
+  // Sweeps with Tick() until converged, where nticks ticks have already been
+  // used for the current cycle.
+  absl::Status RunSweep(int64_t nticks, int64_t max_ticks);
+
+  friend class NocParallelScheduler;
+
   NetworkManager* mgr_;
   NocParameters* params_;
   DistributedRoutingTable* routing_;
@@ -510,6 +557,21 @@ class NocSimulator {
   std::vector<SimNetworkInterfaceSink> network_interface_sinks_;
   std::vector<SimInputBufferedVCRouter> routers_;
 
+  NocSimulatorMode mode_ = NocSimulatorMode::kSweep;
+
+  // All simulation objects in the order they are ticked by Tick().
+  std::vector<SimNetworkComponentBase*> components_;
+
+  // Sorted indices into connections_ of the connections attached to each
+  // element of components_.
+  std::vector<std::vector<int64_t>> component_connections_;
+
+  // Indices into components_ of the components attached to each connection.
+  std::vector<std::vector<int64_t>> connection_components_;
+
+  // Used by NocSimulatorMode::kParallel.
+  std::unique_ptr<NocParallelScheduler> parallel_scheduler_;
+
   // Shims to services to run at the beginning of each cycle.
   std::vector<NocSimulatorServiceShim*> pre_cycle_services_;
 
@@ -163,6 +163,8 @@ absl::StatusOr<bool> BddCsePass::RunOnFunctionBaseInternal(
     }
   }
 
+  // The BDD node indices used above are dead, so the BDD may be collected.
+  query_engine->MaybeCollectGarbage();
   return changed;
 }
 
@@ -237,12 +237,17 @@ class BddQueryEngine::AssumingQueryEngine final : public QueryEngine {
  public:
   AssumingQueryEngine(const BddQueryEngine* query_engine,
                       BddNodeIndex assumption)
-      : query_engine_(query_engine), assumption_(assumption) {}
+      : query_engine_(query_engine), assumption_(assumption) {
+    query_engine_->bdd().Ref(assumption_);
+  }
   AssumingQueryEngine(std::shared_ptr<BddQueryEngine> query_engine,
                       BddNodeIndex assumption)
       : query_engine_storage_(std::move(query_engine)),
         query_engine_(query_engine_storage_.get()),
-        assumption_(assumption) {}
+        assumption_(assumption) {
+    query_engine_->bdd().Ref(assumption_);
+  }
+  ~AssumingQueryEngine() override { query_engine_->bdd().Deref(assumption_); }
 
   absl::StatusOr<ReachedFixpoint> Populate(FunctionBase* f) override;
   bool IsTracked(Node* node) const override;
@@ -275,6 +280,13 @@ class BddQueryEngine::AssumingQueryEngine final : public QueryEngine {
   bool IsFullyKnown(Node* n) const override;
 
  private:
+  // Replaces the assumption, keeping the BDD's reference to it up to date.
+  void SetAssumption(BddNodeIndex assumption) {
+    query_engine_->bdd().Ref(assumption);
+    query_engine_->bdd().Deref(assumption_);
+    assumption_ = assumption;
+  }
+
   std::shared_ptr<BddQueryEngine> query_engine_storage_;
   const BddQueryEngine* query_engine_;
 
@@ -328,8 +340,8 @@ BddQueryEngine::AssumingQueryEngine::SpecializeGivenPredicate(
   std::unique_ptr<AssumingQueryEngine> specialized(
       down_cast<AssumingQueryEngine*>(
           query_engine_->SpecializeGivenPredicate(state).release()));
-  specialized->assumption_ =
-      query_engine_->bdd().And(assumption_, specialized->assumption_);
+  specialized->SetAssumption(
+      query_engine_->bdd().And(assumption_, specialized->assumption_));
   return specialized;
 }
 
@@ -348,9 +360,9 @@ BddQueryEngine::AssumingQueryEngine::SpecializeGiven(
       query_engine_->bdd().And(assumption_, result->assumption_);
   if (query_engine_->ExceedsPathLimit(result->assumption_)) {
     // Restore the original assumption, with no updates.
-    result->assumption_ = assumption_;
+    result->SetAssumption(assumption_);
   } else {
-    result->assumption_ = new_assumption;
+    result->SetAssumption(new_assumption);
   }
   return result;
 }
@@ -546,6 +558,39 @@ absl::Status BddQueryEngine::MergeWithGiven(BddVector& info,
   return absl::OkStatus();
 }
 
+void BddQueryEngine::RetainInfo(const BddTree& info) const {
+  for (const BddVector& bdd_vector : info.elements()) {
+    for (const SaturatingBddNodeIndex& bdd_node : bdd_vector) {
+      if (const BddNodeIndex* index = std::get_if<BddNodeIndex>(&bdd_node)) {
+        bdd_->Ref(*index);
+      }
+    }
+  }
+}
+
+void BddQueryEngine::ReleaseInfo(const BddTree& info) const {
+  for (const BddVector& bdd_vector : info.elements()) {
+    for (const SaturatingBddNodeIndex& bdd_node : bdd_vector) {
+      if (const BddNodeIndex* index = std::get_if<BddNodeIndex>(&bdd_node)) {
+        bdd_->Deref(*index);
+      }
+    }
+  }
+}
+
+void BddQueryEngine::MaybeCollectGarbage() const {
+  if (bdd_->size() < next_collection_size_) {
+    return;
+  }
+  bdd_->GarbageCollect();
+  if (2 * bdd_->size() > next_collection_size_) {
+    // Most of the BDD is still in use, so try to shrink it by reordering.
+    bdd_->Reorder();
+  }
+  next_collection_size_ =
+      std::max(kMinCollectionSize, kCollectionGrowthFactor * bdd_->size());
+}
+
 std::unique_ptr<QueryEngine> BddQueryEngine::SpecializeGivenPredicate(
     const absl::btree_set<PredicateState>& state) const {
   absl::btree_map<Node*, ValueKnowledge, Node::NodeIdLessThan> givens;
@@ -137,8 +137,19 @@ class BddQueryEngine
   // generally mutate the object. We sneakily avoid conflicts with C++ const
   // because the BDD is only held indirectly via pointers.
   // TODO(meheff): Enable queries on a BDD without mutating the BDD itself.
+  //
+  // The engine references (BinaryDecisionDiagram::Ref) the BDD nodes of every
+  // value it caches, and dereferences them when the value is recomputed or
+  // invalidated, so the BDD may be garbage collected or reordered while the
+  // caller holds no other BddNodeIndex values from it.
   BinaryDecisionDiagram& bdd() const { return *bdd_; }
 
+  // Garbage collects the BDD once it has grown enough since the last
+  // collection, and reorders its variables if collecting does not shrink it
+  // much. Must only be called while the caller holds no BddNodeIndex values
+  // from the BDD (e.g. from GetBddNode) which it uses afterwards.
+  void MaybeCollectGarbage() const;
+
   // Returns the BDD node associated with the given bit, if there is one;
   // otherwise returns std::nullopt.
   std::optional<BddNodeIndex> GetBddNode(
@@ -163,6 +174,9 @@ class BddQueryEngine
   absl::Status MergeWithGiven(BddVector& info,
                               const BddVector& given) const override;
 
+  void RetainInfo(const BddTree& info) const override;
+  void ReleaseInfo(const BddTree& info) const override;
+
  private:
   class AssumingQueryEngine;
 
@@ -221,6 +235,13 @@ class BddQueryEngine
   std::unique_ptr<BinaryDecisionDiagram> bdd_;
   std::unique_ptr<SaturatingBddEvaluator> evaluator_;
 
+  // MaybeCollectGarbage collects the BDD once it has this many nodes; after
+  // each collection the threshold becomes kCollectionGrowthFactor times the
+  // number of nodes left, but at least kMinCollectionSize.
+  static constexpr int64_t kMinCollectionSize = 1 << 16;
+  static constexpr int64_t kCollectionGrowthFactor = 2;
+  mutable int64_t next_collection_size_ = kMinCollectionSize;
+
   // A map from bit locations to BDD variables; used when the BDD is saturated
   // to avoid creating new variables for the same bit.
   mutable absl::flat_hash_map<TreeBitLocation, BddNodeIndex> bit_variables_;
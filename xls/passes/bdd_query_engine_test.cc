@@ -281,6 +281,35 @@ TEST_F(BddQueryEngineTest, ForceNodeToBeModeledAsVariable) {
       KnownEquals(query_engine_empty_op_set, orop.node(), my_zero.node()));
 }
 
+TEST_F(BddQueryEngineTest, GarbageCollectionReclaimsInvalidatedValues) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  BValue y = fb.Param("y", p->GetBitsType(8));
+  BValue x_eq_y = fb.Eq(x, y);
+  BValue x_eq_0 = fb.Eq(x, fb.Literal(UBits(0, 8)));
+  BValue x_ne_0 = fb.Not(x_eq_0);
+  BValue x_lt_y = fb.ULt(x, y);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.BuildWithReturnValue(x_ne_0));
+  BddQueryEngine query_engine;
+  XLS_ASSERT_OK(query_engine.Populate(f).status());
+  EXPECT_FALSE(KnownNotEquals(query_engine, x_eq_y.node(), x_lt_y.node()));
+  EXPECT_TRUE(KnownNotEquals(query_engine, x_eq_0.node(), x_ne_0.node()));
+
+  // Only reclaims the intermediate nodes of the queries above.
+  query_engine.bdd().GarbageCollect();
+
+  // Deleting a node or recomputing its value releases its old value.
+  XLS_ASSERT_OK(f->RemoveNode(x_lt_y.node()));
+  XLS_ASSERT_OK(x_eq_y.node()->ReplaceOperandNumber(1, x.node()));
+  EXPECT_TRUE(query_engine.IsOne(TreeBitLocation(x_eq_y.node(), 0)));
+  EXPECT_GT(query_engine.bdd().GarbageCollect(), 0);
+
+  // Values which are still cached remain valid.
+  EXPECT_TRUE(KnownNotEquals(query_engine, x_eq_0.node(), x_ne_0.node()));
+  EXPECT_TRUE(Implies(query_engine, x_eq_0.node(), x_eq_y.node()));
+}
+
 TEST_F(BddQueryEngineTest, BitValuesImplyNodeValuePredicateAlwaysFalse) {
   auto p = CreatePackage();
   FunctionBuilder fb(TestName(), p.get());
@@ -460,6 +460,8 @@ absl::StatusOr<bool> BddSimplificationPass::RunOnFunctionBaseInternal(
     modified |= selects_collapsed;
   }
 
+  // Reclaim the BDD nodes of values invalidated by the simplifications.
+  context.SharedQueryEngine<BddQueryEngine>(f)->MaybeCollectGarbage();
   return modified;
 }
 
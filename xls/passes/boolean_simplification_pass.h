@@ -84,6 +84,8 @@ class BooleanSimplificationPass : public OptimizationFunctionBasePass {
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const OptimizationPassOptions& options,
       PassResults* results, OptimizationContext& context) const override;
+
+  bool IsFunctionLocal() const override { return true; }
 };
 
 }  // namespace xls
@@ -42,6 +42,8 @@ class CanonicalizationPass : public OptimizationFunctionBasePass {
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const OptimizationPassOptions& options,
       PassResults* results, OptimizationContext& context) const override;
+
+  bool IsFunctionLocal() const override { return true; }
 };
 
 }  // namespace xls
@@ -41,6 +41,8 @@ class ComparisonSimplificationPass : public OptimizationFunctionBasePass {
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const OptimizationPassOptions& options,
       PassResults* results, OptimizationContext& context) const override;
+
+  bool IsFunctionLocal() const override { return true; }
 };
 
 }  // namespace xls
@@ -74,6 +74,8 @@ class CsePass : public OptimizationFunctionBasePass {
       FunctionBase* f, const OptimizationPassOptions& options,
       PassResults* results, OptimizationContext& context) const override;
 
+  bool IsFunctionLocal() const override { return true; }
+
   bool common_literals_;
 };
 
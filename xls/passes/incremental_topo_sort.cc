@@ -0,0 +1,307 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/incremental_topo_sort.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/log.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/topo_sort.h"
+
+namespace xls {
+
+IncrementalTopoSort::Stats& IncrementalTopoSort::Stats::operator+=(
+    const Stats& other) {
+  hits += other.hits;
+  incremental_reads += other.incremental_reads;
+  reorders += other.reorders;
+  reordered_nodes += other.reordered_nodes;
+  recomputations += other.recomputations;
+  return *this;
+}
+
+std::string IncrementalTopoSort::Stats::ToString() const {
+  return absl::StrFormat(
+      "hits: %d, incremental reads: %d, reorders: %d (%d nodes moved), "
+      "recomputations: %d",
+      hits, incremental_reads, reorders, reordered_nodes, recomputations);
+}
+
+IncrementalTopoSort::IncrementalTopoSort(FunctionBase* f, bool incremental)
+    : f_(f), incremental_(incremental) {
+  f_->RegisterChangeListener(this);
+}
+
+IncrementalTopoSort::~IncrementalTopoSort() {
+  f_->UnregisterChangeListener(this);
+}
+
+const std::vector<Node*>& IncrementalTopoSort::ReverseTopoSort() {
+  if (!valid_) {
+    Recompute();
+    return reverse_order_;
+  }
+  if (!reverse_order_stale_) {
+    ++stats_.hits;
+    return reverse_order_;
+  }
+
+  // Compact the holes left by deleted nodes while building the reverse order.
+  ++stats_.incremental_reads;
+  if (holes_ > 0) {
+    int64_t next = 0;
+    for (Node* node : order_) {
+      if (node == nullptr) {
+        continue;
+      }
+      position_[node] = next;
+      order_[next++] = node;
+    }
+    order_.resize(next);
+    holes_ = 0;
+  }
+  reverse_order_.assign(order_.rbegin(), order_.rend());
+  reverse_order_stale_ = false;
+  return reverse_order_;
+}
+
+void IncrementalTopoSort::Invalidate() {
+  valid_ = false;
+  order_.clear();
+  position_.clear();
+  holes_ = 0;
+  reverse_order_.clear();
+  reverse_order_stale_ = true;
+}
+
+void IncrementalTopoSort::Recompute() {
+  ++stats_.recomputations;
+  reverse_order_ = xls::ReverseTopoSort(f_);
+  reverse_order_stale_ = false;
+  valid_ = true;
+  if (!incremental_) {
+    return;
+  }
+  order_.assign(reverse_order_.rbegin(), reverse_order_.rend());
+  holes_ = 0;
+  position_.clear();
+  position_.reserve(order_.size());
+  for (int64_t i = 0; i < order_.size(); ++i) {
+    position_[order_[i]] = i;
+  }
+}
+
+void IncrementalTopoSort::AddEdge(Node* operand, Node* user) {
+  auto operand_it = position_.find(operand);
+  auto user_it = position_.find(user);
+  if (operand_it == position_.end() || user_it == position_.end()) {
+    Invalidate();
+    return;
+  }
+  const int64_t lower_bound = user_it->second;
+  const int64_t upper_bound = operand_it->second;
+  if (upper_bound < lower_bound) {
+    // The new edge is already consistent with the order.
+    return;
+  }
+
+  // Collect the nodes reachable forward from `user` and backward from
+  // `operand` within the affected region [lower_bound, upper_bound]; only
+  // these need to move.
+  std::vector<Node*> forward;
+  absl::flat_hash_set<Node*> forward_visited;
+  std::vector<Node*> worklist = {user};
+  forward_visited.insert(user);
+  while (!worklist.empty()) {
+    Node* node = worklist.back();
+    worklist.pop_back();
+    forward.push_back(node);
+    for (Node* next : node->users()) {
+      if (next == operand) {
+        // The edit introduced a cycle; this is only legal as a transient
+        // state, so fall back to recomputing once the IR is consistent again.
+        VLOG(3) << "Cycle through " << operand->GetName() << " and "
+                << user->GetName() << "; invalidating topological order";
+        Invalidate();
+        return;
+      }
+      auto it = position_.find(next);
+      if (it == position_.end()) {
+        Invalidate();
+        return;
+      }
+      if (it->second <= upper_bound && forward_visited.insert(next).second) {
+        worklist.push_back(next);
+      }
+    }
+  }
+
+  std::vector<Node*> backward;
+  absl::flat_hash_set<Node*> backward_visited;
+  worklist = {operand};
+  backward_visited.insert(operand);
+  while (!worklist.empty()) {
+    Node* node = worklist.back();
+    worklist.pop_back();
+    backward.push_back(node);
+    for (Node* next : node->operands()) {
+      auto it = position_.find(next);
+      if (it == position_.end()) {
+        Invalidate();
+        return;
+      }
+      if (it->second >= lower_bound && backward_visited.insert(next).second) {
+        worklist.push_back(next);
+      }
+    }
+  }
+
+  auto by_position = [&](Node* a, Node* b) {
+    return position_.at(a) < position_.at(b);
+  };
+  absl::c_sort(forward, by_position);
+  absl::c_sort(backward, by_position);
+
+  // Reuse the freed slots: everything that must precede `user` goes first, in
+  // its original relative order, followed by the forward region.
+  std::vector<int64_t> slots;
+  slots.reserve(forward.size() + backward.size());
+  for (Node* node : backward) {
+    slots.push_back(position_.at(node));
+  }
+  for (Node* node : forward) {
+    slots.push_back(position_.at(node));
+  }
+  absl::c_sort(slots);
+
+  int64_t slot = 0;
+  for (Node* node : backward) {
+    order_[slots[slot]] = node;
+    position_[node] = slots[slot];
+    ++slot;
+  }
+  for (Node* node : forward) {
+    order_[slots[slot]] = node;
+    position_[node] = slots[slot];
+    ++slot;
+  }
+  ++stats_.reorders;
+  stats_.reordered_nodes += slots.size();
+  reverse_order_stale_ = true;
+}
+
+void IncrementalTopoSort::NodeAdded(Node* node) {
+  if (!valid_) {
+    return;
+  }
+  if (!incremental_) {
+    Invalidate();
+    return;
+  }
+  // A freshly-added node has no users, so it can go at the very end.
+  for (Node* operand : node->operands()) {
+    if (!position_.contains(operand)) {
+      Invalidate();
+      return;
+    }
+  }
+  position_[node] = order_.size();
+  order_.push_back(node);
+  reverse_order_stale_ = true;
+}
+
+void IncrementalTopoSort::NodeDeleted(Node* node) {
+  if (!valid_) {
+    return;
+  }
+  if (!incremental_) {
+    Invalidate();
+    return;
+  }
+  auto it = position_.find(node);
+  if (it == position_.end()) {
+    Invalidate();
+    return;
+  }
+  order_[it->second] = nullptr;
+  position_.erase(it);
+  ++holes_;
+  reverse_order_stale_ = true;
+}
+
+void IncrementalTopoSort::OperandChanged(
+    Node* node, Node* old_operand, absl::Span<const int64_t> operand_nos) {
+  if (!valid_) {
+    return;
+  }
+  if (!incremental_) {
+    Invalidate();
+    return;
+  }
+  for (int64_t operand_no : operand_nos) {
+    AddEdge(node->operand(operand_no), node);
+    if (!valid_) {
+      return;
+    }
+  }
+}
+
+void IncrementalTopoSort::OperandRemoved(Node* node, Node* old_operand) {
+  // Removing an edge can never invalidate a topological order.
+  if (!incremental_) {
+    Invalidate();
+  }
+}
+
+void IncrementalTopoSort::OperandAdded(Node* node) {
+  if (!valid_) {
+    return;
+  }
+  if (!incremental_) {
+    Invalidate();
+    return;
+  }
+  // Nodes add their operands during construction, before they are added to
+  // the function; those are handled by NodeAdded.
+  if (!position_.contains(node)) {
+    return;
+  }
+  AddEdge(node->operands().back(), node);
+}
+
+void IncrementalTopoSort::ReturnValueChanged(Function* function,
+                                             Node* old_return_value) {
+  // The return value does not participate in the order.
+  if (!incremental_) {
+    Invalidate();
+  }
+}
+
+void IncrementalTopoSort::NextStateElementChanged(
+    Proc* proc, int64_t state_index, Node* old_next_state_element) {
+  // Next-state elements do not participate in the order.
+  if (!incremental_) {
+    Invalidate();
+  }
+}
+
+}  // namespace xls
@@ -0,0 +1,118 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_INCREMENTAL_TOPO_SORT_H_
+#define XLS_PASSES_INCREMENTAL_TOPO_SORT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "xls/ir/change_listener.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+
+namespace xls {
+
+// A cached topological order of the nodes in a FunctionBase which listens for
+// change events to keep itself up to date.
+//
+// In incremental mode, local edits patch the cached order rather than
+// discarding it: new nodes are appended (they have no users yet), deleted
+// nodes leave holes which are compacted on the next read, and an operand edge
+// which violates the current order is repaired by reordering only the nodes
+// whose positions lie between the two endpoints (Pearce & Kelly, "A Dynamic
+// Topological Sort Algorithm for Directed Acyclic Graphs", 2007).
+//
+// Note that an incrementally maintained order is a valid topological order but
+// is generally *not* the stable order produced by xls::TopoSort.
+//
+// In non-incremental mode any edit invalidates the cached order, which is then
+// recomputed with xls::ReverseTopoSort on the next read.
+class IncrementalTopoSort : public ChangeListener {
+ public:
+  struct Stats {
+    // Reads answered from the cached order without any recomputation.
+    int64_t hits = 0;
+    // Reads answered by compacting an incrementally patched order.
+    int64_t incremental_reads = 0;
+    // Edits which required a local reordering of the cached order.
+    int64_t reorders = 0;
+    // Total number of nodes moved by local reorderings.
+    int64_t reordered_nodes = 0;
+    // Full recomputations of the order.
+    int64_t recomputations = 0;
+
+    Stats& operator+=(const Stats& other);
+    std::string ToString() const;
+  };
+
+  IncrementalTopoSort(FunctionBase* f, bool incremental);
+  ~IncrementalTopoSort() override;
+
+  IncrementalTopoSort(const IncrementalTopoSort&) = delete;
+  IncrementalTopoSort& operator=(const IncrementalTopoSort&) = delete;
+  IncrementalTopoSort(IncrementalTopoSort&&) = delete;
+  IncrementalTopoSort& operator=(IncrementalTopoSort&&) = delete;
+
+  // Returns the nodes of the function in a reverse topological order. The
+  // reference is valid until the next modification of the function.
+  const std::vector<Node*>& ReverseTopoSort();
+
+  const Stats& stats() const { return stats_; }
+  bool incremental() const { return incremental_; }
+
+  void NodeAdded(Node* node) override;
+  void NodeDeleted(Node* node) override;
+  void OperandChanged(Node* node, Node* old_operand,
+                      absl::Span<const int64_t> operand_nos) override;
+  void OperandRemoved(Node* node, Node* old_operand) override;
+  void OperandAdded(Node* node) override;
+  void ReturnValueChanged(Function* function, Node* old_return_value) override;
+  void NextStateElementChanged(Proc* proc, int64_t state_index,
+                               Node* old_next_state_element) override;
+
+ private:
+  // Discards the cached order; it will be recomputed on the next read.
+  void Invalidate();
+
+  // Recomputes the order from scratch.
+  void Recompute();
+
+  // Repairs the order (if needed) after `user` gained `operand` as an operand.
+  void AddEdge(Node* operand, Node* user);
+
+  FunctionBase* const f_;
+  const bool incremental_;
+
+  // Whether `order_` and `position_` describe a valid topological order.
+  bool valid_ = false;
+
+  // Forward topological order; deleted nodes leave nullptr holes.
+  std::vector<Node*> order_;
+  absl::flat_hash_map<Node*, int64_t> position_;
+  int64_t holes_ = 0;
+
+  // Compacted reverse of `order_`, rebuilt lazily on read.
+  std::vector<Node*> reverse_order_;
+  bool reverse_order_stale_ = true;
+
+  Stats stats_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_INCREMENTAL_TOPO_SORT_H_
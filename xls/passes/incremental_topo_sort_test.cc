@@ -0,0 +1,159 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/incremental_topo_sort.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
+#include "xls/ir/package.h"
+#include "xls/ir/source_location.h"
+#include "xls/ir/topo_sort.h"
+
+namespace xls {
+namespace {
+
+using ::testing::Contains;
+using ::testing::Not;
+
+class IncrementalTopoSortTest : public IrTestBase {
+ protected:
+  // Checks that `reverse_order` is a reverse topological order of all nodes in
+  // `f`.
+  static void ExpectValidReverseOrder(FunctionBase* f,
+                                      const std::vector<Node*>& reverse_order) {
+    ASSERT_EQ(reverse_order.size(), f->node_count());
+    absl::flat_hash_map<Node*, int64_t> position;
+    for (int64_t i = 0; i < reverse_order.size(); ++i) {
+      ASSERT_TRUE(position.emplace(reverse_order[i], i).second)
+          << "Duplicate node " << reverse_order[i]->GetName();
+    }
+    for (Node* node : f->nodes()) {
+      ASSERT_TRUE(position.contains(node)) << "Missing " << node->GetName();
+      for (Node* operand : node->operands()) {
+        EXPECT_GT(position.at(operand), position.at(node))
+            << operand->GetName() << " must come after " << node->GetName();
+      }
+    }
+  }
+};
+
+TEST_F(IncrementalTopoSortTest, NonIncrementalMatchesTopoSort) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  BValue y = fb.Param("y", p->GetBitsType(8));
+  fb.Add(fb.Negate(x), fb.Not(y));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  IncrementalTopoSort topo_sort(f, /*incremental=*/false);
+  EXPECT_EQ(topo_sort.ReverseTopoSort(), ReverseTopoSort(f));
+  EXPECT_EQ(topo_sort.ReverseTopoSort(), ReverseTopoSort(f));
+  EXPECT_EQ(topo_sort.stats().recomputations, 1);
+  EXPECT_EQ(topo_sort.stats().hits, 1);
+
+  XLS_ASSERT_OK(f->MakeNode<UnOp>(SourceInfo(), x.node(), Op::kNeg).status());
+  EXPECT_EQ(topo_sort.ReverseTopoSort(), ReverseTopoSort(f));
+  EXPECT_EQ(topo_sort.stats().recomputations, 2);
+}
+
+TEST_F(IncrementalTopoSortTest, AddedNodesAreAppended) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  fb.Not(fb.Negate(x));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  IncrementalTopoSort topo_sort(f, /*incremental=*/true);
+  ExpectValidReverseOrder(f, topo_sort.ReverseTopoSort());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * neg, f->MakeNode<UnOp>(SourceInfo(), x.node(), Op::kNeg));
+  const std::vector<Node*>& order = topo_sort.ReverseTopoSort();
+  ExpectValidReverseOrder(f, order);
+  EXPECT_EQ(order.front(), neg);
+  EXPECT_EQ(topo_sort.stats().recomputations, 1);
+  EXPECT_EQ(topo_sort.stats().reorders, 0);
+  EXPECT_EQ(topo_sort.stats().incremental_reads, 1);
+}
+
+TEST_F(IncrementalTopoSortTest, ReordersOnBackwardEdge) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  BValue neg = fb.Negate(x);
+  BValue inv = fb.Not(neg);
+  fb.Add(inv, neg);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  IncrementalTopoSort topo_sort(f, /*incremental=*/true);
+  ExpectValidReverseOrder(f, topo_sort.ReverseTopoSort());
+
+  // The new node is appended after everything else, so making it an operand
+  // of `neg` requires moving it (and nothing else) ahead of `neg`'s cone.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * reversed,
+      f->MakeNode<UnOp>(SourceInfo(), x.node(), Op::kReverse));
+  XLS_ASSERT_OK(neg.node()->ReplaceOperandNumber(0, reversed));
+  ExpectValidReverseOrder(f, topo_sort.ReverseTopoSort());
+  EXPECT_EQ(topo_sort.stats().recomputations, 1);
+  EXPECT_EQ(topo_sort.stats().reorders, 1);
+
+  // Edges which agree with the current order need no work.
+  XLS_ASSERT_OK(inv.node()->ReplaceOperandNumber(0, reversed));
+  ExpectValidReverseOrder(f, topo_sort.ReverseTopoSort());
+  EXPECT_EQ(topo_sort.stats().reorders, 1);
+}
+
+TEST_F(IncrementalTopoSortTest, ReplaceUsesWithNewNode) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  BValue y = fb.Param("y", p->GetBitsType(8));
+  BValue sum = fb.Add(x, y);
+  BValue a = fb.Negate(sum);
+  BValue b = fb.Not(sum);
+  fb.Tuple({fb.Add(a, b), fb.Subtract(a, sum)});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  IncrementalTopoSort topo_sort(f, /*incremental=*/true);
+  ExpectValidReverseOrder(f, topo_sort.ReverseTopoSort());
+
+  Node* old_sum = sum.node();
+  XLS_ASSERT_OK(
+      old_sum->ReplaceUsesWithNew<BinOp>(y.node(), x.node(), Op::kAdd)
+          .status());
+  XLS_ASSERT_OK(f->RemoveNode(old_sum));
+  const std::vector<Node*>& order = topo_sort.ReverseTopoSort();
+  ExpectValidReverseOrder(f, order);
+  EXPECT_THAT(order, Not(Contains(old_sum)));
+  EXPECT_EQ(topo_sort.stats().recomputations, 1);
+  EXPECT_GT(topo_sort.stats().reorders, 0);
+}
+
+}  // namespace
+}  // namespace xls
@@ -75,6 +75,13 @@ class LazyDagCache {
 
     virtual absl::StatusOr<Value> ComputeValue(
         const Key& key, absl::Span<const Value* const> input_values) const = 0;
+
+    // Called when the cache starts and stops storing a value, so providers
+    // whose values refer to external resources can keep those alive for as
+    // long as the cache holds them. Values still held when the cache is
+    // destroyed are not released.
+    virtual void RetainValue(const Value& value) const {}
+    virtual void ReleaseValue(const Value& value) const {}
   };
 
   LazyDagCache<Key, Value>(DagProvider* provider) : provider_(provider) {}
@@ -98,19 +105,45 @@ class LazyDagCache {
   LazyDagCache<Key, Value>& operator=(LazyDagCache<Key, Value>&& other) =
       delete;
 
+  // Counters describing how queries were answered.
+  struct Stats {
+    // Queries answered directly by a known or forced value.
+    int64_t hits = 0;
+    // Values which were re-validated without recomputation since none of
+    // their inputs changed.
+    int64_t revalidations = 0;
+    // Calls to ComputeValue for a queried key.
+    int64_t recomputations = 0;
+    // Recomputations which produced the previously-stored value.
+    int64_t unchanged_recomputations = 0;
+  };
+  const Stats& stats() const { return stats_; }
+
   // Erase all knowledge of the values of all keys.
-  void Clear() { cache_.clear(); }
+  void Clear() {
+    for (const auto& [_, entry] : cache_) {
+      Release(entry);
+    }
+    cache_.clear();
+  }
   // Erase all knowledge of the value of all keys except for 'Forced' values.
   void ClearNonForced() {
-    absl::erase_if(cache_, [](const auto& v) {
-      return v.second.state != CacheState::kForced;
+    absl::erase_if(cache_, [this](const auto& v) {
+      if (v.second.state == CacheState::kForced) {
+        return false;
+      }
+      Release(v.second);
+      return true;
     });
   }
 
   // Entirely remove knowledge of this key. This includes erasing any Forced
   // data.
   void Forget(const Key& key) {
-    cache_.erase(key);
+    if (auto it = cache_.find(key); it != cache_.end()) {
+      Release(it->second);
+      cache_.erase(it);
+    }
     for (const Key& user : provider_->GetUsers(key)) {
       MarkInputsUnverified(user);
     }
@@ -123,8 +156,8 @@ class LazyDagCache {
   // 'value' to be associated with 'key' now and forever. This knowledge may
   // only be removed by calling 'Forget' or 'Clear'.
   void SetForced(const Key& key, std::unique_ptr<Value> value) {
-    cache_.insert_or_assign(key, CacheEntry{.state = CacheState::kForced,
-                                            .value = std::move(value)});
+    Store(key, CacheEntry{.state = CacheState::kForced,
+                          .value = std::move(value)});
     MarkUsersUnverified(key);
   }
 
@@ -139,13 +172,11 @@ class LazyDagCache {
   }
 
   void AddUnverified(const Key& key, Value value) {
-    cache_.insert_or_assign(
-        key, CacheEntry{.state = CacheState::kUnverified,
-                        .value = std::make_unique<Value>(std::move(value))});
+    AddUnverified(key, std::make_unique<Value>(std::move(value)));
   }
   void AddUnverified(const Key& key, std::unique_ptr<Value> value) {
-    cache_.insert_or_assign(key, CacheEntry{.state = CacheState::kUnverified,
-                                            .value = std::move(value)});
+    Store(key, CacheEntry{.state = CacheState::kUnverified,
+                          .value = std::move(value)});
   }
 
   // Request recomputation of any users of this key.
@@ -213,6 +244,7 @@ class LazyDagCache {
     if (auto it = cache_.find(key);
         it != cache_.end() && (it->second.state == CacheState::kKnown ||
                                it->second.state == CacheState::kForced)) {
+      ++stats_.hits;
       return it->second.value.get();
     }
 
@@ -234,21 +266,28 @@ class LazyDagCache {
     // recomputation.
     if (state == CacheState::kInputsUnverified) {
       state = CacheState::kKnown;
+      ++stats_.revalidations;
       return cached_value.get();
     }
 
     absl::StatusOr<Value> new_value =
         provider_->ComputeValue(key, input_values);
     CHECK_OK(new_value);
+    ++stats_.recomputations;
     if (state == CacheState::kUnverified && *new_value == *cached_value) {
       // The value didn't change; the stored value is still valid.
       state = CacheState::kKnown;
+      ++stats_.unchanged_recomputations;
       return cached_value.get();
     }
 
     CHECK_NE(state, CacheState::kForced);
     state = CacheState::kKnown;
+    if (cached_value != nullptr) {
+      provider_->ReleaseValue(*cached_value);
+    }
     cached_value = std::make_unique<Value>(*std::move(new_value));
+    provider_->RetainValue(*cached_value);
 
     // Our stored value changed; make sure we downgrade any users that were
     // previously kInputsUnverified to kUnverified.
@@ -279,9 +318,9 @@ class LazyDagCache {
       }
       XLS_ASSIGN_OR_RETURN(Value value,
                            provider_->ComputeValue(key, input_values));
-      cache_.insert_or_assign(
-          key, CacheEntry{.state = CacheState::kKnown,
-                          .value = std::make_unique<Value>(std::move(value))});
+      Store(key,
+            CacheEntry{.state = CacheState::kKnown,
+                       .value = std::make_unique<Value>(std::move(value))});
     }
     return absl::OkStatus();
   }
@@ -367,6 +406,24 @@ class LazyDagCache {
     std::unique_ptr<Value> value = nullptr;
   };
   absl::flat_hash_map<Key, CacheEntry> cache_;
+  Stats stats_;
+
+  void Release(const CacheEntry& entry) const {
+    if (entry.value != nullptr) {
+      provider_->ReleaseValue(*entry.value);
+    }
+  }
+  // Stores `entry` for `key`, releasing any value it replaces.
+  void Store(const Key& key, CacheEntry entry) {
+    if (entry.value != nullptr) {
+      provider_->RetainValue(*entry.value);
+    }
+    auto [it, inserted] = cache_.try_emplace(key);
+    if (!inserted) {
+      Release(it->second);
+    }
+    it->second = std::move(entry);
+  }
 
   struct CacheEntryView {
     CacheState state = CacheState::kUnknown;
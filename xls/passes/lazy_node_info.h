@@ -90,6 +90,8 @@ class LazyNodeInfo
   using CacheState = LazyDagCache<Node*, LeafTypeTree<Info>>::CacheState;
 
  public:
+  using CacheStats = LazyDagCache<Node*, LeafTypeTree<Info>>::Stats;
+
   LazyNodeInfo<Info>() : cache_(this) {}
   ~LazyNodeInfo() override {
     if (f_ != nullptr) {
@@ -372,6 +374,10 @@ class LazyNodeInfo
   // The function that this cache is bound on.
   FunctionBase* bound_function() const { return f_; }
 
+  // Counters describing how often queries were answered without
+  // recomputation.
+  const CacheStats& cache_stats() const { return cache_.stats(); }
+
  protected:
   virtual LeafTypeTree<Info> ComputeInfo(
       Node* node,
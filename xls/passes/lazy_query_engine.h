@@ -103,6 +103,13 @@ class LazyQueryEngine : public QueryEngine {
 
     absl::Status MergeWithGiven(Info& info, const Info& given) const final;
 
+    void RetainValue(const LeafTypeTree<Info>& info) const final {
+      owner_->RetainInfo(info);
+    }
+    void ReleaseValue(const LeafTypeTree<Info>& info) const final {
+      owner_->ReleaseInfo(info);
+    }
+
    private:
     LazyQueryEngine<Info>* owner_;
   };
@@ -200,6 +207,11 @@ class LazyQueryEngine : public QueryEngine {
 
   virtual absl::Status MergeWithGiven(Info& info, const Info& given) const = 0;
 
+  // Called when the cache starts and stops storing the information for a
+  // node; see LazyDagCache::DagProvider::RetainValue.
+  virtual void RetainInfo(const LeafTypeTree<Info>& info) const {}
+  virtual void ReleaseInfo(const LeafTypeTree<Info>& info) const {}
+
  private:
   QueryEngineNodeInfo info_;
 };
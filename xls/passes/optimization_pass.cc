@@ -14,33 +14,42 @@
 
 #include "xls/passes/optimization_pass.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <iterator>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/math_util.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/ir/change_listener.h"
 #include "xls/ir/function_base.h"
 #include "xls/ir/node.h"
 #include "xls/ir/package.h"
 #include "xls/ir/ram_rewrite.pb.h"
-#include "xls/ir/topo_sort.h"
+#include "xls/passes/incremental_topo_sort.h"
 #include "xls/passes/pass_base.h"
+#include "xls/passes/pass_trace.h"
 
 namespace xls {
 
@@ -131,19 +140,46 @@ absl::StatusOr<std::vector<RamRewrite>> RamRewritesFromProto(
   return rewrites;
 }
 
-const std::vector<Node*>& OptimizationContext::ReverseTopoSortReference(
+OptimizationContext::FunctionState& OptimizationContext::GetFunctionState(
     FunctionBase* f) {
-  auto it = reverse_topo_sort_.find(f);
-  if (it == reverse_topo_sort_.end()) {
-    bool inserted = false;
-    std::tie(it, inserted) = reverse_topo_sort_.emplace(
-        f, InvalidatingVector(f, xls::ReverseTopoSort(f)));
-    CHECK(inserted);
+  absl::MutexLock lock(&mu_);
+  std::unique_ptr<FunctionState>& state = function_states_[f];
+  if (state == nullptr) {
+    state = std::make_unique<FunctionState>();
+  }
+  return *state;
+}
+
+std::vector<QueryEngine*> OptimizationContext::ListQueryEngines() {
+  absl::MutexLock lock(&mu_);
+  std::vector<QueryEngine*> query_engines;
+  for (auto& [f, state] : function_states_) {
+    query_engines.reserve(query_engines.size() + state->query_engines.size());
+    for (auto& [type_index, query_engine] : state->query_engines) {
+      query_engines.push_back(query_engine.get());
+    }
   }
-  if (it->second->empty() && f->node_count() > 0) {
-    *it->second = xls::ReverseTopoSort(f);
+  return query_engines;
+}
+
+void OptimizationContext::Abandon(FunctionBase* f) {
+  absl::MutexLock lock(&mu_);
+  auto it = function_states_.find(f);
+  if (it == function_states_.end()) {
+    return;
   }
-  return *it->second;
+  abandoned_stats_ += it->second->Stats();
+  function_states_.erase(it);
+}
+
+const std::vector<Node*>& OptimizationContext::ReverseTopoSortReference(
+    FunctionBase* f) {
+  FunctionState& state = GetFunctionState(f);
+  if (state.topo_sort == nullptr) {
+    state.topo_sort =
+        std::make_unique<IncrementalTopoSort>(f, incremental_topo_sort_);
+  }
+  return state.topo_sort->ReverseTopoSort();
 }
 
 std::vector<Node*> OptimizationContext::ReverseTopoSort(FunctionBase* f) {
@@ -156,6 +192,116 @@ std::vector<Node*> OptimizationContext::TopoSort(FunctionBase* f) {
   return result;
 }
 
+OptimizationContext::CacheStats OptimizationContext::cache_stats() const {
+  absl::MutexLock lock(&mu_);
+  CacheStats stats = abandoned_stats_;
+  for (const auto& [f, state] : function_states_) {
+    stats += state->Stats();
+  }
+  return stats;
+}
+
+std::vector<FunctionBase*> OptimizationContext::GetChangedFunctionBases(
+    const OptimizationPass* pass, absl::Span<FunctionBase* const> fbs,
+    const PassResults& results) {
+  absl::Span<const PassInvocation> invocations = results.invocations;
+  int64_t package_epoch;
+  {
+    absl::MutexLock lock(&mu_);
+    function_local_pass_names_.insert(pass->short_name());
+    if (invocations.size() < seen_invocations_) {
+      // The invocations are those of a different pipeline run.
+      ++package_epoch_;
+      seen_invocations_ = 0;
+    }
+    for (const PassInvocation& invocation :
+         invocations.subspan(seen_invocations_)) {
+      if (invocation.ir_changed &&
+          !function_local_pass_names_.contains(invocation.pass_name)) {
+        ++package_epoch_;
+      }
+    }
+    seen_invocations_ = invocations.size();
+    package_epoch = package_epoch_;
+  }
+
+  if (results.fixed_point_run == 0) {
+    return std::vector<FunctionBase*>(fbs.begin(), fbs.end());
+  }
+  std::vector<FunctionBase*> changed;
+  for (FunctionBase* f : fbs) {
+    FunctionState& state = GetFunctionState(f);
+    auto it = state.unchanged_runs.find(pass);
+    if (it == state.unchanged_runs.end() ||
+        it->second.fixed_point_run != results.fixed_point_run ||
+        it->second.package_epoch != package_epoch ||
+        it->second.change_count != state.change_counter->count()) {
+      changed.push_back(f);
+    }
+  }
+  return changed;
+}
+
+void OptimizationContext::RecordFunctionBaseRun(const OptimizationPass* pass,
+                                                FunctionBase* f,
+                                                const PassResults& results,
+                                                bool changed) {
+  int64_t package_epoch;
+  {
+    absl::MutexLock lock(&mu_);
+    package_epoch = package_epoch_;
+  }
+  FunctionState& state = GetFunctionState(f);
+  if (state.change_counter == nullptr) {
+    state.change_counter = std::make_unique<ChangeCounter>(f);
+  }
+  if (changed) {
+    // Not every change is visible to change listeners (e.g., renaming a node)
+    // so count the change explicitly.
+    state.change_counter->Increment();
+    state.unchanged_runs.erase(pass);
+    return;
+  }
+  state.unchanged_runs[pass] =
+      UnchangedRun{.fixed_point_run = results.fixed_point_run,
+                   .change_count = state.change_counter->count(),
+                   .package_epoch = package_epoch};
+}
+
+IncrementalVerifier& OptimizationContext::GetIncrementalVerifier(
+    Package* p, int64_t full_verification_interval) {
+  if (incremental_verifier_ == nullptr ||
+      incremental_verifier_->package() != p) {
+    incremental_verifier_ = std::make_unique<IncrementalVerifier>(
+        p, /*codegen=*/false, full_verification_interval);
+  }
+  return *incremental_verifier_;
+}
+
+OptimizationContext::CacheStats OptimizationContext::FunctionState::Stats()
+    const {
+  CacheStats stats{.query_engine_hits = query_engine_hits,
+                   .query_engine_populations = query_engine_populations};
+  if (topo_sort != nullptr) {
+    stats.topo_sort = topo_sort->stats();
+  }
+  return stats;
+}
+
+OptimizationContext::CacheStats& OptimizationContext::CacheStats::operator+=(
+    const CacheStats& other) {
+  topo_sort += other.topo_sort;
+  query_engine_hits += other.query_engine_hits;
+  query_engine_populations += other.query_engine_populations;
+  return *this;
+}
+
+std::string OptimizationContext::CacheStats::ToString() const {
+  return absl::StrFormat(
+      "topo sort {%s}; query engines: %d hits, %d populations",
+      topo_sort.ToString(), query_engine_hits, query_engine_populations);
+}
+
 absl::StatusOr<bool> OptimizationFunctionBasePass::RunOnFunctionBase(
     FunctionBase* f, const OptimizationPassOptions& options,
     PassResults* results, OptimizationContext& context) const {
@@ -173,19 +319,119 @@ absl::StatusOr<bool> OptimizationFunctionBasePass::RunOnFunctionBase(
   return changed;
 }
 
-absl::StatusOr<bool> OptimizationFunctionBasePass::RunInternal(
-    Package* p, const OptimizationPassOptions& options, PassResults* results,
-    OptimizationContext& context) const {
+namespace {
+
+// Runs `run` on each of `fbs` using up to `thread_count` threads and returns
+// whether any run changed the IR. Node ids are assigned as if the runs had
+// happened serially in the order of `fbs`, so the result is deterministic. If
+// several runs fail, the error of the first failing FunctionBase (in order) is
+// returned.
+absl::StatusOr<bool> RunOnFunctionBasesInParallel(
+    Package* p, absl::Span<FunctionBase* const> fbs, int64_t thread_count,
+    absl::FunctionRef<absl::StatusOr<bool>(FunctionBase*)> run) {
+  std::vector<absl::StatusOr<bool>> fb_results(fbs.size(), false);
+  std::atomic<int64_t> next_index = 0;
+  p->BeginConcurrentModification(fbs);
+  {
+    std::vector<std::unique_ptr<Thread>> workers;
+    const int64_t worker_count =
+        std::min<int64_t>(thread_count, static_cast<int64_t>(fbs.size()));
+    workers.reserve(worker_count);
+    for (int64_t i = 0; i < worker_count; ++i) {
+      workers.push_back(std::make_unique<Thread>([&]() {
+        for (int64_t index = next_index++; index < fbs.size();
+             index = next_index++) {
+          fb_results[index] = run(fbs[index]);
+        }
+      }));
+    }
+    for (std::unique_ptr<Thread>& worker : workers) {
+      worker->Join();
+    }
+  }
+  p->EndConcurrentModification(fbs);
+
+  bool changed = false;
+  for (absl::StatusOr<bool>& fb_result : fb_results) {
+    XLS_ASSIGN_OR_RETURN(bool fb_changed, std::move(fb_result));
+    changed = changed || fb_changed;
+  }
+  return changed;
+}
+
+// Runs `run` on `f`, recording a span attributed to the pass `pass_name` if
+// `tracer` is not null.
+absl::StatusOr<bool> RunOnFunctionBaseTraced(
+    PassTracer* tracer, std::string_view pass_name, FunctionBase* f,
+    absl::FunctionRef<absl::StatusOr<bool>(FunctionBase*)> run) {
+  PassTracer::ScopedSpan span(tracer, PassTraceCategory::kFunctionBase,
+                              f->name(), [f] { return f->node_count(); });
+  span.AddArg("pass", pass_name);
+  XLS_ASSIGN_OR_RETURN(bool changed, run(f));
+  span.AddArg("changed", changed ? "true" : "false");
+  return changed;
+}
+
+// Runs `run` (the per-FunctionBase implementation of `pass`) on each of `fbs`
+// and returns whether any run changed the IR. Function-local passes may run in
+// parallel, and skip the FunctionBases they cannot change if enabled.
+absl::StatusOr<bool> RunOnFunctionBases(
+    const OptimizationPass* pass, bool function_local, Package* p,
+    absl::Span<FunctionBase* const> fbs, const OptimizationPassOptions& options,
+    PassResults* results, OptimizationContext& context,
+    absl::FunctionRef<absl::StatusOr<bool>(FunctionBase*)> run) {
+  const bool skip_unchanged =
+      function_local && options.skip_unchanged_function_bases;
+  std::vector<FunctionBase*> changed_fbs;
+  if (skip_unchanged) {
+    changed_fbs = context.GetChangedFunctionBases(pass, fbs, *results);
+    results->function_base_skips += fbs.size() - changed_fbs.size();
+    fbs = changed_fbs;
+  }
+  results->function_base_runs += fbs.size();
+
+  auto run_one = [&](FunctionBase* f) -> absl::StatusOr<bool> {
+    XLS_ASSIGN_OR_RETURN(
+        bool changed,
+        RunOnFunctionBaseTraced(options.tracer, pass->short_name(), f, run));
+    if (skip_unchanged) {
+      context.RecordFunctionBaseRun(pass, f, *results, changed);
+    }
+    return changed;
+  };
   bool changed = false;
-  for (FunctionBase* f : p->GetFunctionBases()) {
+  if (options.function_base_threads > 1 && function_local) {
+    // Blocks may refer to each other through instantiations, so only functions
+    // and procs are run in parallel. Blocks come last in `fbs` and are run
+    // serially afterwards, which keeps node ids the same as in a serial run.
+    auto first_block = absl::c_find_if(
+        fbs, [](FunctionBase* f) { return f->IsBlock(); });
+    absl::Span<FunctionBase* const> parallel_fbs =
+        fbs.subspan(0, first_block - fbs.begin());
     XLS_ASSIGN_OR_RETURN(
-        bool function_changed,
-        RunOnFunctionBaseInternal(f, options, results, context));
-    changed = changed || function_changed;
+        changed, RunOnFunctionBasesInParallel(
+                     p, parallel_fbs, options.function_base_threads, run_one));
+    fbs = fbs.subspan(parallel_fbs.size());
+  }
+  for (FunctionBase* f : fbs) {
+    XLS_ASSIGN_OR_RETURN(bool fb_changed, run_one(f));
+    changed = changed || fb_changed;
   }
   return changed;
 }
 
+}  // namespace
+
+absl::StatusOr<bool> OptimizationFunctionBasePass::RunInternal(
+    Package* p, const OptimizationPassOptions& options, PassResults* results,
+    OptimizationContext& context) const {
+  return RunOnFunctionBases(
+      this, IsFunctionLocal(), p, p->GetFunctionBases(), options, results,
+      context, [&](FunctionBase* f) {
+        return RunOnFunctionBaseInternal(f, options, results, context);
+      });
+}
+
 absl::StatusOr<bool> OptimizationFunctionBasePass::TransformNodesToFixedPoint(
     FunctionBase* f,
     std::function<absl::StatusOr<bool>(Node*)> simplify_f) const {
@@ -242,14 +488,16 @@ absl::StatusOr<bool> OptimizationProcPass::RunOnProc(
 absl::StatusOr<bool> OptimizationProcPass::RunInternal(
     Package* p, const OptimizationPassOptions& options, PassResults* results,
     OptimizationContext& context) const {
-  bool changed = false;
+  std::vector<FunctionBase*> procs;
+  procs.reserve(p->procs().size());
   for (const auto& proc : p->procs()) {
-    XLS_ASSIGN_OR_RETURN(
-        bool proc_changed,
-        RunOnProcInternal(proc.get(), options, results, context));
-    changed = changed || proc_changed;
+    procs.push_back(proc.get());
   }
-  return changed;
+  return RunOnFunctionBases(
+      this, IsFunctionLocal(), p, procs, options, results, context,
+      [&](FunctionBase* f) {
+        return RunOnProcInternal(f->AsProcOrDie(), options, results, context);
+      });
 }
 
 }  // namespace xls
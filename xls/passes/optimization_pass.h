@@ -25,15 +25,19 @@
 #include <tuple>
 #include <type_traits>
 #include <typeindex>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
 #include "absl/base/nullability.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/change_listener.h"
@@ -44,9 +48,12 @@
 #include "xls/ir/proc.h"
 #include "xls/ir/ram_rewrite.pb.h"
 #include "xls/ir/value.h"
+#include "xls/ir/verifier.h"
+#include "xls/passes/incremental_topo_sort.h"
 #include "xls/passes/pass_base.h"
 #include "xls/passes/pass_pipeline.pb.h"
 #include "xls/passes/pass_registry.h"
+#include "xls/passes/pass_trace.h"
 #include "xls/passes/pipeline_generator.h"
 #include "xls/passes/query_engine.h"
 #include "xls/passes/query_engine_helpers.h"
@@ -181,27 +188,85 @@ struct OptimizationPassOptions : public PassOptionsBase {
 
   // Enable resource sharing to reduce area
   bool enable_resource_sharing = false;
+
+  // Number of threads used to run function-local passes over the functions
+  // and procs of a package. Values of 1 or less run every pass serially. The
+  // resulting IR is identical regardless of the number of threads.
+  int64_t function_base_threads = 1;
+
+  // Whether function-local passes skip the functions and procs which are
+  // unchanged since the pass last ran on them without changing them. Such runs
+  // cannot change the IR, so the result is the same either way.
+  bool skip_unchanged_function_bases = true;
+
+  // Whether the verifier invariant checker only re-verifies what changed since
+  // it last ran (see xls::IncrementalVerifier) rather than the whole package.
+  bool incremental_verification = false;
+
+  // With incremental verification, verify the whole package every this many
+  // verifications. Zero or less verifies the whole package only the first
+  // time and when functions, procs or channels are added or removed.
+  int64_t full_verification_interval = 0;
 };
 
+class OptimizationContext;
+
+// Defines the pass types for optimizations which operate strictly on XLS IR
+// (i.e., xls::Package).
+using OptimizationPass = PassBase<Package, OptimizationPassOptions, PassResults,
+                                  OptimizationContext>;
+
 class OptimizationContext {
  public:
+  // Counters describing how often cached analyses were reused rather than
+  // recomputed.
+  struct CacheStats {
+    IncrementalTopoSort::Stats topo_sort;
+    // Requests for a shared query engine answered by an existing engine.
+    int64_t query_engine_hits = 0;
+    // Shared query engines created (and populated) from scratch.
+    int64_t query_engine_populations = 0;
+
+    CacheStats& operator+=(const CacheStats& other);
+    std::string ToString() const;
+  };
+
+  // If `incremental_topo_sort` is true, the cached topological orders are
+  // patched in response to IR edits rather than recomputed. The resulting
+  // orders are valid but not necessarily the stable order from xls::TopoSort.
+  //
+  // The context may be used from several threads at once as long as each
+  // FunctionBase is only operated on by one thread at a time.
+  explicit OptimizationContext(bool incremental_topo_sort = false)
+      : incremental_topo_sort_(incremental_topo_sort) {}
+
   template <typename QueryEngineT>
     requires(std::is_base_of_v<QueryEngine, QueryEngineT>)
   QueryEngineT* SharedQueryEngine(FunctionBase* f) {
-    absl::flat_hash_map<std::type_index, std::shared_ptr<QueryEngine>>&
-        f_query_engines = shared_query_engines_[f];
-    auto it = f_query_engines.find(typeid(QueryEngineT));
-    if (it == f_query_engines.end()) {
+    FunctionState& state = GetFunctionState(f);
+    auto it = state.query_engines.find(typeid(QueryEngineT));
+    if (it == state.query_engines.end()) {
       bool inserted = false;
       if constexpr (requires { QueryEngineT::MakeDefault(); }) {
-        std::tie(it, inserted) = f_query_engines.emplace(
+        std::tie(it, inserted) = state.query_engines.emplace(
             typeid(QueryEngineT), QueryEngineT::MakeDefault());
       } else {
-        std::tie(it, inserted) = f_query_engines.emplace(
+        std::tie(it, inserted) = state.query_engines.emplace(
             typeid(QueryEngineT), std::make_unique<QueryEngineT>());
       }
       CHECK(inserted);
+      PassTracer* tracer = PassTracer::Current();
+      PassTracer::ScopedSpan span(
+          tracer, PassTraceCategory::kQueryEngine,
+          tracer == nullptr ? "" : PassTracer::TypeName(typeid(QueryEngineT)),
+          [f] { return f->node_count(); });
+      span.AddArg("function_base", f->name());
       CHECK_OK(it->second->Populate(f).status());
+      ++state.query_engine_populations;
+    } else {
+      // Shared query engines listen for changes to `f` and lazily update only
+      // the affected nodes, so an existing engine is always safe to reuse.
+      ++state.query_engine_hits;
     }
     return dynamic_cast<QueryEngineT*>(it->second.get());
   }
@@ -214,83 +279,117 @@ class OptimizationContext {
         SharedQueryEngine<QueryEngineT>(f));
   }
 
-  std::vector<QueryEngine*> ListQueryEngines() {
-    std::vector<QueryEngine*> query_engines;
-    for (auto& [f, f_query_engines] : shared_query_engines_) {
-      query_engines.reserve(query_engines.size() + f_query_engines.size());
-      for (auto& [type_index, query_engine] : f_query_engines) {
-        query_engines.push_back(query_engine.get());
-      }
-    }
-    return query_engines;
-  }
+  std::vector<QueryEngine*> ListQueryEngines();
 
-  void Abandon(FunctionBase* f) {
-    shared_query_engines_.erase(f);
-    reverse_topo_sort_.erase(f);
-  }
+  void Abandon(FunctionBase* f);
 
   std::vector<Node*> ReverseTopoSort(FunctionBase* f);
   std::vector<Node*> TopoSort(FunctionBase* f);
 
- private:
-  const std::vector<Node*>& ReverseTopoSortReference(FunctionBase* f);
+  // Returns the cache counters accumulated over the lifetime of this context.
+  CacheStats cache_stats() const;
+
+  // Returns the subset of `fbs` the function-local pass `pass` may change
+  // within the current fixed-point run (see PassResults::fixed_point_run):
+  // all of them outside of a fixed-point run, and otherwise those which the
+  // pass has not run on without changing them since they last changed. A
+  // change made by a pass which is not function-local (as found in the
+  // invocations in `results`) may affect any function or proc, so it makes
+  // all of them eligible again.
+  std::vector<FunctionBase*> GetChangedFunctionBases(
+      const OptimizationPass* pass, absl::Span<FunctionBase* const> fbs,
+      const PassResults& results);
+
+  // Records that the function-local pass `pass` ran on `f`. May be called
+  // concurrently for different FunctionBases.
+  void RecordFunctionBaseRun(const OptimizationPass* pass, FunctionBase* f,
+                             const PassResults& results, bool changed);
+
+  // Returns the incremental verifier of `p`, creating it (and discarding the
+  // verifier of any other package) if necessary. Not thread-safe.
+  IncrementalVerifier& GetIncrementalVerifier(
+      Package* p, int64_t full_verification_interval);
 
-  class InvalidatingVector : public ChangeListener {
+ private:
+  // Counts the changes made to a FunctionBase.
+  class ChangeCounter : public ChangeListener {
    public:
-    InvalidatingVector(FunctionBase* f, std::vector<Node*> value = {})
-        : f_(f), storage_(std::move(value)) {
+    explicit ChangeCounter(FunctionBase* f) : f_(f) {
       f_->RegisterChangeListener(this);
     }
-    ~InvalidatingVector() override { f_->UnregisterChangeListener(this); }
+    ~ChangeCounter() override { f_->UnregisterChangeListener(this); }
 
-    InvalidatingVector(const InvalidatingVector&) = delete;
-    InvalidatingVector& operator=(const InvalidatingVector&) = delete;
+    int64_t count() const { return count_; }
+    void Increment() { ++count_; }
 
-    InvalidatingVector(InvalidatingVector&& other)
-        : f_(other.f_), storage_(std::move(other.storage_)) {
-      f_->RegisterChangeListener(this);
+    void NodeAdded(Node* node) override { ++count_; }
+    void NodeDeleted(Node* node) override { ++count_; }
+    void OperandChanged(Node* node, Node* old_operand,
+                        absl::Span<const int64_t> operand_nos) override {
+      ++count_;
     }
-    InvalidatingVector& operator=(InvalidatingVector&& other) {
-      if (f_ != nullptr) {
-        f_->UnregisterChangeListener(this);
-      }
-      f_ = other.f_;
-      storage_ = std::move(other.storage_);
-      if (f_ != nullptr) {
-        f_->RegisterChangeListener(this);
-      }
-      return *this;
-    }
-
-    std::vector<Node*>& operator*() { return storage_; }
-    const std::vector<Node*>& operator*() const { return storage_; }
-
-    std::vector<Node*>* operator->() { return &storage_; }
-    const std::vector<Node*>* operator->() const { return &storage_; }
-
-    void NodeAdded(Node*) override { storage_.clear(); }
-    void NodeDeleted(Node*) override { storage_.clear(); }
-    void OperandChanged(Node*, Node*, absl::Span<const int64_t>) override {
-      storage_.clear();
+    void OperandRemoved(Node* node, Node* old_operand) override { ++count_; }
+    void OperandAdded(Node* node) override { ++count_; }
+    void ReturnValueChanged(Function* function_base,
+                            Node* old_return_value) override {
+      ++count_;
     }
-    void OperandRemoved(Node*, Node*) override { storage_.clear(); }
-    void OperandAdded(Node*) override { storage_.clear(); }
-    void ReturnValueChanged(Function*, Node*) override { storage_.clear(); }
-    void NextStateElementChanged(Proc*, int64_t, Node*) override {
-      storage_.clear();
+    void NextStateElementChanged(Proc* proc, int64_t state_index,
+                                 Node* old_next_state_element) override {
+      ++count_;
     }
 
    private:
     FunctionBase* f_;
-    std::vector<Node*> storage_;
+    int64_t count_ = 0;
   };
-  absl::flat_hash_map<FunctionBase*, InvalidatingVector> reverse_topo_sort_;
 
-  absl::flat_hash_map<
-      FunctionBase*,
-      absl::flat_hash_map<std::type_index, std::shared_ptr<QueryEngine>>>
-      shared_query_engines_;
+  // The state of a FunctionBase when a pass last ran on it without changing
+  // it.
+  struct UnchangedRun {
+    int64_t fixed_point_run;
+    int64_t change_count;
+    int64_t package_epoch;
+  };
+
+  // Everything cached about a single FunctionBase. Only the lookup of this
+  // state is synchronized; the state itself may only be used by the thread
+  // which is currently running a pass on the FunctionBase.
+  struct FunctionState {
+    // Created on first use.
+    std::unique_ptr<IncrementalTopoSort> topo_sort;
+    absl::flat_hash_map<std::type_index, std::shared_ptr<QueryEngine>>
+        query_engines;
+    int64_t query_engine_hits = 0;
+    int64_t query_engine_populations = 0;
+    // Created on first use.
+    std::unique_ptr<ChangeCounter> change_counter;
+    absl::flat_hash_map<const OptimizationPass*, UnchangedRun> unchanged_runs;
+
+    CacheStats Stats() const;
+  };
+
+  FunctionState& GetFunctionState(FunctionBase* f);
+
+  const std::vector<Node*>& ReverseTopoSortReference(FunctionBase* f);
+
+  const bool incremental_topo_sort_;
+
+  mutable absl::Mutex mu_;
+  absl::flat_hash_map<FunctionBase*, std::unique_ptr<FunctionState>>
+      function_states_ ABSL_GUARDED_BY(mu_);
+  // Counters from abandoned FunctionBases.
+  CacheStats abandoned_stats_ ABSL_GUARDED_BY(mu_);
+
+  // Short names of the function-local passes which have run.
+  absl::flat_hash_set<std::string> function_local_pass_names_
+      ABSL_GUARDED_BY(mu_);
+  // Incremented whenever a pass which is not function-local changes the IR.
+  int64_t package_epoch_ ABSL_GUARDED_BY(mu_) = 0;
+  // The number of pass invocations accounted for in `package_epoch_`.
+  int64_t seen_invocations_ ABSL_GUARDED_BY(mu_) = 0;
+
+  std::unique_ptr<IncrementalVerifier> incremental_verifier_;
 };
 
 // Construct a query engine that forwards to the shared implementation from
@@ -307,12 +406,6 @@ MaybeOwnedForwardingQueryEngine<QueryEngineT> GetSharedQueryEngine(
       ctx.SharedQueryEngine<QueryEngineT>(f));
 }
 
-// An object containing information about the invocation of a pass (single call
-// to PassBase::Run).
-// Defines the pass types for optimizations which operate strictly on XLS IR
-// (i.e., xls::Package).
-using OptimizationPass = PassBase<Package, OptimizationPassOptions, PassResults,
-                                  OptimizationContext>;
 using OptimizationCompoundPass =
     CompoundPassBase<Package, OptimizationPassOptions, PassResults,
                      OptimizationContext>;
@@ -510,6 +603,15 @@ class OptimizationFunctionBasePass : public OptimizationPass {
   absl::StatusOr<bool> TransformNodesToFixedPoint(
       FunctionBase* f,
       std::function<absl::StatusOr<bool>(Node*)> simplify_f) const;
+
+  // Whether the pass reads and modifies only the function/proc it is run on,
+  // so that it may be run on several functions/procs of a package in parallel
+  // and skipped on those which are unchanged. Passes opt in by overriding this
+  // to return true, which requires that they:
+  //  - never look at other FunctionBases, e.g., by interpreting invokes;
+  //  - derive the names of new nodes only from assigned names, since node ids
+  //    (and hence generated names) are provisional during a parallel run.
+  virtual bool IsFunctionLocal() const { return false; }
 };
 
 // Abstract base class for passes operate on procs. The derived
@@ -535,6 +637,10 @@ class OptimizationProcPass : public OptimizationPass {
   virtual absl::StatusOr<bool> RunOnProcInternal(
       Proc* proc, const OptimizationPassOptions& options, PassResults* results,
       OptimizationContext& context) const = 0;
+
+  // Whether the pass reads and modifies only the proc it is run on. See
+  // OptimizationFunctionBasePass::IsFunctionLocal.
+  virtual bool IsFunctionLocal() const { return false; }
 };
 
 }  // namespace xls
@@ -32,16 +32,22 @@
 #include "absl/strings/str_format.h"
 #include "xls/common/casts.h"
 #include "xls/common/status/matchers.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/function.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/ir/node.h"
 #include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
 #include "xls/ir/package.h"
 #include "xls/ir/ram_rewrite.pb.h"
 #include "xls/ir/type.h"
+#include "xls/passes/constant_folding_pass.h"
+#include "xls/passes/dce_pass.h"
 #include "xls/passes/pass_base.h"
+#include "xls/passes/select_simplification_pass.h"
 
 namespace xls {
 namespace {
@@ -524,6 +530,274 @@ TEST(PassesTest, TestTransformNodesToFixedPointWhileRemovingNodes) {
               IsOkAndHolds(false));
 }
 
+// Rewrites every `add(a, b)` into `sub(a, neg(b))`, adding and removing nodes.
+class AddToSubPass : public OptimizationFunctionBasePass {
+ public:
+  AddToSubPass() : OptimizationFunctionBasePass("add_to_sub", "add to sub") {}
+
+ protected:
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* f, const OptimizationPassOptions& options,
+      PassResults* results, OptimizationContext& context) const override {
+    bool changed = false;
+    for (Node* node : context.TopoSort(f)) {
+      if (node->op() != Op::kAdd) {
+        continue;
+      }
+      XLS_ASSIGN_OR_RETURN(Node * neg,
+                           f->MakeNode<UnOp>(node->loc(), node->operand(1),
+                                             Op::kNeg));
+      XLS_RETURN_IF_ERROR(
+          node->ReplaceUsesWithNew<BinOp>(node->operand(0), neg, Op::kSub)
+              .status());
+      XLS_RETURN_IF_ERROR(f->RemoveNode(node));
+      changed = true;
+    }
+    return changed;
+  }
+
+  bool IsFunctionLocal() const override { return true; }
+};
+
+TEST(PassesTest, ParallelFunctionBasePassMatchesSerial) {
+  constexpr std::string_view kPackage = R"(
+package p
+
+fn f(x: bits[8], y: bits[8]) -> bits[8] {
+  add.1: bits[8] = add(x, y)
+  ret add.2: bits[8] = add(add.1, x)
+}
+
+fn g(x: bits[8]) -> bits[8] {
+  ret add.3: bits[8] = add(x, x)
+}
+
+fn h(x: bits[8]) -> bits[8] {
+  ret neg.4: bits[8] = neg(x)
+}
+
+fn i(x: bits[8], y: bits[8]) -> bits[8] {
+  add.5: bits[8] = add(x, y)
+  add.6: bits[8] = add(add.5, y)
+  ret add.7: bits[8] = add(add.6, add.5)
+}
+)";
+  auto run = [&](int64_t threads) -> absl::StatusOr<std::string> {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> p,
+                         Parser::ParsePackage(kPackage));
+    OptimizationPassOptions options;
+    options.function_base_threads = threads;
+    PassResults results;
+    OptimizationContext context;
+    XLS_ASSIGN_OR_RETURN(bool changed,
+                         AddToSubPass().Run(p.get(), options, &results,
+                                            context));
+    XLS_RET_CHECK(changed);
+    return p->DumpIr();
+  };
+  XLS_ASSERT_OK_AND_ASSIGN(std::string serial, run(1));
+  for (int64_t threads : {2, 4, 8}) {
+    EXPECT_THAT(run(threads), IsOkAndHolds(serial)) << threads << " threads";
+  }
+}
+
+TEST(PassesTest, ParallelPipelineWithInvokesMatchesSerial) {
+  // Constant folding interprets the invokes of `g` and `sel_index`, so it must
+  // not run while they are being optimized; the function-local passes may.
+  constexpr std::string_view kPackage = R"(
+package p
+
+fn g(x: bits[8]) -> bits[8] {
+  literal.1: bits[8] = literal(value=0)
+  add.2: bits[8] = add(x, literal.1)
+  ret neg.3: bits[8] = neg(add.2)
+}
+
+fn sel_index(x: bits[2]) -> bits[2] {
+  literal.4: bits[2] = literal(value=1)
+  ret add.5: bits[2] = add(x, literal.4)
+}
+
+fn f(x: bits[4], y: bits[4], s: bits[1], t: bits[2]) -> bits[8] {
+  literal.6: bits[8] = literal(value=3)
+  invoke.7: bits[8] = invoke(literal.6, to_apply=g)
+  zero_ext.8: bits[8] = zero_ext(x, new_bit_count=8)
+  zero_ext.9: bits[8] = zero_ext(y, new_bit_count=8)
+  my_sel: bits[8] = sel(s, cases=[zero_ext.8, zero_ext.9])
+  sel.10: bits[8] = sel(s, cases=[zero_ext.9, zero_ext.8])
+  invoke.11: bits[2] = invoke(t, to_apply=sel_index)
+  sel.12: bits[8] = sel(invoke.11, cases=[my_sel, sel.10, invoke.7, my_sel])
+  ret add.13: bits[8] = add(sel.12, invoke.7)
+}
+
+fn h(x: bits[8]) -> bits[8] {
+  invoke.14: bits[8] = invoke(x, to_apply=g)
+  ret invoke.15: bits[8] = invoke(invoke.14, to_apply=g)
+}
+)";
+  auto run = [&](int64_t threads) -> absl::StatusOr<std::string> {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> p,
+                         Parser::ParsePackage(kPackage));
+    OptimizationFixedPointCompoundPass pipeline("pipeline", "pipeline");
+    pipeline.Add<ConstantFoldingPass>();
+    pipeline.Add<SelectSimplificationPass>();
+    pipeline.Add<DeadCodeEliminationPass>();
+    OptimizationPassOptions options;
+    options.function_base_threads = threads;
+    PassResults results;
+    OptimizationContext context;
+    XLS_ASSIGN_OR_RETURN(bool changed,
+                         pipeline.Run(p.get(), options, &results, context));
+    XLS_RET_CHECK(changed);
+    return p->DumpIr();
+  };
+  XLS_ASSERT_OK_AND_ASSIGN(std::string serial, run(1));
+  for (int64_t threads : {2, 4, 8}) {
+    EXPECT_THAT(run(threads), IsOkAndHolds(serial)) << threads << " threads";
+  }
+}
+
+// Records the name of every function it runs on.
+class RecordNamePass : public OptimizationFunctionBasePass {
+ public:
+  explicit RecordNamePass(std::vector<std::string>* record)
+      : OptimizationFunctionBasePass("record_name", "record name"),
+        record_(record) {}
+
+ protected:
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* f, const OptimizationPassOptions& options,
+      PassResults* results, OptimizationContext& context) const override {
+    record_->push_back(f->name());
+    return false;
+  }
+
+  bool IsFunctionLocal() const override { return true; }
+
+ private:
+  std::vector<std::string>* record_;
+};
+
+// Removes a single `neg` from the return value of a function per run.
+class PeelNegPass : public OptimizationFunctionBasePass {
+ public:
+  PeelNegPass() : OptimizationFunctionBasePass("peel_neg", "peel neg") {}
+
+ protected:
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* fb, const OptimizationPassOptions& options,
+      PassResults* results, OptimizationContext& context) const override {
+    if (!fb->IsFunction()) {
+      return false;
+    }
+    Function* f = fb->AsFunctionOrDie();
+    Node* ret = f->return_value();
+    if (ret->op() != Op::kNeg) {
+      return false;
+    }
+    XLS_RETURN_IF_ERROR(f->set_return_value(ret->operand(0)));
+    XLS_RETURN_IF_ERROR(f->RemoveNode(ret));
+    return true;
+  }
+
+  bool IsFunctionLocal() const override { return true; }
+};
+
+TEST(PassesTest, FixedPointSkipsUnchangedFunctionBases) {
+  constexpr std::string_view kPackage = R"(
+package p
+
+fn f(x: bits[8]) -> bits[8] {
+  neg.1: bits[8] = neg(x)
+  neg.2: bits[8] = neg(neg.1)
+  ret neg.3: bits[8] = neg(neg.2)
+}
+
+fn g(x: bits[8]) -> bits[8] {
+  ret add.4: bits[8] = add(x, x)
+}
+)";
+  auto run = [&](bool skip_unchanged, std::vector<std::string>* record,
+                 PassResults* results) -> absl::StatusOr<std::string> {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> p,
+                         Parser::ParsePackage(kPackage));
+    OptimizationFixedPointCompoundPass fixed_point("fixed_point",
+                                                   "fixed point");
+    fixed_point.Add<RecordNamePass>(record);
+    fixed_point.Add<PeelNegPass>();
+    OptimizationPassOptions options;
+    options.skip_unchanged_function_bases = skip_unchanged;
+    OptimizationContext context;
+    XLS_ASSIGN_OR_RETURN(bool changed,
+                         fixed_point.Run(p.get(), options, results, context));
+    XLS_RET_CHECK(changed);
+    return p->DumpIr();
+  };
+
+  std::vector<std::string> record;
+  PassResults results;
+  XLS_ASSERT_OK_AND_ASSIGN(std::string unskipped_ir,
+                           run(/*skip_unchanged=*/false, &record, &results));
+  EXPECT_THAT(record, ElementsAre("f", "g", "f", "g", "f", "g", "f", "g"));
+  EXPECT_EQ(results.function_base_skips, 0);
+
+  // After the first iteration only `f` changes, so neither pass reruns on `g`.
+  record.clear();
+  results = PassResults();
+  EXPECT_THAT(run(/*skip_unchanged=*/true, &record, &results),
+              IsOkAndHolds(unskipped_ir));
+  EXPECT_THAT(record, ElementsAre("f", "g", "f", "f", "f"));
+  EXPECT_EQ(results.function_base_skips, 6);
+  EXPECT_EQ(results.function_base_runs, 10);
+}
+
+// Package pass which adds a function named `name` if there is none.
+class AddFunctionOncePass : public OptimizationPass {
+ public:
+  explicit AddFunctionOncePass(std::string_view name)
+      : OptimizationPass("add_function_once", "add function once"),
+        name_(name) {}
+
+  absl::StatusOr<bool> RunInternal(
+      Package* package, const OptimizationPassOptions& options,
+      PassResults* results, OptimizationContext& context) const override {
+    if (package->GetFunction(name_).ok()) {
+      return false;
+    }
+    XLS_RETURN_IF_ERROR(
+        Parser::ParseFunction(
+            absl::StrFormat("fn %s() -> bits[32] {\n"
+                            "  ret literal.100: bits[32] = literal(value=42)\n"
+                            "}\n",
+                            name_),
+            package)
+            .status());
+    return true;
+  }
+
+ private:
+  std::string name_;
+};
+
+TEST(PassesTest, PackagePassChangeResetsSkippedFunctionBases) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> p,
+                           Parser::ParsePackage(kInvariantTesterPackage));
+  std::vector<std::string> record;
+  OptimizationFixedPointCompoundPass fixed_point("fixed_point", "fixed point");
+  fixed_point.Add<RecordNamePass>(&record);
+  fixed_point.Add<AddFunctionOncePass>("extra");
+  PassResults results;
+  OptimizationContext context;
+  ASSERT_THAT(
+      fixed_point.Run(p.get(), OptimizationPassOptions(), &results, context),
+      IsOkAndHolds(true));
+  // The change made by the package pass in the first iteration may affect
+  // every function, so `foo` is revisited in the second one although it is
+  // unchanged.
+  EXPECT_THAT(record, ElementsAre("foo", "foo", "extra"));
+  EXPECT_EQ(results.function_base_skips, 0);
+}
+
 TEST(RamDatastructuresTest, AddrWidthCorrect) {
   RamConfig config{.kind = RamKind::kAbstract, .depth = 2};
   EXPECT_EQ(config.addr_width(), 1);
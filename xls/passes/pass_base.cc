@@ -15,6 +15,7 @@
 #include "xls/passes/pass_base.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <string_view>
@@ -28,15 +29,24 @@
 
 namespace xls {
 
+int64_t NewFixedPointRunId() {
+  static std::atomic<int64_t> next_id = 1;
+  return next_id++;
+}
+
 void CompoundPassResult::AddSinglePassResult(std::string_view pass_name,
                                              bool changed,
                                              absl::Duration duration,
-                                             const TransformMetrics& metrics) {
+                                             const TransformMetrics& metrics,
+                                             int64_t function_base_runs,
+                                             int64_t function_base_skips) {
   SinglePassResult& result = pass_results_[pass_name];
   ++result.run_count;
   result.changed_count += changed ? 1 : 0;
   result.duration = result.duration + duration;
   result.metrics = result.metrics + metrics;
+  result.function_base_run_count += function_base_runs;
+  result.function_base_skipped_count += function_base_skips;
 }
 
 void CompoundPassResult::AccumulateCompoundPassResult(
@@ -48,6 +58,10 @@ void CompoundPassResult::AccumulateCompoundPassResult(
     pass_result.run_count += other_pass_result.run_count;
     pass_result.duration = pass_result.duration + other_pass_result.duration;
     pass_result.metrics = pass_result.metrics + other_pass_result.metrics;
+    pass_result.function_base_run_count +=
+        other_pass_result.function_base_run_count;
+    pass_result.function_base_skipped_count +=
+        other_pass_result.function_base_skipped_count;
   }
 }
 
@@ -67,9 +81,16 @@ std::string CompoundPassResult::ToString() const {
   for (const std::string& name : pass_names) {
     SinglePassResult result = pass_results_.at(name);
     absl::StrAppendFormat(
-        &s, "  %15s: changed %d/%d, total time %s, metrics %s\n", name,
+        &s, "  %15s: changed %d/%d, total time %s, metrics %s", name,
         result.changed_count, result.run_count, FormatDuration(result.duration),
         result.metrics.ToString());
+    if (result.function_base_skipped_count > 0) {
+      absl::StrAppendFormat(&s, ", skipped %d/%d functions/procs",
+                            result.function_base_skipped_count,
+                            result.function_base_skipped_count +
+                                result.function_base_run_count);
+    }
+    s += "\n";
   }
   return s;
 }
@@ -79,6 +100,10 @@ PassResultProto SinglePassResult::ToProto() const {
   res.set_run_count(run_count);
   res.set_changed_count(changed_count);
   *res.mutable_metrics() = metrics.ToProto();
+  if (function_base_run_count > 0 || function_base_skipped_count > 0) {
+    res.set_function_base_run_count(function_base_run_count);
+    res.set_function_base_skipped_count(function_base_skipped_count);
+  }
 
   absl::Duration rem;
   int64_t s = absl::IDivDuration(duration, absl::Seconds(1), &rem);
@@ -25,6 +25,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/log/vlog_is_on.h"
@@ -44,6 +45,7 @@
 #include "xls/ir/package.h"
 #include "xls/passes/pass_metrics.pb.h"
 #include "xls/passes/pass_pipeline.pb.h"
+#include "xls/passes/pass_trace.h"
 
 namespace xls {
 
@@ -74,6 +76,10 @@ struct PassOptionsBase {
   // If true, record metrics about runtime, number of nodes affected and other
   // information as appropriate for each pass run.
   bool record_metrics = false;
+
+  // If non-null, a span is recorded in this tracer for each pass invocation
+  // and the work nested within it. Not owned.
+  PassTracer* tracer = nullptr;
 };
 
 // An object containing information about the invocation of a pass (single call
@@ -99,6 +105,9 @@ struct SinglePassResult {
   TransformMetrics metrics{};
   // Total duration of the running of the pass.
   absl::Duration duration;
+  // How many times the pass ran on, or skipped, a single function or proc.
+  int64_t function_base_run_count = 0;
+  int64_t function_base_skipped_count = 0;
 
   PassResultProto ToProto() const;
 };
@@ -114,7 +123,9 @@ class CompoundPassResult {
   // Add the results of a single run of a pass.
   void AddSinglePassResult(std::string_view pass_name, bool changed,
                            absl::Duration duration,
-                           const TransformMetrics& metrics);
+                           const TransformMetrics& metrics,
+                           int64_t function_base_runs = 0,
+                           int64_t function_base_skips = 0);
 
   // Accumulates the statistics in `other` into this one.
   void AccumulateCompoundPassResult(const CompoundPassResult& other);
@@ -137,8 +148,23 @@ struct PassResults {
 
   // The aggregate results of all actual invocations performed.
   CompoundPassResult aggregate_results;
+
+  // The number of times function-local passes ran on a single function or
+  // proc, and the number of times they skipped one because it was unchanged
+  // since the pass last ran on it without changing it.
+  int64_t function_base_runs = 0;
+  int64_t function_base_skips = 0;
+
+  // Identifies the run of the innermost fixed-point compound pass in progress,
+  // or zero if there is none. Within such a run, function-local passes may
+  // skip the functions and procs they cannot change.
+  int64_t fixed_point_run = 0;
 };
 
+// Returns a new, process-wide unique, non-zero identifier for a run of a
+// fixed-point compound pass.
+int64_t NewFixedPointRunId();
+
 // Base class for all compiler passes. Template parameters:
 //
 //   IrT : The data type that the pass operates on (e.g., xls::Package). The
@@ -419,8 +445,18 @@ class FixedPointCompoundPassBase
     bool local_changed = true;
     int64_t iteration_count = 0;
     CompoundPassResult aggregate_result;
+    const int64_t enclosing_fixed_point_run = results->fixed_point_run;
+    results->fixed_point_run = NewFixedPointRunId();
+    absl::Cleanup restore_fixed_point_run = [&] {
+      results->fixed_point_run = enclosing_fixed_point_run;
+    };
     while (local_changed) {
       ++iteration_count;
+      PassTracer::ScopedSpan iteration_span(
+          options.tracer, PassTraceCategory::kIteration,
+          absl::StrFormat("%s iteration %d", this->short_name(),
+                          iteration_count),
+          [ir] { return ir->GetNodeCount(); });
       XLS_ASSIGN_OR_RETURN(
           CompoundPassResult compound_result,
           (CompoundPassBase<IrT, OptionsT, ResultsT, ContextT...>::RunNested(
@@ -429,6 +465,7 @@ class FixedPointCompoundPassBase
           _ << "Running pass #" << results->invocations.size() << ": "
             << this->long_name() << " [short: " << this->short_name() << "]");
       local_changed = compound_result.changed();
+      iteration_span.AddArg("changed", local_changed ? "true" : "false");
       aggregate_result.AccumulateCompoundPassResult(compound_result);
     }
     VLOG(1) << absl::StreamFormat(
@@ -459,6 +496,9 @@ CompoundPassBase<IrT, OptionsT, ResultsT, ContextT...>::RunNested(
                   invariant_checker_ptrs_.end());
   auto run_invariant_checkers =
       [&](std::string_view str_context) -> absl::Status {
+    PassTracer::ScopedSpan span(options.tracer,
+                                PassTraceCategory::kInvariantChecker,
+                                "invariant checkers");
     for (const auto& checker : checkers) {
       absl::Status status = checker->Run(ir, options, results, context...);
       if (!status.ok()) {
@@ -484,6 +524,8 @@ CompoundPassBase<IrT, OptionsT, ResultsT, ContextT...>::RunNested(
     if (VLOG_IS_ON(1) || options.record_metrics) {
       before_metrics = ir->transform_metrics();
     }
+    const int64_t function_base_runs_before = results->function_base_runs;
+    const int64_t function_base_skips_before = results->function_base_skips;
 
     if (!pass->IsCompound() && options.bisect_limit &&
         results->invocations.size() >= options.bisect_limit) {
@@ -506,6 +548,9 @@ CompoundPassBase<IrT, OptionsT, ResultsT, ContextT...>::RunNested(
     std::string ir_before = ir->DumpIr();
 #endif
     absl::Time start = absl::Now();
+    PassTracer::ScopedSpan pass_span(options.tracer, PassTraceCategory::kPass,
+                                     pass->short_name(),
+                                     [ir] { return ir->GetNodeCount(); });
     bool pass_changed;
     if (pass->IsCompound()) {
       XLS_ASSIGN_OR_RETURN(
@@ -522,6 +567,8 @@ CompoundPassBase<IrT, OptionsT, ResultsT, ContextT...>::RunNested(
                            pass->Run(ir, options, results, context...));
     }
     absl::Duration duration = absl::Now() - start;
+    pass_span.AddArg("changed", pass_changed ? "true" : "false");
+    pass_span.End();
 #ifdef DEBUG
     std::string ir_after = ir->DumpIr();
     if (pass_changed) {
@@ -559,8 +606,10 @@ CompoundPassBase<IrT, OptionsT, ResultsT, ContextT...>::RunNested(
       }
     }
 
-    aggregate_result.AddSinglePassResult(pass->short_name(), pass_changed,
-                                         duration, pass_metrics);
+    aggregate_result.AddSinglePassResult(
+        pass->short_name(), pass_changed, duration, pass_metrics,
+        results->function_base_runs - function_base_runs_before,
+        results->function_base_skips - function_base_skips_before);
 
     // Only run the verifiers if the pass changed anything.
     if (pass_changed) {
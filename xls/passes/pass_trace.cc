@@ -0,0 +1,256 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/pass_trace.h"
+
+#include <cxxabi.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>  // NOLINT
+#include <string>
+#include <string_view>
+#include <thread>  // NOLINT
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/file/filesystem.h"
+
+namespace xls {
+namespace {
+
+// The tracer of the innermost open span on this thread.
+thread_local PassTracer* current_tracer = nullptr;
+
+int64_t PeakRssBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return -1;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  // Linux reports the maximum resident set size in kilobytes.
+  return int64_t{usage.ru_maxrss} * 1024;
+#endif
+}
+
+std::string JsonString(std::string_view s) {
+  std::string result = "\"";
+  for (char c : s) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          absl::StrAppendFormat(&result, "\\u%04x", c);
+        } else {
+          result += c;
+        }
+    }
+  }
+  result += "\"";
+  return result;
+}
+
+}  // namespace
+
+std::string_view PassTraceCategoryToString(PassTraceCategory category) {
+  switch (category) {
+    case PassTraceCategory::kPass:
+      return "pass";
+    case PassTraceCategory::kIteration:
+      return "iteration";
+    case PassTraceCategory::kFunctionBase:
+      return "function_base";
+    case PassTraceCategory::kInvariantChecker:
+      return "invariant_checker";
+    case PassTraceCategory::kQueryEngine:
+      return "query_engine";
+  }
+}
+
+PassTracer::ScopedSpan::ScopedSpan(
+    PassTracer* tracer, PassTraceCategory category, std::string_view name,
+    absl::AnyInvocable<int64_t() const> node_count)
+    : tracer_(tracer) {
+  if (tracer_ == nullptr) {
+    return;
+  }
+  enclosing_tracer_ = current_tracer;
+  current_tracer = tracer_;
+  node_count_ = std::move(node_count);
+  span_.name = std::string(name);
+  span_.category = category;
+  if (node_count_ != nullptr) {
+    span_.nodes_before = node_count_();
+  }
+  start_ = absl::Now();
+}
+
+void PassTracer::ScopedSpan::AddArg(std::string_view key,
+                                    std::string_view value) {
+  if (tracer_ == nullptr) {
+    return;
+  }
+  span_.args.push_back({std::string(key), std::string(value)});
+}
+
+void PassTracer::ScopedSpan::End() {
+  if (tracer_ == nullptr) {
+    return;
+  }
+  absl::Time end = absl::Now();
+  span_.start = start_ - tracer_->creation_time_;
+  span_.duration = end - start_;
+  if (node_count_ != nullptr) {
+    span_.nodes_after = node_count_();
+  }
+  span_.peak_rss_bytes = PeakRssBytes();
+  current_tracer = enclosing_tracer_;
+  tracer_->AddSpan(std::move(span_));
+  tracer_ = nullptr;
+}
+
+/* static */ PassTracer* PassTracer::Current() { return current_tracer; }
+
+/* static */ std::string PassTracer::TypeName(const std::type_info& type) {
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+  if (status != 0 || demangled == nullptr) {
+    return type.name();
+  }
+  std::string result(demangled);
+  std::free(demangled);
+  return result;
+}
+
+void PassTracer::AddSpan(Span span) {
+  absl::MutexLock lock(&mu_);
+  auto [it, inserted] = thread_numbers_.try_emplace(std::this_thread::get_id(),
+                                                    thread_numbers_.size());
+  span.thread = it->second;
+  spans_.push_back(std::move(span));
+}
+
+std::vector<PassTracer::Span> PassTracer::spans() const {
+  std::vector<Span> spans;
+  {
+    absl::MutexLock lock(&mu_);
+    spans = spans_;
+  }
+  // Spans are recorded when they end, so enclosing spans are recorded after
+  // the spans they contain.
+  std::stable_sort(spans.begin(), spans.end(),
+                   [](const Span& a, const Span& b) {
+                     return std::make_tuple(a.thread, a.start, -a.duration) <
+                            std::make_tuple(b.thread, b.start, -b.duration);
+                   });
+  return spans;
+}
+
+std::string PassTracer::ToChromeTraceJson() const {
+  std::vector<Span> all_spans = spans();
+  std::vector<std::string> events;
+  events.reserve(all_spans.size());
+  int64_t thread_count = 0;
+  for (const Span& span : all_spans) {
+    thread_count = std::max(thread_count, span.thread + 1);
+    std::vector<std::string> args;
+    if (span.nodes_before >= 0) {
+      args.push_back(absl::StrFormat("\"nodes_before\":%d", span.nodes_before));
+      args.push_back(absl::StrFormat("\"nodes_after\":%d", span.nodes_after));
+    }
+    if (span.peak_rss_bytes >= 0) {
+      args.push_back(
+          absl::StrFormat("\"peak_rss_bytes\":%d", span.peak_rss_bytes));
+    }
+    for (const auto& [key, value] : span.args) {
+      args.push_back(absl::StrCat(JsonString(key), ":", JsonString(value)));
+    }
+    events.push_back(absl::StrFormat(
+        "{\"name\":%s,\"cat\":%s,\"ph\":\"X\",\"ts\":%d,\"dur\":%d,"
+        "\"pid\":0,\"tid\":%d,\"args\":{%s}}",
+        JsonString(span.name),
+        JsonString(PassTraceCategoryToString(span.category)),
+        absl::ToInt64Microseconds(span.start),
+        absl::ToInt64Microseconds(span.duration), span.thread,
+        absl::StrJoin(args, ",")));
+  }
+  for (int64_t thread = 0; thread < thread_count; ++thread) {
+    events.push_back(absl::StrFormat(
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,"
+        "\"args\":{\"name\":\"thread %d\"}}",
+        thread, thread));
+  }
+  return absl::StrCat("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n",
+                      absl::StrJoin(events, ",\n"), "\n]}\n");
+}
+
+absl::Status PassTracer::WriteChromeTrace(
+    const std::filesystem::path& path) const {
+  return SetFileContents(path, ToChromeTraceJson());
+}
+
+std::string PassTracer::Summary(int64_t max_rows) const {
+  struct Total {
+    int64_t count = 0;
+    absl::Duration duration;
+  };
+  absl::flat_hash_map<std::pair<PassTraceCategory, std::string>, Total> totals;
+  for (const Span& span : spans()) {
+    Total& total = totals[{span.category, span.name}];
+    ++total.count;
+    total.duration += span.duration;
+  }
+  std::vector<std::pair<std::pair<PassTraceCategory, std::string>, Total>>
+      rows(totals.begin(), totals.end());
+  std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+    return std::tie(b.second.duration, a.first) <
+           std::tie(a.second.duration, b.first);
+  });
+  std::string s = "Pass trace summary (inclusive time):\n";
+  for (int64_t i = 0; i < rows.size() && i < max_rows; ++i) {
+    const auto& [key, total] = rows[i];
+    absl::StrAppendFormat(&s, "  %-17s %-40s %6d spans, total %s\n",
+                          PassTraceCategoryToString(key.first), key.second,
+                          total.count, absl::FormatDuration(total.duration));
+  }
+  return s;
+}
+
+}  // namespace xls
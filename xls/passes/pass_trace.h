@@ -0,0 +1,148 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_PASS_TRACE_H_
+#define XLS_PASSES_PASS_TRACE_H_
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <string>
+#include <string_view>
+#include <thread>  // NOLINT
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace xls {
+
+// The kind of work covered by a span of a pass trace.
+enum class PassTraceCategory : int8_t {
+  // A run of a pass (compound or not) on the whole IR.
+  kPass,
+  // One iteration of a fixed-point compound pass.
+  kIteration,
+  // A run of a pass on a single function, proc or block.
+  kFunctionBase,
+  // A run of the invariant checkers of a compound pass.
+  kInvariantChecker,
+  // The population of a query engine.
+  kQueryEngine,
+};
+
+std::string_view PassTraceCategoryToString(PassTraceCategory category);
+
+// Records a hierarchical trace of a pass pipeline run: a timed span for each
+// pass invocation, each fixed-point iteration, each function/proc a
+// function-local pass runs on, and each query engine population. Spans record
+// the node count of the IR they cover at their start and end, and the peak
+// resident set size of the process at their end.
+//
+// The trace can be written in the Chrome trace event format, which
+// chrome://tracing and https://ui.perfetto.dev display as nested spans per
+// thread. Spans may be recorded from several threads at once.
+class PassTracer {
+ public:
+  struct Span {
+    std::string name;
+    PassTraceCategory category;
+    // The thread which recorded the span. Threads are numbered from zero in
+    // the order in which they first recorded a span.
+    int64_t thread;
+    // The start of the span relative to the creation of the tracer.
+    absl::Duration start;
+    absl::Duration duration;
+    // Node counts of the IR covered by the span, or -1 if not recorded.
+    int64_t nodes_before = -1;
+    int64_t nodes_after = -1;
+    // Peak resident set size of the process at the end of the span, or -1 if
+    // unknown.
+    int64_t peak_rss_bytes = -1;
+    // Additional annotations such as whether a pass changed the IR.
+    std::vector<std::pair<std::string, std::string>> args;
+  };
+
+  // Records a span from its construction until it is destroyed or End is
+  // called. All methods are no-ops if `tracer` is null, so spans cost next to
+  // nothing when tracing is disabled. `node_count`, if given, is called at the
+  // start and end of the span.
+  //
+  // While a span is open, PassTracer::Current returns its tracer on the
+  // thread which created it.
+  class ScopedSpan {
+   public:
+    ScopedSpan(PassTracer* tracer, PassTraceCategory category,
+               std::string_view name,
+               absl::AnyInvocable<int64_t() const> node_count = nullptr);
+    ~ScopedSpan() { End(); }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    bool active() const { return tracer_ != nullptr; }
+
+    void AddArg(std::string_view key, std::string_view value);
+
+    // Ends the span. Later calls have no effect.
+    void End();
+
+   private:
+    PassTracer* tracer_;
+    PassTracer* enclosing_tracer_ = nullptr;
+    absl::AnyInvocable<int64_t() const> node_count_;
+    Span span_;
+    absl::Time start_;
+  };
+
+  PassTracer() : creation_time_(absl::Now()) {}
+
+  // Returns the tracer of the innermost open span on the calling thread, or
+  // null if there is none. This lets code with no access to the pass options,
+  // such as query engines, add spans to the trace of the pass running them.
+  static PassTracer* Current();
+
+  // Returns a readable name for the given type, e.g. "xls::TernaryQueryEngine".
+  static std::string TypeName(const std::type_info& type);
+
+  // Returns the recorded spans ordered by thread and start time, enclosing
+  // spans before the spans they contain.
+  std::vector<Span> spans() const;
+
+  // Returns the trace in the Chrome trace event (JSON) format.
+  std::string ToChromeTraceJson() const;
+  absl::Status WriteChromeTrace(const std::filesystem::path& path) const;
+
+  // Returns a table of the inclusive time spent in each (category, name)
+  // pair, in descending order of time, limited to `max_rows` rows.
+  std::string Summary(int64_t max_rows = 30) const;
+
+ private:
+  void AddSpan(Span span);
+
+  const absl::Time creation_time_;
+  mutable absl::Mutex mu_;
+  std::vector<Span> spans_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::thread::id, int64_t> thread_numbers_
+      ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_PASS_TRACE_H_
@@ -0,0 +1,143 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/pass_trace.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+#include "xls/passes/dce_pass.h"
+#include "xls/passes/optimization_pass.h"
+#include "xls/passes/pass_base.h"
+#include "xls/passes/ternary_query_engine.h"
+
+namespace xls {
+namespace {
+
+using ::testing::AllOf;
+using ::testing::Contains;
+using ::testing::Field;
+using ::testing::HasSubstr;
+using ::testing::Not;
+using ::testing::Pair;
+
+class PassTraceTest : public IrTestBase {};
+
+// A pass which populates a shared query engine on every function.
+class QueryingPass : public OptimizationFunctionBasePass {
+ public:
+  QueryingPass() : OptimizationFunctionBasePass("querying", "Querying") {}
+
+ protected:
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* f, const OptimizationPassOptions& options,
+      PassResults* results, OptimizationContext& context) const override {
+    context.SharedQueryEngine<TernaryQueryEngine>(f);
+    return false;
+  }
+};
+
+TEST_F(PassTraceTest, RecordsNestedSpans) {
+  auto p = CreatePackage();
+  for (const char* name : {"f", "g"}) {
+    FunctionBuilder fb(name, p.get());
+    BValue x = fb.Param("x", p->GetBitsType(8));
+    fb.Add(x, fb.Literal(UBits(1, 8)));
+    XLS_ASSERT_OK(fb.BuildWithReturnValue(x).status());
+  }
+
+  OptimizationCompoundPass pipeline("pipeline", "Pipeline");
+  pipeline.Add<QueryingPass>();
+  pipeline.Add<OptimizationFixedPointCompoundPass>("fixedpoint", "Fixedpoint")
+      ->Add<DeadCodeEliminationPass>();
+
+  PassTracer tracer;
+  OptimizationPassOptions options;
+  options.tracer = &tracer;
+  PassResults results;
+  OptimizationContext context;
+  XLS_ASSERT_OK(pipeline.Run(p.get(), options, &results, context).status());
+  EXPECT_EQ(PassTracer::Current(), nullptr);
+
+  std::vector<PassTracer::Span> spans = tracer.spans();
+  EXPECT_THAT(spans,
+              Contains(AllOf(
+                  Field(&PassTracer::Span::name, "dce"),
+                  Field(&PassTracer::Span::category, PassTraceCategory::kPass),
+                  Field(&PassTracer::Span::nodes_before, 6),
+                  Field(&PassTracer::Span::nodes_after, 4))));
+  EXPECT_THAT(spans, Contains(AllOf(Field(&PassTracer::Span::name,
+                                          "fixedpoint iteration 2"),
+                                    Field(&PassTracer::Span::category,
+                                          PassTraceCategory::kIteration))));
+  EXPECT_THAT(
+      spans,
+      Contains(AllOf(
+          Field(&PassTracer::Span::name, "g"),
+          Field(&PassTracer::Span::category, PassTraceCategory::kFunctionBase),
+          Field(&PassTracer::Span::args, Contains(Pair("pass", "dce"))))));
+  EXPECT_THAT(
+      spans,
+      Contains(AllOf(
+          Field(&PassTracer::Span::name, "xls::TernaryQueryEngine"),
+          Field(&PassTracer::Span::category, PassTraceCategory::kQueryEngine),
+          Field(&PassTracer::Span::args,
+                Contains(Pair("function_base", "f"))))));
+
+  // Enclosing spans come before the spans they contain.
+  for (int64_t i = 1; i < spans.size(); ++i) {
+    if (spans[i].category == PassTraceCategory::kQueryEngine) {
+      EXPECT_EQ(spans[i - 1].category, PassTraceCategory::kFunctionBase);
+    }
+  }
+
+  EXPECT_THAT(tracer.Summary(), HasSubstr("function_base"));
+}
+
+TEST_F(PassTraceTest, ChromeTraceJson) {
+  PassTracer tracer;
+  {
+    PassTracer::ScopedSpan outer(&tracer, PassTraceCategory::kPass,
+                                 "a \"quoted\" pass", [] { return 3; });
+    EXPECT_EQ(PassTracer::Current(), &tracer);
+    outer.AddArg("changed", "true");
+    PassTracer::ScopedSpan inner(nullptr, PassTraceCategory::kPass, "ignored");
+    EXPECT_FALSE(inner.active());
+  }
+  EXPECT_EQ(PassTracer::Current(), nullptr);
+
+  std::string json = tracer.ToChromeTraceJson();
+  EXPECT_THAT(json, HasSubstr("\"traceEvents\":["));
+  EXPECT_THAT(json, HasSubstr("\"name\":\"a \\\"quoted\\\" pass\""));
+  EXPECT_THAT(json, HasSubstr("\"cat\":\"pass\",\"ph\":\"X\""));
+  EXPECT_THAT(json, HasSubstr("\"nodes_before\":3,\"nodes_after\":3"));
+  EXPECT_THAT(json, HasSubstr("\"changed\":\"true\""));
+  EXPECT_THAT(json, HasSubstr("\"thread_name\""));
+  EXPECT_THAT(json, Not(HasSubstr("ignored")));
+}
+
+}  // namespace
+}  // namespace xls
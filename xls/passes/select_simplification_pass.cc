@@ -900,6 +900,13 @@ absl::StatusOr<bool> MaybeReorderSelect(Node* node,
   Select* sel = node->As<Select>();
   Node* selector = sel->selector();
 
+  // Interpreting an invoke would read its callee, which this pass may be
+  // modifying concurrently in another thread.
+  if (selector->Is<Invoke>() &&
+      selector->package()->IsUnderConcurrentModification()) {
+    return false;
+  }
+
   // TODO(epastor): It would be nice to handle default values, but doing this
   // without adding more cases requires proving that all cases that end up
   // defaulted are equivalent... or else deciding how many cases we can add
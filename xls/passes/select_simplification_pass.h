@@ -42,6 +42,8 @@ class SelectSimplificationPassBase : public OptimizationFunctionBasePass {
       FunctionBase* f, const OptimizationPassOptions& options,
       PassResults* results, OptimizationContext& context) const override;
 
+  bool IsFunctionLocal() const override { return true; }
+
   bool range_analysis_;
 };
 
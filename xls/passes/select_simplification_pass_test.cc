@@ -1574,6 +1574,57 @@ TEST_P(SelectSimplificationPassTest, ReorderableSelectWithOperandReuse) {
                                          m::Param("a"), m::Param("b")}));
 }
 
+TEST_P(SelectSimplificationPassTest, ReorderableSelectOnInvoke) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackage(R"(
+     package test
+
+     fn add_one(x: bits[2]) -> bits[2] {
+       one: bits[2] = literal(value=1)
+       ret add: bits[2] = add(x, one)
+     }
+
+     top fn f(p1: bits[2], a: bits[32], b: bits[32], c: bits[32],
+              d: bits[32]) -> bits[32] {
+       selector: bits[2] = invoke(p1, to_apply=add_one)
+       ret sel: bits[32] = sel(selector, cases=[a, b, c, d])
+     }
+  )"));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, p->GetFunction("f"));
+
+  ASSERT_THAT(Run(f), IsOkAndHolds(true));
+  EXPECT_THAT(f->return_value(),
+              m::Select(m::Param("p1"), {m::Param("b"), m::Param("c"),
+                                         m::Param("d"), m::Param("a")}));
+}
+
+TEST_P(SelectSimplificationPassTest,
+       SelectOnInvokeNotReorderedDuringConcurrentModification) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackage(R"(
+     package test
+
+     fn add_one(x: bits[2]) -> bits[2] {
+       one: bits[2] = literal(value=1)
+       ret add: bits[2] = add(x, one)
+     }
+
+     top fn f(p1: bits[2], a: bits[32], b: bits[32], c: bits[32],
+              d: bits[32]) -> bits[32] {
+       selector: bits[2] = invoke(p1, to_apply=add_one)
+       ret sel: bits[32] = sel(selector, cases=[a, b, c, d])
+     }
+  )"));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, p->GetFunction("f"));
+
+  p->BeginConcurrentModification({f});
+  absl::StatusOr<bool> changed = Run(f);
+  p->EndConcurrentModification({f});
+  XLS_ASSERT_OK(changed.status());
+  EXPECT_THAT(f->return_value(),
+              m::Select(m::Invoke(m::Param("p1")),
+                        {m::Param("a"), m::Param("b"), m::Param("c"),
+                         m::Param("d")}));
+}
+
 TEST_P(SelectSimplificationPassTest, UnchangedBitsSelSqueeze) {
   auto p = CreatePackage();
   FunctionBuilder fb(TestName(), p.get());
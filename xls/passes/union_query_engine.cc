@@ -17,6 +17,7 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -30,10 +31,12 @@
 #include "xls/data_structures/leaf_type_tree.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/bits_ops.h"
+#include "xls/ir/function_base.h"
 #include "xls/ir/interval_set.h"
 #include "xls/ir/node.h"
 #include "xls/ir/ternary.h"
 #include "xls/ir/type.h"
+#include "xls/passes/pass_trace.h"
 #include "xls/passes/predicate_state.h"
 #include "xls/passes/query_engine.h"
 
@@ -83,7 +86,13 @@ bool UnownedUnionQueryEngine::IsAllZeros(Node* n) const {
 absl::StatusOr<ReachedFixpoint> UnownedUnionQueryEngine::Populate(
     FunctionBase* f) {
   ReachedFixpoint result = ReachedFixpoint::Unchanged;
+  PassTracer* tracer = PassTracer::Current();
   for (QueryEngine* engine : engines_) {
+    PassTracer::ScopedSpan span(
+        tracer, PassTraceCategory::kQueryEngine,
+        tracer == nullptr ? "" : PassTracer::TypeName(typeid(*engine)),
+        [f] { return f->node_count(); });
+    span.AddArg("function_base", f->name());
     XLS_ASSIGN_OR_RETURN(ReachedFixpoint rf, engine->Populate(f));
     // Unchanged is the top of the lattice so it's an identity
     if (result == ReachedFixpoint::Unchanged) {
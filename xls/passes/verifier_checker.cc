@@ -25,6 +25,11 @@ absl::Status VerifierChecker::Run(Package* p,
                                   const OptimizationPassOptions& options,
                                   PassResults* results,
                                   OptimizationContext& context) const {
+  if (options.incremental_verification) {
+    return context
+        .GetIncrementalVerifier(p, options.full_verification_interval)
+        .Verify();
+  }
   return VerifyPackage(p);
 }
 
@@ -22,7 +22,9 @@
 
 namespace xls {
 
-// Invariant checker which just runs xls::Verifier.
+// Invariant checker which just runs xls::Verifier, or with the
+// `incremental_verification` option re-verifies only what changed since it
+// last ran.
 class VerifierChecker : public OptimizationInvariantChecker {
  public:
   absl::Status Run(Package* p, const OptimizationPassOptions& options,
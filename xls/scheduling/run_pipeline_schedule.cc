@@ -20,6 +20,7 @@
 #include <optional>
 #include <random>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -36,6 +37,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/status/ret_check.h"
@@ -191,6 +193,22 @@ absl::StatusOr<int64_t> ComputeCriticalPath(
                              delay_estimator);
 }
 
+// Logs the LP solves performed by `scheduler` over a binary search.
+void LogSolveStats(std::string_view search, int64_t probes,
+                   const SDCScheduler::SolveStats& before,
+                   const SDCScheduler::SolveStats& after) {
+  const int64_t solves = after.solves - before.solves;
+  const absl::Duration solve_time = after.solve_time - before.solve_time;
+  VLOG(2) << absl::StreamFormat(
+      "Searching for the minimum %s took %d probes, %d LP solves (%d "
+      "warm-started) in %s (%s per probe)",
+      search, probes, solves,
+      after.warm_started_solves - before.warm_started_solves,
+      absl::FormatDuration(solve_time),
+      absl::FormatDuration(probes > 0 ? solve_time / probes
+                                      : absl::ZeroDuration()));
+}
+
 // Returns the minimum clock period in picoseconds for which it is feasible to
 // schedule the function into a pipeline with the given number of stages. If
 // `target_clock_period_ps` is specified, will not try to check lower clock
@@ -246,9 +264,12 @@ absl::StatusOr<int64_t> FindMinimumClockPeriod(
   // Don't waste time explaining infeasibility for the failing points in the
   // search.
   failure_behavior.explain_infeasibility = false;
+  const SDCScheduler::SolveStats initial_stats = scheduler.solve_stats();
+  int64_t probes = 0;
   int64_t min_clk_period_ps = BinarySearchMinTrue(
       optimistic_clk_period_ps, pessimistic_clk_period_ps,
       [&](int64_t clk_period_ps) {
+        ++probes;
         return scheduler
             .Schedule(pipeline_stages, clk_period_ps, failure_behavior,
                       /*check_feasibility=*/true, worst_case_throughput)
@@ -256,6 +277,7 @@ absl::StatusOr<int64_t> FindMinimumClockPeriod(
       },
       BinarySearchAssumptions::kEndKnownTrue);
   VLOG(4) << "minimum clock period = " << min_clk_period_ps;
+  LogSolveStats("clock period", probes, initial_stats, scheduler.solve_stats());
 
   return min_clk_period_ps;
 }
@@ -305,9 +327,12 @@ absl::StatusOr<int64_t> FindMinimumWorstCaseThroughput(
   // Don't waste time explaining infeasibility for the failing points in the
   // search.
   failure_behavior.explain_infeasibility = false;
+  const SDCScheduler::SolveStats initial_stats = scheduler.solve_stats();
+  int64_t probes = 0;
   int64_t min_worst_case_throughput = BinarySearchMinTrue(
       1, pessimistic_worst_case_throughput,
       [&](int64_t worst_case_throughput) {
+        ++probes;
         return scheduler
             .Schedule(pipeline_stages, clock_period_ps, failure_behavior,
                       /*check_feasibility=*/true,
@@ -316,6 +341,8 @@ absl::StatusOr<int64_t> FindMinimumWorstCaseThroughput(
       },
       BinarySearchAssumptions::kEndKnownTrue);
   VLOG(4) << "minimum worst-case throughput = " << min_worst_case_throughput;
+  LogSolveStats("worst-case throughput", probes, initial_stats,
+                scheduler.solve_stats());
 
   return min_worst_case_throughput;
 }
@@ -24,6 +24,7 @@
 #include <variant>
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
@@ -34,6 +35,8 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -189,6 +192,94 @@ ComputeCombinationalDelayConstraints(
   return result;
 }
 
+// Returns the nonbasic status for a variable or constraint with the given
+// bounds, preferring `previous` if it is still consistent with them.
+math_opt::BasisStatus NonbasicStatus(
+    double lower_bound, double upper_bound,
+    std::optional<math_opt::BasisStatus> previous) {
+  if (lower_bound == upper_bound) {
+    return math_opt::BasisStatus::kFixedValue;
+  }
+  const bool has_lower_bound = std::isfinite(lower_bound);
+  const bool has_upper_bound = std::isfinite(upper_bound);
+  if (has_upper_bound &&
+      (previous == math_opt::BasisStatus::kAtUpperBound || !has_lower_bound)) {
+    return math_opt::BasisStatus::kAtUpperBound;
+  }
+  if (has_lower_bound) {
+    return math_opt::BasisStatus::kAtLowerBound;
+  }
+  return math_opt::BasisStatus::kFree;
+}
+
+// Adapts `basis`, the basis of a previous solve, to the current state of
+// `model`. Variables and constraints which were deleted since are dropped, and
+// new constraints enter the basis (i.e., start out slack). The nonbasic
+// statuses are made consistent with the current bounds, and the number of basic
+// constraints is adjusted so that the basis has exactly one basic variable or
+// constraint per constraint. Returns std::nullopt if that is not possible.
+std::optional<math_opt::Basis> AdaptBasis(const math_opt::Model& model,
+                                          const math_opt::Basis& basis) {
+  math_opt::Basis result;
+  int64_t basic_count = 0;
+  for (const math_opt::Variable& var : model.Variables()) {
+    std::optional<math_opt::BasisStatus> previous;
+    if (auto it = basis.variable_status.find(var);
+        it != basis.variable_status.end()) {
+      previous = it->second;
+    }
+    math_opt::BasisStatus status =
+        previous == math_opt::BasisStatus::kBasic
+            ? math_opt::BasisStatus::kBasic
+            : NonbasicStatus(var.lower_bound(), var.upper_bound(), previous);
+    if (status == math_opt::BasisStatus::kBasic) {
+      ++basic_count;
+    }
+    result.variable_status.emplace(var, status);
+  }
+  const std::vector<math_opt::LinearConstraint> constraints =
+      model.LinearConstraints();
+  for (const math_opt::LinearConstraint& constraint : constraints) {
+    std::optional<math_opt::BasisStatus> previous;
+    if (auto it = basis.constraint_status.find(constraint);
+        it != basis.constraint_status.end()) {
+      previous = it->second;
+    }
+    math_opt::BasisStatus status =
+        !previous.has_value() || previous == math_opt::BasisStatus::kBasic
+            ? math_opt::BasisStatus::kBasic
+            : NonbasicStatus(constraint.lower_bound(),
+                             constraint.upper_bound(), previous);
+    if (status == math_opt::BasisStatus::kBasic) {
+      ++basic_count;
+    }
+    result.constraint_status.emplace(constraint, status);
+  }
+
+  // Deleting a tight constraint leaves a surplus basic variable, and deleting a
+  // slack one leaves a deficit; rebalance using the constraints' statuses.
+  const int64_t target = constraints.size();
+  for (const math_opt::LinearConstraint& constraint : constraints) {
+    if (basic_count == target) {
+      break;
+    }
+    math_opt::BasisStatus& status = result.constraint_status.at(constraint);
+    if (basic_count > target && status == math_opt::BasisStatus::kBasic) {
+      status = NonbasicStatus(constraint.lower_bound(),
+                              constraint.upper_bound(), std::nullopt);
+      --basic_count;
+    } else if (basic_count < target &&
+               status != math_opt::BasisStatus::kBasic) {
+      status = math_opt::BasisStatus::kBasic;
+      ++basic_count;
+    }
+  }
+  if (basic_count != target) {
+    return std::nullopt;
+  }
+  return result;
+}
+
 }  // namespace
 
 SDCSchedulingModel::SDCSchedulingModel(
@@ -314,9 +405,15 @@ absl::Status SDCSchedulingModel::AddBackedgeConstraints(
     VLOG(2) << "Setting backedge constraint (II): "
             << absl::StrFormat("cycle[%s] - cycle[%s] < %d", next->GetName(),
                                state->name(), II);
+    // The name leaves out the II, since SetWorstCaseThroughput may change the
+    // bound in place.
     backedge_constraint_.emplace(
         std::make_pair(state_read, next),
-        DiffLessThanConstraint(next, state_read, II, "backedge"));
+        model_.AddLinearConstraint(
+            cycle_var_.at(next) - cycle_var_.at(state_read) <=
+                static_cast<double>(II - 1),
+            absl::StrFormat("backedge:%s-%s<II", next->GetName(),
+                            state_read->GetName())));
   }
 
   return absl::OkStatus();
@@ -524,6 +621,11 @@ absl::StatusOr<ScheduleCycleMap> SDCSchedulingModel::ExtractResult(
 }
 
 void SDCSchedulingModel::SetClockPeriod(int64_t clock_period_ps) {
+  if (clock_period_ps_ == clock_period_ps) {
+    return;
+  }
+  clock_period_ps_ = clock_period_ps;
+
   absl::flat_hash_map<Node*, std::vector<Node*>> prev_delay_constraints =
       std::move(delay_constraints_);
   delay_constraints_ = ComputeCombinationalDelayConstraints(
@@ -578,6 +680,16 @@ absl::Status SDCSchedulingModel::SetWorstCaseThroughput(
   }
 
   proc->SetInitiationInterval(worst_case_throughput);
+  if (worst_case_throughput > 0 && !backedge_constraint_.empty() &&
+      !shared_backedge_slack_.has_value()) {
+    // Only the bound changes, so update the existing constraints in place
+    // rather than replacing them; this lets the solver reuse its basis.
+    for (auto& [nodes, constraint] : backedge_constraint_) {
+      model_.set_upper_bound(constraint,
+                             static_cast<double>(worst_case_throughput - 1));
+    }
+    return absl::OkStatus();
+  }
   for (auto& [nodes, constraint] : backedge_constraint_) {
     model_.DeleteLinearConstraint(constraint);
   }
@@ -964,8 +1076,7 @@ absl::Status SDCScheduler::BuildError(
            math_opt::TerminationReason::kInfeasibleOrUnbounded)) {
     XLS_RETURN_IF_ERROR(model_.AddSlackVariables(
         failure_behavior.infeasible_per_state_backedge_slack_pool));
-    XLS_ASSIGN_OR_RETURN(math_opt::SolveResult result_with_slack,
-                         solver_->Solve());
+    XLS_ASSIGN_OR_RETURN(math_opt::SolveResult result_with_slack, Solve());
     if (result_with_slack.termination.reason ==
             math_opt::TerminationReason::kOptimal ||
         result_with_slack.termination.reason ==
@@ -985,10 +1096,51 @@ absl::Status SDCScheduler::BuildError(
                    math_opt::EnumToString(result.termination.reason)));
 }
 
+absl::StatusOr<math_opt::SolveResult> SDCScheduler::Solve() {
+  const absl::Time start = absl::Now();
+  absl::StatusOr<math_opt::SolveResult> result;
+  std::optional<math_opt::Basis> initial_basis;
+  if (basis_.has_value()) {
+    initial_basis = AdaptBasis(model_.UnderlyingModel(), *basis_);
+  }
+  if (initial_basis.has_value()) {
+    math_opt::SolveArguments args;
+    // Presolve would transform the problem and discard the basis.
+    args.parameters.presolve = math_opt::Emphasis::kOff;
+    args.model_parameters.initial_basis = *std::move(initial_basis);
+    result = solver_->Solve(args);
+    if (result.ok()) {
+      ++solve_stats_.warm_started_solves;
+    } else {
+      VLOG(3) << "Warm-started solve failed; retrying from scratch: "
+              << result.status();
+    }
+  }
+  if (!result.ok()) {
+    result = solver_->Solve();
+  }
+  ++solve_stats_.solves;
+  solve_stats_.solve_time += absl::Now() - start;
+  if (result.ok() && !result->solutions.empty() &&
+      result->solutions.front().basis.has_value()) {
+    basis_ = result->solutions.front().basis;
+  }
+  return result;
+}
+
 absl::StatusOr<ScheduleCycleMap> SDCScheduler::Schedule(
     std::optional<int64_t> pipeline_stages, int64_t clock_period_ps,
     SchedulingFailureBehavior failure_behavior, bool check_feasibility,
     std::optional<int64_t> worst_case_throughput) {
+  const SolveStats initial_stats = solve_stats_;
+  absl::Cleanup log_stats = [&] {
+    VLOG(3) << absl::StreamFormat(
+        "SDC schedule at %dps: %d solves (%d warm-started) in %s",
+        clock_period_ps, solve_stats_.solves - initial_stats.solves,
+        solve_stats_.warm_started_solves - initial_stats.warm_started_solves,
+        absl::FormatDuration(solve_stats_.solve_time -
+                             initial_stats.solve_time));
+  };
   model_.SetClockPeriod(clock_period_ps);
   if (worst_case_throughput.has_value()) {
     XLS_RETURN_IF_ERROR(model_.SetWorstCaseThroughput(*worst_case_throughput));
@@ -1000,7 +1152,7 @@ absl::StatusOr<ScheduleCycleMap> SDCScheduler::Schedule(
     model_.MinimizePipelineLength();
     XLS_ASSIGN_OR_RETURN(
         const math_opt::SolveResult result_with_minimized_pipeline_length,
-        solver_->Solve());
+        Solve());
     if (result_with_minimized_pipeline_length.termination.reason !=
         math_opt::TerminationReason::kOptimal) {
       return BuildError(result_with_minimized_pipeline_length,
@@ -1019,7 +1171,7 @@ absl::StatusOr<ScheduleCycleMap> SDCScheduler::Schedule(
     model_.SetObjective();
   }
 
-  XLS_ASSIGN_OR_RETURN(math_opt::SolveResult result, solver_->Solve());
+  XLS_ASSIGN_OR_RETURN(math_opt::SolveResult result, Solve());
   if (result.termination.reason == math_opt::TerminationReason::kOptimal ||
       (check_feasibility &&
        result.termination.reason == math_opt::TerminationReason::kFeasible)) {
@@ -27,6 +27,7 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xls/estimators/delay_model/delay_estimator.h"
 #include "xls/ir/function_base.h"
@@ -66,6 +67,9 @@ class SDCSchedulingModel {
   absl::Status AddSendThenRecvConstraint(
       const SendThenRecvConstraint& constraint);
 
+  // Updates the timing constraints for the given clock period, adding and
+  // removing only the constraints which differ from the previous clock period
+  // so that the solver can reuse its previous basis.
   void SetClockPeriod(int64_t clock_period_ps);
 
   absl::Status SetWorstCaseThroughput(int64_t worst_case_throughput);
@@ -179,8 +183,10 @@ class SDCSchedulingModel {
   // data-dependence graph.
   operations_research::math_opt::Variable cycle_at_sinknode_;
 
-  // A cache of the delay constraints.
+  // A cache of the delay constraints, and the clock period they were computed
+  // for.
   absl::flat_hash_map<Node*, std::vector<Node*>> delay_constraints_;
+  std::optional<int64_t> clock_period_ps_;
 
   absl::flat_hash_map<std::pair<Node*, Node*>,
                       operations_research::math_opt::LinearConstraint>
@@ -216,6 +222,14 @@ class SDCScheduler {
   using DelayMap = absl::flat_hash_map<Node*, int64_t>;
 
  public:
+  // Statistics about the LP solves performed by the scheduler.
+  struct SolveStats {
+    int64_t solves = 0;
+    // Number of solves which were started from the basis of a previous solve.
+    int64_t warm_started_solves = 0;
+    absl::Duration solve_time = absl::ZeroDuration();
+  };
+
   static absl::StatusOr<std::unique_ptr<SDCScheduler>> Create(
       FunctionBase* f, const DelayEstimator& delay_estimator);
 
@@ -251,6 +265,9 @@ class SDCScheduler {
       bool check_feasibility = false,
       std::optional<int64_t> worst_case_throughput = std::nullopt);
 
+  // Returns cumulative statistics over all calls to Schedule.
+  const SolveStats& solve_stats() const { return solve_stats_; }
+
  private:
   SDCScheduler(FunctionBase* f, absl::flat_hash_set<Node*> dead_after_synthesis,
                DelayMap delay_map);
@@ -260,11 +277,21 @@ class SDCScheduler {
       const operations_research::math_opt::SolveResult& result,
       SchedulingFailureBehavior failure_behavior);
 
+  // Solves the current model, warm-starting from the basis of the last
+  // successful solve if there is one.
+  absl::StatusOr<operations_research::math_opt::SolveResult> Solve();
+
   FunctionBase* f_;
   DelayMap delay_map_;
 
   SDCSchedulingModel model_;
   std::unique_ptr<operations_research::math_opt::IncrementalSolver> solver_;
+
+  // The basis of the last solve which found one. Successive probes of the
+  // clock period (or worst-case throughput) only change a few constraints, so
+  // this is usually close to optimal for the next solve.
+  std::optional<operations_research::math_opt::Basis> basis_;
+  SolveStats solve_stats_;
 };
 
 }  // namespace xls
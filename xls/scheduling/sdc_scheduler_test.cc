@@ -0,0 +1,128 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/sdc_scheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/value.h"
+#include "xls/scheduling/scheduling_options.h"
+
+namespace xls {
+namespace {
+
+class SDCSchedulerTest : public IrTestBase {
+ protected:
+  static int64_t PipelineLength(const ScheduleCycleMap& cycle_map) {
+    int64_t last_stage = 0;
+    for (const auto& [node, cycle] : cycle_map) {
+      last_stage = std::max(last_stage, cycle);
+    }
+    return last_stage + 1;
+  }
+};
+
+TEST_F(SDCSchedulerTest, ReschedulingMatchesFreshScheduler) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(32));
+  BValue y = fb.Param("y", p->GetBitsType(32));
+  BValue value = x;
+  for (int64_t i = 0; i < 12; ++i) {
+    value = fb.Add(fb.Negate(value), i % 2 == 0 ? y : x);
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  TestDelayEstimator delay_estimator;
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<SDCScheduler> scheduler,
+                           SDCScheduler::Create(f, delay_estimator));
+  for (int64_t clock_period_ps : {24, 6, 3, 12, 4, 4, 2, 5}) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        ScheduleCycleMap cycle_map,
+        scheduler->Schedule(/*pipeline_stages=*/std::nullopt, clock_period_ps,
+                            SchedulingFailureBehavior()));
+
+    XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<SDCScheduler> fresh_scheduler,
+                             SDCScheduler::Create(f, delay_estimator));
+    XLS_ASSERT_OK_AND_ASSIGN(
+        ScheduleCycleMap fresh_cycle_map,
+        fresh_scheduler->Schedule(/*pipeline_stages=*/std::nullopt,
+                                  clock_period_ps,
+                                  SchedulingFailureBehavior()));
+    EXPECT_EQ(PipelineLength(cycle_map), PipelineLength(fresh_cycle_map))
+        << "clock period: " << clock_period_ps << "ps";
+    for (Node* node : f->nodes()) {
+      for (Node* operand : node->operands()) {
+        EXPECT_LE(cycle_map.at(operand), cycle_map.at(node));
+      }
+    }
+  }
+  // Each call solves once to find the minimum pipeline length and once to
+  // minimize register usage, reusing the basis of earlier solves.
+  EXPECT_EQ(scheduler->solve_stats().solves, 16);
+  EXPECT_GT(scheduler->solve_stats().warm_started_solves, 0);
+}
+
+TEST_F(SDCSchedulerTest, WorstCaseThroughputSearchIsWarmStarted) {
+  auto p = CreatePackage();
+  TokenlessProcBuilder pb(TestName(), "tkn", p.get());
+  BValue state = pb.StateElement("state", Value(UBits(0, 32)));
+  BValue next = state;
+  for (int64_t i = 0; i < 6; ++i) {
+    next = pb.Negate(next);
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc, pb.Build({next}));
+
+  TestDelayEstimator delay_estimator;
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<SDCScheduler> scheduler,
+                           SDCScheduler::Create(proc, delay_estimator));
+  XLS_ASSERT_OK(scheduler->AddConstraints({BackedgeConstraint()}));
+
+  // A backedge spanning six operations cannot be scheduled within a single
+  // cycle at a 2ps clock, but fits once the throughput is relaxed.
+  SchedulingFailureBehavior failure_behavior;
+  failure_behavior.explain_infeasibility = false;
+  EXPECT_FALSE(scheduler
+                   ->Schedule(/*pipeline_stages=*/3, /*clock_period_ps=*/2,
+                              failure_behavior, /*check_feasibility=*/true,
+                              /*worst_case_throughput=*/1)
+                   .ok());
+  XLS_EXPECT_OK(scheduler
+                    ->Schedule(/*pipeline_stages=*/3, /*clock_period_ps=*/2,
+                               failure_behavior, /*check_feasibility=*/true,
+                               /*worst_case_throughput=*/3)
+                    .status());
+  EXPECT_FALSE(scheduler
+                   ->Schedule(/*pipeline_stages=*/3, /*clock_period_ps=*/2,
+                              failure_behavior, /*check_feasibility=*/true,
+                              /*worst_case_throughput=*/2)
+                   .ok());
+  EXPECT_EQ(scheduler->solve_stats().solves, 3);
+  EXPECT_GT(scheduler->solve_stats().warm_started_solves, 0);
+}
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,474 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/tools/channel_value_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>  // NOLINT
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+#include "xls/ir/value_utils.h"
+#include "xls/jit/llvm_type_converter.h"
+#include "xls/jit/orc_jit.h"
+#include "xls/jit/type_layout.h"
+#include "xls/jit/type_layout.pb.h"
+#include "xls/tools/channel_value_file.pb.h"
+
+namespace xls {
+namespace {
+
+// Size of the fixed part of the file (the magic string and the header size)
+// and of the header of each chunk (the channel index and value count).
+constexpr int64_t kPrefixBytes = 16;
+constexpr int64_t kChunkHeaderBytes = 16;
+
+int64_t PaddedSize(int64_t size) {
+  return RoundUpToNearest(size, kChannelValueFileAlignment);
+}
+
+uint64_t LoadUint64(const uint8_t* data) {
+  uint64_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+void StoreUint64(uint64_t value, std::ofstream& stream) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Appends the number of bytes each leaf of `type` is read from when decoding
+// its native layout.
+void AppendLeafByteCounts(Type* type, std::vector<int64_t>& byte_counts) {
+  if (type->IsBits()) {
+    byte_counts.push_back(
+        CeilOfRatio(type->AsBitsOrDie()->bit_count(), int64_t{8}));
+  } else if (type->IsToken()) {
+    byte_counts.push_back(0);
+  } else if (type->IsTuple()) {
+    for (Type* element_type : type->AsTupleOrDie()->element_types()) {
+      AppendLeafByteCounts(element_type, byte_counts);
+    }
+  } else {
+    CHECK(type->IsArray());
+    for (int64_t i = 0; i < type->AsArrayOrDie()->size(); ++i) {
+      AppendLeafByteCounts(type->AsArrayOrDie()->element_type(), byte_counts);
+    }
+  }
+}
+
+// Returns the layout described by `proto`, checking that values can be
+// decoded without reading outside of the `size` bytes of each value.
+absl::StatusOr<TypeLayout> ParseLayout(const TypeLayoutProto& proto,
+                                       Package* package) {
+  XLS_ASSIGN_OR_RETURN(Type * type, Parser::ParseType(proto.type(), package));
+  std::vector<int64_t> byte_counts;
+  AppendLeafByteCounts(type, byte_counts);
+  if (byte_counts.size() != proto.elements_size() || proto.size() < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Invalid layout for type %s", proto.type()));
+  }
+  for (int64_t i = 0; i < proto.elements_size(); ++i) {
+    const ElementLayoutProto& element = proto.elements(i);
+    if (element.offset() < 0 || element.data_size() < 0 ||
+        element.padded_size() < element.data_size() ||
+        element.offset() >
+            proto.size() - std::max(element.padded_size(), byte_counts[i])) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Invalid layout for type %s", proto.type()));
+    }
+  }
+  return TypeLayout::FromProto(proto, package);
+}
+
+}  // namespace
+
+absl::StatusOr<std::vector<TypeLayout>> GetNativeTypeLayouts(
+    absl::Span<Type* const> types) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<OrcJit> orc_jit, OrcJit::Create());
+  XLS_ASSIGN_OR_RETURN(llvm::DataLayout data_layout,
+                       orc_jit->CreateDataLayout());
+  LlvmTypeConverter type_converter(orc_jit->GetContext(), data_layout);
+  std::vector<TypeLayout> layouts;
+  layouts.reserve(types.size());
+  for (Type* type : types) {
+    layouts.push_back(type_converter.CreateTypeLayout(type));
+  }
+  return layouts;
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<ChannelValueFileWriter>>
+ChannelValueFileWriter::Create(
+    const std::filesystem::path& path,
+    absl::Span<const ChannelValueFileChannel> channels) {
+  ChannelValueFileHeaderProto header;
+  for (const ChannelValueFileChannel& channel : channels) {
+    ChannelValueFileHeaderProto::Channel* channel_proto =
+        header.add_channels();
+    channel_proto->set_name(channel.name);
+    *channel_proto->mutable_layout() = channel.layout.ToProto();
+  }
+  std::string serialized_header;
+  XLS_RET_CHECK(header.SerializeToString(&serialized_header));
+
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    return absl::InternalError(absl::StrFormat(
+        "Unable to open %s for writing: %s", path.string(), strerror(errno)));
+  }
+  auto writer = absl::WrapUnique(new ChannelValueFileWriter(
+      std::move(stream),
+      std::vector<ChannelValueFileChannel>(channels.begin(), channels.end())));
+  XLS_RET_CHECK_EQ(writer->channel_indices_.size(), channels.size())
+      << "Channel names must be unique";
+  writer->stream_.write(kChannelValueFileMagic.data(),
+                        kChannelValueFileMagic.size());
+  StoreUint64(serialized_header.size(), writer->stream_);
+  writer->stream_.write(serialized_header.data(), serialized_header.size());
+  writer->Pad(serialized_header.size());
+  if (!writer->stream_) {
+    return absl::InternalError(
+        absl::StrFormat("Unable to write %s", path.string()));
+  }
+  return writer;
+}
+
+ChannelValueFileWriter::ChannelValueFileWriter(
+    std::ofstream stream, std::vector<ChannelValueFileChannel> channels)
+    : stream_(std::move(stream)),
+      channels_(std::move(channels)),
+      buffers_(channels_.size()),
+      buffered_counts_(channels_.size(), 0) {
+  for (int64_t i = 0; i < channels_.size(); ++i) {
+    channel_indices_.emplace(channels_[i].name, i);
+  }
+}
+
+ChannelValueFileWriter::~ChannelValueFileWriter() {
+  if (!closed_) {
+    absl::Status status = Close();
+    LOG_IF(ERROR, !status.ok()) << status;
+  }
+}
+
+absl::StatusOr<int64_t> ChannelValueFileWriter::GetChannelIndex(
+    std::string_view name) const {
+  auto it = channel_indices_.find(name);
+  if (it == channel_indices_.end()) {
+    return absl::NotFoundError(
+        absl::StrFormat("No channel named `%s` in channel-value file", name));
+  }
+  return it->second;
+}
+
+absl::Status ChannelValueFileWriter::Write(int64_t channel_index,
+                                           const Value& value) {
+  XLS_RET_CHECK(!closed_);
+  XLS_RET_CHECK_LT(channel_index, channels_.size());
+  const TypeLayout& layout = channels_[channel_index].layout;
+  if (!ValueConformsToType(value, layout.type())) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Channel `%s` expects values to have type %s, got: %s",
+        channels_[channel_index].name, layout.type()->ToString(),
+        value.ToString()));
+  }
+  std::vector<uint8_t>& buffer = buffers_[channel_index];
+  buffer.resize(buffer.size() + layout.size());
+  layout.ValueToNativeLayout(value, buffer.data() + buffer.size() -
+                                        layout.size());
+  ++buffered_counts_[channel_index];
+  if (buffer.size() >= kChunkBytes) {
+    return FlushChannel(channel_index);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ChannelValueFileWriter::WriteRaw(int64_t channel_index,
+                                              const uint8_t* data,
+                                              int64_t count) {
+  XLS_RET_CHECK(!closed_);
+  XLS_RET_CHECK_LT(channel_index, channels_.size());
+  std::vector<uint8_t>& buffer = buffers_[channel_index];
+  buffer.insert(buffer.end(), data,
+                data + count * channels_[channel_index].layout.size());
+  buffered_counts_[channel_index] += count;
+  if (buffer.size() >= kChunkBytes) {
+    return FlushChannel(channel_index);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ChannelValueFileWriter::FlushChannel(int64_t channel_index) {
+  if (buffered_counts_[channel_index] == 0) {
+    return absl::OkStatus();
+  }
+  std::vector<uint8_t>& buffer = buffers_[channel_index];
+  StoreUint64(channel_index, stream_);
+  StoreUint64(buffered_counts_[channel_index], stream_);
+  stream_.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+  Pad(buffer.size());
+  if (!stream_) {
+    return absl::InternalError("Unable to write channel-value file");
+  }
+  buffer.clear();
+  buffered_counts_[channel_index] = 0;
+  return absl::OkStatus();
+}
+
+void ChannelValueFileWriter::Pad(int64_t size) {
+  static constexpr char kZeros[kChannelValueFileAlignment] = {};
+  stream_.write(kZeros, PaddedSize(size) - size);
+}
+
+absl::Status ChannelValueFileWriter::Close() {
+  XLS_RET_CHECK(!closed_);
+  closed_ = true;
+  for (int64_t i = 0; i < channels_.size(); ++i) {
+    XLS_RETURN_IF_ERROR(FlushChannel(i));
+  }
+  stream_.close();
+  if (!stream_) {
+    return absl::InternalError("Unable to close channel-value file");
+  }
+  return absl::OkStatus();
+}
+
+ChannelValueCursor::ChannelValueCursor(const TypeLayout* layout,
+                                       absl::Span<const Chunk> chunks,
+                                       int64_t count)
+    : layout_(layout), chunks_(chunks), remaining_(count) {
+  Normalize();
+}
+
+void ChannelValueCursor::Normalize() {
+  while (chunk_index_ < chunks_.size() &&
+         index_in_chunk_ == chunks_[chunk_index_].count) {
+    ++chunk_index_;
+    index_in_chunk_ = 0;
+  }
+}
+
+Value ChannelValueCursor::Peek() const {
+  return layout_->NativeLayoutToValue(PeekRaw());
+}
+
+const uint8_t* ChannelValueCursor::PeekRaw() const {
+  DCHECK(!empty());
+  return chunks_[chunk_index_].data + index_in_chunk_ * layout_->size();
+}
+
+int64_t ChannelValueCursor::contiguous_count() const {
+  DCHECK(!empty());
+  return chunks_[chunk_index_].count - index_in_chunk_;
+}
+
+void ChannelValueCursor::Advance(int64_t count) {
+  CHECK_LE(count, remaining_);
+  remaining_ -= count;
+  while (count > 0) {
+    int64_t step = std::min(count, contiguous_count());
+    index_in_chunk_ += step;
+    count -= step;
+    Normalize();
+  }
+}
+
+std::optional<Value> ChannelValueCursor::Next() {
+  if (empty()) {
+    return std::nullopt;
+  }
+  Value value = Peek();
+  Advance();
+  return value;
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<ChannelValueFileReader>>
+ChannelValueFileReader::Open(const std::filesystem::path& path,
+                             Package* package) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return absl::NotFoundError(
+        absl::StrFormat("Unable to open %s: %s", path.string(),
+                        strerror(errno)));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < kPrefixBytes) {
+    close(fd);
+    return absl::InvalidArgumentError(
+        absl::StrFormat("%s is not a channel-value file", path.string()));
+  }
+  void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return absl::InternalError(
+        absl::StrFormat("Unable to map %s: %s", path.string(),
+                        strerror(errno)));
+  }
+  auto reader =
+      absl::WrapUnique(new ChannelValueFileReader(mapping, st.st_size));
+  XLS_RETURN_IF_ERROR(reader->Index(package))
+      << absl::StrFormat("while reading %s", path.string());
+  return reader;
+}
+
+ChannelValueFileReader::~ChannelValueFileReader() {
+  munmap(mapping_, size_);
+}
+
+absl::Status ChannelValueFileReader::Index(Package* package) {
+  const uint8_t* data = static_cast<const uint8_t*>(mapping_);
+  auto malformed = [] {
+    return absl::InvalidArgumentError("Malformed channel-value file");
+  };
+  if (std::string_view(reinterpret_cast<const char*>(data),
+                       kChannelValueFileMagic.size()) !=
+      kChannelValueFileMagic) {
+    return malformed();
+  }
+  uint64_t header_size = LoadUint64(data + kChannelValueFileMagic.size());
+  if (header_size > size_ - kPrefixBytes) {
+    return malformed();
+  }
+  ChannelValueFileHeaderProto header;
+  if (!header.ParseFromArray(data + kPrefixBytes, header_size)) {
+    return malformed();
+  }
+  for (const ChannelValueFileHeaderProto::Channel& channel :
+       header.channels()) {
+    XLS_ASSIGN_OR_RETURN(TypeLayout layout,
+                         ParseLayout(channel.layout(), package));
+    channels_.push_back(ChannelValueFileChannel{.name = channel.name(),
+                                                .layout = std::move(layout)});
+  }
+  chunks_.resize(channels_.size());
+  value_counts_.resize(channels_.size(), 0);
+
+  int64_t offset = kPrefixBytes + PaddedSize(header_size);
+  while (offset < size_) {
+    if (size_ - offset < kChunkHeaderBytes) {
+      return malformed();
+    }
+    uint64_t channel_index = LoadUint64(data + offset);
+    uint64_t count = LoadUint64(data + offset + sizeof(uint64_t));
+    offset += kChunkHeaderBytes;
+    if (channel_index >= channels_.size()) {
+      return malformed();
+    }
+    int64_t element_size = channels_[channel_index].layout.size();
+    if (count > std::numeric_limits<int64_t>::max() / std::max(element_size,
+                                                               int64_t{1}) ||
+        count * element_size > size_ - offset) {
+      return malformed();
+    }
+    chunks_[channel_index].push_back(ChannelValueCursor::Chunk{
+        .data = data + offset, .count = static_cast<int64_t>(count)});
+    value_counts_[channel_index] += count;
+    offset += PaddedSize(count * element_size);
+  }
+  return absl::OkStatus();
+}
+
+ChannelValueCursor ChannelValueFileReader::GetCursor(
+    int64_t channel_index) const {
+  return ChannelValueCursor(&channels_[channel_index].layout,
+                            chunks_[channel_index],
+                            value_counts_[channel_index]);
+}
+
+absl::StatusOr<ChannelValueCursor> ChannelValueFileReader::GetCursor(
+    std::string_view name) const {
+  for (int64_t i = 0; i < channels_.size(); ++i) {
+    if (channels_[i].name == name) {
+      return GetCursor(i);
+    }
+  }
+  return absl::NotFoundError(
+      absl::StrFormat("No channel named `%s` in channel-value file", name));
+}
+
+absl::Status WriteChannelValuesToFile(
+    const std::filesystem::path& path,
+    const absl::btree_map<std::string, std::vector<Value>>& channel_values) {
+  Package package("channel_values");
+  std::vector<Type*> types;
+  for (const auto& [_, values] : channel_values) {
+    types.push_back(values.empty() ? package.GetTupleType({})
+                                   : package.GetTypeForValue(values.front()));
+  }
+  XLS_ASSIGN_OR_RETURN(std::vector<TypeLayout> layouts,
+                       GetNativeTypeLayouts(types));
+  std::vector<ChannelValueFileChannel> channels;
+  for (const auto& [name, _] : channel_values) {
+    channels.push_back(ChannelValueFileChannel{
+        .name = name, .layout = std::move(layouts[channels.size()])});
+  }
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<ChannelValueFileWriter> writer,
+                       ChannelValueFileWriter::Create(path, channels));
+  int64_t channel_index = 0;
+  for (const auto& [_, values] : channel_values) {
+    for (const Value& value : values) {
+      XLS_RETURN_IF_ERROR(writer->Write(channel_index, value));
+    }
+    ++channel_index;
+  }
+  return writer->Close();
+}
+
+absl::StatusOr<absl::btree_map<std::string, std::vector<Value>>>
+ReadChannelValuesFromFile(const std::filesystem::path& path) {
+  Package package("channel_values");
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<ChannelValueFileReader> reader,
+                       ChannelValueFileReader::Open(path, &package));
+  absl::btree_map<std::string, std::vector<Value>> channel_values;
+  for (int64_t i = 0; i < reader->channels().size(); ++i) {
+    std::vector<Value>& values = channel_values[reader->channels()[i].name];
+    values.reserve(reader->value_count(i));
+    ChannelValueCursor cursor = reader->GetCursor(i);
+    while (std::optional<Value> value = cursor.Next()) {
+      values.push_back(*std::move(value));
+    }
+  }
+  return channel_values;
+}
+
+}  // namespace xls
@@ -0,0 +1,222 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_TOOLS_CHANNEL_VALUE_FILE_H_
+#define XLS_TOOLS_CHANNEL_VALUE_FILE_H_
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/ir/package.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+#include "xls/jit/type_layout.h"
+
+namespace xls {
+
+// Native channel-value files hold sequences of values for a set of channels,
+// each value stored in the native layout the JIT uses for the channel's type.
+// Unlike the text and proto formats they can be read without parsing, so a
+// simulation can stream values directly from a memory-mapped file, and they
+// can be written incrementally as a simulation produces values.
+//
+// A file consists of:
+//
+//   * the magic string "XLSCHVL1",
+//   * the size of the header followed by a serialized
+//     ChannelValueFileHeaderProto naming each channel and giving the layout of
+//     its values,
+//   * a sequence of chunks, each holding the channel index and the number of
+//     values followed by the values themselves, packed contiguously.
+//
+// Sizes and indices are 64-bit host-endian integers, and the header and each
+// chunk start at an offset which is a multiple of kChannelValueFileAlignment.
+// The values of a channel are the concatenation of its chunks in file order.
+// Files are only portable between hosts with the same endianness; readers use
+// the layouts recorded in the file, which need not match their own JIT.
+inline constexpr std::string_view kChannelValueFileMagic = "XLSCHVL1";
+inline constexpr int64_t kChannelValueFileAlignment = 16;
+
+// A channel stored in a native channel-value file.
+struct ChannelValueFileChannel {
+  std::string name;
+  TypeLayout layout;
+};
+
+// Returns the native layout the JIT on this host uses for each of `types`.
+absl::StatusOr<std::vector<TypeLayout>> GetNativeTypeLayouts(
+    absl::Span<Type* const> types);
+
+// Writes a native channel-value file. Values are buffered per channel and
+// written out as a chunk once a channel has accumulated kChunkBytes of data,
+// so the memory used is bounded independently of the number of values.
+class ChannelValueFileWriter {
+ public:
+  static constexpr int64_t kChunkBytes = int64_t{64} * 1024;
+
+  static absl::StatusOr<std::unique_ptr<ChannelValueFileWriter>> Create(
+      const std::filesystem::path& path,
+      absl::Span<const ChannelValueFileChannel> channels);
+
+  // Closes the file if Close has not been called, logging any error.
+  ~ChannelValueFileWriter();
+
+  // Returns the index of the channel with the given name.
+  absl::StatusOr<int64_t> GetChannelIndex(std::string_view name) const;
+
+  const std::vector<ChannelValueFileChannel>& channels() const {
+    return channels_;
+  }
+
+  // Appends a value to the channel with the given index.
+  absl::Status Write(int64_t channel_index, const Value& value);
+
+  // Appends `count` values to the channel with the given index. `data` holds
+  // the values in the native layout of the channel, packed contiguously.
+  absl::Status WriteRaw(int64_t channel_index, const uint8_t* data,
+                        int64_t count);
+
+  // Writes out all buffered values and closes the file.
+  absl::Status Close();
+
+ private:
+  ChannelValueFileWriter(std::ofstream stream,
+                         std::vector<ChannelValueFileChannel> channels);
+
+  // Writes the buffered values of the given channel as a chunk.
+  absl::Status FlushChannel(int64_t channel_index);
+
+  // Writes zero bytes up to the next multiple of kChannelValueFileAlignment.
+  void Pad(int64_t size);
+
+  std::ofstream stream_;
+  std::vector<ChannelValueFileChannel> channels_;
+  absl::flat_hash_map<std::string, int64_t> channel_indices_;
+  // The values of each channel not yet written out.
+  std::vector<std::vector<uint8_t>> buffers_;
+  std::vector<int64_t> buffered_counts_;
+  bool closed_ = false;
+};
+
+// A cursor over the values of one channel of a native channel-value file.
+// Values are only decoded when requested. Cursors are cheap to copy and are
+// valid as long as the reader which created them.
+class ChannelValueCursor {
+ public:
+  const TypeLayout& layout() const { return *layout_; }
+
+  // Returns the number of values after the cursor.
+  int64_t remaining() const { return remaining_; }
+  bool empty() const { return remaining_ == 0; }
+
+  // Returns the next value. The cursor must not be empty.
+  Value Peek() const;
+
+  // Returns the native layout of the next value, and the number of values
+  // which follow contiguously from it (at least one). The cursor must not be
+  // empty.
+  const uint8_t* PeekRaw() const;
+  int64_t contiguous_count() const;
+
+  // Moves the cursor past `count` values.
+  void Advance(int64_t count = 1);
+
+  // Returns the next value and advances the cursor past it, or std::nullopt if
+  // the cursor is empty.
+  std::optional<Value> Next();
+
+ private:
+  friend class ChannelValueFileReader;
+
+  struct Chunk {
+    const uint8_t* data;
+    int64_t count;
+  };
+
+  ChannelValueCursor(const TypeLayout* layout, absl::Span<const Chunk> chunks,
+                     int64_t count);
+
+  // Skips over exhausted chunks.
+  void Normalize();
+
+  const TypeLayout* layout_;
+  absl::Span<const Chunk> chunks_;
+  int64_t chunk_index_ = 0;
+  int64_t index_in_chunk_ = 0;
+  int64_t remaining_;
+};
+
+// Reads a native channel-value file by mapping it into memory. Opening a file
+// only indexes its chunks; values are decoded through cursors as needed.
+class ChannelValueFileReader {
+ public:
+  // The types of the channels are created in `package`, which must outlive
+  // the reader.
+  static absl::StatusOr<std::unique_ptr<ChannelValueFileReader>> Open(
+      const std::filesystem::path& path, Package* package);
+
+  ~ChannelValueFileReader();
+
+  const std::vector<ChannelValueFileChannel>& channels() const {
+    return channels_;
+  }
+
+  // Returns the number of values of the channel with the given index.
+  int64_t value_count(int64_t channel_index) const {
+    return value_counts_[channel_index];
+  }
+
+  // Returns a cursor at the first value of the channel with the given index or
+  // name.
+  ChannelValueCursor GetCursor(int64_t channel_index) const;
+  absl::StatusOr<ChannelValueCursor> GetCursor(std::string_view name) const;
+
+ private:
+  ChannelValueFileReader(void* mapping, int64_t size)
+      : mapping_(mapping), size_(size) {}
+
+  absl::Status Index(Package* package);
+
+  void* mapping_;
+  int64_t size_;
+  std::vector<ChannelValueFileChannel> channels_;
+  std::vector<std::vector<ChannelValueCursor::Chunk>> chunks_;
+  std::vector<int64_t> value_counts_;
+};
+
+// Writes the given channel values to a native channel-value file. The type of
+// each channel is that of its first value; channels without values are
+// recorded with the empty tuple type.
+absl::Status WriteChannelValuesToFile(
+    const std::filesystem::path& path,
+    const absl::btree_map<std::string, std::vector<Value>>& channel_values);
+
+// Returns all the values of all the channels in a native channel-value file.
+absl::StatusOr<absl::btree_map<std::string, std::vector<Value>>>
+ReadChannelValuesFromFile(const std::filesystem::path& path);
+
+}  // namespace xls
+
+#endif  // XLS_TOOLS_CHANNEL_VALUE_FILE_H_
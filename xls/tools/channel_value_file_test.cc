@@ -0,0 +1,155 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/tools/channel_value_file.h"
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/btree_map.h"
+#include "absl/status/status_matchers.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/jit/type_layout.h"
+
+namespace xls {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::testing::HasSubstr;
+
+class ChannelValueFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    XLS_ASSERT_OK_AND_ASSIGN(temp_dir_, TempDirectory::Create());
+  }
+
+  std::filesystem::path path() const {
+    return temp_dir_->path() / "values.bin";
+  }
+
+  std::optional<TempDirectory> temp_dir_;
+};
+
+TEST_F(ChannelValueFileTest, RoundTrip) {
+  absl::btree_map<std::string, std::vector<Value>> channel_values = {
+      {"a", {Value(UBits(1, 8)), Value(UBits(42, 8)), Value(UBits(255, 8))}},
+      {"b",
+       {Value::Tuple({Value(UBits(0x123456789, 37)), Value(UBits(1, 1))}),
+        Value::Tuple({Value(UBits(7, 37)), Value(UBits(0, 1))})}},
+      {"c",
+       {Value::UBitsArray({1, 2, 3}, 100).value(),
+        Value::UBitsArray({4, 5, 6}, 100).value()}},
+      {"empty", {}},
+  };
+  XLS_ASSERT_OK(WriteChannelValuesToFile(path(), channel_values));
+  EXPECT_THAT(ReadChannelValuesFromFile(path()), IsOkAndHolds(channel_values));
+}
+
+TEST_F(ChannelValueFileTest, StreamsManyChunks) {
+  Package package("p");
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<TypeLayout> layouts,
+                           GetNativeTypeLayouts({package.GetBitsType(32),
+                                                 package.GetBitsType(64)}));
+  // Enough values that each channel is written as several interleaved chunks.
+  constexpr int64_t kCount = 100'000;
+  {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<ChannelValueFileWriter> writer,
+        ChannelValueFileWriter::Create(
+            path(), {ChannelValueFileChannel{.name = "x", .layout = layouts[0]},
+                     ChannelValueFileChannel{.name = "y",
+                                             .layout = layouts[1]}}));
+    for (int64_t i = 0; i < kCount; ++i) {
+      XLS_ASSERT_OK(writer->Write(0, Value(UBits(i, 32))));
+      uint64_t raw = i * 3;
+      XLS_ASSERT_OK(
+          writer->WriteRaw(1, reinterpret_cast<const uint8_t*>(&raw), 1));
+    }
+    XLS_ASSERT_OK(writer->Close());
+  }
+
+  Package read_package("read");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ChannelValueFileReader> reader,
+      ChannelValueFileReader::Open(path(), &read_package));
+  ASSERT_EQ(reader->channels().size(), 2);
+  EXPECT_EQ(reader->channels()[1].name, "y");
+  EXPECT_EQ(reader->value_count(0), kCount);
+  EXPECT_EQ(reader->value_count(1), kCount);
+
+  XLS_ASSERT_OK_AND_ASSIGN(ChannelValueCursor x, reader->GetCursor("x"));
+  XLS_ASSERT_OK_AND_ASSIGN(ChannelValueCursor y, reader->GetCursor("y"));
+  EXPECT_LT(x.contiguous_count(), kCount);
+  for (int64_t i = 0; i < kCount; ++i) {
+    ASSERT_EQ(x.remaining(), kCount - i);
+    ASSERT_EQ(x.Next(), Value(UBits(i, 32)));
+    ASSERT_EQ(y.Peek(), Value(UBits(i * 3, 64)));
+    ASSERT_EQ(*reinterpret_cast<const uint64_t*>(y.PeekRaw()), i * 3);
+    y.Advance();
+  }
+  EXPECT_TRUE(x.empty());
+  EXPECT_EQ(x.Next(), std::nullopt);
+
+  // Advancing across chunk boundaries.
+  ChannelValueCursor z = reader->GetCursor(0);
+  z.Advance(kCount - 1);
+  EXPECT_EQ(z.Peek(), Value(UBits(kCount - 1, 32)));
+}
+
+TEST_F(ChannelValueFileTest, RejectsMalformedFiles) {
+  Package package("p");
+  XLS_ASSERT_OK(SetFileContents(path(), "not a channel-value file"));
+  EXPECT_THAT(ChannelValueFileReader::Open(path(), &package),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Malformed channel-value file")));
+
+  XLS_ASSERT_OK(WriteChannelValuesToFile(
+      path(), {{"a", {Value(UBits(1, 32)), Value(UBits(2, 32))}}}));
+  XLS_ASSERT_OK_AND_ASSIGN(std::string contents, GetFileContents(path()));
+  XLS_ASSERT_OK(
+      SetFileContents(path(), contents.substr(0, contents.size() - 16)));
+  EXPECT_THAT(ChannelValueFileReader::Open(path(), &package),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(ChannelValueFileTest, WriteChecksType) {
+  Package package("p");
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<TypeLayout> layouts,
+                           GetNativeTypeLayouts({package.GetBitsType(32)}));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ChannelValueFileWriter> writer,
+      ChannelValueFileWriter::Create(
+          path(),
+          {ChannelValueFileChannel{.name = "x", .layout = layouts[0]}}));
+  EXPECT_THAT(writer->Write(0, Value(UBits(1, 8))),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(writer->GetChannelIndex("x"), IsOkAndHolds(0));
+  EXPECT_THAT(writer->GetChannelIndex("y"),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,121 @@
+// Copyright 2025 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "absl/flags/flag.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/exit_status.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/init_xls.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/value.h"
+#include "xls/tools/channel_value_file.h"
+#include "xls/tools/eval_utils.h"
+#include "xls/tools/proc_channel_values.pb.h"
+
+static constexpr std::string_view kUsage = R"(
+Converts channel values between the ProcChannelValuesProto formats and the
+native channel-value format which eval_proc_main can stream from and to. The
+supported formats are:
+
+  * textproto: a ProcChannelValuesProto textproto,
+  * proto: a binary ProcChannelValuesProto,
+  * native: a native channel-value file (see xls/tools/channel_value_file.h).
+
+Example:
+
+  convert_channel_values_main --input_format=textproto --output_format=native \
+      --output=inputs.bin inputs.textproto
+)";
+
+ABSL_FLAG(std::string, input_format, "textproto",
+          "Format of the input file. One of textproto, proto, or native.");
+ABSL_FLAG(std::string, output_format, "native",
+          "Format of the output file. One of textproto, proto, or native.");
+ABSL_FLAG(std::string, output, "", "Output file to write the values to.");
+
+namespace xls {
+namespace {
+
+using ChannelValues = absl::btree_map<std::string, std::vector<Value>>;
+
+absl::StatusOr<ChannelValues> ReadChannelValues(std::string_view path,
+                                                std::string_view format) {
+  if (format == "textproto") {
+    XLS_ASSIGN_OR_RETURN(ProcChannelValuesProto proto,
+                         ParseTextProtoFile<ProcChannelValuesProto>(path));
+    return ParseChannelValuesFromProto(proto);
+  }
+  if (format == "proto") {
+    return ParseChannelValuesFromProtoFile(path);
+  }
+  if (format == "native") {
+    return ReadChannelValuesFromFile(path);
+  }
+  return absl::InvalidArgumentError(
+      absl::StrFormat("Unknown channel-value format: %s", format));
+}
+
+absl::Status WriteChannelValues(const ChannelValues& channel_values,
+                                std::string_view path,
+                                std::string_view format) {
+  if (format == "textproto" || format == "proto") {
+    XLS_ASSIGN_OR_RETURN(ProcChannelValuesProto proto,
+                         ChannelValuesToProto(channel_values));
+    return format == "textproto" ? SetTextProtoFile(path, proto)
+                                 : SetProtobinFile(path, proto);
+  }
+  if (format == "native") {
+    return WriteChannelValuesToFile(path, channel_values);
+  }
+  return absl::InvalidArgumentError(
+      absl::StrFormat("Unknown channel-value format: %s", format));
+}
+
+absl::Status RealMain(std::string_view input_path,
+                      std::string_view input_format,
+                      std::string_view output_path,
+                      std::string_view output_format) {
+  XLS_ASSIGN_OR_RETURN(ChannelValues channel_values,
+                       ReadChannelValues(input_path, input_format));
+  return WriteChannelValues(channel_values, output_path, output_format);
+}
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  std::vector<std::string_view> positional_arguments =
+      xls::InitXls(kUsage, argc, argv);
+
+  if (positional_arguments.size() != 1) {
+    LOG(QFATAL) << absl::StreamFormat("Expected invocation: %s INPUT_FILE",
+                                      argv[0]);
+  }
+
+  if (absl::GetFlag(FLAGS_output).empty()) {
+    LOG(QFATAL) << "--output (output file path) required.";
+  }
+
+  return xls::ExitStatus(xls::RealMain(
+      positional_arguments[0], absl::GetFlag(FLAGS_input_format),
+      absl::GetFlag(FLAGS_output), absl::GetFlag(FLAGS_output_format)));
+}
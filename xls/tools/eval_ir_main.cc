@@ -143,6 +143,11 @@ Evaluate IR after every optimization pass:
 Evaluate IR using the JIT and with the interpreter and compare the results:
 
    eval_ir_main --test_llvm_jit --random_inputs=100  IR_FILE
+
+Measure the throughput of the precompiled interpreter on many random inputs:
+
+   time eval_ir_main --use_llvm_jit=false --use_compiled_interpreter \
+       --random_inputs=100000 IR_FILE > /dev/null
 )";
 
 // LINT.IfChange
@@ -178,6 +183,10 @@ ABSL_FLAG(
     "When specified with --optimize_ir, run evaluation after each pass. "
     "A non-zero error status is returned if any of the results do not match.");
 ABSL_FLAG(bool, use_llvm_jit, true, "Use the LLVM IR JIT for execution.");
+ABSL_FLAG(bool, use_compiled_interpreter, false,
+          "When evaluating with the interpreter, precompile the function once "
+          "and reuse it for every input. This avoids the per-input graph "
+          "traversal and node value map of the plain interpreter.");
 ABSL_FLAG(bool, test_llvm_jit, false,
           "If true, then run the JIT and compare the results against the "
           "interpereter.");
@@ -384,6 +393,10 @@ absl::StatusOr<std::vector<Value>> Eval(
                  /*include_observer_callbacks=*/eval_observer.has_value(),
                  &observer));
   }
+  std::unique_ptr<CompiledFunctionInterpreter> interpreter;
+  if (!use_jit && absl::GetFlag(FLAGS_use_compiled_interpreter)) {
+    XLS_ASSIGN_OR_RETURN(interpreter, CompiledFunctionInterpreter::Create(f));
+  }
 
   std::vector<Value> results;
   for (const ArgSet& arg_set : arg_sets) {
@@ -420,8 +433,13 @@ absl::StatusOr<std::vector<Value>> Eval(
       // resulting events once the JIT fully supports events. Note: This will
       // require rethinking some of the control flow because event comparison
       // only makes sense for certain modes (optimize_ir and test_llvm_jit).
-      XLS_ASSIGN_OR_RETURN(result, DropInterpreterEvents(InterpretFunction(
-                                       f, arg_set.args, eval_observer)));
+      if (interpreter != nullptr) {
+        XLS_ASSIGN_OR_RETURN(result, DropInterpreterEvents(interpreter->Run(
+                                         arg_set.args, eval_observer)));
+      } else {
+        XLS_ASSIGN_OR_RETURN(result, DropInterpreterEvents(InterpretFunction(
+                                         f, arg_set.args, eval_observer)));
+      }
     }
     std::cout << result.ToString(FormatPreference::kHex) << '\n';
 
@@ -16,7 +16,6 @@
 
 #include <algorithm>
 #include <cstdint>
-#include <deque>
 #include <iostream>
 #include <iterator>
 #include <memory>
@@ -77,7 +76,10 @@
 #include "xls/ir/value_utils.h"
 #include "xls/jit/block_jit.h"
 #include "xls/jit/jit_proc_runtime.h"
+#include "xls/jit/jit_channel_queue.h"
 #include "xls/jit/jit_runtime.h"
+#include "xls/jit/type_layout.h"
+#include "xls/tools/channel_value_file.h"
 #include "xls/tools/eval_utils.h"
 #include "xls/tools/memory_models.h"
 #include "xls/tools/node_coverage_utils.h"
@@ -170,6 +172,21 @@ ABSL_FLAG(
     "Path to file containing ProcChannelValuesProto binary proto of outputs "
     "for all channels.");
 
+ABSL_FLAG(std::string, native_inputs_for_all_channels, "",
+          "Path to a native channel-value file (see "
+          "xls/tools/channel_value_file.h) containing inputs for all channels. "
+          "Values are streamed from the file as the simulation consumes them "
+          "rather than being loaded up front. Use convert_channel_values_main "
+          "to create the file from a ProcChannelValuesProto.");
+ABSL_FLAG(std::string, expected_native_outputs_for_all_channels, "",
+          "Path to a native channel-value file containing the expected outputs "
+          "for all channels. Values are streamed from the file as outputs are "
+          "checked.");
+ABSL_FLAG(std::string, native_outputs_for_all_channels, "",
+          "For procs, path to a native channel-value file to which the values "
+          "sent on output (send-only) channels are written as they are "
+          "produced. Can't be combined with expected outputs.");
+
 ABSL_FLAG(int64_t, random_seed, 42, "Random seed");
 ABSL_FLAG(double, prob_input_valid_assert, 1.0,
           "Single-cycle probability of asserting valid with more input ready.");
@@ -225,18 +242,241 @@ static absl::Status LogInterpreterEvents(std::string_view entity_name,
   return absl::OkStatus();
 }
 
+// The values of a channel which are still to be fed to (for inputs) or checked
+// against (for expected outputs) the simulation. Values given as text or
+// protos are held in memory, while values from a native channel-value file are
+// only decoded from the mapped file as they are reached.
+class ChannelValueSequence {
+ public:
+  explicit ChannelValueSequence(std::vector<Value> values)
+      : values_(std::move(values)) {}
+  explicit ChannelValueSequence(ChannelValueCursor cursor)
+      : cursor_(std::move(cursor)) {}
+
+  // Returns whether the values are streamed from a file.
+  bool streamed() const { return cursor_.has_value(); }
+  const ChannelValueCursor& cursor() const { return *cursor_; }
+
+  // Returns the remaining values. Only valid if the values aren't streamed.
+  absl::Span<const Value> remaining_values() const {
+    return absl::MakeConstSpan(values_).subspan(next_);
+  }
+
+  int64_t size() const {
+    return streamed() ? cursor_->remaining() : values_.size() - next_;
+  }
+  bool empty() const { return size() == 0; }
+
+  const Value& front() const {
+    if (!streamed()) {
+      return values_[next_];
+    }
+    if (!front_.has_value()) {
+      front_ = cursor_->Peek();
+    }
+    return *front_;
+  }
+
+  void pop_front() { Skip(1); }
+  void Skip(int64_t count) {
+    if (streamed()) {
+      cursor_->Advance(count);
+      front_.reset();
+    } else {
+      next_ += count;
+    }
+  }
+
+ private:
+  std::vector<Value> values_;
+  int64_t next_ = 0;
+  std::optional<ChannelValueCursor> cursor_;
+  // The decoded value at the front of the cursor.
+  mutable std::optional<Value> front_;
+};
+
+using ChannelValueSequences =
+    absl::btree_map<std::string, ChannelValueSequence>;
+
+static ChannelValueSequences ToChannelValueSequences(
+    absl::btree_map<std::string, std::vector<Value>> channel_values) {
+  ChannelValueSequences sequences;
+  for (auto& [channel_name, values] : channel_values) {
+    sequences.emplace(channel_name, ChannelValueSequence(std::move(values)));
+  }
+  return sequences;
+}
+
+static ChannelValueSequences ToChannelValueSequences(
+    const ChannelValueFileReader& reader) {
+  ChannelValueSequences sequences;
+  for (int64_t i = 0; i < reader.channels().size(); ++i) {
+    sequences.emplace(reader.channels()[i].name,
+                      ChannelValueSequence(reader.GetCursor(i)));
+  }
+  return sequences;
+}
+
+// Logs a warning listing the inputs which were not consumed by the time all
+// expected outputs were produced. Inputs left in streamed channels are only
+// counted, as there may be very many.
+static void WarnAboutUnconsumedInputs(
+    const absl::btree_map<std::string, std::vector<Value>>& unconsumed_inputs,
+    const absl::btree_map<std::string, int64_t>& unconsumed_streamed_counts) {
+  if (!unconsumed_inputs.empty()) {
+    LOG(WARNING) << "Warning: Not all inputs were consumed by the time all "
+                    "expected outputs were produced. Remaining inputs:\n"
+                 << ChannelValuesToString(unconsumed_inputs);
+  }
+  for (const auto& [channel_name, count] : unconsumed_streamed_counts) {
+    LOG(WARNING) << absl::StreamFormat(
+        "Warning: %d streamed inputs of channel %s were not consumed by the "
+        "time all expected outputs were produced.",
+        count, channel_name);
+  }
+}
+
 struct EvaluateProcsOptions {
   bool use_jit = false;
   bool fail_on_assert = false;
   std::vector<int64_t> ticks = {-1};
   std::optional<std::string> top = std::nullopt;
+  // If set, the values sent on output channels are written to this native
+  // channel-value file as they are produced.
+  std::optional<std::string> native_outputs_path = std::nullopt;
+};
+
+// At most this many streamed input values are queued on a channel at a time.
+// Inputs held in memory are all queued up front.
+constexpr int64_t kStreamedInputQueueDepth = 1024;
+
+// The source of the inputs of a channel queue. Streamed values are copied
+// straight from the file if `raw_queue` is set, which requires the file to use
+// the layout of the JIT.
+struct InputFeed {
+  ChannelQueue* queue;
+  ChannelValueSequence* values;
+  JitChannelQueue* raw_queue = nullptr;
+};
+
+// Tops up the input queues with the next values of their channels.
+static absl::Status FeedInputs(absl::Span<InputFeed> feeds) {
+  for (InputFeed& feed : feeds) {
+    ChannelValueSequence& values = *feed.values;
+    // Every value written to a single-value channel replaces the previous one,
+    // so they are never streamed.
+    const bool streamed =
+        values.streamed() &&
+        feed.queue->channel()->kind() != ChannelKind::kSingleValue;
+    while (!values.empty()) {
+      int64_t room = streamed
+                         ? kStreamedInputQueueDepth - feed.queue->GetSize()
+                         : values.size();
+      if (room <= 0) {
+        break;
+      }
+      if (streamed && feed.raw_queue != nullptr) {
+        int64_t count = std::min(room, values.cursor().contiguous_count());
+        feed.raw_queue->WriteRawBatch(values.cursor().PeekRaw(), count);
+        values.Skip(count);
+        continue;
+      }
+      XLS_RETURN_IF_ERROR(feed.queue->Write(values.front()));
+      values.pop_front();
+    }
+  }
+  return absl::OkStatus();
+}
+
+// The progress of checking the values sent on a channel against the expected
+// ones.
+struct OutputCheck {
+  ChannelQueue* queue;
+  ChannelValueSequence* expected;
+  int64_t matched = 0;
+  // Whether an error has been recorded for the channel.
+  bool failed = false;
+};
+
+// Reads values from the output queues and compares them to the expected
+// values, adding an error for each mismatched channel. Unless `final` is set
+// only the queues of channels which are not read by the simulation are
+// checked, so outputs can be checked (and dropped) as the simulation runs.
+static void CheckOutputs(absl::Span<OutputCheck> checks, bool final,
+                         std::vector<std::string>& errors) {
+  for (OutputCheck& check : checks) {
+    Channel* channel = check.queue->channel();
+    if (!final && (channel->CanReceive() ||
+                   channel->kind() == ChannelKind::kSingleValue)) {
+      continue;
+    }
+    while (!check.failed && !check.expected->empty()) {
+      std::optional<Value> out_val = check.queue->Read();
+      if (!out_val.has_value()) {
+        if (final) {
+          errors.push_back(absl::StrFormat(
+              "Channel %s didn't consume %d expected values (processed %d)",
+              channel->name(), check.expected->size(), check.matched));
+          check.failed = true;
+        }
+        break;
+      }
+      const Value& value = check.expected->front();
+      if (value != *out_val) {
+        errors.push_back(absl::StrFormat(
+            "Mismatched (channel=%s) after %d outputs (%s != %s)",
+            channel->name(), check.matched, value.ToString(),
+            out_val->ToString()));
+        check.failed = true;
+        break;
+      }
+      if (absl::GetFlag(FLAGS_show_trace)) {
+        LOG(INFO) << absl::StreamFormat("Matched (channel=%s) after %d outputs",
+                                        channel->name(), check.matched);
+      }
+      ++check.matched;
+      check.expected->pop_front();
+    }
+  }
+}
+
+// An output channel queue whose values are written to a native channel-value
+// file. Values are copied straight from the queue if `raw_queue` is set.
+struct OutputRecord {
+  ChannelQueue* queue;
+  int64_t channel_index;
+  JitChannelQueue* raw_queue = nullptr;
+  std::vector<uint8_t> buffer;
 };
 
+// Moves the values in the recorded output queues to the file.
+static absl::Status RecordOutputs(absl::Span<OutputRecord> records,
+                                  ChannelValueFileWriter& writer) {
+  for (OutputRecord& record : records) {
+    if (record.raw_queue != nullptr) {
+      int64_t count;
+      while ((count = record.raw_queue->ReadRawBatch(
+                  record.buffer.data(), kStreamedInputQueueDepth)) > 0) {
+        XLS_RETURN_IF_ERROR(
+            writer.WriteRaw(record.channel_index, record.buffer.data(), count));
+      }
+      continue;
+    }
+    while (std::optional<Value> value = record.queue->Read()) {
+      XLS_RETURN_IF_ERROR(writer.Write(record.channel_index, *value));
+    }
+  }
+  return absl::OkStatus();
+}
+
+static bool LayoutsMatch(const TypeLayout& a, const TypeLayout& b) {
+  return a.type() == b.type() && a.size() == b.size() &&
+         absl::c_equal(a.elements(), b.elements());
+}
+
 static absl::Status EvaluateProcs(
-    Package* package,
-    const absl::btree_map<std::string, std::vector<Value>>& inputs_for_channels,
-    absl::btree_map<std::string, std::vector<Value>>&
-        expected_outputs_for_channels,
+    Package* package, ChannelValueSequences& inputs_for_channels,
+    ChannelValueSequences& expected_outputs_for_channels,
     const RamRewritesProto& ram_rewrites,
     const EvaluateProcsOptions& options = {}) {
   std::unique_ptr<SerialProcRuntime> runtime;
@@ -303,24 +543,92 @@ static absl::Status EvaluateProcs(
     memory_models.push_back(std::move(memory_model));
   }
 
-  for (const auto& [channel_name, values] : inputs_for_channels) {
+  std::vector<InputFeed> input_feeds;
+  std::vector<Type*> streamed_input_types;
+  for (auto& [channel_name, values] : inputs_for_channels) {
     XLS_ASSIGN_OR_RETURN(ChannelQueue * in_queue,
                          queue_manager.GetQueueByName(channel_name));
-    for (const Value& value : values) {
-      XLS_RETURN_IF_ERROR(in_queue->Write(value));
+    input_feeds.push_back(InputFeed{.queue = in_queue, .values = &values});
+    if (values.streamed() && !values.empty()) {
+      Type* type = in_queue->channel()->type();
+      if (values.cursor().layout().type() != type) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Channel `%s` expects values to have type %s, got values of type "
+            "%s",
+            channel_name, type->ToString(),
+            values.cursor().layout().type()->ToString()));
+      }
+      streamed_input_types.push_back(type);
     }
     if (absl::GetFlag(FLAGS_show_trace)) {
       LOG(INFO) << "Channel " << channel_name << " has " << values.size()
                 << " inputs";
     }
   }
-  if (absl::GetFlag(FLAGS_show_trace)) {
-    for (const auto& [channel_name, values] : expected_outputs_for_channels) {
+  // Streamed inputs are copied straight into JIT queues if the file uses the
+  // layout of the JIT.
+  if (options.use_jit && !streamed_input_types.empty()) {
+    XLS_ASSIGN_OR_RETURN(std::vector<TypeLayout> jit_layouts,
+                         GetNativeTypeLayouts(streamed_input_types));
+    auto jit_layout = jit_layouts.begin();
+    for (InputFeed& feed : input_feeds) {
+      if (feed.values->streamed() && !feed.values->empty()) {
+        if (LayoutsMatch(feed.values->cursor().layout(), *jit_layout)) {
+          feed.raw_queue = dynamic_cast<JitChannelQueue*>(feed.queue);
+        }
+        ++jit_layout;
+      }
+    }
+  }
+  XLS_RETURN_IF_ERROR(FeedInputs(absl::MakeSpan(input_feeds)));
+
+  std::vector<OutputCheck> output_checks;
+  for (auto& [channel_name, values] : expected_outputs_for_channels) {
+    XLS_ASSIGN_OR_RETURN(ChannelQueue * out_queue,
+                         queue_manager.GetQueueByName(channel_name));
+    output_checks.push_back(
+        OutputCheck{.queue = out_queue, .expected = &values});
+    if (absl::GetFlag(FLAGS_show_trace)) {
       LOG(INFO) << "Channel " << channel_name << " has " << values.size()
                 << " outputs";
     }
   }
 
+  std::unique_ptr<ChannelValueFileWriter> output_writer;
+  std::vector<OutputRecord> output_records;
+  if (options.native_outputs_path.has_value()) {
+    std::vector<ChannelQueue*> out_queues;
+    std::vector<Type*> types;
+    for (const Channel* channel : package->channels()) {
+      if (!channel->CanSend() || channel->CanReceive()) {
+        continue;
+      }
+      XLS_ASSIGN_OR_RETURN(ChannelQueue * out_queue,
+                           queue_manager.GetQueueByName(channel->name()));
+      out_queues.push_back(out_queue);
+      types.push_back(channel->type());
+    }
+    XLS_ASSIGN_OR_RETURN(std::vector<TypeLayout> layouts,
+                         GetNativeTypeLayouts(types));
+    std::vector<ChannelValueFileChannel> channels;
+    for (int64_t i = 0; i < out_queues.size(); ++i) {
+      channels.push_back(ChannelValueFileChannel{
+          .name = std::string{out_queues[i]->channel()->name()},
+          .layout = layouts[i]});
+      OutputRecord record{.queue = out_queues[i], .channel_index = i};
+      if (options.use_jit && layouts[i].size() > 0) {
+        record.raw_queue = dynamic_cast<JitChannelQueue*>(out_queues[i]);
+        record.buffer.resize(kStreamedInputQueueDepth * layouts[i].size());
+      }
+      output_records.push_back(std::move(record));
+    }
+    XLS_ASSIGN_OR_RETURN(output_writer,
+                         ChannelValueFileWriter::Create(
+                             *options.native_outputs_path, channels));
+  }
+
+  std::vector<std::string> errors;
+
   absl::Time start_time = absl::Now();
 
   const int64_t trace_per_ticks = absl::GetFlag(FLAGS_trace_per_ticks);
@@ -332,6 +640,7 @@ static absl::Status EvaluateProcs(
     runtime->ResetState();
 
     for (int i = 0; this_ticks < 0 || i < this_ticks; i++) {
+      XLS_RETURN_IF_ERROR(FeedInputs(absl::MakeSpan(input_feeds)));
       if (absl::GetFlag(FLAGS_show_trace) &&
           (i < trace_per_ticks || i % trace_per_ticks == 0)) {
         std::ostringstream ostr;
@@ -417,36 +726,42 @@ static absl::Status EvaluateProcs(
             "Assert(s) fired:\n\n%s", absl::StrJoin(asserts, "\n")));
       }
 
+      // Check outputs as they are produced so that they don't pile up in the
+      // queues.
+      CheckOutputs(absl::MakeSpan(output_checks), /*final=*/false, errors);
+      if (output_writer != nullptr) {
+        XLS_RETURN_IF_ERROR(
+            RecordOutputs(absl::MakeSpan(output_records), *output_writer));
+      }
+
       // --ticks 0 stops when all outputs are verified
       if (this_ticks < 0) {
         bool all_outputs_produced = true;
-        for (const auto& [channel_name, values] :
-             expected_outputs_for_channels) {
-          XLS_ASSIGN_OR_RETURN(ChannelQueue * out_queue,
-                               queue_manager.GetQueueByName(channel_name));
-          if (out_queue->GetSize() < values.size()) {
+        for (const OutputCheck& check : output_checks) {
+          if (!check.failed &&
+              check.queue->GetSize() < check.expected->size()) {
             all_outputs_produced = false;
           }
         }
         if (all_outputs_produced) {
           absl::btree_map<std::string, std::vector<Value>> unconsumed_inputs;
-          for (const auto& [channel_name, _] : inputs_for_channels) {
-            XLS_ASSIGN_OR_RETURN(ChannelQueue * in_queue,
-                                 queue_manager.GetQueueByName(channel_name));
+          absl::btree_map<std::string, int64_t> unconsumed_streamed_counts;
+          for (const InputFeed& feed : input_feeds) {
+            ChannelQueue* in_queue = feed.queue;
             // Ignore single value channels in this check
             if (in_queue->channel()->kind() == ChannelKind::kSingleValue) {
               continue;
             }
+            std::string channel_name{in_queue->channel()->name()};
             while (!in_queue->IsEmpty()) {
               unconsumed_inputs[channel_name].push_back(*in_queue->Read());
             }
+            if (!feed.values->empty()) {
+              unconsumed_streamed_counts[channel_name] = feed.values->size();
+            }
           }
-          if (!unconsumed_inputs.empty()) {
-            LOG(WARNING)
-                << "Warning: Not all inputs were consumed by the time all "
-                   "expected outputs were produced. Remaining inputs:\n"
-                << ChannelValuesToString(unconsumed_inputs);
-          }
+          WarnAboutUnconsumedInputs(unconsumed_inputs,
+                                    unconsumed_streamed_counts);
           break;
         }
       }
@@ -454,34 +769,11 @@ static absl::Status EvaluateProcs(
   }
   absl::Duration elapsed_time = absl::Now() - start_time;
   LOG(INFO) << "Elapsed time: " << elapsed_time;
-  bool checked_any_output = false;
-  std::vector<std::string> errors;
-  for (const auto& [channel_name, values] : expected_outputs_for_channels) {
-    XLS_ASSIGN_OR_RETURN(ChannelQueue * out_queue,
-                         queue_manager.GetQueueByName(channel_name));
-    uint64_t processed_count = 0;
-    for (const Value& value : values) {
-      std::optional<Value> out_val = out_queue->Read();
-      if (!out_val.has_value()) {
-        errors.push_back(absl::StrFormat(
-            "Channel %s didn't consume %d expected values (processed %d)",
-            channel_name, values.size() - processed_count, processed_count));
-        break;
-      }
-      if (value != *out_val) {
-        errors.push_back(absl::StrFormat(
-            "Mismatched (channel=%s) after %d outputs (%s != %s)", channel_name,
-            processed_count, value.ToString(), out_val->ToString()));
-        break;
-      }
-      if (absl::GetFlag(FLAGS_show_trace)) {
-        LOG(INFO) << absl::StreamFormat("Matched (channel=%s) after %d outputs",
-                                        channel_name, processed_count);
-      }
-      checked_any_output = true;
-      ++processed_count;
-    }
-  }
+  CheckOutputs(absl::MakeSpan(output_checks), /*final=*/true, errors);
+  bool checked_any_output =
+      absl::c_any_of(output_checks, [](const OutputCheck& check) {
+        return check.matched > 0;
+      });
   if (!errors.empty()) {
     return absl::UnknownError(
         absl::StrFormat("Outputs did not match expectations:\n\n%s",
@@ -491,7 +783,14 @@ static absl::Status EvaluateProcs(
     return absl::UnknownError("No output verified (empty expected values?)");
   }
 
+  if (output_writer != nullptr) {
+    XLS_RETURN_IF_ERROR(
+        RecordOutputs(absl::MakeSpan(output_records), *output_writer));
+    return output_writer->Close();
+  }
+
   if (expected_outputs_for_channels.empty()) {
+    absl::btree_map<std::string, std::vector<Value>> outputs_for_channels;
     for (const Channel* channel : package->channels()) {
       if (!channel->CanSend()) {
         continue;
@@ -504,10 +803,10 @@ static absl::Status EvaluateProcs(
         std::optional<Value> out_val = out_queue->Read();
         channel_values[index++] = out_val.value();
       }
-      expected_outputs_for_channels.insert(
+      outputs_for_channels.insert(
           {std::string{channel->name()}, channel_values});
     }
-    std::cout << ChannelValuesToString(expected_outputs_for_channels);
+    std::cout << ChannelValuesToString(outputs_for_channels);
   }
   return absl::OkStatus();
 }
@@ -527,9 +826,8 @@ struct ChannelInfo {
 absl::StatusOr<absl::flat_hash_map<std::string, ChannelInfo>>
 InterpretBlockSignature(
     const verilog::ModuleSignatureProto& signature,
-    const absl::btree_map<std::string, std::vector<Value>>& inputs_for_channels,
-    const absl::btree_map<std::string, std::vector<Value>>&
-        expected_outputs_for_channels,
+    const ChannelValueSequences& inputs_for_channels,
+    const ChannelValueSequences& expected_outputs_for_channels,
     const RamRewritesProto& ram_rewrites) {
   absl::flat_hash_map<std::string, ChannelInfo> channel_info;
   // Pull the information out of the channel_protos
@@ -693,9 +991,8 @@ absl::StatusOr<absl::flat_hash_map<std::string, StandardRamInfo>> GetRamInfoMap(
 
 static absl::Status RunBlock(
     Package* package, const verilog::ModuleSignatureProto& signature,
-    const absl::btree_map<std::string, std::vector<Value>>& inputs_for_channels,
-    absl::btree_map<std::string, std::vector<Value>>&
-        expected_outputs_for_channels,
+    ChannelValueSequences& inputs_for_channels,
+    ChannelValueSequences& expected_outputs_for_channels,
     const RamRewritesProto& ram_rewrites, std::string_view output_stats_path,
     const RunBlockOptions& options = {}) {
   Block* block;
@@ -735,15 +1032,8 @@ static absl::Status RunBlock(
       (absl::flat_hash_map<std::string, StandardRamInfo> ram_info),
       GetRamInfoMap(signature));
 
-  // Prepare values in queue format
-  absl::flat_hash_map<std::string, std::deque<Value>> channel_value_queues;
-  for (const auto& [name, values] : inputs_for_channels) {
-    XLS_RET_CHECK(!channel_value_queues.contains(name));
-    absl::c_copy(values, std::back_inserter(channel_value_queues[name]));
-  }
-  for (const auto& [name, values] : expected_outputs_for_channels) {
-    XLS_RET_CHECK(!channel_value_queues.contains(name));
-    absl::c_copy(values, std::back_inserter(channel_value_queues[name]));
+  for (const auto& [name, _] : inputs_for_channels) {
+    XLS_RET_CHECK(!expected_outputs_for_channels.contains(name));
   }
 
   absl::flat_hash_map<std::string,
@@ -836,7 +1126,7 @@ static absl::Status RunBlock(
 
     for (const auto& [name, _] : inputs_for_channels) {
       const ChannelInfo& info = channel_info.at(name);
-      const std::deque<Value>& queue = channel_value_queues.at(name);
+      const ChannelValueSequence& queue = inputs_for_channels.at(name);
       if (info.ready_valid) {
         // Don't bring valid low without a transaction
         const bool asserted_valid = asserted_valids.contains(name);
@@ -904,7 +1194,7 @@ static absl::Status RunBlock(
       const bool vld_value = input_set.at(info.channel_valid).bits().Get(0);
       const bool rdy_value = outputs.at(info.channel_ready).bits().Get(0);
 
-      std::deque<Value>& queue = channel_value_queues.at(name);
+      ChannelValueSequence& queue = inputs_for_channels.at(name);
       if (vld_value && rdy_value) {
         if (options.show_trace) {
           LOG(INFO) << "Channel Model: Consuming input for " << name << ": "
@@ -922,7 +1212,7 @@ static absl::Status RunBlock(
       const bool vld_value = outputs.at(info.channel_valid).bits().Get(0);
       const bool rdy_value = input_set.at(info.channel_ready).bits().Get(0);
 
-      std::deque<Value>& queue = channel_value_queues.at(name);
+      ChannelValueSequence& queue = expected_outputs_for_channels.at(name);
 
       if (rdy_value && vld_value) {
         if (queue.empty()) {
@@ -1005,7 +1295,8 @@ static absl::Status RunBlock(
         continue;
       }
 
-      const std::deque<Value>& queue = channel_value_queues.at(name);
+      const ChannelValueSequence& queue =
+          expected_outputs_for_channels.at(name);
       if (!queue.empty()) {
         all_output_queues_empty = false;
       }
@@ -1030,23 +1321,22 @@ static absl::Status RunBlock(
   LOG(INFO) << "Elapsed time: " << elapsed_time;
 
   absl::btree_map<std::string, std::vector<Value>> unconsumed_inputs;
-  for (const auto& [channel_name, _] : inputs_for_channels) {
+  absl::btree_map<std::string, int64_t> unconsumed_streamed_counts;
+  for (const auto& [channel_name, queue] : inputs_for_channels) {
     // Ignore single value channels in this check
     const ChannelInfo& info = channel_info.at(channel_name);
-    if (!info.ready_valid) {
+    if (!info.ready_valid || queue.empty()) {
       continue;
     }
 
-    std::deque<Value>& queue = channel_value_queues.at(channel_name);
-    if (!queue.empty()) {
-      absl::c_copy(queue, std::back_inserter(unconsumed_inputs[channel_name]));
+    if (queue.streamed()) {
+      unconsumed_streamed_counts[channel_name] = queue.size();
+    } else {
+      absl::c_copy(queue.remaining_values(),
+                   std::back_inserter(unconsumed_inputs[channel_name]));
     }
   }
-  if (!unconsumed_inputs.empty()) {
-    LOG(WARNING) << "Warning: Not all inputs were consumed by the time all "
-                    "expected outputs were produced. Remaining inputs:\n"
-                 << ChannelValuesToString(unconsumed_inputs);
-  }
+  WarnAboutUnconsumedInputs(unconsumed_inputs, unconsumed_streamed_counts);
   if (!checked_any_output) {
     return absl::UnknownError("No output verified (empty expected values?)");
   }
@@ -1102,6 +1392,9 @@ static absl::Status RealMain(
     const std::string& proto_inputs_for_all_channels,
     const std::string& testvector_proto,
     const std::string& expected_proto_outputs_for_all_channels,
+    const std::string& native_inputs_for_all_channels,
+    const std::string& expected_native_outputs_for_all_channels,
+    const std::string& native_outputs_for_all_channels,
     const int random_seed, const double prob_input_valid_assert,
     bool show_trace, std::string_view output_stats_path, bool fail_on_assert) {
   auto timeout = StartTimeoutTimer();
@@ -1157,6 +1450,32 @@ static absl::Status RealMain(
   XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_file));
   XLS_ASSIGN_OR_RETURN(auto package, Parser::ParsePackage(ir_text));
 
+  // Native channel-value files are mapped into memory rather than parsed, and
+  // their values are only decoded as the simulation reaches them.
+  std::unique_ptr<ChannelValueFileReader> native_inputs;
+  ChannelValueSequences input_sequences;
+  if (!native_inputs_for_all_channels.empty()) {
+    XLS_ASSIGN_OR_RETURN(native_inputs,
+                         ChannelValueFileReader::Open(
+                             native_inputs_for_all_channels, package.get()));
+    input_sequences = ToChannelValueSequences(*native_inputs);
+  } else {
+    input_sequences = ToChannelValueSequences(std::move(inputs_for_channels));
+  }
+  std::unique_ptr<ChannelValueFileReader> native_expected_outputs;
+  ChannelValueSequences expected_output_sequences;
+  if (!expected_native_outputs_for_all_channels.empty()) {
+    XLS_ASSIGN_OR_RETURN(
+        native_expected_outputs,
+        ChannelValueFileReader::Open(expected_native_outputs_for_all_channels,
+                                     package.get()));
+    expected_output_sequences =
+        ToChannelValueSequences(*native_expected_outputs);
+  } else {
+    expected_output_sequences =
+        ToChannelValueSequences(std::move(expected_outputs_for_channels));
+  }
+
   if (backend.starts_with("block")) {
     RunBlockOptions block_options = {
         .ticks = ticks,
@@ -1175,8 +1494,8 @@ static absl::Status RealMain(
     }
     verilog::ModuleSignatureProto proto;
     CHECK_OK(ParseTextProtoFile(block_signature_proto, &proto));
-    return RunBlock(package.get(), proto, inputs_for_channels,
-                    expected_outputs_for_channels, ram_rewrites,
+    return RunBlock(package.get(), proto, input_sequences,
+                    expected_output_sequences, ram_rewrites,
                     output_stats_path, block_options);
   }
 
@@ -1186,6 +1505,10 @@ static absl::Status RealMain(
       .ticks = ticks,
       .top = absl::GetFlag(FLAGS_top),
   };
+  if (!native_outputs_for_all_channels.empty()) {
+    evaluate_procs_options.native_outputs_path =
+        native_outputs_for_all_channels;
+  }
 
   if (backend == "serial_jit") {
     evaluate_procs_options.use_jit = true;
@@ -1194,8 +1517,8 @@ static absl::Status RealMain(
   } else {
     LOG(QFATAL) << "Unknown backend type";
   }
-  return EvaluateProcs(package.get(), inputs_for_channels,
-                       expected_outputs_for_channels, ram_rewrites,
+  return EvaluateProcs(package.get(), input_sequences,
+                       expected_output_sequences, ram_rewrites,
                        evaluate_procs_options);
 }
 
@@ -1236,11 +1559,13 @@ int main(int argc, char* argv[]) {
           absl::Span<const bool>{
               !absl::GetFlag(FLAGS_inputs_for_channels).empty(),
               !absl::GetFlag(FLAGS_inputs_for_all_channels).empty(),
-              !absl::GetFlag(FLAGS_proto_inputs_for_all_channels).empty()},
+              !absl::GetFlag(FLAGS_proto_inputs_for_all_channels).empty(),
+              !absl::GetFlag(FLAGS_native_inputs_for_all_channels).empty()},
           true) > 1) {
     LOG(QFATAL) << "Only one of --inputs_for_channels, "
-                   "--inputs_for_all_channels, and "
-                   "--proto_inputs_for_all_channels must be set.";
+                   "--inputs_for_all_channels, "
+                   "--proto_inputs_for_all_channels, and "
+                   "--native_inputs_for_all_channels must be set.";
   }
 
   if (absl::c_count(
@@ -1248,11 +1573,22 @@ int main(int argc, char* argv[]) {
               !absl::GetFlag(FLAGS_expected_outputs_for_channels).empty(),
               !absl::GetFlag(FLAGS_expected_outputs_for_all_channels).empty(),
               !absl::GetFlag(FLAGS_expected_proto_outputs_for_all_channels)
-                   .empty()},
+                   .empty(),
+              !absl::GetFlag(FLAGS_expected_native_outputs_for_all_channels)
+                   .empty(),
+              !absl::GetFlag(FLAGS_native_outputs_for_all_channels).empty()},
           true) > 1) {
     LOG(QFATAL) << "Only one of --expected_outputs_for_channels, "
-                   "--expected_outputs_for_all_channels, and "
-                   "--expected_proto_outputs_for_all_channels must be set.";
+                   "--expected_outputs_for_all_channels, "
+                   "--expected_proto_outputs_for_all_channels, "
+                   "--expected_native_outputs_for_all_channels, and "
+                   "--native_outputs_for_all_channels must be set.";
+  }
+
+  if (backend.starts_with("block") &&
+      !absl::GetFlag(FLAGS_native_outputs_for_all_channels).empty()) {
+    LOG(QFATAL) << "--native_outputs_for_all_channels is only supported for "
+                   "procs.";
   }
 
   return xls::ExitStatus(xls::RealMain(
@@ -1266,6 +1602,9 @@ int main(int argc, char* argv[]) {
       absl::GetFlag(FLAGS_proto_inputs_for_all_channels),
       absl::GetFlag(FLAGS_testvector_textproto),
       absl::GetFlag(FLAGS_expected_proto_outputs_for_all_channels),
+      absl::GetFlag(FLAGS_native_inputs_for_all_channels),
+      absl::GetFlag(FLAGS_expected_native_outputs_for_all_channels),
+      absl::GetFlag(FLAGS_native_outputs_for_all_channels),
       absl::GetFlag(FLAGS_random_seed),
       absl::GetFlag(FLAGS_prob_input_valid_assert),
       absl::GetFlag(FLAGS_show_trace), absl::GetFlag(FLAGS_output_stats_path),
@@ -1175,6 +1175,67 @@ rewrites {
         + backend
     )
 
+  @parameterized_proc_backends
+  def test_multi_proc_native_channel_values(self, backend):
+    ir_file = MULTI_BLOCK_IR_FILE
+    channels_in_file = self.create_tempfile(
+        content=MULTI_BLOCK_INPUT_CHANNEL_VALUES.SerializeToString()
+    )
+    channels_out_file = self.create_tempfile(
+        content=MULTI_BLOCK_OUTPUT_CHANNEL_VALUES.SerializeToString()
+    )
+    native_in_file = self.create_tempfile()
+    native_out_file = self.create_tempfile()
+    for proto_file, native_file in (
+        (channels_in_file, native_in_file),
+        (channels_out_file, native_out_file),
+    ):
+      run_command([
+          CONVERT_CHANNEL_VALUES_PATH,
+          "--input_format=proto",
+          "--output_format=native",
+          f"--output={native_file.full_path}",
+          proto_file.full_path,
+      ])
+    run_command(
+        [
+            EVAL_PROC_MAIN_PATH,
+            ir_file,
+            f"--native_inputs_for_all_channels={native_in_file.full_path}",
+            f"--expected_native_outputs_for_all_channels={native_out_file.full_path}",
+            "--alsologtostderr",
+            "--ticks=6",
+        ]
+        + backend
+    )
+
+    # Record the outputs to a native file and check they round-trip.
+    recorded_file = self.create_tempfile()
+    recorded_proto_file = self.create_tempfile()
+    run_command(
+        [
+            EVAL_PROC_MAIN_PATH,
+            ir_file,
+            f"--native_inputs_for_all_channels={native_in_file.full_path}",
+            f"--native_outputs_for_all_channels={recorded_file.full_path}",
+            "--alsologtostderr",
+            "--ticks=6",
+        ]
+        + backend
+    )
+    run_command([
+        CONVERT_CHANNEL_VALUES_PATH,
+        "--input_format=native",
+        "--output_format=proto",
+        f"--output={recorded_proto_file.full_path}",
+        recorded_file.full_path,
+    ])
+    with open(recorded_proto_file.full_path, "rb") as f:
+      recorded = proc_channel_values_pb2.ProcChannelValuesProto.FromString(
+          f.read()
+      )
+    self.assertEqual(recorded, MULTI_BLOCK_OUTPUT_CHANNEL_VALUES)
+
   @parameterized_block_backends
   def test_multi_block(self, backend):
     ir_file = MULTI_BLOCK_IR_FILE
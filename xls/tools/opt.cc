@@ -27,6 +27,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
+#include "xls/common/logging/log_lines.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/visitor.h"
@@ -39,6 +40,7 @@
 #include "xls/passes/pass_base.h"
 #include "xls/passes/pass_metrics.pb.h"
 #include "xls/passes/pass_pipeline.pb.h"
+#include "xls/passes/pass_trace.h"
 #include "xls/passes/query_engine_checker.h"
 #include "xls/passes/verifier_checker.h"
 
@@ -114,13 +116,23 @@ absl::Status OptimizeIrForTop(Package* package, const OptOptions& options) {
   pass_options.enable_resource_sharing = options.enable_resource_sharing;
   pass_options.bisect_limit = options.bisect_limit;
   pass_options.record_metrics = options.metrics != nullptr;
+  pass_options.function_base_threads = options.function_base_threads;
+  pass_options.skip_unchanged_function_bases =
+      options.skip_unchanged_function_bases;
+  pass_options.incremental_verification = options.incremental_verification;
+  pass_options.full_verification_interval = options.full_verification_interval;
+  pass_options.tracer = options.tracer;
   PassResults results;
-  OptimizationContext context;
+  OptimizationContext context(options.incremental_topo_sort);
   XLS_RETURN_IF_ERROR(pipeline
                           ->Run(package, pass_options,
                                 options.results ? options.results : &results,
                                 context)
                           .status());
+  VLOG(1) << "Optimization cache stats: " << context.cache_stats().ToString();
+  if (options.tracer != nullptr) {
+    XLS_VLOG_LINES(1, options.tracer->Summary());
+  }
   if (options.metrics) {
     *options.metrics = results.aggregate_results.ToProto();
   }
@@ -30,6 +30,7 @@
 #include "xls/passes/optimization_pass.h"
 #include "xls/passes/pass_base.h"
 #include "xls/passes/pass_metrics.pb.h"
+#include "xls/passes/pass_trace.h"
 #include "xls/passes/pass_pipeline.pb.h"
 
 namespace xls::tools {
@@ -53,6 +54,21 @@ struct OptOptions {
   std::optional<int64_t> bisect_limit;
   PipelineMetricsProto* metrics = nullptr;
   bool debug_optimizations = false;
+  // Whether to incrementally maintain cached topological orders.
+  bool incremental_topo_sort = false;
+  // Number of threads used to run function-local passes on the functions and
+  // procs of the package concurrently. Blocks are always run serially.
+  int64_t function_base_threads = 1;
+  // Whether function-local passes in fixed-point groups skip the functions and
+  // procs they already ran on without effect and which are unchanged since.
+  bool skip_unchanged_function_bases = true;
+  // Whether to re-verify only the IR changed by each pass, verifying the whole
+  // package every `full_verification_interval` verifications if positive.
+  bool incremental_verification = false;
+  int64_t full_verification_interval = 0;
+  // If not null, records a trace of the passes run and the work nested within
+  // them.
+  PassTracer* tracer = nullptr;
 
   // TODO(allight): adding out-arguments like this (and metrics) is not very
   // clean.
@@ -52,6 +52,7 @@
 #include "xls/passes/pass_base.h"
 #include "xls/passes/pass_metrics.pb.h"
 #include "xls/passes/pass_pipeline.pb.h"
+#include "xls/passes/pass_trace.h"
 #include "xls/tools/opt.h"
 
 static constexpr std::string_view kUsage = R"(
@@ -142,10 +143,37 @@ ABSL_FLAG(std::optional<std::string>, pipeline_metrics_proto, std::nullopt,
 ABSL_FLAG(std::optional<std::string>, pipeline_metrics_textproto, std::nullopt,
           "Output path for the pipeline metrics text proto recording what "
           "this opt performed.");
+ABSL_FLAG(std::optional<std::string>, pass_trace_file, std::nullopt,
+          "Output path for a trace of the passes run, with nested spans for "
+          "each pass invocation, fixed-point iteration, function/proc and "
+          "query engine population. Written in the Chrome trace event format "
+          "which chrome://tracing and https://ui.perfetto.dev can display.");
 ABSL_FLAG(bool, debug_optimizations, false,
           "If passed, run additional strict correctness-checking passes; this "
           "slows down the optimization significantly, and is mostly intended "
           "for internal XLS debugging.");
+ABSL_FLAG(bool, incremental_topo_sort, false,
+          "If passed, patch cached topological orders in response to IR edits "
+          "rather than recomputing them after every change. The resulting "
+          "orders are valid but may differ from the stable default order, so "
+          "optimized output is not guaranteed to be identical.");
+ABSL_FLAG(int64_t, function_base_threads, 1,
+          "Number of threads used to run function-local passes over the "
+          "functions and procs of the package concurrently. The output is "
+          "identical regardless of the thread count.");
+ABSL_FLAG(bool, skip_unchanged_function_bases, true,
+          "If true, function-local passes within fixed-point pass groups skip "
+          "the functions and procs they already ran on without effect and "
+          "which have not changed since.");
+ABSL_FLAG(bool, incremental_verification, false,
+          "If true, the IR verifier run between passes only re-verifies the "
+          "nodes changed by the pass (and their users) and the invariants they "
+          "may affect, rather than the whole package.");
+ABSL_FLAG(int64_t, full_verification_interval, 0,
+          "With --incremental_verification, verify the whole package every "
+          "this many verifications. 0 only verifies the whole package before "
+          "the first pass and when functions, procs or channels are added or "
+          "removed.");
 
 namespace xls::tools {
 namespace {
@@ -267,6 +295,18 @@ absl::Status RealMain(std::string_view input_path) {
                        absl::GetFlag(FLAGS_pipeline_metrics_textproto);
 
   bool debug_optimizations = absl::GetFlag(FLAGS_debug_optimizations);
+  bool incremental_topo_sort = absl::GetFlag(FLAGS_incremental_topo_sort);
+  int64_t function_base_threads = absl::GetFlag(FLAGS_function_base_threads);
+  bool skip_unchanged_function_bases =
+      absl::GetFlag(FLAGS_skip_unchanged_function_bases);
+  bool incremental_verification = absl::GetFlag(FLAGS_incremental_verification);
+  int64_t full_verification_interval =
+      absl::GetFlag(FLAGS_full_verification_interval);
+
+  std::optional<PassTracer> tracer;
+  if (absl::GetFlag(FLAGS_pass_trace_file)) {
+    tracer.emplace();
+  }
 
   PassResults results;
   XLS_ASSIGN_OR_RETURN(
@@ -289,6 +329,12 @@ absl::Status RealMain(std::string_view input_path) {
               .bisect_limit = bisect_limit,
               .metrics = wants_metrics ? &metrics : nullptr,
               .debug_optimizations = debug_optimizations,
+              .incremental_topo_sort = incremental_topo_sort,
+              .function_base_threads = function_base_threads,
+              .skip_unchanged_function_bases = skip_unchanged_function_bases,
+              .incremental_verification = incremental_verification,
+              .full_verification_interval = full_verification_interval,
+              .tracer = tracer.has_value() ? &*tracer : nullptr,
               .results = &results,
           }));
   VLOG(2) << "Ran " << results.invocations.size() << " passes";
@@ -303,6 +349,10 @@ absl::Status RealMain(std::string_view input_path) {
     XLS_RETURN_IF_ERROR(
         SetFileContents(*absl::GetFlag(FLAGS_pipeline_metrics_textproto), tf));
   }
+  if (tracer.has_value()) {
+    XLS_RETURN_IF_ERROR(
+        tracer->WriteChromeTrace(*absl::GetFlag(FLAGS_pass_trace_file)));
+  }
 
   if (output_path == "-") {
     std::cout << opt_ir;